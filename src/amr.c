@@ -0,0 +1,1805 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file amr.c
+ *  \brief Functions to add, remove and resize the refined Domains of a nested
+ *   mesh as the solution evolves (adaptive mesh refinement, AMR).
+ *
+ * PURPOSE: Functions to add, remove and resize the refined Domains of a nested
+ *   mesh as the solution evolves (adaptive mesh refinement, AMR).  The mesh is
+ *   set up from the <domain> blocks in the input file as with SMR.  Then every
+ *   <amr>/interval steps of the root level, the Domains of each level with
+ *   <domainN>/adaptive = 1 are replaced by new Domains covering the cells of
+ *   the level below flagged by a refinement criterion:
+ *   - "gradient": relative jump in density to a neighbour > <amr>/thresh
+ *   - "shock":    relative jump in pressure > <amr>/thresh, with div(v) < 0
+ *   - "jeans":    cell size > Jeans length/<amr>/jeans_number, with 4\pi G
+ *                 given by <amr>/four_pi_G
+ *   or by a function enrolled in AMRFlagFunc by the problem generator, which
+ *   overrides <amr>/criterion.
+ *
+ *   Each flagged cell marks the blocks of <amr>/block parent cells within
+ *   <amr>/buffer parent cells of it.  The marked blocks are clustered into
+ *   boxes as in Berger & Rigoutsos (1991, IEEE Trans. SMC 21, 1278): a box is
+ *   split at a hole in, or else at the largest inflection of, the number of
+ *   marked blocks in each plane, until at least a fraction <amr>/efficiency
+ *   of its blocks are marked.  The boxes are then grown and merged until they
+ *   obey the rules checked by init_mesh(): each lies inside one parent, with
+ *   a gap of at least nghost/2 parent cells unless at the edge of the root,
+ *   covers its own children with the same gap, and touches no other box on
+ *   its level.  Each box is one new Domain.  Levels are regridded starting
+ *   with the finest, so that each level covers the new Domains of the next.
+ *   A level with no flagged cells and no children keeps its Domains.
+ *
+ *   When the Domains of any level change, the Domain array of the Mesh is
+ *   built again.  Domains on fixed levels (adaptive = 0) are kept as they
+ *   are.  New Domains are divided into Grids of about <amr>/max_grid cells a
+ *   side, assigned to processors by cost with balance_grids(), and saved in
+ *   the <domain> blocks after those of the fixed levels (which must come
+ *   first in the input file), so restart files reproduce them.  The MPI
+ *   communicators of the Domains and between levels, the overlaps between
+ *   child and parent Grids, and the buffers of SMR, boundary conditions and
+ *   integrators are then all set up again.  The solution is copied where a
+ *   new Domain overlaps an old Domain of its level, and elsewhere it is
+ *   prolongated from the parent Domain with ProCon() and ProFld(), keeping
+ *   the face-centered fields copied at the edges of the old Domains.
+ *   Boundary conditions enrolled with bvals_mhd_fun() on adaptive levels are
+ *   not kept.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - AMR_init()   - reads <amr> block and sets the refinement criterion
+ * - AMR_regrid() - flags cells, and rebuilds the Domains of adaptive levels
+ *
+ * PRIVATE FUNCTION PROTOTYPES:
+ * - flag_gradient() - flags cells with large jumps in density
+ * - flag_shock()    - flags cells in shocks
+ * - flag_jeans()    - flags cells that do not resolve the Jeans length
+ * - cell_pressure() - returns pressure in a cell
+ * - box_add()       - appends a box to a list
+ * - cmp_box()       - orders boxes by their lower corner, for qsort()
+ * - boxes_touch()   - returns 1 if two boxes overlap or touch
+ * - in_boxes()      - returns 1 if a region lies inside a box of a list
+ * - allowed_boxes() - finds where the Domains of a level may lie
+ * - find_boxes()    - finds the new boxes of an adaptive level
+ * - cluster()       - clusters marked blocks into boxes
+ * - fix_boxes()     - grows and merges boxes to obey the nesting rules
+ * - regrid_mesh()   - replaces the Domains of adaptive levels
+ * - new_domain()    - initializes a new Domain
+ * - choose_ngrid()  - chooses the number of Grids of a new Domain
+ * - copy_old()      - copies the solution from an old Domain
+ * - prolong_new()   - prolongates the solution into the new cells of a Domain
+ * - region_data()   - loads or stores cells and faces in a region of a Grid
+ * - free_grid()     - frees a Grid					      */
+/*============================================================================*/
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+
+#ifdef ADAPTIVE_MESH_REFINEMENT
+
+/*! \struct BoxListS
+ *  \brief List of boxes, in cells of one level */
+typedef struct BoxList_s{
+  int n,nmax;       /*!< number of boxes, and number allocated */
+  SideS *box;       /*!< boxes */
+}BoxListS;
+
+static int interval, block, buffer, max_grid, FirstBlock;
+static Real thresh, jeans_number, amr_G, efficiency;
+static int *Adapt=NULL;       /* 1 if Domains on level are regridded */
+static Real *LevelCost=NULL;  /* <domainN>/cost of Domains on adaptive levels */
+
+/* number of doubles per parent cell sent for prolongation */
+#ifdef MHD
+#define NPRO (NCONS_VAR + 3)
+#else
+#define NPRO (NCONS_VAR)
+#endif
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   flag_gradient() - flags cells with large jumps in density
+ *   flag_shock()    - flags cells in shocks
+ *   flag_jeans()    - flags cells that do not resolve the Jeans length
+ *   cell_pressure() - returns pressure in a cell
+ *   box_add()       - appends a box to a list
+ *   cmp_box()       - orders boxes by their lower corner, for qsort()
+ *   boxes_touch()   - returns 1 if two boxes overlap or touch
+ *   in_boxes()      - returns 1 if a region lies inside a box of a list
+ *   allowed_boxes() - finds where the Domains of a level may lie
+ *   find_boxes()    - finds the new boxes of an adaptive level
+ *   cluster()       - clusters marked blocks into boxes
+ *   fix_boxes()     - grows and merges boxes to obey the nesting rules
+ *   regrid_mesh()   - replaces the Domains of adaptive levels
+ *   new_domain()    - initializes a new Domain
+ *   choose_ngrid()  - chooses the number of Grids of a new Domain
+ *   copy_old()      - copies the solution from an old Domain
+ *   prolong_new()   - prolongates the solution into the new cells of a Domain
+ *   region_data()   - loads or stores cells and faces in a region of a Grid
+ *   free_grid()     - frees a Grid
+ *============================================================================*/
+
+static int flag_gradient(GridS *pG, int i, int j, int k);
+static int flag_shock(GridS *pG, int i, int j, int k);
+static int flag_jeans(GridS *pG, int i, int j, int k);
+static Real cell_pressure(GridS *pG, const int i, const int j, const int k);
+static void box_add(BoxListS *pL, const SideS *pB);
+static int cmp_box(const void *a, const void *b);
+static int boxes_touch(const SideS *pB1, const SideS *pB2);
+static int in_boxes(const BoxListS *pL, const int nDim, const int *lo,
+                    const int *hi);
+static void allowed_boxes(MeshS *pM, const int nl, const BoxListS *pP,
+                          BoxListS *pA);
+static void find_boxes(MeshS *pM, const int nl, const BoxListS *pOld,
+                       const BoxListS *pAllowed, const BoxListS *pChild,
+                       BoxListS *pNew);
+static void cluster(const unsigned char *pF, const int *nb, const SideS *pS,
+                    BoxListS *pL);
+static void fix_boxes(MeshS *pM, const int nl, const SideS *pA,
+                      const BoxListS *pFoot, BoxListS *pL);
+static void regrid_mesh(MeshS *pM, BoxListS *Old, BoxListS *New);
+static void new_domain(MeshS *pM, DomainS *pD, const int nl, const int nd,
+                       const SideS *pB, const int nblock);
+#ifdef MPI_PARALLEL
+static void choose_ngrid(DomainS *pD);
+#endif
+static void copy_old(DomainS *pD, DomainS *pOD);
+static void prolong_new(MeshS *pM, DomainS *pD, DomainS *pPD,
+                        const BoxListS *pOld);
+static int region_data(DomainS *pD, GridS *pG, const SideS *pR, double *pBuf,
+                       const int load);
+static void free_grid(GridS *pG);
+
+/* floor and ceiling of x to a multiple of b>0, for x of either sign */
+static int round_down(const int x, const int b)
+{
+  return (x >= 0) ? (x/b)*b : -(((b - 1 - x)/b)*b);
+}
+static int round_up(const int x, const int b)
+{
+  return -round_down(-x,b);
+}
+
+/* root boundaries in direction dim are periodic */
+static int is_periodic(MeshS *pM, const int dim)
+{
+  if (dim == 0) return (pM->BCFlag_ix1 == 4 || pM->BCFlag_ox1 == 4);
+  if (dim == 1) return (pM->BCFlag_ix2 == 4 || pM->BCFlag_ox2 == 4);
+  return (pM->BCFlag_ix3 == 4 || pM->BCFlag_ox3 == 4);
+}
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void AMR_init(MeshS *pM)
+ *  \brief Reads the <amr> block, finds the adaptive levels, and sets the
+ *   refinement criterion unless one was enrolled by the problem generator.
+ *   Must be called after init_grid() and the problem generator.
+ */
+
+void AMR_init(MeshS *pM)
+{
+  DomainS *pD;
+  char blk[80], *criterion;
+  int nl,nd,i,nadapt=0,maxfixed=0;
+
+  interval = par_geti_def("amr","interval",4);
+  block    = par_geti_def("amr","block",4);
+  buffer   = par_geti_def("amr","buffer",2);
+  max_grid = par_geti_def("amr","max_grid",32);
+  thresh   = par_getd_def("amr","thresh",0.1);
+  efficiency = par_getd_def("amr","efficiency",0.7);
+  if (interval < 1) ath_error("[AMR_init]: <amr>/interval must be >= 1\n");
+  if (block < 1) ath_error("[AMR_init]: <amr>/block must be >= 1\n");
+  if (buffer < 0) ath_error("[AMR_init]: <amr>/buffer must be >= 0\n");
+  if (max_grid < 1) ath_error("[AMR_init]: <amr>/max_grid must be >= 1\n");
+  if (efficiency <= 0.0 || efficiency > 1.0)
+    ath_error("[AMR_init]: <amr>/efficiency must be in (0,1]\n");
+  for (i=1; i<block; i*=2);  /* round block up to a power of 2 */
+  block = i;
+
+  if ((Adapt = (int*)calloc_1d_array(pM->NLevels,sizeof(int))) == NULL)
+    ath_error("[AMR_init]: Failed to allocate Adapt\n");
+  if ((LevelCost = (Real*)calloc_1d_array(pM->NLevels,sizeof(Real))) == NULL)
+    ath_error("[AMR_init]: Failed to allocate LevelCost\n");
+
+/* Find the adaptive levels, on which all Domains must be adaptive, and the
+ * first <domain> block of their Domains.  The blocks of the fixed levels must
+ * all come before it, since AMR_regrid() numbers new Domains from there. */
+
+  FirstBlock = INT_MAX;
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      if (pD->Adaptive != pM->Domain[nl][0].Adaptive)
+        ath_error("[AMR_init]: Domains on level %d differ in adaptive\n",nl);
+      if (pD->Adaptive) FirstBlock = MIN(FirstBlock,pD->InputBlock);
+      else maxfixed = MAX(maxfixed,pD->InputBlock);
+    }
+    Adapt[nl] = pM->Domain[nl][0].Adaptive;
+    if (Adapt[nl]) {
+      nadapt++;
+      sprintf(blk,"domain%d",pM->Domain[nl][0].InputBlock);
+      LevelCost[nl] = par_getd_def(blk,"cost",1.0);
+    }
+  }
+  if (Adapt[0]) ath_error("[AMR_init]: the root Domain cannot be adaptive\n");
+  if (nadapt > 0 && FirstBlock < maxfixed)
+    ath_error("[AMR_init]: <domain> blocks of adaptive levels must follow those of fixed levels\n");
+
+/* Set the refinement criterion, unless the problem generator has set one */
+
+  if (AMRFlagFunc == NULL) {
+    criterion = par_gets_def("amr","criterion","gradient");
+    if (strcmp(criterion,"gradient") == 0) {
+      AMRFlagFunc = flag_gradient;
+    } else if (strcmp(criterion,"shock") == 0) {
+      AMRFlagFunc = flag_shock;
+    } else if (strcmp(criterion,"jeans") == 0) {
+      jeans_number = par_getd_def("amr","jeans_number",4.0);
+      amr_G = par_getd("amr","four_pi_G")/(4.0*PI);
+      if (amr_G <= 0.0) ath_error("[AMR_init]: <amr>/four_pi_G must be > 0\n");
+      AMRFlagFunc = flag_jeans;
+    } else if (strcmp(criterion,"user") == 0) {
+      ath_error("[AMR_init]: criterion=user but none set in problem()\n");
+    } else {
+      ath_error("[AMR_init]: unknown <amr>/criterion %s\n",criterion);
+    }
+    ath_pout(0,"[AMR_init]: refining on %s every %d steps\n",criterion,
+      interval);
+    free(criterion);
+  } else {
+    ath_pout(0,"[AMR_init]: refining on user criterion every %d steps\n",
+      interval);
+  }
+  if (nadapt == 0)
+    ath_pout(0,"[AMR_init]: no adaptive levels, Domains are fixed\n");
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int AMR_regrid(MeshS *pM)
+ *  \brief Every <amr>/interval steps, flags cells for refinement and replaces
+ *   the Domains of the adaptive levels with new ones covering them.  Ghost
+ *   zones must be set on entry, and are set again on exit.  Returns the
+ *   number of levels whose Domains changed, after which the timestep must be
+ *   computed again.
+ */
+
+int AMR_regrid(MeshS *pM)
+{
+  DomainS *pD;
+  BoxListS *Old,*New,*Allowed;
+  SideS B,*pB;
+  int nl,nd,i,n,nadapt=0,nchanged=0,changed;
+
+  if ((pM->NLevels) < 2 || (pM->nstep % interval) != 0) return 0;
+  for (nl=1; nl<(pM->NLevels); nl++) nadapt += Adapt[nl];
+  if (nadapt == 0) return 0;
+
+  if ((Old = (BoxListS*)calloc_1d_array(pM->NLevels,sizeof(BoxListS)))==NULL)
+    ath_error("[AMR_regrid]: Failed to allocate Old\n");
+  if ((New = (BoxListS*)calloc_1d_array(pM->NLevels,sizeof(BoxListS)))==NULL)
+    ath_error("[AMR_regrid]: Failed to allocate New\n");
+  if ((Allowed = (BoxListS*)calloc_1d_array(pM->NLevels,sizeof(BoxListS)))
+    == NULL) ath_error("[AMR_regrid]: Failed to allocate Allowed\n");
+
+/* Boxes of all Domains, on their own levels */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      for (i=0; i<3; i++) {
+        B.ijkl[i] = pD->Disp[i];
+        B.ijkr[i] = pD->Disp[i] + pD->Nx[i];
+      }
+      box_add(&(Old[nl]),&B);
+    }
+    qsort(Old[nl].box, Old[nl].n, sizeof(SideS), cmp_box);
+  }
+
+/* Regions where the Domains of each adaptive level may lie, given the old
+ * Domains of the level below or, if it is adaptive too, where they may lie */
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    if (Adapt[nl])
+      allowed_boxes(pM,nl,(Adapt[nl-1] ? &(Allowed[nl-1]) : &(Old[nl-1])),
+        &(Allowed[nl]));
+  }
+
+/* Find new boxes, starting at the finest level so that each level can cover
+ * the new boxes of the next */
+
+  for (nl=(pM->NLevels)-1; nl>0; nl--){
+    if (Adapt[nl]) {
+      find_boxes(pM,nl,&(Old[nl]),&(Allowed[nl]),
+        (nl < (pM->NLevels)-1 ? &(New[nl+1]) : NULL),&(New[nl]));
+    } else {
+      for (n=0; n<Old[nl].n; n++) box_add(&(New[nl]),&(Old[nl].box[n]));
+    }
+  }
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    if (Adapt[nl] == 0) continue;
+    changed = (New[nl].n != Old[nl].n);
+    for (n=0; n<New[nl].n && changed==0; n++){
+      for (i=0; i<3; i++) {
+        if (New[nl].box[n].ijkl[i] != Old[nl].box[n].ijkl[i] ||
+            New[nl].box[n].ijkr[i] != Old[nl].box[n].ijkr[i]) changed = 1;
+      }
+    }
+    if (changed == 0) continue;
+
+    nchanged++;
+    ath_pout(0,"[AMR_regrid]: level=%d Domains=%d (was %d)\n",nl,New[nl].n,
+      Old[nl].n);
+    for (n=0; n<New[nl].n; n++){
+      pB = &(New[nl].box[n]);
+      ath_pout(1,"[AMR_regrid]:   [is,ie,js,je,ks,ke]=[%d %d %d %d %d %d]\n",
+        pB->ijkl[0],pB->ijkr[0]-1,pB->ijkl[1],pB->ijkr[1]-1,
+        pB->ijkl[2],pB->ijkr[2]-1);
+    }
+  }
+
+  if (nchanged > 0) regrid_mesh(pM,Old,New);
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    if (Old[nl].box != NULL) free(Old[nl].box);
+    if (New[nl].box != NULL) free(New[nl].box);
+    if (Allowed[nl].box != NULL) free(Allowed[nl].box);
+  }
+  free_1d_array(Old);
+  free_1d_array(New);
+  free_1d_array(Allowed);
+
+  return nchanged;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static int flag_gradient(GridS *pG, int i, int j, int k)
+ *  \brief Flags cells where the density differs from that in a neighbour by
+ *   more than a fraction thresh */
+
+static int flag_gradient(GridS *pG, int i, int j, int k)
+{
+  Real rho = GRID_U(pG,k,j,i,d), djump = 0.0;
+
+  if (pG->Nx[0] > 1) {
+    djump = MAX(djump,fabs(GRID_U(pG,k,j,i+1,d) - rho));
+    djump = MAX(djump,fabs(GRID_U(pG,k,j,i-1,d) - rho));
+  }
+  if (pG->Nx[1] > 1) {
+    djump = MAX(djump,fabs(GRID_U(pG,k,j+1,i,d) - rho));
+    djump = MAX(djump,fabs(GRID_U(pG,k,j-1,i,d) - rho));
+  }
+  if (pG->Nx[2] > 1) {
+    djump = MAX(djump,fabs(GRID_U(pG,k+1,j,i,d) - rho));
+    djump = MAX(djump,fabs(GRID_U(pG,k-1,j,i,d) - rho));
+  }
+
+  return (djump > thresh*rho);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int flag_shock(GridS *pG, int i, int j, int k)
+ *  \brief Flags cells in compression, where the pressures in the neighbours
+ *   differ by more than a fraction thresh of the smallest */
+
+static int flag_shock(GridS *pG, int i, int j, int k)
+{
+  Real divv = 0.0, p, pmin, pmax;
+
+  pmin = pmax = cell_pressure(pG,i,j,k);
+  if (pG->Nx[0] > 1) {
+    divv += (GRID_U(pG,k,j,i+1,M1)/GRID_U(pG,k,j,i+1,d) -
+             GRID_U(pG,k,j,i-1,M1)/GRID_U(pG,k,j,i-1,d))/pG->dx1;
+    p = cell_pressure(pG,i+1,j,k);  pmin = MIN(pmin,p);  pmax = MAX(pmax,p);
+    p = cell_pressure(pG,i-1,j,k);  pmin = MIN(pmin,p);  pmax = MAX(pmax,p);
+  }
+  if (pG->Nx[1] > 1) {
+    divv += (GRID_U(pG,k,j+1,i,M2)/GRID_U(pG,k,j+1,i,d) -
+             GRID_U(pG,k,j-1,i,M2)/GRID_U(pG,k,j-1,i,d))/pG->dx2;
+    p = cell_pressure(pG,i,j+1,k);  pmin = MIN(pmin,p);  pmax = MAX(pmax,p);
+    p = cell_pressure(pG,i,j-1,k);  pmin = MIN(pmin,p);  pmax = MAX(pmax,p);
+  }
+  if (pG->Nx[2] > 1) {
+    divv += (GRID_U(pG,k+1,j,i,M3)/GRID_U(pG,k+1,j,i,d) -
+             GRID_U(pG,k-1,j,i,M3)/GRID_U(pG,k-1,j,i,d))/pG->dx3;
+    p = cell_pressure(pG,i,j,k+1);  pmin = MIN(pmin,p);  pmax = MAX(pmax,p);
+    p = cell_pressure(pG,i,j,k-1);  pmin = MIN(pmin,p);  pmax = MAX(pmax,p);
+  }
+
+  return (divv < 0.0 && (pmax - pmin) > thresh*pmin);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int flag_jeans(GridS *pG, int i, int j, int k)
+ *  \brief Flags cells larger than 1/jeans_number of the Jeans length
+ *   lambda_J = sqrt(pi cs^2/(G rho)) (Truelove et al. 1997) */
+
+static int flag_jeans(GridS *pG, int i, int j, int k)
+{
+  Real rho = GRID_U(pG,k,j,i,d), cs2, dx;
+
+#ifdef ISOTHERMAL
+  cs2 = Iso_csound2;
+#else
+  cs2 = Gamma*cell_pressure(pG,i,j,k)/rho;
+#endif
+  dx = pG->dx1;
+  if (pG->Nx[1] > 1) dx = MAX(dx,pG->dx2);
+  if (pG->Nx[2] > 1) dx = MAX(dx,pG->dx3);
+
+  return (SQR(jeans_number*dx)*amr_G*rho > PI*cs2);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real cell_pressure(GridS *pG, const int i, const int j,
+ *                                const int k)
+ *  \brief Returns the gas pressure in cell (i,j,k) */
+
+static Real cell_pressure(GridS *pG, const int i, const int j, const int k)
+{
+#ifdef ISOTHERMAL
+  return GRID_U(pG,k,j,i,d)*Iso_csound2;
+#else
+  Real p;
+
+  p = GRID_U(pG,k,j,i,E) - 0.5*(SQR(GRID_U(pG,k,j,i,M1)) +
+    SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
+#ifdef MHD
+  p -= 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) +
+            SQR(GRID_U(pG,k,j,i,B3c)));
+#endif
+  return MAX(Gamma_1*p,TINY_NUMBER);
+#endif /* ISOTHERMAL */
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void box_add(BoxListS *pL, const SideS *pB)
+ *  \brief Appends box pB to list pL, doubling its size when it is full */
+
+static void box_add(BoxListS *pL, const SideS *pB)
+{
+  if (pL->n == pL->nmax) {
+    pL->nmax = MAX(2*(pL->nmax),8);
+    if ((pL->box = (SideS*)realloc(pL->box,(pL->nmax)*sizeof(SideS))) == NULL)
+      ath_error("[AMR_regrid]: Failed to allocate list of %d boxes\n",
+        pL->nmax);
+  }
+  pL->box[pL->n++] = *pB;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int cmp_box(const void *a, const void *b)
+ *  \brief Orders boxes by the k, j and then i index of their lower corner, so
+ *   Domains are numbered in the same order on every processor */
+
+static int cmp_box(const void *a, const void *b)
+{
+  const SideS *pA = (const SideS*)a, *pB = (const SideS*)b;
+  int dim;
+
+  for (dim=2; dim>=0; dim--){
+    if (pA->ijkl[dim] < pB->ijkl[dim]) return -1;
+    if (pA->ijkl[dim] > pB->ijkl[dim]) return 1;
+  }
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int boxes_touch(const SideS *pB1, const SideS *pB2)
+ *  \brief Returns 1 if two boxes on the same level overlap or touch, as
+ *   tested in Step 4 of init_mesh() */
+
+static int boxes_touch(const SideS *pB1, const SideS *pB2)
+{
+  return (pB1->ijkl[0] <= pB2->ijkr[0] && pB1->ijkr[0] >= pB2->ijkl[0] &&
+          pB1->ijkl[1] <= pB2->ijkr[1] && pB1->ijkr[1] >= pB2->ijkl[1] &&
+          pB1->ijkl[2] <= pB2->ijkr[2] && pB1->ijkr[2] >= pB2->ijkl[2]);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int in_boxes(const BoxListS *pL, const int nDim, const int *lo,
+ *                          const int *hi)
+ *  \brief Returns 1 if cells lo..hi-1 in the first nDim directions all lie
+ *   inside one box of pL.  Boxes on a level do not touch, so this is the same
+ *   as lying inside all of them together. */
+
+static int in_boxes(const BoxListS *pL, const int nDim, const int *lo,
+                    const int *hi)
+{
+  int n,dim;
+
+  for (n=0; n<pL->n; n++){
+    for (dim=0; dim<nDim; dim++){
+      if (lo[dim] < pL->box[n].ijkl[dim] || hi[dim] > pL->box[n].ijkr[dim])
+        break;
+    }
+    if (dim == nDim) return 1;
+  }
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void allowed_boxes(MeshS *pM, const int nl, const BoxListS *pP,
+ *                                BoxListS *pA)
+ *  \brief Finds the boxes on level nl inside boxes pP on level nl-1, with the
+ *   gap of (nghost+1)/2 parent cells required by init_mesh() except at the
+ *   edges of the root, and aligned with the root Grid.  Boxes too small to
+ *   hold a Domain are left out. */
+
+static void allowed_boxes(MeshS *pM, const int nl, const BoxListS *pP,
+                          BoxListS *pA)
+{
+  const SideS *pB;
+  SideS A;
+  int a,gc,R,nmin,dim,n,ok;
+
+  a = 1 << nl;            /* cells on this level per root cell */
+  gc = (nghost + 1)/2;    /* smallest gap to edge of parent, in parent cells */
+  nmin = round_up(nghost,a);
+
+  for (n=0; n<pP->n; n++){
+    pB = &(pP->box[n]);
+    ok = 1;
+    for (dim=0; dim<3; dim++){
+      A.ijkl[dim] = 0;
+      A.ijkr[dim] = 1;
+      if (pM->Nx[dim] == 1) continue;
+      R = pM->Nx[dim]*a;
+      A.ijkl[dim] = (pB->ijkl[dim] == 0) ? 0 : round_up(2*(pB->ijkl[dim]+gc),a);
+      A.ijkr[dim] = (2*pB->ijkr[dim] == R) ? R :
+        round_down(2*(pB->ijkr[dim]-gc),a);
+      if (A.ijkr[dim] - A.ijkl[dim] < nmin) ok = 0;
+    }
+    if (ok) box_add(pA,&A);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void find_boxes(MeshS *pM, const int nl, const BoxListS *pOld,
+ *                             const BoxListS *pAllowed,
+ *                             const BoxListS *pChild, BoxListS *pNew)
+ *  \brief Finds the new boxes of adaptive level nl, inside the regions
+ *   pAllowed and covering the new boxes pChild of level nl+1 (NULL on the
+ *   finest level).  The level is divided into blocks of 2*block cells, and a
+ *   map of the blocks near cells of level nl-1 flagged by AMRFlagFunc, or
+ *   under a child, is combined over all processors.  The marked blocks are
+ *   then clustered, and the boxes fixed up, in each allowed region.  With no
+ *   marked blocks the old boxes pOld are kept. */
+
+static void find_boxes(MeshS *pM, const int nl, const BoxListS *pOld,
+                       const BoxListS *pAllowed, const BoxListS *pChild,
+                       BoxListS *pNew)
+{
+  GridS *pG;
+  BoxListS Foot,Blk;
+  SideS S,F,*pB;
+  unsigned char *pF;
+  int a,bf,gc,R,dim,n,nd,ntot,any,i,j,k,ib,jb,kb;
+  int bs[3],ob[3],nb[3],g[3],lo[3],hi[3];
+#ifdef MPI_PARALLEL
+  int ierr;
+#endif
+
+  a = 1 << nl;
+  gc = (nghost + 1)/2;
+  for (bf=a; bf<2*block; bf*=2);  /* block, in cells on this level */
+  Foot.n = Foot.nmax = Blk.n = Blk.nmax = 0;
+  Foot.box = Blk.box = NULL;
+
+/* Map of blocks, covering all allowed regions */
+
+  for (dim=0; dim<3; dim++){
+    bs[dim] = 1;
+    ob[dim] = 0;
+    nb[dim] = 1;
+    if (pM->Nx[dim] == 1) continue;
+    bs[dim] = bf;
+    lo[dim] = INT_MAX;
+    hi[dim] = 0;
+    for (n=0; n<pAllowed->n; n++){
+      lo[dim] = MIN(lo[dim],pAllowed->box[n].ijkl[dim]);
+      hi[dim] = MAX(hi[dim],pAllowed->box[n].ijkr[dim]);
+    }
+    if (pAllowed->n == 0) lo[dim] = 0;
+    ob[dim] = round_down(lo[dim],bf);
+    nb[dim] = MAX(round_up(hi[dim],bf) - ob[dim],bf)/bf;
+  }
+  ntot = nb[0]*nb[1]*nb[2];
+  if ((pF = (unsigned char*)calloc_1d_array(ntot,sizeof(unsigned char)))
+    == NULL) ath_error("[AMR_regrid]: Failed to allocate map of blocks\n");
+
+/* Mark blocks within buffer parent cells of flagged cells on this processor */
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl-1]); nd++){
+    pG = pM->Domain[nl-1][nd].Grid;
+    if (pG == NULL) continue;
+    for (k=pG->ks; k<=pG->ke; k++) {
+    for (j=pG->js; j<=pG->je; j++) {
+    for (i=pG->is; i<=pG->ie; i++) {
+      if ((*AMRFlagFunc)(pG,i,j,k) == 0) continue;
+      g[0] = i - pG->is + pG->Disp[0];
+      g[1] = j - pG->js + pG->Disp[1];
+      g[2] = k - pG->ks + pG->Disp[2];
+      for (dim=0; dim<3; dim++){
+        lo[dim] = 0;
+        hi[dim] = 1;
+        if (pM->Nx[dim] == 1) continue;
+        lo[dim] = MAX(round_down(2*(g[dim]-buffer) - ob[dim],bf)/bf, 0);
+        hi[dim] = MIN(round_up(2*(g[dim]+buffer+1) - ob[dim],bf)/bf, nb[dim]);
+      }
+      for (kb=lo[2]; kb<hi[2]; kb++) {
+      for (jb=lo[1]; jb<hi[1]; jb++) {
+      for (ib=lo[0]; ib<hi[0]; ib++) {
+        pF[(kb*nb[1] + jb)*nb[0] + ib] = 1;
+      }}}
+    }}}
+  }
+
+#ifdef MPI_PARALLEL
+  ierr = MPI_Allreduce(MPI_IN_PLACE,pF,ntot,MPI_UNSIGNED_CHAR,MPI_MAX,
+    MPI_COMM_WORLD);
+#endif /* MPI_PARALLEL */
+
+/* Mark blocks under the footprints of the children in this level, which are
+ * the children plus the gap to the edge of their parent */
+
+  if (pChild != NULL) {
+    for (n=0; n<pChild->n; n++){
+      pB = &(pChild->box[n]);
+      for (dim=0; dim<3; dim++){
+        F.ijkl[dim] = 0;
+        F.ijkr[dim] = 1;
+        lo[dim] = 0;
+        hi[dim] = 1;
+        if (pM->Nx[dim] == 1) continue;
+        R = pM->Nx[dim]*a;
+        F.ijkl[dim] = (pB->ijkl[dim] == 0) ? 0 :
+          MAX(round_down(pB->ijkl[dim]/2 - gc,a), 0);
+        F.ijkr[dim] = (pB->ijkr[dim] == 2*R) ? R :
+          MIN(round_up(pB->ijkr[dim]/2 + gc,a), R);
+        lo[dim] = MAX((F.ijkl[dim] - ob[dim])/bf, 0);
+        hi[dim] = MIN(round_up(F.ijkr[dim] - ob[dim],bf)/bf, nb[dim]);
+      }
+      box_add(&Foot,&F);
+      for (kb=lo[2]; kb<hi[2]; kb++) {
+      for (jb=lo[1]; jb<hi[1]; jb++) {
+      for (ib=lo[0]; ib<hi[0]; ib++) {
+        pF[(kb*nb[1] + jb)*nb[0] + ib] = 1;
+      }}}
+    }
+  }
+
+  any = 0;
+  for (n=0; n<ntot; n++) any |= pF[n];
+
+/* Cluster the marked blocks in each allowed region, and fix up the boxes */
+
+  if (any) {
+    for (n=0; n<pAllowed->n; n++){
+      for (dim=0; dim<3; dim++){
+        S.ijkl[dim] = (pAllowed->box[n].ijkl[dim] - ob[dim])/bs[dim];
+        S.ijkr[dim] = round_up(pAllowed->box[n].ijkr[dim] - ob[dim],bs[dim])/
+          bs[dim];
+      }
+      Blk.n = 0;
+      cluster(pF,nb,&S,&Blk);
+      for (i=0; i<Blk.n; i++){
+        for (dim=0; dim<3; dim++){
+          Blk.box[i].ijkl[dim] = ob[dim] + Blk.box[i].ijkl[dim]*bs[dim];
+          Blk.box[i].ijkr[dim] = ob[dim] + Blk.box[i].ijkr[dim]*bs[dim];
+        }
+      }
+      fix_boxes(pM,nl,&(pAllowed->box[n]),&Foot,&Blk);
+      for (i=0; i<Blk.n; i++) box_add(pNew,&(Blk.box[i]));
+    }
+  }
+  if (pNew->n == 0) {
+    for (n=0; n<pOld->n; n++) box_add(pNew,&(pOld->box[n]));
+  }
+  qsort(pNew->box, pNew->n, sizeof(SideS), cmp_box);
+
+  free_1d_array(pF);
+  if (Foot.box != NULL) free(Foot.box);
+  if (Blk.box != NULL) free(Blk.box);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void cluster(const unsigned char *pF, const int *nb,
+ *                          const SideS *pS, BoxListS *pL)
+ *  \brief Appends to pL boxes covering the marked blocks of map pF (of
+ *   nb[0]xnb[1]xnb[2] blocks) in region pS, in block indices.  The region is
+ *   shrunk to its marked blocks, and kept if at least a fraction efficiency
+ *   of them are marked.  Otherwise it is split, at the hole in the signature
+ *   (number of marked blocks in each plane) nearest its middle, else where the
+ *   second derivative of the signature changes sign most strongly, else in
+ *   half across its longest side, and each part is clustered in turn. */
+
+static void cluster(const unsigned char *pF, const int *nb, const SideS *pS,
+                    BoxListS *pL)
+{
+  SideS S1,S2;
+  int *sig[3],len[3],i,j,k,dim,x,nf=0,vol=1,best,bdim,bx,lap0,lap1;
+
+  for (dim=0; dim<3; dim++){
+    len[dim] = pS->ijkr[dim] - pS->ijkl[dim];
+    if (len[dim] <= 0) return;
+    if ((sig[dim] = (int*)calloc_1d_array(len[dim],sizeof(int))) == NULL)
+      ath_error("[AMR_regrid]: Failed to allocate signature\n");
+  }
+
+  for (k=pS->ijkl[2]; k<pS->ijkr[2]; k++) {
+  for (j=pS->ijkl[1]; j<pS->ijkr[1]; j++) {
+  for (i=pS->ijkl[0]; i<pS->ijkr[0]; i++) {
+    if (pF[(k*nb[1] + j)*nb[0] + i] == 0) continue;
+    nf++;
+    sig[0][i-pS->ijkl[0]]++;
+    sig[1][j-pS->ijkl[1]]++;
+    sig[2][k-pS->ijkl[2]]++;
+  }}}
+
+/* Shrink the region to its marked blocks */
+
+  S1 = *pS;
+  if (nf > 0) {
+    for (dim=0; dim<3; dim++){
+      for (x=0; sig[dim][x] == 0; x++);
+      S1.ijkl[dim] = pS->ijkl[dim] + x;
+      for (x=len[dim]-1; sig[dim][x] == 0; x--);
+      S1.ijkr[dim] = pS->ijkl[dim] + x + 1;
+      vol *= S1.ijkr[dim] - S1.ijkl[dim];
+    }
+  }
+  for (dim=0; dim<3; dim++){
+    if (nf > 0 && (S1.ijkl[dim] != pS->ijkl[dim] ||
+                   S1.ijkr[dim] != pS->ijkr[dim])) break;
+  }
+  if (nf == 0 || dim < 3) {
+    for (dim=0; dim<3; dim++) free_1d_array(sig[dim]);
+    if (nf > 0) cluster(pF,nb,&S1,pL);
+    return;
+  }
+
+  if ((Real)nf >= efficiency*(Real)vol) {
+    for (dim=0; dim<3; dim++) free_1d_array(sig[dim]);
+    box_add(pL,pS);
+    return;
+  }
+
+/* Split at the hole nearest the middle */
+
+  bdim = -1;
+  bx = 0;
+  best = INT_MAX;
+  for (dim=0; dim<3; dim++){
+    for (x=1; x<len[dim]-1; x++){
+      if (sig[dim][x] == 0 && abs(2*x - len[dim]) < best) {
+        best = abs(2*x - len[dim]);
+        bdim = dim;
+        bx = x;
+      }
+    }
+  }
+
+/* or at the largest change in sign of the second derivative */
+
+  if (bdim < 0) {
+    best = 0;
+    for (dim=0; dim<3; dim++){
+      for (x=2; x<=len[dim]-2; x++){
+        lap0 = sig[dim][x-2] - 2*sig[dim][x-1] + sig[dim][x];
+        lap1 = sig[dim][x-1] - 2*sig[dim][x] + sig[dim][x+1];
+        if (((lap0 < 0 && lap1 > 0) || (lap0 > 0 && lap1 < 0)) &&
+            abs(lap1 - lap0) > best) {
+          best = abs(lap1 - lap0);
+          bdim = dim;
+          bx = x;
+        }
+      }
+    }
+  }
+
+/* or in half across the longest side */
+
+  if (bdim < 0) {
+    bdim = 0;
+    for (dim=1; dim<3; dim++) if (len[dim] > len[bdim]) bdim = dim;
+    bx = len[bdim]/2;
+  }
+
+  for (dim=0; dim<3; dim++) free_1d_array(sig[dim]);
+  S1 = *pS;
+  S2 = *pS;
+  S1.ijkr[bdim] = pS->ijkl[bdim] + bx;
+  S2.ijkl[bdim] = pS->ijkl[bdim] + bx;
+  cluster(pF,nb,&S1,pL);
+  cluster(pF,nb,&S2,pL);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void fix_boxes(MeshS *pM, const int nl, const SideS *pA,
+ *                            const BoxListS *pFoot, BoxListS *pL)
+ *  \brief Changes boxes pL on level nl, inside allowed region pA, until they
+ *   can be Domains: each is clipped to pA, and taken to the edge of the root
+ *   if less than the gap to its parent from it (or in periodic directions,
+ *   across the whole root if it touches either edge), then grown to at least
+ *   nghost cells.  Boxes that overlap or touch are replaced by the box
+ *   around both, as is each footprint of a child in pFoot with the boxes it
+ *   is not inside. */
+
+static void fix_boxes(MeshS *pM, const int nl, const SideS *pA,
+                      const BoxListS *pFoot, BoxListS *pL)
+{
+  SideS *pB,*pF,B;
+  int a,gc,R,nmin,dim,n,m,f,l,r,nov,in,changed;
+
+  a = 1 << nl;
+  gc = (nghost + 1)/2;
+  nmin = round_up(nghost,a);
+
+  do {
+    changed = 0;
+
+/* Clip, snap to the edges of the root, and grow each box */
+
+    for (n=0; n<pL->n; n++){
+      pB = &(pL->box[n]);
+      for (dim=0; dim<3; dim++){
+        if (pM->Nx[dim] == 1) continue;
+        R = pM->Nx[dim]*a;
+        l = MAX(pB->ijkl[dim],pA->ijkl[dim]);
+        r = MIN(pB->ijkr[dim],pA->ijkr[dim]);
+        if (l < 2*gc) l = 0;
+        if (r > R - 2*gc) r = R;
+        if (is_periodic(pM,dim) && (l == 0 || r == R)) {
+          l = 0;
+          r = R;
+        }
+        while (r - l < nmin && (l > pA->ijkl[dim] || r < pA->ijkr[dim])) {
+          if (l > pA->ijkl[dim]) l -= a;
+          if (r - l < nmin && r < pA->ijkr[dim]) r += a;
+        }
+        if (l != pB->ijkl[dim] || r != pB->ijkr[dim]) changed = 1;
+        pB->ijkl[dim] = l;
+        pB->ijkr[dim] = r;
+      }
+      for (dim=0; dim<3; dim++){
+        if (pM->Nx[dim] > 1 && pB->ijkr[dim] - pB->ijkl[dim] < nmin) break;
+      }
+      if (dim < 3) {
+        pL->box[n--] = pL->box[--(pL->n)];
+        changed = 1;
+      }
+    }
+
+/* Merge boxes that overlap or touch */
+
+    for (n=0; n<pL->n; n++){
+      for (m=n+1; m<pL->n; m++){
+        if (boxes_touch(&(pL->box[n]),&(pL->box[m])) == 0) continue;
+        for (dim=0; dim<3; dim++){
+          pL->box[n].ijkl[dim] = MIN(pL->box[n].ijkl[dim],pL->box[m].ijkl[dim]);
+          pL->box[n].ijkr[dim] = MAX(pL->box[n].ijkr[dim],pL->box[m].ijkr[dim]);
+        }
+        pL->box[m] = pL->box[--(pL->n)];
+        m = n;
+        changed = 1;
+      }
+    }
+
+/* Each footprint of a child in this region must lie inside one box */
+
+    for (f=0; f<pFoot->n; f++){
+      pF = &(pFoot->box[f]);
+      for (dim=0; dim<3; dim++){
+        if (pF->ijkl[dim] >= pA->ijkr[dim] || pF->ijkr[dim] <= pA->ijkl[dim])
+          break;
+      }
+      if (dim < 3) continue;
+
+      nov = in = 0;
+      for (n=0; n<pL->n; n++){
+        if (boxes_touch(pF,&(pL->box[n])) == 0) continue;
+        nov++;
+        for (dim=0; dim<3; dim++){
+          if (pF->ijkl[dim] < pL->box[n].ijkl[dim] ||
+              pF->ijkr[dim] > pL->box[n].ijkr[dim]) break;
+        }
+        if (dim == 3) in = 1;
+      }
+      if (nov == 1 && in) continue;
+
+      B = *pF;
+      for (n=0; n<pL->n; n++){
+        if (boxes_touch(pF,&(pL->box[n])) == 0) continue;
+        for (dim=0; dim<3; dim++){
+          B.ijkl[dim] = MIN(B.ijkl[dim],pL->box[n].ijkl[dim]);
+          B.ijkr[dim] = MAX(B.ijkr[dim],pL->box[n].ijkr[dim]);
+        }
+        pL->box[n--] = pL->box[--(pL->n)];
+      }
+      box_add(pL,&B);
+      changed = 1;
+    }
+  } while (changed);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void regrid_mesh(MeshS *pM, BoxListS *Old, BoxListS *New)
+ *  \brief Replaces the Domains of each adaptive level, with boxes Old, by new
+ *   Domains with boxes New, and sets the solution in them.  All processors
+ *   build the same new Domain array, then create the communicators, Grids,
+ *   Grid overlaps and buffers that depend on it.
+ */
+
+static void regrid_mesh(MeshS *pM, BoxListS *Old, BoxListS *New)
+{
+  DomainS **OldDomain,*pD,*pOD,*pPD;
+  int *OldDPL;
+  int nl,nd,nod,npd,ndom,nblock,dim,l,m,n;
+#ifdef MPI_PARALLEL
+  int ierr;
+#endif
+
+/*--- Step 1. Free everything that depends on the old Domains ----------------*/
+/* History dumps still being reduced use the communicators of the Domains */
+
+  dump_history_flush();
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      if (pM->Domain[nl][nd].Grid != NULL)
+        free_grid_overlaps(pM->Domain[nl][nd].Grid);
+    }
+  }
+  SMR_destruct(pM);
+  bvals_mhd_destruct(pM);
+
+/*--- Step 2. Build the new Domain array -------------------------------------*/
+/* Domains on fixed levels are copied.  Those on adaptive levels are new, and
+ * use the <domain> blocks from FirstBlock on. */
+
+  OldDomain = pM->Domain;
+  OldDPL = pM->DomainsPerLevel;
+
+  pM->DomainsPerLevel = (int*)calloc_1d_array(pM->NLevels,sizeof(int));
+  if (pM->DomainsPerLevel == NULL)
+    ath_error("[AMR_regrid]: malloc returned a NULL pointer\n");
+  ndom = 0;
+  for (nl=0; nl<(pM->NLevels); nl++){
+    pM->DomainsPerLevel[nl] = Adapt[nl] ? New[nl].n : OldDPL[nl];
+    ndom += pM->DomainsPerLevel[nl];
+  }
+
+  if ((pM->Domain = (DomainS**)calloc(pM->NLevels,sizeof(DomainS*))) == NULL)
+    ath_error("[AMR_regrid]: failed to allocate memory for Domain pointers\n");
+  if ((pM->Domain[0] = (DomainS*)calloc(ndom,sizeof(DomainS))) == NULL)
+    ath_error("[AMR_regrid]: failed to allocate memory for Domains\n");
+  for (nl=1; nl<(pM->NLevels); nl++)
+    pM->Domain[nl] = pM->Domain[nl-1] + pM->DomainsPerLevel[nl-1];
+
+  nblock = FirstBlock;
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      if (Adapt[nl]) {
+        new_domain(pM,&(pM->Domain[nl][nd]),nl,nd,&(New[nl].box[nd]),nblock);
+        nblock++;
+      } else {
+        pM->Domain[nl][nd] = OldDomain[nl][nd];
+      }
+    }
+  }
+  par_seti("job","num_domains","%d",nblock-1,NULL);
+
+/*--- Step 3. Assign the new Grids to processors, and create communicators ---*/
+
+#ifdef MPI_PARALLEL
+  balance_grids(pM, 1);
+  for (nl=1; nl<(pM->NLevels); nl++){
+    if (Adapt[nl] == 0) continue;
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++)
+      init_comm_domain(&(pM->Domain[nl][nd]));
+    for (nod=0; nod<OldDPL[nl]; nod++){
+      pOD = &(OldDomain[nl][nod]);
+      if (pOD->Comm_Domain != MPI_COMM_NULL)
+        ierr = MPI_Comm_free(&(pOD->Comm_Domain));
+      ierr = MPI_Group_free(&(pOD->Group_Domain));
+    }
+  }
+
+/* Comm_Parent of each Domain is Comm_Children of its parent */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nod=0; nod<OldDPL[nl]; nod++){
+      pOD = &(OldDomain[nl][nod]);
+      if (pOD->Comm_Children != MPI_COMM_NULL)
+        ierr = MPI_Comm_free(&(pOD->Comm_Children));
+      if (pOD->Group_Children != MPI_GROUP_NULL)
+        ierr = MPI_Group_free(&(pOD->Group_Children));
+    }
+  }
+  init_comm_children(pM);
+#endif /* MPI_PARALLEL */
+
+/*--- Step 4. Allocate the new Grids on this processor, and the Grid overlaps
+ * and buffers ----------------------------------------------------------------*/
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    if (Adapt[nl] == 0) continue;
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      for (n=0; n<(pD->NGrid[2]); n++){
+      for (m=0; m<(pD->NGrid[1]); m++){
+      for (l=0; l<(pD->NGrid[0]); l++){
+        if (pD->GData[n][m][l].ID_Comm_world == myID_Comm_world) {
+          if ((pD->Grid = (GridS*)malloc(sizeof(GridS))) == NULL)
+            ath_error("[AMR_regrid]: Failed to malloc a Grid for domain%d\n",
+              pD->InputBlock);
+          init_grid_domain(pM,pD);
+        }
+      }}}
+    }
+  }
+
+  init_grid_overlaps(pM);
+  SMR_init(pM);
+  bvals_mhd_init(pM);
+
+/*--- Step 5. Set solution on new Grids --------------------------------------*/
+/* First copy the solution from the old Domains of each adaptive level.  Then,
+ * level by level starting at the coarsest, set the ghost zones of the parents
+ * and prolongate the solution into the rest of the new Domains. */
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    if (Adapt[nl] == 0) continue;
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      for (nod=0; nod<OldDPL[nl]; nod++){
+        pOD = &(OldDomain[nl][nod]);
+        for (dim=0; dim<3; dim++){
+          if (pD->Disp[dim] >= pOD->Disp[dim] + pOD->Nx[dim] ||
+              pOD->Disp[dim] >= pD->Disp[dim] + pD->Nx[dim]) break;
+        }
+        if (dim == 3) copy_old(pD,pOD);
+      }
+    }
+  }
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    if (Adapt[nl] == 0) continue;
+    for (npd=0; npd<(pM->DomainsPerLevel[nl-1]); npd++){
+      if (pM->Domain[nl-1][npd].Grid != NULL)
+        bvals_mhd(&(pM->Domain[nl-1][npd]));
+    }
+
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = (DomainS*)&(pM->Domain[nl][nd]);
+      pPD = NULL;
+      for (npd=0; npd<(pM->DomainsPerLevel[nl-1]); npd++){
+        pPD = (DomainS*)&(pM->Domain[nl-1][npd]);
+        for (dim=0; dim<3; dim++){
+          if (pD->Nx[dim] > 1 && (pD->Disp[dim]/2 < pPD->Disp[dim] ||
+              (pD->Disp[dim] + pD->Nx[dim])/2 > pPD->Disp[dim] + pPD->Nx[dim]))
+            break;
+        }
+        if (dim == 3) break;
+        pPD = NULL;
+      }
+      if (pPD == NULL)
+        ath_error("[AMR_regrid]: no parent for Domain %d on level %d\n",nd,nl);
+      prolong_new(pM,pD,pPD,&(Old[nl]));
+    }
+  }
+
+/*--- Step 6. Free the old Domains, reallocate integrator arrays, and set
+ * ghost zones on all Grids ---------------------------------------------------*/
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    if (Adapt[nl] == 0) continue;
+    for (nod=0; nod<OldDPL[nl]; nod++){
+      pOD = &(OldDomain[nl][nod]);
+      if (pOD->Grid != NULL) free_grid(pOD->Grid);
+      free_3d_array(pOD->GData);
+    }
+  }
+  free(OldDomain[0]);
+  free(OldDomain);
+  free_1d_array(OldDPL);
+
+  lr_states_destruct();
+  lr_states_init(pM);
+  integrate_destruct();
+  integrate_init(pM);
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      if (pM->Domain[nl][nd].Grid != NULL) bvals_mhd(&(pM->Domain[nl][nd]));
+    }
+  }
+  Prolongate(pM);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void new_domain(MeshS *pM, DomainS *pD, const int nl,
+ *                             const int nd, const SideS *pB, const int nblock)
+ *  \brief Initializes Domain nd on adaptive level nl, with box pB, as in
+ *   init_mesh(), and divides it into Grids.  The Domain is saved in block
+ *   <domain[nblock]> so restart files reproduce it. */
+
+static void new_domain(MeshS *pM, DomainS *pD, const int nl, const int nd,
+                       const SideS *pB, const int nblock)
+{
+  char blk[80];
+  int i,irefine,izones;
+
+  irefine = 1 << nl;
+  pD->Level = nl;
+  pD->DomNumber = nd;
+  pD->InputBlock = nblock;
+  pD->Adaptive = 1;
+
+/* Set extent of Domain as in init_mesh() */
+
+  for (i=0; i<3; i++){
+    pD->RootMinX[i] = pM->RootMinX[i];
+    pD->RootMaxX[i] = pM->RootMaxX[i];
+    pD->Nx[i] = 1;
+    pD->Disp[i] = 0;
+    pD->dx[i] = pM->dx[i];
+    if (pM->Nx[i] > 1) {
+      pD->Nx[i] = pB->ijkr[i] - pB->ijkl[i];
+      pD->Disp[i] = pB->ijkl[i];
+      pD->dx[i] = pM->dx[i]/(Real)(irefine);
+    }
+
+    if (pD->Disp[i] == 0) {
+      pD->MinX[i] = pD->RootMinX[i];
+    } else {
+      pD->MinX[i] = pD->RootMinX[i] + ((Real)(pD->Disp[i]))*pD->dx[i];
+    }
+    izones = (pD->Disp[i] + pD->Nx[i])/irefine;
+    if (izones == pM->Nx[i]) {
+      pD->MaxX[i] = pD->RootMaxX[i];
+    } else {
+      pD->MaxX[i] = pD->MinX[i] + ((Real)(pD->Nx[i]))*pD->dx[i];
+    }
+  }
+
+/* Divide into Grids, which are assigned to processors by regrid_mesh() */
+
+#ifdef MPI_PARALLEL
+  choose_ngrid(pD);
+  pD->Comm_Domain = MPI_COMM_NULL;
+  pD->Comm_Parent = MPI_COMM_NULL;
+  pD->Comm_Children = MPI_COMM_NULL;
+  pD->Group_Children = MPI_GROUP_NULL;
+#else
+  for (i=0; i<3; i++) pD->NGrid[i] = 1;
+#endif
+  if ((pD->GData = (GridsDataS***)calloc_3d_array(pD->NGrid[2],pD->NGrid[1],
+    pD->NGrid[0],sizeof(GridsDataS))) == NULL)
+    ath_error("[AMR_regrid]: GData calloc returned a NULL pointer\n");
+  divide_domain(pD);
+  pD->Grid = NULL;
+
+/* Save the Domain in the par database */
+
+  sprintf(blk,"domain%d",nblock);
+  par_seti(blk,"level","%d",nl,NULL);
+  par_seti(blk,"Nx1","%d",pD->Nx[0],NULL);
+  par_seti(blk,"Nx2","%d",pD->Nx[1],NULL);
+  par_seti(blk,"Nx3","%d",pD->Nx[2],NULL);
+  par_seti(blk,"iDisp","%d",pD->Disp[0],NULL);
+  par_seti(blk,"jDisp","%d",pD->Disp[1],NULL);
+  par_seti(blk,"kDisp","%d",pD->Disp[2],NULL);
+  par_seti(blk,"AutoWithNProc","%d",0,NULL);
+  par_seti(blk,"NGrid_x1","%d",pD->NGrid[0],NULL);
+  par_seti(blk,"NGrid_x2","%d",pD->NGrid[1],NULL);
+  par_seti(blk,"NGrid_x3","%d",pD->NGrid[2],NULL);
+  par_seti(blk,"adaptive","%d",1,NULL);
+  par_setd(blk,"cost","%g",LevelCost[nl],NULL);
+
+  return;
+}
+
+#ifdef MPI_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn static void choose_ngrid(DomainS *pD)
+ *  \brief Chooses the number of Grids of a new Domain in each direction, for
+ *   Grids of about max_grid cells a side, with an even number of cells and at
+ *   least nghost, and no more Grids than processors. */
+
+static void choose_ngrid(DomainS *pD)
+{
+  int dim,dmax,g,gmax,n,Np,ierr;
+
+  ierr = MPI_Comm_size(MPI_COMM_WORLD, &Np);
+
+  for (dim=0; dim<3; dim++){
+    pD->NGrid[dim] = 1;
+    n = pD->Nx[dim];
+    if (n <= 1) continue;
+    gmax = MAX(n/nghost,1);
+    g = MIN((n + max_grid - 1)/max_grid, gmax);
+    while (g <= gmax && (n % (2*g)) != 0) g++;
+    if (g > gmax) {
+      g = MIN((n + max_grid - 1)/max_grid, gmax);
+      while (g > 1 && (n % (2*g)) != 0) g--;
+    }
+    pD->NGrid[dim] = g;
+  }
+
+/* Use fewer Grids across the direction with the most until they fit */
+
+  while ((pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]) > Np) {
+    dmax = 0;
+    for (dim=1; dim<3; dim++) if (pD->NGrid[dim] > pD->NGrid[dmax]) dmax = dim;
+    n = pD->Nx[dmax];
+    g = pD->NGrid[dmax] - 1;
+    while (g > 1 && (n % (2*g)) != 0) g--;
+    pD->NGrid[dmax] = g;
+  }
+
+  return;
+}
+#endif /* MPI_PARALLEL */
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void copy_old(DomainS *pD, DomainS *pOD)
+ *  \brief Copies the solution where the Grids of old Domain pOD overlap the
+ *   Grids of new Domain pD on the same level, including face-centered fields
+ *   on the faces of the overlap.
+ */
+
+static void copy_old(DomainS *pD, DomainS *pOD)
+{
+  GridsDataS *pO,*pN;
+  SideS R;
+  double **buf;
+  int i,lo,mo,no,ln,mn,nn,ngo,ng,nmsg,cnt;
+#ifdef MPI_PARALLEL
+  MPI_Request *rq;
+  int ierr,nrq=0;
+#endif
+
+  ngo = (pOD->NGrid[0])*(pOD->NGrid[1])*(pOD->NGrid[2]);
+  ng = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+  if ((buf = (double**)calloc_1d_array(ngo*ng,sizeof(double*))) == NULL)
+    ath_error("[AMR_regrid]: Failed to allocate copy buffers\n");
+#ifdef MPI_PARALLEL
+  if ((rq = (MPI_Request*)calloc_1d_array(ngo*ng,sizeof(MPI_Request)))==NULL)
+    ath_error("[AMR_regrid]: Failed to allocate copy requests\n");
+#endif
+
+/* Loop over all pairs of old and new Grids, post receives on the new Grid,
+ * and send (or copy, on the same processor) from the old Grid */
+
+  nmsg = 0;
+  for (no=0; no<(pOD->NGrid[2]); no++){
+  for (mo=0; mo<(pOD->NGrid[1]); mo++){
+  for (lo=0; lo<(pOD->NGrid[0]); lo++){
+    pO = &(pOD->GData[no][mo][lo]);
+    for (nn=0; nn<(pD->NGrid[2]); nn++){
+    for (mn=0; mn<(pD->NGrid[1]); mn++){
+    for (ln=0; ln<(pD->NGrid[0]); ln++){
+      pN = &(pD->GData[nn][mn][ln]);
+      if (pO->ID_Comm_world != myID_Comm_world &&
+          pN->ID_Comm_world != myID_Comm_world) continue;
+
+      for (i=0; i<3; i++) {
+        R.ijkl[i] = MAX(pO->Disp[i], pN->Disp[i]);
+        R.ijkr[i] = MIN(pO->Disp[i] + pO->Nx[i], pN->Disp[i] + pN->Nx[i]);
+      }
+      cnt = region_data(pD,NULL,&R,NULL,0);
+      if (cnt == 0) continue;
+      if ((buf[nmsg] = (double*)calloc_1d_array(cnt,sizeof(double))) == NULL)
+        ath_error("[AMR_regrid]: Failed to allocate copy buffer\n");
+
+      if (pO->ID_Comm_world == myID_Comm_world) {
+        region_data(pD,pOD->Grid,&R,buf[nmsg],1);
+        if (pN->ID_Comm_world == myID_Comm_world) {
+          region_data(pD,pD->Grid,&R,buf[nmsg],0);
+        }
+#ifdef MPI_PARALLEL
+        else {
+          ierr = MPI_Isend(buf[nmsg],cnt,MPI_DOUBLE,pN->ID_Comm_world,
+            pD->DomNumber,MPI_COMM_WORLD,&(rq[nrq++]));
+        }
+      } else {
+        ierr = MPI_Irecv(buf[nmsg],cnt,MPI_DOUBLE,pO->ID_Comm_world,
+          pD->DomNumber,MPI_COMM_WORLD,&(rq[nrq++]));
+#endif /* MPI_PARALLEL */
+      }
+      nmsg++;
+    }}}
+  }}}
+
+#ifdef MPI_PARALLEL
+/* Wait for all messages, then store the data received */
+
+  ierr = MPI_Waitall(nrq,rq,MPI_STATUSES_IGNORE);
+
+  nmsg = 0;
+  for (no=0; no<(pOD->NGrid[2]); no++){
+  for (mo=0; mo<(pOD->NGrid[1]); mo++){
+  for (lo=0; lo<(pOD->NGrid[0]); lo++){
+    pO = &(pOD->GData[no][mo][lo]);
+    for (nn=0; nn<(pD->NGrid[2]); nn++){
+    for (mn=0; mn<(pD->NGrid[1]); mn++){
+    for (ln=0; ln<(pD->NGrid[0]); ln++){
+      pN = &(pD->GData[nn][mn][ln]);
+      if (pO->ID_Comm_world != myID_Comm_world &&
+          pN->ID_Comm_world != myID_Comm_world) continue;
+
+      for (i=0; i<3; i++) {
+        R.ijkl[i] = MAX(pO->Disp[i], pN->Disp[i]);
+        R.ijkr[i] = MIN(pO->Disp[i] + pO->Nx[i], pN->Disp[i] + pN->Nx[i]);
+      }
+      if (region_data(pD,NULL,&R,NULL,0) == 0) continue;
+      if (pO->ID_Comm_world != myID_Comm_world)
+        region_data(pD,pD->Grid,&R,buf[nmsg],0);
+      nmsg++;
+    }}}
+  }}}
+  free_1d_array(rq);
+#endif /* MPI_PARALLEL */
+
+  for (i=0; i<nmsg; i++) free_1d_array(buf[i]);
+  free_1d_array(buf);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void prolong_new(MeshS *pM, DomainS *pD, DomainS *pPD,
+ *                              const BoxListS *pOld)
+ *  \brief Prolongates the solution on parent Domain pPD into the cells of the
+ *   new Grids of Domain pD outside the old boxes pOld of its level.  Ghost
+ *   zones of the parent must be set.  Each new Grid receives the parent cells
+ *   it covers plus one on each side, from all parent Grids, and then sets each
+ *   2x2x2 block of cells outside the old boxes with ProCon() and ProFld() as
+ *   in Prolongate(), but with E shifted so the block holds the energy of its
+ *   parent cell.  Fields on faces shared with the old boxes were copied by
+ *   copy_old() and are kept.
+ */
+
+static void prolong_new(MeshS *pM, DomainS *pD, DomainS *pPD,
+                        const BoxListS *pOld)
+{
+  GridS *pG,*pPG;
+  GridsDataS *pC,*pP;
+  SideS Rq,Rm,R,E;
+  ConsS Uc[3][3][3],ProlongedC[2][2][2];
+  double **buf,*pA,*p;
+  Real *pU;
+#ifndef BAROTROPIC
+  Real dE;
+#endif
+  int nDim,dim,ng,nmsg,nmine=0,ln,mn,nn,lp,mp,np,cnt,v,nw[3],nA;
+  int ic,jc,kc,i,j,k,l,m,n,ip,jp,kp,mend,nend;
+  int gi,gj,gk,o[3],oe[3];
+#ifdef MHD
+  Real3Vect BGZ[3][3][3], ProlongedF[3][3][3];
+  int pre[3][2],ii,kk,nb[3];
+#endif
+#ifdef MPI_PARALLEL
+  MPI_Request *rq;
+  int ierr,nrq=0;
+#endif
+
+  pG = pD->Grid;
+  pPG = pPD->Grid;
+  nDim = 1;
+  for (dim=1; dim<3; dim++) if (pM->Nx[dim] > 1) nDim++;
+
+  ng = (pPD->NGrid[0])*(pPD->NGrid[1])*(pPD->NGrid[2]);
+  ng *= (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+  if ((buf = (double**)calloc_1d_array(ng,sizeof(double*))) == NULL)
+    ath_error("[AMR_regrid]: Failed to allocate prolongation buffers\n");
+#ifdef MPI_PARALLEL
+  if ((rq = (MPI_Request*)calloc_1d_array(ng,sizeof(MPI_Request))) == NULL)
+    ath_error("[AMR_regrid]: Failed to allocate prolongation requests\n");
+#endif
+  pA = NULL;
+
+/* Loop over new Grids of this Domain that are not inside the old boxes, and
+ * parent Grids on this processor or sending to it */
+
+  nmsg = 0;
+  for (nn=0; nn<(pD->NGrid[2]); nn++){
+  for (mn=0; mn<(pD->NGrid[1]); mn++){
+  for (ln=0; ln<(pD->NGrid[0]); ln++){
+    pC = &(pD->GData[nn][mn][ln]);
+    for (dim=0; dim<3; dim++) oe[dim] = pC->Disp[dim] + pC->Nx[dim];
+    if (in_boxes(pOld,nDim,pC->Disp,oe)) continue;
+
+/* parent cells needed by this Grid, in global indices of the parent */
+
+    for (dim=0; dim<3; dim++) {
+      Rq.ijkl[dim] = 0;
+      Rq.ijkr[dim] = 1;
+      if (pM->Nx[dim] > 1) {
+        Rq.ijkl[dim] = pC->Disp[dim]/2 - 1;
+        Rq.ijkr[dim] = (pC->Disp[dim] + pC->Nx[dim])/2 + 1;
+      }
+      nw[dim] = Rq.ijkr[dim] - Rq.ijkl[dim];
+    }
+    if (pC->ID_Comm_world == myID_Comm_world) {
+      Rm = Rq;
+      nmine = nmsg;
+      nA = nw[0]*nw[1]*nw[2]*(NPRO);
+      if ((pA = (double*)calloc_1d_array(nA,sizeof(double))) == NULL)
+        ath_error("[AMR_regrid]: Failed to allocate parent cells\n");
+    }
+
+    for (np=0; np<(pPD->NGrid[2]); np++){
+    for (mp=0; mp<(pPD->NGrid[1]); mp++){
+    for (lp=0; lp<(pPD->NGrid[0]); lp++){
+      pP = &(pPD->GData[np][mp][lp]);
+      if (pP->ID_Comm_world != myID_Comm_world &&
+          pC->ID_Comm_world != myID_Comm_world) continue;
+
+/* Parent Grid sends its cells, and its ghost zones at edges of its Domain */
+
+      for (dim=0; dim<3; dim++) {
+        E.ijkl[dim] = pP->Disp[dim];
+        E.ijkr[dim] = pP->Disp[dim] + pP->Nx[dim];
+        if (pM->Nx[dim] > 1) {
+          if (pP->Disp[dim] == pPD->Disp[dim]) E.ijkl[dim]--;
+          if (E.ijkr[dim] == pPD->Disp[dim] + pPD->Nx[dim]) E.ijkr[dim]++;
+        }
+        R.ijkl[dim] = MAX(Rq.ijkl[dim],E.ijkl[dim]);
+        R.ijkr[dim] = MIN(Rq.ijkr[dim],E.ijkr[dim]);
+      }
+      if (R.ijkl[0] >= R.ijkr[0] || R.ijkl[1] >= R.ijkr[1] ||
+          R.ijkl[2] >= R.ijkr[2]) continue;
+      cnt = (R.ijkr[0]-R.ijkl[0])*(R.ijkr[1]-R.ijkl[1])*(R.ijkr[2]-R.ijkl[2]);
+      cnt *= (NPRO);
+
+      if ((buf[nmsg] = (double*)calloc_1d_array(cnt,sizeof(double))) == NULL)
+        ath_error("[AMR_regrid]: Failed to allocate prolongation buffer\n");
+
+      if (pP->ID_Comm_world == myID_Comm_world) {
+        p = buf[nmsg];
+        for (gk=R.ijkl[2]; gk<R.ijkr[2]; gk++) {
+        for (gj=R.ijkl[1]; gj<R.ijkr[1]; gj++) {
+        for (gi=R.ijkl[0]; gi<R.ijkr[0]; gi++) {
+          k = gk - pPG->Disp[2] + pPG->ks;
+          j = gj - pPG->Disp[1] + pPG->js;
+          i = gi - pPG->Disp[0] + pPG->is;
+          for (v=0; v<NCONS_VAR; v++) *(p++) = GRID_UN(pPG,k,j,i,v);
+#ifdef MHD
+          *(p++) = pPG->B1i[k][j][i];
+          *(p++) = pPG->B2i[k][j][i];
+          *(p++) = pPG->B3i[k][j][i];
+#endif
+        }}}
+#ifdef MPI_PARALLEL
+        if (pC->ID_Comm_world != myID_Comm_world) {
+          ierr = MPI_Isend(buf[nmsg],cnt,MPI_DOUBLE,pC->ID_Comm_world,
+            pD->DomNumber,MPI_COMM_WORLD,&(rq[nrq++]));
+        }
+      } else {
+        ierr = MPI_Irecv(buf[nmsg],cnt,MPI_DOUBLE,pP->ID_Comm_world,
+          pD->DomNumber,MPI_COMM_WORLD,&(rq[nrq++]));
+#endif /* MPI_PARALLEL */
+      }
+      nmsg++;
+    }}}
+  }}}
+
+#ifdef MPI_PARALLEL
+  ierr = MPI_Waitall(nrq,rq,MPI_STATUSES_IGNORE);
+  free_1d_array(rq);
+#endif /* MPI_PARALLEL */
+
+/* The Grid of this Domain on this processor (if it needs prolongation) stores
+ * the parent cells it received, in the same order as they were sent above */
+
+  if (pA != NULL) {
+    Rq = Rm;
+    for (dim=0; dim<3; dim++) nw[dim] = Rq.ijkr[dim] - Rq.ijkl[dim];
+    nmsg = nmine;
+
+    for (np=0; np<(pPD->NGrid[2]); np++){
+    for (mp=0; mp<(pPD->NGrid[1]); mp++){
+    for (lp=0; lp<(pPD->NGrid[0]); lp++){
+      pP = &(pPD->GData[np][mp][lp]);
+      for (dim=0; dim<3; dim++) {
+        E.ijkl[dim] = pP->Disp[dim];
+        E.ijkr[dim] = pP->Disp[dim] + pP->Nx[dim];
+        if (pM->Nx[dim] > 1) {
+          if (pP->Disp[dim] == pPD->Disp[dim]) E.ijkl[dim]--;
+          if (E.ijkr[dim] == pPD->Disp[dim] + pPD->Nx[dim]) E.ijkr[dim]++;
+        }
+        R.ijkl[dim] = MAX(Rq.ijkl[dim],E.ijkl[dim]);
+        R.ijkr[dim] = MIN(Rq.ijkr[dim],E.ijkr[dim]);
+      }
+      if (R.ijkl[0] >= R.ijkr[0] || R.ijkl[1] >= R.ijkr[1] ||
+          R.ijkl[2] >= R.ijkr[2]) continue;
+
+      p = buf[nmsg++];
+      for (gk=R.ijkl[2]; gk<R.ijkr[2]; gk++) {
+      for (gj=R.ijkl[1]; gj<R.ijkr[1]; gj++) {
+      for (gi=R.ijkl[0]; gi<R.ijkr[0]; gi++) {
+        v = (((gk-Rq.ijkl[2])*nw[1] + (gj-Rq.ijkl[1]))*nw[0] +
+             (gi-Rq.ijkl[0]))*(NPRO);
+        memcpy(&(pA[v]),p,(NPRO)*sizeof(double));
+        p += (NPRO);
+      }}}
+    }}}
+
+/*--- Prolongate each 2x2x2 block of fine cells outside the old boxes --------*/
+
+    mend = (pG->Nx[1] > 1) ? 1 : 0;
+    nend = (pG->Nx[2] > 1) ? 1 : 0;
+    for (kc=Rq.ijkl[2]+nend; kc<Rq.ijkr[2]-nend; kc++) {
+    for (jc=Rq.ijkl[1]+mend; jc<Rq.ijkr[1]-mend; jc++) {
+    for (ic=Rq.ijkl[0]+1;    ic<Rq.ijkr[0]-1;    ic++) {
+      o[0] = 2*ic;
+      o[1] = (mend ? 2*jc : 0);
+      o[2] = (nend ? 2*kc : 0);
+      for (dim=0; dim<3; dim++) oe[dim] = o[dim] + 2;
+      if (in_boxes(pOld,nDim,o,oe)) continue;
+      i = o[0] - pG->Disp[0] + pG->is;
+      j = o[1] - pG->Disp[1] + pG->js;
+      k = o[2] - pG->Disp[2] + pG->ks;
+
+/* Load conserved variables (and faces) of parent cell and its neighbours,
+ * repeating the cell itself in missing dimensions */
+
+      for (n=0; n<3; n++) {
+      for (m=0; m<3; m++) {
+      for (l=0; l<3; l++) {
+        kp = kc - Rq.ijkl[2] + (nend ? n-1 : 0);
+        jp = jc - Rq.ijkl[1] + (mend ? m-1 : 0);
+        ip = ic - Rq.ijkl[0] + l-1;
+        p = &(pA[((kp*nw[1] + jp)*nw[0] + ip)*(NPRO)]);
+        pU = (Real*)&(Uc[n][m][l]);
+        for (v=0; v<NCONS_VAR; v++) pU[v] = p[v];
+#ifdef MHD
+        BGZ[n][m][l].x1 = p[NCONS_VAR  ];
+        BGZ[n][m][l].x2 = p[NCONS_VAR+1];
+        BGZ[n][m][l].x3 = p[NCONS_VAR+2];
+#endif
+      }}}
+
+      ProCon(Uc[1][1][0],Uc[1][1][1],Uc[1][1][2],
+             Uc[1][0][1],            Uc[1][2][1],
+             Uc[0][1][1],            Uc[2][1][1], ProlongedC);
+
+#ifndef BAROTROPIC
+/* ProCon() prolongates the pressure, so shift E to conserve total energy */
+
+      dE = 0.0;
+      for (n=0; n<2; n++) {
+      for (m=0; m<2; m++) {
+      for (l=0; l<2; l++) {
+        dE += ProlongedC[n][m][l].E;
+      }}}
+      dE = Uc[1][1][1].E - 0.125*dE;
+      for (n=0; n<2; n++) {
+      for (m=0; m<2; m++) {
+      for (l=0; l<2; l++) {
+        ProlongedC[n][m][l].E += dE;
+      }}}
+#endif /* BAROTROPIC */
+
+      for (n=0; n<=nend; n++) {
+      for (m=0; m<=mend; m++) {
+      for (l=0; l<=1; l++) {
+        pU = (Real*)&(ProlongedC[n][m][l]);
+        for (v=0; v<NCONS_VAR; v++) GRID_UN(pG,k+n,j+m,i+l,v) = pU[v];
+      }}}
+
+#ifdef MHD
+/* Faces shared with a block inside the old boxes were copied, so are kept */
+
+      for (dim=0; dim<nDim; dim++) {
+        for (ii=0; ii<2; ii++) {
+          for (kk=0; kk<3; kk++) {
+            nb[kk] = o[kk];
+            if (kk == dim) nb[kk] += (ii == 0 ? -2 : 2);
+            oe[kk] = nb[kk] + 2;
+          }
+          pre[dim][ii] = in_boxes(pOld,nDim,nb,oe);
+        }
+      }
+
+      if (nDim == 1) {
+        for (l=0; l<=1; l++) {
+          if (l > 0 || !pre[0][0]) pG->B1i[k][j][i+l] = GRID_U(pG,k,j,i+l,B1c);
+          pG->B2i[k][j][i+l] = GRID_U(pG,k,j,i+l,B2c);
+          pG->B3i[k][j][i+l] = GRID_U(pG,k,j,i+l,B3c);
+        }
+        if (!pre[0][1]) pG->B1i[k][j][i+2] = GRID_U(pG,k,j,i+1,B1c);
+      } else {
+        for (n=0; n<3; n++) {
+        for (m=0; m<3; m++) {
+        for (l=0; l<3; l++) {
+          ProlongedF[n][m][l].x1 = 0.0;
+          ProlongedF[n][m][l].x2 = 0.0;
+          ProlongedF[n][m][l].x3 = 0.0;
+        }}}
+        for (n=0; n<2; n++) {
+        for (m=0; m<2; m++) {
+          kk = k + (nend ? n : 0);
+          if (pre[0][0]) ProlongedF[n][m][0].x1 = pG->B1i[kk][j+m][i  ];
+          if (pre[0][1]) ProlongedF[n][m][2].x1 = pG->B1i[kk][j+m][i+2];
+          if (pre[1][0]) ProlongedF[n][0][m].x2 = pG->B2i[kk][j  ][i+m];
+          if (pre[1][1]) ProlongedF[n][2][m].x2 = pG->B2i[kk][j+2][i+m];
+          if (nDim == 3) {
+            if (pre[2][0]) ProlongedF[0][n][m].x3 = pG->B3i[k  ][j+n][i+m];
+            if (pre[2][1]) ProlongedF[2][n][m].x3 = pG->B3i[k+2][j+n][i+m];
+          }
+        }}
+
+        ProFld(BGZ, ProlongedF, pG->dx1, pG->dx2, pG->dx3);
+
+        for (n=0; n<=nend; n++) {
+        for (m=0; m<=mend; m++) {
+        for (l=0; l<=1; l++) {
+          if (l > 0 || !pre[0][0])
+            pG->B1i[k+n][j+m][i+l] = ProlongedF[n][m][l].x1;
+          if (m > 0 || !pre[1][0])
+            pG->B2i[k+n][j+m][i+l] = ProlongedF[n][m][l].x2;
+          if (nDim < 3 || n > 0 || !pre[2][0])
+            pG->B3i[k+n][j+m][i+l] = ProlongedF[n][m][l].x3;
+
+          GRID_U(pG,k+n,j+m,i+l,B1c) =
+            0.5*(ProlongedF[n][m][l].x1 + ProlongedF[n][m][l+1].x1);
+          GRID_U(pG,k+n,j+m,i+l,B2c) =
+            0.5*(ProlongedF[n][m][l].x2 + ProlongedF[n][m+1][l].x2);
+          GRID_U(pG,k+n,j+m,i+l,B3c) =
+            0.5*(ProlongedF[n][m][l].x3 + ProlongedF[n+1][m][l].x3);
+        }}}
+
+/* faces on the far side of the block, at the edge of the Grid or shared with
+ * the next block */
+
+        for (n=0; n<=nend; n++) {
+        for (m=0; m<=1; m++) {
+          if (!pre[0][1])
+            pG->B1i[k+n][j+(mend ? m : 0)][i+2] = ProlongedF[n][mend ? m : 0][2].x1;
+          if (!pre[1][1])
+            pG->B2i[k+n][j+2][i+m] = ProlongedF[n][2][m].x2;
+        }}
+        if (nDim == 3 && !pre[2][1]) {
+          for (m=0; m<=1; m++) {
+          for (l=0; l<=1; l++) {
+            pG->B3i[k+2][j+m][i+l] = ProlongedF[2][m][l].x3;
+          }}
+        }
+      }
+#endif /* MHD */
+    }}}
+
+    free_1d_array(pA);
+  }
+
+  for (i=0; i<ng; i++) if (buf[i] != NULL) free_1d_array(buf[i]);
+  free_1d_array(buf);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int region_data(DomainS *pD, GridS *pG, const SideS *pR,
+ *                             double *pBuf, const int load)
+ *  \brief Loads pBuf with (load=1) or stores it into (load=0) the conserved
+ *   variables of Grid pG in the cells of region pR, in global indices of
+ *   Domain pD, and with MHD the fields on all faces of these cells.  Returns
+ *   the number of values, without touching pG or pBuf if pG is NULL.
+ */
+
+static int region_data(DomainS *pD, GridS *pG, const SideS *pR, double *pBuf,
+                       const int load)
+{
+  int i,j,k,v,dim,cnt=0,ncell=1,nface[3];
+  int is=0,js=0,ks=0;
+  double *p = pBuf;
+
+  for (dim=0; dim<3; dim++) {
+    ncell *= MAX(pR->ijkr[dim] - pR->ijkl[dim], 0);
+  }
+  cnt = ncell*NCONS_VAR;
+
+#ifdef MHD
+/* in each direction, one more face than cells; none if the cells do not
+ * overlap in the other directions */
+
+  for (dim=0; dim<3; dim++) {
+    nface[dim] = 1;
+    for (v=0; v<3; v++) {
+      if (v == dim && pD->Nx[v] > 1)
+        nface[dim] *= MAX(pR->ijkr[v] - pR->ijkl[v] + 1, 0);
+      else
+        nface[dim] *= MAX(pR->ijkr[v] - pR->ijkl[v], 0);
+    }
+    cnt += nface[dim];
+  }
+#endif
+  if (pG == NULL || cnt == 0) return cnt;
+
+  is = pG->is - pG->Disp[0];
+  js = pG->js - pG->Disp[1];
+  ks = pG->ks - pG->Disp[2];
+
+  for (k=pR->ijkl[2]; k<pR->ijkr[2]; k++) {
+  for (j=pR->ijkl[1]; j<pR->ijkr[1]; j++) {
+  for (i=pR->ijkl[0]; i<pR->ijkr[0]; i++) {
+    for (v=0; v<NCONS_VAR; v++) {
+      if (load) *(p++) = GRID_UN(pG,k+ks,j+js,i+is,v);
+      else GRID_UN(pG,k+ks,j+js,i+is,v) = *(p++);
+    }
+  }}}
+
+#ifdef MHD
+  if (nface[0] > 0) {
+    for (k=pR->ijkl[2]; k<pR->ijkr[2]; k++) {
+    for (j=pR->ijkl[1]; j<pR->ijkr[1]; j++) {
+    for (i=pR->ijkl[0]; i<pR->ijkr[0] + (pD->Nx[0] > 1 ? 1 : 0); i++) {
+      if (load) *(p++) = pG->B1i[k+ks][j+js][i+is];
+      else pG->B1i[k+ks][j+js][i+is] = *(p++);
+    }}}
+  }
+  if (nface[1] > 0) {
+    for (k=pR->ijkl[2]; k<pR->ijkr[2]; k++) {
+    for (j=pR->ijkl[1]; j<pR->ijkr[1] + (pD->Nx[1] > 1 ? 1 : 0); j++) {
+    for (i=pR->ijkl[0]; i<pR->ijkr[0]; i++) {
+      if (load) *(p++) = pG->B2i[k+ks][j+js][i+is];
+      else pG->B2i[k+ks][j+js][i+is] = *(p++);
+    }}}
+  }
+  if (nface[2] > 0) {
+    for (k=pR->ijkl[2]; k<pR->ijkr[2] + (pD->Nx[2] > 1 ? 1 : 0); k++) {
+    for (j=pR->ijkl[1]; j<pR->ijkr[1]; j++) {
+    for (i=pR->ijkl[0]; i<pR->ijkr[0]; i++) {
+      if (load) *(p++) = pG->B3i[k+ks][j+js][i+is];
+      else pG->B3i[k+ks][j+js][i+is] = *(p++);
+    }}}
+  }
+#endif /* MHD */
+
+  return cnt;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void free_grid(GridS *pG)
+ *  \brief Frees a Grid allocated by AMR_regrid() or init_mesh() */
+
+static void free_grid(GridS *pG)
+{
+  free_grid_U(pG);
+#ifdef MHD
+  free_3d_array(pG->B1i);
+  free_3d_array(pG->B2i);
+  free_3d_array(pG->B3i);
+#endif /* MHD */
+  free_grid_overlaps(pG);
+  free(pG);
+
+  return;
+}
+
+#endif /* ADAPTIVE_MESH_REFINEMENT */
@@ -22,14 +22,19 @@
  *   - calloc_1d_array() - creates 1D array
  *   - calloc_2d_array() - creates 2D array
  *   - calloc_3d_array() - creates 3D array
+ *   - calloc_3d_array_aligned() - creates 3D array with aligned, padded rows
  *   - free_1d_array()   - destroys 1D array
  *   - free_2d_array()   - destroys 2D array
  *   - free_3d_array()   - destroys 3D array				      */
 /*============================================================================*/
 
 #include <stdlib.h>
+#include <string.h>
 #include "prototypes.h"
 
+/* alignment (in bytes) of the rows of arrays from calloc_3d_array_aligned() */
+#define ATH_ALIGN 64
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void* calloc_1d_array(size_t nc, size_t size)
  *  \brief Construct 1D array = array[nc]  */
@@ -119,6 +124,57 @@ void*** calloc_3d_array(size_t nt, size_t nr, size_t nc, size_t size)
   return array;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void*** calloc_3d_array_aligned(size_t nt, size_t nr, size_t nc,
+ *                                      size_t size)
+ *  \brief Construct 3D array = array[nt][nr][nc] in which every row
+ *   array[k][j] starts on an ATH_ALIGN byte boundary.  Rows are padded, so
+ *   array[k][j+1] != array[k][j] + nc in general.  Free with free_3d_array().
+ */
+void*** calloc_3d_array_aligned(size_t nt, size_t nr, size_t nc, size_t size)
+{
+  void ***array;
+  void *data;
+  size_t i,j,ncp;
+
+/* row length in bytes, rounded up to a multiple of ATH_ALIGN */
+  ncp = ((nc*size + ATH_ALIGN - 1)/ATH_ALIGN)*ATH_ALIGN;
+
+  if((array = (void ***)calloc(nt,sizeof(void**))) == NULL){
+    ath_error("[calloc_3d_aligned] failed to allocate memory for %d 1st-pointers\n",
+              (int)nt);
+    return NULL;
+  }
+
+  if((array[0] = (void **)calloc(nt*nr,sizeof(void*))) == NULL){
+    ath_error("[calloc_3d_aligned] failed to allocate memory for %d 2nd-pointers\n",
+              (int)(nt*nr));
+    free((void *)array);
+    return NULL;
+  }
+
+  for(i=1; i<nt; i++){
+    array[i] = (void **)((unsigned char *)array[0] + i*nr*sizeof(void*));
+  }
+
+  if(posix_memalign(&data, ATH_ALIGN, nt*nr*ncp) != 0){
+    ath_error("[calloc_3d_aligned] failed to alloc. memory (%d X %d X %d of size %d)\n",
+              (int)nt,(int)nr,(int)nc,(int)size);
+    free((void *)array[0]);
+    free((void *)array);
+    return NULL;
+  }
+  memset(data, 0, nt*nr*ncp);
+
+  for(i=0; i<nt; i++){
+    for(j=0; j<nr; j++){
+      array[i][j] = (void *)((unsigned char *)data + (i*nr + j)*ncp);
+    }
+  }
+
+  return array;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void free_1d_array(void *array)
  *  \brief Free memory used by 1D array  */
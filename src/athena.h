@@ -14,8 +14,13 @@
  * - GridS   - everything in a single Grid
  * - DomainS - everything in a single Domain (potentially many Grids)
  * - MeshS   - everything across whole Mesh (potentially many Domains)
- * - OutputS - everything associated with an individual output		      */
+ * - OutputS - everything associated with an individual output
+ * - ZFileS  - file written through the compression functions
+ * - RstFieldS - entry of the index of a restart file
+ * - RstIndexS - index of a restart file being written
+ * - RstMapS - restart file mapped into memory			      */
 /*============================================================================*/
+#include <stdio.h>
 #include "defs.h"
 
 #ifdef MPI_PARALLEL
@@ -104,6 +109,35 @@ typedef struct Cons_s{
 #endif
 }ConsS;
 
+#ifdef SOA_LAYOUT
+/*----------------------------------------------------------------------------*/
+/*! \struct ConsArrS
+ *  \brief Conserved variables stored as one 3D array per variable, used for
+ *   GridS.U with --enable-soa.
+ *  IMPORTANT!! The elements must be in the same order as in ConsS.
+ */
+typedef struct ConsArr_s{
+  Real ***d;			/*!< density */
+  Real ***M1;			/*!< momentum density in 1-direction*/
+  Real ***M2;			/*!< momentum density in 2-direction*/
+  Real ***M3;			/*!< momentum density in 3-direction*/
+#ifndef BAROTROPIC
+  Real ***E;			/*!< total energy density */
+#endif /* BAROTROPIC */
+#ifdef MHD
+  Real ***B1c;			/*!< cell centered magnetic fields in 1-dir*/
+  Real ***B2c;			/*!< cell centered magnetic fields in 2-dir*/
+  Real ***B3c;			/*!< cell centered magnetic fields in 3-dir*/
+#endif /* MHD */
+#if (NSCALARS > 0)
+  Real ***s[NSCALARS];          /*!< passively advected scalars */
+#endif
+#ifdef CYLINDRICAL
+  Real ***Pflux;	 	/*!< pressure component of flux */
+#endif
+}ConsArrS;
+#endif /* SOA_LAYOUT */
+
 /*----------------------------------------------------------------------------*/
 /*! \struct PrimS
  *  \brief Primitive variables.
@@ -278,6 +312,10 @@ typedef struct GridOvrlp_s{
   Real **myEMF2[6];      /*!< fluxes of magnetic field (EMF2) at 6 boundaries */
   Real **myEMF3[6];      /*!< fluxes of magnetic field (EMF3) at 6 boundaries */
 #endif
+#ifdef SMR_AGGREGATE
+  int AggP, AggRC;     /*!< aggregated message with Prol and Rest/Corr data */
+  double *pAggP, *pAggRC; /*!< start of data of this overlap in those messages */
+#endif
 }GridOvrlpS;
 #endif /* STATIC_MESH_REFINEMENT */
 
@@ -290,10 +328,17 @@ typedef struct GridOvrlp_s{
  *   Remember a Grid is defined as the region of a Domain at some
  *   refinement level being updated by a single processor.  Uses an array of
  *   ConsS, rather than arrays of each variable, to increase locality of data
- *   for a given cell in memory.  */
+ *   for a given cell in memory.  With --enable-soa each variable is instead
+ *   stored in its own padded and aligned 3D array, so sweeps over one variable
+ *   are contiguous.  The conserved variables should always be accessed with
+ *   the GRID_U() family of macros below, which work with either layout. */
 
 typedef struct Grid_s{
+#ifdef SOA_LAYOUT
+  ConsArrS U;                /*!< conserved variables */
+#else
   ConsS ***U;                /*!< conserved variables */
+#endif
 #ifdef MHD
   Real ***B1i,***B2i,***B3i;    /*!< interface magnetic fields */
 #ifdef RESISTIVITY
@@ -355,8 +400,32 @@ typedef struct Grid_s{
   UnitS units;
 #endif
 
+#ifdef FUSED_CFL
+  Real max_v1,max_v2,max_v3; /*!< max signal speeds found by the integrator */
+  int cfl_set;   /*!< 1 if max_v1,2,3 are set for the current state, else 0 */
+#endif /* FUSED_CFL */
+
 }GridS;
 
+/* Access to the conserved variables of a Grid with either storage layout:
+ * - GRID_U(pG,k,j,i,var) - variable var (d, M1, ..., s[n]) in cell (i,j,k)
+ * - GRID_UN(pG,k,j,i,n)  - n-th variable in ConsS order in cell (i,j,k)
+ * - GET_GRID_U(pG,k,j,i) - all variables in cell (i,j,k) as a ConsS
+ * - SET_GRID_U(pG,k,j,i,Uc) - sets all variables in cell (i,j,k) from ConsS Uc
+ * NCONS_VAR is the number of Reals in a ConsS. */
+#define NCONS_VAR ((int)(sizeof(ConsS)/sizeof(Real)))
+#ifdef SOA_LAYOUT
+#define GRID_U(pG,k,j,i,var) ((pG)->U.var[k][j][i])
+#define GRID_UN(pG,k,j,i,n) (((Real****)&((pG)->U))[n][k][j][i])
+#define GET_GRID_U(pG,k,j,i) get_grid_cons((pG),(k),(j),(i))
+#define SET_GRID_U(pG,k,j,i,Uc) set_grid_cons((pG),(k),(j),(i),(Uc))
+#else
+#define GRID_U(pG,k,j,i,var) ((pG)->U[k][j][i].var)
+#define GRID_UN(pG,k,j,i,n) (((Real*)&((pG)->U[k][j][i]))[n])
+#define GET_GRID_U(pG,k,j,i) ((pG)->U[k][j][i])
+#define SET_GRID_U(pG,k,j,i,Uc) ((pG)->U[k][j][i] = (Uc))
+#endif /* SOA_LAYOUT */
+
 /*! \fn void (*VGFun_t)(GridS *pG)
  *  \brief Generic void function of Grid. */
 typedef void (*VGFun_t)(GridS *pG);    /* generic void function of Grid */
@@ -382,6 +451,9 @@ typedef struct Domain_s{
   int Disp[3]; /*!< i,j,k displacements of Domain from origin [0,1,2]=[i,j,k] */
   int Level,DomNumber;   /*!< level and ID number of this Domain */
   int InputBlock;      /*!< # of <domain> block in input file for this Domain */
+#ifdef ADAPTIVE_MESH_REFINEMENT
+  int Adaptive;       /*!< 1 if Domains on this level are regridded by AMR */
+#endif
   GridS *Grid;     /*!< pointer to Grid in this Dom updated on this processor */
 
   GridsDataS ***GData;/*!< size,location,& processor IDs of Grids in this Dom */
@@ -453,6 +525,12 @@ typedef void (*VResFun_t)(MeshS *pM, struct Output_s *pout);
 /*! \fn Real (*ConsFun_t)(const GridS *pG, const int i,const int j,const int k) 
  *  \brief Pointer to expression that computes quant for output.*/
 typedef Real (*ConsFun_t)(const GridS *pG, const int i,const int j,const int k);
+/*! \fn void (*ConsRowFun_t)(const GridS *pG, const int il, const int iu,
+ *                            const int j, const int k, Real *row)
+ *  \brief Pointer to expression that computes quant for output in cells
+ *   il..iu of an x1-row, stored in row[0..iu-il].*/
+typedef void (*ConsRowFun_t)(const GridS *pG, const int il, const int iu,
+                             const int j, const int k, Real *row);
 #ifdef PARTICLES
 /*! \fn int (*PropFun_t)(const GrainS *gr, const GrainAux *grsub)
  *  \brief Particle property selection function */
@@ -466,6 +544,8 @@ typedef struct Output_s{
   int n;          /*!< the N from the <outputN> block of this output */
   Real dt;        /*!< time interval between outputs  */
   Real t;         /*!< next time to output */
+  int dcycle;     /*!< # of cycles between outputs, or 0 to use dt */
+  int ncycle;     /*!< next cycle to output, if dcycle > 0 */
   int num;        /*!< dump number (0=first) */
   char *out;      /*!< variable (or user fun) to be output */
   char *id;       /*!< filename is of the form <basename>[.idump][.id].<ext> */
@@ -503,9 +583,75 @@ typedef struct Output_s{
   VOutFun_t out_fun; /*!< output function pointer */
   VResFun_t res_fun; /*!< restart function pointer */
   ConsFun_t expr;   /*!< pointer to expression that computes quant for output */
+  ConsRowFun_t row_expr; /*!< same expression for a row of cells, or NULL */
+
+/* compression of binary data in dumps and restarts, see compress.c */
+  int compress;   /*!< 0 = none, 1 = lossless, 2 = lossy */
+  Real rel_err;   /*!< maximum relative error of lossy compression */
+
+/* one file per Domain written with MPI-IO, see shared_file.c */
+  int single_file;  /*!< 1 = shared by all processes, 0 = one per process */
+
+/* layout of hdf dumps, see dump_hdf5.c */
+  int chunk;        /*!< edge of the chunks of each dataset, in cells */
+
+/* in-situ analysis products, see output_insitu.c */
+  int axis;         /*!< axis normal to slices and projections (1,2,3) */
+  Real pos;         /*!< position of slices along axis */
+  int prof;         /*!< profiles in 0 = r, 1 = R, 2 = phi */
+  Real xc[3];       /*!< centre of profiles */
+  Real rmax;        /*!< outer radius of profiles */
+  int nbin;         /*!< number of bins of profiles and spectra */
 
 }OutputS;
 
+/*----------------------------------------------------------------------------*/
+/* ZFileS: compressed dumps and restarts, see compress.c */
+
+/*! \struct ZFileS
+ *  \brief File written through the compression functions in compress.c */
+typedef struct ZFile_s{
+  FILE *fp;             /*!< file being written */
+  int compress;         /*!< 0 = none, 1 = lossless, 2 = lossy */
+  int keep;             /*!< mantissa bits kept by lossy compression */
+  size_t elsize;        /*!< size of elements in current section (0 = none) */
+  unsigned char *buf;   /*!< uncompressed data of current chunk */
+  size_t nbuf;          /*!< number of bytes in buf */
+  unsigned char *work;  /*!< shuffled and compressed data of current chunk */
+}ZFileS;
+
+/*----------------------------------------------------------------------------*/
+/* RstFieldS, RstIndexS, RstMapS: index of restart files, see restart_map.c */
+
+#define RST_NAMELEN 24          /* length of the field names in the index */
+#define RST_ENTRYLEN (RST_NAMELEN + 6*sizeof(int) + sizeof(long long))
+#define RST_MAGIC "ATHRIDX1"    /* last 8 bytes of a restart file with index */
+/*! \struct RstFieldS
+ *  \brief Entry of the index of a restart file, see restart_map.c */
+typedef struct RstField_s{
+  char name[RST_NAMELEN]; /*!< label of the field in the file, e.g. DENSITY */
+  int level, domain;      /*!< Domain of the field, or -1 for global data */
+  int elsize;             /*!< size of each element in bytes */
+  int n[3];               /*!< number of elements in x1, x2 and x3 */
+  long long offset;       /*!< offset of the data from the start of the file */
+}RstFieldS;
+
+/*! \struct RstIndexS
+ *  \brief Index of a restart file being written */
+typedef struct RstIndex_s{
+  int nfield, cap;        /*!< number of entries, and size of field[] */
+  RstFieldS *field;       /*!< the entries */
+}RstIndexS;
+
+/*! \struct RstMapS
+ *  \brief Restart file mapped into memory by ath_rstmap_open() */
+typedef struct RstMap_s{
+  char *base;             /*!< start of the mapped file */
+  size_t size;            /*!< size of the file in bytes */
+  int nfield;             /*!< number of entries in the index */
+  RstFieldS *field;       /*!< the index */
+}RstMapS;
+
 
 /*----------------------------------------------------------------------------*/
 /* typedefs for functions:
@@ -534,6 +680,11 @@ typedef Real (*CoolingFun_t)(const Real d, const Real p, const Real dt);
 typedef void (*EtaFun_t)(GridS *pG, int i, int j, int k,
                          Real *eta_O, Real *eta_H, Real *eta_A);
 #endif /* RESISTIVITY */
+#ifdef ADAPTIVE_MESH_REFINEMENT
+/*! \fn int (*AMRFlagFun_t)(GridS *pG, int i, int j, int k)
+ *  \brief Refinement criterion, returns 1 if cell (i,j,k) needs refining. */
+typedef int (*AMRFlagFun_t)(GridS *pG, int i, int j, int k);
+#endif /* ADAPTIVE_MESH_REFINEMENT */
 
 #ifdef PARTICLES
 /* function types for interpolation schemes and stopping time */
@@ -547,6 +698,29 @@ typedef void (*WeightFun_t)(GridS *pG, Real x1, Real x2, Real x3,
 typedef Real (*TSFun_t)(GridS *pG, int type, Real rho, Real cs, Real vd);
 #endif /* PARTICLES */
 
+#ifdef RUNTIME_SOLVERS
+/* function types for the flux function and reconstruction chosen at runtime */
+/*! \fn void (*FluxFun_t)(const Cons1DS Ul, const Cons1DS Ur,
+ *           const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF)
+ *  \brief Flux function, see fluxes() in rsolvers/prototypes.h */
+typedef void (*FluxFun_t)(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+/*! \fn void (*FluxPencilFun_t)(const int il, const int iu,
+ *           const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+ *           const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[])
+ *  \brief Flux function along a pencil, see fluxes_pencil() */
+typedef void (*FluxPencilFun_t)(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+/*! \fn void (*LRStatesFun_t)(const GridS *pG, const Prim1DS W[],
+ *           const Real Bxc[], const Real dt, const Real dx, const int il,
+ *           const int iu, Prim1DS Wl[], Prim1DS Wr[], const int dir)
+ *  \brief Spatial reconstruction, see lr_states() */
+typedef void (*LRStatesFun_t)(const GridS *pG, const Prim1DS W[],
+  const Real Bxc[], const Real dt, const Real dx, const int il, const int iu,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+#endif /* RUNTIME_SOLVERS */
+
 /*----------------------------------------------------------------------------*/
 /*! \enum BCDirection
  *  \brief Directions for the set_bvals_fun() function */
@@ -33,6 +33,16 @@
  *   - 2) Pack and send data to the Grids on both L and R
  *   - 3) Check for receives and unpack data in order of first to finish
  *   If the Grid is at the edge of the Domain, we set BCs as in case (1) or (3).
+ *   This is done in three rounds, for x1, x2 and x3, since the corner cells are
+ *   filled by passing the ghost zones set in the previous round.
+ *
+ *   With ASYNC_BVALS the three rounds are replaced by one: bvals_mhd_start()
+ *   sets the physical boundaries, then exchanges the faces, edges and corners
+ *   with all (up to 26) neighbouring Grids at once, and bvals_mhd_finish()
+ *   unpacks them as they arrive.  Messages along a boundary of the Domain also
+ *   carry the ghost zones already set by the physical BCs at that boundary, so
+ *   the corner cells are the same as with three rounds.  Work that does not
+ *   need the ghost zones can be done between the two calls.
  *
  * For case (3) -- INTERNAL GRID LEVEL BOUNDARIES
  *   This step is complicated and must be handled separately, in the function
@@ -45,7 +55,10 @@
  * CONTAINS PUBLIC FUNCTIONS: 
  * - bvals_mhd()      - calls appropriate functions to set ghost cells
  * - bvals_mhd_init() - sets function pointers used by bvals_mhd()
+ * - bvals_mhd_destruct() - frees memory allocated by bvals_mhd_init()
  * - bvals_mhd_fun()  - enrolls a pointer to a user-defined BC function
+ * - bvals_mhd_start()  - ASYNC_BVALS: physical BCs, post all MPI messages
+ * - bvals_mhd_finish() - ASYNC_BVALS: wait for and unpack all MPI messages
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - reflect_ix1()  - reflecting BCs at boundary ix1
@@ -83,7 +96,12 @@
  * - unpack_ix2()   - unpack data for MPI non-blocking receive at ix2 boundary
  * - unpack_ox2()   - unpack data for MPI non-blocking receive at ox2 boundary
  * - unpack_ix3()   - unpack data for MPI non-blocking receive at ix3 boundary
- * - unpack_ox3()   - unpack data for MPI non-blocking receive at ox3 boundary*/
+ * - unpack_ox3()   - unpack data for MPI non-blocking receive at ox3 boundary
+ * - nbr_range()    - ASYNC_BVALS: cells sent/received in one of 26 directions
+ * - nbr_count()    - ASYNC_BVALS: size of message in one of 26 directions
+ * - pack_nbr()     - ASYNC_BVALS: pack data for neighbour in one direction
+ * - unpack_nbr()   - ASYNC_BVALS: unpack data from neighbour in one direction
+ * - init_nbr_exch() - ASYNC_BVALS: find neighbours and allocate buffers    */
 /*============================================================================*/
 
 #include <stdio.h>
@@ -96,9 +114,25 @@
 #ifdef MPI_PARALLEL
 /* MPI send and receive buffers */
 static double **send_buf = NULL, **recv_buf = NULL;
-static MPI_Request *recv_rq, *send_rq;
+static MPI_Request *recv_rq = NULL, *send_rq = NULL;
 #endif /* MPI_PARALLEL */
 
+#ifdef ASYNC_BVALS
+/*! \struct NbrExchS
+ *  \brief Messages exchanged with the neighbours of one Grid.  Direction
+ *   n=(dx+1)+3*(dy+1)+9*(dz+1) with dx,dy,dz=-1,0,1; n=13 is the Grid itself.
+ *   id[n] is the ID_Comm_Domain of the neighbour, or -1 if there is none. */
+typedef struct NbrExch_s{
+  int id[27];
+  int cnt[27];                     /* number of doubles in each message */
+  double *send[27], *recv[27];
+  MPI_Request send_rq[27], recv_rq[27];
+}NbrExchS;
+
+/* one NbrExchS for each Domain on this processor, Exch[Level][DomNumber] */
+static NbrExchS **Exch = NULL;
+#endif /* ASYNC_BVALS */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
  *   reflect_???()  - reflecting BCs at boundary ???
@@ -155,6 +189,15 @@ static void unpack_ix3(GridS *pG);
 static void unpack_ox3(GridS *pG);
 #endif /* MPI_PARALLEL */
 
+#ifdef ASYNC_BVALS
+static void nbr_range(const GridS *pG, const int n, const int var,
+                      const int recv, int lo[3], int hi[3]);
+static int nbr_count(const GridS *pG, const int n);
+static void pack_nbr(GridS *pG, const int n, double *pSnd);
+static void unpack_nbr(GridS *pG, const int n, double *pRcv);
+static void init_nbr_exch(DomainS *pD, NbrExchS *pX);
+#endif /* ASYNC_BVALS */
+
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 
 /*----------------------------------------------------------------------------*/
@@ -181,6 +224,12 @@ void bvals_mhd(DomainS *pD)
   int cnt, cnt2, cnt3, ierr, mIndex;
 #endif /* MPI_PARALLEL */
 
+#ifdef ASYNC_BVALS
+  bvals_mhd_start(pD);
+  bvals_mhd_finish(pD);
+  return;
+#endif /* ASYNC_BVALS */
+
 /*--- Step 1. ------------------------------------------------------------------
  * Boundary Conditions in x1-direction */
 
@@ -521,6 +570,16 @@ void bvals_mhd_init(MeshS *pM)
   int x1cnt=0, x2cnt=0, x3cnt=0; /* Number of words passed in x1/x2/x3-dir. */
 #endif /* MPI_PARALLEL */
 
+#ifdef ASYNC_BVALS
+  if((Exch = (NbrExchS**)calloc_1d_array(pM->NLevels,sizeof(NbrExchS*)))==NULL)
+    ath_error("[bvals_init]: Failed to allocate neighbour exchange array\n");
+  for (nl=0; nl<(pM->NLevels); nl++){
+    if((Exch[nl] = (NbrExchS*)calloc_1d_array(pM->DomainsPerLevel[nl],
+      sizeof(NbrExchS))) == NULL)
+      ath_error("[bvals_init]: Failed to allocate neighbour exchange array\n");
+  }
+#endif /* ASYNC_BVALS */
+
 /* Cycle through all the Domains that have active Grids on this proc */
 
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -875,6 +934,12 @@ void bvals_mhd_init(MeshS *pM)
     }}
 #endif /* MPI_PARALLEL */
 
+/* Find the neighbours in all 26 directions, once the IDs of the neighbours
+ * across periodic boundaries have been set above */
+#ifdef ASYNC_BVALS
+    init_nbr_exch(pD, &(Exch[nl][nd]));
+#endif
+
   }}}  /* End loop over all Domains with active Grids -----------------------*/
 
 #ifdef MPI_PARALLEL
@@ -907,6 +972,44 @@ void bvals_mhd_init(MeshS *pM)
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_destruct(MeshS *pM)
+ *  \brief Frees memory allocated by bvals_mhd_init(), so it can be called again
+ *   after the Grids have changed.  Function pointers are not reset.
+ */
+
+void bvals_mhd_destruct(MeshS *pM)
+{
+#ifdef ASYNC_BVALS
+  int nl,nd,n;
+
+  if (Exch != NULL) {
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        for (n=0; n<27; n++){
+          if (Exch[nl][nd].send[n] != NULL) free_1d_array(Exch[nl][nd].send[n]);
+          if (Exch[nl][nd].recv[n] != NULL) free_1d_array(Exch[nl][nd].recv[n]);
+        }
+      }
+      free_1d_array(Exch[nl]);
+    }
+    free_1d_array(Exch);
+    Exch = NULL;
+  }
+#endif /* ASYNC_BVALS */
+
+#ifdef MPI_PARALLEL
+  if (send_buf != NULL) free_2d_array(send_buf);
+  if (recv_buf != NULL) free_2d_array(recv_buf);
+  if (recv_rq != NULL) free_1d_array(recv_rq);
+  if (send_rq != NULL) free_1d_array(send_rq);
+  send_buf = recv_buf = NULL;
+  recv_rq = send_rq = NULL;
+#endif /* MPI_PARALLEL */
+
+  return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void bvals_mhd_fun(DomainS *pD, enum BCDirection dir, VGFun_t prob_bc)
  *  \brief Sets function ptrs for user-defined BCs.
@@ -940,6 +1043,87 @@ void bvals_mhd_fun(DomainS *pD, enum BCDirection dir, VGFun_t prob_bc)
   return;
 }
 
+#ifdef ASYNC_BVALS
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_start(DomainS *pD)
+ *  \brief Sets the physical boundaries, then posts non-blocking receives and
+ *   sends for the ghost zones shared with all neighbouring Grids.
+ *
+ *   The physical BCs are set first, in the order x1-x2-x3, so that the
+ *   messages along the edges of the Domain can carry them to the corner cells
+ *   of the neighbours.  Must be followed by bvals_mhd_finish() before the
+ *   ghost zones are used.
+ */
+
+void bvals_mhd_start(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  NbrExchS *pX = &(Exch[pD->Level][pD->DomNumber]);
+  int n, ierr;
+
+/* Post non-blocking receives.  The neighbour in direction n sends with the
+ * tag of the opposite direction, 26-n */
+
+  for (n=0; n<27; n++) {
+    if (pX->id[n] < 0) continue;
+    ierr = MPI_Irecv(pX->recv[n],pX->cnt[n],MPI_DOUBLE,pX->id[n],
+      bvals_nbr_tag+(26-n), pD->Comm_Domain, &(pX->recv_rq[n]));
+  }
+
+/* Set physical boundaries */
+
+  if (pG->Nx[0] > 1) {
+    if (pG->lx1_id < 0) (*(pD->ix1_BCFun))(pG);
+    if (pG->rx1_id < 0) (*(pD->ox1_BCFun))(pG);
+  }
+  if (pG->Nx[1] > 1) {
+    if (pG->lx2_id < 0) (*(pD->ix2_BCFun))(pG);
+    if (pG->rx2_id < 0) (*(pD->ox2_BCFun))(pG);
+  }
+  if (pG->Nx[2] > 1) {
+    if (pG->lx3_id < 0) (*(pD->ix3_BCFun))(pG);
+    if (pG->rx3_id < 0) (*(pD->ox3_BCFun))(pG);
+  }
+
+/* Pack and send data to all neighbours */
+
+  for (n=0; n<27; n++) {
+    if (pX->id[n] < 0) continue;
+    pack_nbr(pG,n,pX->send[n]);
+    ierr = MPI_Isend(pX->send[n],pX->cnt[n],MPI_DOUBLE,pX->id[n],
+      bvals_nbr_tag+n, pD->Comm_Domain, &(pX->send_rq[n]));
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void bvals_mhd_finish(DomainS *pD)
+ *  \brief Unpacks the messages posted by bvals_mhd_start() in the order they
+ *   arrive, and waits for the sends to complete.
+ */
+
+void bvals_mhd_finish(DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  NbrExchS *pX = &(Exch[pD->Level][pD->DomNumber]);
+  int ierr, mIndex;
+
+/* Requests of completed (and never posted) receives are MPI_REQUEST_NULL, so
+ * MPI_Waitany() returns MPI_UNDEFINED once all have been unpacked. */
+
+  for (;;) {
+    ierr = MPI_Waitany(27,pX->recv_rq,&mIndex,MPI_STATUS_IGNORE);
+    if (mIndex == MPI_UNDEFINED) break;
+    unpack_nbr(pG,mIndex,pX->recv[mIndex]);
+  }
+
+  ierr = MPI_Waitall(27,pX->send_rq,MPI_STATUSES_IGNORE);
+
+  return;
+}
+#endif /* ASYNC_BVALS */
+
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 /* Following are the functions:
  *   reflecting_???:   where ???=[ix1,ox1,ix2,ox2,ix3,ox3]
@@ -967,10 +1151,10 @@ static void reflect_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i]    =  pGrid->U[k][j][is+(i-1)];
-        pGrid->U[k][j][is-i].M1 = -pGrid->U[k][j][is-i].M1; /* reflect 1-mom. */
+        SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j,is+(i-1)));
+        GRID_U(pGrid,k,j,is-i,M1) = -GRID_U(pGrid,k,j,is-i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][is-i].B1c= -pGrid->U[k][j][is-i].B1c;/* reflect 1-fld. */
+        GRID_U(pGrid,k,j,is-i,B1c)= -GRID_U(pGrid,k,j,is-i,B1c);/* reflect 1-fld. */
 #endif
       }
     }
@@ -1026,10 +1210,10 @@ static void reflect_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i]    =  pGrid->U[k][j][ie-(i-1)];
-        pGrid->U[k][j][ie+i].M1 = -pGrid->U[k][j][ie+i].M1; /* reflect 1-mom. */
+        SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j,ie-(i-1)));
+        GRID_U(pGrid,k,j,ie+i,M1) = -GRID_U(pGrid,k,j,ie+i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][ie+i].B1c= -pGrid->U[k][j][ie+i].B1c;/* reflect 1-fld. */
+        GRID_U(pGrid,k,j,ie+i,B1c)= -GRID_U(pGrid,k,j,ie+i,B1c);/* reflect 1-fld. */
 #endif
       }
     }
@@ -1085,10 +1269,10 @@ static void reflect_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i]    =  pGrid->U[k][js+(j-1)][i];
-        pGrid->U[k][js-j][i].M2 = -pGrid->U[k][js-j][i].M2; /* reflect 2-mom. */
+        SET_GRID_U(pGrid,k,js-j,i,GET_GRID_U(pGrid,k,js+(j-1),i));
+        GRID_U(pGrid,k,js-j,i,M2) = -GRID_U(pGrid,k,js-j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][js-j][i].B2c= -pGrid->U[k][js-j][i].B2c;/* reflect 2-fld. */
+        GRID_U(pGrid,k,js-j,i,B2c)= -GRID_U(pGrid,k,js-j,i,B2c);/* reflect 2-fld. */
 #endif
       }
     }
@@ -1146,10 +1330,10 @@ static void reflect_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i]    =  pGrid->U[k][je-(j-1)][i];
-        pGrid->U[k][je+j][i].M2 = -pGrid->U[k][je+j][i].M2; /* reflect 2-mom. */
+        SET_GRID_U(pGrid,k,je+j,i,GET_GRID_U(pGrid,k,je-(j-1),i));
+        GRID_U(pGrid,k,je+j,i,M2) = -GRID_U(pGrid,k,je+j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][je+j][i].B2c= -pGrid->U[k][je+j][i].B2c;/* reflect 2-fld. */
+        GRID_U(pGrid,k,je+j,i,B2c)= -GRID_U(pGrid,k,je+j,i,B2c);/* reflect 2-fld. */
 #endif
       }
     }
@@ -1204,10 +1388,10 @@ static void reflect_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i]    =  pGrid->U[ks+(k-1)][j][i];
-        pGrid->U[ks-k][j][i].M3 = -pGrid->U[ks-k][j][i].M3; /* reflect 3-mom. */
+        SET_GRID_U(pGrid,ks-k,j,i,GET_GRID_U(pGrid,ks+(k-1),j,i));
+        GRID_U(pGrid,ks-k,j,i,M3) = -GRID_U(pGrid,ks-k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ks-k][j][i].B3c= -pGrid->U[ks-k][j][i].B3c;/* reflect 3-fld.*/
+        GRID_U(pGrid,ks-k,j,i,B3c)= -GRID_U(pGrid,ks-k,j,i,B3c);/* reflect 3-fld.*/
 #endif
       }
     }
@@ -1264,10 +1448,10 @@ static void reflect_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i]    =  pGrid->U[ke-(k-1)][j][i];
-        pGrid->U[ke+k][j][i].M3 = -pGrid->U[ke+k][j][i].M3; /* reflect 3-mom. */
+        SET_GRID_U(pGrid,ke+k,j,i,GET_GRID_U(pGrid,ke-(k-1),j,i));
+        GRID_U(pGrid,ke+k,j,i,M3) = -GRID_U(pGrid,ke+k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ke+k][j][i].B3c= -pGrid->U[ke+k][j][i].B3c;/* reflect 3-fld. */
+        GRID_U(pGrid,ke+k,j,i,B3c)= -GRID_U(pGrid,ke+k,j,i,B3c);/* reflect 3-fld. */
 #endif
       }
     }
@@ -1327,7 +1511,7 @@ static void outflow_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][is];
+        SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j,is));
       }
     }
   }
@@ -1381,7 +1565,7 @@ static void outflow_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][ie];
+        SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j,ie));
       }
     }
   }
@@ -1435,7 +1619,7 @@ static void outflow_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i] = pGrid->U[k][js][i];
+        SET_GRID_U(pGrid,k,js-j,i,GET_GRID_U(pGrid,k,js,i));
       }
     }
   }
@@ -1489,7 +1673,7 @@ static void outflow_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i] = pGrid->U[k][je][i];
+        SET_GRID_U(pGrid,k,je+j,i,GET_GRID_U(pGrid,k,je,i));
       }
     }
   }
@@ -1540,7 +1724,7 @@ static void outflow_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i] = pGrid->U[ks][j][i];
+        SET_GRID_U(pGrid,ks-k,j,i,GET_GRID_U(pGrid,ks,j,i));
       }
     }
   }
@@ -1591,7 +1775,7 @@ static void outflow_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i] = pGrid->U[ke][j][i];
+        SET_GRID_U(pGrid,ke+k,j,i,GET_GRID_U(pGrid,ke,j,i));
       }
     }
   }
@@ -1645,7 +1829,7 @@ static void periodic_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][ie-(i-1)];
+        SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j,ie-(i-1)));
       }
     }
   }
@@ -1699,7 +1883,7 @@ static void periodic_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][is+(i-1)];
+        SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j,is+(i-1)));
       }
     }
   }
@@ -1753,7 +1937,7 @@ static void periodic_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i] = pGrid->U[k][je-(j-1)][i];
+        SET_GRID_U(pGrid,k,js-j,i,GET_GRID_U(pGrid,k,je-(j-1),i));
       }
     }
   }
@@ -1807,7 +1991,7 @@ static void periodic_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i] = pGrid->U[k][js+(j-1)][i];
+        SET_GRID_U(pGrid,k,je+j,i,GET_GRID_U(pGrid,k,js+(j-1),i));
       }
     }
   }
@@ -1858,7 +2042,7 @@ static void periodic_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i] = pGrid->U[ke-(k-1)][j][i];
+        SET_GRID_U(pGrid,ks-k,j,i,GET_GRID_U(pGrid,ke-(k-1),j,i));
       }
     }
   }
@@ -1909,7 +2093,7 @@ static void periodic_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i] = pGrid->U[ks+(k-1)][j][i];
+        SET_GRID_U(pGrid,ke+k,j,i,GET_GRID_U(pGrid,ks+(k-1),j,i));
       }
     }
   }
@@ -1963,11 +2147,11 @@ static void conduct_ix1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i]    =  pGrid->U[k][j][is+(i-1)];
-        pGrid->U[k][j][is-i].M1 = -pGrid->U[k][j][is-i].M1; /* reflect 1-mom. */
+        SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j,is+(i-1)));
+        GRID_U(pGrid,k,j,is-i,M1) = -GRID_U(pGrid,k,j,is-i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][is-i].B2c= -pGrid->U[k][j][is-i].B2c;/* reflect fld */
-        pGrid->U[k][j][is-i].B3c= -pGrid->U[k][j][is-i].B3c;
+        GRID_U(pGrid,k,j,is-i,B2c)= -GRID_U(pGrid,k,j,is-i,B2c);/* reflect fld */
+        GRID_U(pGrid,k,j,is-i,B3c)= -GRID_U(pGrid,k,j,is-i,B3c);
 #endif
       }
     }
@@ -2022,11 +2206,11 @@ static void conduct_ox1(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i]    =  pGrid->U[k][j][ie-(i-1)];
-        pGrid->U[k][j][ie+i].M1 = -pGrid->U[k][j][ie+i].M1; /* reflect 1-mom. */
+        SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j,ie-(i-1)));
+        GRID_U(pGrid,k,j,ie+i,M1) = -GRID_U(pGrid,k,j,ie+i,M1); /* reflect 1-mom. */
 #ifdef MHD
-        pGrid->U[k][j][ie+i].B2c= -pGrid->U[k][j][ie+i].B2c;/* reflect fld */
-        pGrid->U[k][j][ie+i].B3c= -pGrid->U[k][j][ie+i].B3c;
+        GRID_U(pGrid,k,j,ie+i,B2c)= -GRID_U(pGrid,k,j,ie+i,B2c);/* reflect fld */
+        GRID_U(pGrid,k,j,ie+i,B3c)= -GRID_U(pGrid,k,j,ie+i,B3c);
 #endif
       }
     }
@@ -2081,11 +2265,11 @@ static void conduct_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][js-j][i]    =  pGrid->U[k][js+(j-1)][i];
-        pGrid->U[k][js-j][i].M2 = -pGrid->U[k][js-j][i].M2; /* reflect 2-mom. */
+        SET_GRID_U(pGrid,k,js-j,i,GET_GRID_U(pGrid,k,js+(j-1),i));
+        GRID_U(pGrid,k,js-j,i,M2) = -GRID_U(pGrid,k,js-j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][js-j][i].B1c= -pGrid->U[k][js-j][i].B1c;/* reflect fld */
-        pGrid->U[k][js-j][i].B3c= -pGrid->U[k][js-j][i].B3c;
+        GRID_U(pGrid,k,js-j,i,B1c)= -GRID_U(pGrid,k,js-j,i,B1c);/* reflect fld */
+        GRID_U(pGrid,k,js-j,i,B3c)= -GRID_U(pGrid,k,js-j,i,B3c);
 #endif
       }
     }
@@ -2140,11 +2324,11 @@ static void conduct_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[k][je+j][i]    =  pGrid->U[k][je-(j-1)][i];
-        pGrid->U[k][je+j][i].M2 = -pGrid->U[k][je+j][i].M2; /* reflect 2-mom. */
+        SET_GRID_U(pGrid,k,je+j,i,GET_GRID_U(pGrid,k,je-(j-1),i));
+        GRID_U(pGrid,k,je+j,i,M2) = -GRID_U(pGrid,k,je+j,i,M2); /* reflect 2-mom. */
 #ifdef MHD
-        pGrid->U[k][je+j][i].B1c= -pGrid->U[k][je+j][i].B1c;/* reflect fld */
-        pGrid->U[k][je+j][i].B3c= -pGrid->U[k][je+j][i].B3c;
+        GRID_U(pGrid,k,je+j,i,B1c)= -GRID_U(pGrid,k,je+j,i,B1c);/* reflect fld */
+        GRID_U(pGrid,k,je+j,i,B3c)= -GRID_U(pGrid,k,je+j,i,B3c);
 #endif
       }
     }
@@ -2196,11 +2380,11 @@ static void conduct_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ks-k][j][i]    =  pGrid->U[ks+(k-1)][j][i];
-        pGrid->U[ks-k][j][i].M3 = -pGrid->U[ks-k][j][i].M3; /* reflect 3-mom. */
+        SET_GRID_U(pGrid,ks-k,j,i,GET_GRID_U(pGrid,ks+(k-1),j,i));
+        GRID_U(pGrid,ks-k,j,i,M3) = -GRID_U(pGrid,ks-k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ks-k][j][i].B1c= -pGrid->U[ks-k][j][i].B1c;/* reflect fld */
-        pGrid->U[ks-k][j][i].B2c= -pGrid->U[ks-k][j][i].B2c;
+        GRID_U(pGrid,ks-k,j,i,B1c)= -GRID_U(pGrid,ks-k,j,i,B1c);/* reflect fld */
+        GRID_U(pGrid,ks-k,j,i,B2c)= -GRID_U(pGrid,ks-k,j,i,B2c);
 #endif
       }
     }
@@ -2252,11 +2436,11 @@ static void conduct_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pGrid->U[ke+k][j][i]    =  pGrid->U[ke-(k-1)][j][i];
-        pGrid->U[ke+k][j][i].M3 = -pGrid->U[ke+k][j][i].M3; /* reflect 3-mom. */
+        SET_GRID_U(pGrid,ke+k,j,i,GET_GRID_U(pGrid,ke-(k-1),j,i));
+        GRID_U(pGrid,ke+k,j,i,M3) = -GRID_U(pGrid,ke+k,j,i,M3); /* reflect 3-mom. */
 #ifdef MHD
-        pGrid->U[ke+k][j][i].B1c= -pGrid->U[ke+k][j][i].B1c;/* reflect fld */
-        pGrid->U[ke+k][j][i].B2c= -pGrid->U[ke+k][j][i].B2c;
+        GRID_U(pGrid,ke+k,j,i,B1c)= -GRID_U(pGrid,ke+k,j,i,B1c);/* reflect fld */
+        GRID_U(pGrid,ke+k,j,i,B2c)= -GRID_U(pGrid,ke+k,j,i,B2c);
 #endif
       }
     }
@@ -2330,20 +2514,20 @@ static void pack_ix1(GridS *pG)
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=is+(nghost-1); i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) *(pSnd++) = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
     }
@@ -2403,20 +2587,20 @@ static void pack_ox1(GridS *pG)
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=ie-(nghost-1); i<=ie; i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) *(pSnd++) = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
     }
@@ -2475,20 +2659,20 @@ static void pack_ix2(GridS *pG)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=js+(nghost-1); j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) *(pSnd++) = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
     }
@@ -2548,20 +2732,20 @@ static void pack_ox2(GridS *pG)
   for (k=ks; k<=ke; k++){
     for (j=je-(nghost-1); j<=je; j++){
       for (i=is-nghost; i<=ie+nghost; i++){
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) *(pSnd++) = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
     }
@@ -2618,20 +2802,20 @@ static void pack_ix3(GridS *pG)
   for (k=ks; k<=ks+(nghost-1); k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) *(pSnd++) = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
     }
@@ -2688,20 +2872,20 @@ static void pack_ox3(GridS *pG)
   for (k=ke-(nghost-1); k<=ke; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        *(pSnd++) = pG->U[k][j][i].d;
-        *(pSnd++) = pG->U[k][j][i].M1;
-        *(pSnd++) = pG->U[k][j][i].M2;
-        *(pSnd++) = pG->U[k][j][i].M3;
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E;
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) *(pSnd++) = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) *(pSnd++) = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
     }
@@ -2761,20 +2945,20 @@ static void unpack_ix1(GridS *pG)
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is-nghost; i<=is-1; i++){
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
+        GRID_U(pG,k,j,i,d)  = *(pRcv++);
+        GRID_U(pG,k,j,i,M1) = *(pRcv++);
+        GRID_U(pG,k,j,i,M2) = *(pRcv++);
+        GRID_U(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
+        GRID_U(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
+        GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+        for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
       }
     }
@@ -2834,20 +3018,20 @@ static void unpack_ox1(GridS *pG)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=ie+1; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
+        GRID_U(pG,k,j,i,d)  = *(pRcv++);
+        GRID_U(pG,k,j,i,M1) = *(pRcv++);
+        GRID_U(pG,k,j,i,M2) = *(pRcv++);
+        GRID_U(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
+        GRID_U(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
+        GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+        for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
       }
     }
@@ -2907,20 +3091,20 @@ static void unpack_ix2(GridS *pG)
   for (k=ks; k<=ke; k++) {
     for (j=js-nghost; j<=js-1; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
+        GRID_U(pG,k,j,i,d)  = *(pRcv++);
+        GRID_U(pG,k,j,i,M1) = *(pRcv++);
+        GRID_U(pG,k,j,i,M2) = *(pRcv++);
+        GRID_U(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
+        GRID_U(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
+        GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+        for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
       }
     }
@@ -2980,20 +3164,20 @@ static void unpack_ox2(GridS *pG)
   for (k=ks; k<=ke; k++) {
     for (j=je+1; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
+        GRID_U(pG,k,j,i,d)  = *(pRcv++);
+        GRID_U(pG,k,j,i,M1) = *(pRcv++);
+        GRID_U(pG,k,j,i,M2) = *(pRcv++);
+        GRID_U(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
+        GRID_U(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
+        GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+        for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
       }
     }
@@ -3050,20 +3234,20 @@ static void unpack_ix3(GridS *pG)
   for (k=ks-nghost; k<=ks-1; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
+        GRID_U(pG,k,j,i,d)  = *(pRcv++);
+        GRID_U(pG,k,j,i,M1) = *(pRcv++);
+        GRID_U(pG,k,j,i,M2) = *(pRcv++);
+        GRID_U(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
+        GRID_U(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
+        GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+        for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
       }
     }
@@ -3120,20 +3304,20 @@ static void unpack_ox3(GridS *pG)
   for (k=ke+1; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        pG->U[k][j][i].d  = *(pRcv++);
-        pG->U[k][j][i].M1 = *(pRcv++);
-        pG->U[k][j][i].M2 = *(pRcv++);
-        pG->U[k][j][i].M3 = *(pRcv++);
+        GRID_U(pG,k,j,i,d)  = *(pRcv++);
+        GRID_U(pG,k,j,i,M1) = *(pRcv++);
+        GRID_U(pG,k,j,i,M2) = *(pRcv++);
+        GRID_U(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  = *(pRcv++);
+        GRID_U(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        pG->U[k][j][i].B1c = *(pRcv++);
-        pG->U[k][j][i].B2c = *(pRcv++);
-        pG->U[k][j][i].B3c = *(pRcv++);
+        GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+        for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
       }
     }
@@ -3171,3 +3355,258 @@ static void unpack_ox3(GridS *pG)
   return;
 }
 #endif /* MPI_PARALLEL */
+
+#ifdef ASYNC_BVALS
+/*----------------------------------------------------------------------------*/
+/*! \fn static void nbr_range(const GridS *pG, const int n, const int var,
+ *                            const int recv, int lo[3], int hi[3])
+ *  \brief Range of cells [lo,hi] in i,j,k packed for the neighbour in
+ *   direction n (recv=0), or unpacked from it (recv=1).  var=0 for the
+ *   conserved variables, and 1,2,3 for B1i,B2i,B3i.
+ *
+ *   In directions in which n is offset, nghost cells are passed, and one fewer
+ *   for the interface field normal to that direction, as with pack_ix1() etc.
+ *   In directions in which it is not, the message covers the Grid plus any
+ *   ghost zones at a physical boundary, which are set before packing.
+ */
+
+static void nbr_range(const GridS *pG, const int n, const int var,
+                      const int recv, int lo[3], int hi[3])
+{
+  int dir[3], s[3], e[3], lphys[3], rphys[3];
+  int m, ng, face;
+
+  dir[0] = n%3 - 1;  dir[1] = (n/3)%3 - 1;  dir[2] = n/9 - 1;
+  s[0] = pG->is;  s[1] = pG->js;  s[2] = pG->ks;
+  e[0] = pG->ie;  e[1] = pG->je;  e[2] = pG->ke;
+  lphys[0] = (pG->lx1_id < 0);  rphys[0] = (pG->rx1_id < 0);
+  lphys[1] = (pG->lx2_id < 0);  rphys[1] = (pG->rx2_id < 0);
+  lphys[2] = (pG->lx3_id < 0);  rphys[2] = (pG->rx3_id < 0);
+
+  for (m=0; m<3; m++) {
+    face = (var == m+1) ? 1 : 0;
+    ng = nghost - face;
+    if (pG->Nx[m] == 1) {
+      lo[m] = s[m];
+      hi[m] = e[m];
+    } else if (dir[m] == 0) {
+      lo[m] = s[m] - (lphys[m] ? ng : 0);
+      hi[m] = e[m] + face + (rphys[m] ? ng : 0);
+    } else if (dir[m] < 0) {
+      lo[m] = recv ? s[m] - ng : s[m] + face;
+      hi[m] = recv ? s[m] - 1  : s[m] + nghost - 1;
+    } else {
+      lo[m] = recv ? e[m] + 1 + face : e[m] - ng + 1;
+      hi[m] = recv ? e[m] + nghost   : e[m];
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int nbr_count(const GridS *pG, const int n)
+ *  \brief Number of doubles passed to the neighbour in direction n */
+
+static int nbr_count(const GridS *pG, const int n)
+{
+  int lo[3], hi[3], cnt;
+#ifdef MHD
+  int var;
+#endif
+
+  nbr_range(pG,n,0,0,lo,hi);
+  cnt = (hi[0]-lo[0]+1)*(hi[1]-lo[1]+1)*(hi[2]-lo[2]+1)*(NVAR);
+#ifdef MHD
+  for (var=1; var<=3; var++) {
+    nbr_range(pG,n,var,0,lo,hi);
+    cnt += (hi[0]-lo[0]+1)*(hi[1]-lo[1]+1)*(hi[2]-lo[2]+1);
+  }
+#endif
+
+  return cnt;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void pack_nbr(GridS *pG, const int n, double *pSnd)
+ *  \brief PACK data for MPI_Isend to the neighbour in direction n */
+
+static void pack_nbr(GridS *pG, const int n, double *pSnd)
+{
+  int lo[3], hi[3], i, j, k;
+#if (NSCALARS > 0)
+  int ns;
+#endif
+
+  nbr_range(pG,n,0,0,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
+#ifndef BAROTROPIC
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
+#endif /* BAROTROPIC */
+#ifdef MHD
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
+#endif /* MHD */
+#if (NSCALARS > 0)
+        for (ns=0; ns<NSCALARS; ns++) *(pSnd++) = GRID_U(pG,k,j,i,s[ns]);
+#endif
+      }
+    }
+  }
+
+#ifdef MHD
+  nbr_range(pG,n,1,0,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        *(pSnd++) = pG->B1i[k][j][i];
+      }
+    }
+  }
+
+  nbr_range(pG,n,2,0,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        *(pSnd++) = pG->B2i[k][j][i];
+      }
+    }
+  }
+
+  nbr_range(pG,n,3,0,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        *(pSnd++) = pG->B3i[k][j][i];
+      }
+    }
+  }
+#endif /* MHD */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void unpack_nbr(GridS *pG, const int n, double *pRcv)
+ *  \brief UNPACK data from MPI_Irecv from the neighbour in direction n */
+
+static void unpack_nbr(GridS *pG, const int n, double *pRcv)
+{
+  int lo[3], hi[3], i, j, k;
+#if (NSCALARS > 0)
+  int ns;
+#endif
+
+  nbr_range(pG,n,0,1,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        GRID_U(pG,k,j,i,d) = *(pRcv++);
+        GRID_U(pG,k,j,i,M1) = *(pRcv++);
+        GRID_U(pG,k,j,i,M2) = *(pRcv++);
+        GRID_U(pG,k,j,i,M3) = *(pRcv++);
+#ifndef BAROTROPIC
+        GRID_U(pG,k,j,i,E) = *(pRcv++);
+#endif /* BAROTROPIC */
+#ifdef MHD
+        GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+        GRID_U(pG,k,j,i,B3c) = *(pRcv++);
+#endif /* MHD */
+#if (NSCALARS > 0)
+        for (ns=0; ns<NSCALARS; ns++) GRID_U(pG,k,j,i,s[ns]) = *(pRcv++);
+#endif
+      }
+    }
+  }
+
+#ifdef MHD
+  nbr_range(pG,n,1,1,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        pG->B1i[k][j][i] = *(pRcv++);
+      }
+    }
+  }
+
+  nbr_range(pG,n,2,1,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        pG->B2i[k][j][i] = *(pRcv++);
+      }
+    }
+  }
+
+  nbr_range(pG,n,3,1,lo,hi);
+  for (k=lo[2]; k<=hi[2]; k++){
+    for (j=lo[1]; j<=hi[1]; j++){
+      for (i=lo[0]; i<=hi[0]; i++){
+        pG->B3i[k][j][i] = *(pRcv++);
+      }
+    }
+  }
+#endif /* MHD */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void init_nbr_exch(DomainS *pD, NbrExchS *pX)
+ *  \brief Finds the ID of the neighbour of the Grid on this processor in each
+ *   of the 26 directions, and allocates the message buffers.
+ *
+ *   A neighbour exists in direction n if there is a neighbour across each face
+ *   the direction crosses (including across periodic boundaries, handled with
+ *   MPI when there is more than one Grid in that direction).
+ */
+
+static void init_nbr_exch(DomainS *pD, NbrExchS *pX)
+{
+  GridS *pG = pD->Grid;
+  int myL,myM,myN,l,m,k,n,dx,dy,dz;
+
+  get_myGridIndex(pD, myID_Comm_world, &myL, &myM, &myN);
+
+  for (n=0; n<27; n++) {
+    pX->id[n] = -1;
+    pX->cnt[n] = 0;
+    pX->send[n] = NULL;
+    pX->recv[n] = NULL;
+    pX->send_rq[n] = MPI_REQUEST_NULL;
+    pX->recv_rq[n] = MPI_REQUEST_NULL;
+
+    dx = n%3 - 1;  dy = (n/3)%3 - 1;  dz = n/9 - 1;
+    if (dx == 0 && dy == 0 && dz == 0) continue;
+    if (dx != 0 && (pG->Nx[0] == 1 || (dx<0 ? pG->lx1_id : pG->rx1_id) < 0))
+      continue;
+    if (dy != 0 && (pG->Nx[1] == 1 || (dy<0 ? pG->lx2_id : pG->rx2_id) < 0))
+      continue;
+    if (dz != 0 && (pG->Nx[2] == 1 || (dz<0 ? pG->lx3_id : pG->rx3_id) < 0))
+      continue;
+
+    l = (myL + dx + pD->NGrid[0]) % pD->NGrid[0];
+    m = (myM + dy + pD->NGrid[1]) % pD->NGrid[1];
+    k = (myN + dz + pD->NGrid[2]) % pD->NGrid[2];
+    pX->id[n] = pD->GData[k][m][l].ID_Comm_Domain;
+    pX->cnt[n] = nbr_count(pG,n);
+
+    if ((pX->send[n] = (double*)calloc_1d_array(pX->cnt[n],sizeof(double)))
+        == NULL)
+      ath_error("[bvals_init]: Failed to allocate send buffer\n");
+    if ((pX->recv[n] = (double*)calloc_1d_array(pX->cnt[n],sizeof(double)))
+        == NULL)
+      ath_error("[bvals_init]: Failed to allocate recv buffer\n");
+  }
+
+  return;
+}
+#endif /* ASYNC_BVALS */
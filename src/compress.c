@@ -0,0 +1,364 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file compress.c
+ *  \brief Writes dumps and restart files with compressed binary data.
+ *
+ * PURPOSE: Writes dumps and restart files with compressed binary data.  The
+ *   dump functions write their files through a ZFileS, with ath_zprintf() for
+ *   text and ath_zwrite() for binary data.  If compress = lossless or lossy in
+ *   the <outputN> block (which requires configure --enable-compression), the
+ *   text is written as is, while consecutive binary writes of elements of the
+ *   same size are collected in a section, which is split into independent
+ *   chunks of 1 MB.  Each chunk is byte-shuffled (the first bytes of all
+ *   elements, then the second bytes, ...) and compressed with zlib at its
+ *   fastest level, or stored if it does not compress.  Otherwise the ZFileS
+ *   passes everything directly to the file, which is unchanged.
+ *
+ *   With compress = lossy, ath_zlossy() rounds float and double data to the
+ *   fewest mantissa bits that keep the relative error of each (normal) value
+ *   below rel_err in the <outputN> block (default 1.0e-4), which makes the
+ *   following shuffle and compression far more effective.  Lossy compression
+ *   is only allowed for bin and vtk dumps, never for restarts.
+ *
+ *   A section is the bytes "\0ATHZ1", the element size and a zero byte,
+ *   followed by chunks and ended by an empty chunk.  Each chunk has two
+ *   4-byte little-endian integers, its size before and after compression (the
+ *   same if stored), and the data.  Since the text written by the dump
+ *   functions never contains a zero byte, vis/compress/athunzip.c can restore
+ *   the uncompressed file by copying the text and expanding each section.
+ *   restart_grids() reads compressed restart files with ath_zunpack().
+ *
+ *   Every process compresses its own files, so all of them work in parallel.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - ath_zopen()   - starts writing a file through a ZFileS
+ * - ath_zprintf() - writes text
+ * - ath_zwrite()  - writes binary data
+ * - ath_zlossy()  - rounds data for lossy compression
+ * - ath_zclose()  - finishes writing through a ZFileS
+ * - ath_zunpack() - decompresses the rest of a file into memory	      */
+/*============================================================================*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "prototypes.h"
+#ifdef COMPRESSION
+#include <zlib.h>
+
+/* uncompressed size of chunks, a multiple of any element size */
+#define ZCHUNK 1048576
+
+static const unsigned char zmagic[6] = {0,'A','T','H','Z','1'};
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   end_section()  - writes last chunk of section and its end marker
+ *   put_chunk()    - shuffles, compresses and writes one chunk
+ *   put_u32()      - writes 4-byte little-endian integer
+ *   get_u32()      - reads 4-byte little-endian integer
+ *   get_section()  - reads and decompresses one section
+ *============================================================================*/
+
+static void end_section(ZFileS *zf);
+static void put_chunk(ZFileS *zf);
+static void put_u32(unsigned long n, FILE *fp);
+static unsigned long get_u32(FILE *fp);
+static void get_section(FILE *fp, FILE *out);
+#endif /* COMPRESSION */
+
+/*----------------------------------------------------------------------------*/
+/*! \fn ZFileS *ath_zopen(FILE *fp, const OutputS *pOut)
+ *  \brief Starts writing the open file fp through a ZFileS, with the
+ *   compression given in pOut */
+
+ZFileS *ath_zopen(FILE *fp, const OutputS *pOut)
+{
+  ZFileS *zf;
+
+  if ((zf = (ZFileS*)calloc(1,sizeof(ZFileS))) == NULL)
+    ath_error("[ath_zopen]: malloc failed for ZFileS\n");
+  zf->fp = fp;
+  zf->compress = pOut->compress;
+
+#ifdef COMPRESSION
+  if (zf->compress == 0) return zf;
+
+/* mantissa bits kept for relative error below rel_err */
+  if (zf->compress == 2) {
+    zf->keep = (int)ceil(-log(pOut->rel_err)/log(2.0)) - 1;
+    if (zf->keep < 0) zf->keep = 0;
+  }
+
+  zf->buf  = (unsigned char*)malloc(ZCHUNK);
+  zf->work = (unsigned char*)malloc(ZCHUNK + compressBound(ZCHUNK));
+  if (zf->buf == NULL || zf->work == NULL)
+    ath_error("[ath_zopen]: malloc failed for compression buffers\n");
+#endif /* COMPRESSION */
+
+  return zf;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int ath_zprintf(ZFileS *zf, const char *fmt, ...)
+ *  \brief Writes text like fprintf(), ending any section of binary data */
+
+int ath_zprintf(ZFileS *zf, const char *fmt, ...)
+{
+  va_list ap;
+  int ret;
+
+#ifdef COMPRESSION
+  if (zf->elsize > 0) end_section(zf);
+#endif
+  va_start(ap, fmt);
+  ret = vfprintf(zf->fp, fmt, ap);
+  va_end(ap);
+  return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn size_t ath_zwrite(const void *ptr, size_t size, size_t n, ZFileS *zf)
+ *  \brief Writes binary data like fwrite() */
+
+size_t ath_zwrite(const void *ptr, size_t size, size_t n, ZFileS *zf)
+{
+#ifdef COMPRESSION
+  const unsigned char *p = (const unsigned char*)ptr;
+  size_t len, nbytes = size*n;
+
+  if (zf->compress == 0) return fwrite(ptr, size, n, zf->fp);
+  if (size == 0 || size > 255 || ZCHUNK % size != 0)
+    ath_error("[ath_zwrite]: cannot compress elements of %lu bytes\n",
+      (unsigned long)size);
+
+/* start a new section if the size of the elements changes */
+
+  if (zf->elsize != size) {
+    if (zf->elsize > 0) end_section(zf);
+    fwrite(zmagic, 1, 6, zf->fp);
+    putc((int)size, zf->fp);
+    putc(0, zf->fp);
+    zf->elsize = size;
+  }
+
+  while (nbytes > 0) {
+    len = ZCHUNK - zf->nbuf;
+    if (len > nbytes) len = nbytes;
+    memcpy(zf->buf + zf->nbuf, p, len);
+    zf->nbuf += len;
+    p += len;
+    nbytes -= len;
+    if (zf->nbuf == ZCHUNK) put_chunk(zf);
+  }
+  return n;
+#else
+  return fwrite(ptr, size, n, zf->fp);
+#endif /* COMPRESSION */
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_zlossy(ZFileS *zf, void *data, size_t size, int n)
+ *  \brief With lossy compression, rounds the n floats (size=4) or doubles
+ *   (size=8) in data to the mantissa bits kept.  Call before any byte swap. */
+
+void ath_zlossy(ZFileS *zf, void *data, size_t size, int n)
+{
+#ifdef COMPRESSION
+  int i, drop;
+
+  if (zf->compress != 2) return;
+
+  if (size == sizeof(float) && sizeof(unsigned int) == 4) {
+    unsigned int *u = (unsigned int*)data, mask, half, v;
+    const unsigned int expo = 0x7f800000U;
+    if ((drop = 23 - zf->keep) <= 0) return;
+    mask = (1U << drop) - 1;
+    half = 1U << (drop - 1);
+    for (i=0; i<n; i++) {
+      if ((u[i] & expo) == expo) continue;  /* inf or nan */
+      v = (u[i] + half) & ~mask;
+      u[i] = ((v & expo) == expo) ? (u[i] & ~mask) : v;
+    }
+  } else if (size == sizeof(double) && sizeof(unsigned long long) == 8) {
+    unsigned long long *u = (unsigned long long*)data, mask, half, v;
+    const unsigned long long expo = 0x7ff0000000000000ULL;
+    if ((drop = 52 - zf->keep) <= 0) return;
+    mask = (1ULL << drop) - 1;
+    half = 1ULL << (drop - 1);
+    for (i=0; i<n; i++) {
+      if ((u[i] & expo) == expo) continue;
+      v = (u[i] + half) & ~mask;
+      u[i] = ((v & expo) == expo) ? (u[i] & ~mask) : v;
+    }
+  }
+#endif /* COMPRESSION */
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_zclose(ZFileS *zf)
+ *  \brief Ends any section of binary data and frees zf.  Does not close the
+ *   file. */
+
+void ath_zclose(ZFileS *zf)
+{
+#ifdef COMPRESSION
+  if (zf->elsize > 0) end_section(zf);
+  free(zf->buf);
+  free(zf->work);
+#endif
+  free(zf);
+  return;
+}
+
+#ifdef COMPRESSION
+/*----------------------------------------------------------------------------*/
+/*! \fn FILE *ath_zunpack(FILE *fp, char **image)
+ *  \brief Decompresses the rest of the file fp into memory, closes fp and
+ *   returns a stream that reads the uncompressed data.  *image must be freed
+ *   after the stream is closed. */
+
+FILE *ath_zunpack(FILE *fp, char **image)
+{
+  FILE *out;
+  size_t size;
+  int c;
+
+  if ((out = open_memstream(image, &size)) == NULL)
+    ath_error("[ath_zunpack]: Unable to open memory stream\n");
+
+  while ((c = getc(fp)) != EOF) {
+    if (c != 0) putc(c, out);
+    else get_section(fp, out);
+  }
+  fclose(out);
+  fclose(fp);
+
+  if ((fp = fmemopen(*image, size, "r")) == NULL)
+    ath_error("[ath_zunpack]: Unable to read decompressed data\n");
+  return fp;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void end_section(ZFileS *zf)
+ *  \brief Writes the last chunk of the current section and its end marker */
+
+static void end_section(ZFileS *zf)
+{
+  if (zf->nbuf > 0) put_chunk(zf);
+  put_u32(0, zf->fp);
+  put_u32(0, zf->fp);
+  zf->elsize = 0;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void put_chunk(ZFileS *zf)
+ *  \brief Shuffles the bytes of the elements in the current chunk,
+ *   compresses them and writes the chunk.  Stores the chunk unshuffled if it
+ *   does not get smaller. */
+
+static void put_chunk(ZFileS *zf)
+{
+  size_t i, b, s = zf->elsize, n = zf->nbuf/zf->elsize;
+  unsigned char *shuf = zf->work, *out = zf->work + ZCHUNK;
+  uLongf nout = compressBound(ZCHUNK);
+
+  for (b=0; b<s; b++) {
+    for (i=0; i<n; i++) shuf[b*n + i] = zf->buf[i*s + b];
+  }
+  if (compress2(out, &nout, shuf, (uLong)zf->nbuf, Z_BEST_SPEED) != Z_OK)
+    ath_error("[ath_zwrite]: zlib compress2() failed\n");
+
+  put_u32((unsigned long)zf->nbuf, zf->fp);
+  if (nout < zf->nbuf) {
+    put_u32((unsigned long)nout, zf->fp);
+    fwrite(out, 1, nout, zf->fp);
+  } else {
+    put_u32((unsigned long)zf->nbuf, zf->fp);
+    fwrite(zf->buf, 1, zf->nbuf, zf->fp);
+  }
+  zf->nbuf = 0;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void put_u32(unsigned long n, FILE *fp)
+ *  \brief Writes n as a 4-byte little-endian integer */
+
+static void put_u32(unsigned long n, FILE *fp)
+{
+  putc((int)( n        & 0xff), fp);
+  putc((int)((n >>  8) & 0xff), fp);
+  putc((int)((n >> 16) & 0xff), fp);
+  putc((int)((n >> 24) & 0xff), fp);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static unsigned long get_u32(FILE *fp)
+ *  \brief Reads a 4-byte little-endian integer */
+
+static unsigned long get_u32(FILE *fp)
+{
+  unsigned char c[4];
+
+  if (fread(c, 1, 4, fp) != 4)
+    ath_error("[ath_zunpack]: unexpected end of compressed file\n");
+  return (unsigned long)c[0] | ((unsigned long)c[1] << 8) |
+    ((unsigned long)c[2] << 16) | ((unsigned long)c[3] << 24);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void get_section(FILE *fp, FILE *out)
+ *  \brief Reads one section (after its first zero byte) from fp, and writes
+ *   the uncompressed data to out */
+
+static void get_section(FILE *fp, FILE *out)
+{
+  unsigned char head[7], *in, *shuf, *raw;
+  unsigned long nraw, nin;
+  uLongf nshuf;
+  size_t i, b, s, n;
+
+  if (fread(head, 1, 7, fp) != 7 || memcmp(head, zmagic+1, 5) != 0)
+    ath_error("[ath_zunpack]: zero byte outside compressed data\n");
+  s = (size_t)head[5];
+
+  in   = (unsigned char*)malloc(ZCHUNK + compressBound(ZCHUNK));
+  shuf = (unsigned char*)malloc(ZCHUNK);
+  raw  = (unsigned char*)malloc(ZCHUNK);
+  if (in == NULL || shuf == NULL || raw == NULL)
+    ath_error("[ath_zunpack]: malloc failed for compression buffers\n");
+
+  while ((nraw = get_u32(fp)) > 0) {
+    nin = get_u32(fp);
+    if (nraw > ZCHUNK || nin > nraw || fread(in, 1, nin, fp) != nin)
+      ath_error("[ath_zunpack]: corrupt compressed chunk\n");
+    if (nin == nraw) {
+      fwrite(in, 1, nraw, out);
+      continue;
+    }
+    nshuf = ZCHUNK;
+    if (uncompress(shuf, &nshuf, in, nin) != Z_OK || nshuf != nraw)
+      ath_error("[ath_zunpack]: zlib uncompress() failed\n");
+    n = nraw/s;
+    for (b=0; b<s; b++) {
+      for (i=0; i<n; i++) raw[i*s + b] = shuf[b*n + i];
+    }
+    fwrite(raw, 1, nraw, out);
+  }
+  get_u32(fp);  /* compressed size of end marker */
+
+  free(in);
+  free(shuf);
+  free(raw);
+  return;
+}
+#endif /* COMPRESSION */
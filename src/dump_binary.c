@@ -6,6 +6,11 @@
  * PURPOSE: Function to write an unformatted dump of the field variables that
  *   can be read, e.g., by IDL scripts.  With SMR, dumps are made for all levels
  *   and domains, unless nlevel and ndomain are specified in <output> block.
+ *   With compress = lossless or lossy in the <output> block, the binary data
+ *   is compressed (see compress.c) and the files are named *.binz.
+ *   With single_file = 1 in an MPI job, all processes write one file for each
+ *   Domain with MPI-IO (see shared_file.c), with the size and coordinates of
+ *   the whole Domain in its header.
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - dump_binary() - writes either conserved or primitive variables depending
@@ -23,6 +28,16 @@
 #include "particles/particle.h"
 #endif
 
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   dump_binary_shared() - writes binary dump of one Domain to a shared file
+ *============================================================================*/
+
+#ifdef MPI_PARALLEL
+static void dump_binary_shared(MeshS *pM, OutputS *pOut, int nl, int nd);
+#endif
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
 /*! \fn void dump_binary(MeshS *pM, OutputS *pOut)
  *  \brief Function to write an unformatted dump of the field variables. */
@@ -31,7 +46,9 @@ void dump_binary(MeshS *pM, OutputS *pOut)
 {
   GridS *pGrid;
   PrimS ***W;
+  ConsS Ucell;
   FILE *p_binfile;
+  ZFileS *zf;
   char *fname,*plev=NULL,*pdom=NULL;
   char levstr[8],domstr[8];
   int n,ndata[7];
@@ -52,6 +69,13 @@ void dump_binary(MeshS *pM, OutputS *pOut)
           (pOut->ndomain == -1 || pOut->ndomain == nd)){
         pGrid = pM->Domain[nl][nd].Grid;
 
+#ifdef MPI_PARALLEL
+        if (pOut->single_file) {
+          dump_binary_shared(pM,pOut,nl,nd);
+          continue;
+        }
+#endif
+
         il = pGrid->is, iu = pGrid->ie;
         jl = pGrid->js, ju = pGrid->je;
         kl = pGrid->ks, ku = pGrid->ke;
@@ -85,7 +109,8 @@ void dump_binary(MeshS *pM, OutputS *pOut)
           for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
           for (i=il; i<=iu; i++) {
-            W[k-kl][j-jl][i-il] = Cons_to_Prim(&(pGrid->U[k][j][i]));
+            Ucell = GET_GRID_U(pGrid,k,j,i);
+            W[k-kl][j-jl][i-il] = Cons_to_Prim(&Ucell);
           }}}
         }
 
@@ -99,7 +124,7 @@ void dump_binary(MeshS *pM, OutputS *pOut)
           sprintf(pdom,"dom%d",nd);
         }
         if((fname = ath_fname(plev,pM->outfilename,plev,pdom,num_digit,
-            pOut->num,NULL,"bin")) == NULL){
+            pOut->num,NULL,(pOut->compress ? "binz" : "bin"))) == NULL){
           ath_error("[dump_binary]: Error constructing filename\n");
         }
 
@@ -108,6 +133,7 @@ void dump_binary(MeshS *pM, OutputS *pOut)
           return;
         }
         free(fname);
+        zf = ath_zopen(p_binfile,pOut);
 
 /* Write the coordinate system information */
 #if defined CARTESIAN
@@ -117,7 +143,7 @@ void dump_binary(MeshS *pM, OutputS *pOut)
 #elif defined SPHERICAL
         coordsys = -3;
 #endif
-        fwrite(&coordsys,sizeof(int),1,p_binfile);
+        ath_zwrite(&coordsys,sizeof(int),1,zf);
 
 /* Write number of zones and variables */
         ndata[3] = NVAR;
@@ -132,7 +158,7 @@ void dump_binary(MeshS *pM, OutputS *pOut)
 #else
         ndata[6] = 0;
 #endif
-        fwrite(ndata,sizeof(int),7,p_binfile);
+        ath_zwrite(ndata,sizeof(int),7,zf);
 
 /* Write (gamma-1) and isothermal sound speed */
 
@@ -145,13 +171,13 @@ void dump_binary(MeshS *pM, OutputS *pOut)
 #else
         dat[0] = dat[1] = 0.0; /* Anything better to put here? */
 #endif
-        fwrite(dat,sizeof(Real),2,p_binfile);
+        ath_zwrite(dat,sizeof(Real),2,zf);
 
 /* Write time, dt */
 
         dat[0] = (Real)pGrid->time;
         dat[1] = (Real)pGrid->dt;
-        fwrite(dat,sizeof(Real),2,p_binfile);
+        ath_zwrite(dat,sizeof(Real),2,zf);
  
 /* Allocate Memory */
 
@@ -175,21 +201,21 @@ void dump_binary(MeshS *pM, OutputS *pOut)
           pData = ((Real *) &(x1));
           datax[i-il] = (Real)(*pData);
         }
-        fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
+        ath_zwrite(datax,sizeof(Real),(size_t)ndata[0],zf);
 
         for (j=jl; j<=ju; j++) {
           cc_pos(pGrid,il,j,kl,&x1,&x2,&x3);
           pData = ((Real *) &(x2));
           datay[j-jl] = (Real)(*pData);
         }
-        fwrite(datay,sizeof(Real),(size_t)ndata[1],p_binfile);
+        ath_zwrite(datay,sizeof(Real),(size_t)ndata[1],zf);
 
         for (k=kl; k<=ku; k++) {
           cc_pos(pGrid,il,jl,k,&x1,&x2,&x3);
           pData = ((Real *) &(x3));
           dataz[k-kl] = (Real)(*pData);
         }
-        fwrite(dataz,sizeof(Real),(size_t)ndata[2],p_binfile);
+        ath_zwrite(dataz,sizeof(Real),(size_t)ndata[2],zf);
 
 /* Write cell-centered data (either conserved or primitives) */
 
@@ -199,14 +225,15 @@ void dump_binary(MeshS *pM, OutputS *pOut)
             for (i=0; i<ndata[0]; i++) {
 
               if (strcmp(pOut->out,"cons") == 0){
-                pData = ((Real*)&(pGrid->U[k+kl][j+jl][i+il])) + n;
+                pData = &GRID_UN(pGrid,k+kl,j+jl,i+il,n);
               } else if(strcmp(pOut->out,"prim") == 0) {
                 pData = ((Real*)&(W[k][j][i])) + n;
               }
               datax[i] = (Real)(*pData);
 
             }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
+            ath_zlossy(zf,datax,sizeof(Real),ndata[0]);
+            ath_zwrite(datax,sizeof(Real),(size_t)ndata[0],zf);
 
           }}
         }
@@ -218,7 +245,8 @@ void dump_binary(MeshS *pM, OutputS *pOut)
             pData = &(pGrid->Phi[k+kl][j+jl][i+il]);
             datax[i] = (Real)(*pData);
           }
-          fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
+          ath_zlossy(zf,datax,sizeof(Real),ndata[0]);
+          ath_zwrite(datax,sizeof(Real),(size_t)ndata[0],zf);
         }}
 #endif
 
@@ -229,33 +257,38 @@ void dump_binary(MeshS *pM, OutputS *pOut)
             for (i=0; i<ndata[0]; i++) {
               datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_d;
             }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
+            ath_zlossy(zf,datax,sizeof(Real),ndata[0]);
+            ath_zwrite(datax,sizeof(Real),(size_t)ndata[0],zf);
           }}
           for (k=0; k<ndata[2]; k++) {
           for (j=0; j<ndata[1]; j++) {
             for (i=0; i<ndata[0]; i++) {
               datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_v1;
             }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
+            ath_zlossy(zf,datax,sizeof(Real),ndata[0]);
+            ath_zwrite(datax,sizeof(Real),(size_t)ndata[0],zf);
           }}
           for (k=0; k<ndata[2]; k++) {
           for (j=0; j<ndata[1]; j++) {
             for (i=0; i<ndata[0]; i++) {
               datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_v2;
             }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
+            ath_zlossy(zf,datax,sizeof(Real),ndata[0]);
+            ath_zwrite(datax,sizeof(Real),(size_t)ndata[0],zf);
           }}
           for (k=0; k<ndata[2]; k++) {
           for (j=0; j<ndata[1]; j++) {
             for (i=0; i<ndata[0]; i++) {
               datax[i] = pGrid->Coup[k+kl][j+jl][i+il].grid_v3;
             }
-            fwrite(datax,sizeof(Real),(size_t)ndata[0],p_binfile);
+            ath_zlossy(zf,datax,sizeof(Real),ndata[0]);
+            ath_zwrite(datax,sizeof(Real),(size_t)ndata[0],zf);
           }}
         }
 #endif
 
 /* close file and free memory */
+        ath_zclose(zf);
         fclose(p_binfile); 
         free(datax); 
         free(datay); 
@@ -265,3 +298,146 @@ void dump_binary(MeshS *pM, OutputS *pOut)
     }
   }
 }
+
+#ifdef MPI_PARALLEL
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void dump_binary_shared(MeshS *pM, OutputS *pOut, int nl,
+ *                                     int nd)
+ *  \brief Writes binary dump of Domain nd on level nl to one file shared by
+ *   all processes with a Grid in it.  The layout is that of dump_binary(),
+ *   with the number of cells and coordinates of the whole Domain. */
+
+static void dump_binary_shared(MeshS *pM, OutputS *pOut, int nl, int nd)
+{
+  DomainS *pD = &(pM->Domain[nl][nd]);
+  GridS *pGrid = pD->Grid;
+  PrimS ***W=NULL;
+  ConsS Ucell;
+  SFileS *sf;
+  int i,j,k,m,n,nmax,ndata[7];
+  int prim = (strcmp(pOut->out,"prim") == 0);
+  Real dat[2],*data;
+  int coordsys = -1;
+
+  nmax = MAX(MAX(pD->Nx[0],pD->Nx[1]),pD->Nx[2]);
+  nmax = MAX(nmax,pGrid->Nx[0]*pGrid->Nx[1]*pGrid->Nx[2]);
+  if((data = (Real *)malloc(nmax*sizeof(Real))) == NULL)
+    ath_error("[dump_binary]: malloc failed for temporary array\n");
+
+  if (prim) {
+    if((W = (PrimS***)calloc_3d_array(pGrid->Nx[2],pGrid->Nx[1],pGrid->Nx[0],
+      sizeof(PrimS))) == NULL)
+      ath_error("[dump_bin]: failed to allocate Prim array\n");
+    for (k=pGrid->ks; k<=pGrid->ke; k++) {
+    for (j=pGrid->js; j<=pGrid->je; j++) {
+    for (i=pGrid->is; i<=pGrid->ie; i++) {
+      Ucell = GET_GRID_U(pGrid,k,j,i);
+      W[k-pGrid->ks][j-pGrid->js][i-pGrid->is] = Cons_to_Prim(&Ucell);
+    }}}
+  }
+
+  sf = ath_sfopen(pM,nl,nd,pOut,NULL,"bin");
+
+/* Write the coordinate system information */
+#if defined CARTESIAN
+  coordsys = -1;
+#elif defined CYLINDRICAL
+  coordsys = -2;
+#elif defined SPHERICAL
+  coordsys = -3;
+#endif
+  ath_sfwrite(&coordsys,sizeof(int),1,sf);
+
+/* Write number of zones in Domain and variables */
+  ndata[0] = pD->Nx[0];
+  ndata[1] = pD->Nx[1];
+  ndata[2] = pD->Nx[2];
+  ndata[3] = NVAR;
+  ndata[4] = NSCALARS;
+#ifdef SELF_GRAVITY
+  ndata[5] = 1;
+#else
+  ndata[5] = 0;
+#endif
+#ifdef PARTICLES
+  ndata[6] = 1;
+#else
+  ndata[6] = 0;
+#endif
+  ath_sfwrite(ndata,sizeof(int),7,sf);
+
+/* Write (gamma-1) and isothermal sound speed, then time and dt */
+
+#ifdef ISOTHERMAL
+  dat[0] = (Real)0.0;
+  dat[1] = (Real)Iso_csound;
+#elif defined ADIABATIC
+  dat[0] = (Real)Gamma_1 ;
+  dat[1] = (Real)0.0;
+#else
+  dat[0] = dat[1] = 0.0;
+#endif
+  ath_sfwrite(dat,sizeof(Real),2,sf);
+
+  dat[0] = (Real)pGrid->time;
+  dat[1] = (Real)pGrid->dt;
+  ath_sfwrite(dat,sizeof(Real),2,sf);
+
+/* Write x,y,z coordinates of cell centers over the Domain */
+
+  for (n=0; n<3; n++) {
+    for (i=0; i<ndata[n]; i++)
+      data[i] = pD->MinX[n] + ((Real)i + 0.5)*pD->dx[n];
+    ath_sfwrite(data,sizeof(Real),(size_t)ndata[n],sf);
+  }
+
+/* Write cell-centered data (either conserved or primitives) */
+
+  for (n=0; n<NVAR; n++) {
+    m = 0;
+    for (k=pGrid->ks; k<=pGrid->ke; k++) {
+    for (j=pGrid->js; j<=pGrid->je; j++) {
+    for (i=pGrid->is; i<=pGrid->ie; i++) {
+      if (prim) {
+        data[m++] = ((Real*)&(W[k-pGrid->ks][j-pGrid->js][i-pGrid->is]))[n];
+      } else {
+        data[m++] = GRID_UN(pGrid,k,j,i,n);
+      }
+    }}}
+    ath_sfwrite_grid(data,(int)sizeof(Real),sf);
+  }
+
+#ifdef SELF_GRAVITY
+  m = 0;
+  for (k=pGrid->ks; k<=pGrid->ke; k++) {
+  for (j=pGrid->js; j<=pGrid->je; j++) {
+  for (i=pGrid->is; i<=pGrid->ie; i++) {
+    data[m++] = pGrid->Phi[k][j][i];
+  }}}
+  ath_sfwrite_grid(data,(int)sizeof(Real),sf);
+#endif
+
+#ifdef PARTICLES
+  if (pOut->out_pargrid) {
+    for (n=0; n<4; n++) {
+      m = 0;
+      for (k=pGrid->ks; k<=pGrid->ke; k++) {
+      for (j=pGrid->js; j<=pGrid->je; j++) {
+      for (i=pGrid->is; i<=pGrid->ie; i++) {
+        if      (n == 0) data[m++] = pGrid->Coup[k][j][i].grid_d;
+        else if (n == 1) data[m++] = pGrid->Coup[k][j][i].grid_v1;
+        else if (n == 2) data[m++] = pGrid->Coup[k][j][i].grid_v2;
+        else             data[m++] = pGrid->Coup[k][j][i].grid_v3;
+      }}}
+      ath_sfwrite_grid(data,(int)sizeof(Real),sf);
+    }
+  }
+#endif
+
+  ath_sfclose(sf);
+  free(data);
+  if (prim) free_3d_array(W);
+  return;
+}
+#endif /* MPI_PARALLEL */
@@ -0,0 +1,551 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file dump_hdf5.c
+ *  \brief Function to write a dump of the field variables in an HDF5 file.
+ *
+ * PURPOSE: Function to write a dump of the field variables on all levels and
+ *   Domains of the Mesh into one HDF5 file (out_fmt = hdf, requires configure
+ *   --enable-hdf5), named <basename>.<num>.<id>.h5.  With MPI the file is
+ *   written in the run directory, the parent of the id# directories.  The
+ *   file contains:
+ *   - attributes of the root group: time, dt, nstep, NLevels, DomainsPerLevel,
+ *     coordsys, NVAR, NSCALARS, gamma_1, iso_csound and variables (cons/prim)
+ *   - /Parameters: the text of the parameter database, as from par_dump()
+ *   - /levelL/domainD: one group per Domain, with attributes Level, DomNumber,
+ *     Nx, Disp, MinX, MaxX and dx, datasets x1, x2, x3 of the cell centers,
+ *     and one [Nx3][Nx2][Nx1] dataset per variable (d, M1, M2, M3, E, B1c,
+ *     B2c, B3c, s0,... or d, V1, V2, V3, P, B1c, B2c, B3c, r0,..., then Phi
+ *     and the binned particle variables dpar, M1par, M2par, M3par).
+ *
+ *   Each variable is stored in chunks of chunk^3 cells (chunk = 32 by default
+ *   in the <output> block), compressed with the shuffle and deflate filters
+ *   when compress = lossless.  Any HDF5 reader can therefore read a subvolume
+ *   by reading only the chunks it covers, e.g. vis/hdf5/h5slab.
+ *
+ *   When the HDF5 library is built for parallel I/O (H5_HAVE_PARALLEL), all
+ *   processes create the file together and write their Grids with collective
+ *   MPI-IO transfers.  Otherwise the root process creates the file and all
+ *   objects in it, then the processes write their Grids in turn.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - dump_hdf5() - writes either conserved or primitive variables depending
+ *                 on value of pOut->out read from input block.		      */
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+#ifdef PARTICLES
+#include "particles/particle.h"
+#endif
+
+#ifdef HDF5_OUTPUT
+#include "hdf5.h"
+
+#ifdef SINGLE_PREC
+#define H5T_NATIVE_REAL H5T_NATIVE_FLOAT
+#else
+#define H5T_NATIVE_REAL H5T_NATIVE_DOUBLE
+#endif
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   hdf_nvar()   - number of variables in the dump
+ *   hdf_name()   - name of variable n
+ *   hdf_attr()   - writes an attribute
+ *   hdf_write()  - writes a whole dataset from one process
+ *   hdf_header() - writes time, configuration and parameters
+ *   hdf_domain() - creates the group and datasets of one Domain
+ *   hdf_grid()   - writes the data of this process's Grid in one Domain
+ *============================================================================*/
+
+static int hdf_nvar(const OutputS *pOut);
+static void hdf_name(const OutputS *pOut, const int n, char *name);
+static void hdf_attr(hid_t loc, const char *name, hid_t type, const int n,
+                     const void *data);
+static void hdf_write(hid_t dset, hid_t type, const void *data,
+                      const int writer, hid_t dxpl);
+static void hdf_header(hid_t file, MeshS *pM, OutputS *pOut, const int writer,
+                       hid_t dxpl);
+static void hdf_domain(hid_t file, MeshS *pM, OutputS *pOut, int nl, int nd,
+                       const int writer, hid_t dxpl);
+static void hdf_grid(hid_t file, MeshS *pM, OutputS *pOut, int nl, int nd,
+                     hid_t dxpl);
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_hdf5(MeshS *pM, OutputS *pOut)
+ *  \brief Function to write a dump of all levels and Domains in one HDF5
+ *   file. */
+
+void dump_hdf5(MeshS *pM, OutputS *pOut)
+{
+  hid_t file, dxpl = H5P_DEFAULT;
+  char *fname=NULL;
+  int nl,nd;
+#ifdef MPI_PARALLEL
+  int len;
+#ifdef H5_HAVE_PARALLEL
+  hid_t fapl;
+#endif
+#endif
+
+/* construct filename from the name of the root process, with the id so
+ * that several hdf outputs (e.g. cons and prim) do not share a file */
+
+#ifdef MPI_PARALLEL
+  if (myID_Comm_world == 0) {
+    fname = ath_fname("..",pM->outfilename,NULL,NULL,num_digit,pOut->num,
+                      pOut->id,"h5");
+    len = (fname == NULL ? 0 : 1 + (int)strlen(fname));
+  }
+  MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (len == 0)
+    ath_error("[dump_hdf5]: Error constructing filename\n");
+  if (myID_Comm_world != 0 && (fname = (char*)malloc(len)) == NULL)
+    ath_error("[dump_hdf5]: malloc failed for filename\n");
+  MPI_Bcast(fname, len, MPI_CHAR, 0, MPI_COMM_WORLD);
+#else
+  if((fname = ath_fname(NULL,pM->outfilename,NULL,NULL,num_digit,pOut->num,
+                        pOut->id,"h5")) == NULL)
+    ath_error("[dump_hdf5]: Error constructing filename\n");
+#endif
+
+#if defined(MPI_PARALLEL) && defined(H5_HAVE_PARALLEL)
+/* All processes create the file and every object in it, then write their
+ * Grids with collective transfers */
+
+  fapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, MPI_INFO_NULL);
+  if ((file = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+    ath_error("[dump_hdf5]: Unable to create %s\n",fname);
+  H5Pclose(fapl);
+  dxpl = H5Pcreate(H5P_DATASET_XFER);
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+
+  hdf_header(file,pM,pOut,(myID_Comm_world == 0),dxpl);
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      if ((pOut->nlevel == -1 || pOut->nlevel == nl) &&
+          (pOut->ndomain == -1 || pOut->ndomain == nd)){
+        hdf_domain(file,pM,pOut,nl,nd,(myID_Comm_world == 0),dxpl);
+        hdf_grid(file,pM,pOut,nl,nd,dxpl);
+      }
+    }
+  }
+  H5Pclose(dxpl);
+
+#else /* serial HDF5 */
+/* The root process creates the file and every object in it, then each
+ * process in turn opens the file and writes its Grids, passing a baton */
+
+#ifdef MPI_PARALLEL
+  baton_start(1, hdf5_baton_tag);
+  if (myID_Comm_world > 0) {
+    if ((file = H5Fopen(fname, H5F_ACC_RDWR, H5P_DEFAULT)) < 0)
+      ath_error("[dump_hdf5]: Unable to open %s\n",fname);
+  } else
+#endif
+  {
+    if ((file = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+      ath_error("[dump_hdf5]: Unable to create %s\n",fname);
+    hdf_header(file,pM,pOut,1,dxpl);
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if ((pOut->nlevel == -1 || pOut->nlevel == nl) &&
+            (pOut->ndomain == -1 || pOut->ndomain == nd))
+          hdf_domain(file,pM,pOut,nl,nd,1,dxpl);
+      }
+    }
+  }
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      if (pM->Domain[nl][nd].Grid != NULL &&
+          (pOut->nlevel == -1 || pOut->nlevel == nl) &&
+          (pOut->ndomain == -1 || pOut->ndomain == nd))
+        hdf_grid(file,pM,pOut,nl,nd,dxpl);
+    }
+  }
+#endif /* H5_HAVE_PARALLEL */
+
+  if (H5Fclose(file) < 0)
+    ath_error("[dump_hdf5]: Error closing %s\n",fname);
+#if defined(MPI_PARALLEL) && !defined(H5_HAVE_PARALLEL)
+  baton_stop(1, hdf5_baton_tag);
+#endif
+  free(fname);
+
+  return;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static int hdf_nvar(const OutputS *pOut)
+ *  \brief Number of variables in the dump */
+
+static int hdf_nvar(const OutputS *pOut)
+{
+  int nvar = NVAR;
+#ifdef SELF_GRAVITY
+  nvar++;
+#endif
+#ifdef PARTICLES
+  if (pOut->out_pargrid) nvar += 4;
+#endif
+  return nvar;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hdf_name(const OutputS *pOut, const int n, char *name)
+ *  \brief Name of variable n, in the order of ConsS or PrimS, then Phi and
+ *   the particle variables.  name must hold at least 16 chars. */
+
+static void hdf_name(const OutputS *pOut, const int n, char *name)
+{
+  int prim = (strcmp(pOut->out,"prim") == 0);
+  int m = n;
+
+  if (m == 0) { strcpy(name,"d"); return; }
+  if (m <= 3) { sprintf(name,"%s%d",(prim ? "V" : "M"),m); return; }
+  m -= 4;
+#ifndef BAROTROPIC
+  if (m == 0) { strcpy(name,(prim ? "P" : "E")); return; }
+  m--;
+#endif
+#ifdef MHD
+  if (m < 3) { sprintf(name,"B%dc",m+1); return; }
+  m -= 3;
+#endif
+#if (NSCALARS > 0)
+  if (m < NSCALARS) { sprintf(name,"%s%d",(prim ? "r" : "s"),m); return; }
+  m -= NSCALARS;
+#endif
+#ifdef SELF_GRAVITY
+  if (m == 0) { strcpy(name,"Phi"); return; }
+  m--;
+#endif
+  if (m == 0) strcpy(name,"dpar");
+  else sprintf(name,"M%dpar",m);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hdf_attr(hid_t loc, const char *name, hid_t type,
+ *                           const int n, const void *data)
+ *  \brief Writes an attribute of n elements (a scalar if n = 0) */
+
+static void hdf_attr(hid_t loc, const char *name, hid_t type, const int n,
+                     const void *data)
+{
+  hid_t space, attr;
+  hsize_t dim = (hsize_t)n;
+
+  space = (n == 0 ? H5Screate(H5S_SCALAR) : H5Screate_simple(1,&dim,NULL));
+  attr = H5Acreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  if (attr < 0 || H5Awrite(attr, type, data) < 0)
+    ath_error("[dump_hdf5]: Unable to write attribute %s\n",name);
+  H5Aclose(attr);
+  H5Sclose(space);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hdf_write(hid_t dset, hid_t type, const void *data,
+ *                            const int writer, hid_t dxpl)
+ *  \brief Writes all of a dataset that is the same on every process.  Only
+ *   the writer writes data, the others take part in collective transfers. */
+
+static void hdf_write(hid_t dset, hid_t type, const void *data,
+                      const int writer, hid_t dxpl)
+{
+  hid_t space;
+  herr_t ierr;
+
+  space = H5Dget_space(dset);
+  if (!writer) H5Sselect_none(space);
+  ierr = H5Dwrite(dset, type, space, space, dxpl, data);
+  H5Sclose(space);
+  if (ierr < 0)
+    ath_error("[dump_hdf5]: Unable to write dataset\n");
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hdf_header(hid_t file, MeshS *pM, OutputS *pOut,
+ *                             const int writer, hid_t dxpl)
+ *  \brief Writes time, configuration and the parameter database */
+
+static void hdf_header(hid_t file, MeshS *pM, OutputS *pOut, const int writer,
+                       hid_t dxpl)
+{
+  hid_t root, type, space, dset;
+  FILE *fp;
+  char *text=NULL;
+  long len=0;
+  int ival;
+  double dval;
+
+  root = H5Gopen2(file, "/", H5P_DEFAULT);
+
+  dval = (double)pM->time;
+  hdf_attr(root,"time",H5T_NATIVE_DOUBLE,0,&dval);
+  dval = (double)pM->dt;
+  hdf_attr(root,"dt",H5T_NATIVE_DOUBLE,0,&dval);
+  hdf_attr(root,"nstep",H5T_NATIVE_INT,0,&(pM->nstep));
+  hdf_attr(root,"NLevels",H5T_NATIVE_INT,0,&(pM->NLevels));
+  hdf_attr(root,"DomainsPerLevel",H5T_NATIVE_INT,pM->NLevels,
+           pM->DomainsPerLevel);
+
+#if defined CARTESIAN
+  ival = -1;
+#elif defined CYLINDRICAL
+  ival = -2;
+#elif defined SPHERICAL
+  ival = -3;
+#endif
+  hdf_attr(root,"coordsys",H5T_NATIVE_INT,0,&ival);
+  ival = NVAR;
+  hdf_attr(root,"NVAR",H5T_NATIVE_INT,0,&ival);
+  ival = NSCALARS;
+  hdf_attr(root,"NSCALARS",H5T_NATIVE_INT,0,&ival);
+
+#ifdef ISOTHERMAL
+  dval = 0.0;
+  hdf_attr(root,"gamma_1",H5T_NATIVE_DOUBLE,0,&dval);
+  dval = (double)Iso_csound;
+  hdf_attr(root,"iso_csound",H5T_NATIVE_DOUBLE,0,&dval);
+#elif defined ADIABATIC
+  dval = (double)Gamma_1;
+  hdf_attr(root,"gamma_1",H5T_NATIVE_DOUBLE,0,&dval);
+  dval = 0.0;
+  hdf_attr(root,"iso_csound",H5T_NATIVE_DOUBLE,0,&dval);
+#endif
+
+  type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, strlen(pOut->out));
+  hdf_attr(root,"variables",type,0,pOut->out);
+  H5Tclose(type);
+  H5Gclose(root);
+
+/* Text of the parameter database, taken from the writer (with MPI, the
+ * problem_id of the other processes includes their id) */
+
+  if (writer) {
+    if ((fp = tmpfile()) == NULL)
+      ath_error("[dump_hdf5]: Unable to open temporary file\n");
+    par_dump(0,fp);
+    len = ftell(fp);
+    if ((text = (char*)malloc(len+1)) == NULL)
+      ath_error("[dump_hdf5]: malloc failed for parameters\n");
+    rewind(fp);
+    if (fread(text, 1, len, fp) != (size_t)len)
+      ath_error("[dump_hdf5]: Error reading parameters\n");
+    fclose(fp);
+  }
+#if defined(MPI_PARALLEL) && defined(H5_HAVE_PARALLEL)
+  MPI_Bcast(&len, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+#endif
+
+  type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, (size_t)(len > 0 ? len : 1));
+  space = H5Screate(H5S_SCALAR);
+  dset = H5Dcreate2(file, "Parameters", type, space, H5P_DEFAULT, H5P_DEFAULT,
+                    H5P_DEFAULT);
+  if (dset < 0)
+    ath_error("[dump_hdf5]: Unable to create dataset Parameters\n");
+  hdf_write(dset, type, text, writer, dxpl);
+  H5Dclose(dset);
+  H5Sclose(space);
+  H5Tclose(type);
+  if (text != NULL) free(text);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hdf_domain(hid_t file, MeshS *pM, OutputS *pOut, int nl,
+ *                             int nd, const int writer, hid_t dxpl)
+ *  \brief Creates the group of Domain nd on level nl, with its attributes,
+ *   coordinates, and a chunked dataset for each variable */
+
+static void hdf_domain(hid_t file, MeshS *pM, OutputS *pOut, int nl, int nd,
+                       const int writer, hid_t dxpl)
+{
+  DomainS *pD = &(pM->Domain[nl][nd]);
+  hid_t lcpl, group, space, dcpl, dset;
+  hsize_t dims[3], chunk[3];
+  char path[48], name[16];
+  double dval[3], *x;
+  int i,n,nvar = hdf_nvar(pOut);
+
+  lcpl = H5Pcreate(H5P_LINK_CREATE);
+  H5Pset_create_intermediate_group(lcpl, 1);
+  sprintf(path,"level%d/domain%d",nl,nd);
+  if ((group = H5Gcreate2(file, path, lcpl, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+    ath_error("[dump_hdf5]: Unable to create group %s\n",path);
+  H5Pclose(lcpl);
+
+  hdf_attr(group,"Level",H5T_NATIVE_INT,0,&(pD->Level));
+  hdf_attr(group,"DomNumber",H5T_NATIVE_INT,0,&(pD->DomNumber));
+  hdf_attr(group,"Nx",H5T_NATIVE_INT,3,pD->Nx);
+  hdf_attr(group,"Disp",H5T_NATIVE_INT,3,pD->Disp);
+  for (n=0; n<3; n++) dval[n] = (double)pD->MinX[n];
+  hdf_attr(group,"MinX",H5T_NATIVE_DOUBLE,3,dval);
+  for (n=0; n<3; n++) dval[n] = (double)pD->MaxX[n];
+  hdf_attr(group,"MaxX",H5T_NATIVE_DOUBLE,3,dval);
+  for (n=0; n<3; n++) dval[n] = (double)pD->dx[n];
+  hdf_attr(group,"dx",H5T_NATIVE_DOUBLE,3,dval);
+
+/* Coordinates of cell centers */
+
+  for (n=0; n<3; n++) {
+    if ((x = (double*)malloc(pD->Nx[n]*sizeof(double))) == NULL)
+      ath_error("[dump_hdf5]: malloc failed for coordinates\n");
+    for (i=0; i<pD->Nx[n]; i++)
+      x[i] = (double)(pD->MinX[n] + ((Real)i + 0.5)*pD->dx[n]);
+    dims[0] = (hsize_t)pD->Nx[n];
+    space = H5Screate_simple(1, dims, NULL);
+    sprintf(name,"x%d",n+1);
+    dset = H5Dcreate2(group, name, H5T_NATIVE_DOUBLE, space, H5P_DEFAULT,
+                      H5P_DEFAULT, H5P_DEFAULT);
+    if (dset < 0)
+      ath_error("[dump_hdf5]: Unable to create dataset %s/%s\n",path,name);
+    hdf_write(dset, H5T_NATIVE_DOUBLE, x, writer, dxpl);
+    H5Dclose(dset);
+    H5Sclose(space);
+    free(x);
+  }
+
+/* Chunked datasets of the variables, written later by hdf_grid() */
+
+  for (n=0; n<3; n++) {
+    dims[n] = (hsize_t)pD->Nx[2-n];
+    chunk[n] = (hsize_t)MIN(pOut->chunk, pD->Nx[2-n]);
+  }
+  dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(dcpl, 3, chunk);
+  H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER);
+  if (pOut->compress) {
+    H5Pset_shuffle(dcpl);
+    H5Pset_deflate(dcpl, 1);
+  }
+  space = H5Screate_simple(3, dims, NULL);
+  for (n=0; n<nvar; n++) {
+    hdf_name(pOut,n,name);
+    dset = H5Dcreate2(group, name, H5T_NATIVE_REAL, space, H5P_DEFAULT, dcpl,
+                      H5P_DEFAULT);
+    if (dset < 0)
+      ath_error("[dump_hdf5]: Unable to create dataset %s/%s\n",path,name);
+    H5Dclose(dset);
+  }
+  H5Sclose(space);
+  H5Pclose(dcpl);
+  H5Gclose(group);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hdf_grid(hid_t file, MeshS *pM, OutputS *pOut, int nl,
+ *                           int nd, hid_t dxpl)
+ *  \brief Writes the variables of this process's Grid in Domain nd on level
+ *   nl into the hyperslab it covers.  Without a Grid in the Domain, takes part
+ *   in the collective transfers with an empty selection. */
+
+static void hdf_grid(hid_t file, MeshS *pM, OutputS *pOut, int nl, int nd,
+                     hid_t dxpl)
+{
+  DomainS *pD = &(pM->Domain[nl][nd]);
+  GridS *pGrid = pD->Grid;
+  PrimS ***W=NULL;
+  ConsS Ucell;
+  hid_t fspace, mspace, dset;
+  hsize_t start[3], count[3];
+  char path[48];
+  Real *data=NULL;
+  int i,j,k,m,n,nvar = hdf_nvar(pOut);
+  int is,ie,js,je,ks,ke;
+
+  if (pGrid != NULL) {
+    is = pGrid->is; ie = pGrid->ie;
+    js = pGrid->js; je = pGrid->je;
+    ks = pGrid->ks; ke = pGrid->ke;
+    for (n=0; n<3; n++) {
+      start[n] = (hsize_t)(pGrid->Disp[2-n] - pD->Disp[2-n]);
+      count[n] = (hsize_t)pGrid->Nx[2-n];
+    }
+    mspace = H5Screate_simple(3, count, NULL);
+
+    if((data = (Real *)malloc(pGrid->Nx[0]*pGrid->Nx[1]*pGrid->Nx[2]
+                              *sizeof(Real))) == NULL)
+      ath_error("[dump_hdf5]: malloc failed for temporary array\n");
+
+/* calculate primitive variables, if needed */
+
+    if(strcmp(pOut->out,"prim") == 0) {
+      if((W = (PrimS***)calloc_3d_array(pGrid->Nx[2],pGrid->Nx[1],
+                                        pGrid->Nx[0],sizeof(PrimS))) == NULL)
+        ath_error("[dump_hdf5]: failed to allocate Prim array\n");
+
+      for (k=ks; k<=ke; k++) {
+      for (j=js; j<=je; j++) {
+      for (i=is; i<=ie; i++) {
+        Ucell = GET_GRID_U(pGrid,k,j,i);
+        W[k-ks][j-js][i-is] = Cons_to_Prim(&Ucell);
+      }}}
+    }
+  } else {
+    is = ie = js = je = ks = ke = 0;
+    mspace = H5Screate(H5S_NULL);
+  }
+
+  for (n=0; n<nvar; n++) {
+    sprintf(path,"level%d/domain%d/",nl,nd);
+    hdf_name(pOut,n,&(path[strlen(path)]));
+    if ((dset = H5Dopen2(file, path, H5P_DEFAULT)) < 0)
+      ath_error("[dump_hdf5]: Unable to open dataset %s\n",path);
+    fspace = H5Dget_space(dset);
+
+    if (pGrid == NULL) {
+      H5Sselect_none(fspace);
+    } else {
+      H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, NULL);
+      m = 0;
+      for (k=ks; k<=ke; k++) {
+      for (j=js; j<=je; j++) {
+      for (i=is; i<=ie; i++) {
+        if (n < NVAR) {
+          if (W != NULL) data[m++] = ((Real*)&(W[k-ks][j-js][i-is]))[n];
+          else data[m++] = GRID_UN(pGrid,k,j,i,n);
+        }
+#ifdef SELF_GRAVITY
+        else if (n == NVAR) data[m++] = pGrid->Phi[k][j][i];
+#endif
+#ifdef PARTICLES
+        else if (n == nvar-4) data[m++] = pGrid->Coup[k][j][i].grid_d;
+        else if (n == nvar-3) data[m++] = pGrid->Coup[k][j][i].grid_v1;
+        else if (n == nvar-2) data[m++] = pGrid->Coup[k][j][i].grid_v2;
+        else data[m++] = pGrid->Coup[k][j][i].grid_v3;
+#endif
+      }}}
+    }
+
+    if (H5Dwrite(dset, H5T_NATIVE_REAL, mspace, fspace, dxpl, data) < 0)
+      ath_error("[dump_hdf5]: Unable to write dataset %s\n",path);
+    H5Sclose(fspace);
+    H5Dclose(dset);
+  }
+
+  H5Sclose(mspace);
+  if (data != NULL) free(data);
+  if (W != NULL) free_3d_array(W);
+
+  return;
+}
+
+#endif /* HDF5_OUTPUT */
@@ -35,7 +35,15 @@
  * adding calculation of desired quantities below.
  *
  * Alternatively, up to MAX_USR_H_COUNT new history variables can be added using
- * dump_history_enroll() in the problem generator.
+ * dump_history_enroll() in the problem generator, or dump_history_enroll_row()
+ * for a function that computes the variable along a row of cells at once.
+ *
+ * All variables, including the user-defined ones, are summed in a single
+ * pass over each Grid, an x1-row of cells at a time.  With MPI, the sums over
+ * the Grids in each Domain are reduced with a non-blocking MPI_Ireduce(), so
+ * the reduction overlaps the following steps.  It is completed, and the
+ * line written, by the next history dump with the same <outputN> block, or
+ * by dump_history_flush() at the end of the run.
  *
  * With SMR, data is averaged over each Domain separately, and dumped to
  * separate files with the level and domain number encoded in the filename.
@@ -63,11 +71,14 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - dump_history()        - Writes variables as formatted table
- * - dump_history_enroll() - Adds new user-defined history variables	      */
+ * - dump_history_enroll() - Adds new user-defined history variables
+ * - dump_history_enroll_row() - Same, computed along rows of cells
+ * - dump_history_flush()  - Writes history data still being reduced	      */
 /*============================================================================*/
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "defs.h"
 #include "athena.h"
 #include "globals.h"
@@ -85,8 +96,50 @@ static char *usr_label[MAX_USR_H_COUNT];
 /* Array of history dump function pointers for user added history columns. */
 static ConsFun_t phst_fun[MAX_USR_H_COUNT];
 
+/* Same for columns computed along rows of cells (NULL if phst_fun is used) */
+static ConsRowFun_t phst_row_fun[MAX_USR_H_COUNT];
+
 static int usr_hst_cnt = 0; /* User History Counter <= MAX_USR_H_COUNT */
 
+#ifdef MPI_PARALLEL
+/*! \struct HstPendS
+ *  \brief History data of one Domain being reduced with MPI_Ireduce() */
+typedef struct HstPend_s{
+  MeshS *pM;
+  OutputS *pOut;
+  int nl,nd;          /* level and domain */
+  int header;         /* 1 to write the column headers first */
+  int root;           /* 1 on the process that writes the history file */
+  MPI_Request req;
+  double scal[NSCAL + NSCALARS + MAX_USR_H_COUNT];
+  struct HstPend_s *next;
+}HstPendS;
+
+static HstPendS *pend_head = NULL;  /* pending reductions, oldest first */
+#endif /* MPI_PARALLEL */
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   hst_count() - total number of history variables
+ *   hst_grid()  - sums all history variables over a Grid
+ *   hst_row()   - sums the built-in variables over an x1-row of cells
+ *   hst_write() - writes the volume averages of one Domain to its file
+ *   hst_complete() - completes pending reductions, and writes their data
+ *============================================================================*/
+
+static int hst_count(void);
+static void hst_grid(GridS *pG, const int cnt, double *scal);
+#ifndef SPECIAL_RELATIVITY
+static void hst_row(const GridS *pG, const int j, const int k, const Real *w,
+                    double *scal);
+#endif
+static void hst_write(MeshS *pM, OutputS *pOut, const int nl, const int nd,
+                      double *scal, const int header);
+#ifdef MPI_PARALLEL
+static void hst_complete(const OutputS *pOut);
+#endif
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
 /*! \fn void dump_history(MeshS *pM, OutputS *pOut)
  *  \brief Function to write dumps of scalar "history" variables in a
@@ -95,26 +148,142 @@ static int usr_hst_cnt = 0; /* User History Counter <= MAX_USR_H_COUNT */
 void dump_history(MeshS *pM, OutputS *pOut)
 {
   GridS *pG;
-  DomainS *pD;
-  int i,j,k,is,ie,js,je,ks,ke,nl,nd;
-  double dVol, scal[NSCAL + NSCALARS + MAX_USR_H_COUNT], d1;
-  FILE *pfile;
-  char *fname,*plev=NULL,*pdom=NULL,*pdir=NULL,fmt[80];
-  char levstr[8],domstr[8],dirstr[20];
-  int n, total_hst_cnt, mhst, myID_Comm_Domain=1;
+  int nl,nd,total_hst_cnt;
+  double scal[NSCAL + NSCALARS + MAX_USR_H_COUNT];
 #ifdef MPI_PARALLEL
-  double my_scal[NSCAL + NSCALARS + MAX_USR_H_COUNT]; /* My Volume averages */
-  int ierr;
-#endif
-#ifdef CYLINDRICAL
-  Real x1,x2,x3;
+  DomainS *pD;
+  HstPendS *pp, **pnext;
+  int ierr, myID_Comm_Domain;
+
+/* Finish the reductions of the last dump with this block, so lines are
+ * written in order */
+
+  hst_complete(pOut);
 #endif
-#ifdef SPECIAL_RELATIVITY
-  PrimS W;
-  Real g, g2, g_2;
-  Real bx, by, bz, vB, b2, Bmag2;
+
+  total_hst_cnt = hst_count();
+
+/* store time and dt in first two elements of output vector */
+
+  scal[0] = pM->time;
+  scal[1] = pM->dt;
+
+/* Loop over all Domains in Mesh, and output Grid data */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+
+      if (pM->Domain[nl][nd].Grid != NULL){
+        pG = pM->Domain[nl][nd].Grid;
+
+        hst_grid(pG, total_hst_cnt, scal);
+
+#ifdef MPI_PARALLEL
+/* Start the sum over all Grids in Domain, to be completed later.  Only the
+ * parent (rank=0) process computes the average and writes output. */
+
+        pD = (DomainS*)&(pM->Domain[nl][nd]);
+        if ((pp = (HstPendS*)malloc(sizeof(HstPendS))) == NULL)
+          ath_error("[dump_history]: malloc failed for pending history\n");
+        pp->pM = pM;
+        pp->pOut = pOut;
+        pp->nl = nl;
+        pp->nd = nd;
+        pp->header = (pOut->num == 0);
+        pp->next = NULL;
+        memcpy(pp->scal, scal, total_hst_cnt*sizeof(double));
+
+        ierr = MPI_Comm_rank(pD->Comm_Domain, &myID_Comm_Domain);
+        pp->root = (myID_Comm_Domain == 0);
+        if (myID_Comm_Domain == 0)
+          ierr = MPI_Ireduce(MPI_IN_PLACE, &(pp->scal[2]), (total_hst_cnt - 2),
+            MPI_DOUBLE, MPI_SUM, 0, pD->Comm_Domain, &(pp->req));
+        else
+          ierr = MPI_Ireduce(&(pp->scal[2]), NULL, (total_hst_cnt - 2),
+            MPI_DOUBLE, MPI_SUM, 0, pD->Comm_Domain, &(pp->req));
+
+        for (pnext = &pend_head; *pnext != NULL; pnext = &((*pnext)->next));
+        *pnext = pp;
+#else
+        hst_write(pM, pOut, nl, nd, scal, (pOut->num == 0));
+#endif /* MPI_PARALLEL */
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_history_enroll(const ConsFun_t pfun, const char *label)
+ *  \brief Adds new user-defined history variables	      */
+
+void dump_history_enroll(const ConsFun_t pfun, const char *label){
+
+  if(usr_hst_cnt >= MAX_USR_H_COUNT)
+    ath_error("[dump_history_enroll]: MAX_USR_H_COUNT = %d exceeded\n",
+	      MAX_USR_H_COUNT);
+
+/* Copy the label string */
+  if((usr_label[usr_hst_cnt] = ath_strdup(label)) == NULL)
+    ath_error("[dump_history_enroll]: Error on sim_strdup(\"%s\")\n",label);
+
+/* Store the function pointer */
+  phst_fun[usr_hst_cnt] = pfun;
+  phst_row_fun[usr_hst_cnt] = NULL;
+
+  usr_hst_cnt++;
+
+  return;
+
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_history_enroll_row(const ConsRowFun_t pfun,
+ *                                   const char *label)
+ *  \brief Adds a new user-defined history variable computed by pfun along an
+ *   x1-row of cells at a time, with no function call per cell */
+
+void dump_history_enroll_row(const ConsRowFun_t pfun, const char *label){
+
+  if(usr_hst_cnt >= MAX_USR_H_COUNT)
+    ath_error("[dump_history_enroll_row]: MAX_USR_H_COUNT = %d exceeded\n",
+	      MAX_USR_H_COUNT);
+
+  if((usr_label[usr_hst_cnt] = ath_strdup(label)) == NULL)
+    ath_error("[dump_history_enroll_row]: Error on sim_strdup(\"%s\")\n",label);
+
+  phst_fun[usr_hst_cnt] = NULL;
+  phst_row_fun[usr_hst_cnt] = pfun;
+
+  usr_hst_cnt++;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_history_flush(void)
+ *  \brief Completes the reductions of all history dumps still pending, and
+ *   writes them.  Called by data_output_destruct() at the end of the run. */
+
+void dump_history_flush(void)
+{
+#ifdef MPI_PARALLEL
+  hst_complete(NULL);
 #endif
+  return;
+}
 
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static int hst_count(void)
+ *  \brief Returns the total number of history variables, including time and
+ *   dt */
+
+static int hst_count(void)
+{
+  int total_hst_cnt;
 
   total_hst_cnt = 9 + NSCALARS + usr_hst_cnt;
 #ifdef ADIABATIC
@@ -136,362 +305,451 @@ void dump_history(MeshS *pM, OutputS *pOut)
 #endif
 #endif
 
+  return total_hst_cnt;
+}
 
-/* Add a white space to the format */
-  if(pOut->dat_fmt == NULL){
-    sprintf(fmt," %%14.6e"); /* Use a default format */
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hst_grid(GridS *pG, const int cnt, double *scal)
+ *  \brief Sets scal[2..cnt-1] to the volume integrals of the history
+ *   variables over the Grid, in one pass over its x1-rows */
+
+static void hst_grid(GridS *pG, const int cnt, double *scal)
+{
+  Real *w, *row;
+  double dVol, s;
+  int i,j,k,n,is,ie,js,je,ks,ke,mhst;
+#ifdef CYLINDRICAL
+  Real x1,x2,x3;
+#endif
+#ifdef SPECIAL_RELATIVITY
+  PrimS W;
+  ConsS Ucell;
+  Real g, g2, g_2;
+  Real bx, by, bz, vB, b2, Bmag2;
+#endif
+
+  is = pG->is, ie = pG->ie;
+  js = pG->js, je = pG->je;
+  ks = pG->ks, ke = pG->ke;
+
+  for (i=2; i<cnt; i++) {
+    scal[i] = 0.0;
   }
-  else{
-    sprintf(fmt," %s",pOut->dat_fmt);
+
+/* Volume of the cells, as a constant times a weight w[i] in each cell of a
+ * row (the radius with cylindrical coordinates, 1 otherwise) */
+
+  dVol = 1.0;
+  if (pG->dx1 > 0.0) dVol *= pG->dx1;
+  if (pG->dx2 > 0.0) dVol *= pG->dx2;
+  if (pG->dx3 > 0.0) dVol *= pG->dx3;
+
+  w = (Real*)calloc_1d_array(ie-is+1, sizeof(Real));
+  row = (Real*)calloc_1d_array(ie-is+1, sizeof(Real));
+  if (w == NULL || row == NULL)
+    ath_error("[dump_history]: malloc failed for rows\n");
+  for (i=is; i<=ie; i++) {
+#ifdef CYLINDRICAL
+    cc_pos(pG,i,js,ks,&x1,&x2,&x3);
+    w[i-is] = x1;
+#else
+    w[i-is] = 1.0;
+#endif
   }
 
-/* store time and dt in first two elements of output vector */
+/* Compute history variables */
 
-  scal[0] = pM->time;
-  scal[1] = pM->dt;
+  for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+#ifndef SPECIAL_RELATIVITY
+      hst_row(pG, j, k, w, scal);
+#else /* SPECIAL_RELATIVITY */
+      for (i=is; i<=ie; i++) {
+        Ucell = GET_GRID_U(pG,k,j,i);
+        W = Cons_to_Prim (&Ucell);
+
+        /* calculate gamma */
+        g   = GRID_U(pG,k,j,i,d)/W.d;
+        g2  = SQR(g);
+        g_2 = 1.0/g2;
+
+        mhst = 2;
+        scal[mhst] += GRID_U(pG,k,j,i,d);
+        mhst++;
+        scal[mhst] += GRID_U(pG,k,j,i,E);
+        mhst++;
+        scal[mhst] += GRID_U(pG,k,j,i,M1);
+        mhst++;
+        scal[mhst] += GRID_U(pG,k,j,i,M2);
+        mhst++;
+        scal[mhst] += GRID_U(pG,k,j,i,M3);
+
+        mhst++;
+        scal[mhst] += SQR(g);
+        mhst++;
+        scal[mhst] += SQR(g*W.V1);
+        mhst++;
+        scal[mhst] += SQR(g*W.V2);
+        mhst++;
+        scal[mhst] += SQR(g*W.V3);
+
+        mhst++;
+        scal[mhst] += W.P;
 
-/* Loop over all Domains in Mesh, and output Grid data */
+#ifdef MHD
 
-  for (nl=0; nl<(pM->NLevels); nl++){
+        vB = W.V1*GRID_U(pG,k,j,i,B1c) + W.V2*W.B2c + W.V3*W.B3c;
+        Bmag2 = SQR(GRID_U(pG,k,j,i,B1c)) + SQR(W.B2c) + SQR(W.B3c);
 
-    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        bx = g*(GRID_U(pG,k,j,i,B1c)*g_2 + vB*W.V1);
+        by = g*(W.B2c*g_2 + vB*W.V2);
+        bz = g*(W.B3c*g_2 + vB*W.V3);
 
-      if (pM->Domain[nl][nd].Grid != NULL){
-        pG = pM->Domain[nl][nd].Grid;
-        pD = (DomainS*)&(pM->Domain[nl][nd]);
-        is = pG->is, ie = pG->ie;
-        js = pG->js, je = pG->je;
-        ks = pG->ks, ke = pG->ke;
+        b2 = Bmag2*g_2 + vB*vB;
+
+        mhst++;
+        scal[mhst] += (g*vB*g*vB);
+        mhst++;
+        scal[mhst] += bx*bx;
+        mhst++;
+        scal[mhst] += by*by;
+        mhst++;
+        scal[mhst] += bz*bz;
+        mhst++;
+        scal[mhst] += b2;
+        mhst++;
+        scal[mhst] += (Bmag2*(1.0 - 0.5*g_2) - SQR(vB) / 2.0);
 
-        for (i=2; i<total_hst_cnt; i++) {
-          scal[i] = 0.0;
+#endif /* MHD */
+      }
+#endif  /* SPECIAL_RELATIVITY */
+
+/* Calculate the user defined history variables, a row at a time */
+      mhst = cnt - usr_hst_cnt;
+      for(n=0; n<usr_hst_cnt; n++, mhst++){
+        if (phst_row_fun[n] != NULL) {
+          (*phst_row_fun[n])(pG, is, ie, j, k, row);
+        } else {
+          for (i=is; i<=ie; i++) row[i-is] = (*phst_fun[n])(pG, i, j, k);
         }
- 
-/* Compute history variables */
+        s = 0.0;
+        for (i=0; i<=ie-is; i++) s += w[i]*row[i];
+        scal[mhst] += s;
+      }
+    }
+  }
+
+  for (i=2; i<cnt; i++) {
+    scal[i] *= dVol;
+  }
+
+  free_1d_array(row);
+  free_1d_array(w);
+  return;
+}
 
-        for (k=ks; k<=ke; k++) {
-          for (j=js; j<=je; j++) {
-            for (i=is; i<=ie; i++) {
-              dVol = 1.0; 
-              if (pG->dx1 > 0.0) dVol *= pG->dx1;
-              if (pG->dx2 > 0.0) dVol *= pG->dx2;
-              if (pG->dx3 > 0.0) dVol *= pG->dx3;
 #ifndef SPECIAL_RELATIVITY
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hst_row(const GridS *pG, const int j, const int k,
+ *                          const Real *w, double *scal)
+ *  \brief Adds the sums of the built-in history variables over the x1-row
+ *   (j,k), weighted by w[i-is], to scal[2...].  Each sum is kept in a local
+ *   variable over the row, so the loop has no indirection. */
+
+static void hst_row(const GridS *pG, const int j, const int k, const Real *w,
+                    double *scal)
+{
+  int i, mhst, is = pG->is, ie = pG->ie;
+  double wi, d1;
+  double sd=0.0, sM1=0.0, sM2=0.0, sM3=0.0, sK1=0.0, sK2=0.0, sK3=0.0;
+#ifndef BAROTROPIC
+  double sE=0.0;
+#endif
+#ifdef MHD
+  double sB1=0.0, sB2=0.0, sB3=0.0;
+#endif
+#ifdef SELF_GRAVITY
+  double sPhi=0.0;
+#endif
+#if (NSCALARS > 0)
+  double ss[NSCALARS];
+  int n;
+#endif
 #ifdef CYLINDRICAL
-              cc_pos(pG,i,j,k,&x1,&x2,&x3);
-              dVol *= x1;
+  double sL=0.0;
 #endif
 
-              mhst = 2;
-              scal[mhst] += dVol*pG->U[k][j][i].d;
-              d1 = 1.0/pG->U[k][j][i].d;
+#if (NSCALARS > 0)
+  for (n=0; n<NSCALARS; n++) ss[n] = 0.0;
+#endif
+
+  for (i=is; i<=ie; i++) {
+    wi = w[i-is];
+    d1 = 1.0/GRID_U(pG,k,j,i,d);
+    sd  += wi*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].E;
-#endif
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M1;
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M2;
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M3;
-              mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].M1)*d1;
-              mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].M2)*d1;
-              mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].M3)*d1;
+    sE  += wi*GRID_U(pG,k,j,i,E);
+#endif
+    sM1 += wi*GRID_U(pG,k,j,i,M1);
+    sM2 += wi*GRID_U(pG,k,j,i,M2);
+    sM3 += wi*GRID_U(pG,k,j,i,M3);
+    sK1 += wi*0.5*SQR(GRID_U(pG,k,j,i,M1))*d1;
+    sK2 += wi*0.5*SQR(GRID_U(pG,k,j,i,M2))*d1;
+    sK3 += wi*0.5*SQR(GRID_U(pG,k,j,i,M3))*d1;
 #ifdef MHD
-              mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].B1c);
-              mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].B2c);
-              mhst++;
-              scal[mhst] += dVol*0.5*SQR(pG->U[k][j][i].B3c);
+    sB1 += wi*0.5*SQR(GRID_U(pG,k,j,i,B1c));
+    sB2 += wi*0.5*SQR(GRID_U(pG,k,j,i,B2c));
+    sB3 += wi*0.5*SQR(GRID_U(pG,k,j,i,B3c));
 #endif
 #ifdef SELF_GRAVITY
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].d*pG->Phi[k][j][i];
+    sPhi += wi*GRID_U(pG,k,j,i,d)*pG->Phi[k][j][i];
 #endif
 #if (NSCALARS > 0)
-              for(n=0; n<NSCALARS; n++){
-                mhst++;
-                scal[mhst] += dVol*pG->U[k][j][i].s[n];
-              }
+    for (n=0; n<NSCALARS; n++)
+      ss[n] += wi*GRID_U(pG,k,j,i,s[n]);
 #endif
-
 #ifdef CYLINDRICAL
-              mhst++;
-              scal[mhst] += dVol*(x1*pG->U[k][j][i].M2);
+    sL += wi*(wi*GRID_U(pG,k,j,i,M2));
 #endif
+  }
 
-#else /* SPECIAL_RELATIVITY */
-
-              W = Cons_to_Prim (&(pG->U[k][j][i]));
-        
-              /* calculate gamma */
-              g   = pG->U[k][j][i].d/W.d;
-              g2  = SQR(g);
-              g_2 = 1.0/g2;
-
-              mhst = 2;
-              scal[mhst] += dVol*pG->U[k][j][i].d;
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].E;
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M1;
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M2;
-              mhst++;
-              scal[mhst] += dVol*pG->U[k][j][i].M3;
-
-              mhst++;
-              scal[mhst] += dVol*SQR(g);
-              mhst++;
-              scal[mhst] += dVol*SQR(g*W.V1);
-              mhst++;
-              scal[mhst] += dVol*SQR(g*W.V2);
-              mhst++;
-              scal[mhst] += dVol*SQR(g*W.V3);
-
-	      mhst++;
-	      scal[mhst] += dVol*W.P;
-
+  mhst = 2;
+  scal[mhst++] += sd;
+#ifndef BAROTROPIC
+  scal[mhst++] += sE;
+#endif
+  scal[mhst++] += sM1;
+  scal[mhst++] += sM2;
+  scal[mhst++] += sM3;
+  scal[mhst++] += sK1;
+  scal[mhst++] += sK2;
+  scal[mhst++] += sK3;
 #ifdef MHD
+  scal[mhst++] += sB1;
+  scal[mhst++] += sB2;
+  scal[mhst++] += sB3;
+#endif
+#ifdef SELF_GRAVITY
+  scal[mhst++] += sPhi;
+#endif
+#if (NSCALARS > 0)
+  for (n=0; n<NSCALARS; n++) scal[mhst++] += ss[n];
+#endif
+#ifdef CYLINDRICAL
+  scal[mhst++] += sL;
+#endif
 
-              vB = W.V1*pG->U[k][j][i].B1c + W.V2*W.B2c + W.V3*W.B3c;
-              Bmag2 = SQR(pG->U[k][j][i].B1c) + SQR(W.B2c) + SQR(W.B3c);
-        
-              bx = g*(pG->U[k][j][i].B1c*g_2 + vB*W.V1);
-              by = g*(W.B2c*g_2 + vB*W.V2);
-              bz = g*(W.B3c*g_2 + vB*W.V3);
-        
-              b2 = Bmag2*g_2 + vB*vB;
-
-              mhst++;
-              scal[mhst] += dVol*(g*vB*g*vB);
-              mhst++;
-              scal[mhst] += dVol*bx*bx;
-              mhst++;
-              scal[mhst] += dVol*by*by;
-              mhst++;
-              scal[mhst] += dVol*bz*bz;
-              mhst++;
-              scal[mhst] += dVol*b2;
-              mhst++;
-              scal[mhst] += dVol*(Bmag2*(1.0 - 0.5*g_2) - SQR(vB) / 2.0);
-
-#endif /* MHD */
-
-#endif  /* SPECIAL_RELATIVITY */
-
-/* Calculate the user defined history variables */
-              for(n=0; n<usr_hst_cnt; n++){
-                mhst++;
-                scal[mhst] += dVol*(*phst_fun[n])(pG, i, j, k);
-              }
-            }
-          }
-        }
-
-/* Compute the sum over all Grids in Domain */
+  return;
+}
+#endif /* SPECIAL_RELATIVITY */
 
-#ifdef MPI_PARALLEL 
-        for(i=2; i<total_hst_cnt; i++){
-          my_scal[i] = scal[i];
-        }
-        ierr = MPI_Reduce(&(my_scal[2]), &(scal[2]), (total_hst_cnt - 2),
-          MPI_DOUBLE, MPI_SUM, 0, pD->Comm_Domain);
-#endif
+/*----------------------------------------------------------------------------*/
+/*! \fn static void hst_write(MeshS *pM, OutputS *pOut, const int nl,
+ *                            const int nd, double *scal, const int header)
+ *  \brief Divides the sums in scal over Domain nd on level nl by its volume,
+ *   and appends them to its history file, after the column headers if
+ *   header = 1 */
+
+static void hst_write(MeshS *pM, OutputS *pOut, const int nl, const int nd,
+                      double *scal, const int header)
+{
+  DomainS *pD = (DomainS*)&(pM->Domain[nl][nd]);
+  double dVol;
+  FILE *pfile;
+  char *fname,*plev=NULL,*pdom=NULL,*pdir=NULL,fmt[80];
+  char levstr[8],domstr[8],dirstr[20];
+  int i, n, total_hst_cnt, mhst;
 
-/* Only the parent (rank=0) process computes the average and writes output.
- * For single-processor jobs, myID_Comm_world is always zero. */
+  total_hst_cnt = hst_count();
 
-#ifdef MPI_PARALLEL
-        ierr = MPI_Comm_rank(pD->Comm_Domain, &myID_Comm_Domain);
-#endif
-        if((myID_Comm_Domain==0) || (myID_Comm_world==0)){  /* I'm the parent */
+/* Add a white space to the format */
+  if(pOut->dat_fmt == NULL){
+    sprintf(fmt," %%14.6e"); /* Use a default format */
+  }
+  else{
+    sprintf(fmt," %s",pOut->dat_fmt);
+  }
 
 /* Compute volume averages */
 
-          dVol = pD->MaxX[0] - pD->MinX[0];
+  dVol = pD->MaxX[0] - pD->MinX[0];
 #ifdef CYLINDRICAL
-          dVol = 0.5*(SQR(pD->MaxX[0]) - SQR(pD->MinX[0]));
+  dVol = 0.5*(SQR(pD->MaxX[0]) - SQR(pD->MinX[0]));
 #endif
-          if (pD->Nx[1] > 1) dVol *= (pD->MaxX[1] - pD->MinX[1]);
-          if (pD->Nx[2] > 1) dVol *= (pD->MaxX[2] - pD->MinX[2]);
-          for(i=2; i<total_hst_cnt; i++){
-            scal[i] /= dVol;
-          }
+  if (pD->Nx[1] > 1) dVol *= (pD->MaxX[1] - pD->MinX[1]);
+  if (pD->Nx[2] > 1) dVol *= (pD->MaxX[2] - pD->MinX[2]);
+  for(i=2; i<total_hst_cnt; i++){
+    scal[i] /= dVol;
+  }
 
 /* Create filename and open file.  History files are always written in lev#
  * directories of root process (rank=0 in MPI_COMM_WORLD) */
 #ifdef MPI_PARALLEL
-          if (nl>0) {
-            plev = &levstr[0];
-            sprintf(plev,"lev%d",nl);
-            pdir = &dirstr[0];
-            sprintf(pdir,"../id0/lev%d",nl);
-          }
+  if (nl>0) {
+    plev = &levstr[0];
+    sprintf(plev,"lev%d",nl);
+    pdir = &dirstr[0];
+    sprintf(pdir,"../id0/lev%d",nl);
+  }
 #else
-          if (nl>0) {
-            plev = &levstr[0];
-            sprintf(plev,"lev%d",nl);
-            pdir = &dirstr[0];
-            sprintf(pdir,"lev%d",nl);
-          }
-#endif
-
-          if (nd>0) {
-            pdom = &domstr[0];
-            sprintf(pdom,"dom%d",nd);
-          }
-
-          fname = ath_fname(pdir,pM->outfilename,plev,pdom,0,0,NULL,"hst");
-          if(fname == NULL){
-            ath_perr(-1,"[dump_history]: Unable to create history filename\n");
-          }
-          pfile = fopen(fname,"a");
-          if(pfile == NULL){
-            ath_perr(-1,"[dump_history]: Unable to open the history file\n");
-          }
-          free(fname);
+  if (nl>0) {
+    plev = &levstr[0];
+    sprintf(plev,"lev%d",nl);
+    pdir = &dirstr[0];
+    sprintf(pdir,"lev%d",nl);
+  }
+#endif
+
+  if (nd>0) {
+    pdom = &domstr[0];
+    sprintf(pdom,"dom%d",nd);
+  }
+
+  fname = ath_fname(pdir,pM->outfilename,plev,pdom,0,0,NULL,"hst");
+  if(fname == NULL){
+    ath_perr(-1,"[dump_history]: Unable to create history filename\n");
+  }
+  pfile = fopen(fname,"a");
+  if(pfile == NULL){
+    ath_perr(-1,"[dump_history]: Unable to open the history file\n");
+  }
+  free(fname);
 
 /* Write out column headers, but only for first dump */
 
-          mhst = 0;
-          if(pOut->num == 0){
-            fprintf(pfile,
+  mhst = 0;
+  if(header){
+    fprintf(pfile,
          "# Athena history dump for level=%i domain=%i volume=%e\n",nl,nd,dVol);
-            mhst++;
-            fprintf(pfile,"#   [%i]=time   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=dt      ",mhst);
+    mhst++;
+    fprintf(pfile,"#   [%i]=time   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=dt      ",mhst);
 #ifndef SPECIAL_RELATIVITY
-            mhst++;
-            fprintf(pfile,"   [%i]=mass    ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=mass    ",mhst);
 #ifdef ADIABATIC
-            mhst++;
-            fprintf(pfile,"   [%i]=total E ",mhst);
-#endif
-            mhst++;
-            fprintf(pfile,"   [%i]=x1 Mom. ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x2 Mom. ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x3 Mom. ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x1-KE   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x2-KE   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x3-KE   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=total E ",mhst);
+#endif
+    mhst++;
+    fprintf(pfile,"   [%i]=x1 Mom. ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x2 Mom. ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x3 Mom. ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x1-KE   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x2-KE   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x3-KE   ",mhst);
 #ifdef MHD
-            mhst++;
-            fprintf(pfile,"   [%i]=x1-ME   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x2-ME   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x3-ME   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x1-ME   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x2-ME   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x3-ME   ",mhst);
 #endif
 #ifdef SELF_GRAVITY
-            mhst++;
-            fprintf(pfile,"   [%i]=grav PE ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=grav PE ",mhst);
 #endif
 #if (NSCALARS > 0)
-            for(n=0; n<NSCALARS; n++){
-              mhst++;
-              fprintf(pfile,"  [%i]=scalar %i",mhst,n);
-            }
+    for(n=0; n<NSCALARS; n++){
+      mhst++;
+      fprintf(pfile,"  [%i]=scalar %i",mhst,n);
+    }
 #endif
 
 #ifdef CYLINDRICAL
-            mhst++;
-            fprintf(pfile,"   [%i]=Ang.Mom.",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=Ang.Mom.",mhst);
 #endif
 
 #else /* SPECIAL_RELATIVITY */
-            mhst++;
-            fprintf(pfile,"   [%i]=mass    ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=total E ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x1 Mom. ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x2 Mom. ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x3 Mom." ,mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=Gamma   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x1-KE   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x2-KE   ",mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x3-KE  " ,mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=Press  " ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=mass    ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=total E ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x1 Mom. ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x2 Mom. ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x3 Mom." ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=Gamma   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x1-KE   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x2-KE   ",mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x3-KE  " ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=Press  " ,mhst);
 #ifdef MHD
-            mhst++;
-            fprintf(pfile,"   [%i]=x0-ME  " ,mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x1-ME  " ,mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x2-ME  " ,mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=x3-ME  " ,mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=bsq    " ,mhst);
-            mhst++;
-            fprintf(pfile,"   [%i]=T^00_EM" ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x0-ME  " ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x1-ME  " ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x2-ME  " ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=x3-ME  " ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=bsq    " ,mhst);
+    mhst++;
+    fprintf(pfile,"   [%i]=T^00_EM" ,mhst);
 #endif
 #endif /* SPECIAL_RELATIVITY */
 
-            for(n=0; n<usr_hst_cnt; n++){
-              mhst++;
-              fprintf(pfile,"  [%i]=%s",mhst,usr_label[n]);
-            }
-            fprintf(pfile,"\n#\n");
-          }
+    for(n=0; n<usr_hst_cnt; n++){
+      mhst++;
+      fprintf(pfile,"  [%i]=%s",mhst,usr_label[n]);
+    }
+    fprintf(pfile,"\n#\n");
+  }
 
 /* Write out data, and close file */
 
-          for (i=0; i<total_hst_cnt; i++) {
-            fprintf(pfile,fmt,scal[i]);
-          }
-          fprintf(pfile,"\n");
-          fclose(pfile);
-  
-        }
-      }
-    }
+  for (i=0; i<total_hst_cnt; i++) {
+    fprintf(pfile,fmt,scal[i]);
   }
+  fprintf(pfile,"\n");
+  fclose(pfile);
 
   return;
 }
 
+#ifdef MPI_PARALLEL
 /*----------------------------------------------------------------------------*/
-/*! \fn void dump_history_enroll(const ConsFun_t pfun, const char *label)
- *  \brief Adds new user-defined history variables	      */
-
-void dump_history_enroll(const ConsFun_t pfun, const char *label){
-
-  if(usr_hst_cnt >= MAX_USR_H_COUNT)
-    ath_error("[dump_history_enroll]: MAX_USR_H_COUNT = %d exceeded\n",
-	      MAX_USR_H_COUNT);
-
-/* Copy the label string */
-  if((usr_label[usr_hst_cnt] = ath_strdup(label)) == NULL)
-    ath_error("[dump_history_enroll]: Error on sim_strdup(\"%s\")\n",label);
+/*! \fn static void hst_complete(const OutputS *pOut)
+ *  \brief Waits for the pending reductions of history dumps made with pOut
+ *   (or of all dumps if pOut is NULL), writes their data, and frees them */
 
-/* Store the function pointer */
-  phst_fun[usr_hst_cnt] = pfun;
+static void hst_complete(const OutputS *pOut)
+{
+  HstPendS *pp, **pprev;
+  int ierr;
 
-  usr_hst_cnt++;
+  pprev = &pend_head;
+  while ((pp = *pprev) != NULL) {
+    if (pOut != NULL && pp->pOut != pOut) {
+      pprev = &(pp->next);
+      continue;
+    }
+    ierr = MPI_Wait(&(pp->req), MPI_STATUS_IGNORE);
+    if (pp->root)
+      hst_write(pp->pM, pp->pOut, pp->nl, pp->nd, pp->scal, pp->header);
+    *pprev = pp->next;
+    free(pp);
+  }
 
   return;
-
 }
+#endif /* MPI_PARALLEL */
 
 #undef NSCAL
 #undef MAX_USR_H_COUNT
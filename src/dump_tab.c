@@ -231,19 +231,19 @@ void dump_tab_cons(MeshS *pM, OutputS *pOut)
 
 /* Dump all variables */
 
-              fprintf(pfile,fmt,pG->U[k][j][i].d);
-              fprintf(pfile,fmt,pG->U[k][j][i].M1);
-              fprintf(pfile,fmt,pG->U[k][j][i].M2);
-              fprintf(pfile,fmt,pG->U[k][j][i].M3);
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,d));
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,M1));
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,M2));
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,M3));
 
 #ifndef BAROTROPIC
-              fprintf(pfile,fmt,pG->U[k][j][i].E);
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,E));
 #endif /* BAROTROPIC */
 
 #ifdef MHD
-              fprintf(pfile,fmt,pG->U[k][j][i].B1c);
-              fprintf(pfile,fmt,pG->U[k][j][i].B2c);
-              fprintf(pfile,fmt,pG->U[k][j][i].B3c);
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,B1c));
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,B2c));
+              fprintf(pfile,fmt,GRID_U(pG,k,j,i,B3c));
 #endif
 
 #ifdef SELF_GRAVITY
@@ -260,7 +260,7 @@ void dump_tab_cons(MeshS *pM, OutputS *pOut)
 #endif
 
 #if (NSCALARS > 0)
-              for (n=0; n<NSCALARS; n++) fprintf(pfile,fmt,pG->U[k][j][i].s[n]);
+              for (n=0; n<NSCALARS; n++) fprintf(pfile,fmt,GRID_U(pG,k,j,i,s[n]));
 #endif
 
       	      fprintf(pfile,"\n");
@@ -288,6 +288,7 @@ void dump_tab_prim(MeshS *pM, OutputS *pOut)
   char *fname,*plev=NULL,*pdom=NULL;
   char levstr[8],domstr[8];
   PrimS W;
+  ConsS Ucell;
   Real x1,x2,x3;
   char zone_fmt[20], fmt[80];
   int col_cnt, nmax;
@@ -470,7 +471,8 @@ void dump_tab_prim(MeshS *pM, OutputS *pOut)
           for(j=jl; j<=ju; j++){
             for(i=il; i<=iu; i++){
               cc_pos(pG,i,j,k,&x1,&x2,&x3);
-              W = Cons_to_Prim(&(pG->U[k][j][i])); 
+              Ucell = GET_GRID_U(pG,k,j,i);
+              W = Cons_to_Prim(&Ucell); 
 
               if (pG->Nx[0] > 1) fprintf(pfile,zone_fmt,i);
               if (pG->Nx[1] > 1) fprintf(pfile,zone_fmt,j);
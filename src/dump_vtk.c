@@ -6,6 +6,10 @@
  * PURPOSE: Function to write a dump in VTK "legacy" format.  With SMR,
  *   dumps are made for all levels and domains, unless nlevel and ndomain are
  *   specified in <output> block.  Works for BOTH conserved and primitives.
+ *   With compress = lossless or lossy in the <output> block, the binary data
+ *   is compressed (see compress.c) and the files are named *.vtkz.
+ *   With single_file = 1 in an MPI job, all processes write one file for each
+ *   Domain with MPI-IO (see shared_file.c), which needs no joining.
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - dump_vtk() - writes VTK dump (all variables).			      */
@@ -21,6 +25,18 @@
 #include "particles/particle.h"
 #endif
 
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   dump_vtk_shared() - writes VTK dump of one Domain to a shared file
+ *   put_vtk_var()     - writes one variable to a shared file
+ *============================================================================*/
+
+#ifdef MPI_PARALLEL
+static void dump_vtk_shared(MeshS *pM, OutputS *pOut, int nl, int nd);
+static void put_vtk_var(SFileS *sf, float *data, const int ncomp);
+#endif
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
 /*! \fn void dump_vtk(MeshS *pM, OutputS *pOut)
  *  \brief Writes VTK dump (all variables).				      */
@@ -29,7 +45,9 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 {
   GridS *pGrid;
   PrimS ***W;
+  ConsS Ucell;
   FILE *pfile;
+  ZFileS *zf;
   char *fname,*plev=NULL,*pdom=NULL;
   char levstr[8],domstr[8];
 /* Upper and Lower bounds on i,j,k for data dump */
@@ -53,6 +71,13 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
           (pOut->ndomain == -1 || pOut->ndomain == nd)){
         pGrid = pM->Domain[nl][nd].Grid;
 
+#ifdef MPI_PARALLEL
+        if (pOut->single_file) {
+          dump_vtk_shared(pM,pOut,nl,nd);
+          continue;
+        }
+#endif
+
         il = pGrid->is, iu = pGrid->ie;
         jl = pGrid->js, ju = pGrid->je;
         kl = pGrid->ks, ku = pGrid->ke;
@@ -85,7 +110,8 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
           for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
           for (i=il; i<=iu; i++) {
-            W[k-kl][j-jl][i-il] = Cons_to_Prim(&(pGrid->U[k][j][i]));
+            Ucell = GET_GRID_U(pGrid,k,j,i);
+            W[k-kl][j-jl][i-il] = Cons_to_Prim(&Ucell);
           }}}
         }
 
@@ -99,7 +125,7 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
           sprintf(pdom,"dom%d",nd);
         }
         if((fname = ath_fname(plev,pM->outfilename,plev,pdom,num_digit,
-            pOut->num,NULL,"vtk")) == NULL){
+            pOut->num,NULL,(pOut->compress ? "vtkz" : "vtk"))) == NULL){
           ath_error("[dump_vtk]: Error constructing filename\n");
         }
 
@@ -108,6 +134,7 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
           return;
         }
         free(fname);
+        zf = ath_zopen(pfile,pOut);
 
 /* Allocate memory for temporary array of floats */
 
@@ -119,21 +146,21 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 /* There are five basic parts to the VTK "legacy" file format.  */
 /*  1. Write file version and identifier */
 
-        fprintf(pfile,"# vtk DataFile Version 2.0\n");
+        ath_zprintf(zf,"# vtk DataFile Version 2.0\n");
 
 /*  2. Header */
 
         if (strcmp(pOut->out,"cons") == 0){
-          fprintf(pfile,"CONSERVED vars at time= %e, level= %i, domain= %i\n",
+          ath_zprintf(zf,"CONSERVED vars at time= %e, level= %i, domain= %i\n",
             pGrid->time,nl,nd);
         } else if(strcmp(pOut->out,"prim") == 0) {
-          fprintf(pfile,"PRIMITIVE vars at time= %e, level= %i, domain= %i\n",
+          ath_zprintf(zf,"PRIMITIVE vars at time= %e, level= %i, domain= %i\n",
             pGrid->time,nl,nd);
         }
 
 /*  3. File format */
 
-        fprintf(pfile,"BINARY\n");
+        ath_zprintf(zf,"BINARY\n");
 
 /*  4. Dataset structure */
 
@@ -141,63 +168,65 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 
         fc_pos(pGrid, il, jl, kl, &x1, &x2, &x3);;
 
-        fprintf(pfile,"DATASET STRUCTURED_POINTS\n");
+        ath_zprintf(zf,"DATASET STRUCTURED_POINTS\n");
         if (pGrid->Nx[1] == 1) {
-          fprintf(pfile,"DIMENSIONS %d %d %d\n",iu-il+2,1,1);
+          ath_zprintf(zf,"DIMENSIONS %d %d %d\n",iu-il+2,1,1);
         } else {
           if (pGrid->Nx[2] == 1) {
-            fprintf(pfile,"DIMENSIONS %d %d %d\n",iu-il+2,ju-jl+2,1);
+            ath_zprintf(zf,"DIMENSIONS %d %d %d\n",iu-il+2,ju-jl+2,1);
           } else {
-            fprintf(pfile,"DIMENSIONS %d %d %d\n",iu-il+2,ju-jl+2,ku-kl+2);
+            ath_zprintf(zf,"DIMENSIONS %d %d %d\n",iu-il+2,ju-jl+2,ku-kl+2);
           }
         }
-        fprintf(pfile,"ORIGIN %e %e %e \n",x1,x2,x3);
-        fprintf(pfile,"SPACING %e %e %e \n",pGrid->dx1,pGrid->dx2,pGrid->dx3);
+        ath_zprintf(zf,"ORIGIN %e %e %e \n",x1,x2,x3);
+        ath_zprintf(zf,"SPACING %e %e %e \n",pGrid->dx1,pGrid->dx2,pGrid->dx3);
 
 /*  5. Data  */
 
-        fprintf(pfile,"CELL_DATA %d \n", (iu-il+1)*(ju-jl+1)*(ku-kl+1));
+        ath_zprintf(zf,"CELL_DATA %d \n", (iu-il+1)*(ju-jl+1)*(ku-kl+1));
 
 /* Write density */
 
-        fprintf(pfile,"SCALARS density float\n");
-        fprintf(pfile,"LOOKUP_TABLE default\n");
+        ath_zprintf(zf,"SCALARS density float\n");
+        ath_zprintf(zf,"LOOKUP_TABLE default\n");
         for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
             for (i=il; i<=iu; i++) {
               if (strcmp(pOut->out,"cons") == 0){
-                data[i-il] = (float)pGrid->U[k][j][i].d;
+                data[i-il] = (float)GRID_U(pGrid,k,j,i,d);
               } else if(strcmp(pOut->out,"prim") == 0) {
                 data[i-il] = (float)W[k-kl][j-jl][i-il].d;
               }
             }
+            ath_zlossy(zf,data,sizeof(float),iu-il+1);
             if(!big_end) ath_bswap(data,sizeof(float),iu-il+1);
-            fwrite(data,sizeof(float),(size_t)ndata0,pfile);
+            ath_zwrite(data,sizeof(float),(size_t)ndata0,zf);
           }
         }
 
 /* Write momentum or velocity */
 
         if (strcmp(pOut->out,"cons") == 0){
-          fprintf(pfile,"\nVECTORS momentum float\n");
+          ath_zprintf(zf,"\nVECTORS momentum float\n");
         } else if(strcmp(pOut->out,"prim") == 0) {
-          fprintf(pfile,"\nVECTORS velocity float\n");
+          ath_zprintf(zf,"\nVECTORS velocity float\n");
         }
         for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
             for (i=il; i<=iu; i++) {
               if (strcmp(pOut->out,"cons") == 0){
-                data[3*(i-il)  ] = (float)pGrid->U[k][j][i].M1;
-                data[3*(i-il)+1] = (float)pGrid->U[k][j][i].M2;
-                data[3*(i-il)+2] = (float)pGrid->U[k][j][i].M3;
+                data[3*(i-il)  ] = (float)GRID_U(pGrid,k,j,i,M1);
+                data[3*(i-il)+1] = (float)GRID_U(pGrid,k,j,i,M2);
+                data[3*(i-il)+2] = (float)GRID_U(pGrid,k,j,i,M3);
               } else if(strcmp(pOut->out,"prim") == 0) {
                 data[3*(i-il)  ] = (float)W[k-kl][j-jl][i-il].V1;
                 data[3*(i-il)+1] = (float)W[k-kl][j-jl][i-il].V2;
                 data[3*(i-il)+2] = (float)W[k-kl][j-jl][i-il].V3;
               }
             }
+            ath_zlossy(zf,data,sizeof(float),3*(iu-il+1));
             if(!big_end) ath_bswap(data,sizeof(float),3*(iu-il+1));
-            fwrite(data,sizeof(float),(size_t)(3*ndata0),pfile);
+            ath_zwrite(data,sizeof(float),(size_t)(3*ndata0),zf);
           }
         }
 
@@ -205,22 +234,23 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 
 #ifndef BAROTROPIC
         if (strcmp(pOut->out,"cons") == 0){
-          fprintf(pfile,"\nSCALARS total_energy float\n");
+          ath_zprintf(zf,"\nSCALARS total_energy float\n");
         } else if(strcmp(pOut->out,"prim") == 0) {
-          fprintf(pfile,"\nSCALARS pressure float\n");
+          ath_zprintf(zf,"\nSCALARS pressure float\n");
         }
-        fprintf(pfile,"LOOKUP_TABLE default\n");
+        ath_zprintf(zf,"LOOKUP_TABLE default\n");
         for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
             for (i=il; i<=iu; i++) {
               if (strcmp(pOut->out,"cons") == 0){
-                data[i-il] = (float)pGrid->U[k][j][i].E;
+                data[i-il] = (float)GRID_U(pGrid,k,j,i,E);
               } else if(strcmp(pOut->out,"prim") == 0) {
                 data[i-il] = (float)W[k-kl][j-jl][i-il].P;
               }
             }
+            ath_zlossy(zf,data,sizeof(float),iu-il+1);
             if(!big_end) ath_bswap(data,sizeof(float),iu-il+1);
-            fwrite(data,sizeof(float),(size_t)ndata0,pfile);
+            ath_zwrite(data,sizeof(float),(size_t)ndata0,zf);
           }
         }
 #endif
@@ -228,16 +258,17 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 /* Write cell centered B */
 
 #ifdef MHD
-        fprintf(pfile,"\nVECTORS cell_centered_B float\n");
+        ath_zprintf(zf,"\nVECTORS cell_centered_B float\n");
         for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
             for (i=il; i<=iu; i++) {
-              data[3*(i-il)] = (float)pGrid->U[k][j][i].B1c;
-              data[3*(i-il)+1] = (float)pGrid->U[k][j][i].B2c;
-              data[3*(i-il)+2] = (float)pGrid->U[k][j][i].B3c;
+              data[3*(i-il)] = (float)GRID_U(pGrid,k,j,i,B1c);
+              data[3*(i-il)+1] = (float)GRID_U(pGrid,k,j,i,B2c);
+              data[3*(i-il)+2] = (float)GRID_U(pGrid,k,j,i,B3c);
             }
+            ath_zlossy(zf,data,sizeof(float),3*(iu-il+1));
             if(!big_end) ath_bswap(data,sizeof(float),3*(iu-il+1));
-            fwrite(data,sizeof(float),(size_t)(3*ndata0),pfile);
+            ath_zwrite(data,sizeof(float),(size_t)(3*ndata0),zf);
           }
         }
 #endif
@@ -245,15 +276,16 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 /* Write gravitational potential */
 
 #ifdef SELF_GRAVITY
-        fprintf(pfile,"\nSCALARS gravitational_potential float\n");
-        fprintf(pfile,"LOOKUP_TABLE default\n");
+        ath_zprintf(zf,"\nSCALARS gravitational_potential float\n");
+        ath_zprintf(zf,"LOOKUP_TABLE default\n");
         for (k=kl; k<=ku; k++) {
           for (j=jl; j<=ju; j++) {
             for (i=il; i<=iu; i++) {
               data[i-il] = (float)pGrid->Phi[k][j][i];
             }
+            ath_zlossy(zf,data,sizeof(float),iu-il+1);
             if(!big_end) ath_bswap(data,sizeof(float),iu-il+1);
-            fwrite(data,sizeof(float),(size_t)ndata0,pfile);
+            ath_zwrite(data,sizeof(float),(size_t)ndata0,zf);
           }
         }
 #endif
@@ -262,18 +294,19 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 
 #ifdef PARTICLES
         if (pOut->out_pargrid) {
-          fprintf(pfile,"\nSCALARS particle_density float\n");
-          fprintf(pfile,"LOOKUP_TABLE default\n");
+          ath_zprintf(zf,"\nSCALARS particle_density float\n");
+          ath_zprintf(zf,"LOOKUP_TABLE default\n");
           for (k=kl; k<=ku; k++) {
             for (j=jl; j<=ju; j++) {
               for (i=il; i<=iu; i++) {
                 data[i-il] = pGrid->Coup[k][j][i].grid_d;
               }
+              ath_zlossy(zf,data,sizeof(float),iu-il+1);
               if(!big_end) ath_bswap(data,sizeof(float),iu-il+1);
-              fwrite(data,sizeof(float),(size_t)ndata0,pfile);
+              ath_zwrite(data,sizeof(float),(size_t)ndata0,zf);
             }
           }
-          fprintf(pfile,"\nVECTORS particle_momentum float\n");
+          ath_zprintf(zf,"\nVECTORS particle_momentum float\n");
           for (k=kl; k<=ku; k++) {
             for (j=jl; j<=ju; j++) {
               for (i=il; i<=iu; i++) {
@@ -281,8 +314,9 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
                 data[3*(i-il)+1] = pGrid->Coup[k][j][i].grid_v2;
                 data[3*(i-il)+2] = pGrid->Coup[k][j][i].grid_v3;
               }
+              ath_zlossy(zf,data,sizeof(float),3*(iu-il+1));
               if(!big_end) ath_bswap(data,sizeof(float),3*(iu-il+1));
-              fwrite(data,sizeof(float),(size_t)(3*ndata0),pfile);
+              ath_zwrite(data,sizeof(float),(size_t)(3*ndata0),zf);
             }
           }
         }
@@ -293,22 +327,23 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++){
           if (strcmp(pOut->out,"cons") == 0){
-            fprintf(pfile,"\nSCALARS scalar[%d] float\n",n);
+            ath_zprintf(zf,"\nSCALARS scalar[%d] float\n",n);
           } else if(strcmp(pOut->out,"prim") == 0) {
-            fprintf(pfile,"\nSCALARS specific_scalar[%d] float\n",n);
+            ath_zprintf(zf,"\nSCALARS specific_scalar[%d] float\n",n);
           }
-          fprintf(pfile,"LOOKUP_TABLE default\n");
+          ath_zprintf(zf,"LOOKUP_TABLE default\n");
           for (k=kl; k<=ku; k++) {
             for (j=jl; j<=ju; j++) {
               for (i=il; i<=iu; i++) {
                 if (strcmp(pOut->out,"cons") == 0){
-                  data[i-il] = (float)pGrid->U[k][j][i].s[n];
+                  data[i-il] = (float)GRID_U(pGrid,k,j,i,s[n]);
                 } else if(strcmp(pOut->out,"prim") == 0) {
                   data[i-il] = (float)W[k-kl][j-jl][i-il].r[n];
                 }
               }
+              ath_zlossy(zf,data,sizeof(float),iu-il+1);
               if(!big_end) ath_bswap(data,sizeof(float),iu-il+1);
-              fwrite(data,sizeof(float),(size_t)ndata0,pfile);
+              ath_zwrite(data,sizeof(float),(size_t)ndata0,zf);
             }
           }
         }
@@ -316,6 +351,7 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
 
 /* close file and free memory */
 
+        ath_zclose(zf);
         fclose(pfile);
         free(data);
         if(strcmp(pOut->out,"prim") == 0) free_3d_array(W);
@@ -324,3 +360,195 @@ void dump_vtk(MeshS *pM, OutputS *pOut)
   }
   return;
 }
+
+#ifdef MPI_PARALLEL
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void dump_vtk_shared(MeshS *pM, OutputS *pOut, int nl, int nd)
+ *  \brief Writes VTK dump of Domain nd on level nl to one file shared by all
+ *   processes with a Grid in it.  The variables are the same as in dump_vtk(),
+ *   each one over the whole Domain. */
+
+static void dump_vtk_shared(MeshS *pM, OutputS *pOut, int nl, int nd)
+{
+  DomainS *pD = &(pM->Domain[nl][nd]);
+  GridS *pGrid = pD->Grid;
+  PrimS ***W=NULL;
+  ConsS Ucell;
+  SFileS *sf;
+  int i,j,k,il,iu,jl,ju,kl,ku,m=0;
+  int prim = (strcmp(pOut->out,"prim") == 0);
+  float *data;   /* points to 3*(cells in Grid) allocated floats */
+#if (NSCALARS > 0)
+  int n;
+#endif
+
+  il = pGrid->is, iu = pGrid->ie;
+  jl = pGrid->js, ju = pGrid->je;
+  kl = pGrid->ks, ku = pGrid->ke;
+
+  if (prim) {
+    if((W = (PrimS***)calloc_3d_array(ku-kl+1,ju-jl+1,iu-il+1,sizeof(PrimS)))
+       == NULL) ath_error("[dump_vtk]: failed to allocate Prim array\n");
+    for (k=kl; k<=ku; k++) {
+    for (j=jl; j<=ju; j++) {
+    for (i=il; i<=iu; i++) {
+      Ucell = GET_GRID_U(pGrid,k,j,i);
+      W[k-kl][j-jl][i-il] = Cons_to_Prim(&Ucell);
+    }}}
+  }
+  if((data = (float *)malloc(3*(iu-il+1)*(ju-jl+1)*(ku-kl+1)*sizeof(float)))
+     == NULL) ath_error("[dump_vtk]: malloc failed for temporary array\n");
+
+  sf = ath_sfopen(pM,nl,nd,pOut,NULL,"vtk");
+
+/* Header, with the size and origin of the Domain */
+
+  ath_sfprintf(sf,"# vtk DataFile Version 2.0\n");
+  ath_sfprintf(sf,"%s vars at time= %e, level= %i, domain= %i\n",
+    (prim ? "PRIMITIVE" : "CONSERVED"),pGrid->time,nl,nd);
+  ath_sfprintf(sf,"BINARY\n");
+  ath_sfprintf(sf,"DATASET STRUCTURED_POINTS\n");
+  if (pD->Nx[1] == 1) {
+    ath_sfprintf(sf,"DIMENSIONS %d %d %d\n",pD->Nx[0]+1,1,1);
+  } else if (pD->Nx[2] == 1) {
+    ath_sfprintf(sf,"DIMENSIONS %d %d %d\n",pD->Nx[0]+1,pD->Nx[1]+1,1);
+  } else {
+    ath_sfprintf(sf,"DIMENSIONS %d %d %d\n",pD->Nx[0]+1,pD->Nx[1]+1,
+      pD->Nx[2]+1);
+  }
+  ath_sfprintf(sf,"ORIGIN %e %e %e \n",pD->MinX[0],pD->MinX[1],pD->MinX[2]);
+  ath_sfprintf(sf,"SPACING %e %e %e \n",pGrid->dx1,pGrid->dx2,pGrid->dx3);
+  ath_sfprintf(sf,"CELL_DATA %d \n",pD->Nx[0]*pD->Nx[1]*pD->Nx[2]);
+
+/* Write density */
+
+  ath_sfprintf(sf,"SCALARS density float\n");
+  ath_sfprintf(sf,"LOOKUP_TABLE default\n");
+  for (k=kl, m=0; k<=ku; k++) {
+  for (j=jl; j<=ju; j++) {
+  for (i=il; i<=iu; i++) {
+    data[m++] = (float)(prim ? W[k-kl][j-jl][i-il].d : GRID_U(pGrid,k,j,i,d));
+  }}}
+  put_vtk_var(sf,data,1);
+
+/* Write momentum or velocity */
+
+  ath_sfprintf(sf,"\nVECTORS %s float\n",(prim ? "velocity" : "momentum"));
+  for (k=kl, m=0; k<=ku; k++) {
+  for (j=jl; j<=ju; j++) {
+  for (i=il; i<=iu; i++) {
+    if (prim) {
+      data[m++] = (float)W[k-kl][j-jl][i-il].V1;
+      data[m++] = (float)W[k-kl][j-jl][i-il].V2;
+      data[m++] = (float)W[k-kl][j-jl][i-il].V3;
+    } else {
+      data[m++] = (float)GRID_U(pGrid,k,j,i,M1);
+      data[m++] = (float)GRID_U(pGrid,k,j,i,M2);
+      data[m++] = (float)GRID_U(pGrid,k,j,i,M3);
+    }
+  }}}
+  put_vtk_var(sf,data,3);
+
+/* Write total energy or pressure */
+
+#ifndef BAROTROPIC
+  ath_sfprintf(sf,"\nSCALARS %s float\n",(prim ? "pressure" : "total_energy"));
+  ath_sfprintf(sf,"LOOKUP_TABLE default\n");
+  for (k=kl, m=0; k<=ku; k++) {
+  for (j=jl; j<=ju; j++) {
+  for (i=il; i<=iu; i++) {
+    data[m++] = (float)(prim ? W[k-kl][j-jl][i-il].P : GRID_U(pGrid,k,j,i,E));
+  }}}
+  put_vtk_var(sf,data,1);
+#endif
+
+/* Write cell centered B */
+
+#ifdef MHD
+  ath_sfprintf(sf,"\nVECTORS cell_centered_B float\n");
+  for (k=kl, m=0; k<=ku; k++) {
+  for (j=jl; j<=ju; j++) {
+  for (i=il; i<=iu; i++) {
+    data[m++] = (float)GRID_U(pGrid,k,j,i,B1c);
+    data[m++] = (float)GRID_U(pGrid,k,j,i,B2c);
+    data[m++] = (float)GRID_U(pGrid,k,j,i,B3c);
+  }}}
+  put_vtk_var(sf,data,3);
+#endif
+
+/* Write gravitational potential */
+
+#ifdef SELF_GRAVITY
+  ath_sfprintf(sf,"\nSCALARS gravitational_potential float\n");
+  ath_sfprintf(sf,"LOOKUP_TABLE default\n");
+  for (k=kl, m=0; k<=ku; k++) {
+  for (j=jl; j<=ju; j++) {
+  for (i=il; i<=iu; i++) {
+    data[m++] = (float)pGrid->Phi[k][j][i];
+  }}}
+  put_vtk_var(sf,data,1);
+#endif
+
+/* Write binned particle grid */
+
+#ifdef PARTICLES
+  if (pOut->out_pargrid) {
+    ath_sfprintf(sf,"\nSCALARS particle_density float\n");
+    ath_sfprintf(sf,"LOOKUP_TABLE default\n");
+    for (k=kl, m=0; k<=ku; k++) {
+    for (j=jl; j<=ju; j++) {
+    for (i=il; i<=iu; i++) {
+      data[m++] = pGrid->Coup[k][j][i].grid_d;
+    }}}
+    put_vtk_var(sf,data,1);
+
+    ath_sfprintf(sf,"\nVECTORS particle_momentum float\n");
+    for (k=kl, m=0; k<=ku; k++) {
+    for (j=jl; j<=ju; j++) {
+    for (i=il; i<=iu; i++) {
+      data[m++] = pGrid->Coup[k][j][i].grid_v1;
+      data[m++] = pGrid->Coup[k][j][i].grid_v2;
+      data[m++] = pGrid->Coup[k][j][i].grid_v3;
+    }}}
+    put_vtk_var(sf,data,3);
+  }
+#endif
+
+/* Write passive scalars */
+
+#if (NSCALARS > 0)
+  for (n=0; n<NSCALARS; n++){
+    ath_sfprintf(sf,"\nSCALARS %sscalar[%d] float\n",(prim ? "specific_" : ""),
+      n);
+    ath_sfprintf(sf,"LOOKUP_TABLE default\n");
+    for (k=kl, m=0; k<=ku; k++) {
+    for (j=jl; j<=ju; j++) {
+    for (i=il; i<=iu; i++) {
+      data[m++] = (float)(prim ? W[k-kl][j-jl][i-il].r[n] :
+                                 GRID_U(pGrid,k,j,i,s[n]));
+    }}}
+    put_vtk_var(sf,data,1);
+  }
+#endif
+
+  ath_sfclose(sf);
+  free(data);
+  if (prim) free_3d_array(W);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void put_vtk_var(SFileS *sf, float *data, const int ncomp)
+ *  \brief Writes one variable with ncomp floats per cell, in big-endian order
+ *   as VTK requires, to a shared file */
+
+static void put_vtk_var(SFileS *sf, float *data, const int ncomp)
+{
+  int n = ncomp*sf->size[0]*sf->size[1]*sf->size[2];
+
+  if(!ath_big_endian()) ath_bswap(data,sizeof(float),n);
+  ath_sfwrite_grid(data,ncomp*(int)sizeof(float),sf);
+  return;
+}
+#endif /* MPI_PARALLEL */
@@ -24,6 +24,9 @@ Real d_MIN = TINY_NUMBER;    /*!< density floor */
 
 GravPotFun_t StaticGravPot = NULL;
 CoolingFun_t CoolingFunc = NULL;
+#ifdef ADAPTIVE_MESH_REFINEMENT
+AMRFlagFun_t AMRFlagFunc = NULL; /*!< refinement criterion, see amr.c */
+#endif
 #ifdef SELF_GRAVITY
 Real four_pi_G, grav_mean_rho;    /*!< 4\pi G and mean density in domain */
 #endif
@@ -70,6 +73,9 @@ ShearFun_t ShearProfile = NULL;
 #endif
 
 Real etah=0.0;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(etah)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* definitions included everywhere except main.c  */
@@ -87,6 +93,9 @@ extern Real d_MIN;
 
 extern GravPotFun_t StaticGravPot;
 extern CoolingFun_t CoolingFunc;
+#ifdef ADAPTIVE_MESH_REFINEMENT
+extern AMRFlagFun_t AMRFlagFunc;
+#endif
 #ifdef SELF_GRAVITY
 extern Real four_pi_G, grav_mean_rho;
 #endif
@@ -133,5 +142,8 @@ extern ShearFun_t ShearProfile;
 #endif
 
 extern Real etah;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(etah)
+#endif
 #endif /* MAIN_C */
 #endif /* GLOBALS_H */
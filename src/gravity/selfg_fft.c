@@ -72,15 +72,15 @@ void selfg_fft_1d(DomainS *pD)
 
   pG->Phi[ks][js][is] = 0.0;
   for (i=is; i<=ie; i++) {
-    drho = (pG->U[ks][js][i].d - grav_mean_rho);
+    drho = (GRID_U(pG,ks,js,i,d) - grav_mean_rho);
     pG->Phi[ks][js][is] += ((float)(i-is+1))*four_pi_G*dx_sq*drho;
   }
   pG->Phi[ks][js][is] /= (float)(pG->Nx[0]);
 
-  drho = (pG->U[ks][js][is].d - grav_mean_rho);
+  drho = (GRID_U(pG,ks,js,is,d) - grav_mean_rho);
   pG->Phi[ks][js][is+1] = 2.0*pG->Phi[ks][js][is] + four_pi_G*dx_sq*drho;
   for (i=is+2; i<=ie; i++) {
-    drho = (pG->U[ks][js][i-1].d - grav_mean_rho);
+    drho = (GRID_U(pG,ks,js,i-1,d) - grav_mean_rho);
     pG->Phi[ks][js][i] = four_pi_G*dx_sq*drho 
       + 2.0*pG->Phi[ks][js][i-1] - pG->Phi[ks][js][i-2];
   }
@@ -145,7 +145,7 @@ void selfg_fft_2d_xy(DomainS *pD)
     for (i=is-nghost; i<=ie+nghost; i++){
       pG->Phi_old[ks][j][i] = pG->Phi[ks][j][i];
 #ifdef SHEARING_BOX
-      RollDen[ks][i][j] = pG->U[ks][j][i].d;
+      RollDen[ks][i][j] = GRID_U(pG,ks,j,i,d);
 #endif
     }
   }
@@ -163,7 +163,7 @@ void selfg_fft_2d_xy(DomainS *pD)
 #ifdef SHEARING_BOX
         four_pi_G*(RollDen[ks][i][j] - grav_mean_rho);
 #else
-        four_pi_G*(pG->U[ks][j][i].d - grav_mean_rho);
+        four_pi_G*(GRID_U(pG,ks,j,i,d) - grav_mean_rho);
 #endif
       work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1] = 0.0;
     }
@@ -291,7 +291,7 @@ void selfg_fft_2d(DomainS *pD)
   for (j=js; j<=je; j++){
     for (i=is; i<=ie; i++){
       work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] =
-        four_pi_G*(pG->U[ks][j][i].d - grav_mean_rho);
+        four_pi_G*(GRID_U(pG,ks,j,i,d) - grav_mean_rho);
       work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1] = 0.0;
     }
   }
@@ -398,7 +398,7 @@ void selfg_fft_3d(DomainS *pD)
     for (i=is-nghost; i<=ie+nghost; i++){
       pG->Phi_old[k][j][i] = pG->Phi[k][j][i];
 #ifdef SHEARING_BOX
-      RollDen[k][i][j] = pG->U[k][j][i].d;
+      RollDen[k][i][j] = GRID_U(pG,k,j,i,d);
 #endif
     }
   }}
@@ -417,7 +417,7 @@ void selfg_fft_3d(DomainS *pD)
 #ifdef SHEARING_BOX
         RollDen[k][i][j] - grav_mean_rho;
 #else
-        pG->U[k][j][i].d - grav_mean_rho;
+        GRID_U(pG,k,j,i,d) - grav_mean_rho;
 #endif
       work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1] = 0.0;
     }
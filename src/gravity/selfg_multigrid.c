@@ -7,6 +7,20 @@
  *   These functions work for non-periodic domains.  A low-order multipole
  *   expansion is used to compute the potential on the boundaries.
  *
+ *   The hierarchy of levels is allocated once by selfg_multig_3d_init().  Each
+ *   level is coarsened by a factor of two in the directions that have an even
+ *   number (at least 4) of cells and the smallest cells, until no direction
+ *   can be coarsened.  Each call to selfg_multig_3d() does a full multigrid
+ *   (FMG) cycle, starting from the solution on the coarsest level, followed
+ *   by V-cycles on the finest level until the RMS residual is less than
+ *   <gravity>/mg_tol times the RMS of the RHS, or <gravity>/mg_max_cycles
+ *   V-cycles have been done.  Red-black Gauss-Seidel is used as the smoother,
+ *   with <gravity>/mg_npre and <gravity>/mg_npost sweeps before and after
+ *   each coarse grid correction.  The FMG cycle alone already reaches the
+ *   truncation error of the discretization, so the defaults (mg_tol=1e-3,
+ *   mg_max_cycles=2) add at most a couple of V-cycles; smaller tolerances
+ *   only converge the algebraic error further.
+ *
  * HISTORY:
  * - june-2007 - 2D and 3D solvers written by Irene Balmes
  * - july-2007 - routines incorporated into Athena by JMS and IB
@@ -14,11 +28,13 @@
  * CONTAINS PUBLIC FUNCTIONS:
  * - selfg_by_multig_2d() - 2D Poisson solver using multigrid
  * - selfg_by_multig_3d() - 3D Poisson solver using multigrid
- * - selfg_by_multig_3d_init() - Initializes send/receive buffers for MPI */
+ * - selfg_by_multig_3d_init() - Initializes levels, and send/receive buffers
+ *   for MPI */
 /*============================================================================*/
 
 #include <math.h>
 #include <float.h>
+#include <string.h>
 #include "../defs.h"
 #include "../athena.h"
 #include "../globals.h"
@@ -45,6 +61,9 @@ static double *send_buf=NULL, *recv_buf=NULL;
 typedef struct MGrid_s{
   Real ***rhs,***Phi;  /* RHS of elliptic equation, and solution */
   Real dx1,dx2,dx3;
+  Real MinX[3];        /* min(x) in each dir, used for boundary values */
+  Real bfac[3];        /* ghost zone = -bfac*(interior) for a correction */
+  int corr;            /* 1 if Phi is a correction to the next finer level */
   int Nx1,Nx2,Nx3;
   int is,ie;
   int js,je;
@@ -54,18 +73,43 @@ typedef struct MGrid_s{
   int rx3_id, lx3_id;
 }MGrid;
 
-/* 3D temporary array needed for restriction of errors  */
-Real ***error;
+static MGrid *MGLev=NULL;     /* levels, from [0]=finest to [NMGLev-1] */
+static int NMGLev=0;
+static Real mg_tol;           /* tolerance on RMS residual relative to RHS */
+static int mg_max_cycles;     /* max number of V-cycles after FMG cycle */
+static int mg_npre, mg_npost; /* smoothing sweeps before/after coarse corr. */
+static Real mg_GM;            /* G*(total mass), for boundary values */
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
- *   multig_3d() -
+ *   fmg_3d()          - FMG cycle from coarsest to finest level
+ *   vcycle_3d()       - V-cycle from level nl to the coarsest level
+ *   coarse_solve_3d() - solves on coarsest level by iteration
+ *   RBGauss_Seidel()  - red-black Gauss-Seidel sweeps
+ *   residual()        - residual in one cell
+ *   residual_norm()   - RMS residual on a level
+ *   Restrict_rhs_3d() - averages RHS of fine level onto coarse level
+ *   Restrict_res_3d() - averages residual of fine level onto coarse level RHS
+ *   Prolong_3d()      - linear interpolation of coarse level onto fine
+ *   monopole()        - monopole potential at center of a cell
+ *   monopole_bvals()  - sets potential in ghost zones from monopole
+ *   corr_bvals()      - sets correction in ghost zones
+ *   coarsen_level()   - sets size of next coarser level
  *============================================================================*/
 
-void multig_3d(MGrid *pMG);
-void Jacobi(MGrid *pMG);
-void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse);
-void Prolongation_3d(MGrid *pMG_coarse, MGrid *pMG_fine);
+static void fmg_3d(void);
+static void vcycle_3d(const int nl);
+static void coarse_solve_3d(MGrid *pMG);
+static void RBGauss_Seidel(MGrid *pMG, const int nsweep);
+static Real residual(const MGrid *pMG, const int k, const int j, const int i);
+static Real residual_norm(const MGrid *pMG);
+static void Restrict_rhs_3d(const MGrid *pMG_fine, MGrid *pMG_coarse);
+static void Restrict_res_3d(const MGrid *pMG_fine, MGrid *pMG_coarse);
+static void Prolong_3d(const MGrid *pMG_coarse, MGrid *pMG_fine, const int add);
+static Real monopole(const MGrid *pMG, const int k, const int j, const int i);
+static void monopole_bvals(MGrid *pMG);
+static void corr_bvals(MGrid *pMG);
+static int coarsen_level(const MGrid *pMG_fine, MGrid *pMG_coarse);
 
 #ifdef MPI_PARALLEL
 void set_mg_bvals(MGrid *pMG);
@@ -110,15 +154,17 @@ void selfg_multig_2d(DomainS *pD)
 void selfg_multig_3d(DomainS *pD)
 {
   GridS *pG = (pD->Grid);
+  MGrid *pMG = &(MGLev[0]);
   int i, is = pG->is, ie = pG->ie;
   int j, js = pG->js, je = pG->je;
   int k, ks = pG->ks, ke = pG->ke;
-  int Nx1z, Nx2z, Nx3z;
-  MGrid Root_grid;
+  int ncycle;
   Real mass = 0.0, tmass, dVol, rad, x1, x2, x3;
   Real Grav_const = four_pi_G/(4.0*PI);
+  Real rhs_norm = 0.0, res_norm;
 #ifdef MPI_PARALLEL
-  Real mpi_err;
+  Real mpi_err, my_norm;
+  long ncell;
 #endif
 
 /* Copy current potential into old */
@@ -137,7 +183,7 @@ void selfg_multig_3d(DomainS *pD)
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
-        mass += pG->U[k][j][i].d*dVol;
+        mass += GRID_U(pG,k,j,i,d)*dVol;
       }
     }
   }
@@ -149,6 +195,7 @@ void selfg_multig_3d(DomainS *pD)
 #else
   tmass = mass;
 #endif /* MPI_PARALLEL */
+  mg_GM = Grav_const*tmass;
 
 /*  Inner and outer x1 boundaries */
 
@@ -228,50 +275,48 @@ void selfg_multig_3d(DomainS *pD)
     }
   }
 
-/* Initialize MGrid structure for top level (the root, or finest, level) */
-
-  Root_grid.Nx1 = pG->Nx[0];
-  Root_grid.Nx2 = pG->Nx[1];
-  Root_grid.Nx3 = pG->Nx[2];
-  Root_grid.is = 1;  Root_grid.ie = pG->Nx[0];
-  Root_grid.js = 1;  Root_grid.je = pG->Nx[1];
-  Root_grid.ks = 1;  Root_grid.ke = pG->Nx[2];
-  Root_grid.dx1 = pG->dx1;
-  Root_grid.dx2 = pG->dx2;
-  Root_grid.dx3 = pG->dx3;
-  Root_grid.rx1_id = pG->rx1_id; Root_grid.lx1_id = pG->lx1_id;
-  Root_grid.rx2_id = pG->rx2_id; Root_grid.lx2_id = pG->lx2_id;
-  Root_grid.rx3_id = pG->rx3_id; Root_grid.lx3_id = pG->lx3_id;
-
-/* There is only one ghost zone needed at each level, not nghost */
-  Nx1z = pG->Nx[0] + 2;
-  Nx2z = pG->Nx[1] + 2;
-  Nx3z = pG->Nx[2] + 2;
-  Root_grid.rhs = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-  Root_grid.Phi = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-  if (Root_grid.rhs == NULL) {
-    ath_error("[selfg_by_multig_3d]: Error allocating memory\n");
-  }
-  if (Root_grid.Phi == NULL) {
-    ath_error("[selfg_by_multig_3d]: Error allocating memory\n");
-  }
+/* Initialize RHS and solution on the finest level, including single ghost
+ * zone.  The potential in the ghost zones is held fixed. */
 
-/* Initialize solution on root grid, including single ghost zone */
   for (k=ks-1; k<=ke+1; k++){
     for (j=js-1; j<=je+1; j++){
       for (i=is-1; i<=ie+1; i++){
-        Root_grid.rhs[k-ks+1][j-js+1][i-is+1] = four_pi_G*pG->U[k][j][i].d;
-        Root_grid.Phi[k-ks+1][j-js+1][i-is+1] = pG->Phi[k][j][i];
+        pMG->rhs[k-ks+1][j-js+1][i-is+1] = four_pi_G*GRID_U(pG,k,j,i,d);
+        pMG->Phi[k-ks+1][j-js+1][i-is+1] = pG->Phi[k][j][i];
+      }
+    }
+  }
+  for (k=pMG->ks; k<=pMG->ke; k++){
+    for (j=pMG->js; j<=pMG->je; j++){
+      for (i=pMG->is; i<=pMG->ie; i++){
+        rhs_norm += pMG->rhs[k][j][i]*pMG->rhs[k][j][i];
       }
     }
   }
 #ifdef MPI_PARALLEL
-  set_mg_bvals(&Root_grid);
+  my_norm = rhs_norm;
+  mpi_err = MPI_Allreduce(&my_norm, &rhs_norm,1,MPI_DOUBLE,MPI_SUM,
+    MPI_COMM_WORLD);
+  ncell = (long)pD->Nx[0]*pD->Nx[1]*pD->Nx[2];
+  rhs_norm = sqrt(rhs_norm/(Real)ncell);
+  set_mg_bvals(pMG);
+#else
+  rhs_norm = sqrt(rhs_norm/(Real)(pMG->Nx1*pMG->Nx2*pMG->Nx3));
 #endif
 
-/* Compute new potential.  Note multig_3d calls itself recursively. */
+/* Compute new potential with an FMG cycle, then iterate V-cycles until the
+ * residual is small enough */
 
-  multig_3d(&Root_grid);
+  fmg_3d();
+
+  res_norm = residual_norm(pMG);
+  for (ncycle=0; ncycle<mg_max_cycles && res_norm > mg_tol*rhs_norm; ncycle++){
+    vcycle_3d(0);
+    res_norm = residual_norm(pMG);
+  }
+  if (res_norm > mg_tol*rhs_norm)
+    ath_perr(0,"[selfg_multig_3d]: residual = %e of RHS after %d V-cycles\n",
+      res_norm/rhs_norm, ncycle);
 
 /* copy solution for potential from MGrid into Grid structure.  Boundary
  * conditions for nghost ghost cells are set by set_bvals() call in main() */
@@ -279,133 +324,130 @@ void selfg_multig_3d(DomainS *pD)
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
-        pG->Phi[k][j][i] = Root_grid.Phi[k-ks+1][j-js+1][i-is+1];
+        pG->Phi[k][j][i] = pMG->Phi[k-ks+1][j-js+1][i-is+1];
       }
     }
   }
 
-  free_3d_array(Root_grid.rhs);
-  free_3d_array(Root_grid.Phi);
-
   return;
 }
 
+/*=========================== PRIVATE FUNCTIONS ==============================*/
 /*----------------------------------------------------------------------------*/
-/*! \fn void multig_3d(MGrid *pMG)
- *  \brief Functions needed for the multigrid solver in 3D
+/*! \fn static void fmg_3d(void)
+ *  \brief Full multigrid cycle.  The RHS is averaged down to every level, the
+ *   coarsest level is solved, and then the solution on each level is
+ *   interpolated onto the next finer level and improved by one V-cycle.
+ *   The RHS and the potential in the ghost zones of the finest level must be
+ *   set.
  */
 
-void multig_3d(MGrid *pMG)
+static void fmg_3d(void)
 {
-  int i, is = pMG->is, ie = pMG->ie;
-  int j, js = pMG->js, je = pMG->je;
-  int k, ks = pMG->ks, ke = pMG->ke;
-  int Nx1z, Nx2z, Nx3z;
-  MGrid Coarse_grid;
-
-/* If we are down to 4 cells in any dimension do 10 iterations and return */
-
-  if (pMG->Nx1==4 || pMG->Nx2==4 || pMG->Nx3==4)
-    Jacobi(pMG);
-
-/* Else, do 10 iterations at this level, restrict to a coarser grid, and call
- * multig_3d again with this coarse grid */
-
-  else { 
-    Jacobi(pMG);
-
-/* Allocate and initialize MGrid at next coarsest level */
-
-    Coarse_grid.Nx1 = pMG->Nx1/2;
-    Coarse_grid.Nx2 = pMG->Nx2/2;
-    Coarse_grid.Nx3 = pMG->Nx3/2;
-    Coarse_grid.is = 1;  Coarse_grid.ie = Coarse_grid.Nx1;
-    Coarse_grid.js = 1;  Coarse_grid.je = Coarse_grid.Nx2;
-    Coarse_grid.ks = 1;  Coarse_grid.ke = Coarse_grid.Nx3;
-    Coarse_grid.dx1 = 2.0*pMG->dx1;
-    Coarse_grid.dx2 = 2.0*pMG->dx2;
-    Coarse_grid.dx3 = 2.0*pMG->dx3;
-    Coarse_grid.rx1_id = pMG->rx1_id; Coarse_grid.lx1_id = pMG->lx1_id;
-    Coarse_grid.rx2_id = pMG->rx2_id; Coarse_grid.lx2_id = pMG->lx2_id;
-    Coarse_grid.rx3_id = pMG->rx3_id; Coarse_grid.lx3_id = pMG->lx3_id;
-
-/* Again, only one ghost zone on each level */
-    Nx1z = (pMG->Nx1)/2 + 2;
-    Nx2z = (pMG->Nx2)/2 + 2;
-    Nx3z = (pMG->Nx3)/2 + 2;
-    Coarse_grid.rhs = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-    Coarse_grid.Phi = (Real ***) calloc_3d_array(Nx3z,Nx2z,Nx1z,sizeof(Real));
-    if (Coarse_grid.rhs == NULL) {
-      ath_error("[multig_3d]: Error allocating memory for some level\n");
-    }
-    if (Coarse_grid.Phi == NULL) {
-      ath_error("[multig_3d]: Error allocating memory for some level\n");
-    }
+  int nl;
+
+  for (nl=1; nl<NMGLev; nl++) Restrict_rhs_3d(&(MGLev[nl-1]), &(MGLev[nl]));
 
-    Restriction_3d(pMG, &Coarse_grid);
+/* On coarser levels, the solution is the potential itself, so the ghost zones
+ * hold the monopole potential at their (coarser) cell centers */
+
+  if (NMGLev > 1) {
+    memset(&(MGLev[NMGLev-1].Phi[0][0][0]), 0, (MGLev[NMGLev-1].Nx3+2)*
+      (MGLev[NMGLev-1].Nx2+2)*(MGLev[NMGLev-1].Nx1+2)*sizeof(Real));
+    monopole_bvals(&(MGLev[NMGLev-1]));
+  }
+  coarse_solve_3d(&(MGLev[NMGLev-1]));
+
+  for (nl=NMGLev-2; nl>=0; nl--){
+    if (nl > 0) monopole_bvals(&(MGLev[nl]));
+    Prolong_3d(&(MGLev[nl+1]), &(MGLev[nl]), 0);
 #ifdef MPI_PARALLEL
-    set_mg_bvals(&Coarse_grid);
+    set_mg_bvals(&(MGLev[nl]));
 #endif
+    vcycle_3d(nl);
+  }
 
-    multig_3d(&Coarse_grid);
+  return;
+}
 
-/* The following code is first reached after 10 iterations at the coarsest
- * level.  We then prolongate, do 10 iterations, and return.  This will return
- * execution to this same spot for the next coarsest level, so we will
- * prolongate, do 10 iterations, return, and so on.
+/*----------------------------------------------------------------------------*/
+/*! \fn static void vcycle_3d(const int nl)
+ *  \brief V-cycle on level nl.  On all coarser levels the solution is the
+ *   correction to the next finer level, which is zero on the boundaries.
  */
 
-    Prolongation_3d(&Coarse_grid, pMG);
-    free_3d_array(Coarse_grid.rhs);
-    free_3d_array(Coarse_grid.Phi);
+static void vcycle_3d(const int nl)
+{
+  MGrid *pMG = &(MGLev[nl]);
+
+  if (nl == NMGLev-1) {
+    coarse_solve_3d(pMG);
+    return;
+  }
+
+  RBGauss_Seidel(pMG, mg_npre);
+  Restrict_res_3d(pMG, &(MGLev[nl+1]));
+  vcycle_3d(nl+1);
+  Prolong_3d(&(MGLev[nl+1]), pMG, 1);
 #ifdef MPI_PARALLEL
-    set_mg_bvals(pMG);
+  set_mg_bvals(pMG);
 #endif
+  RBGauss_Seidel(pMG, mg_npost);
+
+  return;
+}
 
-/* End with 10 iterations at the finest level */
+/*----------------------------------------------------------------------------*/
+/*! \fn static void coarse_solve_3d(MGrid *pMG)
+ *  \brief Iterates on the coarsest level until the residual is reduced by a
+ *   factor of 1000, or (Nx1+Nx2+Nx3)^2 sweeps have been done.
+ */
+
+static void coarse_solve_3d(MGrid *pMG)
+{
+  int n, nmax = (pMG->Nx1 + pMG->Nx2 + pMG->Nx3);
+  Real res0 = residual_norm(pMG);
 
-    Jacobi(pMG);
+  nmax *= nmax;
+  for (n=0; n<nmax; n+=4){
+    RBGauss_Seidel(pMG, 4);
+    if (residual_norm(pMG) <= 1.0e-3*res0) break;
   }
 
   return;
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void Jacobi(MGrid *pMG)
- *  \brief Jacobi iterations. 
- *
- *   Do not use with periodic BCs, uses multipole expansion
- *   to compute potential at boundary
+/*! \fn static void RBGauss_Seidel(MGrid *pMG, const int nsweep)
+ *  \brief Red-black Gauss-Seidel sweeps.  Cells with i+j+k even are updated
+ *   first, then those with i+j+k odd, using the new values of the first.
  */
-void Jacobi(MGrid *pMG)
+
+static void RBGauss_Seidel(MGrid *pMG, const int nsweep)
 {
   int i, is = pMG->is, ie = pMG->ie;
   int j, js = pMG->js, je = pMG->je;
   int k, ks = pMG->ks, ke = pMG->ke;
-  int n;
-  Real dx1sq = (pMG->dx1*pMG->dx1);
-  Real dx2sq = (pMG->dx2*pMG->dx2);
-  Real dx3sq = (pMG->dx3*pMG->dx3);
-
-/* Jacobi iterations in 3D */
-
-  if (pMG->Nx3 > 1) {
-    for (n=0; n<=10; n++){  /* hardwired to do 10 iterations */
-      for (k=ks; k<=ke; k++){
-        for (j=js; j<=je; j++){
-          for (i=is; i<=ie; i++){
-            error[k][j][i] = -pMG->rhs[k][j][i];
-            error[k][j][i] += (pMG->Phi[k][j][i+1] + pMG->Phi[k][j][i-1])/dx1sq;
-            error[k][j][i] += (pMG->Phi[k][j+1][i] + pMG->Phi[k][j-1][i])/dx2sq;
-            error[k][j][i] += (pMG->Phi[k+1][j][i] + pMG->Phi[k-1][j][i])/dx3sq;
-          }
-        }
-      }
-
+  int n, color;
+  Real c1 = 1.0/(pMG->dx1*pMG->dx1);
+  Real c2 = 1.0/(pMG->dx2*pMG->dx2);
+  Real c3 = (pMG->Nx3 > 1) ? 1.0/(pMG->dx3*pMG->dx3) : 0.0;
+  Real diag = 1.0/(2.0*(c1 + c2 + c3));
+  Real **Phim, **Phi0, **Phip, **rhs;
+
+  for (n=0; n<nsweep; n++){
+    for (color=0; color<2; color++){
+      if (pMG->corr) corr_bvals(pMG);
       for (k=ks; k<=ke; k++){
+        Phim = pMG->Phi[k-1];
+        Phi0 = pMG->Phi[k];
+        Phip = pMG->Phi[k+1];
+        rhs = pMG->rhs[k];
         for (j=js; j<=je; j++){
-          for (i=is; i<=ie; i++){
-            pMG->Phi[k][j][i] = error[k][j][i]/(2.0/dx1sq + 2.0/dx2sq + 2.0/dx3sq);
+          for (i=is+((is+j+k+color)&1); i<=ie; i+=2){
+            Phi0[j][i] = diag*(c1*(Phi0[j][i+1] + Phi0[j][i-1])
+                             + c2*(Phi0[j+1][i] + Phi0[j-1][i])
+                             + c3*(Phip[j][i] + Phim[j][i]) - rhs[j][i]);
           }
         }
       }
@@ -414,27 +456,91 @@ void Jacobi(MGrid *pMG)
 #endif
     }
   }
+  if (pMG->corr) corr_bvals(pMG);
 
-/* Jacobi iterations in 2D (x-y plane) */
+  return;
+}
 
-  if (pMG->Nx3 == 1) {
-    for (n=0; n<=10; n++){  /* hardwired to do 10 iterations */
-      for (j=js; j<=je; j++){
-        for (i=is; i<=ie; i++){
-          error[ks][j][i] = -pMG->rhs[ks][j][i];
-          error[ks][j][i] += (pMG->Phi[ks][j][i+1] + pMG->Phi[ks][j][i-1])/dx1sq;
-          error[ks][j][i] += (pMG->Phi[ks][j+1][i] + pMG->Phi[ks][j-1][i])/dx2sq;
-        }
-      }
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real residual(const MGrid *pMG, const int k, const int j,
+ *                           const int i)
+ *  \brief Returns the residual rhs - Laplacian(Phi) in cell i,j,k
+ */
 
-      for (j=js; j<=je; j++){
-        for (i=is; i<=ie; i++){
-          pMG->Phi[ks][j][i] = error[ks][j][i]/(2.0/dx1sq + 2.0/dx2sq);
-        }
+static Real residual(const MGrid *pMG, const int k, const int j, const int i)
+{
+  Real ***Phi = pMG->Phi;
+  Real res;
+
+  res = pMG->rhs[k][j][i];
+  res -= (Phi[k][j][i+1] + Phi[k][j][i-1] - 2.0*Phi[k][j][i])
+    /(pMG->dx1*pMG->dx1);
+  res -= (Phi[k][j+1][i] + Phi[k][j-1][i] - 2.0*Phi[k][j][i])
+    /(pMG->dx2*pMG->dx2);
+  if (pMG->Nx3 > 1)
+    res -= (Phi[k+1][j][i] + Phi[k-1][j][i] - 2.0*Phi[k][j][i])
+      /(pMG->dx3*pMG->dx3);
+
+  return res;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real residual_norm(const MGrid *pMG)
+ *  \brief Returns the RMS residual over all cells of level pMG
+ */
+
+static Real residual_norm(const MGrid *pMG)
+{
+  int i, j, k;
+  long ncell = (long)pMG->Nx1*pMG->Nx2*pMG->Nx3;
+  Real res, sum = 0.0;
+#ifdef MPI_PARALLEL
+  Real my_sum;
+  long my_ncell;
+#endif
+
+  for (k=pMG->ks; k<=pMG->ke; k++){
+    for (j=pMG->js; j<=pMG->je; j++){
+      for (i=pMG->is; i<=pMG->ie; i++){
+        res = residual(pMG,k,j,i);
+        sum += res*res;
       }
+    }
+  }
 #ifdef MPI_PARALLEL
-      set_mg_bvals(pMG);
+  my_sum = sum;
+  my_ncell = ncell;
+  MPI_Allreduce(&my_sum, &sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(&my_ncell, &ncell, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
 #endif
+
+  return sqrt(sum/(Real)ncell);
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void Restrict_rhs_3d(const MGrid *pMG_fine, MGrid *pMG_coarse)
+ *  \brief Averages RHS of fine level onto coarse level
+ */
+
+static void Restrict_rhs_3d(const MGrid *pMG_fine, MGrid *pMG_coarse)
+{
+  int i, j, k, ii, jj, kk;
+  int f1 = pMG_fine->Nx1/pMG_coarse->Nx1;
+  int f2 = pMG_fine->Nx2/pMG_coarse->Nx2;
+  int f3 = pMG_fine->Nx3/pMG_coarse->Nx3;
+  Real sum, vol = 1.0/(Real)(f1*f2*f3);
+
+  for (k=pMG_coarse->ks; k<=pMG_coarse->ke; k++){
+    for (j=pMG_coarse->js; j<=pMG_coarse->je; j++){
+      for (i=pMG_coarse->is; i<=pMG_coarse->ie; i++){
+        sum = 0.0;
+        for (kk=f3*k-f3+1; kk<=f3*k; kk++){
+        for (jj=f2*j-f2+1; jj<=f2*j; jj++){
+        for (ii=f1*i-f1+1; ii<=f1*i; ii++){
+          sum += pMG_fine->rhs[kk][jj][ii];
+        }}}
+        pMG_coarse->rhs[k][j][i] = sum*vol;
+      }
     }
   }
 
@@ -442,46 +548,79 @@ void Jacobi(MGrid *pMG)
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse) 
- *  \brief Averages fine grid solution onto coarse
+/*! \fn static void Restrict_res_3d(const MGrid *pMG_fine, MGrid *pMG_coarse)
+ *  \brief Averages residual of fine level onto RHS of coarse level, and zeros
+ *   the solution on the coarse level (including ghost zones)
  */
 
-void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse)
+static void Restrict_res_3d(const MGrid *pMG_fine, MGrid *pMG_coarse)
 {
-  int i, is = pMG_fine->is, ie = pMG_fine->ie;
-  int j, js = pMG_fine->js, je = pMG_fine->je;
-  int k, ks = pMG_fine->ks, ke = pMG_fine->ke;
-  Real dx1sq = (pMG_fine->dx1*pMG_fine->dx1);
-  Real dx2sq = (pMG_fine->dx2*pMG_fine->dx2);
-  Real dx3sq = (pMG_fine->dx3*pMG_fine->dx3);
-
-  for (k=ks; k<=ke; k++){
-    for (j=js; j<=je; j++){
-      for (i=is; i<=ie; i++){
-        error[k][j][i] = pMG_fine->rhs[k][j][i];
-        error[k][j][i] -= (pMG_fine->Phi[k][j][i+1] + pMG_fine->Phi[k][j][i-1]
-          - 2.0*pMG_fine->Phi[k][j][i]) / dx1sq;
-        error[k][j][i] -= (pMG_fine->Phi[k][j+1][i] + pMG_fine->Phi[k][j-1][i]
-          - 2.0*pMG_fine->Phi[k][j][i]) / dx2sq;
-        error[k][j][i] -= (pMG_fine->Phi[k+1][j][i] + pMG_fine->Phi[k-1][j][i]
-          - 2.0*pMG_fine->Phi[k][j][i]) / dx3sq;
+  int i, j, k, ii, jj, kk;
+  int f1 = pMG_fine->Nx1/pMG_coarse->Nx1;
+  int f2 = pMG_fine->Nx2/pMG_coarse->Nx2;
+  int f3 = pMG_fine->Nx3/pMG_coarse->Nx3;
+  Real sum, vol = 1.0/(Real)(f1*f2*f3);
+
+  for (k=pMG_coarse->ks; k<=pMG_coarse->ke; k++){
+    for (j=pMG_coarse->js; j<=pMG_coarse->je; j++){
+      for (i=pMG_coarse->is; i<=pMG_coarse->ie; i++){
+        sum = 0.0;
+        for (kk=f3*k-f3+1; kk<=f3*k; kk++){
+        for (jj=f2*j-f2+1; jj<=f2*j; jj++){
+        for (ii=f1*i-f1+1; ii<=f1*i; ii++){
+          sum += residual(pMG_fine,kk,jj,ii);
+        }}}
+        pMG_coarse->rhs[k][j][i] = sum*vol;
       }
     }
   }
 
-  for(k=ks; k<=pMG_coarse->ke; k++){
-    for (j=js; j<=pMG_coarse->je; j++){
-      for (i=is; i<=pMG_coarse->ie; i++){
-        pMG_coarse->Phi[k][j][i] =
-          (pMG_fine->Phi[2*k  ][2*j  ][2*i] + pMG_fine->Phi[2*k  ][2*j  ][2*i-1]
-         + pMG_fine->Phi[2*k  ][2*j-1][2*i] + pMG_fine->Phi[2*k  ][2*j-1][2*i-1]
-         + pMG_fine->Phi[2*k-1][2*j  ][2*i] + pMG_fine->Phi[2*k-1][2*j  ][2*i-1]
-         + pMG_fine->Phi[2*k-1][2*j-1][2*i] + pMG_fine->Phi[2*k-1][2*j-1][2*i-1])/8.0 ;
-        pMG_coarse->rhs[k][j][i] =
-           (error[2*k  ][2*j  ][2*i] + error[2*k  ][2*j  ][2*i-1]
-          + error[2*k  ][2*j-1][2*i] + error[2*k  ][2*j-1][2*i-1]
-          + error[2*k-1][2*j  ][2*i] + error[2*k-1][2*j  ][2*i-1]
-          + error[2*k-1][2*j-1][2*i] + error[2*k-1][2*j-1][2*i-1])/8.0 ;
+  memset(&(pMG_coarse->Phi[0][0][0]), 0, (pMG_coarse->Nx3+2)*
+    (pMG_coarse->Nx2+2)*(pMG_coarse->Nx1+2)*sizeof(Real));
+  pMG_coarse->corr = 1;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void Prolong_3d(const MGrid *pMG_coarse, MGrid *pMG_fine,
+ *                             const int add)
+ *  \brief Linear interpolation of coarse level onto fine.  If add=1 the
+ *   result is added to the fine level solution, otherwise it replaces it.
+ *   Uses the ghost zones of the coarse level.
+ */
+
+static void Prolong_3d(const MGrid *pMG_coarse, MGrid *pMG_fine, const int add)
+{
+  int i, j, k, ic, jc, kc, oi, oj, ok;
+  int f1 = pMG_fine->Nx1/pMG_coarse->Nx1;
+  int f2 = pMG_fine->Nx2/pMG_coarse->Nx2;
+  int f3 = pMG_fine->Nx3/pMG_coarse->Nx3;
+  Real wi0, wi1, wj0, wj1, wk0, wk1, p;
+  Real ***C = pMG_coarse->Phi;
+
+/* Each fine cell takes 3/4 of the coarse cell containing it and 1/4 of the
+ * coarse neighbor on its side, in each direction that has been coarsened */
+
+  wi0 = (f1 == 2) ? 0.75 : 1.0;  wi1 = 1.0 - wi0;
+  wj0 = (f2 == 2) ? 0.75 : 1.0;  wj1 = 1.0 - wj0;
+  wk0 = (f3 == 2) ? 0.75 : 1.0;  wk1 = 1.0 - wk0;
+
+  for (k=pMG_fine->ks; k<=pMG_fine->ke; k++){
+    kc = (k + f3 - 1)/f3;
+    ok = (f3 == 2) ? ((k & 1) ? -1 : 1) : 0;
+    for (j=pMG_fine->js; j<=pMG_fine->je; j++){
+      jc = (j + f2 - 1)/f2;
+      oj = (f2 == 2) ? ((j & 1) ? -1 : 1) : 0;
+      for (i=pMG_fine->is; i<=pMG_fine->ie; i++){
+        ic = (i + f1 - 1)/f1;
+        oi = (f1 == 2) ? ((i & 1) ? -1 : 1) : 0;
+        p = wk0*(wj0*(wi0*C[kc   ][jc   ][ic] + wi1*C[kc   ][jc   ][ic+oi])
+               + wj1*(wi0*C[kc   ][jc+oj][ic] + wi1*C[kc   ][jc+oj][ic+oi]))
+          + wk1*(wj0*(wi0*C[kc+ok][jc   ][ic] + wi1*C[kc+ok][jc   ][ic+oi])
+               + wj1*(wi0*C[kc+ok][jc+oj][ic] + wi1*C[kc+ok][jc+oj][ic+oi]));
+        if (add) pMG_fine->Phi[k][j][i] += p;
+        else     pMG_fine->Phi[k][j][i]  = p;
       }
     }
   }
@@ -490,50 +629,137 @@ void Restriction_3d(MGrid *pMG_fine, MGrid *pMG_coarse)
 }
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void Prolongation_3d(MGrid *pMG_coarse, MGrid *pMG_fine)
- *  \brief Linear interpolation of coarse grid onto fine  
+/*! \fn static Real monopole(const MGrid *pMG, const int k, const int j,
+ *                           const int i)
+ *  \brief Returns the monopole potential at the center of cell i,j,k
  */
-void Prolongation_3d(MGrid *pMG_coarse, MGrid *pMG_fine)
-{
-  int i, is = pMG_coarse->is, ie = pMG_coarse->ie;
-  int j, js = pMG_coarse->js, je = pMG_coarse->je;
-  int k, ks = pMG_coarse->ks, ke = pMG_coarse->ke;
 
-  for (k=ks; k<=ke; k++){
-  for (j=js; j<=je; j++){
-    for (i=is; i<=ie; i++){
-      pMG_fine->Phi[2*k  ][2*j  ][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j  ][2*i  ] += 0.25*pMG_coarse->Phi[k+1][j+1][i+1];
+static Real monopole(const MGrid *pMG, const int k, const int j, const int i)
+{
+  Real x1 = pMG->MinX[0] + ((Real)i - 0.5)*pMG->dx1;
+  Real x2 = pMG->MinX[1] + ((Real)j - 0.5)*pMG->dx2;
+  Real x3 = pMG->MinX[2] + ((Real)k - 0.5)*pMG->dx3;
 
-      pMG_fine->Phi[2*k  ][2*j  ][2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j  ][2*i-1] += 0.25*pMG_coarse->Phi[k+1][j+1][i-1];
+  return -mg_GM/sqrt(x1*x1 + x2*x2 + x3*x3);
+}
 
-      pMG_fine->Phi[2*k  ][2*j-1][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j-1][2*i  ] += 0.25*pMG_coarse->Phi[k+1][j-1][i+1];
+/*----------------------------------------------------------------------------*/
+/*! \fn static void monopole_bvals(MGrid *pMG)
+ *  \brief Sets the potential in the ghost zones at physical boundaries of a
+ *   coarse level from the monopole expansion, as on the finest level
+ */
 
-      pMG_fine->Phi[2*k-1][2*j  ][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j  ][2*i  ] += 0.25*pMG_coarse->Phi[k-1][j+1][i+1];
+static void monopole_bvals(MGrid *pMG)
+{
+  int i, j, k;
+  int il = pMG->is-1, iu = pMG->ie+1;
+  int jl = pMG->js-1, ju = pMG->je+1;
+  int kl = pMG->ks-1, ku = pMG->ke+1;
 
-      pMG_fine->Phi[2*k  ][2*j-1][2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k  ][2*j-1][2*i-1] += 0.25*pMG_coarse->Phi[k+1][j-1][i-1];
+  pMG->corr = 0;
+  for (k=kl; k<=ku; k++){
+    for (j=jl; j<=ju; j++){
+      if (pMG->lx1_id < 0) pMG->Phi[k][j][il] = monopole(pMG,k,j,il);
+      if (pMG->rx1_id < 0) pMG->Phi[k][j][iu] = monopole(pMG,k,j,iu);
+    }
+  }
+  for (k=kl; k<=ku; k++){
+    for (i=il; i<=iu; i++){
+      if (pMG->lx2_id < 0) pMG->Phi[k][jl][i] = monopole(pMG,k,jl,i);
+      if (pMG->rx2_id < 0) pMG->Phi[k][ju][i] = monopole(pMG,k,ju,i);
+    }
+  }
+  if (pMG->Nx3 > 1) {
+    for (j=jl; j<=ju; j++){
+      for (i=il; i<=iu; i++){
+        if (pMG->lx3_id < 0) pMG->Phi[kl][j][i] = monopole(pMG,kl,j,i);
+        if (pMG->rx3_id < 0) pMG->Phi[ku][j][i] = monopole(pMG,ku,j,i);
+      }
+    }
+  }
 
-      pMG_fine->Phi[2*k-1][2*j-1][2*i  ] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j-1][2*i  ] += 0.25*pMG_coarse->Phi[k-1][j-1][i+1];
+  return;
+}
 
-      pMG_fine->Phi[2*k-1][2*j]  [2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j]  [2*i-1] += 0.25*pMG_coarse->Phi[k-1][j+1][i-1];
+/*----------------------------------------------------------------------------*/
+/*! \fn static void corr_bvals(MGrid *pMG)
+ *  \brief Sets the correction in the ghost zones at physical boundaries of a
+ *   coarse level.  The potential is fixed at the centers of the ghost zones of
+ *   the finest level, so the correction is extrapolated linearly to zero
+ *   there, rather than at the (further) centers of the coarse ghost zones.
+ *   Edges and corners are filled by doing x1, x2 and x3 in turn.
+ */
 
-      pMG_fine->Phi[2*k-1][2*j-1][2*i-1] += 0.75*pMG_coarse->Phi[k  ][j  ][i  ];
-      pMG_fine->Phi[2*k-1][2*j-1][2*i-1] += 0.25*pMG_coarse->Phi[k-1][j-1][i-1];
+static void corr_bvals(MGrid *pMG)
+{
+  int i, j, k;
+  int il = pMG->is-1, iu = pMG->ie+1;
+  int jl = pMG->js-1, ju = pMG->je+1;
+  int kl = pMG->ks-1, ku = pMG->ke+1;
+  Real ***Phi = pMG->Phi;
+
+  for (k=pMG->ks; k<=pMG->ke; k++){
+    for (j=pMG->js; j<=pMG->je; j++){
+      if (pMG->lx1_id < 0) Phi[k][j][il] = -pMG->bfac[0]*Phi[k][j][il+1];
+      if (pMG->rx1_id < 0) Phi[k][j][iu] = -pMG->bfac[0]*Phi[k][j][iu-1];
+    }
+  }
+  for (k=pMG->ks; k<=pMG->ke; k++){
+    for (i=il; i<=iu; i++){
+      if (pMG->lx2_id < 0) Phi[k][jl][i] = -pMG->bfac[1]*Phi[k][jl+1][i];
+      if (pMG->rx2_id < 0) Phi[k][ju][i] = -pMG->bfac[1]*Phi[k][ju-1][i];
+    }
+  }
+  if (pMG->Nx3 > 1) {
+    for (j=jl; j<=ju; j++){
+      for (i=il; i<=iu; i++){
+        if (pMG->lx3_id < 0) Phi[kl][j][i] = -pMG->bfac[2]*Phi[kl+1][j][i];
+        if (pMG->rx3_id < 0) Phi[ku][j][i] = -pMG->bfac[2]*Phi[ku-1][j][i];
+      }
     }
-  }}
+  }
 
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static int coarsen_level(const MGrid *pMG_fine, MGrid *pMG_coarse)
+ *  \brief Sets size and cell spacing of the next coarser level, and returns
+ *   the number of directions coarsened.  A direction is coarsened by a factor
+ *   of two if it has an even number of cells, at least 4, and its cell size
+ *   is less than 1.5 times the smallest, so that cells become less elongated
+ *   and point smoothing remains effective.
+ */
+
+static int coarsen_level(const MGrid *pMG_fine, MGrid *pMG_coarse)
+{
+  int n, N[3], nc=0;
+  Real dx[3], dxmin=HUGE_NUMBER;
+
+  N[0] = pMG_fine->Nx1;  dx[0] = pMG_fine->dx1;
+  N[1] = pMG_fine->Nx2;  dx[1] = pMG_fine->dx2;
+  N[2] = pMG_fine->Nx3;  dx[2] = pMG_fine->dx3;
+  for (n=0; n<3; n++){
+    if (N[n] > 1) dxmin = MIN(dxmin, dx[n]);
+  }
+  for (n=0; n<3; n++){
+    if (N[n] >= 4 && N[n]%2 == 0 && dx[n] < 1.5*dxmin) {
+      N[n] /= 2;
+      dx[n] *= 2.0;
+      nc++;
+    }
+  }
+
+  pMG_coarse->Nx1 = N[0];  pMG_coarse->dx1 = dx[0];
+  pMG_coarse->Nx2 = N[1];  pMG_coarse->dx2 = dx[1];
+  pMG_coarse->Nx3 = N[2];  pMG_coarse->dx3 = dx[2];
+
+  return nc;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void set_mg_bvals(MGrid *pMG)
- *  \brief Sets BC for Jacobi iterates for MPI parallel jobs.
+ *  \brief Sets BC for smoothing iterates for MPI parallel jobs.
  *
  *   With self-gravity using multigrid, the boundary conditions at the edge of
  *   the Domain are held fixed.  So only ghostzones associated with internal
@@ -1036,8 +1262,9 @@ void swap_mg_ox3(MGrid *pMG, int cnt, int swap_flag, MPI_Request *prq)
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void selfg_multig_3d_init(MeshS *pM)
- *  \brief Initialize send/receive buffers needed to swap
- *   iterates during Jacobi iterations.
+ *  \brief Reads parameters of the solver, allocates the hierarchy of levels,
+ *   and initializes send/receive buffers needed to swap iterates during
+ *   smoothing.
  */
 
 void selfg_multig_3d_init(MeshS *pM)
@@ -1047,31 +1274,55 @@ void selfg_multig_3d_init(MeshS *pM)
   int nx1t,nx2t,nx3t, size;
   int NGrid_x1, NGrid_x2, NGrid_x3;
 #endif
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
-
-/* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
-  for (nl=0; nl<(pM->NLevels); nl++){
-    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-      if (pM->Domain[nl][nd].Grid != NULL) {
-        if (pM->Domain[nl][nd].Grid->Nx[0] > size1){
-          size1 = pM->Domain[nl][nd].Grid->Nx[0];
-        }
-        if (pM->Domain[nl][nd].Grid->Nx[1] > size2){
-          size2 = pM->Domain[nl][nd].Grid->Nx[1];
-        }
-        if (pM->Domain[nl][nd].Grid->Nx[2] > size3){
-          size3 = pM->Domain[nl][nd].Grid->Nx[2];
-        }
-      }
-    }
-  }
+  GridS *pG = pM->Domain[0][0].Grid;
+  MGrid *pMG, Root, Lev[2];
+  int nl;
+
+  mg_tol        = par_getd_def("gravity","mg_tol",1.0e-3);
+  mg_max_cycles = par_geti_def("gravity","mg_max_cycles",2);
+  mg_npre       = par_geti_def("gravity","mg_npre",2);
+  mg_npost      = par_geti_def("gravity","mg_npost",2);
+
+/* Count levels, then allocate and initialize them */
+
+  Root.Nx1 = pG->Nx[0];
+  Root.Nx2 = pG->Nx[1];
+  Root.Nx3 = pG->Nx[2];
+  Root.dx1 = pG->dx1;
+  Root.dx2 = pG->dx2;
+  Root.dx3 = pG->dx3;
+  Lev[0] = Root;
+  NMGLev = 1;
+  while (coarsen_level(&(Lev[(NMGLev-1)%2]), &(Lev[NMGLev%2]))) NMGLev++;
+
+  if ((MGLev = (MGrid*)calloc_1d_array(NMGLev,sizeof(MGrid))) == NULL)
+    ath_error("[selfg_multig_3d_init]: Error allocating memory for levels\n");
+
+  MGLev[0] = Root;
+  for (nl=0; nl<NMGLev; nl++){
+    pMG = &(MGLev[nl]);
+    if (nl > 0) coarsen_level(&(MGLev[nl-1]), pMG);
+    pMG->is = 1;  pMG->ie = pMG->Nx1;
+    pMG->js = 1;  pMG->je = pMG->Nx2;
+    pMG->ks = 1;  pMG->ke = pMG->Nx3;
+    pMG->MinX[0] = pG->MinX[0];
+    pMG->MinX[1] = pG->MinX[1];
+    pMG->MinX[2] = pG->MinX[2];
+    pMG->bfac[0] = (pMG->dx1 - pG->dx1)/(pMG->dx1 + pG->dx1);
+    pMG->bfac[1] = (pMG->dx2 - pG->dx2)/(pMG->dx2 + pG->dx2);
+    pMG->bfac[2] = (pMG->dx3 - pG->dx3)/(pMG->dx3 + pG->dx3);
+    pMG->rx1_id = pG->rx1_id; pMG->lx1_id = pG->lx1_id;
+    pMG->rx2_id = pG->rx2_id; pMG->lx2_id = pG->lx2_id;
+    pMG->rx3_id = pG->rx3_id; pMG->lx3_id = pG->lx3_id;
+    pMG->corr = 0;
 
-  size1 += 2;
-  size2 += 2;
-  size3 += 2;
-  error = (Real ***)calloc_3d_array(size3, size2, size1, sizeof(Real));
-  if (error == NULL) {
-    ath_error("[multig_3d]: Error allocating memory for error array\n");
+/* There is only one ghost zone needed at each level, not nghost */
+    pMG->rhs = (Real***)calloc_3d_array(pMG->Nx3+2,pMG->Nx2+2,pMG->Nx1+2,
+      sizeof(Real));
+    pMG->Phi = (Real***)calloc_3d_array(pMG->Nx3+2,pMG->Nx2+2,pMG->Nx1+2,
+      sizeof(Real));
+    if (pMG->rhs == NULL || pMG->Phi == NULL)
+      ath_error("[selfg_multig_3d_init]: Error allocating level %d\n",nl);
   }
 
 /* Allocate memory for send and receive buffers for Phi in MultiGrid
@@ -1083,17 +1334,17 @@ void selfg_multig_3d_init(MeshS *pM)
   NGrid_x3 = par_geti("parallel","NGrid_x3");
 
   x1cnt = x2cnt = x3cnt = 0;
-        
+
   for (k=0; k<NGrid_x3; k++){
     for (j=0; j<NGrid_x2; j++){
       for (i=0; i<NGrid_x1; i++){
         if(NGrid_x1 > 1){
           nx2t = pD->grid_block[k][j][i].jde - pD->grid_block[k][j][i].jds + 1;
           nx3t = pD->grid_block[k][j][i].kde - pD->grid_block[k][j][i].kds + 1;
-        
+
           x1cnt = nx2t*nx3t > x1cnt ? nx2t*nx3t : x1cnt;
         }
-        
+
         if(NGrid_x2 > 1){
           nx1t = pD->grid_block[k][j][i].ide - pD->grid_block[k][j][i].ids + 1;
           if(nx1t > 1) nx1t += 2;
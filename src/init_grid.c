@@ -10,6 +10,9 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - init_grid()
+ * - init_grid_domain()   - initializes the Grid of one Domain on this processor
+ * - init_grid_overlaps() - finds overlaps between child and parent Grids (SMR)
+ * - free_grid_overlaps() - frees the overlaps of a Grid (SMR)
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - checkOverlap() - checks for overlap of cubes, and returns overlap coords
@@ -45,187 +48,196 @@ int checkOverlapTouch(SideS *pC1, SideS *pC2, SideS *pC3);
 
 void init_grid(MeshS *pM)
 {
-  DomainS *pD;
-  GridS *pG;
-  int nDim,nl,nd,myL,myM,myN;
-  int i,l,m,n,n1z,n2z,n3z;
-#ifdef STATIC_MESH_REFINEMENT
-  DomainS *pCD,*pPD;
-  SideS D1,D2,D3,G1,G2,G3;
-  int isDOverlap,isGOverlap,irefine,ncd,npd,dim,iGrid;
-  int ncg,nCG,nMyCG,nCB[6],nMyCB[6],nb;
-  int npg,nPG,nMyPG,nPB[6],nMyPB[6];
-  int n1r,n2r,n1p,n2p;
-#endif
-
-/* number of dimensions in Grid. */
-  nDim=1;
-  for (i=1; i<3; i++) if (pM->Nx[i]>1) nDim++;
+  int nl,nd;
 
 /* Loop over all levels and domains per level */
 
   for (nl=0; nl<pM->NLevels; nl++){
   for (nd=0; nd<pM->DomainsPerLevel[nl]; nd++){
-    if (pM->Domain[nl][nd].Grid != NULL) {
-      pD = (DomainS*)&(pM->Domain[nl][nd]);  /* set ptr to Domain */
-      pG = pM->Domain[nl][nd].Grid;          /* set ptr to Grid */
+    if (pM->Domain[nl][nd].Grid != NULL)
+      init_grid_domain(pM, &(pM->Domain[nl][nd]));
+  }}
+
+#ifdef STATIC_MESH_REFINEMENT
+  init_grid_overlaps(pM);
+#endif
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void init_grid_domain(MeshS *pM, DomainS *pD)
+ *  \brief Initializes the Grid of Domain pD updated on this processor, which
+ *   must have been allocated, from the layout of the Domain in pD->GData.
+ */
+
+void init_grid_domain(MeshS *pM, DomainS *pD)
+{
+  GridS *pG = pD->Grid;
+  int myL,myM,myN;
+  int l,m,n,n1z,n2z,n3z;
+#ifdef CYLINDRICAL
+  int i;
+#endif
 
-      pG->time = pM->time;
+  pG->time = pM->time;
+#ifdef FUSED_CFL
+  pG->cfl_set = 0;
+#endif
 
 /* get (l,m,n) coordinates of Grid being updated on this processor */
 
-      get_myGridIndex(pD, myID_Comm_world, &myL, &myM, &myN);
+  get_myGridIndex(pD, myID_Comm_world, &myL, &myM, &myN);
 
 /* ---------------------  Intialize grid in 1-direction --------------------- */
 /* Initialize is,ie,dx1
  * Compute Disp, MinX[0], and MaxX[0] using displacement of Domain and Grid
  * location within Domain */
 
-      pG->Nx[0] = pD->GData[myN][myM][myL].Nx[0];
+  pG->Nx[0] = pD->GData[myN][myM][myL].Nx[0];
+
+  if(pG->Nx[0] > 1) {
+    pG->is = nghost;
+    pG->ie = pG->Nx[0] + nghost - 1;
+  }
+  else
+    pG->is = pG->ie = 0;
+
+  pG->dx1 = pD->dx[0];
+
+  pG->Disp[0] = pD->Disp[0];
+  pG->MinX[0] = pD->MinX[0];
+  for (l=1; l<=myL; l++) {
+    pG->Disp[0] +=        pD->GData[myN][myM][l-1].Nx[0];
+    pG->MinX[0] += (Real)(pD->GData[myN][myM][l-1].Nx[0])*pG->dx1;
+  }
+  pG->MaxX[0] = pG->MinX[0] + (Real)(pG->Nx[0])*pG->dx1;
 
-      if(pG->Nx[0] > 1) {
-        pG->is = nghost;
-        pG->ie = pG->Nx[0] + nghost - 1;
-      }
-      else
-        pG->is = pG->ie = 0;
-    
-      pG->dx1 = pD->dx[0];
-    
-      pG->Disp[0] = pD->Disp[0];
-      pG->MinX[0] = pD->MinX[0];
-      for (l=1; l<=myL; l++) {
-        pG->Disp[0] +=        pD->GData[myN][myM][l-1].Nx[0];
-        pG->MinX[0] += (Real)(pD->GData[myN][myM][l-1].Nx[0])*pG->dx1;
-      }
-      pG->MaxX[0] = pG->MinX[0] + (Real)(pG->Nx[0])*pG->dx1;
-    
 /* ---------------------  Intialize grid in 2-direction --------------------- */
 /* Initialize js,je,dx2
  * Compute Disp, MinX[1], and MaxX[1] using displacement of Domain and Grid
  * location within Domain */
 
-      pG->Nx[1] = pD->GData[myN][myM][myL].Nx[1];
-    
-      if(pG->Nx[1] > 1) {
-        pG->js = nghost;
-        pG->je = pG->Nx[1] + nghost - 1;
-      }
-      else
-        pG->js = pG->je = 0;
-    
-      pG->dx2 = pD->dx[1];
-
-      pG->Disp[1] = pD->Disp[1];
-      pG->MinX[1] = pD->MinX[1];
-      for (m=1; m<=myM; m++) {
-        pG->Disp[1] +=        pD->GData[myN][m-1][myL].Nx[1];
-        pG->MinX[1] += (Real)(pD->GData[myN][m-1][myL].Nx[1])*pG->dx2;
-      }
-      pG->MaxX[1] = pG->MinX[1] + (Real)(pG->Nx[1])*pG->dx2;
+  pG->Nx[1] = pD->GData[myN][myM][myL].Nx[1];
+
+  if(pG->Nx[1] > 1) {
+    pG->js = nghost;
+    pG->je = pG->Nx[1] + nghost - 1;
+  }
+  else
+    pG->js = pG->je = 0;
+
+  pG->dx2 = pD->dx[1];
+
+  pG->Disp[1] = pD->Disp[1];
+  pG->MinX[1] = pD->MinX[1];
+  for (m=1; m<=myM; m++) {
+    pG->Disp[1] +=        pD->GData[myN][m-1][myL].Nx[1];
+    pG->MinX[1] += (Real)(pD->GData[myN][m-1][myL].Nx[1])*pG->dx2;
+  }
+  pG->MaxX[1] = pG->MinX[1] + (Real)(pG->Nx[1])*pG->dx2;
 
 /* ---------------------  Intialize grid in 3-direction --------------------- */
 /* Initialize ks,ke,dx3
  * Compute Disp, MinX[2], and MaxX[2] using displacement of Domain and Grid
  * location within Domain */
 
-      pG->Nx[2] = pD->GData[myN][myM][myL].Nx[2];
+  pG->Nx[2] = pD->GData[myN][myM][myL].Nx[2];
 
-      if(pG->Nx[2] > 1) {
-        pG->ks = nghost;
-        pG->ke = pG->Nx[2] + nghost - 1;
-      }
-      else
-        pG->ks = pG->ke = 0;
+  if(pG->Nx[2] > 1) {
+    pG->ks = nghost;
+    pG->ke = pG->Nx[2] + nghost - 1;
+  }
+  else
+    pG->ks = pG->ke = 0;
 
-      pG->dx3 = pD->dx[2];
+  pG->dx3 = pD->dx[2];
 
-      pG->Disp[2] = pD->Disp[2];
-      pG->MinX[2] = pD->MinX[2];
-      for (n=1; n<=myN; n++) {
-        pG->Disp[2] +=        pD->GData[n-1][myM][myL].Nx[2];
-        pG->MinX[2] += (Real)(pD->GData[n-1][myM][myL].Nx[2])*pG->dx3;
-      }
-      pG->MaxX[2] = pG->MinX[2] + (Real)(pG->Nx[2])*pG->dx3;
+  pG->Disp[2] = pD->Disp[2];
+  pG->MinX[2] = pD->MinX[2];
+  for (n=1; n<=myN; n++) {
+    pG->Disp[2] +=        pD->GData[n-1][myM][myL].Nx[2];
+    pG->MinX[2] += (Real)(pD->GData[n-1][myM][myL].Nx[2])*pG->dx3;
+  }
+  pG->MaxX[2] = pG->MinX[2] + (Real)(pG->Nx[2])*pG->dx3;
 
 /* ---------  Allocate 3D arrays to hold Cons based on size of grid --------- */
 
-      if (pG->Nx[0] > 1)
-        n1z = pG->Nx[0] + 2*nghost;
-      else
-        n1z = 1;
+  if (pG->Nx[0] > 1)
+    n1z = pG->Nx[0] + 2*nghost;
+  else
+    n1z = 1;
 
-      if (pG->Nx[1] > 1)
-        n2z = pG->Nx[1] + 2*nghost;
-      else
-        n2z = 1;
+  if (pG->Nx[1] > 1)
+    n2z = pG->Nx[1] + 2*nghost;
+  else
+    n2z = 1;
 
-      if (pG->Nx[2] > 1)
-        n3z = pG->Nx[2] + 2*nghost;
-      else
-        n3z = 1;
+  if (pG->Nx[2] > 1)
+    n3z = pG->Nx[2] + 2*nghost;
+  else
+    n3z = 1;
 
-/* Build a 3D array of type ConsS */
+/* Build a 3D array of type ConsS (or 3D arrays of each variable) */
+
+  if (calloc_grid_U(pG, n3z, n2z, n1z) != 0) goto on_error1;
 
-      pG->U = (ConsS***)calloc_3d_array(n3z, n2z, n1z, sizeof(ConsS));
-      if (pG->U == NULL) goto on_error1;
-    
 /* Build 3D arrays to hold interface field */
 
 #ifdef MHD
-      pG->B1i = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->B1i == NULL) goto on_error2;
+  pG->B1i = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->B1i == NULL) goto on_error2;
 
-      pG->B2i = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->B2i == NULL) goto on_error3;
+  pG->B2i = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->B2i == NULL) goto on_error3;
 
-      pG->B3i = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->B3i == NULL) goto on_error4;
+  pG->B3i = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->B3i == NULL) goto on_error4;
 #endif /* MHD */
 
 /* Build 3D arrays to magnetic diffusivities */
 
 #ifdef RESISTIVITY
-      pG->eta_Ohm = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->eta_Ohm == NULL) goto on_error5;
+  pG->eta_Ohm = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->eta_Ohm == NULL) goto on_error5;
 
-      pG->eta_Hall = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->eta_Hall == NULL) goto on_error6;
+  pG->eta_Hall = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->eta_Hall == NULL) goto on_error6;
 
-      pG->eta_AD = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->eta_AD == NULL) goto on_error7;
+  pG->eta_AD = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->eta_AD == NULL) goto on_error7;
 #endif /* RESISTIVITY */
 
 /* Build 3D arrays to gravitational potential and mass fluxes */
 
 #ifdef SELF_GRAVITY
-      pG->Phi = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->Phi == NULL) goto on_error9;
+  pG->Phi = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->Phi == NULL) goto on_error9;
 
-      pG->Phi_old = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->Phi_old == NULL) goto on_error10;
+  pG->Phi_old = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->Phi_old == NULL) goto on_error10;
 
-      pG->x1MassFlux = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->x1MassFlux == NULL) goto on_error11;
+  pG->x1MassFlux = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->x1MassFlux == NULL) goto on_error11;
 
-      pG->x2MassFlux = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->x2MassFlux == NULL) goto on_error12;
+  pG->x2MassFlux = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->x2MassFlux == NULL) goto on_error12;
 
-      pG->x3MassFlux = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
-      if (pG->x3MassFlux == NULL) goto on_error13;
+  pG->x3MassFlux = (Real***)calloc_3d_array(n3z, n2z, n1z, sizeof(Real));
+  if (pG->x3MassFlux == NULL) goto on_error13;
 #endif /* SELF_GRAVITY */
 
 /* Allocate and initialize cylindrical scaling factors */
 #ifdef CYLINDRICAL
-      pG->r = (Real*)calloc_1d_array(n1z, sizeof(Real));
-      if (pG->r == NULL) goto on_error14;
-
-      pG->ri = (Real*)calloc_1d_array(n1z, sizeof(Real));
-      if (pG->ri == NULL) goto on_error15;
-      for (i=pG->is-nghost; i<=pG->ie+nghost; i++) {
-        pG->ri[i] = pG->MinX[0] + ((Real)(i - pG->is))*pG->dx1;
-        pG->r[i]  = pG->ri[i] + 0.5*pG->dx1;
-      }
+  pG->r = (Real*)calloc_1d_array(n1z, sizeof(Real));
+  if (pG->r == NULL) goto on_error14;
+
+  pG->ri = (Real*)calloc_1d_array(n1z, sizeof(Real));
+  if (pG->ri == NULL) goto on_error15;
+  for (i=pG->is-nghost; i<=pG->ie+nghost; i++) {
+    pG->ri[i] = pG->MinX[0] + ((Real)(i - pG->is))*pG->dx1;
+    pG->r[i]  = pG->ri[i] + 0.5*pG->dx1;
+  }
 #endif /* CYLINDRICAL */
 
 
@@ -235,57 +247,118 @@ void init_grid(MeshS *pM)
  */
 
 /* Left-x1 */
-      if(myL > 0) pG->lx1_id = pD->GData[myN][myM][myL-1].ID_Comm_Domain;
-      else pG->lx1_id = -1;
+  if(myL > 0) pG->lx1_id = pD->GData[myN][myM][myL-1].ID_Comm_Domain;
+  else pG->lx1_id = -1;
 
 /* Right-x1 */
-      if(myL <(pD->NGrid[0])-1)
-        pG->rx1_id = pD->GData[myN][myM][myL+1].ID_Comm_Domain;
-      else pG->rx1_id = -1;
+  if(myL <(pD->NGrid[0])-1)
+    pG->rx1_id = pD->GData[myN][myM][myL+1].ID_Comm_Domain;
+  else pG->rx1_id = -1;
 
 /* Left-x2 */
-      if(myM > 0) pG->lx2_id = pD->GData[myN][myM-1][myL].ID_Comm_Domain;
-      else pG->lx2_id = -1;
+  if(myM > 0) pG->lx2_id = pD->GData[myN][myM-1][myL].ID_Comm_Domain;
+  else pG->lx2_id = -1;
 
 /* Right-x2 */
-      if(myM <(pD->NGrid[1])-1)
-        pG->rx2_id = pD->GData[myN][myM+1][myL].ID_Comm_Domain;
-      else pG->rx2_id = -1;
+  if(myM <(pD->NGrid[1])-1)
+    pG->rx2_id = pD->GData[myN][myM+1][myL].ID_Comm_Domain;
+  else pG->rx2_id = -1;
 
 /* Left-x3 */
-      if(myN > 0) pG->lx3_id = pD->GData[myN-1][myM][myL].ID_Comm_Domain;
-      else pG->lx3_id = -1;
+  if(myN > 0) pG->lx3_id = pD->GData[myN-1][myM][myL].ID_Comm_Domain;
+  else pG->lx3_id = -1;
 
 /* Right-x3 */
-      if(myN <(pD->NGrid[2])-1)
-        pG->rx3_id = pD->GData[myN+1][myM][myL].ID_Comm_Domain;
-      else pG->rx3_id = -1;
+  if(myN <(pD->NGrid[2])-1)
+    pG->rx3_id = pD->GData[myN+1][myM][myL].ID_Comm_Domain;
+  else pG->rx3_id = -1;
 
 #ifdef SELF_GRAVITY
-      pG->lx1_Gid=pG->lx1_id;
-      pG->rx1_Gid=pG->rx1_id;
-      pG->lx2_Gid=pG->lx2_id;
-      pG->rx2_Gid=pG->rx2_id;
-      pG->lx3_Gid=pG->lx3_id;
-      pG->rx3_Gid=pG->rx3_id;
+  pG->lx1_Gid=pG->lx1_id;
+  pG->rx1_Gid=pG->rx1_id;
+  pG->lx2_Gid=pG->lx2_id;
+  pG->rx2_Gid=pG->rx2_id;
+  pG->lx3_Gid=pG->lx3_id;
+  pG->rx3_Gid=pG->rx3_id;
 #endif
    
 #ifdef STATIC_MESH_REFINEMENT
 /*---------------------- Initialize variables for SMR ------------------------*/
 /* Number of child/parent grids, and data about overlap regions. */
 
-      pG->NCGrid = 0;
-      pG->NPGrid = 0;
-      pG->NmyCGrid = 0;  /* can be as large as # of child Domains */
-      pG->NmyPGrid = 0;  /* must be 0 or 1 */
-      pG->CGrid = NULL;
-      pG->PGrid = NULL;
+  pG->NCGrid = 0;
+  pG->NPGrid = 0;
+  pG->NmyCGrid = 0;  /* can be as large as # of child Domains */
+  pG->NmyPGrid = 0;  /* must be 0 or 1 */
+  pG->CGrid = NULL;
+  pG->PGrid = NULL;
 #endif
 
-    }
-  }}
+  return;
+
+/*--- Error messages ---------------------------------------------------------*/
+
+#ifdef CYLINDRICAL
+  on_error15:
+    free_1d_array(pG->ri);
+  on_error14:
+    free_1d_array(pG->r);
+#endif
+#ifdef SELF_GRAVITY
+  on_error13:
+    free_3d_array(pG->x3MassFlux);
+  on_error12:
+    free_3d_array(pG->x2MassFlux);
+  on_error11:
+    free_3d_array(pG->x1MassFlux);
+  on_error10:
+    free_3d_array(pG->Phi_old);
+  on_error9:
+    free_3d_array(pG->Phi);
+#endif
+#ifdef RESISTIVITY
+  on_error7:
+    free_3d_array(pG->eta_AD);
+  on_error6:
+    free_3d_array(pG->eta_Hall);
+  on_error5:
+    free_3d_array(pG->eta_Ohm);
+#endif
+#ifdef MHD
+  on_error4:
+    free_3d_array(pG->B3i);
+  on_error3:
+    free_3d_array(pG->B2i);
+  on_error2:
+    free_3d_array(pG->B1i);
+#endif
+  on_error1:
+    free_grid_U(pG);
+    ath_error("[init_grid_domain]: Error allocating memory\n");
+}
 
 #ifdef STATIC_MESH_REFINEMENT
+/*----------------------------------------------------------------------------*/
+/*! \fn void init_grid_overlaps(MeshS *pM)
+ *  \brief Finds all overlaps between child and parent Grids, and initializes
+ *   the CGrid and PGrid arrays used by the restriction, flux-correction, and
+ *   prolongation steps.
+ */
+
+void init_grid_overlaps(MeshS *pM)
+{
+  DomainS *pD,*pCD,*pPD;
+  GridS *pG;
+  SideS D1,D2,D3,G1,G2,G3;
+  int isDOverlap,isGOverlap,irefine,ncd,npd,dim,iGrid;
+  int ncg,nCG,nMyCG,nCB[6],nMyCB[6],nb;
+  int npg,nPG,nMyPG,nPB[6],nMyPB[6];
+  int n1r,n2r,n1p,n2p;
+  int nDim,nl,nd,myL,myM,myN,i,l,m,n,n1z,n2z,n3z;
+
+  nDim=1;
+  for (i=1; i<3; i++) if (pM->Nx[i]>1) nDim++;
+
 /*------------------- Count number of child Grids ----------------------------*/
 /* For each Grid, count the total number of child Grids before allocating the
  * CGrid array.  This way we know how many child Grids there are on the same
@@ -1085,52 +1158,59 @@ G3.ijkl[2],G3.ijkr[2]);
     } 
   }}
 
-#endif /* STATIC_MESH_REFINEMENT */
-
   return;
+}
 
-/*--- Error messages ---------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void free_grid_overlaps(GridS *pG)
+ *  \brief Frees the CGrid and PGrid arrays of a Grid set by
+ *   init_grid_overlaps(), so they can be found again after the Domains on a
+ *   level have been moved.
+ */
 
-#ifdef CYLINDRICAL
-  on_error15:
-    free_1d_array(pG->ri);
-  on_error14:
-    free_1d_array(pG->r);
-#endif
-#ifdef SELF_GRAVITY
-  on_error13:
-    free_3d_array(pG->x3MassFlux);
-  on_error12:
-    free_3d_array(pG->x2MassFlux);
-  on_error11:
-    free_3d_array(pG->x1MassFlux);
-  on_error10:
-    free_3d_array(pG->Phi_old);
-  on_error9:
-    free_3d_array(pG->Phi);
-#endif
-#ifdef RESISTIVITY
-  on_error7:
-    free_3d_array(pG->eta_AD);
-  on_error6:
-    free_3d_array(pG->eta_Hall);
-  on_error5:
-    free_3d_array(pG->eta_Ohm);
-#endif
+void free_grid_overlaps(GridS *pG)
+{
+  int n,dim;
+
+  for (n=0; n<pG->NCGrid; n++){
+    for (dim=0; dim<6; dim++){
+      if (pG->CGrid[n].myFlx[dim] != NULL) free_2d_array(pG->CGrid[n].myFlx[dim]);
 #ifdef MHD
-  on_error4:
-    free_3d_array(pG->B3i);
-  on_error3:
-    free_3d_array(pG->B2i);
-  on_error2:
-    free_3d_array(pG->B1i);
-#endif
-  on_error1:
-    free_3d_array(pG->U);
-    ath_error("[init_grid]: Error allocating memory\n");
+      if (pG->CGrid[n].myEMF1[dim] != NULL)
+        free_2d_array(pG->CGrid[n].myEMF1[dim]);
+      if (pG->CGrid[n].myEMF2[dim] != NULL)
+        free_2d_array(pG->CGrid[n].myEMF2[dim]);
+      if (pG->CGrid[n].myEMF3[dim] != NULL)
+        free_2d_array(pG->CGrid[n].myEMF3[dim]);
+#endif /* MHD */
+    }
+  }
+  for (n=0; n<pG->NPGrid; n++){
+    for (dim=0; dim<6; dim++){
+      if (pG->PGrid[n].myFlx[dim] != NULL) free_2d_array(pG->PGrid[n].myFlx[dim]);
+#ifdef MHD
+      if (pG->PGrid[n].myEMF1[dim] != NULL)
+        free_2d_array(pG->PGrid[n].myEMF1[dim]);
+      if (pG->PGrid[n].myEMF2[dim] != NULL)
+        free_2d_array(pG->PGrid[n].myEMF2[dim]);
+      if (pG->PGrid[n].myEMF3[dim] != NULL)
+        free_2d_array(pG->PGrid[n].myEMF3[dim]);
+#endif /* MHD */
+    }
+  }
+  if (pG->CGrid != NULL) free_1d_array(pG->CGrid);
+  if (pG->PGrid != NULL) free_1d_array(pG->PGrid);
+
+  pG->NCGrid = 0;
+  pG->NPGrid = 0;
+  pG->NmyCGrid = 0;
+  pG->NmyPGrid = 0;
+  pG->CGrid = NULL;
+  pG->PGrid = NULL;
+
+  return;
 }
 
-#ifdef STATIC_MESH_REFINEMENT
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 /*----------------------------------------------------------------------------*/
 /*! \fn int checkOverlap(SideS *pC1, SideS *pC2, SideS *pC3)
@@ -30,18 +30,41 @@
  *  - (3) divides each Domain into one or more Grids depending on the
  *        parallelization.
  *
+ *   With MPI the Grids of all Domains are assigned to processors in turn,
+ *   which requires the total number of Grids to be a multiple of the number
+ *   of processors.  With <job>/load_balance = 1 they are instead assigned by
+ *   cost with a greedy bin-packing, so that a processor with a large Grid on
+ *   one level gets fewer or smaller Grids on the others.  The cost of a Grid
+ *   is its number of cells, times 2^level with SMR_SUBCYCLE, times
+ *   <domainN>/cost (default 1.0), which can be set from the measured time
+ *   per cell of each Domain.  The ratio of the largest to the mean cost per
+ *   processor is reported at startup.
+ *
+ *   With AMR, the Grids of Domains on adaptive levels (<domainN>/adaptive = 1)
+ *   are left out of the above, and are then always assigned by cost, with the
+ *   Grids of the other levels kept where they are.  AMR_regrid() assigns the
+ *   Grids of the Domains it creates in the same way, so a restart reproduces
+ *   its layout.
+ *
  *   This function supercedes init_domain() from v3.2.
  *   The init_grid() function initializes the data in each Grid structure in 
  *   each Domain, including finding all child and parent Grids with SMR.
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - init_mesh()
+ * - divide_domain()
  * - get_myGridIndex()							      
+ * - init_comm_domain()   - creates the MPI communicator of a Domain
+ * - init_comm_children() - creates MPI communicators between levels
+ * - balance_grids()      - assigns Grids to processors by cost
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - dom_decomp()    - calls auto domain decomposition functions 
  * - dom_decomp_2d() - finds optimum domain decomposition in 2D 
- * - dom_decomp_3d() - finds optimum domain decomposition in 3D		      */
+ * - dom_decomp_3d() - finds optimum domain decomposition in 3D
+ * - grid_cost()      - returns the estimated cost of one Grid
+ * - cmp_cost()       - orders Grids by decreasing cost, for qsort()
+ * - grid_imbalance() - returns the load imbalance of the Grids		      */
 /*============================================================================*/
 
 #include <math.h>
@@ -51,11 +74,31 @@
 #include "globals.h"
 #include "prototypes.h"
 
+#ifdef MPI_PARALLEL
+/*! \struct GridCostS
+ *  \brief Estimated cost of one Grid, and its place in the Mesh: Grid [n][m][l]
+ *   of Domain[nl][nd], which is the dom-th Domain counting over all levels */
+typedef struct GridCost_s{
+  Real cost;
+  int nl,nd,dom,n,m,l;
+}GridCostS;
+#endif /* MPI_PARALLEL */
+
+/* 1 if the Grids of Domain pD are assigned by cost after the others (AMR) */
+#ifdef ADAPTIVE_MESH_REFINEMENT
+#define DOM_ADAPTIVE(pD) ((pD)->Adaptive)
+#else
+#define DOM_ADAPTIVE(pD) 0
+#endif
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
  *   dom_decomp()    - calls auto domain decomposition functions 
  *   dom_decomp_2d() - finds optimum domain decomposition in 2D 
  *   dom_decomp_3d() - finds optimum domain decomposition in 3D 
+ *   grid_cost()      - returns the estimated cost of one Grid
+ *   cmp_cost()       - orders Grids by decreasing cost, for qsort()
+ *   grid_imbalance() - returns the load imbalance of the Grids
  *============================================================================*/
 #ifdef MPI_PARALLEL
 /*! \fn static int dom_decomp(const int Nx, const int Ny, const int Nz,
@@ -75,6 +118,18 @@ static int dom_decomp_2d(const int Nx, const int Ny, const int Np,
  *  \brief finds optimum domain decomposition in 3D  */
 static int dom_decomp_3d(const int Nx, const int Ny, const int Nz, const int Np,
   int *pNGx, int *pNGy, int *pNGz);
+
+/*! \fn static Real grid_cost(DomainS *pD, GridsDataS *pG)
+ *  \brief returns the estimated cost of one Grid */
+static Real grid_cost(DomainS *pD, GridsDataS *pG);
+
+/*! \fn static int cmp_cost(const void *a, const void *b)
+ *  \brief orders Grids by decreasing cost, for qsort() */
+static int cmp_cost(const void *a, const void *b);
+
+/*! \fn static Real grid_imbalance(MeshS *pM, const int Np)
+ *  \brief returns the load imbalance of the Grids */
+static Real grid_imbalance(MeshS *pM, const int Np);
 #endif
 
 /*----------------------------------------------------------------------------*/
@@ -95,8 +150,7 @@ void init_mesh(MeshS *pM)
   SideS D1,D2;
   DomainS *pD, *pCD;
 #ifdef MPI_PARALLEL
-  int ierr,child_found,groupn,Nranks,Nranks0,max_rank,irank,*ranks;
-  MPI_Group world_group;
+  int ierr,load_balance;
 
 /* Get total # of processes, in MPI_COMM_WORLD */
   ierr = MPI_Comm_size(MPI_COMM_WORLD, &Nproc_Comm_world);
@@ -262,6 +316,9 @@ void init_mesh(MeshS *pM)
     pM->Domain[nl][nd].Level = nl;
     pM->Domain[nl][nd].DomNumber = nd;
     pM->Domain[nl][nd].InputBlock = nblock;
+#ifdef ADAPTIVE_MESH_REFINEMENT
+    pM->Domain[nl][nd].Adaptive = par_geti_def(block,"adaptive",0);
+#endif
 
     pM->Domain[nl][nd].Nx[0] = par_geti(block,"Nx1");
     pM->Domain[nl][nd].Nx[1] = par_geti(block,"Nx2");
@@ -544,94 +601,46 @@ void init_mesh(MeshS *pM)
         pD->NGrid[0],sizeof(GridsDataS))) == NULL) ath_error(
         "[init_mesh]: GData calloc returned a NULL pointer\n");
 
-/* Divide the domain into blocks */
-
-      for (i=0; i<3; i++) {
-        xdiv[i] = div(pD->Nx[i], pD->NGrid[i]);
-      }
-
-/* Distribute cells in Domain to Grids.  Assign each Grid to a processor ID in
- * the MPI_COMM_WORLD communicator.  For single-processor jobs, there is only
- * one ID=0, and the GData array will have only one element. */
+/* Assign each Grid to a processor ID in the MPI_COMM_WORLD communicator.  For
+ * single-processor jobs, there is only one ID=0, and the GData array will have
+ * only one element.  Grids of adaptive Domains are assigned below. */
 
       for(n=0; n<(pD->NGrid[2]); n++){
       for(m=0; m<(pD->NGrid[1]); m++){
       for(l=0; l<(pD->NGrid[0]); l++){
-        for (i=0; i<3; i++) pD->GData[n][m][l].Nx[i] = xdiv[i].quot;
+        if (DOM_ADAPTIVE(pD)) continue;
         pD->GData[n][m][l].ID_Comm_world = next_procID++;
         if (next_procID > ((Nproc_Comm_world)-1)) next_procID=0;
       }}}
 
-/* If the Domain is not evenly divisible put the extra cells on the first
- * Grids in each direction, maintaining the load balance as much as possible */
-
-      for(n=0; n<(pD->NGrid[2]); n++){
-        for(m=0; m<(pD->NGrid[1]); m++){
-          for(l=0; l<xdiv[0].rem; l++){
-            pD->GData[n][m][l].Nx[0]++;
-          }
-        }
-      }
-      xdiv[0].rem=0;
+/* Divide the Domain into Grids */
 
-      for(n=0; n<(pD->NGrid[2]); n++){
-        for(m=0; m<xdiv[1].rem; m++) {
-          for(l=0; l<(pD->NGrid[0]); l++){
-            pD->GData[n][m][l].Nx[1]++;
-          }
-        }
-      }
-      xdiv[1].rem=0;
-
-      for(n=0; n<xdiv[2].rem; n++){
-        for(m=0; m<(pD->NGrid[1]); m++){
-          for(l=0; l<(pD->NGrid[0]); l++){
-            pD->GData[n][m][l].Nx[2]++;
-          }
-        }
-      }
-      xdiv[2].rem=0;
-
-/* Initialize displacements from origin for each Grid */
-
-      for(n=0; n<(pD->NGrid[2]); n++){
-        for(m=0; m<(pD->NGrid[1]); m++){
-          pD->GData[n][m][0].Disp[0] = pD->Disp[0];
-          for(l=1; l<(pD->NGrid[0]); l++){
-            pD->GData[n][m][l].Disp[0] = pD->GData[n][m][l-1].Disp[0] + 
-                                         pD->GData[n][m][l-1].Nx[0];
-          }
-        }
-      }
-
-      for(n=0; n<(pD->NGrid[2]); n++){
-        for(l=0; l<(pD->NGrid[0]); l++){
-          pD->GData[n][0][l].Disp[1] = pD->Disp[1];
-          for(m=1; m<(pD->NGrid[1]); m++){
-            pD->GData[n][m][l].Disp[1] = pD->GData[n][m-1][l].Disp[1] + 
-                                         pD->GData[n][m-1][l].Nx[1];
-          }
-        }
-      }
-
-      for(m=0; m<(pD->NGrid[1]); m++){
-        for(l=0; l<(pD->NGrid[0]); l++){
-          pD->GData[0][m][l].Disp[2] = pD->Disp[2];
-          for(n=1; n<(pD->NGrid[2]); n++){
-            pD->GData[n][m][l].Disp[2] = pD->GData[n-1][m][l].Disp[2] + 
-                                         pD->GData[n-1][m][l].Nx[2];
-          }
-        }
-      }
+      divide_domain(pD);
 
     }  /* end loop over ndomains */
   }    /* end loop over nlevels */
 
 /* check that total number of Grids was partitioned evenly over total number of
- * MPI processes available (equal to one for single processor jobs) */ 
+ * MPI processes available (equal to one for single processor jobs), or assign
+ * the Grids by cost instead */ 
 
+#ifdef MPI_PARALLEL
+  load_balance = par_geti_def("job","load_balance",0);
+  if (load_balance != 0) {
+    balance_grids(pM, 0);
+  } else
+#endif
   if (next_procID != 0)
     ath_error("[init_mesh]:total # of Grids != total # of MPI procs\n");
+#if defined(MPI_PARALLEL) && defined(ADAPTIVE_MESH_REFINEMENT)
+  balance_grids(pM, 1);
+#endif
+
+#ifdef MPI_PARALLEL
+  if (load_balance != 0)
+    ath_pout(0,"[init_mesh]: load imbalance (max/mean cost per processor) = %g\n",
+      grid_imbalance(pM, Nproc_Comm_world));
+#endif
 
 /*--- Step 7: Allocate a Grid for each Domain on this processor --------------*/
 
@@ -658,53 +667,193 @@ void init_mesh(MeshS *pM)
 /*--- Step 8: Create an MPI Communicator for each Domain ---------------------*/
 
 #ifdef MPI_PARALLEL
-/* Allocate memory for ranks[] array */
-
-  max_rank = 0;
   for (nl=0; nl<=maxlevel; nl++){
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-    pD = (DomainS*)&(pM->Domain[nl][nd]);  /* set ptr to this Domain */
-    Nranks = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
-    max_rank = MAX(max_rank, Nranks);
-  }}
-  ranks = (int*)calloc_1d_array(max_rank,sizeof(int));
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      init_comm_domain(&(pM->Domain[nl][nd]));
+    }
+  }
+#endif /* MPI_PARALLEL */
 
-/* Extract handle of group defined by MPI_COMM_WORLD communicator */
+/*--- Step 9: Create MPI Communicators for Child and Parent Domains ----------*/
 
-  ierr = MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+#if defined(MPI_PARALLEL) && defined(STATIC_MESH_REFINEMENT)
+  init_comm_children(pM);
+#endif /* MPI_PARALLEL & STATIC_MESH_REFINEMENT  */
 
-  for (nl=0; nl<=maxlevel; nl++){
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-    pD = (DomainS*)&(pM->Domain[nl][nd]);  /* set ptr to this Domain */
+  free(next_domainid);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void divide_domain(DomainS *pD)
+ *  \brief Divides the cells of a Domain between its NGrid[0]xNGrid[1]xNGrid[2]
+ *   Grids, setting the size and displacement of each Grid in GData.  Extra
+ *   cells go to the first Grids in each direction. */
+
+void divide_domain(DomainS *pD)
+{
+  int i,l,m,n;
+  div_t xdiv[3];  /* divisor with quot and rem members */
+
+  for (i=0; i<3; i++) {
+    xdiv[i] = div(pD->Nx[i], pD->NGrid[i]);
+  }
+
+/* Distribute cells in Domain to Grids */
+
+  for(n=0; n<(pD->NGrid[2]); n++){
+  for(m=0; m<(pD->NGrid[1]); m++){
+  for(l=0; l<(pD->NGrid[0]); l++){
+    for (i=0; i<3; i++) pD->GData[n][m][l].Nx[i] = xdiv[i].quot;
+  }}}
+
+/* If the Domain is not evenly divisible put the extra cells on the first
+ * Grids in each direction, maintaining the load balance as much as possible */
+
+  for(n=0; n<(pD->NGrid[2]); n++){
+    for(m=0; m<(pD->NGrid[1]); m++){
+      for(l=0; l<xdiv[0].rem; l++){
+        pD->GData[n][m][l].Nx[0]++;
+      }
+    }
+  }
+  xdiv[0].rem=0;
+
+  for(n=0; n<(pD->NGrid[2]); n++){
+    for(m=0; m<xdiv[1].rem; m++) {
+      for(l=0; l<(pD->NGrid[0]); l++){
+        pD->GData[n][m][l].Nx[1]++;
+      }
+    }
+  }
+  xdiv[1].rem=0;
+
+  for(n=0; n<xdiv[2].rem; n++){
+    for(m=0; m<(pD->NGrid[1]); m++){
+      for(l=0; l<(pD->NGrid[0]); l++){
+        pD->GData[n][m][l].Nx[2]++;
+      }
+    }
+  }
+  xdiv[2].rem=0;
+
+/* Initialize displacements from origin for each Grid */
+
+  for(n=0; n<(pD->NGrid[2]); n++){
+    for(m=0; m<(pD->NGrid[1]); m++){
+      pD->GData[n][m][0].Disp[0] = pD->Disp[0];
+      for(l=1; l<(pD->NGrid[0]); l++){
+        pD->GData[n][m][l].Disp[0] = pD->GData[n][m][l-1].Disp[0] + 
+                                     pD->GData[n][m][l-1].Nx[0];
+      }
+    }
+  }
+
+  for(n=0; n<(pD->NGrid[2]); n++){
+    for(l=0; l<(pD->NGrid[0]); l++){
+      pD->GData[n][0][l].Disp[1] = pD->Disp[1];
+      for(m=1; m<(pD->NGrid[1]); m++){
+        pD->GData[n][m][l].Disp[1] = pD->GData[n][m-1][l].Disp[1] + 
+                                     pD->GData[n][m-1][l].Nx[1];
+      }
+    }
+  }
+
+  for(m=0; m<(pD->NGrid[1]); m++){
+    for(l=0; l<(pD->NGrid[0]); l++){
+      pD->GData[0][m][l].Disp[2] = pD->Disp[2];
+      for(n=1; n<(pD->NGrid[2]); n++){
+        pD->GData[n][m][l].Disp[2] = pD->GData[n-1][m][l].Disp[2] + 
+                                     pD->GData[n-1][m][l].Nx[2];
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void get_myGridIndex(DomainS *pD, const int myID, int *pi, 
+ *			     int *pj, int *pk)
+ *  \brief Searches GData[][][] array to find i,j,k components
+ *   of block being updated on this processor.  */
+
+void get_myGridIndex(DomainS *pD, const int myID,
+                     int *pi, int *pj, int *pk)
+{
+  int i, j, k;
+  for (k=0; k<(pD->NGrid[2]); k++){
+    for (j=0; j<(pD->NGrid[1]); j++){
+      for (i=0; i<(pD->NGrid[0]); i++){
+        if (pD->GData[k][j][i].ID_Comm_world == myID) {
+          *pi = i;  *pj = j;  *pk = k;
+          return;
+        }
+      }
+    }
+  }
+
+  ath_error("[get_myGridIndex]: Can't find ID=%i in GData\n", myID);
+}
+
+#ifdef MPI_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn void init_comm_domain(DomainS *pD)
+ *  \brief Creates the communicator Comm_Domain between the processors
+ *   updating the Grids of Domain pD, and sets ID_Comm_Domain of each Grid.
+ *   Must be called by all processors. */
+
+void init_comm_domain(DomainS *pD)
+{
+  int ierr,groupn,Nranks,*ranks,l,m,n;
+  MPI_Group world_group;
 
 /* Load integer array with ranks of processes in MPI_COMM_WORLD updating Grids
  * on this Domain.  The ranks of these processes in the new Comm_Domain
  * communicator created below are equal to the indices of this array */
 
-    Nranks = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
-    groupn = 0;
+  Nranks = (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+  ranks = (int*)calloc_1d_array(Nranks,sizeof(int));
+  groupn = 0;
 
-    for(n=0; n<(pD->NGrid[2]); n++){
-    for(m=0; m<(pD->NGrid[1]); m++){
-    for(l=0; l<(pD->NGrid[0]); l++){
-      ranks[groupn] = pD->GData[n][m][l].ID_Comm_world;
-      pD->GData[n][m][l].ID_Comm_Domain = groupn;
-      groupn++;
-    }}}
+  for(n=0; n<(pD->NGrid[2]); n++){
+  for(m=0; m<(pD->NGrid[1]); m++){
+  for(l=0; l<(pD->NGrid[0]); l++){
+    ranks[groupn] = pD->GData[n][m][l].ID_Comm_world;
+    pD->GData[n][m][l].ID_Comm_Domain = groupn;
+    groupn++;
+  }}}
 
 /* Create a new group for this Domain; use it to create a new communicator */
 
-    ierr = MPI_Group_incl(world_group,Nranks,ranks,&(pD->Group_Domain));
-    ierr = MPI_Comm_create(MPI_COMM_WORLD,pD->Group_Domain,&(pD->Comm_Domain));
-
-  }}
+  ierr = MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+  ierr = MPI_Group_incl(world_group,Nranks,ranks,&(pD->Group_Domain));
+  ierr = MPI_Comm_create(MPI_COMM_WORLD,pD->Group_Domain,&(pD->Comm_Domain));
+  ierr = MPI_Group_free(&world_group);
 
   free_1d_array(ranks);
-#endif /* MPI_PARALLEL */
+  return;
+}
 
-/*--- Step 9: Create MPI Communicators for Child and Parent Domains ----------*/
+#ifdef STATIC_MESH_REFINEMENT
+/*----------------------------------------------------------------------------*/
+/*! \fn void init_comm_children(MeshS *pM)
+ *  \brief Creates the communicator Comm_Children between the processors
+ *   updating the Grids of each Domain and of its children, which is also
+ *   Comm_Parent of the children, and sets ID_Comm_Children and ID_Comm_Parent
+ *   of each Grid.  Must be called by all processors. */
+
+void init_comm_children(MeshS *pM)
+{
+  DomainS *pD, *pCD;
+  SideS D1,D2;
+  int ierr,child_found,groupn,Nranks,irank,*ranks;
+  int Nproc_Comm_world,maxlevel,nl,nd,ncd,i,l,m,n;
+  MPI_Group world_group;
+
+  ierr = MPI_Comm_size(MPI_COMM_WORLD, &Nproc_Comm_world);
+  maxlevel = (pM->NLevels) - 1;
 
-#if defined(MPI_PARALLEL) && defined(STATIC_MESH_REFINEMENT)
 /* Initialize communicators to NULL, since not all Domains use them, and
  * allocate memory for ranks[] array */
 
@@ -712,12 +861,13 @@ void init_mesh(MeshS *pM)
     for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
       pM->Domain[nl][nd].Comm_Parent = MPI_COMM_NULL;
       pM->Domain[nl][nd].Comm_Children = MPI_COMM_NULL;
+      pM->Domain[nl][nd].Group_Children = MPI_GROUP_NULL;
     }
   }
+  if (maxlevel == 0) return;
 
-  if (maxlevel > 0) {
-    ranks = (int*)calloc_1d_array(Nproc_Comm_world,sizeof(int));
-  }
+  ranks = (int*)calloc_1d_array(Nproc_Comm_world,sizeof(int));
+  ierr = MPI_Comm_group(MPI_COMM_WORLD, &world_group);
 
 /* For each Domain up to (maxlevel-1), initialize communicator with children */
 
@@ -784,7 +934,7 @@ void init_mesh(MeshS *pM)
             groupn++;
             Nranks++;
           } else {
-            pCD->GData[n][m][l].ID_Comm_Parent = ranks[irank];
+            pCD->GData[n][m][l].ID_Comm_Parent = irank;
           }
         }}}
       }
@@ -818,36 +968,129 @@ void init_mesh(MeshS *pM)
     }
   }}
 
-#endif /* MPI_PARALLEL & STATIC_MESH_REFINEMENT  */
-
-  free(next_domainid);
+  ierr = MPI_Group_free(&world_group);
+  free_1d_array(ranks);
   return;
 }
+#endif /* STATIC_MESH_REFINEMENT */
 
 /*----------------------------------------------------------------------------*/
-/*! \fn void get_myGridIndex(DomainS *pD, const int myID, int *pi, 
- *			     int *pj, int *pk)
- *  \brief Searches GData[][][] array to find i,j,k components
- *   of block being updated on this processor.  */
+/*! \fn void balance_grids(MeshS *pM, const int adaptive)
+ *  \brief Assigns the Grids of all Domains to processors by cost.
+ *
+ *   Grids are taken in order of decreasing cost, and each is given to the
+ *   processor with the least cost so far that has no other Grid of the same
+ *   Domain (longest processing time first).  The largest cost on any
+ *   processor is then at most 4/3 of the best possible, without the
+ *   constraint.  With adaptive=0 every processor gets at least one Grid, so
+ *   there must be at least as many Grids as processors.
+ *
+ *   With AMR only the Grids of Domains on fixed (adaptive=0) or on adaptive
+ *   (adaptive=1) levels are assigned.  With adaptive=1 the Grids of the fixed
+ *   levels keep their processors, and start off the cost of each. */
 
-void get_myGridIndex(DomainS *pD, const int myID,
-                     int *pi, int *pj, int *pk)
+void balance_grids(MeshS *pM, const int adaptive)
 {
-  int i, j, k;
-  for (k=0; k<(pD->NGrid[2]); k++){
-    for (j=0; j<(pD->NGrid[1]); j++){
-      for (i=0; i<(pD->NGrid[0]); i++){
-        if (pD->GData[k][j][i].ID_Comm_world == myID) {
-          *pi = i;  *pj = j;  *pk = k;
-          return;
+  DomainS *pD;
+  GridCostS *list;
+  Real *load;
+  char **used;
+  int nl,nd,n,m,l,dom,ndom,ng,q,ip,id,Np,ierr;
+
+  ierr = MPI_Comm_size(MPI_COMM_WORLD, &Np);
+
+/* Count the Grids, and make a list of them with their costs */
+
+  ndom = ng = 0;
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = &(pM->Domain[nl][nd]);
+      if (DOM_ADAPTIVE(pD) == adaptive)
+        ng += (pD->NGrid[0])*(pD->NGrid[1])*(pD->NGrid[2]);
+      ndom++;
+    }
+  }
+  if (adaptive == 0 && ng < Np)
+    ath_error("[init_mesh]: %d Grids cannot be balanced over %d procs\n",ng,Np);
+  if (ng == 0) return;
+
+  if ((list = (GridCostS*)malloc(ng*sizeof(GridCostS))) == NULL)
+    ath_error("[init_mesh]: malloc failed for list of Grids\n");
+  if ((load = (Real*)calloc(Np,sizeof(Real))) == NULL)
+    ath_error("[init_mesh]: malloc failed for cost of processors\n");
+  if ((used = (char**)calloc_2d_array(ndom,Np,sizeof(char))) == NULL)
+    ath_error("[init_mesh]: malloc failed for Grids of processors\n");
+
+  q = dom = 0;
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = &(pM->Domain[nl][nd]);
+      for(n=0; n<(pD->NGrid[2]); n++){
+      for(m=0; m<(pD->NGrid[1]); m++){
+      for(l=0; l<(pD->NGrid[0]); l++){
+        if (DOM_ADAPTIVE(pD) != adaptive) {
+          if (adaptive == 1) load[pD->GData[n][m][l].ID_Comm_world] +=
+            grid_cost(pD,&(pD->GData[n][m][l]));
+          continue;
         }
+        list[q].cost = grid_cost(pD,&(pD->GData[n][m][l]));
+        list[q].nl = nl;
+        list[q].nd = nd;
+        list[q].dom = dom;
+        list[q].n = n;
+        list[q].m = m;
+        list[q].l = l;
+        q++;
+      }}}
+      dom++;
+    }
+  }
+
+  qsort(list, ng, sizeof(GridCostS), cmp_cost);
+
+/* Give each Grid to the least loaded processor without a Grid in its Domain.
+ * init_mesh() has checked that no Domain has more Grids than processors. */
+
+  for (q=0; q<ng; q++){
+    id = -1;
+    for (ip=0; ip<Np; ip++){
+      if (used[list[q].dom][ip]) continue;
+      if (id < 0 || load[ip] < load[id]) id = ip;
+    }
+    used[list[q].dom][id] = 1;
+    load[id] += list[q].cost;
+    pD = &(pM->Domain[list[q].nl][list[q].nd]);
+    pD->GData[list[q].n][list[q].m][list[q].l].ID_Comm_world = id;
+  }
+
+/* Swap processors so that rank 0 has the first Grid of the root Domain, and
+ * writes its history and other outputs as with the default assignment */
+
+  id = pM->Domain[0][0].GData[0][0][0].ID_Comm_world;
+  if (adaptive == 0 && id != 0) {
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        pD = &(pM->Domain[nl][nd]);
+        for(n=0; n<(pD->NGrid[2]); n++){
+        for(m=0; m<(pD->NGrid[1]); m++){
+        for(l=0; l<(pD->NGrid[0]); l++){
+          if (DOM_ADAPTIVE(pD)) continue;
+          ip = pD->GData[n][m][l].ID_Comm_world;
+          if (ip == id) pD->GData[n][m][l].ID_Comm_world = 0;
+          if (ip == 0)  pD->GData[n][m][l].ID_Comm_world = id;
+        }}}
       }
     }
   }
 
-  ath_error("[get_myGridIndex]: Can't find ID=%i in GData\n", myID);
+  free(list);
+  free(load);
+  free_2d_array(used);
+  return;
 }
 
+#endif /* MPI_PARALLEL */
+
 #ifdef MPI_PARALLEL
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 /*! \fn static int dom_decomp(const int Nx, const int Ny, const int Nz,
@@ -1015,4 +1258,81 @@ static int dom_decomp_3d(const int Nx, const int Ny, const int Nz,
   return 0;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real grid_cost(DomainS *pD, GridsDataS *pG)
+ *  \brief Returns the estimated cost of Grid pG of Domain pD per step of the
+ *   root level: its number of cells, times the number of steps it takes per
+ *   root step with SMR_SUBCYCLE, times <domainN>/cost */
+
+static Real grid_cost(DomainS *pD, GridsDataS *pG)
+{
+  char block[80];
+  Real cost;
+
+  sprintf(block,"domain%d",pD->InputBlock);
+  cost = par_getd_def(block,"cost",1.0);
+  if (cost <= 0.0)
+    ath_error("[init_mesh]: %s/cost = %g must be > 0\n",block,cost);
+
+  cost *= (Real)(pG->Nx[0])*(Real)(pG->Nx[1])*(Real)(pG->Nx[2]);
+#ifdef SMR_SUBCYCLE
+  cost *= (Real)(1 << pD->Level);
+#endif
+
+  return cost;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int cmp_cost(const void *a, const void *b)
+ *  \brief Orders Grids by decreasing cost, and Grids of equal cost by their
+ *   place in the Mesh, so every processor finds the same order */
+
+static int cmp_cost(const void *a, const void *b)
+{
+  const GridCostS *pa = (const GridCostS*)a, *pb = (const GridCostS*)b;
+
+  if (pa->cost > pb->cost) return -1;
+  if (pa->cost < pb->cost) return  1;
+  if (pa->dom != pb->dom) return (pa->dom < pb->dom ? -1 : 1);
+  if (pa->n != pb->n) return (pa->n < pb->n ? -1 : 1);
+  if (pa->m != pb->m) return (pa->m < pb->m ? -1 : 1);
+  if (pa->l != pb->l) return (pa->l < pb->l ? -1 : 1);
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static Real grid_imbalance(MeshS *pM, const int Np)
+ *  \brief Returns the ratio of the largest to the mean cost of the Grids on
+ *   each of the Np processors */
+
+static Real grid_imbalance(MeshS *pM, const int Np)
+{
+  DomainS *pD;
+  Real *load,max_load=0.0,tot_load=0.0;
+  int nl,nd,n,m,l,ip;
+
+  if ((load = (Real*)calloc(Np,sizeof(Real))) == NULL)
+    ath_error("[init_mesh]: malloc failed for cost of processors\n");
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = &(pM->Domain[nl][nd]);
+      for(n=0; n<(pD->NGrid[2]); n++){
+      for(m=0; m<(pD->NGrid[1]); m++){
+      for(l=0; l<(pD->NGrid[0]); l++){
+        load[pD->GData[n][m][l].ID_Comm_world] +=
+          grid_cost(pD,&(pD->GData[n][m][l]));
+      }}}
+    }
+  }
+
+  for (ip=0; ip<Np; ip++){
+    max_load = MAX(max_load,load[ip]);
+    tot_load += load[ip];
+  }
+  free(load);
+
+  return max_load*Np/tot_load;
+}
+
 #endif /* MPI_PARALLEL */
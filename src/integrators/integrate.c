@@ -3,6 +3,9 @@
 /*! \file integrate.c
  *  \brief Contains public functions to set integrator.
  *
+ * With RUNTIME_SOLVERS both the CTU and VL integrators are compiled, and the
+ * one chosen with <job>integrator is used (see runtime_solvers.c).
+ *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - integrate_init()        - set pointer to integrate function based on dim
  * - integrate_destruct()    - call destruct integrate function based on dim */
@@ -34,10 +37,18 @@ VDFun_t integrate_init(MeshS *pM)
 
   case 1:
     if(pM->Nx[0] <= 1) break;
+#ifdef RUNTIME_SOLVERS
+    if (runtime_ctu_integrator()) {
+      integrate_init_1d_ctu(pM);
+      return integrate_1d_ctu;
+    }
+    integrate_init_1d_vl(pM);
+#else
     integrate_init_1d(pM);
+#endif
 #if defined(CTU_INTEGRATOR)
     return integrate_1d_ctu;
-#elif defined(VL_INTEGRATOR)
+#elif defined(VL_INTEGRATOR) || defined(RUNTIME_SOLVERS)
     cfl = par_getd("time","cour_no");
     if (cfl > 0.5)
       ath_error("<time>cour_no=%e, must be <= 0.5 with 1D VL integrator\n",cfl);
@@ -48,10 +59,18 @@ VDFun_t integrate_init(MeshS *pM)
 
   case 2:
     if(pM->Nx[2] > 1) break;
+#ifdef RUNTIME_SOLVERS
+    if (runtime_ctu_integrator()) {
+      integrate_init_2d_ctu(pM);
+      return integrate_2d_ctu;
+    }
+    integrate_init_2d_vl(pM);
+#else
     integrate_init_2d(pM);
+#endif
 #if defined(CTU_INTEGRATOR)
     return integrate_2d_ctu;
-#elif defined(VL_INTEGRATOR)
+#elif defined(VL_INTEGRATOR) || defined(RUNTIME_SOLVERS)
     cfl = par_getd("time","cour_no");
     if (cfl > 0.5)
       ath_error("<time>cour_no=%e, must be <= 0.5 with 2D VL integrator\n",cfl);
@@ -61,16 +80,33 @@ VDFun_t integrate_init(MeshS *pM)
 #endif
 
   case 3:
+#ifdef RUNTIME_SOLVERS
+    if (runtime_ctu_integrator()) {
+      integrate_init_3d_ctu(pM);
+      cfl = par_getd("time","cour_no");
+      if (cfl > 0.5)
+        ath_error("<time>cour_no=%e, must be <= 0.5 with 3D CTU integrator\n",cfl);
+      return integrate_3d_ctu;
+    }
+    integrate_init_3d_vl(pM);
+#else
     integrate_init_3d(pM);
+#endif
 #if defined(CTU_INTEGRATOR)
     cfl = par_getd("time","cour_no");
     if (cfl > 0.5)
       ath_error("<time>cour_no=%e, must be <= 0.5 with 3D CTU integrator\n",cfl);
     return integrate_3d_ctu;
-#elif defined(VL_INTEGRATOR)
+#elif defined(VL_INTEGRATOR) || defined(RUNTIME_SOLVERS)
     cfl = par_getd("time","cour_no");
     if (cfl > 0.5)
       ath_error("<time>cour_no=%e, must be <= 0.5 with 3D VL integrator\n",cfl);
+#ifndef SPECIAL_RELATIVITY
+    if (par_geti_def("job","tile_nx1",0) > 0 ||
+        par_geti_def("job","tile_nx2",0) > 0 ||
+        par_geti_def("job","tile_nx3",0) > 0)
+      return integrate_3d_vl_tiled;
+#endif
     return integrate_3d_vl;
 #else
     ath_err("[integrate_init]: Invalid integrator defined for 3D problem");
@@ -94,13 +130,28 @@ void integrate_destruct()
 {
   switch(dim){
   case 1:
+#ifdef RUNTIME_SOLVERS
+    if (runtime_ctu_integrator()) integrate_destruct_1d_ctu();
+    else integrate_destruct_1d_vl();
+#else
     integrate_destruct_1d();
+#endif
     return;
   case 2:
+#ifdef RUNTIME_SOLVERS
+    if (runtime_ctu_integrator()) integrate_destruct_2d_ctu();
+    else integrate_destruct_2d_vl();
+#else
     integrate_destruct_2d();
+#endif
     return;
   case 3:
+#ifdef RUNTIME_SOLVERS
+    if (runtime_ctu_integrator()) integrate_destruct_3d_ctu();
+    else integrate_destruct_3d_vl();
+#else
     integrate_destruct_3d();
+#endif
     return;
   }
 
@@ -11,6 +11,11 @@
  *   Also adds gravitational source terms, self-gravity, optically-thin cooling,
  *   and H-correction of Sanders et al.
  *
+ *   With --enable-openmp the loops over the outer (j, or i for the x2-sweep)
+ *   index are threaded, including the transverse flux corrections and the emf
+ *   corner integration.  Results are bitwise identical to the serial
+ *   integrator.  SMR flux storage remains serial.
+ *
  * REFERENCES:
  * - P. Colella, "Multidimensional upwind methods for hyperbolic conservation
  *   laws", JCP, 87, 171 (1990)
@@ -61,6 +66,9 @@ static Real **emf3=NULL, **emf3_cc=NULL;
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W=NULL, *Wl=NULL, *Wr=NULL;
 static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(Bxc,Bxi,W,Wl,Wr,U1d,Ul,Ur)
+#endif
 
 /* density and Pressure at t^{n+1/2} needed by MHD, cooling, and gravity */
 static Real **dhalf = NULL,**phalf = NULL;
@@ -75,6 +83,71 @@ static Real **eta1=NULL, **eta2=NULL;
 static Real **geom_src=NULL;
 #endif
 
+/* Work variables of integrate_2d_ctu() that are written inside its threaded
+ * loops.  Each group is defined under the same options as the variables it
+ * names, and is expanded in the private() clauses of the OpenMP directives.
+ * Variables in CTU_FIRSTPRIVATE only vary with CYLINDRICAL; they are also made
+ * lastprivate so their values after each loop are the same as in serial. */
+#ifdef OPENMP_PARALLEL
+#ifndef BAROTROPIC
+#define CTU_PRIV_ENERGY ,coolfl,coolfr,coolf,Eh
+#else
+#define CTU_PRIV_ENERGY
+#endif
+#ifdef MHD
+#define CTU_PRIV_MHD ,MHD_src,dbx,dby,B1,B2,B3,V3,B1ch,B2ch,B3ch
+#else
+#define CTU_PRIV_MHD
+#endif
+#ifdef H_CORRECTION
+#define CTU_PRIV_HCORR ,cfr,cfl,lambdar,lambdal
+#else
+#define CTU_PRIV_HCORR
+#endif
+#if (NSCALARS > 0)
+#define CTU_PRIV_SCALARS ,n
+#else
+#define CTU_PRIV_SCALARS
+#endif
+#ifdef SELF_GRAVITY
+#define CTU_PRIV_SELFG ,gxl,gxr,gyl,gyr,flux_m1l,flux_m1r,flux_m2l,flux_m2r
+#else
+#define CTU_PRIV_SELFG
+#endif
+#ifdef SHEARING_BOX
+#define CTU_PRIV_SHEAR ,Vphi,Mphi,M1n,dM2n,dM3n,M1e,dM2e,dM3e,\
+  flx1_dM2,frx1_dM2,flx2_dM2,frx2_dM2,flx1_dM3,frx1_dM3,flx2_dM3,frx2_dM3
+#else
+#define CTU_PRIV_SHEAR
+#endif
+#ifdef CYLINDRICAL
+#ifndef ISOTHERMAL
+#define CTU_PRIV_PAVG ,Pavgh
+#else
+#define CTU_PRIV_PAVG
+#endif
+#ifdef FARGO
+#define CTU_PRIV_FARGO ,Om,qshear,Mrn,Mpn,Mre,Mpe,Mrav,Mpav
+#else
+#define CTU_PRIV_FARGO
+#endif
+#define CTU_PRIV_CYL ,rinv,geom_src_d,geom_src_Vx,geom_src_Vy,geom_src_P,\
+  geom_src_By,geom_src_Bz CTU_PRIV_PAVG CTU_PRIV_FARGO
+#else
+#define CTU_PRIV_CYL
+#endif
+#ifdef PARTICLES
+#define CTU_PRIV_PARTICLES ,d1
+#else
+#define CTU_PRIV_PARTICLES
+#endif
+
+#define CTU_PRIVATE x1,x2,x3,phicl,phicr,phifc,phil,phir,phic,M1h,M2h,M3h,\
+  g,gl,gr CTU_PRIV_ENERGY CTU_PRIV_MHD CTU_PRIV_HCORR CTU_PRIV_SCALARS \
+  CTU_PRIV_SELFG CTU_PRIV_SHEAR CTU_PRIV_CYL CTU_PRIV_PARTICLES
+#define CTU_FIRSTPRIVATE Bx,rsf,lsf,dx2i,dx2,dtodx2,hdtodx2
+#endif /* OPENMP_PARALLEL */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
  *   integrate_emf3_corner() - the upwind CT method in Gardiner & Stone (2005) 
@@ -96,6 +169,9 @@ static void integrate_emf3_corner(GridS *pG);
 void integrate_2d_ctu(DomainS *pD)
 {
   GridS *pG=(pD->Grid);
+#ifdef FUSED_CFL
+  Real cfl_v1=0.0,cfl_v2=0.0,cfl_v3=0.0;
+#endif
   Real dtodx1 = pG->dt/pG->dx1, dtodx2 = pG->dt/pG->dx2;
   Real hdtodx1 = 0.5*dtodx1, hdtodx2 = 0.5*dtodx2;
   Real hdt = 0.5*pG->dt, dx2 = pG->dx2;
@@ -175,13 +251,19 @@ void integrate_2d_ctu(DomainS *pD)
   ju = je + 2;
 #endif
 
-/* Set etah=0 so first calls to flux functions do not use H-correction */
+/* Set etah=0 so first calls to flux functions do not use H-correction.
+ * etah is threadprivate, so it must be reset in every thread. */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
   etah = 0.0;
 
 /* Compute predictor feedback from particle drag */
 #ifdef FEEDBACK
+  TIMER_START(TIMER_PARTICLES);
   feedback_predictor(pD);
   exchange_gpcouple(pD,1);
+  TIMER_STOP(TIMER_PARTICLES);
 #endif
 
 /*=== STEP 1: Compute L/R x1-interface states and 1D x1-Fluxes ===============*/
@@ -191,24 +273,28 @@ void integrate_2d_ctu(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl; j<=ju; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
-      U1d[i].d  = pG->U[ks][j][i].d;
-      U1d[i].Mx = pG->U[ks][j][i].M1;
-      U1d[i].My = pG->U[ks][j][i].M2;
-      U1d[i].Mz = pG->U[ks][j][i].M3;
+      U1d[i].d  = GRID_U(pG,ks,j,i,d);
+      U1d[i].Mx = GRID_U(pG,ks,j,i,M1);
+      U1d[i].My = GRID_U(pG,ks,j,i,M2);
+      U1d[i].Mz = GRID_U(pG,ks,j,i,M3);
 #ifndef BAROTROPIC
-      U1d[i].E  = pG->U[ks][j][i].E;
+      U1d[i].E  = GRID_U(pG,ks,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-      U1d[i].By = pG->U[ks][j][i].B2c;
-      U1d[i].Bz = pG->U[ks][j][i].B3c;
-      Bxc[i] = pG->U[ks][j][i].B1c;
+      U1d[i].By = GRID_U(pG,ks,j,i,B2c);
+      U1d[i].Bz = GRID_U(pG,ks,j,i,B3c);
+      Bxc[i] = GRID_U(pG,ks,j,i,B1c);
       Bxi[i] = pG->B1i[ks][j][i];
       B1_x1Face[j][i] = pG->B1i[ks][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-      for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[ks][j][i].s[n];
+      for (n=0; n<NSCALARS; n++) U1d[i].s[n] = GRID_U(pG,ks,j,i,s[n]);
 #endif
     }
 
@@ -253,14 +339,14 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i]/r[i-1];  lsf = ri[i-1]/r[i-1];
 #endif
-      MHD_src = (pG->U[ks][j][i-1].M2/pG->U[ks][j][i-1].d)*
+      MHD_src = (GRID_U(pG,ks,j,i-1,M2)/GRID_U(pG,ks,j,i-1,d))*
                 (rsf*pG->B1i[ks][j][i] - lsf*pG->B1i[ks][j][i-1])*dx1i;
       Wl[i].By += hdt*MHD_src;
 
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      MHD_src = (pG->U[ks][j][i].M2/pG->U[ks][j][i].d)*
+      MHD_src = (GRID_U(pG,ks,j,i,M2)/GRID_U(pG,ks,j,i,d))*
                (rsf*pG->B1i[ks][j][i+1] - lsf*pG->B1i[ks][j][i])*dx1i;
       Wr[i].By += hdt*MHD_src;
     }
@@ -496,12 +582,13 @@ void integrate_2d_ctu(DomainS *pD)
     for (i=il+1; i<=iu; i++) {
       Ul_x1Face[j][i] = Prim1D_to_Cons1D(&Wl[i],&Bxi[i]);
       Ur_x1Face[j][i] = Prim1D_to_Cons1D(&Wr[i],&Bxi[i]);
-
+    }
 #ifdef MHD
-      Bx = B1_x1Face[j][i];
+    fluxes_pencil(il+1,iu,Ul_x1Face[j],Ur_x1Face[j],Wl,Wr,B1_x1Face[j],
+                  x1Flux[j]);
+#else
+    fluxes_pencil(il+1,iu,Ul_x1Face[j],Ur_x1Face[j],Wl,Wr,Bxi,x1Flux[j]);
 #endif
-      fluxes(Ul_x1Face[j][i],Ur_x1Face[j][i],Wl[i],Wr[i],Bx,&x1Flux[j][i]);
-    }
   }
 
 /*=== STEP 2: Compute L/R x2-interface states and 1D x2-Fluxes ===============*/
@@ -511,6 +598,10 @@ void integrate_2d_ctu(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (i=il; i<=iu; i++) {
 #ifdef CYLINDRICAL
     dx2 = r[i]*pG->dx2;
@@ -519,22 +610,22 @@ void integrate_2d_ctu(DomainS *pD)
     hdtodx2 = 0.5*dtodx2;
 #endif
     for (j=js-nghost; j<=je+nghost; j++) {
-      U1d[j].d  = pG->U[ks][j][i].d;
-      U1d[j].Mx = pG->U[ks][j][i].M2;
-      U1d[j].My = pG->U[ks][j][i].M3;
-      U1d[j].Mz = pG->U[ks][j][i].M1;
+      U1d[j].d  = GRID_U(pG,ks,j,i,d);
+      U1d[j].Mx = GRID_U(pG,ks,j,i,M2);
+      U1d[j].My = GRID_U(pG,ks,j,i,M3);
+      U1d[j].Mz = GRID_U(pG,ks,j,i,M1);
 #ifndef BAROTROPIC
-      U1d[j].E  = pG->U[ks][j][i].E;
+      U1d[j].E  = GRID_U(pG,ks,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-      U1d[j].By = pG->U[ks][j][i].B3c;
-      U1d[j].Bz = pG->U[ks][j][i].B1c;
-      Bxc[j] = pG->U[ks][j][i].B2c;
+      U1d[j].By = GRID_U(pG,ks,j,i,B3c);
+      U1d[j].Bz = GRID_U(pG,ks,j,i,B1c);
+      Bxc[j] = GRID_U(pG,ks,j,i,B2c);
       Bxi[j] = pG->B2i[ks][j][i];
       B2_x2Face[j][i] = pG->B2i[ks][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-      for (n=0; n<NSCALARS; n++) U1d[j].s[n] = pG->U[ks][j][i].s[n];
+      for (n=0; n<NSCALARS; n++) U1d[j].s[n] = GRID_U(pG,ks,j,i,s[n]);
 #endif
     }
 
@@ -560,11 +651,11 @@ void integrate_2d_ctu(DomainS *pD)
 
 #ifdef MHD
     for (j=jl+1; j<=ju; j++) {
-      MHD_src = (pG->U[ks][j-1][i].M1/pG->U[ks][j-1][i].d)*
+      MHD_src = (GRID_U(pG,ks,j-1,i,M1)/GRID_U(pG,ks,j-1,i,d))*
         (pG->B2i[ks][j][i] - pG->B2i[ks][j-1][i])*dx2i;
       Wl[j].Bz += hdt*MHD_src;
 
-      MHD_src = (pG->U[ks][j][i].M1/pG->U[ks][j][i].d)*
+      MHD_src = (GRID_U(pG,ks,j,i,M1)/GRID_U(pG,ks,j,i,d))*
         (pG->B2i[ks][j+1][i] - pG->B2i[ks][j][i])*dx2i;
       Wr[j].Bz += hdt*MHD_src;
     }
@@ -665,11 +756,15 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
       emf3_cc[j][i] =
-        (pG->U[ks][j][i].B1c*pG->U[ks][j][i].M2 -
-         pG->U[ks][j][i].B2c*pG->U[ks][j][i].M1 )/pG->U[ks][j][i].d;
+        (GRID_U(pG,ks,j,i,B1c)*GRID_U(pG,ks,j,i,M2) -
+         GRID_U(pG,ks,j,i,B2c)*GRID_U(pG,ks,j,i,M1) )/GRID_U(pG,ks,j,i,d);
     }
   }
 
@@ -679,6 +774,10 @@ void integrate_2d_ctu(DomainS *pD)
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
     for (i=il+1; i<=iu-1; i++) {
 #ifdef CYLINDRICAL
@@ -704,6 +803,10 @@ void integrate_2d_ctu(DomainS *pD)
  * Since the fluxes come from an x2-sweep, (x,y,z) on RHS -> (z,x,y) on LHS
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
     for (i=il+1; i<=iu; i++) {
 #ifdef CYLINDRICAL
@@ -753,6 +856,10 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
     for (i=il+1; i<=iu; i++) {
 #ifdef CYLINDRICAL
@@ -760,10 +867,10 @@ void integrate_2d_ctu(DomainS *pD)
 #else
       dbx = pG->B1i[ks][j][i] - pG->B1i[ks][j][i-1];
 #endif
-      B1 = pG->U[ks][j][i-1].B1c;
-      B2 = pG->U[ks][j][i-1].B2c;
-      B3 = pG->U[ks][j][i-1].B3c;
-      V3 = pG->U[ks][j][i-1].M3/pG->U[ks][j][i-1].d;
+      B1 = GRID_U(pG,ks,j,i-1,B1c);
+      B2 = GRID_U(pG,ks,j,i-1,B2c);
+      B3 = GRID_U(pG,ks,j,i-1,B3c);
+      V3 = GRID_U(pG,ks,j,i-1,M3)/GRID_U(pG,ks,j,i-1,d);
 
       Ul_x1Face[j][i].Mx += hdtodx1*B1*dbx;
       Ul_x1Face[j][i].My += hdtodx1*B2*dbx;
@@ -778,10 +885,10 @@ void integrate_2d_ctu(DomainS *pD)
 #else
       dbx = pG->B1i[ks][j][i+1] - pG->B1i[ks][j][i];
 #endif
-      B1 = pG->U[ks][j][i].B1c;
-      B2 = pG->U[ks][j][i].B2c;
-      B3 = pG->U[ks][j][i].B3c;
-      V3 = pG->U[ks][j][i].M3/pG->U[ks][j][i].d;
+      B1 = GRID_U(pG,ks,j,i,B1c);
+      B2 = GRID_U(pG,ks,j,i,B2c);
+      B3 = GRID_U(pG,ks,j,i,B3c);
+      V3 = GRID_U(pG,ks,j,i,M3)/GRID_U(pG,ks,j,i,d);
 
       Ur_x1Face[j][i].Mx += hdtodx1*B1*dbx;
       Ur_x1Face[j][i].My += hdtodx1*B2*dbx;
@@ -802,6 +909,10 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
         cc_pos(pG,i,j,ks,&x1,&x2,&x3);
@@ -812,10 +923,10 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
-        Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
 
 #ifdef ROTATING_FRAME
-        Ur_x1Face[j][i].My -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+        Ur_x1Face[j][i].My -= (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
 
 #ifndef BAROTROPIC
@@ -830,10 +941,10 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         hdtodx2 = hdt/(r[i-1]*pG->dx2);
 #endif
-        Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i-1].d;
+        Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i-1,d);
 
 #ifdef ROTATING_FRAME
-        Ul_x1Face[j][i].My -= (pG->dt)*Omega_0*pG->U[ks][j][i-1].M1;
+        Ul_x1Face[j][i].My -= (pG->dt)*Omega_0*GRID_U(pG,ks,j,i-1,M1);
 #endif /*ROTATING_FRAME*/
 
 #ifndef BAROTROPIC
@@ -850,13 +961,17 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
     for (i=il+1; i<=iu; i++) {
       phic = pG->Phi[ks][j][i];
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j+1][i]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j-1][i]);
 
-      Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+      Ur_x1Face[j][i].My -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
       Ur_x1Face[j][i].E -= hdtodx2*(x2Flux[j  ][i  ].d*(phic - phil) +
                                     x2Flux[j+1][i  ].d*(phir - phic));
@@ -866,7 +981,7 @@ void integrate_2d_ctu(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j][i-1] + pG->Phi[ks][j+1][i-1]);
       phil = 0.5*(pG->Phi[ks][j][i-1] + pG->Phi[ks][j-1][i-1]);
 
-      Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*pG->U[ks][j][i-1].d;
+      Ul_x1Face[j][i].My -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i-1,d);
 #ifndef BAROTROPIC
       Ul_x1Face[j][i].E -= hdtodx2*(x2Flux[j  ][i-1].d*(phic - phil) +
                                     x2Flux[j+1][i-1].d*(phir - phic));
@@ -882,6 +997,10 @@ void integrate_2d_ctu(DomainS *pD)
  * Since the fluxes come from an x1-sweep, (x,y,z) on RHS -> (y,z,x) on LHS
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju; j++) {
     for (i=il+1; i<=iu-1; i++) {
 #ifdef CYLINDRICAL
@@ -924,16 +1043,20 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju; j++) {
     for (i=il+1; i<=iu-1; i++) {
 #ifdef CYLINDRICAL
       hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
       dby = pG->B2i[ks][j][i] - pG->B2i[ks][j-1][i];
-      B1 = pG->U[ks][j-1][i].B1c;
-      B2 = pG->U[ks][j-1][i].B2c;
-      B3 = pG->U[ks][j-1][i].B3c;
-      V3 = pG->U[ks][j-1][i].M3/pG->U[ks][j-1][i].d;
+      B1 = GRID_U(pG,ks,j-1,i,B1c);
+      B2 = GRID_U(pG,ks,j-1,i,B2c);
+      B3 = GRID_U(pG,ks,j-1,i,B3c);
+      V3 = GRID_U(pG,ks,j-1,i,M3)/GRID_U(pG,ks,j-1,i,d);
 
       Ul_x2Face[j][i].Mz += hdtodx2*B1*dby;
       Ul_x2Face[j][i].Mx += hdtodx2*B2*dby;
@@ -944,10 +1067,10 @@ void integrate_2d_ctu(DomainS *pD)
 #endif /* BAROTROPIC */
 
       dby = pG->B2i[ks][j+1][i] - pG->B2i[ks][j][i];
-      B1 = pG->U[ks][j][i].B1c;
-      B2 = pG->U[ks][j][i].B2c;
-      B3 = pG->U[ks][j][i].B3c;
-      V3 = pG->U[ks][j][i].M3/pG->U[ks][j][i].d;
+      B1 = GRID_U(pG,ks,j,i,B1c);
+      B2 = GRID_U(pG,ks,j,i,B2c);
+      B3 = GRID_U(pG,ks,j,i,B3c);
+      V3 = GRID_U(pG,ks,j,i,M3)/GRID_U(pG,ks,j,i,d);
 
       Ur_x2Face[j][i].Mz += hdtodx2*B1*dby;
       Ur_x2Face[j][i].Mx += hdtodx2*B2*dby;
@@ -968,6 +1091,10 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
         cc_pos(pG,i,j,ks,&x1,&x2,&x3);
@@ -983,12 +1110,12 @@ void integrate_2d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ur_x2Face[j][i].Mz -= hdt*pG->U[ks][j][i].d*g;
+        Ur_x2Face[j][i].Mz -= hdt*GRID_U(pG,ks,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
+        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j][i].d*Om*x1vc(pG,i);
+        Ur_x2Face[j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 
@@ -1010,12 +1137,12 @@ void integrate_2d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ul_x2Face[j][i].Mz -= hdt*pG->U[ks][j-1][i].d*g;
+        Ul_x2Face[j][i].Mz -= hdt*GRID_U(pG,ks,j-1,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j-1][i].M2;
+        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,ks,j-1,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*pG->U[ks][j-1][i].d*Om*x1vc(pG,i);
+        Ul_x2Face[j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,ks,j-1,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 
@@ -1038,6 +1165,10 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju; j++) {
     for (i=il+1; i<=iu-1; i++) {
       /* correct right states; x1 gradients */
@@ -1045,7 +1176,7 @@ void integrate_2d_ctu(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i+1]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i-1]);
 
-      Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+      Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
       Ur_x2Face[j][i].E -= hdtodx1*(x1Flux[j  ][i  ].d*(phic - phil) +
                                     x1Flux[j  ][i+1].d*(phir - phic));
@@ -1056,7 +1187,7 @@ void integrate_2d_ctu(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j-1][i] + pG->Phi[ks][j-1][i+1]);
       phil = 0.5*(pG->Phi[ks][j-1][i] + pG->Phi[ks][j-1][i-1]);
 
-      Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j-1][i].d;
+      Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j-1,i,d);
 #ifndef BAROTROPIC
       Ul_x2Face[j][i].E -= hdtodx1*(x1Flux[j-1][i  ].d*(phic - phil) +
                                     x1Flux[j-1][i+1].d*(phir - phic));
@@ -1077,6 +1208,10 @@ void integrate_2d_ctu(DomainS *pD)
 
 #ifdef SHEARING_BOX
   if (ShearingBoxPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
         cc_pos(pG,i,j,ks,&x1,&x2,&x3);
@@ -1084,7 +1219,7 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+        Ur_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[j][i].E -= hdtodx1*(x1Flux[j  ][i  ].d*(phic - phil) +
                                       x1Flux[j  ][i+1].d*(phir - phic));
@@ -1094,7 +1229,7 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),(x2-pG->dx2),x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),(x2-pG->dx2),x3);
 
-        Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*pG->U[ks][j-1][i].d;
+        Ul_x2Face[j][i].Mz -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[j][i].E -= hdtodx1*(x1Flux[j-1][i  ].d*(phic - phil) +
                                       x1Flux[j-1][i+1].d*(phir - phic));
@@ -1104,32 +1239,40 @@ void integrate_2d_ctu(DomainS *pD)
   }
 
   if (ShBoxCoord == xz){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j][i].M3;
-        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j-1][i].M3;
+        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*GRID_U(pG,ks,j,i,M3);
+        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*GRID_U(pG,ks,j-1,i,M3);
 #ifdef FARGO
-        Ur_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*GRID_U(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].My += hdt*(qshear-2.)*Omega_0*GRID_U(pG,ks,j-1,i,M1);
 #else
-        Ur_x2Face[j][i].My -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].My -= pG->dt*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].My -= pG->dt*Omega_0*GRID_U(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].My -= pG->dt*Omega_0*GRID_U(pG,ks,j-1,i,M1);
 #endif
       }
     }
   }
 
   if (ShBoxCoord == xy){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j][i].M2;
-        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*pG->U[ks][j-1][i].M2;
+        Ur_x2Face[j][i].Mz += pG->dt*Omega_0*GRID_U(pG,ks,j,i,M2);
+        Ul_x2Face[j][i].Mz += pG->dt*Omega_0*GRID_U(pG,ks,j-1,i,M2);
 #ifdef FARGO
-        Ur_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*GRID_U(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].Mx += hdt*(qshear-2.)*Omega_0*GRID_U(pG,ks,j-1,i,M1);
 #else
-        Ur_x2Face[j][i].Mx -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
-        Ul_x2Face[j][i].Mx -= pG->dt*Omega_0*pG->U[ks][j-1][i].M1;
+        Ur_x2Face[j][i].Mx -= pG->dt*Omega_0*GRID_U(pG,ks,j,i,M1);
+        Ul_x2Face[j][i].Mx -= pG->dt*Omega_0*GRID_U(pG,ks,j-1,i,M1);
 #endif
       }
     }
@@ -1137,16 +1280,20 @@ void integrate_2d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
 #if defined(CYLINDRICAL) && defined(FARGO)
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju; j++) {
     for (i=il+1; i<=iu-1; i++) {
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
 
-      Ur_x2Face[j][i].Mz += pG->dt*Om*pG->U[ks][j][i].M2;
-      Ur_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[ks][j][i].M1;
+      Ur_x2Face[j][i].Mz += pG->dt*Om*GRID_U(pG,ks,j,i,M2);
+      Ur_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*GRID_U(pG,ks,j,i,M1);
 
-      Ul_x2Face[j][i].Mz += pG->dt*Om*pG->U[ks][j-1][i].M2;
-      Ul_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[ks][j-1][i].M1;
+      Ul_x2Face[j][i].Mz += pG->dt*Om*GRID_U(pG,ks,j-1,i,M2);
+      Ul_x2Face[j][i].Mx += hdt*(qshear-2.0)*Om*GRID_U(pG,ks,j-1,i,M1);
     }
   }
 #endif
@@ -1155,6 +1302,10 @@ void integrate_2d_ctu(DomainS *pD)
  * add the geometric source terms in the x1-direction for dt/2
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js-1; j<=ju; j++) {
     for (i=is-1; i<=ie+1; i++) {
       Ur_x2Face[j][i].Mz += hdt*geom_src[j  ][i];
@@ -1166,6 +1317,10 @@ void integrate_2d_ctu(DomainS *pD)
 /*--- Step 6e ------------------------------------------------------------------
  * Apply density floor
  */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
   for (i=il+1; i<=iu-1; i++) {
     if ((Ul_x1Face[j][i].d < d_MIN) ||
@@ -1200,13 +1355,17 @@ void integrate_2d_ctu(DomainS *pD)
 #endif
 #endif
   {
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
         hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
-        dhalf[j][i] = pG->U[ks][j][i].d
+        dhalf[j][i] = GRID_U(pG,ks,j,i,d)
           - hdtodx1*(rsf*x1Flux[j  ][i+1].d - lsf*x1Flux[j][i].d)
           - hdtodx2*(    x2Flux[j+1][i  ].d -     x2Flux[j][i].d);
 
@@ -1230,26 +1389,30 @@ void integrate_2d_ctu(DomainS *pD)
 #endif /* PARTICLES */
 #endif /* MHD */
   {
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
     for (i=il+1; i<=iu-1; i++) {
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
       hdtodx2 = hdt/(r[i]*pG->dx2);
 #endif
-      M1h = pG->U[ks][j][i].M1
+      M1h = GRID_U(pG,ks,j,i,M1)
         - hdtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx)
         - hdtodx2*(    x2Flux[j+1][i].Mz -     x2Flux[j][i].Mz);
 
-      M2h = pG->U[ks][j][i].M2
+      M2h = GRID_U(pG,ks,j,i,M2)
         - hdtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My)
         - hdtodx2*(         x2Flux[j+1][i].Mx -          x2Flux[j][i].Mx);
 
-      M3h = pG->U[ks][j][i].M3
+      M3h = GRID_U(pG,ks,j,i,M3)
         - hdtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz)
         - hdtodx2*(    x2Flux[j+1][i].My -     x2Flux[j][i].My);
 
 #ifndef BAROTROPIC
-      Eh = pG->U[ks][j][i].E
+      Eh = GRID_U(pG,ks,j,i,E)
         - hdtodx1*(rsf*x1Flux[j][i+1].E - lsf*x1Flux[j][i].E)
         - hdtodx2*(    x2Flux[j+1][i].E -     x2Flux[j][i].E);
 #endif
@@ -1264,20 +1427,20 @@ void integrate_2d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
-        M1h -= hdt*pG->U[ks][j][i].d*g; 
+        M1h -= hdt*GRID_U(pG,ks,j,i,d)*g; 
 #ifdef ROTATING_FRAME
-        M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
+        M1h += (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].d*Om*x1vc(pG,i);
+        M1h += (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-        M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        M2h -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifdef ROTATING_FRAME
-        M2h -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+        M2h -= (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
 
       }
@@ -1286,11 +1449,11 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef SELF_GRAVITY
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i+1]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i-1]);
-      M1h -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+      M1h -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j,i,d);
 
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j+1][i]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j-1][i]);
-      M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+      M2h -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #endif /* SELF_GRAVITY */
 
       /* Add the tidal gravity and Coriolis terms for shearing box. */
@@ -1299,28 +1462,28 @@ void integrate_2d_ctu(DomainS *pD)
         cc_pos(pG,i,j,ks,&x1,&x2,&x3);
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
-        M1h -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+        M1h -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j,i,d);
 
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
-        M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        M2h -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
       }
 
-      if (ShBoxCoord == xy) M1h += pG->dt*Omega_0*pG->U[ks][j][i].M2;
-      if (ShBoxCoord == xz) M1h += pG->dt*Omega_0*pG->U[ks][j][i].M3;
+      if (ShBoxCoord == xy) M1h += pG->dt*Omega_0*GRID_U(pG,ks,j,i,M2);
+      if (ShBoxCoord == xz) M1h += pG->dt*Omega_0*GRID_U(pG,ks,j,i,M3);
 #ifdef FARGO
-      if (ShBoxCoord == xy) M2h += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
-      if (ShBoxCoord == xz) M3h += hdt*(qshear-2.)*Omega_0*pG->U[ks][j][i].M1;
+      if (ShBoxCoord == xy) M2h += hdt*(qshear-2.)*Omega_0*GRID_U(pG,ks,j,i,M1);
+      if (ShBoxCoord == xz) M3h += hdt*(qshear-2.)*Omega_0*GRID_U(pG,ks,j,i,M1);
 #else
-      if (ShBoxCoord == xy) M2h -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
-      if (ShBoxCoord == xz) M3h -= pG->dt*Omega_0*pG->U[ks][j][i].M1;
+      if (ShBoxCoord == xy) M2h -= pG->dt*Omega_0*GRID_U(pG,ks,j,i,M1);
+      if (ShBoxCoord == xz) M3h -= pG->dt*Omega_0*GRID_U(pG,ks,j,i,M1);
 #endif
 #endif /* SHEARING_BOX */
 #if defined(CYLINDRICAL) && defined(FARGO)
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
-      M1h += hdt*2.0*Om*pG->U[ks][j][i].M2;
-      M2h += hdt*Om*(qshear-2.0)*pG->U[ks][j][i].M1;
+      M1h += hdt*2.0*Om*GRID_U(pG,ks,j,i,M2);
+      M2h += hdt*Om*(qshear-2.0)*GRID_U(pG,ks,j,i,M1);
 #endif
 
       /* Add the particle feedback terms */
@@ -1343,7 +1506,7 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef MHD
       B1ch = 0.5*(lsf*B1_x1Face[j][i] + rsf*B1_x1Face[j][i+1]);
       B2ch = 0.5*(    B2_x2Face[j][i] +     B2_x2Face[j+1][i]);
-      B3ch = pG->U[ks][j][i].B3c 
+      B3ch = GRID_U(pG,ks,j,i,B3c) 
         - hdtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz)
         - hdtodx2*(    x2Flux[j+1][i].By -     x2Flux[j][i].By);
       emf3_cc[j][i] = (B1ch*M2h - B2ch*M1h)/dhalf[j][i];
@@ -1373,10 +1536,12 @@ void integrate_2d_ctu(DomainS *pD)
 /*=== STEP 8.5: Integrate the particles, compute the feedback ================*/
 
 #ifdef PARTICLES
+  TIMER_START(TIMER_PARTICLES);
   Integrate_Particles(pD);
 #ifdef FEEDBACK
   exchange_gpcouple(pD, 2);
 #endif
+  TIMER_STOP(TIMER_PARTICLES);
 #endif
 
 /*=== STEP 9: Compute 2D x1-Flux, x2-Flux ====================================*/
@@ -1387,6 +1552,10 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef H_CORRECTION
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js-1; j<=je+1; j++) {
     for (i=is-1; i<=ie+2; i++) {
 #ifdef MHD
@@ -1400,6 +1569,10 @@ void integrate_2d_ctu(DomainS *pD)
     }
   }
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js-1; j<=je+2; j++) {
     for (i=is-1; i<=ie+1; i++) {
 #ifdef MHD
@@ -1418,14 +1591,17 @@ void integrate_2d_ctu(DomainS *pD)
  * Compute 2D x1-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js-1; j<=je+1; j++) {
-    for (i=is; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+    for (i=is; i<=ie+1; i++) {
       etah = MAX(eta2[j][i-1],eta2[j][i]);
       etah = MAX(etah,eta2[j+1][i-1]);
       etah = MAX(etah,eta2[j+1][i  ]);
       etah = MAX(etah,eta1[j  ][i  ]);
-#endif /* H_CORRECTION */
 #ifdef MHD
       Bx = B1_x1Face[j][i];
 #endif
@@ -1434,6 +1610,16 @@ void integrate_2d_ctu(DomainS *pD)
 
       fluxes(Ul_x1Face[j][i],Ur_x1Face[j][i],Wl[i],Wr[i],Bx,&x1Flux[j][i]);
     }
+#else
+    for (i=is; i<=ie+1; i++) {
+#ifdef MHD
+      Bxi[i] = B1_x1Face[j][i];
+#endif
+      Wl[i] = Cons1D_to_Prim1D(&Ul_x1Face[j][i],&Bxi[i]);
+      Wr[i] = Cons1D_to_Prim1D(&Ur_x1Face[j][i],&Bxi[i]);
+    }
+    fluxes_pencil(is,ie+1,Ul_x1Face[j],Ur_x1Face[j],Wl,Wr,Bxi,x1Flux[j]);
+#endif /* H_CORRECTION */
   }
 
 
@@ -1441,14 +1627,17 @@ void integrate_2d_ctu(DomainS *pD)
  * Compute 2D x2-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je+1; j++) {
-    for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+    for (i=is-1; i<=ie+1; i++) {
       etah = MAX(eta1[j-1][i],eta1[j][i]);
       etah = MAX(etah,eta1[j-1][i+1]);
       etah = MAX(etah,eta1[j  ][i+1]);
       etah = MAX(etah,eta2[j  ][i  ]);
-#endif /* H_CORRECTION */
 #ifdef MHD
       Bx = B2_x2Face[j][i];
 #endif
@@ -1457,6 +1646,16 @@ void integrate_2d_ctu(DomainS *pD)
 
       fluxes(Ul_x2Face[j][i],Ur_x2Face[j][i],Wl[i],Wr[i],Bx,&x2Flux[j][i]);
     }
+#else
+    for (i=is-1; i<=ie+1; i++) {
+#ifdef MHD
+      Bxi[i] = B2_x2Face[j][i];
+#endif
+      Wl[i] = Cons1D_to_Prim1D(&Ul_x2Face[j][i],&Bxi[i]);
+      Wr[i] = Cons1D_to_Prim1D(&Ur_x2Face[j][i],&Bxi[i]);
+    }
+    fluxes_pencil(is-1,ie+1,Ul_x2Face[j],Ur_x2Face[j],Wl,Wr,Bxi,x2Flux[j]);
+#endif /* H_CORRECTION */
   }
 
 /*=== STEP 10: Update face-centered B for a full timestep ====================*/
@@ -1472,6 +1671,10 @@ void integrate_2d_ctu(DomainS *pD)
  * Update the interface magnetic fields using CT for a full time step.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
@@ -1496,21 +1699,25 @@ void integrate_2d_ctu(DomainS *pD)
  * Add geometric source terms
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
       hdtodx2 = hdt/(r[i]*pG->dx2);
 
       /* Calculate d at time n+1/2 */
-      dhalf[j][i] = pG->U[ks][j][i].d
+      dhalf[j][i] = GRID_U(pG,ks,j,i,d)
         - hdtodx1*(rsf*x1Flux[j  ][i+1].d - lsf*x1Flux[j][i].d)
         - hdtodx2*(    x2Flux[j+1][i  ].d -     x2Flux[j][i].d);
 
 #ifdef FARGO
       dtodx2 = pG->dt/(r[i]*pG->dx2);
       /* Save current R/phi momenta */
-      Mrn = pG->U[ks][j][i].M1;
-      Mpn = pG->U[ks][j][i].M2;
+      Mrn = GRID_U(pG,ks,j,i,M1);
+      Mpn = GRID_U(pG,ks,j,i,M2);
 
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
@@ -1530,17 +1737,17 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
         g = (phir-phil)*dx1i;
-	Mre -= pG->dt*pG->U[ks][j][i].d*g;
+	Mre -= pG->dt*GRID_U(pG,ks,j,i,d)*g;
 
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-	Mpe -= dtodx2*(phir-phil)*pG->U[ks][j][i].d;
+	Mpe -= dtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
       }
 
-        Mre += pG->dt*pG->U[ks][j][i].d *r[i]*SQR((*OrbitalProfile)(r[i]));
+        Mre += pG->dt*GRID_U(pG,ks,j,i,d) *r[i]*SQR((*OrbitalProfile)(r[i]));
 #ifdef ROTATING_FRAME
-        Mre += (pG->dt)*2.0*Omega_0*(pG->U[ks][j][i].M2+pG->U[ks][j][i].d*Om*x1vc(pG,i));
-        Mpe -= (pG->dt)*2.0*Omega_0*pG->U[ks][j][i].M1;
+        Mre += (pG->dt)*2.0*Omega_0*(GRID_U(pG,ks,j,i,M2)+GRID_U(pG,ks,j,i,d)*Om*x1vc(pG,i));
+        Mpe -= (pG->dt)*2.0*Omega_0*GRID_U(pG,ks,j,i,M1);
 #endif
 
       /* Average forward euler and current values to approximate at t^{n+1/2} */
@@ -1552,10 +1759,10 @@ void integrate_2d_ctu(DomainS *pD)
 #else /* FARGO */
 
       /* Calculate m1 and m2 at time n+1/2 */
-      M1h = pG->U[ks][j][i].M1
+      M1h = GRID_U(pG,ks,j,i,M1)
         - hdtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx)
         - hdtodx2*(    x2Flux[j+1][i].Mz -     x2Flux[j][i].Mz);
-      M2h = pG->U[ks][j][i].M2
+      M2h = GRID_U(pG,ks,j,i,M2)
         - hdtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My)
         - hdtodx2*(         x2Flux[j+1][i].Mx -          x2Flux[j][i].Mx);
       /* Add the geometric source term */
@@ -1567,16 +1774,16 @@ void integrate_2d_ctu(DomainS *pD)
         phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
         g = (phir-phil)*dx1i;
-        M1h -= hdt*pG->U[ks][j][i].d*g;
+        M1h -= hdt*GRID_U(pG,ks,j,i,d)*g;
 
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-        M2h -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        M2h -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
       }
 
 #ifdef ROTATING_FRAME
-        M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
-	M2h -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+        M1h += (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M2);
+	M2h -= (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
       /* compute geometric source term at time n+1/2 */
       geom_src[j][i] = SQR(M2h)/dhalf[j][i];
@@ -1590,7 +1797,7 @@ void integrate_2d_ctu(DomainS *pD)
       geom_src[j][i] += Iso_csound2*dhalf[j][i];
 #ifdef MHD
       B1ch = 0.5*(rsf*B1_x1Face[j][i+1] + lsf*B1_x1Face[j][i]);
-      B3ch = pG->U[ks][j][i].B3c
+      B3ch = GRID_U(pG,ks,j,i,B3c)
         - hdtodx1*(rsf*x1Flux[j  ][i+1].Bz - lsf*x1Flux[j][i].Bz)
         - hdtodx2*(    x2Flux[j+1][i  ].By -     x2Flux[j][i].By);
       geom_src[j][i] += 0.5*(SQR(B1ch)+SQR(B2ch)+SQR(B3ch));
@@ -1603,18 +1810,18 @@ void integrate_2d_ctu(DomainS *pD)
 
 #ifdef FARGO
       /* Use average values to apply source terms for full time-step */
-      pG->U[ks][j][i].M1 += pG->dt*( 2.0*Om*Mpav + geom_src[j][i]);
-      pG->U[ks][j][i].M2 += pG->dt*( Om*(qshear-2.0)*Mrav);
+      GRID_U(pG,ks,j,i,M1) += pG->dt*( 2.0*Om*Mpav + geom_src[j][i]);
+      GRID_U(pG,ks,j,i,M2) += pG->dt*( Om*(qshear-2.0)*Mrav);
 #ifdef ROTATING_FRAME
-      pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
-      pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*Mrav;
+      GRID_U(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
+      GRID_U(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*Mrav;
 #endif 
 #else /* FARGO*/
       /* add time-centered geometric source term for full dt */
-      pG->U[ks][j][i].M1 += pG->dt*geom_src[j][i];
+      GRID_U(pG,ks,j,i,M1) += pG->dt*geom_src[j][i];
 #ifdef ROTATING_FRAME
-      pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*M2h;
-      pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*M1h;
+      GRID_U(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*M2h;
+      GRID_U(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*M1h;
 #endif /* ROTATING_FRAME */
 #endif /* FARGO */
     }
@@ -1633,18 +1840,22 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef SHEARING_BOX
   fact = om_dt/(2. + (2.-qshear)*om_dt*om_dt);
   qom = qshear*Omega_0;
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for(j=js; j<=je; j++) {
     for(i=is; i<=ie; i++) {
       cc_pos(pG,i,j,ks,&x1,&x2,&x3);
 
 /* Store the current state */
-      M1n  = pG->U[ks][j][i].M1;
+      M1n  = GRID_U(pG,ks,j,i,M1);
 #ifdef FARGO
-      if (ShBoxCoord==xy) dM2n = pG->U[ks][j][i].M2;
-      if (ShBoxCoord==xz) dM3n = pG->U[ks][j][i].M3;
+      if (ShBoxCoord==xy) dM2n = GRID_U(pG,ks,j,i,M2);
+      if (ShBoxCoord==xz) dM3n = GRID_U(pG,ks,j,i,M3);
 #else
-      if (ShBoxCoord==xy) dM2n = pG->U[ks][j][i].M2 + qom*x1*pG->U[ks][j][i].d;
-      if (ShBoxCoord==xz) dM3n = pG->U[ks][j][i].M3 + qom*x1*pG->U[ks][j][i].d;
+      if (ShBoxCoord==xy) dM2n = GRID_U(pG,ks,j,i,M2) + qom*x1*GRID_U(pG,ks,j,i,d);
+      if (ShBoxCoord==xz) dM3n = GRID_U(pG,ks,j,i,M3) + qom*x1*GRID_U(pG,ks,j,i,d);
 #endif
 
 /* Calculate the flux for the y-momentum fluctuation (M3 in 2D) */
@@ -1699,17 +1910,17 @@ void integrate_2d_ctu(DomainS *pD)
  * discretization for the momentum fluctuation equation. */
 
       if (ShBoxCoord==xy){
-        pG->U[ks][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[ks][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+        GRID_U(pG,ks,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        GRID_U(pG,ks,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 #ifndef FARGO
-        pG->U[ks][j][i].M2 -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
+        GRID_U(pG,ks,j,i,M2) -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
 #endif
       }
       if (ShBoxCoord==xz){
-        pG->U[ks][j][i].M1 += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[ks][j][i].M3 += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
+        GRID_U(pG,ks,j,i,M1) += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        GRID_U(pG,ks,j,i,M3) += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
 #ifndef FARGO
-        pG->U[ks][j][i].M3 -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
+        GRID_U(pG,ks,j,i,M3) -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
 #endif
       }
 
@@ -1720,14 +1931,14 @@ void integrate_2d_ctu(DomainS *pD)
       phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
       phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
                                    x1Flux[j][i+1].d*(phir - phic));
 #endif
 
       phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
       phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                    x2Flux[j+1][i].d*(phir - phic));
 #endif
     }
@@ -1736,6 +1947,10 @@ void integrate_2d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
         cc_pos(pG,i,j,ks,&x1,&x2,&x3);
@@ -1751,24 +1966,24 @@ void integrate_2d_ctu(DomainS *pD)
         g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif /* CYLINDRICAL */
-        pG->U[ks][j][i].M1 -= pG->dt*dhalf[j][i]*g;
+        GRID_U(pG,ks,j,i,M1) -= pG->dt*dhalf[j][i]*g;
 
 #ifndef BAROTROPIC
 #ifdef CYLINDRICAL
-        pG->U[ks][j][i].E -= hdt*g*(lsf*x1Flux[j][i  ].d +
+        GRID_U(pG,ks,j,i,E) -= hdt*g*(lsf*x1Flux[j][i  ].d +
                                      rsf*x1Flux[j][i+1].d);
 #else        
-        pG->U[ks][j][i].E -= dtodx1*(lsf*x1Flux[j][i  ].d*(phic - phil) +
+        GRID_U(pG,ks,j,i,E) -= dtodx1*(lsf*x1Flux[j][i  ].d*(phic - phil) +
                                      rsf*x1Flux[j][i+1].d*(phir - phic));
 #endif
 #endif
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        pG->U[ks][j][i].M2 -= dtodx2*dhalf[j][i]*(phir-phil);
+        GRID_U(pG,ks,j,i,M2) -= dtodx2*dhalf[j][i]*(phir-phil);
 
 #ifndef BAROTROPIC
-        pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+        GRID_U(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                      x2Flux[j+1][i].d*(phir - phic));
 #endif
       }
@@ -1785,6 +2000,10 @@ void integrate_2d_ctu(DomainS *pD)
 #ifdef SELF_GRAVITY
 /* Add fluxes and source terms due to (d/dx1) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++){
     for (i=is; i<=ie; i++){
       phic = pG->Phi[ks][j][i];
@@ -1808,10 +2027,10 @@ void integrate_2d_ctu(DomainS *pD)
       flux_m2r = gxr*gyr/four_pi_G;
 
 /* Update momenta and energy with d/dx1 terms  */
-      pG->U[ks][j][i].M1 -= dtodx1*(flux_m1r - flux_m1l);
-      pG->U[ks][j][i].M2 -= dtodx1*(flux_m2r - flux_m2l);
+      GRID_U(pG,ks,j,i,M1) -= dtodx1*(flux_m1r - flux_m1l);
+      GRID_U(pG,ks,j,i,M2) -= dtodx1*(flux_m2r - flux_m2l);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
                                    x1Flux[j][i+1].d*(phir - phic));
 #endif
     }
@@ -1819,6 +2038,10 @@ void integrate_2d_ctu(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx2) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++){
     for (i=is; i<=ie; i++){
       phic = pG->Phi[ks][j][i];
@@ -1842,16 +2065,20 @@ void integrate_2d_ctu(DomainS *pD)
       flux_m2r = 0.5*(gyr*gyr-gxr*gxr)/four_pi_G + grav_mean_rho*phir;
 
 /* Update momenta and energy with d/dx2 terms  */
-      pG->U[ks][j][i].M1 -= dtodx2*(flux_m1r - flux_m1l);
-      pG->U[ks][j][i].M2 -= dtodx2*(flux_m2r - flux_m2l);
+      GRID_U(pG,ks,j,i,M1) -= dtodx2*(flux_m1r - flux_m1l);
+      GRID_U(pG,ks,j,i,M2) -= dtodx2*(flux_m2r - flux_m2l);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                    x2Flux[j+1][i].d*(phir - phic));
 #endif
     }
   }
 
 /* Save mass fluxes in Grid structure for source term correction in main loop */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je+1; j++) {
     for (i=is; i<=ie+1; i++) {
       pG->x1MassFlux[ks][j][i] = x1Flux[j][i].d;
@@ -1866,10 +2093,14 @@ void integrate_2d_ctu(DomainS *pD)
 
 #ifndef BAROTROPIC
   if (CoolingFunc != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
         coolf = (*CoolingFunc)(dhalf[j][i],phalf[j][i],pG->dt);
-        pG->U[ks][j][i].E -= pG->dt*coolf;
+        GRID_U(pG,ks,j,i,E) -= pG->dt*coolf;
       }
     }
   }
@@ -1880,13 +2111,17 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef FEEDBACK
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++)
     for (i=is; i<=ie; i++) {
-      pG->U[ks][j][i].M1 -= pG->Coup[ks][j][i].fb1;
-      pG->U[ks][j][i].M2 -= pG->Coup[ks][j][i].fb2;
-      pG->U[ks][j][i].M3 -= pG->Coup[ks][j][i].fb3;
+      GRID_U(pG,ks,j,i,M1) -= pG->Coup[ks][j][i].fb1;
+      GRID_U(pG,ks,j,i,M2) -= pG->Coup[ks][j][i].fb2;
+      GRID_U(pG,ks,j,i,M3) -= pG->Coup[ks][j][i].fb3;
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E += pG->Coup[ks][j][i].Eloss;
+      GRID_U(pG,ks,j,i,E) += pG->Coup[ks][j][i].Eloss;
       pG->Coup[ks][j][i].Eloss *= dt1; /* for history output purpose */
 #endif
     }
@@ -1898,25 +2133,29 @@ void integrate_2d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 2D x1-fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[ks][j][i].d  -= dtodx1*(rsf*x1Flux[j][i+1].d  - lsf*x1Flux[j][i].d );
-      pG->U[ks][j][i].M1 -= dtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx);
-      pG->U[ks][j][i].M2 -= dtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My);
-      pG->U[ks][j][i].M3 -= dtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz);
+      GRID_U(pG,ks,j,i,d)  -= dtodx1*(rsf*x1Flux[j][i+1].d  - lsf*x1Flux[j][i].d );
+      GRID_U(pG,ks,j,i,M1) -= dtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx);
+      GRID_U(pG,ks,j,i,M2) -= dtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My);
+      GRID_U(pG,ks,j,i,M3) -= dtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E  -= dtodx1*(rsf*x1Flux[j][i+1].E  - lsf*x1Flux[j][i].E );
+      GRID_U(pG,ks,j,i,E)  -= dtodx1*(rsf*x1Flux[j][i+1].E  - lsf*x1Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B2c -= dtodx1*(x1Flux[j][i+1].By - x1Flux[j][i].By);
-      pG->U[ks][j][i].B3c -= dtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz);
+      GRID_U(pG,ks,j,i,B2c) -= dtodx1*(x1Flux[j][i+1].By - x1Flux[j][i].By);
+      GRID_U(pG,ks,j,i,B3c) -= dtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx1*(rsf*x1Flux[j][i+1].s[n] 
+        GRID_U(pG,ks,j,i,s[n]) -= dtodx1*(rsf*x1Flux[j][i+1].s[n] 
                                       - lsf*x1Flux[j][i  ].s[n]);
 #endif
     }
@@ -1926,28 +2165,35 @@ void integrate_2d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 2D x2-fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE) CFL_REDUCTION
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
       dtodx2 = pG->dt/(r[i]*pG->dx2);
 #endif
-      pG->U[ks][j][i].d  -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
-      pG->U[ks][j][i].M1 -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
-      pG->U[ks][j][i].M2 -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
-      pG->U[ks][j][i].M3 -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
+      GRID_U(pG,ks,j,i,d)  -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
+      GRID_U(pG,ks,j,i,M1) -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
+      GRID_U(pG,ks,j,i,M2) -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
+      GRID_U(pG,ks,j,i,M3) -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E  -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
+      GRID_U(pG,ks,j,i,E)  -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B3c -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
-      pG->U[ks][j][i].B1c -= dtodx2*(x2Flux[j+1][i].Bz - x2Flux[j][i].Bz);
+      GRID_U(pG,ks,j,i,B3c) -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
+      GRID_U(pG,ks,j,i,B1c) -= dtodx2*(x2Flux[j+1][i].Bz - x2Flux[j][i].Bz);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx2*(x2Flux[j+1][i].s[n] 
+        GRID_U(pG,ks,j,i,s[n]) -= dtodx2*(x2Flux[j+1][i].s[n] 
                                          - x2Flux[j  ][i].s[n]);
 #endif
     }
+#if defined(FUSED_CFL) && !defined(MHD)
+    new_dt_speeds(pG,j,ks,&cfl_v1,&cfl_v2,&cfl_v3);
+#endif
   }
 
 /*--- Step 12c: Not needed in 2D ---*/
@@ -1956,18 +2202,31 @@ void integrate_2d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE) CFL_REDUCTION
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[ks][j][i].B1c =0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
-      pG->U[ks][j][i].B2c =0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
+      GRID_U(pG,ks,j,i,B1c) =0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
+      GRID_U(pG,ks,j,i,B2c) =0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
       /* Set the 3-interface magnetic field equal to the cell center field. */
-      pG->B3i[ks][j][i] = pG->U[ks][j][i].B3c;
+      pG->B3i[ks][j][i] = GRID_U(pG,ks,j,i,B3c);
     }
+#ifdef FUSED_CFL
+    new_dt_speeds(pG,j,ks,&cfl_v1,&cfl_v2,&cfl_v3);
+#endif
   }
 #endif /* MHD */
+#ifdef FUSED_CFL
+  pG->max_v1 = cfl_v1;
+  pG->max_v2 = cfl_v2;
+  pG->max_v3 = cfl_v3;
+  pG->cfl_set = 1;
+#endif /* FUSED_CFL */
 
 #ifdef STATIC_MESH_REFINEMENT
 /*--- Step 12e -----------------------------------------------------------------
@@ -2134,7 +2393,7 @@ void integrate_2d_ctu(DomainS *pD)
  *  \brief Allocate temporary integration arrays */
 void integrate_init_2d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,nl,nd;
+  int nmax,size1=0,size2=0,nl,nd,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -2167,8 +2426,6 @@ void integrate_init_2d(MeshS *pM)
     goto on_error;
 #endif /* H_CORRECTION */
 
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
 
 #ifdef MHD
   if ((B1_x1Face = (Real**)calloc_2d_array(size2, size1, sizeof(Real))) == NULL)
@@ -2177,12 +2434,21 @@ void integrate_init_2d(MeshS *pM)
     goto on_error;
 #endif /* MHD */
 
-  if ((U1d= (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ul = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ur = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* 1D scratch vectors are private to each OpenMP thread */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel reduction(+:nerr)
+#endif
+  {
+    if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) nerr++;
+    if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) nerr++;
+    if ((U1d= (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((Ul = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((Ur = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((W  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+    if ((Wl = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+    if ((Wr = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+  }
+  if (nerr > 0) goto on_error;
 
   if ((Ul_x1Face=(Cons1DS**)calloc_2d_array(size2,size1,sizeof(Cons1DS)))==NULL)
     goto on_error;
@@ -2238,19 +2504,24 @@ void integrate_destruct_2d(void)
   if (eta1 != NULL) free_2d_array(eta1);
   if (eta2 != NULL) free_2d_array(eta2);
 #endif /* H_CORRECTION */
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
   if (B1_x1Face != NULL) free_2d_array(B1_x1Face);
   if (B2_x2Face != NULL) free_2d_array(B2_x2Face);
 #endif /* MHD */
 
-  if (U1d      != NULL) free(U1d);
-  if (Ul       != NULL) free(Ul);
-  if (Ur       != NULL) free(Ur);
-  if (W        != NULL) free(W);
-  if (Wl       != NULL) free(Wl);
-  if (Wr       != NULL) free(Wr);
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
+  {
+    if (Bxc != NULL) free(Bxc);
+    if (Bxi != NULL) free(Bxi);
+    if (U1d != NULL) free(U1d);
+    if (Ul  != NULL) free(Ul);
+    if (Ur  != NULL) free(Ur);
+    if (W   != NULL) free(W);
+    if (Wl  != NULL) free(Wl);
+    if (Wr  != NULL) free(Wr);
+  }
 
   if (Ul_x1Face != NULL) free_2d_array(Ul_x1Face);
   if (Ur_x1Face != NULL) free_2d_array(Ur_x1Face);
@@ -2285,6 +2556,9 @@ static void integrate_emf3_corner(GridS *pG)
   js = pG->js;   je = pG->je;
 
 /* NOTE: The x1-Flux of B2 is -E3.  The x2-Flux of B1 is +E3. */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,emf_l1,emf_r1,emf_l2,emf_r2) firstprivate(rsf,lsf)
+#endif
   for (j=js-1; j<=je+2; j++) {
     for (i=is-1; i<=ie+2; i++) {
 #ifdef CYLINDRICAL
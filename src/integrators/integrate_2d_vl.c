@@ -62,7 +62,7 @@ static Real **emf3=NULL, **emf3_cc=NULL;
 /* 1D scratch vectors used by lr_states and flux functions */
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W1d=NULL, *Wl=NULL, *Wr=NULL;
-static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL;
+static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL, *F1d=NULL;
 
 /* conserved and primitive variables at t^{n+1/2} computed in predict step */
 static ConsS **Uhalf=NULL;
@@ -98,6 +98,9 @@ static void ApplyCorr(GridS *pG, int i, int j,
 void integrate_2d_vl(DomainS *pD)
 {
   GridS *pG=(pD->Grid);
+#ifdef FUSED_CFL
+  Real cfl_v1=0.0,cfl_v2=0.0,cfl_v3=0.0;
+#endif
   PrimS W,Whalf;
   Real dtodx1=pG->dt/pG->dx1, dtodx2=pG->dt/pG->dx2;
   Real hdtodx1 = 0.5*dtodx1, hdtodx2 = 0.5*dtodx2;
@@ -130,6 +133,7 @@ void integrate_2d_vl(DomainS *pD)
   int flag_cell=0,negd=0,negP=0,superl=0,NaNFlux=0;
   Real Vsq;
   Int3Vect BadCell;
+  ConsS Ufofc;
 #endif
   int il=is-(nghost-1), iu=ie+(nghost-1);
   int jl=js-(nghost-1), ju=je+(nghost-1);
@@ -154,7 +158,7 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
-      Uhalf[j][i] = pG->U[ks][j][i];
+      Uhalf[j][i] = GET_GRID_U(pG,ks,j,i);
 #ifdef MHD
       B1_x1Face[j][i] = pG->B1i[ks][j][i];
       B2_x2Face[j][i] = pG->B2i[ks][j][i];
@@ -172,21 +176,21 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
-      U1d[i].d  = pG->U[ks][j][i].d;
-      U1d[i].Mx = pG->U[ks][j][i].M1;
-      U1d[i].My = pG->U[ks][j][i].M2;
-      U1d[i].Mz = pG->U[ks][j][i].M3;
+      U1d[i].d  = GRID_U(pG,ks,j,i,d);
+      U1d[i].Mx = GRID_U(pG,ks,j,i,M1);
+      U1d[i].My = GRID_U(pG,ks,j,i,M2);
+      U1d[i].Mz = GRID_U(pG,ks,j,i,M3);
 #ifndef BAROTROPIC
-      U1d[i].E  = pG->U[ks][j][i].E;
+      U1d[i].E  = GRID_U(pG,ks,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-      U1d[i].By = pG->U[ks][j][i].B2c;
-      U1d[i].Bz = pG->U[ks][j][i].B3c;
-      Bxc[i] = pG->U[ks][j][i].B1c;
+      U1d[i].By = GRID_U(pG,ks,j,i,B2c);
+      U1d[i].Bz = GRID_U(pG,ks,j,i,B3c);
+      Bxc[i] = GRID_U(pG,ks,j,i,B1c);
       Bxi[i] = pG->B1i[ks][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-      for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[ks][j][i].s[n];
+      for (n=0; n<NSCALARS; n++) U1d[i].s[n] = GRID_U(pG,ks,j,i,s[n]);
 #endif
     }
 
@@ -212,9 +216,7 @@ void integrate_2d_vl(DomainS *pD)
 /*--- Step 1d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
-    for (i=il; i<=ie+nghost; i++) {
-      fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1Flux[j][i]);
-    }
+    fluxes_pencil(il,ie+nghost,Ul,Ur,Wl,Wr,Bxi,x1Flux[j]);
   }
 
 /*=== STEP 2: Compute first-order fluxes at t^{n} in x2-direction ============*/
@@ -227,21 +229,21 @@ void integrate_2d_vl(DomainS *pD)
 
   for (i=is-nghost; i<=ie+nghost; i++) {
     for (j=js-nghost; j<=je+nghost; j++) {
-      U1d[j].d  = pG->U[ks][j][i].d;
-      U1d[j].Mx = pG->U[ks][j][i].M2;
-      U1d[j].My = pG->U[ks][j][i].M3;
-      U1d[j].Mz = pG->U[ks][j][i].M1;
+      U1d[j].d  = GRID_U(pG,ks,j,i,d);
+      U1d[j].Mx = GRID_U(pG,ks,j,i,M2);
+      U1d[j].My = GRID_U(pG,ks,j,i,M3);
+      U1d[j].Mz = GRID_U(pG,ks,j,i,M1);
 #ifndef BAROTROPIC
-      U1d[j].E  = pG->U[ks][j][i].E;
+      U1d[j].E  = GRID_U(pG,ks,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-      U1d[j].By = pG->U[ks][j][i].B3c;
-      U1d[j].Bz = pG->U[ks][j][i].B1c;
-      Bxc[j] = pG->U[ks][j][i].B2c;
+      U1d[j].By = GRID_U(pG,ks,j,i,B3c);
+      U1d[j].Bz = GRID_U(pG,ks,j,i,B1c);
+      Bxc[j] = GRID_U(pG,ks,j,i,B2c);
       Bxi[j] = pG->B2i[ks][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-      for (n=0; n<NSCALARS; n++) U1d[j].s[n] = pG->U[ks][j][i].s[n];
+      for (n=0; n<NSCALARS; n++) U1d[j].s[n] = GRID_U(pG,ks,j,i,s[n]);
 #endif
     }
 
@@ -267,8 +269,9 @@ void integrate_2d_vl(DomainS *pD)
 /*--- Step 2d ------------------------------------------------------------------
  * Compute flux in x2-direction */
 
+    fluxes_pencil(jl,je+nghost,Ul,Ur,Wl,Wr,Bxi,F1d);
     for (j=jl; j<=je+nghost; j++) {
-      fluxes(Ul[j],Ur[j],Wl[j],Wr[j],Bxi[j],&x2Flux[j][i]);
+      x2Flux[j][i] = F1d[j];
     }
   }
 
@@ -284,7 +287,7 @@ void integrate_2d_vl(DomainS *pD)
 #ifdef MHD
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
-      Whalf = Cons_to_Prim(&pG->U[ks][j][i]);
+      Whalf = Cons_to_Prim(&Uhalf[j][i]);
       emf3_cc[j][i] = (Whalf.B1c*Whalf.V2 - Whalf.B2c*Whalf.V1);
     }
   }
@@ -422,7 +425,7 @@ void integrate_2d_vl(DomainS *pD)
         g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif /* CYLINDRICAL */
-        Uhalf[j][i].M1 -= hdt*pG->U[ks][j][i].d*g;
+        Uhalf[j][i].M1 -= hdt*GRID_U(pG,ks,j,i,d)*g;
 #ifndef BAROTROPIC
         Uhalf[j][i].E -= hdtodx1*(lsf*x1Flux[j][i  ].d*(phic - phil)
                                 + rsf*x1Flux[j][i+1].d*(phir - phic));
@@ -430,7 +433,7 @@ void integrate_2d_vl(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[j][i].E -= hdtodx2*(x2Flux[j  ][i].d*(phic - phil)
                                 + x2Flux[j+1][i].d*(phir - phic));
@@ -451,7 +454,7 @@ void integrate_2d_vl(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i+1]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j][i-1]);
 
-      Uhalf[j][i].M1 -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+      Uhalf[j][i].M1 -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
       Uhalf[j][i].E -= hdtodx1*(x1Flux[j][i  ].d*(phic - phil)
                               + x1Flux[j][i+1].d*(phir - phic));
@@ -459,7 +462,7 @@ void integrate_2d_vl(DomainS *pD)
       phir = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j+1][i]);
       phil = 0.5*(pG->Phi[ks][j][i] + pG->Phi[ks][j-1][i]);
 
-      Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+      Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
       Uhalf[j][i].E -= hdtodx2*(x2Flux[j  ][i].d*(phic - phil)
                               + x2Flux[j+1][i].d*(phir - phic));
@@ -485,7 +488,7 @@ void integrate_2d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Uhalf[j][i].M1 -= hdtodx1*(phir-phil)*pG->U[ks][j][i].d;
+        Uhalf[j][i].M1 -= hdtodx1*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[j][i].E -= hdtodx1*(x1Flux[j][i  ].d*(phic - phil)
                                 + x1Flux[j][i+1].d*(phir - phic));
@@ -493,7 +496,7 @@ void integrate_2d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*pG->U[ks][j][i].d;
+        Uhalf[j][i].M2 -= hdtodx2*(phir-phil)*GRID_U(pG,ks,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[j][i].E -= hdtodx2*(x2Flux[j  ][i].d*(phic - phil)
                                 + x2Flux[j+1][i].d*(phir - phic));
@@ -505,11 +508,11 @@ void integrate_2d_vl(DomainS *pD)
   if (ShBoxCoord == xz){
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        Uhalf[j][i].M1 += om_dt*pG->U[ks][j][i].M3;
+        Uhalf[j][i].M1 += om_dt*GRID_U(pG,ks,j,i,M3);
 #ifdef FARGO
-        Uhalf[j][i].M3 += 0.5*om_dt*(qshear-2.)*pG->U[ks][j][i].M1;
+        Uhalf[j][i].M3 += 0.5*om_dt*(qshear-2.)*GRID_U(pG,ks,j,i,M1);
 #else /* FARGO */
-        Uhalf[j][i].M3 -= om_dt*pG->U[ks][j][i].M1;
+        Uhalf[j][i].M3 -= om_dt*GRID_U(pG,ks,j,i,M1);
 #endif /* FARGO */
       }
     }
@@ -518,11 +521,11 @@ void integrate_2d_vl(DomainS *pD)
   if (ShBoxCoord == xy){
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        Uhalf[j][i].M1 += om_dt*pG->U[ks][j][i].M2;
+        Uhalf[j][i].M1 += om_dt*GRID_U(pG,ks,j,i,M2);
 #ifdef FARGO
-        Uhalf[j][i].M2 += 0.5*om_dt*(qshear-2.)*pG->U[ks][j][i].M1;
+        Uhalf[j][i].M2 += 0.5*om_dt*(qshear-2.)*GRID_U(pG,ks,j,i,M1);
 #else /* FARGO */
-        Uhalf[j][i].M2 -= om_dt*pG->U[ks][j][i].M1;
+        Uhalf[j][i].M2 -= om_dt*GRID_U(pG,ks,j,i,M1);
 #endif /* FARGO */
       }
     }
@@ -535,8 +538,8 @@ void integrate_2d_vl(DomainS *pD)
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
       /* This *is* a half-timestep update below (see note above) */
-      Uhalf[j][i].M1 += pG->dt*Om*pG->U[ks][j][i].M2;
-      Uhalf[j][i].M2 += hdt*(qshear - 2.0)*Om*pG->U[ks][j][i].M1;
+      Uhalf[j][i].M1 += pG->dt*Om*GRID_U(pG,ks,j,i,M2);
+      Uhalf[j][i].M2 += hdt*(qshear - 2.0)*Om*GRID_U(pG,ks,j,i,M1);
     }
   }
 #endif
@@ -550,24 +553,24 @@ void integrate_2d_vl(DomainS *pD)
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
 
-      Ekin = 0.5*(SQR(pG->U[ks][j][i].M1)+SQR(pG->U[ks][j][i].M2)+SQR(pG->U[ks][j][i].M3))/pG->U[ks][j][i].d;
+      Ekin = 0.5*(SQR(GRID_U(pG,ks,j,i,M1))+SQR(GRID_U(pG,ks,j,i,M2))+SQR(GRID_U(pG,ks,j,i,M3)))/GRID_U(pG,ks,j,i,d);
 #ifdef MHD
-      B2sq = SQR(pG->U[ks][j][i].B2c);
-      Emag = 0.5*(SQR(pG->U[ks][j][i].B1c) + B2sq + SQR(pG->U[ks][j][i].B3c));
+      B2sq = SQR(GRID_U(pG,ks,j,i,B2c));
+      Emag = 0.5*(SQR(GRID_U(pG,ks,j,i,B1c)) + B2sq + SQR(GRID_U(pG,ks,j,i,B3c)));
 #else
       B2sq = 0.0;
       Emag = 0.0;
 #endif
 
 #ifdef ISOTHERMAL
-      Ptot = Iso_csound2*pG->U[ks][j][i].d;
+      Ptot = Iso_csound2*GRID_U(pG,ks,j,i,d);
 #else
-      Ptot = Gamma_1*(pG->U[ks][j][i].E - Ekin - Emag);
+      Ptot = Gamma_1*(GRID_U(pG,ks,j,i,E) - Ekin - Emag);
 #endif
       Ptot = MAX(Ptot,TINY_NUMBER);
       Ptot += Emag;
 
-      Uhalf[j][i].M1 += hdt*(SQR(pG->U[ks][j][i].M2)/pG->U[ks][j][i].d - B2sq + Ptot)/r[i];
+      Uhalf[j][i].M1 += hdt*(SQR(GRID_U(pG,ks,j,i,M2))/GRID_U(pG,ks,j,i,d) - B2sq + Ptot)/r[i];
     }
   }
 #endif /* CYLINDRICAL */
@@ -703,13 +706,12 @@ void integrate_2d_vl(DomainS *pD)
  */
 
   for (j=js-1; j<=je+1; j++) {
-    for (i=is; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+    for (i=is; i<=ie+1; i++) {
       etah = MAX(eta2[j][i-1],eta2[j][i]);
       etah = MAX(etah,eta2[j+1][i-1]);
       etah = MAX(etah,eta2[j+1][i  ]);
       etah = MAX(etah,eta1[j  ][i  ]);
-#endif /* H_CORRECTION */
 #ifdef MHD
       Bx = B1_x1Face[j][i];
 #endif
@@ -717,8 +719,20 @@ void integrate_2d_vl(DomainS *pD)
       Ur[i] = Prim1D_to_Cons1D(&Wr_x1Face[j][i],&Bx);
 
       fluxes(Ul[i],Ur[i],Wl_x1Face[j][i],Wr_x1Face[j][i],Bx,&x1Flux[j][i]);
+    }
+#else
+    for (i=is; i<=ie+1; i++) {
+#ifdef MHD
+      Bxi[i] = B1_x1Face[j][i];
+#endif
+      Ul[i] = Prim1D_to_Cons1D(&Wl_x1Face[j][i],&Bxi[i]);
+      Ur[i] = Prim1D_to_Cons1D(&Wr_x1Face[j][i],&Bxi[i]);
+    }
+    fluxes_pencil(is,ie+1,Ul,Ur,Wl_x1Face[j],Wr_x1Face[j],Bxi,x1Flux[j]);
+#endif /* H_CORRECTION */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
+    for (i=is; i<=ie+1; i++) {
 /* revert to predictor flux if this flux Nan'ed */
       if ((x1Flux[j][i].d  != x1Flux[j][i].d)  ||
 #ifndef BAROTROPIC
@@ -734,8 +748,8 @@ void integrate_2d_vl(DomainS *pD)
         x1Flux[j][i] = x1FluxP[j][i];
         NaNFlux++;
       }
-#endif
     }
+#endif
   }
 
 /*--- Step 10c -----------------------------------------------------------------
@@ -743,13 +757,12 @@ void integrate_2d_vl(DomainS *pD)
  */
 
   for (j=js; j<=je+1; j++) {
-    for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+    for (i=is-1; i<=ie+1; i++) {
       etah = MAX(eta1[j-1][i],eta1[j][i]);
       etah = MAX(etah,eta1[j-1][i+1]);
       etah = MAX(etah,eta1[j  ][i+1]);
       etah = MAX(etah,eta2[j  ][i]);
-#endif /* H_CORRECTION */
 #ifdef MHD
       Bx = B2_x2Face[j][i];
 #endif
@@ -757,8 +770,20 @@ void integrate_2d_vl(DomainS *pD)
       Ur[i] = Prim1D_to_Cons1D(&Wr_x2Face[j][i],&Bx);
 
       fluxes(Ul[i],Ur[i],Wl_x2Face[j][i],Wr_x2Face[j][i],Bx,&x2Flux[j][i]);
+    }
+#else
+    for (i=is-1; i<=ie+1; i++) {
+#ifdef MHD
+      Bxi[i] = B2_x2Face[j][i];
+#endif
+      Ul[i] = Prim1D_to_Cons1D(&Wl_x2Face[j][i],&Bxi[i]);
+      Ur[i] = Prim1D_to_Cons1D(&Wr_x2Face[j][i],&Bxi[i]);
+    }
+    fluxes_pencil(is-1,ie+1,Ul,Ur,Wl_x2Face[j],Wr_x2Face[j],Bxi,x2Flux[j]);
+#endif /* H_CORRECTION */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
+    for (i=is-1; i<=ie+1; i++) {
 /* revert to predictor flux if this flux NaN'ed */
       if ((x2Flux[j][i].d  != x2Flux[j][i].d)  ||
 #ifndef BAROTROPIC
@@ -774,8 +799,8 @@ void integrate_2d_vl(DomainS *pD)
         x2Flux[j][i] = x2FluxP[j][i];
         NaNFlux++;
       }
-#endif
     }
+#endif
   }
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
@@ -836,8 +861,8 @@ void integrate_2d_vl(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[ks][j][i].B1c = 0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
-      pG->U[ks][j][i].B2c = 0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
+      GRID_U(pG,ks,j,i,B1c) = 0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
+      GRID_U(pG,ks,j,i,B2c) = 0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
     }
   }
 #endif /* MHD */
@@ -860,13 +885,13 @@ void integrate_2d_vl(DomainS *pD)
       cc_pos(pG,i,j,ks,&x1,&x2,&x3);
 
 /* Store the current state */
-      M1n  = pG->U[ks][j][i].M1;
+      M1n  = GRID_U(pG,ks,j,i,M1);
 #ifdef FARGO
-      if (ShBoxCoord==xy) dM2n = pG->U[ks][j][i].M2;
-      if (ShBoxCoord==xz) dM3n = pG->U[ks][j][i].M3;
+      if (ShBoxCoord==xy) dM2n = GRID_U(pG,ks,j,i,M2);
+      if (ShBoxCoord==xz) dM3n = GRID_U(pG,ks,j,i,M3);
 #else
-      if (ShBoxCoord==xy) dM2n = pG->U[ks][j][i].M2 + qom*x1*pG->U[ks][j][i].d;
-      if (ShBoxCoord==xz) dM3n = pG->U[ks][j][i].M3 + qom*x1*pG->U[ks][j][i].d;
+      if (ShBoxCoord==xy) dM2n = GRID_U(pG,ks,j,i,M2) + qom*x1*GRID_U(pG,ks,j,i,d);
+      if (ShBoxCoord==xz) dM3n = GRID_U(pG,ks,j,i,M3) + qom*x1*GRID_U(pG,ks,j,i,d);
 #endif
 
 /* Calculate the flux for the y-momentum fluctuation (M3 in 2D) */
@@ -916,17 +941,17 @@ void integrate_2d_vl(DomainS *pD)
  * discretization for the momentum fluctuation equation. */
 
       if (ShBoxCoord==xy){
-        pG->U[ks][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[ks][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+        GRID_U(pG,ks,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        GRID_U(pG,ks,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 #ifndef FARGO
-        pG->U[ks][j][i].M2 -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
+        GRID_U(pG,ks,j,i,M2) -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
 #endif
       }
       if (ShBoxCoord==xz){
-        pG->U[ks][j][i].M1 += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[ks][j][i].M3 += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
+        GRID_U(pG,ks,j,i,M1) += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        GRID_U(pG,ks,j,i,M3) += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
 #ifndef FARGO
-        pG->U[ks][j][i].M3 -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
+        GRID_U(pG,ks,j,i,M3) -=0.5*qshear*om_dt*(x1Flux[j][i].d+x1Flux[j][i+1].d);
 #endif
       }
 
@@ -937,14 +962,14 @@ void integrate_2d_vl(DomainS *pD)
       phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
       phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
                                    x1Flux[j][i+1].d*(phir - phic));
 #endif
 
       phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
       phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                    x2Flux[j+1][i].d*(phir - phic));
 #endif
     }
@@ -968,17 +993,17 @@ void integrate_2d_vl(DomainS *pD)
         g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif
-        pG->U[ks][j][i].M1 -= pG->dt*Uhalf[j][i].d*g;
+        GRID_U(pG,ks,j,i,M1) -= pG->dt*Uhalf[j][i].d*g;
 #ifndef BAROTROPIC
-        pG->U[ks][j][i].E -= dtodx1*(lsf*x1Flux[j][i  ].d*(phic - phil)
+        GRID_U(pG,ks,j,i,E) -= dtodx1*(lsf*x1Flux[j][i  ].d*(phic - phil)
                                    + rsf*x1Flux[j][i+1].d*(phir - phic));
 #endif
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        pG->U[ks][j][i].M2 -= dtodx2*(phir-phil)*Uhalf[j][i].d;
+        GRID_U(pG,ks,j,i,M2) -= dtodx2*(phir-phil)*Uhalf[j][i].d;
 #ifndef BAROTROPIC
-        pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil)
+        GRID_U(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil)
                                    + x2Flux[j+1][i].d*(phir - phic));
 #endif
       }
@@ -1017,10 +1042,10 @@ void integrate_2d_vl(DomainS *pD)
       flx_m2r = gxr*gyr/four_pi_G;
 
 /* Update momenta and energy with d/dx1 terms  */
-      pG->U[ks][j][i].M1 -= dtodx1*(flx_m1r - flx_m1l);
-      pG->U[ks][j][i].M2 -= dtodx1*(flx_m2r - flx_m2l);
+      GRID_U(pG,ks,j,i,M1) -= dtodx1*(flx_m1r - flx_m1l);
+      GRID_U(pG,ks,j,i,M2) -= dtodx1*(flx_m2r - flx_m2l);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx1*(x1Flux[j][i  ].d*(phic - phil) +
                                    x1Flux[j][i+1].d*(phir - phic));
 #endif /* BAROTROPIC */
     }
@@ -1051,10 +1076,10 @@ void integrate_2d_vl(DomainS *pD)
       flx_m2r = 0.5*(gyr*gyr-gxr*gxr)/four_pi_G + grav_mean_rho*phir;
 
 /* Update momenta and energy with d/dx2 terms  */
-      pG->U[ks][j][i].M1 -= dtodx2*(flx_m1r - flx_m1l);
-      pG->U[ks][j][i].M2 -= dtodx2*(flx_m2r - flx_m2l);
+      GRID_U(pG,ks,j,i,M1) -= dtodx2*(flx_m1r - flx_m1l);
+      GRID_U(pG,ks,j,i,M2) -= dtodx2*(flx_m2r - flx_m2l);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
+      GRID_U(pG,ks,j,i,E) -= dtodx2*(x2Flux[j  ][i].d*(phic - phil) +
                                    x2Flux[j+1][i].d*(phir - phic));
 #endif /* BAROTROPIC */
     }
@@ -1096,14 +1121,14 @@ void integrate_2d_vl(DomainS *pD)
       Ptot = MAX(Ptot,TINY_NUMBER);
       Ptot += Emag;
 
-      pG->U[ks][j][i].M1 += pG->dt*(SQR(Uhalf[j][i].M2)/Uhalf[j][i].d - B2sq + Ptot)/r[i];
+      GRID_U(pG,ks,j,i,M1) += pG->dt*(SQR(Uhalf[j][i].M2)/Uhalf[j][i].d - B2sq + Ptot)/r[i];
 
 #ifdef FARGO
       /* Use average values to apply source terms for full time-step */
       Om = (*OrbitalProfile)(r[i]);
       qshear = (*ShearProfile)(r[i]);
-      pG->U[ks][j][i].M1 += pG->dt*(2.0*Om*Uhalf[j][i].M2);
-      pG->U[ks][j][i].M2 += pG->dt*(Om*(qshear-2.0)*Uhalf[j][i].M1);
+      GRID_U(pG,ks,j,i,M1) += pG->dt*(2.0*Om*Uhalf[j][i].M2);
+      GRID_U(pG,ks,j,i,M2) += pG->dt*(Om*(qshear-2.0)*Uhalf[j][i].M1);
 #endif /* FARGO */
     }
   }
@@ -1121,19 +1146,19 @@ void integrate_2d_vl(DomainS *pD)
 #ifdef CYLINDRICAL
       rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-      pG->U[ks][j][i].d   -= dtodx1*(rsf*x1Flux[j][i+1].d  - lsf*x1Flux[j][i].d );
-      pG->U[ks][j][i].M1  -= dtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx);
-      pG->U[ks][j][i].M2  -= dtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My);
-      pG->U[ks][j][i].M3  -= dtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz);
+      GRID_U(pG,ks,j,i,d)   -= dtodx1*(rsf*x1Flux[j][i+1].d  - lsf*x1Flux[j][i].d );
+      GRID_U(pG,ks,j,i,M1)  -= dtodx1*(rsf*x1Flux[j][i+1].Mx - lsf*x1Flux[j][i].Mx);
+      GRID_U(pG,ks,j,i,M2)  -= dtodx1*(SQR(rsf)*x1Flux[j][i+1].My - SQR(lsf)*x1Flux[j][i].My);
+      GRID_U(pG,ks,j,i,M3)  -= dtodx1*(rsf*x1Flux[j][i+1].Mz - lsf*x1Flux[j][i].Mz);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E   -= dtodx1*(rsf*x1Flux[j][i+1].E  - lsf*x1Flux[j][i].E );
+      GRID_U(pG,ks,j,i,E)   -= dtodx1*(rsf*x1Flux[j][i+1].E  - lsf*x1Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B3c -= dtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz);
+      GRID_U(pG,ks,j,i,B3c) -= dtodx1*(rsf*x1Flux[j][i+1].Bz - lsf*x1Flux[j][i].Bz);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx1*(rsf*x1Flux[j][i+1].s[n]
+        GRID_U(pG,ks,j,i,s[n]) -= dtodx1*(rsf*x1Flux[j][i+1].s[n]
                                       - lsf*x1Flux[j][i  ].s[n]);
 #endif
     }
@@ -1148,22 +1173,25 @@ void integrate_2d_vl(DomainS *pD)
 #ifdef CYLINDRICAL
       dtodx2 = pG->dt/(r[i]*pG->dx2);
 #endif
-      pG->U[ks][j][i].d   -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
-      pG->U[ks][j][i].M1  -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
-      pG->U[ks][j][i].M2  -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
-      pG->U[ks][j][i].M3  -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
+      GRID_U(pG,ks,j,i,d)   -= dtodx2*(x2Flux[j+1][i].d  - x2Flux[j][i].d );
+      GRID_U(pG,ks,j,i,M1)  -= dtodx2*(x2Flux[j+1][i].Mz - x2Flux[j][i].Mz);
+      GRID_U(pG,ks,j,i,M2)  -= dtodx2*(x2Flux[j+1][i].Mx - x2Flux[j][i].Mx);
+      GRID_U(pG,ks,j,i,M3)  -= dtodx2*(x2Flux[j+1][i].My - x2Flux[j][i].My);
 #ifndef BAROTROPIC
-      pG->U[ks][j][i].E   -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
+      GRID_U(pG,ks,j,i,E)   -= dtodx2*(x2Flux[j+1][i].E  - x2Flux[j][i].E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-      pG->U[ks][j][i].B3c -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
+      GRID_U(pG,ks,j,i,B3c) -= dtodx2*(x2Flux[j+1][i].By - x2Flux[j][i].By);
 #endif /* MHD */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        pG->U[ks][j][i].s[n] -= dtodx2*(x2Flux[j+1][i].s[n]
+        GRID_U(pG,ks,j,i,s[n]) -= dtodx2*(x2Flux[j+1][i].s[n]
                                       - x2Flux[j  ][i].s[n]);
 #endif
     }
+#if defined(FUSED_CFL) && !defined(MHD)
+    new_dt_speeds(pG,j,ks,&cfl_v1,&cfl_v2,&cfl_v3);
+#endif
   }
 
 /*--- Step 13c -----------------------------------------------------------------
@@ -1172,10 +1200,19 @@ void integrate_2d_vl(DomainS *pD)
 #ifdef MHD
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pG->B3i[ks][j][i] = pG->U[ks][j][i].B3c;
+      pG->B3i[ks][j][i] = GRID_U(pG,ks,j,i,B3c);
     }
+#ifdef FUSED_CFL
+    new_dt_speeds(pG,j,ks,&cfl_v1,&cfl_v2,&cfl_v3);
+#endif
   }
 #endif /* MHD */
+#ifdef FUSED_CFL
+  pG->max_v1 = cfl_v1;
+  pG->max_v2 = cfl_v2;
+  pG->max_v3 = cfl_v3;
+  pG->cfl_set = 1;
+#endif /* FUSED_CFL */
 
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
@@ -1186,7 +1223,8 @@ void integrate_2d_vl(DomainS *pD)
 
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      W = Cons_to_Prim(&(pG->U[ks][j][i]));
+      Ufofc = GET_GRID_U(pG,ks,j,i);
+      W = Cons_to_Prim(&Ufofc);
       if (W.d < 0.0) {
         flag_cell = 1;
         BadCell.i = i;
@@ -1429,6 +1467,7 @@ void integrate_init_2d(MeshS *pM)
   if ((U1d= (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
   if ((Ul = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
   if ((Ur = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
+  if ((F1d= (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
   if ((W1d= (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
   if ((Wl = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
   if ((Wr = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
@@ -1489,6 +1528,7 @@ void integrate_destruct_2d(void)
   if (U1d != NULL) free(U1d);
   if (Ul  != NULL) free(Ul);
   if (Ur  != NULL) free(Ur);
+  if (F1d != NULL) free(F1d);
   if (W1d != NULL) free(W1d);
   if (Wl  != NULL) free(Wl);
   if (Wr  != NULL) free(Wr);
@@ -1702,9 +1742,9 @@ static void FixCell(GridS *pG, Int3Vect ix)
 #ifdef CYLINDRICAL
     rsf = pG->ri[i+1]/pG->r[i];  lsf = pG->ri[i]/pG->r[i];
 #endif
-    pG->U[ks][j][i].B1c = 0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
-    pG->U[ks][j][i].B2c = 0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
-    pG->B3i[ks][j][i] = pG->U[ks][j][i].B3c;  /* for completeness */
+    GRID_U(pG,ks,j,i,B1c) = 0.5*(lsf*pG->B1i[ks][j][i] + rsf*pG->B1i[ks][j][i+1]);
+    GRID_U(pG,ks,j,i,B2c) = 0.5*(    pG->B2i[ks][j][i] +     pG->B2i[ks][j+1][i]);
+    pG->B3i[ks][j][i] = GRID_U(pG,ks,j,i,B3c);  /* for completeness */
   }}
 #endif /* MHD */
 
@@ -1759,34 +1799,34 @@ static void ApplyCorr(GridS *pG, int i, int j,
   dtodx2 = pG->dt/(pG->r[i]*pG->dx2);
 #endif
 
-  pG->U[ks][j][i].d  += dtodx1*(rsf*rx1*x1FD_ip1.d  - lsf*lx1*x1FD_i.d );
-  pG->U[ks][j][i].M1 += dtodx1*(rsf*rx1*x1FD_ip1.Mx - lsf*lx1*x1FD_i.Mx);
-  pG->U[ks][j][i].M2 += dtodx1*(SQR(rsf)*rx1*x1FD_ip1.My - SQR(lsf)*lx1*x1FD_i.My);
-  pG->U[ks][j][i].M3 += dtodx1*(rsf*rx1*x1FD_ip1.Mz - lsf*lx1*x1FD_i.Mz);
+  GRID_U(pG,ks,j,i,d)  += dtodx1*(rsf*rx1*x1FD_ip1.d  - lsf*lx1*x1FD_i.d );
+  GRID_U(pG,ks,j,i,M1) += dtodx1*(rsf*rx1*x1FD_ip1.Mx - lsf*lx1*x1FD_i.Mx);
+  GRID_U(pG,ks,j,i,M2) += dtodx1*(SQR(rsf)*rx1*x1FD_ip1.My - SQR(lsf)*lx1*x1FD_i.My);
+  GRID_U(pG,ks,j,i,M3) += dtodx1*(rsf*rx1*x1FD_ip1.Mz - lsf*lx1*x1FD_i.Mz);
 #ifndef BAROTROPIC
-  pG->U[ks][j][i].E  += dtodx1*(rsf*rx1*x1FD_ip1.E  - lsf*lx1*x1FD_i.E );
+  GRID_U(pG,ks,j,i,E)  += dtodx1*(rsf*rx1*x1FD_ip1.E  - lsf*lx1*x1FD_i.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-  pG->U[ks][j][i].B3c += dtodx1*(rsf*rx1*x1FD_ip1.Bz - lsf*lx1*x1FD_i.Bz);
+  GRID_U(pG,ks,j,i,B3c) += dtodx1*(rsf*rx1*x1FD_ip1.Bz - lsf*lx1*x1FD_i.Bz);
 #endif /* MHD */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[ks][j][i].s[n] += dtodx1*(rsf*rx1*x1FD_ip1.s[n] - lsf*lx1*x1FD_i.s[n]);
+    GRID_U(pG,ks,j,i,s[n]) += dtodx1*(rsf*rx1*x1FD_ip1.s[n] - lsf*lx1*x1FD_i.s[n]);
 #endif
 
-  pG->U[ks][j][i].d  += dtodx2*(rx2*x2FD_jp1.d  - lx2*x2FD_j.d );
-  pG->U[ks][j][i].M1 += dtodx2*(rx2*x2FD_jp1.Mz - lx2*x2FD_j.Mz);
-  pG->U[ks][j][i].M2 += dtodx2*(rx2*x2FD_jp1.Mx - lx2*x2FD_j.Mx);
-  pG->U[ks][j][i].M3 += dtodx2*(rx2*x2FD_jp1.My - lx2*x2FD_j.My);
+  GRID_U(pG,ks,j,i,d)  += dtodx2*(rx2*x2FD_jp1.d  - lx2*x2FD_j.d );
+  GRID_U(pG,ks,j,i,M1) += dtodx2*(rx2*x2FD_jp1.Mz - lx2*x2FD_j.Mz);
+  GRID_U(pG,ks,j,i,M2) += dtodx2*(rx2*x2FD_jp1.Mx - lx2*x2FD_j.Mx);
+  GRID_U(pG,ks,j,i,M3) += dtodx2*(rx2*x2FD_jp1.My - lx2*x2FD_j.My);
 #ifndef BAROTROPIC                                   
-  pG->U[ks][j][i].E  += dtodx2*(rx2*x2FD_jp1.E  - lx2*x2FD_j.E );
+  GRID_U(pG,ks,j,i,E)  += dtodx2*(rx2*x2FD_jp1.E  - lx2*x2FD_j.E );
 #endif /* BAROTROPIC */
 #ifdef MHD
-  pG->U[ks][j][i].B3c += dtodx2*(rx2*x2FD_jp1.By - lx2*x2FD_j.By);
+  GRID_U(pG,ks,j,i,B3c) += dtodx2*(rx2*x2FD_jp1.By - lx2*x2FD_j.By);
 #endif /* MHD */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[ks][j][i].s[n] += dtodx2*(rx2*x2FD_jp1.s[n] - lx2*x2FD_j.s[n]);
+    GRID_U(pG,ks,j,i,s[n]) += dtodx2*(rx2*x2FD_jp1.s[n] - lx2*x2FD_j.s[n]);
 #endif
 
 #ifdef SHEARING_BOX
@@ -1842,18 +1882,18 @@ static void ApplyCorr(GridS *pG, int i, int j,
  * discretization for the momentum fluctuation equation. */
 
   if (ShBoxCoord==xy){
-    pG->U[ks][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-    pG->U[ks][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+    GRID_U(pG,ks,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+    GRID_U(pG,ks,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 #ifndef FARGO
-    pG->U[ks][j][i].M2 += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d+ABS(rx1)*x1FD_ip1.d);
+    GRID_U(pG,ks,j,i,M2) += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d+ABS(rx1)*x1FD_ip1.d);
 #endif
   }
 
   if (ShBoxCoord==xz){
-    pG->U[ks][j][i].M1 += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-    pG->U[ks][j][i].M3 += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
+    GRID_U(pG,ks,j,i,M1) += (4.0*dM3e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+    GRID_U(pG,ks,j,i,M3) += 2.0*(qshear-2.)*(M1e + om_dt*dM3e)*fact;
 #ifndef FARGO
-    pG->U[ks][j][i].M3 += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d+ABS(rx1)*x1FD_ip1.d);
+    GRID_U(pG,ks,j,i,M3) += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d+ABS(rx1)*x1FD_ip1.d);
 #endif
   }
 
@@ -1864,14 +1904,14 @@ static void ApplyCorr(GridS *pG, int i, int j,
   phir = (*ShearingBoxPot)((x1+rx1*0.5*pG->dx1),x2,x3);
   phil = (*ShearingBoxPot)((x1-lx1*0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-  pG->U[ks][j][i].E += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
+  GRID_U(pG,ks,j,i,E) += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
                                rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
   phir = (*ShearingBoxPot)(x1,(x2+rx2*0.5*pG->dx2),x3);
   phil = (*ShearingBoxPot)(x1,(x2-lx2*0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-  pG->U[ks][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+  GRID_U(pG,ks,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                                rx2*x2FD_jp1.d*(phir - phic));
 #endif
 #endif /* SHEARING_BOX */
@@ -1883,7 +1923,7 @@ static void ApplyCorr(GridS *pG, int i, int j,
     phil = (*StaticGravPot)((x1-lx1*0.5*pG->dx1),x2,x3);
 
 #ifndef BAROTROPIC
-    pG->U[ks][j][i].E += dtodx1*(lsf*lx1*x1FD_i.d*(phic - phil) +
+    GRID_U(pG,ks,j,i,E) += dtodx1*(lsf*lx1*x1FD_i.d*(phic - phil) +
                                  rsf*rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
@@ -1891,7 +1931,7 @@ static void ApplyCorr(GridS *pG, int i, int j,
     phil = (*StaticGravPot)(x1,(x2-lx2*0.5*pG->dx2),x3);
 
 #ifndef BAROTROPIC
-    pG->U[ks][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+    GRID_U(pG,ks,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                                  rx2*x2FD_jp1.d*(phir - phic));
 #endif
   }
@@ -1902,7 +1942,7 @@ static void ApplyCorr(GridS *pG, int i, int j,
   phir = 0.5*(pG->Phi[ks][j][i  ] + pG->Phi[ks][j][i+rx1]);
 
 #ifndef BAROTROPIC
-  pG->U[ks][j][i].E += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
+  GRID_U(pG,ks,j,i,E) += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
                                rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
@@ -1910,7 +1950,7 @@ static void ApplyCorr(GridS *pG, int i, int j,
   phir = 0.5*(pG->Phi[ks][j  ][i] + pG->Phi[ks][j+rx2][i]);
 
 #ifndef BAROTROPIC
-  pG->U[ks][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+  GRID_U(pG,ks,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                                rx2*x2FD_jp1.d*(phir - phic));
 #endif
 
@@ -14,6 +14,11 @@
  *   - For adb mhd, requires   (9*Cons1DS + 10*Real) = 73 3D arrays
  *   The H-correction of Sanders et al. adds another 3 arrays.  
  *
+ *   With --enable-openmp the loops over the outer (k or j) index are threaded,
+ *   including the transverse flux corrections and the emf corner integration.
+ *   Results are bitwise identical to the serial integrator.  Shearing-box flux
+ *   remaps and SMR flux storage remain serial.
+ *
  * REFERENCES:
  * - P. Colella, "Multidimensional upwind methods for hyperbolic conservation
  *   laws", JCP, 87, 171 (1990)
@@ -69,6 +74,9 @@ static Real ***emf1_cc=NULL, ***emf2_cc=NULL, ***emf3_cc=NULL;
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W=NULL, *Wl=NULL, *Wr=NULL;
 static Cons1DS *U1d=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(Bxc,Bxi,W,Wl,Wr,U1d)
+#endif
 
 /* density and Pressure at t^{n+1/2} needed by MHD, cooling, and gravity */
 static Real ***dhalf = NULL, ***phalf=NULL;
@@ -89,6 +97,73 @@ static ConsS **rFlxiib=NULL, **rFlxoib=NULL;
 static Real ***geom_src=NULL;
 #endif
 
+/* Work variables of integrate_3d_ctu() that are written inside its threaded
+ * loops.  Each group is defined under the same options as the variables it
+ * names, and is expanded in the private() clauses of the OpenMP directives.
+ * Variables in CTU_FIRSTPRIVATE only vary with CYLINDRICAL; they are also made
+ * lastprivate so their values after each loop are the same as in serial. */
+#ifdef OPENMP_PARALLEL
+#ifndef BAROTROPIC
+#define CTU_PRIV_ENERGY ,coolfl,coolfr,coolf,Eh
+#else
+#define CTU_PRIV_ENERGY
+#endif
+#ifdef MHD
+#define CTU_PRIV_MHD ,MHD_src_By,MHD_src_Bz,mdb1,mdb2,mdb3,db1,db2,db3,l1,l2,l3,\
+  B1,B2,B3,V1,V2,V3,B1ch,B2ch,B3ch
+#else
+#define CTU_PRIV_MHD
+#endif
+#ifdef H_CORRECTION
+#define CTU_PRIV_HCORR ,cfr,cfl,lambdar,lambdal
+#else
+#define CTU_PRIV_HCORR
+#endif
+#if (NSCALARS > 0)
+#define CTU_PRIV_SCALARS ,n
+#else
+#define CTU_PRIV_SCALARS
+#endif
+#ifdef SELF_GRAVITY
+#define CTU_PRIV_SELFG ,gxl,gxr,gyl,gyr,gzl,gzr,\
+  flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r
+#else
+#define CTU_PRIV_SELFG
+#endif
+#ifdef SHEARING_BOX
+#define CTU_PRIV_SHEAR ,M1n,dM2n,M1e,dM2e,\
+  flx1_dM2,frx1_dM2,flx2_dM2,frx2_dM2,flx3_dM2,frx3_dM2
+#else
+#define CTU_PRIV_SHEAR
+#endif
+#ifdef CYLINDRICAL
+#ifndef ISOTHERMAL
+#define CTU_PRIV_PAVG ,Pavgh
+#else
+#define CTU_PRIV_PAVG
+#endif
+#ifdef FARGO
+#define CTU_PRIV_FARGO ,Om,qshear,Mrn,Mpn,Mre,Mpe,Mrav,Mpav
+#else
+#define CTU_PRIV_FARGO
+#endif
+#define CTU_PRIV_CYL ,rinv,geom_src_d,geom_src_Vx,geom_src_Vy,geom_src_P,\
+  geom_src_By,geom_src_Bz CTU_PRIV_PAVG CTU_PRIV_FARGO
+#else
+#define CTU_PRIV_CYL
+#endif
+#ifdef PARTICLES
+#define CTU_PRIV_PARTICLES ,d1
+#else
+#define CTU_PRIV_PARTICLES
+#endif
+
+#define CTU_PRIVATE x1,x2,x3,phicl,phicr,phifc,phil,phir,phic,M1h,M2h,M3h,\
+  g,gl,gr CTU_PRIV_ENERGY CTU_PRIV_MHD CTU_PRIV_HCORR CTU_PRIV_SCALARS \
+  CTU_PRIV_SELFG CTU_PRIV_SHEAR CTU_PRIV_CYL CTU_PRIV_PARTICLES
+#define CTU_FIRSTPRIVATE Bx,rsf,lsf,dx2i,dx2,q2,dtodx2
+#endif /* OPENMP_PARALLEL */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
  *   integrate_emf1_corner() - the upwind CT method in GS05, for emf1
@@ -110,6 +185,9 @@ static void integrate_emf3_corner(const GridS *pG);
 void integrate_3d_ctu(DomainS *pD)
 {
   GridS *pG=(pD->Grid);
+#ifdef FUSED_CFL
+  Real cfl_v1=0.0,cfl_v2=0.0,cfl_v3=0.0;
+#endif
   Real dtodx1=pG->dt/pG->dx1, dtodx2=pG->dt/pG->dx2, dtodx3=pG->dt/pG->dx3;
   Real hdt = 0.5*pG->dt, dx2=pG->dx2;
   Real q1 = 0.5*dtodx1, q2 = 0.5*dtodx2, q3 = 0.5*dtodx3;
@@ -196,13 +274,19 @@ void integrate_3d_ctu(DomainS *pD)
   ku = ke + 2;
 #endif
 
-/* Set etah=0 so first calls to flux functions do not use H-correction */
+/* Set etah=0 so first calls to flux functions do not use H-correction.
+ * etah is threadprivate, so it must be reset in every thread. */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
   etah = 0.0;
 
 /* Compute predictor feedback from particle drag */
 #ifdef FEEDBACK
+  TIMER_START(TIMER_PARTICLES);
   feedback_predictor(pD);
   exchange_gpcouple(pD,1);
+  TIMER_STOP(TIMER_PARTICLES);
 #endif
 
 /*=== STEP 1: Compute L/R x1-interface states and 1D x1-Fluxes ===============*/
@@ -212,25 +296,29 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        U1d[i].d  = pG->U[k][j][i].d;
-        U1d[i].Mx = pG->U[k][j][i].M1;
-        U1d[i].My = pG->U[k][j][i].M2;
-        U1d[i].Mz = pG->U[k][j][i].M3;
+        U1d[i].d  = GRID_U(pG,k,j,i,d);
+        U1d[i].Mx = GRID_U(pG,k,j,i,M1);
+        U1d[i].My = GRID_U(pG,k,j,i,M2);
+        U1d[i].Mz = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-        U1d[i].E  = pG->U[k][j][i].E;
+        U1d[i].E  = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        U1d[i].By = pG->U[k][j][i].B2c;
-        U1d[i].Bz = pG->U[k][j][i].B3c;
-        Bxc[i] = pG->U[k][j][i].B1c;
+        U1d[i].By = GRID_U(pG,k,j,i,B2c);
+        U1d[i].Bz = GRID_U(pG,k,j,i,B3c);
+        Bxc[i] = GRID_U(pG,k,j,i,B1c);
         Bxi[i] = pG->B1i[k][j][i];
         B1_x1Face[k][j][i] = pG->B1i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -296,8 +384,8 @@ void integrate_3d_ctu(DomainS *pD)
 	  l2 = l2 < 0.0 ? l2 : 0.0;
 	}
 
-        MHD_src_By = (pG->U[k][j][i-1].M2/pG->U[k][j][i-1].d)*l2;
-        MHD_src_Bz = (pG->U[k][j][i-1].M3/pG->U[k][j][i-1].d)*l3;
+        MHD_src_By = (GRID_U(pG,k,j,i-1,M2)/GRID_U(pG,k,j,i-1,d))*l2;
+        MHD_src_Bz = (GRID_U(pG,k,j,i-1,M3)/GRID_U(pG,k,j,i-1,d))*l3;
 
         Wl[i].By += hdt*MHD_src_By;
         Wl[i].Bz += hdt*MHD_src_Bz;
@@ -326,8 +414,8 @@ void integrate_3d_ctu(DomainS *pD)
           l2 = l2 < 0.0 ? l2 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j][i].M2/pG->U[k][j][i].d)*l2;
-        MHD_src_Bz = (pG->U[k][j][i].M3/pG->U[k][j][i].d)*l3;
+        MHD_src_By = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d))*l2;
+        MHD_src_Bz = (GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d))*l3;
 
         Wr[i].By += hdt*MHD_src_By;
         Wr[i].Bz += hdt*MHD_src_Bz;
@@ -548,13 +636,14 @@ void integrate_3d_ctu(DomainS *pD)
       for (i=il+1; i<=iu; i++) {
         Ul_x1Face[k][j][i] = Prim1D_to_Cons1D(&Wl[i],&Bxi[i]);
         Ur_x1Face[k][j][i] = Prim1D_to_Cons1D(&Wr[i],&Bxi[i]);
-
+      }
 #ifdef MHD
-        Bx = B1_x1Face[k][j][i];
+      fluxes_pencil(il+1,iu,Ul_x1Face[k][j],Ur_x1Face[k][j],Wl,Wr,
+                    B1_x1Face[k][j],x1Flux[k][j]);
+#else
+      fluxes_pencil(il+1,iu,Ul_x1Face[k][j],Ur_x1Face[k][j],Wl,Wr,Bxi,
+                    x1Flux[k][j]);
 #endif
-        fluxes(Ul_x1Face[k][j][i],Ur_x1Face[k][j][i],Wl[i],Wr[i],Bx,
-          &x1Flux[k][j][i]);
-      }
     }
   }
 
@@ -565,6 +654,10 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,j,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (i=il; i<=iu; i++) {
 #ifdef CYLINDRICAL
@@ -573,22 +666,22 @@ void integrate_3d_ctu(DomainS *pD)
       dtodx2 = pG->dt/dx2;
 #endif
       for (j=js-nghost; j<=je+nghost; j++) {
-        U1d[j].d  = pG->U[k][j][i].d;
-        U1d[j].Mx = pG->U[k][j][i].M2;
-        U1d[j].My = pG->U[k][j][i].M3;
-        U1d[j].Mz = pG->U[k][j][i].M1;
+        U1d[j].d  = GRID_U(pG,k,j,i,d);
+        U1d[j].Mx = GRID_U(pG,k,j,i,M2);
+        U1d[j].My = GRID_U(pG,k,j,i,M3);
+        U1d[j].Mz = GRID_U(pG,k,j,i,M1);
 #ifndef BAROTROPIC
-        U1d[j].E  = pG->U[k][j][i].E;
+        U1d[j].E  = GRID_U(pG,k,j,i,E);
 #endif
 #ifdef MHD
-        U1d[j].By = pG->U[k][j][i].B3c;
-        U1d[j].Bz = pG->U[k][j][i].B1c;
-        Bxc[j] = pG->U[k][j][i].B2c;
+        U1d[j].By = GRID_U(pG,k,j,i,B3c);
+        U1d[j].Bz = GRID_U(pG,k,j,i,B1c);
+        Bxc[j] = GRID_U(pG,k,j,i,B2c);
         Bxi[j] = pG->B2i[k][j][i];
         B2_x2Face[k][j][i] = pG->B2i[k][j][i];
 #endif
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -637,8 +730,8 @@ void integrate_3d_ctu(DomainS *pD)
           l3 = l3 < 0.0 ? l3 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j-1][i].M3/pG->U[k][j-1][i].d)*l3;
-        MHD_src_Bz = (pG->U[k][j-1][i].M1/pG->U[k][j-1][i].d)*l1;
+        MHD_src_By = (GRID_U(pG,k,j-1,i,M3)/GRID_U(pG,k,j-1,i,d))*l3;
+        MHD_src_Bz = (GRID_U(pG,k,j-1,i,M1)/GRID_U(pG,k,j-1,i,d))*l1;
 
         Wl[j].By += hdt*MHD_src_By;
         Wl[j].Bz += hdt*MHD_src_Bz;
@@ -663,8 +756,8 @@ void integrate_3d_ctu(DomainS *pD)
           l3 = l3 < 0.0 ? l3 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j][i].M3/pG->U[k][j][i].d)*l3;
-        MHD_src_Bz = (pG->U[k][j][i].M1/pG->U[k][j][i].d)*l1;
+        MHD_src_By = (GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d))*l3;
+        MHD_src_Bz = (GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d))*l1;
 
         Wr[j].By += hdt*MHD_src_By;
         Wr[j].Bz += hdt*MHD_src_Bz;
@@ -768,25 +861,29 @@ void integrate_3d_ctu(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,k,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
       for (k=ks-nghost; k<=ke+nghost; k++) {
-        U1d[k].d  = pG->U[k][j][i].d;
-        U1d[k].Mx = pG->U[k][j][i].M3;
-        U1d[k].My = pG->U[k][j][i].M1;
-        U1d[k].Mz = pG->U[k][j][i].M2;
+        U1d[k].d  = GRID_U(pG,k,j,i,d);
+        U1d[k].Mx = GRID_U(pG,k,j,i,M3);
+        U1d[k].My = GRID_U(pG,k,j,i,M1);
+        U1d[k].Mz = GRID_U(pG,k,j,i,M2);
 #ifndef BAROTROPIC
-        U1d[k].E  = pG->U[k][j][i].E;
+        U1d[k].E  = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-        U1d[k].By = pG->U[k][j][i].B1c;
-        U1d[k].Bz = pG->U[k][j][i].B2c;
-        Bxc[k] = pG->U[k][j][i].B3c;
+        U1d[k].By = GRID_U(pG,k,j,i,B1c);
+        U1d[k].Bz = GRID_U(pG,k,j,i,B2c);
+        Bxc[k] = GRID_U(pG,k,j,i,B3c);
         Bxi[k] = pG->B3i[k][j][i];
         B3_x3Face[k][j][i] = pG->B3i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -836,8 +933,8 @@ void integrate_3d_ctu(DomainS *pD)
           l2 = l2 < 0.0 ? l2 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k-1][j][i].M1/pG->U[k-1][j][i].d)*l1;
-        MHD_src_Bz = (pG->U[k-1][j][i].M2/pG->U[k-1][j][i].d)*l2;
+        MHD_src_By = (GRID_U(pG,k-1,j,i,M1)/GRID_U(pG,k-1,j,i,d))*l1;
+        MHD_src_Bz = (GRID_U(pG,k-1,j,i,M2)/GRID_U(pG,k-1,j,i,d))*l2;
 
         Wl[k].By += hdt*MHD_src_By;
         Wl[k].Bz += hdt*MHD_src_Bz;
@@ -862,8 +959,8 @@ void integrate_3d_ctu(DomainS *pD)
           l2 = l2 < 0.0 ? l2 : 0.0;
         }
 
-        MHD_src_By = (pG->U[k][j][i].M1/pG->U[k][j][i].d)*l1;
-        MHD_src_Bz = (pG->U[k][j][i].M2/pG->U[k][j][i].d)*l2;
+        MHD_src_By = (GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d))*l1;
+        MHD_src_Bz = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d))*l2;
 
         Wr[k].By += hdt*MHD_src_By;
         Wr[k].Bz += hdt*MHD_src_Bz;
@@ -963,18 +1060,22 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef MHD
 /* emf1 */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        emf1_cc[k][j][i] = (pG->U[k][j][i].B2c*pG->U[k][j][i].M3 -
-                            pG->U[k][j][i].B3c*pG->U[k][j][i].M2)
-                              /pG->U[k][j][i].d;
-        emf2_cc[k][j][i] = (pG->U[k][j][i].B3c*pG->U[k][j][i].M1 -
-                            pG->U[k][j][i].B1c*pG->U[k][j][i].M3)
-                              /pG->U[k][j][i].d;
-        emf3_cc[k][j][i] = (pG->U[k][j][i].B1c*pG->U[k][j][i].M2 -
-                            pG->U[k][j][i].B2c*pG->U[k][j][i].M1)
-                              /pG->U[k][j][i].d;
+        emf1_cc[k][j][i] = (GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,M3) -
+                            GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,M2))
+                              /GRID_U(pG,k,j,i,d);
+        emf2_cc[k][j][i] = (GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,M1) -
+                            GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,M3))
+                              /GRID_U(pG,k,j,i,d);
+        emf3_cc[k][j][i] = (GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,M2) -
+                            GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,M1))
+                              /GRID_U(pG,k,j,i,d);
       }
     }
   }
@@ -986,6 +1087,10 @@ void integrate_3d_ctu(DomainS *pD)
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1014,6 +1119,10 @@ void integrate_3d_ctu(DomainS *pD)
                              q3*(emf1[k+1][ju][i  ]-emf1[k][ju][i]);
     }
   }
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=jl+1; j<=ju-1; j++) {
     for (i=il+1; i<=iu-1; i++) {
 #ifdef CYLINDRICAL
@@ -1033,6 +1142,10 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x2-sweep, (x,y,z) on RHS -> (z,x,y) on LHS 
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1132,6 +1245,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1142,11 +1259,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i  ] - lsf*pG->B1i[k][j][i-1])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i-1] -     pG->B2i[k][j][i-1])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i-1] -     pG->B3i[k][j][i-1])*dx3i;
-        B1 = pG->U[k][j][i-1].B1c;
-        B2 = pG->U[k][j][i-1].B2c;
-        B3 = pG->U[k][j][i-1].B3c;
-        V2 = pG->U[k][j][i-1].M2/pG->U[k][j][i-1].d;
-        V3 = pG->U[k][j][i-1].M3/pG->U[k][j][i-1].d;
+        B1 = GRID_U(pG,k,j,i-1,B1c);
+        B2 = GRID_U(pG,k,j,i-1,B2c);
+        B3 = GRID_U(pG,k,j,i-1,B3c);
+        V2 = GRID_U(pG,k,j,i-1,M2)/GRID_U(pG,k,j,i-1,d);
+        V3 = GRID_U(pG,k,j,i-1,M3)/GRID_U(pG,k,j,i-1,d);
 
         /* Calculate mdb2 = min_mod(-db1,db2) */
         if(db1 > 0.0 && db2 < 0.0){
@@ -1182,11 +1299,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i+1] - lsf*pG->B1i[k][j][i])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i  ] -     pG->B2i[k][j][i])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i  ] -     pG->B3i[k][j][i])*dx3i;
-        B1 = pG->U[k][j][i].B1c;
-        B2 = pG->U[k][j][i].B2c;
-        B3 = pG->U[k][j][i].B3c;
-        V2 = pG->U[k][j][i].M2/pG->U[k][j][i].d;
-        V3 = pG->U[k][j][i].M3/pG->U[k][j][i].d;
+        B1 = GRID_U(pG,k,j,i,B1c);
+        B2 = GRID_U(pG,k,j,i,B2c);
+        B3 = GRID_U(pG,k,j,i,B3c);
+        V2 = GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d);
+        V3 = GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
 
         /* Calculate mdb2 = min_mod(-db1,db2) */
         if(db1 > 0.0 && db2 < 0.0){
@@ -1227,6 +1344,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1239,9 +1360,9 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         q2 = hdt/(r[i]*pG->dx2);
 #endif
-        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifdef ROTATING_FRAME
-        Ur_x1Face[k][j][i].My -= (pG->dt)*Omega_0*pG->U[k][j][i].M1;
+        Ur_x1Face[k][j][i].My -= (pG->dt)*Omega_0*GRID_U(pG,k,j,i,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i  ].d*(phic - phil)
@@ -1251,7 +1372,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i  ].d*(phic - phil)
                                   + x3Flux[k+1][j][i  ].d*(phir - phic));
@@ -1265,9 +1386,9 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef CYLINDRICAL
         q2 = hdt/(r[i-1]*pG->dx2);
 #endif
-        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*GRID_U(pG,k,j,i-1,d);
 #ifdef ROTATING_FRAME
-        Ul_x1Face[k][j][i].My -= (pG->dt)*Omega_0*pG->U[k][j][i-1].M1;
+        Ul_x1Face[k][j][i].My -= (pG->dt)*Omega_0*GRID_U(pG,k,j,i-1,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i-1].d*(phic - phil)
@@ -1277,7 +1398,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)((x1-pG->dx1),x2,(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)((x1-pG->dx1),x2,(x3-0.5*pG->dx3));
 
-        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*GRID_U(pG,k,j,i-1,d);
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i-1].d*(phic - phil)
                                   + x3Flux[k+1][j][i-1].d*(phir - phic));
@@ -1292,6 +1413,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu; i++) {
@@ -1300,7 +1425,7 @@ void integrate_3d_ctu(DomainS *pD)
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
 
         /* correct right states; x2 and x3 gradients */
-        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].My -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i  ].d*(phic - phil)
                                   + x2Flux[k][j+1][i  ].d*(phir - phic));
@@ -1309,7 +1434,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
 
-        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x1Face[k][j][i].Mz -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i  ].d*(phic - phil)
                                   + x3Flux[k+1][j][i  ].d*(phir - phic));
@@ -1320,7 +1445,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k][j+1][i-1]);
         phil = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k][j-1][i-1]);
 
-        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].My -= q2*(phir-phil)*GRID_U(pG,k,j,i-1,d);
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q2*(x2Flux[k][j  ][i-1].d*(phic - phil)
                                   + x2Flux[k][j+1][i-1].d*(phir - phic));
@@ -1329,7 +1454,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k+1][j][i-1]);
         phil = 0.5*(pG->Phi[k][j][i-1] + pG->Phi[k-1][j][i-1]);
 
-        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*pG->U[k][j][i-1].d;
+        Ul_x1Face[k][j][i].Mz -= q3*(phir-phil)*GRID_U(pG,k,j,i-1,d);
 #ifndef BAROTROPIC
         Ul_x1Face[k][j][i].E -= q3*(x3Flux[k  ][j][i-1].d*(phic - phil)
                                   + x3Flux[k+1][j][i-1].d*(phir - phic));
@@ -1347,6 +1472,10 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x1-sweep, (x,y,z) on RHS -> (y,z,x) on LHS
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1439,6 +1568,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1449,11 +1582,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j-1][i+1] - lsf*pG->B1i[k][j-1][i])*dx1i;
         db2 = (    pG->B2i[k  ][j  ][i  ] -     pG->B2i[k][j-1][i])*dx2i;
         db3 = (    pG->B3i[k+1][j-1][i  ] -     pG->B3i[k][j-1][i])*dx3i;
-        B1 = pG->U[k][j-1][i].B1c;
-        B2 = pG->U[k][j-1][i].B2c;
-        B3 = pG->U[k][j-1][i].B3c;
-        V1 = pG->U[k][j-1][i].M1/pG->U[k][j-1][i].d;
-        V3 = pG->U[k][j-1][i].M3/pG->U[k][j-1][i].d;
+        B1 = GRID_U(pG,k,j-1,i,B1c);
+        B2 = GRID_U(pG,k,j-1,i,B2c);
+        B3 = GRID_U(pG,k,j-1,i,B3c);
+        V1 = GRID_U(pG,k,j-1,i,M1)/GRID_U(pG,k,j-1,i,d);
+        V3 = GRID_U(pG,k,j-1,i,M3)/GRID_U(pG,k,j-1,i,d);
 
         /* Calculate mdb1 = min_mod(-db2,db1) */
         if(db2 > 0.0 && db1 < 0.0){
@@ -1485,11 +1618,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i+1] - lsf*pG->B1i[k][j][i])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i  ] -     pG->B2i[k][j][i])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i  ] -     pG->B3i[k][j][i])*dx3i;
-        B1 = pG->U[k][j][i].B1c;
-        B2 = pG->U[k][j][i].B2c;
-        B3 = pG->U[k][j][i].B3c;
-        V1 = pG->U[k][j][i].M1/pG->U[k][j][i].d;
-        V3 = pG->U[k][j][i].M3/pG->U[k][j][i].d;
+        B1 = GRID_U(pG,k,j,i,B1c);
+        B2 = GRID_U(pG,k,j,i,B2c);
+        B3 = GRID_U(pG,k,j,i,B3c);
+        V1 = GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d);
+        V3 = GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
 
         /* Calculate mdb1 = min_mod(-db2,db1) */
         if(db2 > 0.0 && db1 < 0.0){
@@ -1530,6 +1663,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1547,12 +1684,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ur_x2Face[k][j][i].Mz -= hdt*pG->U[k][j][i].d*g;
+        Ur_x2Face[k][j][i].Mz -= hdt*GRID_U(pG,k,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j][i].M2;
+        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,k,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j][i].d*Om*x1vc(pG,i);
+        Ur_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,k,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -1567,7 +1704,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j  ][i].d*(phic - phil)
                                   + x3Flux[k+1][j  ][i].d*(phir - phic));
@@ -1582,12 +1719,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ul_x2Face[k][j][i].Mz -= hdt*pG->U[k][j-1][i].d*g;
+        Ul_x2Face[k][j][i].Mz -= hdt*GRID_U(pG,k,j-1,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j-1][i].M2;
+        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,k,j-1,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*pG->U[k][j-1][i].d*Om*x1vc(pG,i);
+        Ul_x2Face[k][j][i].Mz += (pG->dt)*Omega_0*GRID_U(pG,k,j-1,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -1602,7 +1739,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2-pG->dx2),(x3+0.5*pG->dx3));
         phil = (*StaticGravPot)(x1,(x2-pG->dx2),(x3-0.5*pG->dx3));
 
-        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*GRID_U(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j-1][i].d*(phic - phil)
                                   + x3Flux[k+1][j-1][i].d*(phir - phic));
@@ -1617,6 +1754,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1625,7 +1766,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
 
-        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                                   + x1Flux[k][j][i+1].d*(phir - phic));
@@ -1634,7 +1775,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
 
-        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                                   + x3Flux[k+1][j][i].d*(phir - phic));
@@ -1645,7 +1786,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k][j-1][i+1]);
         phil = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k][j-1][i-1]);
 
-        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*GRID_U(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q1*(x1Flux[k][j-1][i  ].d*(phic - phil)
                                   + x1Flux[k][j-1][i+1].d*(phir - phic));
@@ -1653,7 +1794,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k+1][j-1][i]);
         phil = 0.5*(pG->Phi[k][j-1][i] + pG->Phi[k-1][j-1][i]);
 
-        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*GRID_U(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j-1][i].d*(phic - phil)
                                   + x3Flux[k+1][j-1][i].d*(phir - phic));
@@ -1673,6 +1814,10 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef SHEARING_BOX
   if (ShearingBoxPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1683,7 +1828,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].Mz -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q1*(x1Flux[k][j  ][i  ].d*(phic - phil)
                                   + x1Flux[k][j  ][i+1].d*(phir - phic));
@@ -1692,7 +1837,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x2Face[k][j][i].My -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j  ][i].d*(phic - phil)
                                   + x3Flux[k+1][j  ][i].d*(phir - phic));
@@ -1703,7 +1848,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),(x2-pG->dx2),x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),(x2-pG->dx2),x3);
 
-        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].Mz -= q1*(phir-phil)*GRID_U(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q1*(x1Flux[k][j-1][i  ].d*(phic - phil)
                                   + x1Flux[k][j-1][i+1].d*(phir - phic));
@@ -1711,7 +1856,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2-pG->dx2),(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,(x2-pG->dx2),(x3-0.5*pG->dx3));
 
-        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*pG->U[k][j-1][i].d;
+        Ul_x2Face[k][j][i].My -= q3*(phir-phil)*GRID_U(pG,k,j-1,i,d);
 #ifndef BAROTROPIC
         Ul_x2Face[k][j][i].E -= q3*(x3Flux[k  ][j-1][i].d*(phic - phil)
                                   + x3Flux[k+1][j-1][i].d*(phir - phic));
@@ -1720,17 +1865,21 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }}
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x2Face[k][j][i].Mz += pG->dt*Omega_0*pG->U[k][j][i].M2;
-        Ul_x2Face[k][j][i].Mz += pG->dt*Omega_0*pG->U[k][j-1][i].M2;
+        Ur_x2Face[k][j][i].Mz += pG->dt*Omega_0*GRID_U(pG,k,j,i,M2);
+        Ul_x2Face[k][j][i].Mz += pG->dt*Omega_0*GRID_U(pG,k,j-1,i,M2);
 #ifdef FARGO
-        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
-        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*pG->U[k][j-1][i].M1;
+        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*GRID_U(pG,k,j,i,M1);
+        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.)*Omega_0*GRID_U(pG,k,j-1,i,M1);
 #else
-        Ur_x2Face[k][j][i].Mx -= pG->dt*Omega_0*pG->U[k][j][i].M1;
-        Ul_x2Face[k][j][i].Mx -= pG->dt*Omega_0*pG->U[k][j-1][i].M1;
+        Ur_x2Face[k][j][i].Mx -= pG->dt*Omega_0*GRID_U(pG,k,j,i,M1);
+        Ul_x2Face[k][j][i].Mx -= pG->dt*Omega_0*GRID_U(pG,k,j-1,i,M1);
 #endif
       }
     }
@@ -1738,17 +1887,21 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
 #if defined(CYLINDRICAL) && defined(FARGO)
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
 
-        Ur_x2Face[k][j][i].Mz += pG->dt*Om*pG->U[k][j][i].M2;
-        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[k][j][i].M1;
+        Ur_x2Face[k][j][i].Mz += pG->dt*Om*GRID_U(pG,k,j,i,M2);
+        Ur_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*GRID_U(pG,k,j,i,M1);
 
-        Ul_x2Face[k][j][i].Mz += pG->dt*Om*pG->U[k][j-1][i].M2;
-        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*pG->U[k][j-1][i].M1;
+        Ul_x2Face[k][j][i].Mz += pG->dt*Om*GRID_U(pG,k,j-1,i,M2);
+        Ul_x2Face[k][j][i].Mx += hdt*(qshear-2.0)*Om*GRID_U(pG,k,j-1,i,M1);
       }
     }
   }
@@ -1759,6 +1912,10 @@ void integrate_3d_ctu(DomainS *pD)
  * states on x2-faces.  S_{M_R} = -(\rho v_\phi^2 - B_\phi^2)/R
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1776,6 +1933,10 @@ void integrate_3d_ctu(DomainS *pD)
  * Since the fluxes come from an x1-sweep, (x,y,z) on RHS -> (z,x,y) on LHS 
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1869,6 +2030,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1879,11 +2044,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k-1][j  ][i+1] - lsf*pG->B1i[k-1][j][i])*dx1i;
         db2 = (    pG->B2i[k-1][j+1][i  ] -     pG->B2i[k-1][j][i])*dx2i;
         db3 = (    pG->B3i[k  ][j  ][i  ] -     pG->B3i[k-1][j][i])*dx3i;
-        B1 = pG->U[k-1][j][i].B1c;
-        B2 = pG->U[k-1][j][i].B2c;
-        B3 = pG->U[k-1][j][i].B3c;
-        V1 = pG->U[k-1][j][i].M1/pG->U[k-1][j][i].d;
-        V2 = pG->U[k-1][j][i].M2/pG->U[k-1][j][i].d;
+        B1 = GRID_U(pG,k-1,j,i,B1c);
+        B2 = GRID_U(pG,k-1,j,i,B2c);
+        B3 = GRID_U(pG,k-1,j,i,B3c);
+        V1 = GRID_U(pG,k-1,j,i,M1)/GRID_U(pG,k-1,j,i,d);
+        V2 = GRID_U(pG,k-1,j,i,M2)/GRID_U(pG,k-1,j,i,d);
 
         /* Calculate mdb1 = min_mod(-db3,db1) */
         if(db3 > 0.0 && db1 < 0.0){
@@ -1915,11 +2080,11 @@ void integrate_3d_ctu(DomainS *pD)
         db1 = (rsf*pG->B1i[k  ][j  ][i+1] - lsf*pG->B1i[k][j][i])*dx1i;
         db2 = (    pG->B2i[k  ][j+1][i  ] -     pG->B2i[k][j][i])*dx2i;
         db3 = (    pG->B3i[k+1][j  ][i  ] -     pG->B3i[k][j][i])*dx3i;
-        B1 = pG->U[k][j][i].B1c;
-        B2 = pG->U[k][j][i].B2c;
-        B3 = pG->U[k][j][i].B3c;
-        V1 = pG->U[k][j][i].M1/pG->U[k][j][i].d;
-        V2 = pG->U[k][j][i].M2/pG->U[k][j][i].d;
+        B1 = GRID_U(pG,k,j,i,B1c);
+        B2 = GRID_U(pG,k,j,i,B2c);
+        B3 = GRID_U(pG,k,j,i,B3c);
+        V1 = GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d);
+        V2 = GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d);
 
         /* Calculate mdb1 = min_mod(-db3,db1) */
         if(db3 > 0.0 && db1 < 0.0){
@@ -1960,6 +2125,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -1977,12 +2146,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ur_x3Face[k][j][i].My -= hdt*pG->U[k][j][i].d*g;
+        Ur_x3Face[k][j][i].My -= hdt*GRID_U(pG,k,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k][j][i].M2;
+        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*GRID_U(pG,k,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k][j][i].d*Om*x1vc(pG,i);
+        Ur_x3Face[k][j][i].My += (pG->dt)*Omega_0*GRID_U(pG,k,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -1997,9 +2166,9 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifdef ROTATING_FRAME
-        Ur_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*pG->U[k][j][i].M1;
+        Ur_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*GRID_U(pG,k,j,i,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q2*(x2Flux[k  ][j  ][i].d*(phic - phil)
@@ -2014,12 +2183,12 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
         g -= r[i]*SQR((*OrbitalProfile)(r[i])); 
 #endif
-        Ul_x3Face[k][j][i].My -= hdt*pG->U[k-1][j][i].d*g;
+        Ul_x3Face[k][j][i].My -= hdt*GRID_U(pG,k-1,j,i,d)*g;
 #ifdef ROTATING_FRAME
-        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k-1][j][i].M2;
+        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*GRID_U(pG,k-1,j,i,M2);
         #ifdef FARGO
         Om = (*OrbitalProfile)(x1vc(pG,i));
-        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*pG->U[k-1][j][i].d*Om*x1vc(pG,i);
+        Ul_x3Face[k][j][i].My += (pG->dt)*Omega_0*GRID_U(pG,k-1,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
@@ -2034,9 +2203,9 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),(x3-pG->dx3));
         phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),(x3-pG->dx3));
 
-        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*GRID_U(pG,k-1,j,i,d);
 #ifdef ROTATING_FRAME
-        Ul_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*pG->U[k-1][j][i].M1;
+        Ul_x3Face[k][j][i].Mz -= (pG->dt)*Omega_0*GRID_U(pG,k-1,j,i,M1);
 #endif /*ROTATING_FRAME*/
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q2*(x2Flux[k-1][j  ][i].d*(phic - phil)
@@ -2052,6 +2221,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2060,7 +2233,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
 
-        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                                   + x1Flux[k][j][i+1].d*(phir - phic));
@@ -2069,7 +2242,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j+1][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
 
-        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                                   + x2Flux[k][j+1][i].d*(phir - phic));
@@ -2080,7 +2253,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j][i+1]);
         phil = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j][i-1]);
 
-        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*GRID_U(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q1*(x1Flux[k-1][j][i  ].d*(phic - phil)
                                   + x1Flux[k-1][j][i+1].d*(phir - phic));
@@ -2089,7 +2262,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j+1][i]);
         phil = 0.5*(pG->Phi[k-1][j][i] + pG->Phi[k-1][j-1][i]);
 
-        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*GRID_U(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q2*(x2Flux[k-1][j  ][i].d*(phic - phil)
                                   + x2Flux[k-1][j+1][i].d*(phir - phic));
@@ -2109,6 +2282,10 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef SHEARING_BOX
   if (ShearingBoxPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2118,7 +2295,7 @@ void integrate_3d_ctu(DomainS *pD)
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
         /* correct right states; x1 and x2 gradients */
-        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].My -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q1*(x1Flux[k  ][j][i  ].d*(phic - phil)
                                   + x1Flux[k  ][j][i+1].d*(phir - phic));
@@ -2127,7 +2304,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Ur_x3Face[k][j][i].Mz -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Ur_x3Face[k][j][i].E -= q2*(x2Flux[k  ][j  ][i].d*(phic - phil)
                                   + x2Flux[k  ][j+1][i].d*(phir - phic));
@@ -2138,7 +2315,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,(x3-pG->dx3));
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,(x3-pG->dx3));
 
-        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].My -= q1*(phir-phil)*GRID_U(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q1*(x1Flux[k-1][j][i  ].d*(phic - phil)
                                   + x1Flux[k-1][j][i+1].d*(phir - phic));
@@ -2147,7 +2324,7 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),(x3-pG->dx3));
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),(x3-pG->dx3));
 
-        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*pG->U[k-1][j][i].d;
+        Ul_x3Face[k][j][i].Mz -= q2*(phir-phil)*GRID_U(pG,k-1,j,i,d);
 #ifndef BAROTROPIC
         Ul_x3Face[k][j][i].E -= q2*(x2Flux[k-1][j  ][i].d*(phic - phil)
                                   + x2Flux[k-1][j+1][i].d*(phir - phic));
@@ -2156,17 +2333,21 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }}
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
-        Ur_x3Face[k][j][i].My += pG->dt*Omega_0*pG->U[k][j][i].M2;
-        Ul_x3Face[k][j][i].My += pG->dt*Omega_0*pG->U[k-1][j][i].M2;
+        Ur_x3Face[k][j][i].My += pG->dt*Omega_0*GRID_U(pG,k,j,i,M2);
+        Ul_x3Face[k][j][i].My += pG->dt*Omega_0*GRID_U(pG,k-1,j,i,M2);
 #ifdef FARGO
-        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
-        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*pG->U[k-1][j][i].M1;
+        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*GRID_U(pG,k,j,i,M1);
+        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.)*Omega_0*GRID_U(pG,k-1,j,i,M1);
 #else
-        Ur_x3Face[k][j][i].Mz -= pG->dt*Omega_0*pG->U[k][j][i].M1;
-        Ul_x3Face[k][j][i].Mz -= pG->dt*Omega_0*pG->U[k-1][j][i].M1;
+        Ur_x3Face[k][j][i].Mz -= pG->dt*Omega_0*GRID_U(pG,k,j,i,M1);
+        Ul_x3Face[k][j][i].Mz -= pG->dt*Omega_0*GRID_U(pG,k-1,j,i,M1);
 #endif
       }
     }
@@ -2174,17 +2355,21 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
 #if defined(CYLINDRICAL) && defined(FARGO)
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
 
-        Ur_x3Face[k][j][i].My += pG->dt*Om*pG->U[k][j][i].M2;
-        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*pG->U[k][j][i].M1;
+        Ur_x3Face[k][j][i].My += pG->dt*Om*GRID_U(pG,k,j,i,M2);
+        Ur_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*GRID_U(pG,k,j,i,M1);
 
-        Ul_x3Face[k][j][i].My += pG->dt*Om*pG->U[k-1][j][i].M2;
-        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*pG->U[k-1][j][i].M1;
+        Ul_x3Face[k][j][i].My += pG->dt*Om*GRID_U(pG,k-1,j,i,M2);
+        Ul_x3Face[k][j][i].Mz += hdt*(qshear-2.0)*Om*GRID_U(pG,k-1,j,i,M1);
       }
     }
   }
@@ -2195,6 +2380,10 @@ void integrate_3d_ctu(DomainS *pD)
  * states on x3-faces.  S_{M_R} = -(\rho v_\phi^2 - B_\phi^2)/R
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2208,6 +2397,10 @@ void integrate_3d_ctu(DomainS *pD)
 /*--- Step 7e ------------------------------------------------------------------
  * Apply density floor
  */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
   for (j=jl+1; j<=ju-1; j++) {
   for (i=il+1; i<=iu-1; i++) {
@@ -2248,6 +2441,10 @@ void integrate_3d_ctu(DomainS *pD)
 #endif
 #endif
   {
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (k=kl+1; k<=ku-1; k++) {
       for (j=jl+1; j<=ju-1; j++) {
 	for (i=il+1; i<=iu-1; i++) {
@@ -2255,7 +2452,7 @@ void integrate_3d_ctu(DomainS *pD)
           rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
           q2 = hdt/(r[i]*pG->dx2);
 #endif
-          dhalf[k][j][i] = pG->U[k][j][i].d 
+          dhalf[k][j][i] = GRID_U(pG,k,j,i,d) 
             - q1*(rsf*x1Flux[k  ][j  ][i+1].d - lsf*x1Flux[k][j][i].d)
             - q2*(    x2Flux[k  ][j+1][i  ].d -     x2Flux[k][j][i].d)
             - q3*(    x3Flux[k+1][j  ][i  ].d -     x3Flux[k][j][i].d);
@@ -2281,6 +2478,10 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* PARTICLES */
 #endif /* MHD */
   {
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=kl+1; k<=ku-1; k++) {
     for (j=jl+1; j<=ju-1; j++) {
       for (i=il+1; i<=iu-1; i++) {
@@ -2288,23 +2489,23 @@ void integrate_3d_ctu(DomainS *pD)
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
         q2 = hdt/(r[i]/pG->dx2);
 #endif
-        M1h = pG->U[k][j][i].M1
+        M1h = GRID_U(pG,k,j,i,M1)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].Mx - lsf*x1Flux[k][j][i].Mx)
            - q2*(    x2Flux[k  ][j+1][i  ].Mz -     x2Flux[k][j][i].Mz)
            - q3*(    x3Flux[k+1][j  ][i  ].My -     x3Flux[k][j][i].My);
 
-        M2h = pG->U[k][j][i].M2
+        M2h = GRID_U(pG,k,j,i,M2)
            - q1*(SQR(rsf)*x1Flux[k  ][j  ][i+1].My - SQR(lsf)*x1Flux[k][j][i].My)
            - q2*(         x2Flux[k  ][j+1][i  ].Mx -          x2Flux[k][j][i].Mx)
            - q3*(         x3Flux[k+1][j  ][i  ].Mz -          x3Flux[k][j][i].Mz);
 
-        M3h = pG->U[k][j][i].M3
+        M3h = GRID_U(pG,k,j,i,M3)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].Mz - lsf*x1Flux[k][j][i].Mz)
            - q2*(    x2Flux[k  ][j+1][i  ].My -     x2Flux[k][j][i].My)
            - q3*(    x3Flux[k+1][j  ][i  ].Mx -     x3Flux[k][j][i].Mx);
 
 #ifndef BAROTROPIC
-        Eh = pG->U[k][j][i].E
+        Eh = GRID_U(pG,k,j,i,E)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].E - lsf*x1Flux[k][j][i].E)
            - q2*(    x2Flux[k  ][j+1][i  ].E -     x2Flux[k][j][i].E)
            - q3*(    x3Flux[k+1][j  ][i  ].E -     x3Flux[k][j][i].E);
@@ -2320,40 +2521,40 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
-          M1h -= hdt*pG->U[k][j][i].d*g;
+          M1h -= hdt*GRID_U(pG,k,j,i,d)*g;
 #ifdef ROTATING_FRAME
-          M1h += (pG->dt)*Omega_0*pG->U[k][j][i].M2;
+          M1h += (pG->dt)*Omega_0*GRID_U(pG,k,j,i,M2);
         #ifdef FARGO
           Om = (*OrbitalProfile)(x1vc(pG,i));
-          M1h += (pG->dt)*Omega_0*pG->U[k][j][i].d*Om*x1vc(pG,i);
+          M1h += (pG->dt)*Omega_0*GRID_U(pG,k,j,i,d)*Om*x1vc(pG,i);
         #endif
 #endif
 
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+          M2h -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifdef ROTATING_FRAME
-          M2h -= (pG->dt)*Omega_0*pG->U[k][j][i].M1;
+          M2h -= (pG->dt)*Omega_0*GRID_U(pG,k,j,i,M1);
 #endif
 
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
-          M3h -= q3*(phir-phil)*pG->U[k][j][i].d;
+          M3h -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
         }
 
         /* Add source terms due to self-gravity  */
 #ifdef SELF_GRAVITY
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
-        M1h -= q1*(phir-phil)*pG->U[k][j][i].d;
+        M1h -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j+1][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
-        M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+        M2h -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
-        M3h -= q3*(phir-phil)*pG->U[k][j][i].d;
+        M3h -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #endif /* SELF_GRAVITY */
 
         /* Add the tidal gravity and Coriolis terms for shearing box. */
@@ -2362,29 +2563,29 @@ void integrate_3d_ctu(DomainS *pD)
           cc_pos(pG,i,j,k,&x1,&x2,&x3);
           phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
-          M1h -= q1*(phir-phil)*pG->U[k][j][i].d;
+          M1h -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 
           phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
-          M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+          M2h -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 
           phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
-          M3h -= q3*(phir-phil)*pG->U[k][j][i].d;
+          M3h -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
         }
 
-        M1h += pG->dt*Omega_0*pG->U[k][j][i].M2;
+        M1h += pG->dt*Omega_0*GRID_U(pG,k,j,i,M2);
 #ifdef FARGO
-        M2h += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
+        M2h += hdt*(qshear-2.)*Omega_0*GRID_U(pG,k,j,i,M1);
 #else
-        M2h -= pG->dt*Omega_0*pG->U[k][j][i].M1;
+        M2h -= pG->dt*Omega_0*GRID_U(pG,k,j,i,M1);
 #endif
 #endif /* SHEARING_BOX */
 #if defined(CYLINDRICAL) && defined(FARGO)
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
-        M1h += hdt*2.0*Om*pG->U[k][j][i].M2;
-        M2h += hdt*Om*(qshear-2.0)*pG->U[k][j][i].M1;
+        M1h += hdt*2.0*Om*GRID_U(pG,k,j,i,M2);
+        M2h += hdt*Om*(qshear-2.0)*GRID_U(pG,k,j,i,M1);
 #endif
 
         /* Add the particle feedback terms */
@@ -2437,10 +2638,12 @@ void integrate_3d_ctu(DomainS *pD)
 /*=== STEP 8.5: Integrate the particles, compute the feedback ================*/
 
 #ifdef PARTICLES
+  TIMER_START(TIMER_PARTICLES);
   Integrate_Particles(pD);
 #ifdef FEEDBACK
   exchange_gpcouple(pD,2);
 #endif
+  TIMER_STOP(TIMER_PARTICLES);
 #endif
 
 /*=== STEP 9: Compute 3D x1-Flux, x2-Flux, x3-Flux ===========================*/
@@ -2451,6 +2654,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef H_CORRECTION
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+2; i++) {
@@ -2466,6 +2673,10 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2481,6 +2692,10 @@ void integrate_3d_ctu(DomainS *pD)
     }
   }
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -2501,10 +2716,14 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x1-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
-      for (i=is; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+      for (i=is; i<=ie+1; i++) {
         etah = MAX(eta2[k][j][i-1],eta2[k][j][i]);
         etah = MAX(etah,eta2[k][j+1][i-1]);
         etah = MAX(etah,eta2[k][j+1][i  ]);
@@ -2515,7 +2734,6 @@ void integrate_3d_ctu(DomainS *pD)
         etah = MAX(etah,eta3[k+1][j][i  ]);
 
         etah = MAX(etah,eta1[k  ][j][i  ]);
-#endif /* H_CORRECTION */
 #ifdef MHD
         Bx = B1_x1Face[k][j][i];
 #endif
@@ -2525,6 +2743,17 @@ void integrate_3d_ctu(DomainS *pD)
         fluxes(Ul_x1Face[k][j][i],Ur_x1Face[k][j][i],Wl[i],Wr[i],Bx,
                &x1Flux[k][j][i]);
       }
+#else
+      for (i=is; i<=ie+1; i++) {
+#ifdef MHD
+        Bxi[i] = B1_x1Face[k][j][i];
+#endif
+        Wl[i] = Cons1D_to_Prim1D(&Ul_x1Face[k][j][i],&Bxi[i]);
+        Wr[i] = Cons1D_to_Prim1D(&Ur_x1Face[k][j][i],&Bxi[i]);
+      }
+      fluxes_pencil(is,ie+1,Ul_x1Face[k][j],Ur_x1Face[k][j],Wl,Wr,Bxi,
+                    x1Flux[k][j]);
+#endif /* H_CORRECTION */
     }
   }
 
@@ -2532,10 +2761,14 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x2-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
-      for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+      for (i=is-1; i<=ie+1; i++) {
         etah = MAX(eta1[k][j-1][i],eta1[k][j][i]);
         etah = MAX(etah,eta1[k][j-1][i+1]);
         etah = MAX(etah,eta1[k][j  ][i+1]);
@@ -2546,7 +2779,6 @@ void integrate_3d_ctu(DomainS *pD)
         etah = MAX(etah,eta3[k+1][j  ][i]);
 
         etah = MAX(etah,eta2[k  ][j  ][i]);
-#endif /* H_CORRECTION */
 #ifdef MHD
         Bx = B2_x2Face[k][j][i];
 #endif
@@ -2556,6 +2788,17 @@ void integrate_3d_ctu(DomainS *pD)
         fluxes(Ul_x2Face[k][j][i],Ur_x2Face[k][j][i],Wl[i],Wr[i],Bx,
                &x2Flux[k][j][i]);
       }
+#else
+      for (i=is-1; i<=ie+1; i++) {
+#ifdef MHD
+        Bxi[i] = B2_x2Face[k][j][i];
+#endif
+        Wl[i] = Cons1D_to_Prim1D(&Ul_x2Face[k][j][i],&Bxi[i]);
+        Wr[i] = Cons1D_to_Prim1D(&Ur_x2Face[k][j][i],&Bxi[i]);
+      }
+      fluxes_pencil(is-1,ie+1,Ul_x2Face[k][j],Ur_x2Face[k][j],Wl,Wr,Bxi,
+                    x2Flux[k][j]);
+#endif /* H_CORRECTION */
     }
   }
 
@@ -2563,10 +2806,14 @@ void integrate_3d_ctu(DomainS *pD)
  * Compute 3D x3-fluxes from corrected L/R states.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
-      for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+      for (i=is-1; i<=ie+1; i++) {
         etah = MAX(eta1[k-1][j][i],eta1[k][j][i]);
         etah = MAX(etah,eta1[k-1][j][i+1]);
         etah = MAX(etah,eta1[k][j  ][i+1]);
@@ -2577,7 +2824,6 @@ void integrate_3d_ctu(DomainS *pD)
         etah = MAX(etah,eta2[k  ][j+1][i]);
 
         etah = MAX(etah,eta3[k  ][j  ][i]);
-#endif /* H_CORRECTION */
 #ifdef MHD
         Bx = B3_x3Face[k][j][i];
 #endif
@@ -2587,6 +2833,17 @@ void integrate_3d_ctu(DomainS *pD)
         fluxes(Ul_x3Face[k][j][i],Ur_x3Face[k][j][i],Wl[i],Wr[i],Bx,
                &x3Flux[k][j][i]);
       }
+#else
+      for (i=is-1; i<=ie+1; i++) {
+#ifdef MHD
+        Bxi[i] = B3_x3Face[k][j][i];
+#endif
+        Wl[i] = Cons1D_to_Prim1D(&Ul_x3Face[k][j][i],&Bxi[i]);
+        Wr[i] = Cons1D_to_Prim1D(&Ur_x3Face[k][j][i],&Bxi[i]);
+      }
+      fluxes_pencil(is-1,ie+1,Ul_x3Face[k][j],Ur_x3Face[k][j],Wl,Wr,Bxi,
+                    x3Flux[k][j]);
+#endif /* H_CORRECTION */
     }
   }
 
@@ -2688,6 +2945,10 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -2718,6 +2979,10 @@ void integrate_3d_ctu(DomainS *pD)
         dtodx3*(emf1[k+1][je+1][i  ] - emf1[k][je+1][i]);
     }
   }
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
@@ -2736,6 +3001,10 @@ void integrate_3d_ctu(DomainS *pD)
  * Add geometric source terms
  */
 #ifdef CYLINDRICAL
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -2743,7 +3012,7 @@ void integrate_3d_ctu(DomainS *pD)
         q2 = hdt/(r[i]*pG->dx2);
 
         /* calculate d at time n+1/2 */
-        dhalf[k][j][i] = pG->U[k][j][i].d 
+        dhalf[k][j][i] = GRID_U(pG,k,j,i,d) 
           - q1*(rsf*x1Flux[k  ][j  ][i+1].d - lsf*x1Flux[k][j][i].d)
           - q2*(    x2Flux[k  ][j+1][i  ].d -     x2Flux[k][j][i].d)
           - q3*(    x3Flux[k+1][j  ][i  ].d -     x3Flux[k][j][i].d);
@@ -2751,8 +3020,8 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef FARGO
         dtodx2 = pG->dt/(r[i]*pG->dx2);
         /* Save current R/phi momenta */
-        Mrn = pG->U[k][j][i].M1;
-        Mpn = pG->U[k][j][i].M2;
+        Mrn = GRID_U(pG,k,j,i,M1);
+        Mpn = GRID_U(pG,k,j,i,M2);
 
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
@@ -2774,17 +3043,17 @@ void integrate_3d_ctu(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
           g = (phir-phil)/pG->dx1;
-	  Mre -= pG->dt*pG->U[k][j][i].d*g;
+	  Mre -= pG->dt*GRID_U(pG,k,j,i,d)*g;
 
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          Mpe -= dtodx2*(phir-phil)*pG->U[k][j][i].d;
+          Mpe -= dtodx2*(phir-phil)*GRID_U(pG,k,j,i,d);
         }
 
-          Mre += pG->dt*pG->U[k][j][i].d*r[i]*SQR((*OrbitalProfile)(r[i]));
+          Mre += pG->dt*GRID_U(pG,k,j,i,d)*r[i]*SQR((*OrbitalProfile)(r[i]));
 #ifdef ROTATING_FRAME
-          Mre += (pG->dt)*2.0*Omega_0*(pG->U[k][j][i].M2+pG->U[k][j][i].d*Om*x1vc(pG,i));
-          Mpe -= (pG->dt)*2.0*Omega_0*pG->U[k][j][i].M1;
+          Mre += (pG->dt)*2.0*Omega_0*(GRID_U(pG,k,j,i,M2)+GRID_U(pG,k,j,i,d)*Om*x1vc(pG,i));
+          Mpe -= (pG->dt)*2.0*Omega_0*GRID_U(pG,k,j,i,M1);
 #endif
 
         /* Average forward euler and current values to approximate at t^{n+1/2} */
@@ -2796,12 +3065,12 @@ void integrate_3d_ctu(DomainS *pD)
 #else /* FARGO */
 
         /* calculate M1 and M2 at time n+1/2 */
-        M1h = pG->U[k][j][i].M1
+        M1h = GRID_U(pG,k,j,i,M1)
            - q1*(rsf*x1Flux[k  ][j  ][i+1].Mx - lsf*x1Flux[k][j][i].Mx)
            - q2*(    x2Flux[k  ][j+1][i  ].Mz -     x2Flux[k][j][i].Mz)
            - q3*(    x3Flux[k+1][j  ][i  ].My -     x3Flux[k][j][i].My);
         M1h += hdt*geom_src[k][j][i];
-        M2h = pG->U[k][j][i].M2
+        M2h = GRID_U(pG,k,j,i,M2)
            - q1*(SQR(rsf)*x1Flux[k  ][j  ][i+1].My - SQR(lsf)*x1Flux[k][j][i].My)
            - q2*(         x2Flux[k  ][j+1][i  ].Mx -          x2Flux[k][j][i].Mx)
            - q3*(         x3Flux[k+1][j  ][i  ].Mz -          x3Flux[k][j][i].Mz);
@@ -2811,15 +3080,15 @@ void integrate_3d_ctu(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
           g = (phir-phil)/pG->dx1;
-          M1h -= hdt*pG->U[ks][j][i].d*g;
+          M1h -= hdt*GRID_U(pG,ks,j,i,d)*g;
 
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          M2h -= q2*(phir-phil)*pG->U[k][j][i].d;
+          M2h -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
         }
 #ifdef ROTATING_FRAME
-          M1h += (pG->dt)*Omega_0*pG->U[ks][j][i].M2;
-          M2h -= (pG->dt)*Omega_0*pG->U[ks][j][i].M1;
+          M1h += (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M2);
+          M2h -= (pG->dt)*Omega_0*GRID_U(pG,ks,j,i,M1);
 #endif /*ROTATING_FRAME*/
 
         /* Compute geometric source term at time n+1/2 */
@@ -2845,18 +3114,18 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifdef FARGO
         /* Use average values to apply source terms for full time-step */
-        pG->U[k][j][i].M1 += pG->dt*( 2.0*Om*Mpav + geom_src[k][j][i]);
-        pG->U[k][j][i].M2 += pG->dt*( Om*(qshear-2.0)*Mrav);
+        GRID_U(pG,k,j,i,M1) += pG->dt*( 2.0*Om*Mpav + geom_src[k][j][i]);
+        GRID_U(pG,k,j,i,M2) += pG->dt*( Om*(qshear-2.0)*Mrav);
 #ifdef ROTATING_FRAME
-        pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
-        pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*Mrav;
+        GRID_U(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*(Mpav+dhalf[j][i]*Om*x1vc(pG,i));
+        GRID_U(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*Mrav;
 #endif
 #else /* FARGO */
         /* Add time-centered geometric source term for full dt */
-        pG->U[k][j][i].M1 += pG->dt*geom_src[k][j][i];
+        GRID_U(pG,k,j,i,M1) += pG->dt*geom_src[k][j][i];
 #ifdef ROTATING_FRAME
-        pG->U[ks][j][i].M1 += (pG->dt)*2.0*Omega_0*M2h;
-        pG->U[ks][j][i].M2 -= (pG->dt)*2.0*Omega_0*M1h;
+        GRID_U(pG,ks,j,i,M1) += (pG->dt)*2.0*Omega_0*M2h;
+        GRID_U(pG,ks,j,i,M2) -= (pG->dt)*2.0*Omega_0*M1h;
 #endif /* ROTATING_FRAME */
 #endif /* FARGO */
       }
@@ -2876,17 +3145,21 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef SHEARING_BOX
   fact = om_dt/(2. + (2.-qshear)*om_dt*om_dt);
   qom = qshear*Omega_0;
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for(k=ks; k<=ke; k++) {
     for(j=js; j<=je; j++) {
       for(i=is; i<=ie; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
 
         /* Store the current state */
-        M1n  = pG->U[k][j][i].M1;
+        M1n  = GRID_U(pG,k,j,i,M1);
 #ifdef FARGO
-        dM2n = pG->U[k][j][i].M2;
+        dM2n = GRID_U(pG,k,j,i,M2);
 #else
-        dM2n = pG->U[k][j][i].M2 + qom*x1*pG->U[k][j][i].d;
+        dM2n = GRID_U(pG,k,j,i,M2) + qom*x1*GRID_U(pG,k,j,i,d);
 #endif
 
         /* Calculate the flux for the y-momentum fluctuation */
@@ -2923,11 +3196,11 @@ void integrate_3d_ctu(DomainS *pD)
  * potential momentum source terms using a Crank-Nicholson
  * discretization for the momentum fluctuation equation. */
 
-        pG->U[k][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-        pG->U[k][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+        GRID_U(pG,k,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+        GRID_U(pG,k,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 
 #ifndef FARGO
-        pG->U[k][j][i].M2 -= 0.5*qshear*om_dt*
+        GRID_U(pG,k,j,i,M2) -= 0.5*qshear*om_dt*
             (x1Flux[k][j][i].d + x1Flux[k][j][i+1].d);
 #endif
 
@@ -2938,21 +3211,21 @@ void integrate_3d_ctu(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif
 
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif
 
         phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif
       }
@@ -2961,6 +3234,10 @@ void integrate_3d_ctu(DomainS *pD)
 #endif /* SHEARING_BOX */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
@@ -2977,28 +3254,28 @@ void integrate_3d_ctu(DomainS *pD)
 #if defined(CYLINDRICAL) && defined(FARGO)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
-          pG->U[k][j][i].M1 -= pG->dt*dhalf[k][j][i]*g;
+          GRID_U(pG,k,j,i,M1) -= pG->dt*dhalf[k][j][i]*g;
 #ifndef BAROTROPIC
 #ifdef CYLINDRICAL
-          pG->U[k][j][i].E -= hdt*g*(lsf*x1Flux[k][j][i  ].d +
+          GRID_U(pG,k,j,i,E) -= hdt*g*(lsf*x1Flux[k][j][i  ].d +
                                      rsf*x1Flux[k][j][i+1].d);
 #else
-          pG->U[k][j][i].E -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil) +
+          GRID_U(pG,k,j,i,E) -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil) +
                                       rsf*x1Flux[k][j][i+1].d*(phir - phic));
 #endif
 #endif
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
-          pG->U[k][j][i].M2 -= dtodx2*(phir-phil)*dhalf[k][j][i];
+          GRID_U(pG,k,j,i,M2) -= dtodx2*(phir-phil)*dhalf[k][j][i];
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+          GRID_U(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                       x2Flux[k][j+1][i].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
-          pG->U[k][j][i].M3 -= dtodx3*(phir-phil)*dhalf[k][j][i];
+          GRID_U(pG,k,j,i,M3) -= dtodx3*(phir-phil)*dhalf[k][j][i];
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+          GRID_U(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                       x3Flux[k+1][j][i].d*(phir - phic));
 #endif
         }
@@ -3015,6 +3292,10 @@ void integrate_3d_ctu(DomainS *pD)
 #ifdef SELF_GRAVITY
 /* Add fluxes and source terms due to (d/dx1) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -3047,11 +3328,11 @@ void integrate_3d_ctu(DomainS *pD)
         flx_m3r = gxr*gzr/four_pi_G;
 
         /* Update momenta and energy with d/dx1 terms  */
-        pG->U[k][j][i].M1 -= dtodx1*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx1*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx1*(flx_m3r - flx_m3l);
+        GRID_U(pG,k,j,i,M1) -= dtodx1*(flx_m1r - flx_m1l);
+        GRID_U(pG,k,j,i,M2) -= dtodx1*(flx_m2r - flx_m2l);
+        GRID_U(pG,k,j,i,M3) -= dtodx1*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -3060,6 +3341,10 @@ void integrate_3d_ctu(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx2) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -3092,11 +3377,11 @@ void integrate_3d_ctu(DomainS *pD)
         flx_m3r = gyr*gzr/four_pi_G;
 
         /* Update momenta and energy with d/dx2 terms  */
-        pG->U[k][j][i].M1 -= dtodx2*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx2*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx2*(flx_m3r - flx_m3l);
+        GRID_U(pG,k,j,i,M1) -= dtodx2*(flx_m1r - flx_m1l);
+        GRID_U(pG,k,j,i,M2) -= dtodx2*(flx_m2r - flx_m2l);
+        GRID_U(pG,k,j,i,M3) -= dtodx2*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -3105,6 +3390,10 @@ void integrate_3d_ctu(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx3) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -3137,11 +3426,11 @@ void integrate_3d_ctu(DomainS *pD)
         flx_m3r = 0.5*(gzr*gzr-gxr*gxr-gyr*gyr)/four_pi_G + grav_mean_rho*phir;
 
 /* Update momenta and energy with d/dx3 terms  */
-        pG->U[k][j][i].M1 -= dtodx3*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx3*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx3*(flx_m3r - flx_m3l);
+        GRID_U(pG,k,j,i,M1) -= dtodx3*(flx_m1r - flx_m1l);
+        GRID_U(pG,k,j,i,M2) -= dtodx3*(flx_m2r - flx_m2l);
+        GRID_U(pG,k,j,i,M3) -= dtodx3*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -3150,6 +3439,10 @@ void integrate_3d_ctu(DomainS *pD)
 
 /* Save mass fluxes in Grid structure for source term correction in main loop */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -3167,11 +3460,15 @@ void integrate_3d_ctu(DomainS *pD)
 
 #ifndef BAROTROPIC
   if (CoolingFunc != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
     for (k=ks; k<=ke; k++){
       for (j=js; j<=je; j++){
         for (i=is; i<=ie; i++){
           coolf = (*CoolingFunc)(dhalf[k][j][i],phalf[k][j][i],pG->dt);
-          pG->U[k][j][i].E -= pG->dt*coolf;
+          GRID_U(pG,k,j,i,E) -= pG->dt*coolf;
         }
       }
     }
@@ -3183,14 +3480,18 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef FEEDBACK
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++)
     for (j=js; j<=je; j++)
       for (i=is; i<=ie; i++) {
-      pG->U[k][j][i].M1 -= pG->Coup[k][j][i].fb1;
-      pG->U[k][j][i].M2 -= pG->Coup[k][j][i].fb2;
-      pG->U[k][j][i].M3 -= pG->Coup[k][j][i].fb3;
+      GRID_U(pG,k,j,i,M1) -= pG->Coup[k][j][i].fb1;
+      GRID_U(pG,k,j,i,M2) -= pG->Coup[k][j][i].fb2;
+      GRID_U(pG,k,j,i,M3) -= pG->Coup[k][j][i].fb3;
 #ifndef BAROTROPIC
-      pG->U[k][j][i].E += pG->Coup[k][j][i].Eloss;
+      GRID_U(pG,k,j,i,E) += pG->Coup[k][j][i].Eloss;
       pG->Coup[k][j][i].Eloss *= dt1; /* for history output purpose */
       pG->Eloss[k][j][i] *= dt1; /* for history output purpose */
 #endif
@@ -3203,22 +3504,26 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x1-Fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].d  -= dtodx1*(rsf*x1Flux[k][j][i+1].d -lsf*x1Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx-lsf*x1Flux[k][j][i].Mx);
-        pG->U[k][j][i].M2 -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My-SQR(lsf)*x1Flux[k][j][i].My);
-        pG->U[k][j][i].M3 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz-lsf*x1Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,d)  -= dtodx1*(rsf*x1Flux[k][j][i+1].d -lsf*x1Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx-lsf*x1Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,M2) -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My-SQR(lsf)*x1Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,M3) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz-lsf*x1Flux[k][j][i].Mz);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx1*(rsf*x1Flux[k][j][i+1].E -lsf*x1Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E)  -= dtodx1*(rsf*x1Flux[k][j][i+1].E -lsf*x1Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
                                        - lsf*x1Flux[k][j][i  ].s[n]);
 #endif
       }
@@ -3229,22 +3534,26 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x2-Fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         dtodx2 = pG->dt/(r[i]*pG->dx2);
 #endif
-        pG->U[k][j][i].d  -= dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
-        pG->U[k][j][i].M2 -= dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
-        pG->U[k][j][i].M3 -= dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,d)  -= dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1) -= dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,M2) -= dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,M3) -= dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E) -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx2*(x2Flux[k][j+1][i].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx2*(x2Flux[k][j+1][i].s[n]
                                        - x2Flux[k][j  ][i].s[n]);
 #endif
       }
@@ -3255,22 +3564,29 @@ void integrate_3d_ctu(DomainS *pD)
  * Update cell-centered variables in pG using 3D x3-Fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE) CFL_REDUCTION
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d  -= dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
-        pG->U[k][j][i].M2 -= dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
-        pG->U[k][j][i].M3 -= dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,d)  -= dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1) -= dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,M2) -= dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,M3) -= dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E)  -= dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx3*(x3Flux[k+1][j][i].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx3*(x3Flux[k+1][j][i].s[n]
                                        - x3Flux[k  ][j][i].s[n]);
 #endif
       }
+#if defined(FUSED_CFL) && !defined(MHD)
+      new_dt_speeds(pG,j,k,&cfl_v1,&cfl_v2,&cfl_v3);
+#endif
     }
   }
 
@@ -3279,19 +3595,32 @@ void integrate_3d_ctu(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,CTU_PRIVATE) \
+  firstprivate(CTU_FIRSTPRIVATE) lastprivate(CTU_FIRSTPRIVATE) CFL_REDUCTION
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
-        pG->U[k][j][i].B2c = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
-        pG->U[k][j][i].B3c = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
+        GRID_U(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+        GRID_U(pG,k,j,i,B2c) = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
+        GRID_U(pG,k,j,i,B3c) = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
       }
+#ifdef FUSED_CFL
+      new_dt_speeds(pG,j,k,&cfl_v1,&cfl_v2,&cfl_v3);
+#endif
     }
   }
 #endif /* MHD */
+#ifdef FUSED_CFL
+  pG->max_v1 = cfl_v1;
+  pG->max_v2 = cfl_v2;
+  pG->max_v3 = cfl_v3;
+  pG->cfl_set = 1;
+#endif /* FUSED_CFL */
 
 #ifdef STATIC_MESH_REFINEMENT
 /*--- Step 12e -----------------------------------------------------------------
@@ -3598,7 +3927,7 @@ void integrate_3d_ctu(DomainS *pD)
 */
 void integrate_init_3d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -3646,8 +3975,6 @@ void integrate_init_3d(MeshS *pM)
     goto on_error;
 #endif /* H_CORRECTION */
 
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
 
 #ifdef MHD
   if ((B1_x1Face = (Real***)calloc_3d_array(size3,size2,size1, sizeof(Real)))
@@ -3658,10 +3985,19 @@ void integrate_init_3d(MeshS *pM)
     == NULL) goto on_error;
 #endif /* MHD */
 
-  if ((U1d=(Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W  =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* 1D scratch vectors are private to each OpenMP thread */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel reduction(+:nerr)
+#endif
+  {
+    if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) nerr++;
+    if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) nerr++;
+    if ((U1d=(Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((W  =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+    if ((Wl =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+    if ((Wr =(Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+  }
+  if (nerr > 0) goto on_error;
 
   if ((Ul_x1Face=(Cons1DS***)calloc_3d_array(size3,size2,size1,sizeof(Cons1DS)))
     == NULL) goto on_error;
@@ -3741,18 +4077,23 @@ void integrate_destruct_3d(void)
   if (eta3 != NULL) free_3d_array(eta3);
 #endif /* H_CORRECTION */
 
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
   if (B1_x1Face != NULL) free_3d_array(B1_x1Face);
   if (B2_x2Face != NULL) free_3d_array(B2_x2Face);
   if (B3_x3Face != NULL) free_3d_array(B3_x3Face);
 #endif /* MHD */
 
-  if (U1d      != NULL) free(U1d);
-  if (W        != NULL) free(W);
-  if (Wl       != NULL) free(Wl);
-  if (Wr       != NULL) free(Wr);
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
+  {
+    if (Bxc != NULL) free(Bxc);
+    if (Bxi != NULL) free(Bxi);
+    if (U1d != NULL) free(U1d);
+    if (W   != NULL) free(W);
+    if (Wl  != NULL) free(Wl);
+    if (Wr  != NULL) free(Wr);
+  }
 
   if (Ul_x1Face != NULL) free_3d_array(Ul_x1Face);
   if (Ur_x1Face != NULL) free_3d_array(Ur_x1Face);
@@ -3802,6 +4143,9 @@ static void integrate_emf1_corner(const GridS *pG)
   int k, ks = pG->ks, ke = pG->ke;
   Real de1_l2, de1_r2, de1_l3, de1_r3;
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,de1_l2,de1_r2,de1_l3,de1_r3)
+#endif
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-2; i<=ie+2; i++) {
@@ -3871,6 +4215,9 @@ static void integrate_emf2_corner(const GridS *pG)
   int k, ks = pG->ks, ke = pG->ke;
   Real de2_l1, de2_r1, de2_l3, de2_r3;
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,de2_l1,de2_r1,de2_l3,de2_r3)
+#endif
   for (k=ks-1; k<=ke+2; k++) {
     for (j=js-2; j<=je+2; j++) {
       for (i=is-1; i<=ie+2; i++) {
@@ -3941,6 +4288,9 @@ static void integrate_emf3_corner(const GridS *pG)
   Real de3_l1, de3_r1, de3_l2, de3_r2;
   Real rsf=1.0,lsf=1.0;
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,de3_l1,de3_r1,de3_l2,de3_r2) firstprivate(rsf,lsf)
+#endif
   for (k=ks-2; k<=ke+2; k++) {
     for (j=js-1; j<=je+2; j++) {
       for (i=is-1; i<=ie+2; i++) {
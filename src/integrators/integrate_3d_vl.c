@@ -13,6 +13,16 @@
  *   - For adb hydro, requires (9*Cons1DS + 3*Real + 1*ConsS) = 53 3D arrays
  *   - For adb mhd, requires   (9*Cons1DS + 9*Real + 1*ConsS) = 80 3D arrays
  *
+ *   With --enable-openmp the sweeps over the outer (k or j) index are
+ *   threaded; the 1D scratch vectors are threadprivate.  The update of each
+ *   cell is independent of the thread count, so results are bitwise identical
+ *   to the serial integrator.  The first-order flux correction, SMR flux
+ *   storage and shearing-box remaps remain serial.
+ *
+ *   If any of <job>/tile_nx1,tile_nx2,tile_nx3 is set the Grid is instead
+ *   advanced by integrate_3d_vl_tiled() in cache-sized bricks, and the
+ *   scratch arrays above are only as large as one brick plus ghost zones.
+ *
  * REFERENCE: 
  * - J.M Stone & T.A. Gardiner, "A simple, unsplit Godunov method
  *   for multidimensional MHD", NewA 14, 139 (2009)
@@ -23,6 +33,7 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - integrate_3d_vl()
+ * - integrate_3d_vl_tiled()
  * - integrate_destruct_3d()
  * - integrate_init_3d() */
 /*============================================================================*/
@@ -67,7 +78,10 @@ static Real ***emf1_cc=NULL, ***emf2_cc=NULL, ***emf3_cc=NULL;
 /* 1D scratch vectors used by lr_states and flux functions */
 static Real *Bxc=NULL, *Bxi=NULL;
 static Prim1DS *W1d=NULL, *Wl=NULL, *Wr=NULL;
-static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL;
+static Cons1DS *U1d=NULL, *Ul=NULL, *Ur=NULL, *F1d=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(Bxc,Bxi,W1d,Wl,Wr,U1d,Ul,Ur,F1d)
+#endif
 
 /* conserved variables at t^{n+1/2} computed in predict step */
 static ConsS ***Uhalf=NULL;
@@ -82,12 +96,26 @@ static Real ***eta1=NULL, ***eta2=NULL, ***eta3=NULL;
 static ConsS **Flxiib=NULL, **Flxoib=NULL;
 static ConsS **rFlxiib=NULL, **rFlxoib=NULL;
 #endif
+
+/* variables needed for the tiled (cache-blocked) update: a Grid holding one
+ * brick plus ghost zones, and buffers for two x3-planes of updated bricks */
+static int tile_nx1=0, tile_nx2=0, tile_nx3=0;
+static GridS Tile;
+static DomainS TileDomain;
+static ConsS ***Ubuf[2]={NULL,NULL};
+#ifdef MHD
+static Real ***B1buf[2]={NULL,NULL}, ***B2buf[2]={NULL,NULL};
+static Real ***B3buf[2]={NULL,NULL};
+#endif
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
  *   integrate_emf1_corner() - upwind CT method of GS (2005) for emf1
  *   integrate_emf2_corner() - upwind CT method of GS (2005) for emf2 
  *   integrate_emf3_corner() - upwind CT method of GS (2005) for emf3
  *   FixCell() - apply first-order correction to one cell
+ *   load_tile()  - copy one brick of Grid plus ghost zones into Tile
+ *   store_tile() - copy updated interior of Tile into plane buffer
+ *   flush_tile_plane() - copy plane buffer back into Grid
  *============================================================================*/
 #ifdef MHD
 static void integrate_emf1_corner(const GridS *pG);
@@ -99,6 +127,11 @@ static void FixCell(GridS *pG, Int3Vect);
 static void ApplyCorr(GridS *pG, int i, int j, int k, 
                       int lx1, int rx1, int lx2, int rx2, int lx3, int rx3);
 #endif
+static void load_tile(const GridS *pG, int ibs, int ibe, int jbs, int jbe,
+                      int kbs, int kbe);
+static void store_tile(const GridS *pG, int nb, int ibs, int ibe, int jbs,
+                       int jbe, int kbs, int kbe, int kps);
+static void flush_tile_plane(GridS *pG, int nb, int kps, int kpe);
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -108,6 +141,9 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
 void integrate_3d_vl(DomainS *pD)
 {
   GridS *pG=(pD->Grid);
+#ifdef FUSED_CFL
+  Real cfl_v1=0.0,cfl_v2=0.0,cfl_v3=0.0;
+#endif
   PrimS W,Whalf;
   Real dtodx1=pG->dt/pG->dx1, dtodx2=pG->dt/pG->dx2, dtodx3=pG->dt/pG->dx3;
   Real q1 = 0.5*dtodx1, q2 = 0.5*dtodx2, q3 = 0.5*dtodx3;
@@ -116,7 +152,7 @@ void integrate_3d_vl(DomainS *pD)
   int j, js = pG->js, je = pG->je;
   int k, ks = pG->ks, ke = pG->ke;
   Real x1,x2,x3,phicl,phicr,phifc,phil,phir,phic,Bx;
-#if (NSCALARS > 0)
+#if (NSCALARS > 0) || defined(OPENMP_PARALLEL)
   int n;
 #endif
 #ifdef SELF_GRAVITY
@@ -140,6 +176,7 @@ void integrate_3d_vl(DomainS *pD)
   int flag_cell=0,negd=0,negP=0,superl=0,NaNFlux=0;
   Real Vsq;
   Int3Vect BadCell;
+  ConsS Ufofc;
 #endif
   int il=is-(nghost-1), iu=ie+(nghost-1);
   int jl=js-(nghost-1), ju=je+(nghost-1);
@@ -160,13 +197,20 @@ void integrate_3d_vl(DomainS *pD)
     ath_error("[integrate_3d_vl]:  OrbitalProfile() and ShearProfile() *must* be defined.\n");
 #endif
 
-/* Set etah=0 so first calls to flux functions do not use H-correction */
+/* Set etah=0 so first calls to flux functions do not use H-correction.
+ * etah is threadprivate, so it must be reset in every thread. */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
   etah = 0.0;
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        Uhalf[k][j][i] = pG->U[k][j][i];
+        Uhalf[k][j][i] = GET_GRID_U(pG,k,j,i);
 #ifdef MHD
         B1_x1Face[k][j][i] = pG->B1i[k][j][i];
         B2_x2Face[k][j][i] = pG->B2i[k][j][i];
@@ -184,24 +228,27 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-	U1d[i].d  = pG->U[k][j][i].d;
-	U1d[i].Mx = pG->U[k][j][i].M1;
-	U1d[i].My = pG->U[k][j][i].M2;
-	U1d[i].Mz = pG->U[k][j][i].M3;
+	U1d[i].d  = GRID_U(pG,k,j,i,d);
+	U1d[i].Mx = GRID_U(pG,k,j,i,M1);
+	U1d[i].My = GRID_U(pG,k,j,i,M2);
+	U1d[i].Mz = GRID_U(pG,k,j,i,M3);
 #ifndef BAROTROPIC
-	U1d[i].E  = pG->U[k][j][i].E;
+	U1d[i].E  = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-	U1d[i].By = pG->U[k][j][i].B2c;
-	U1d[i].Bz = pG->U[k][j][i].B3c;
-        Bxc[i] = pG->U[k][j][i].B1c;
+	U1d[i].By = GRID_U(pG,k,j,i,B2c);
+	U1d[i].Bz = GRID_U(pG,k,j,i,B3c);
+        Bxc[i] = GRID_U(pG,k,j,i,B1c);
         Bxi[i] = pG->B1i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[i].s[n] = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -228,9 +275,7 @@ void integrate_3d_vl(DomainS *pD)
 /*--- Step 1d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
-      for (i=il; i<=ie+nghost; i++) {
-        fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&x1Flux[k][j][i]);
-      }
+      fluxes_pencil(il,ie+nghost,Ul,Ur,Wl,Wr,Bxi,x1Flux[k][j]);
     }
   }
 
@@ -242,24 +287,27 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,j,n)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (j=js-nghost; j<=je+nghost; j++) {
-	U1d[j].d  = pG->U[k][j][i].d;
-	U1d[j].Mx = pG->U[k][j][i].M2;
-	U1d[j].My = pG->U[k][j][i].M3;
-	U1d[j].Mz = pG->U[k][j][i].M1;
+	U1d[j].d  = GRID_U(pG,k,j,i,d);
+	U1d[j].Mx = GRID_U(pG,k,j,i,M2);
+	U1d[j].My = GRID_U(pG,k,j,i,M3);
+	U1d[j].Mz = GRID_U(pG,k,j,i,M1);
 #ifndef BAROTROPIC
-	U1d[j].E  = pG->U[k][j][i].E;
+	U1d[j].E  = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-	U1d[j].By = pG->U[k][j][i].B3c;
-	U1d[j].Bz = pG->U[k][j][i].B1c;
-        Bxc[j] = pG->U[k][j][i].B2c;
+	U1d[j].By = GRID_U(pG,k,j,i,B3c);
+	U1d[j].Bz = GRID_U(pG,k,j,i,B1c);
+        Bxc[j] = GRID_U(pG,k,j,i,B2c);
         Bxi[j] = pG->B2i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[j].s[n] = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -286,8 +334,9 @@ void integrate_3d_vl(DomainS *pD)
 /*--- Step 2d ------------------------------------------------------------------
  * Compute flux in x2-direction */
 
+      fluxes_pencil(jl,je+nghost,Ul,Ur,Wl,Wr,Bxi,F1d);
       for (j=jl; j<=je+nghost; j++) {
-        fluxes(Ul[j],Ur[j],Wl[j],Wr[j],Bxi[j],&x2Flux[k][j][i]);
+        x2Flux[k][j][i] = F1d[j];
       }
     }
   }
@@ -300,24 +349,27 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,k,n)
+#endif
   for (j=js-nghost; j<=je+nghost; j++) {
     for (i=is-nghost; i<=ie+nghost; i++) {
       for (k=ks-nghost; k<=ke+nghost; k++) {
-	U1d[k].d  = pG->U[k][j][i].d;
-	U1d[k].Mx = pG->U[k][j][i].M3;
-	U1d[k].My = pG->U[k][j][i].M1;
-	U1d[k].Mz = pG->U[k][j][i].M2;
+	U1d[k].d  = GRID_U(pG,k,j,i,d);
+	U1d[k].Mx = GRID_U(pG,k,j,i,M3);
+	U1d[k].My = GRID_U(pG,k,j,i,M1);
+	U1d[k].Mz = GRID_U(pG,k,j,i,M2);
 #ifndef BAROTROPIC
-	U1d[k].E  = pG->U[k][j][i].E;
+	U1d[k].E  = GRID_U(pG,k,j,i,E);
 #endif /* BAROTROPIC */
 #ifdef MHD
-	U1d[k].By = pG->U[k][j][i].B1c;
-	U1d[k].Bz = pG->U[k][j][i].B2c;
-        Bxc[k] = pG->U[k][j][i].B3c;
+	U1d[k].By = GRID_U(pG,k,j,i,B1c);
+	U1d[k].Bz = GRID_U(pG,k,j,i,B2c);
+        Bxc[k] = GRID_U(pG,k,j,i,B3c);
         Bxi[k] = pG->B3i[k][j][i];
 #endif /* MHD */
 #if (NSCALARS > 0)
-        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = pG->U[k][j][i].s[n];
+        for (n=0; n<NSCALARS; n++) U1d[k].s[n] = GRID_U(pG,k,j,i,s[n]);
 #endif
       }
 
@@ -344,8 +396,9 @@ void integrate_3d_vl(DomainS *pD)
 /*--- Step 3d ------------------------------------------------------------------
  * Compute flux in x1-direction */
 
+      fluxes_pencil(kl,ke+nghost,Ul,Ur,Wl,Wr,Bxi,F1d);
       for (k=kl; k<=ke+nghost; k++) {
-        fluxes(Ul[k],Ur[k],Wl[k],Wr[k],Bxi[k],&x3Flux[k][j][i]);
+        x3Flux[k][j][i] = F1d[k];
       }
     }
   }
@@ -358,10 +411,13 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,Whalf)
+#endif
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        Whalf = Cons_to_Prim(&pG->U[k][j][i]);
+        Whalf = Cons_to_Prim(&Uhalf[k][j][i]);
         emf1_cc[k][j][i] = (Whalf.B2c*Whalf.V3 - Whalf.B3c*Whalf.V2);
         emf2_cc[k][j][i] = (Whalf.B3c*Whalf.V1 - Whalf.B1c*Whalf.V3);
         emf3_cc[k][j][i] = (Whalf.B1c*Whalf.V2 - Whalf.B2c*Whalf.V1);
@@ -376,6 +432,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update the interface magnetic fields using CT for a half time step.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i) firstprivate(q2,rsf,lsf)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -404,6 +463,9 @@ void integrate_3d_vl(DomainS *pD)
                                q3*(emf1[k+1][ju+1][i  ]-emf1[k][ju+1][i]);
     }
   }
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i) firstprivate(q2,rsf,lsf)
+#endif
   for (j=jl; j<=ju; j++) {
     for (i=il; i<=iu; i++) {
 #ifdef CYLINDRICAL
@@ -420,6 +482,9 @@ void integrate_3d_vl(DomainS *pD)
  * face-centered fields.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i) firstprivate(rsf,lsf)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -440,6 +505,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x1-fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n) firstprivate(rsf,lsf)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -466,6 +534,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x2-fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n) firstprivate(q2)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -492,6 +563,9 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables to half-timestep using x3-fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -516,6 +590,9 @@ void integrate_3d_vl(DomainS *pD)
  * With first-order flux correction, save predict fluxes and emf3
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -619,6 +696,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,x1,x2,x3,phic,phir,phil,g) firstprivate(rsf,lsf,q2)
+#endif
     for (k=kl; k<=ku; k++) {
       for (j=jl; j<=ju; j++) {
         for (i=il; i<=iu; i++) {
@@ -635,7 +715,7 @@ void integrate_3d_vl(DomainS *pD)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif /* CYLINDRICAL */
-          Uhalf[k][j][i].M1 -= hdt*pG->U[k][j][i].d*g;
+          Uhalf[k][j][i].M1 -= hdt*GRID_U(pG,k,j,i,d)*g;
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q1*(lsf*x1Flux[k][j][i  ].d*(phic - phil)
                                 + rsf*x1Flux[k][j][i+1].d*(phir - phic));
@@ -643,7 +723,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M2 -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                                 + x2Flux[k][j+1][i].d*(phir - phic));
@@ -651,7 +731,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M3 -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                                 + x3Flux[k+1][j][i].d*(phir - phic));
@@ -667,6 +747,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef SELF_GRAVITY
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,phic,phir,phil)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
@@ -674,7 +757,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i+1]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j][i-1]);
 
-        Uhalf[k][j][i].M1 -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M1 -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                               + x1Flux[k][j][i+1].d*(phir - phic));
@@ -682,7 +765,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j+1][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k][j-1][i]);
 
-        Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M2 -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                               + x2Flux[k][j+1][i].d*(phir - phic));
@@ -690,7 +773,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = 0.5*(pG->Phi[k][j][i] + pG->Phi[k+1][j][i]);
         phil = 0.5*(pG->Phi[k][j][i] + pG->Phi[k-1][j][i]);
 
-        Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d; 
+        Uhalf[k][j][i].M3 -= q3*(phir-phil)*GRID_U(pG,k,j,i,d); 
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                               + x3Flux[k+1][j][i].d*(phir - phic));
@@ -718,7 +801,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
         phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 
-        Uhalf[k][j][i].M1 -= q1*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M1 -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                               + x1Flux[k][j][i+1].d*(phir - phic));
@@ -726,7 +809,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
         phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 
-        Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M2 -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                               + x2Flux[k][j+1][i].d*(phir - phic));
@@ -734,7 +817,7 @@ void integrate_3d_vl(DomainS *pD)
         phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
         phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 
-        Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d;
+        Uhalf[k][j][i].M3 -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
         Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                               + x3Flux[k+1][j][i].d*(phir - phic));
@@ -746,11 +829,11 @@ void integrate_3d_vl(DomainS *pD)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        Uhalf[k][j][i].M1 += pG->dt*Omega_0*pG->U[k][j][i].M2;
+        Uhalf[k][j][i].M1 += pG->dt*Omega_0*GRID_U(pG,k,j,i,M2);
 #ifdef FARGO
-        Uhalf[k][j][i].M2 += hdt*(qshear-2.)*Omega_0*pG->U[k][j][i].M1;
+        Uhalf[k][j][i].M2 += hdt*(qshear-2.)*Omega_0*GRID_U(pG,k,j,i,M1);
 #else
-        Uhalf[k][j][i].M2 -= pG->dt*Omega_0*pG->U[k][j][i].M1;
+        Uhalf[k][j][i].M2 -= pG->dt*Omega_0*GRID_U(pG,k,j,i,M1);
 #endif
       }
     }
@@ -764,8 +847,8 @@ void integrate_3d_vl(DomainS *pD)
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
         /* This *is* a half-timestep update below (see note above) */
-        Uhalf[k][j][i].M1 += pG->dt*Om*pG->U[k][j][i].M2;
-        Uhalf[k][j][i].M2 += hdt*(qshear - 2.0)*Om*pG->U[k][j][i].M1;
+        Uhalf[k][j][i].M1 += pG->dt*Om*GRID_U(pG,k,j,i,M2);
+        Uhalf[k][j][i].M2 += hdt*(qshear - 2.0)*Om*GRID_U(pG,k,j,i,M1);
       }
     }
   }
@@ -781,24 +864,24 @@ void integrate_3d_vl(DomainS *pD)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
 
-        Ekin = 0.5*(SQR(pG->U[k][j][i].M1)+SQR(pG->U[k][j][i].M2)+SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+        Ekin = 0.5*(SQR(GRID_U(pG,k,j,i,M1))+SQR(GRID_U(pG,k,j,i,M2))+SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #ifdef MHD
-        B2sq = SQR(pG->U[k][j][i].B2c);
-        Emag = 0.5*(SQR(pG->U[k][j][i].B1c) + B2sq + SQR(pG->U[k][j][i].B3c));
+        B2sq = SQR(GRID_U(pG,k,j,i,B2c));
+        Emag = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + B2sq + SQR(GRID_U(pG,k,j,i,B3c)));
 #else
         B2sq = 0.0;
         Emag = 0.0;
 #endif
 
 #ifdef ISOTHERMAL
-        Ptot = Iso_csound2*pG->U[k][j][i].d;
+        Ptot = Iso_csound2*GRID_U(pG,k,j,i,d);
 #else
-        Ptot = Gamma_1*(pG->U[k][j][i].E - Ekin - Emag);
+        Ptot = Gamma_1*(GRID_U(pG,k,j,i,E) - Ekin - Emag);
 #endif
         Ptot = MAX(Ptot,TINY_NUMBER);
         Ptot += Emag;
 
-        Uhalf[k][j][i].M1 += hdt*(SQR(pG->U[k][j][i].M2)/pG->U[k][j][i].d - B2sq + Ptot)/r[i];
+        Uhalf[k][j][i].M1 += hdt*(SQR(GRID_U(pG,k,j,i,M2))/GRID_U(pG,k,j,i,d) - B2sq + Ptot)/r[i];
       }
     }
   }
@@ -811,6 +894,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M1, M2, M3, E, B2c, B3c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=il; i<=iu; i++) {
@@ -855,6 +941,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M2, M3, M1, E, B3c, B1c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,j,n) firstprivate(dx2)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (i=is-1; i<=ie+1; i++) {
       for (j=jl; j<=ju; j++) {
@@ -902,6 +991,9 @@ void integrate_3d_vl(DomainS *pD)
  * U1d = (d, M3, M1, M2, E, B1c, B2c, s[n])
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i,k,n)
+#endif
   for (j=js-1; j<=je+1; j++) {
     for (i=is-1; i<=ie+1; i++) {
       for (k=kl; k<=ku; k++) {
@@ -947,6 +1039,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef H_CORRECTION
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,Bx,cfr,cfl,lambdar,lambdal)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=iu; i++) {
@@ -962,6 +1057,9 @@ void integrate_3d_vl(DomainS *pD)
     }
   }
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,Bx,cfr,cfl,lambdar,lambdal)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=ju; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -977,6 +1075,9 @@ void integrate_3d_vl(DomainS *pD)
     }
   }
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,Bx,cfr,cfl,lambdar,lambdal)
+#endif
   for (k=ks-1; k<=ku; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -997,10 +1098,17 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x1-direction
  */
 
+#ifdef OPENMP_PARALLEL
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for private(j,i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for private(j,i,Bx)
+#endif
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
-      for (i=is; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+      for (i=is; i<=ie+1; i++) {
         etah = MAX(eta2[k][j][i-1],eta2[k][j][i]);
         etah = MAX(etah,eta2[k][j+1][i-1]);
         etah = MAX(etah,eta2[k][j+1][i  ]);
@@ -1011,7 +1119,6 @@ void integrate_3d_vl(DomainS *pD)
         etah = MAX(etah,eta3[k+1][j][i  ]);
 
         etah = MAX(etah,eta1[k  ][j][i  ]);
-#endif /* H_CORRECTION */
 #ifdef MHD
         Bx = B1_x1Face[k][j][i];
 #endif
@@ -1020,8 +1127,21 @@ void integrate_3d_vl(DomainS *pD)
 
         fluxes(Ul[i],Ur[i],Wl_x1Face[k][j][i],Wr_x1Face[k][j][i],Bx,
                &x1Flux[k][j][i]);
+      }
+#else
+      for (i=is; i<=ie+1; i++) {
+#ifdef MHD
+        Bxi[i] = B1_x1Face[k][j][i];
+#endif
+        Ul[i] = Prim1D_to_Cons1D(&Wl_x1Face[k][j][i],&Bxi[i]);
+        Ur[i] = Prim1D_to_Cons1D(&Wr_x1Face[k][j][i],&Bxi[i]);
+      }
+      fluxes_pencil(is,ie+1,Ul,Ur,Wl_x1Face[k][j],Wr_x1Face[k][j],Bxi,
+                    x1Flux[k][j]);
+#endif /* H_CORRECTION */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
+      for (i=is; i<=ie+1; i++) {
 /* revert to predictor flux if this flux Nan'ed */
         if ((x1Flux[k][j][i].d  != x1Flux[k][j][i].d)  ||
 #ifndef BAROTROPIC
@@ -1037,9 +1157,8 @@ void integrate_3d_vl(DomainS *pD)
           x1Flux[k][j][i] = x1FluxP[k][j][i];
           NaNFlux++;
         }
-#endif
-
       }
+#endif
     }
   }
 
@@ -1047,10 +1166,17 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x2-direction
  */
 
+#ifdef OPENMP_PARALLEL
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for private(j,i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for private(j,i,Bx)
+#endif
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
-      for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+      for (i=is-1; i<=ie+1; i++) {
         etah = MAX(eta1[k][j-1][i],eta1[k][j][i]);
         etah = MAX(etah,eta1[k][j-1][i+1]);
         etah = MAX(etah,eta1[k][j  ][i+1]);
@@ -1061,7 +1187,6 @@ void integrate_3d_vl(DomainS *pD)
         etah = MAX(etah,eta3[k+1][j  ][i]);
 
         etah = MAX(etah,eta2[k  ][j  ][i]);
-#endif /* H_CORRECTION */
 #ifdef MHD
         Bx = B2_x2Face[k][j][i];
 #endif
@@ -1070,8 +1195,21 @@ void integrate_3d_vl(DomainS *pD)
 
         fluxes(Ul[i],Ur[i],Wl_x2Face[k][j][i],Wr_x2Face[k][j][i],Bx,
                &x2Flux[k][j][i]);
+      }
+#else
+      for (i=is-1; i<=ie+1; i++) {
+#ifdef MHD
+        Bxi[i] = B2_x2Face[k][j][i];
+#endif
+        Ul[i] = Prim1D_to_Cons1D(&Wl_x2Face[k][j][i],&Bxi[i]);
+        Ur[i] = Prim1D_to_Cons1D(&Wr_x2Face[k][j][i],&Bxi[i]);
+      }
+      fluxes_pencil(is-1,ie+1,Ul,Ur,Wl_x2Face[k][j],Wr_x2Face[k][j],Bxi,
+                    x2Flux[k][j]);
+#endif /* H_CORRECTION */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
+      for (i=is-1; i<=ie+1; i++) {
 /* revert to predictor flux if this flux NaN'ed */
         if ((x2Flux[k][j][i].d  != x2Flux[k][j][i].d)  ||
 #ifndef BAROTROPIC
@@ -1087,9 +1225,8 @@ void integrate_3d_vl(DomainS *pD)
           x2Flux[k][j][i] = x2FluxP[k][j][i];
           NaNFlux++;
         }
-#endif
-
       }
+#endif
     }
   }
 
@@ -1097,10 +1234,17 @@ void integrate_3d_vl(DomainS *pD)
  * Compute second-order fluxes in x3-direction
  */
 
+#ifdef OPENMP_PARALLEL
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+#pragma omp parallel for private(j,i,Bx) reduction(+:NaNFlux)
+#else
+#pragma omp parallel for private(j,i,Bx)
+#endif
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
-      for (i=is-1; i<=ie+1; i++) {
 #ifdef H_CORRECTION
+      for (i=is-1; i<=ie+1; i++) {
         etah = MAX(eta1[k-1][j][i],eta1[k][j][i]);
         etah = MAX(etah,eta1[k-1][j][i+1]);
         etah = MAX(etah,eta1[k][j  ][i+1]);
@@ -1111,7 +1255,6 @@ void integrate_3d_vl(DomainS *pD)
         etah = MAX(etah,eta2[k  ][j+1][i]);
 
         etah = MAX(etah,eta3[k  ][j  ][i]);
-#endif /* H_CORRECTION */
 #ifdef MHD
         Bx = B3_x3Face[k][j][i];
 #endif
@@ -1120,8 +1263,21 @@ void integrate_3d_vl(DomainS *pD)
 
         fluxes(Ul[i],Ur[i],Wl_x3Face[k][j][i],Wr_x3Face[k][j][i],Bx,
                &x3Flux[k][j][i]);
+      }
+#else
+      for (i=is-1; i<=ie+1; i++) {
+#ifdef MHD
+        Bxi[i] = B3_x3Face[k][j][i];
+#endif
+        Ul[i] = Prim1D_to_Cons1D(&Wl_x3Face[k][j][i],&Bxi[i]);
+        Ur[i] = Prim1D_to_Cons1D(&Wr_x3Face[k][j][i],&Bxi[i]);
+      }
+      fluxes_pencil(is-1,ie+1,Ul,Ur,Wl_x3Face[k][j],Wr_x3Face[k][j],Bxi,
+                    x3Flux[k][j]);
+#endif /* H_CORRECTION */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
+      for (i=is-1; i<=ie+1; i++) {
 /* revert to predictor flux if this flux NaN'ed */
         if ((x3Flux[k][j][i].d  != x3Flux[k][j][i].d)  ||
 #ifndef BAROTROPIC
@@ -1137,9 +1293,8 @@ void integrate_3d_vl(DomainS *pD)
           x3Flux[k][j][i] = x3FluxP[k][j][i];
           NaNFlux++;
         }
-#endif
-
       }
+#endif
     }
   }
 
@@ -1157,6 +1312,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,Whalf)
+#endif
   for (k=ks-1; k<=ke+1; k++) {
     for (j=js-1; j<=je+1; j++) {
       for (i=is-1; i<=ie+1; i++) {
@@ -1266,6 +1424,9 @@ void integrate_3d_vl(DomainS *pD)
  */
 
 #ifdef MHD
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i) firstprivate(dtodx2,rsf,lsf)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
@@ -1296,6 +1457,9 @@ void integrate_3d_vl(DomainS *pD)
         dtodx3*(emf1[k+1][je+1][i  ] - emf1[k][je+1][i]);
     }
   }
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(i) firstprivate(dtodx2,rsf,lsf)
+#endif
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
@@ -1312,15 +1476,18 @@ void integrate_3d_vl(DomainS *pD)
  * Set cell centered magnetic fields to average of updated face centered fields.
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i) firstprivate(rsf,lsf)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
-        pG->U[k][j][i].B2c = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
-        pG->U[k][j][i].B3c = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
+        GRID_U(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+        GRID_U(pG,k,j,i,B2c) = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
+        GRID_U(pG,k,j,i,B3c) = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
       }
     }
   }
@@ -1345,11 +1512,11 @@ void integrate_3d_vl(DomainS *pD)
 	cc_pos(pG,i,j,k,&x1,&x2,&x3);
 
 /* Store the current state */
-	M1n  = pG->U[k][j][i].M1;
+	M1n  = GRID_U(pG,k,j,i,M1);
 #ifdef FARGO
-	dM2n = pG->U[k][j][i].M2;
+	dM2n = GRID_U(pG,k,j,i,M2);
 #else
-	dM2n = pG->U[k][j][i].M2 + qom*x1*pG->U[k][j][i].d;
+	dM2n = GRID_U(pG,k,j,i,M2) + qom*x1*GRID_U(pG,k,j,i,d);
 #endif
 
 /* Calculate the flux for the y-momentum fluctuation */
@@ -1381,11 +1548,11 @@ void integrate_3d_vl(DomainS *pD)
  * potential momentum source terms using a Crank-Nicholson
  * discretization for the momentum fluctuation equation. */
 
-	pG->U[k][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-	pG->U[k][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+	GRID_U(pG,k,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+	GRID_U(pG,k,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 
 #ifndef FARGO
-	pG->U[k][j][i].M2 -= 0.5*qshear*om_dt*
+	GRID_U(pG,k,j,i,M2) -= 0.5*qshear*om_dt*
            (x1Flux[k][j][i].d + x1Flux[k][j][i+1].d);
 #endif
 
@@ -1396,21 +1563,21 @@ void integrate_3d_vl(DomainS *pD)
 	phir = (*ShearingBoxPot)((x1+0.5*pG->dx1),x2,x3);
 	phil = (*ShearingBoxPot)((x1-0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-	pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+	GRID_U(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif
 
 	phir = (*ShearingBoxPot)(x1,(x2+0.5*pG->dx2),x3);
 	phil = (*ShearingBoxPot)(x1,(x2-0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-	pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+	GRID_U(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif
 
 	phir = (*ShearingBoxPot)(x1,x2,(x3+0.5*pG->dx3));
 	phil = (*ShearingBoxPot)(x1,x2,(x3-0.5*pG->dx3));
 #ifndef BAROTROPIC
-	pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+	GRID_U(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif
       }
@@ -1420,6 +1587,9 @@ void integrate_3d_vl(DomainS *pD)
 
 
   if (StaticGravPot != NULL){
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,x1,x2,x3,phic,phir,phil,g) firstprivate(rsf,lsf,dtodx2)
+#endif
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
@@ -1436,25 +1606,25 @@ void integrate_3d_vl(DomainS *pD)
           g -= r[i]*SQR((*OrbitalProfile)(r[i]));
 #endif
 #endif
-          pG->U[k][j][i].M1 -= pG->dt*Uhalf[k][j][i].d*g;
+          GRID_U(pG,k,j,i,M1) -= pG->dt*Uhalf[k][j][i].d*g;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil)
+          GRID_U(pG,k,j,i,E) -= dtodx1*(lsf*x1Flux[k][j][i  ].d*(phic - phil)
                                     + rsf*x1Flux[k][j][i+1].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          pG->U[k][j][i].M2 -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
+          GRID_U(pG,k,j,i,M2) -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
+          GRID_U(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
                                     + x2Flux[k][j+1][i].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          pG->U[k][j][i].M3 -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
+          GRID_U(pG,k,j,i,M3) -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
+          GRID_U(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
                                     + x3Flux[k+1][j][i].d*(phir - phic));
 #endif
         }
@@ -1471,6 +1641,9 @@ void integrate_3d_vl(DomainS *pD)
 #ifdef SELF_GRAVITY
 /* Add fluxes and source terms due to (d/dx1) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,phic,phil,phir,gxl,gxr,gyl,gyr,gzl,gzr,flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -1503,11 +1676,11 @@ void integrate_3d_vl(DomainS *pD)
         flx_m3r = gxr*gzr/four_pi_G;
 
 /* Update momenta and energy with d/dx1 terms  */
-        pG->U[k][j][i].M1 -= dtodx1*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx1*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx1*(flx_m3r - flx_m3l);
+        GRID_U(pG,k,j,i,M1) -= dtodx1*(flx_m1r - flx_m1l);
+        GRID_U(pG,k,j,i,M2) -= dtodx1*(flx_m2r - flx_m2l);
+        GRID_U(pG,k,j,i,M3) -= dtodx1*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil) +
                                     x1Flux[k][j][i+1].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -1516,6 +1689,9 @@ void integrate_3d_vl(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx2) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,phic,phil,phir,gxl,gxr,gyl,gyr,gzl,gzr,flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -1548,11 +1724,11 @@ void integrate_3d_vl(DomainS *pD)
         flx_m3r = gyr*gzr/four_pi_G;
 
 /* Update momenta and energy with d/dx2 terms  */
-        pG->U[k][j][i].M1 -= dtodx2*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx2*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx2*(flx_m3r - flx_m3l);
+        GRID_U(pG,k,j,i,M1) -= dtodx2*(flx_m1r - flx_m1l);
+        GRID_U(pG,k,j,i,M2) -= dtodx2*(flx_m2r - flx_m2l);
+        GRID_U(pG,k,j,i,M3) -= dtodx2*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil) +
                                     x2Flux[k][j+1][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -1561,6 +1737,9 @@ void integrate_3d_vl(DomainS *pD)
 
 /* Add fluxes and source terms due to (d/dx3) terms  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,phic,phil,phir,gxl,gxr,gyl,gyr,gzl,gzr,flx_m1l,flx_m1r,flx_m2l,flx_m2r,flx_m3l,flx_m3r)
+#endif
   for (k=ks; k<=ke; k++){
     for (j=js; j<=je; j++){
       for (i=is; i<=ie; i++){
@@ -1593,11 +1772,11 @@ void integrate_3d_vl(DomainS *pD)
         flx_m3r = 0.5*(gzr*gzr-gxr*gxr-gyr*gyr)/four_pi_G + grav_mean_rho*phir;
 
 /* Update momenta and energy with d/dx3 terms  */
-        pG->U[k][j][i].M1 -= dtodx3*(flx_m1r - flx_m1l);
-        pG->U[k][j][i].M2 -= dtodx3*(flx_m2r - flx_m2l);
-        pG->U[k][j][i].M3 -= dtodx3*(flx_m3r - flx_m3l);
+        GRID_U(pG,k,j,i,M1) -= dtodx3*(flx_m1r - flx_m1l);
+        GRID_U(pG,k,j,i,M2) -= dtodx3*(flx_m2r - flx_m2l);
+        GRID_U(pG,k,j,i,M3) -= dtodx3*(flx_m3r - flx_m3l);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
+        GRID_U(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil) +
                                     x3Flux[k+1][j][i].d*(phir - phic));
 #endif /* BAROTROPIC */
       }
@@ -1606,6 +1785,9 @@ void integrate_3d_vl(DomainS *pD)
 
 /* Save mass fluxes in Grid structure for source term correction in main loop */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i)
+#endif
   for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie+1; i++) {
@@ -1644,14 +1826,14 @@ void integrate_3d_vl(DomainS *pD)
         Ptot = MAX(Ptot,TINY_NUMBER);
         Ptot += Emag;
 
-        pG->U[k][j][i].M1 += pG->dt*(SQR(Uhalf[k][j][i].M2)/Uhalf[k][j][i].d - B2sq + Ptot)/r[i];
+        GRID_U(pG,k,j,i,M1) += pG->dt*(SQR(Uhalf[k][j][i].M2)/Uhalf[k][j][i].d - B2sq + Ptot)/r[i];
 
 #ifdef FARGO
         /* Use average values to apply source terms for full time-step */
         Om = (*OrbitalProfile)(r[i]);
         qshear = (*ShearProfile)(r[i]);
-        pG->U[k][j][i].M1 += pG->dt*(2.0*Om*Uhalf[k][j][i].M2);
-        pG->U[k][j][i].M2 += pG->dt*(Om*(qshear-2.0)*Uhalf[k][j][i].M1);
+        GRID_U(pG,k,j,i,M1) += pG->dt*(2.0*Om*Uhalf[k][j][i].M2);
+        GRID_U(pG,k,j,i,M2) += pG->dt*(Om*(qshear-2.0)*Uhalf[k][j][i].M1);
 #endif /* FARGO */
       }
     }
@@ -1664,22 +1846,25 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x1-Fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n) firstprivate(rsf,lsf)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         rsf = ri[i+1]/r[i];  lsf = ri[i]/r[i];
 #endif
-        pG->U[k][j][i].d  -= dtodx1*(rsf*x1Flux[k][j][i+1].d  - lsf*x1Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx - lsf*x1Flux[k][j][i].Mx);
-        pG->U[k][j][i].M2 -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My - SQR(lsf)*x1Flux[k][j][i].My);
-        pG->U[k][j][i].M3 -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz - lsf*x1Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,d)  -= dtodx1*(rsf*x1Flux[k][j][i+1].d  - lsf*x1Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mx - lsf*x1Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,M2) -= dtodx1*(SQR(rsf)*x1Flux[k][j][i+1].My - SQR(lsf)*x1Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,M3) -= dtodx1*(rsf*x1Flux[k][j][i+1].Mz - lsf*x1Flux[k][j][i].Mz);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx1*(rsf*x1Flux[k][j][i+1].E  - lsf*x1Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E)  -= dtodx1*(rsf*x1Flux[k][j][i+1].E  - lsf*x1Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx1*(rsf*x1Flux[k][j][i+1].s[n]
                                        - lsf*x1Flux[k][j][i  ].s[n]);
 #endif
       }
@@ -1690,22 +1875,25 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x2-Fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n) firstprivate(dtodx2)
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 #ifdef CYLINDRICAL
         dtodx2 = pG->dt/(r[i]*pG->dx2);
 #endif
-        pG->U[k][j][i].d  -= dtodx2*(x2Flux[k][j+1][i].d  - x2Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx2*(x2Flux[k][j+1][i].Mz - x2Flux[k][j][i].Mz);
-        pG->U[k][j][i].M2 -= dtodx2*(x2Flux[k][j+1][i].Mx - x2Flux[k][j][i].Mx);
-        pG->U[k][j][i].M3 -= dtodx2*(x2Flux[k][j+1][i].My - x2Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,d)  -= dtodx2*(x2Flux[k][j+1][i].d  - x2Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1) -= dtodx2*(x2Flux[k][j+1][i].Mz - x2Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,M2) -= dtodx2*(x2Flux[k][j+1][i].Mx - x2Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,M3) -= dtodx2*(x2Flux[k][j+1][i].My - x2Flux[k][j][i].My);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx2*(x2Flux[k][j+1][i].E  - x2Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E)  -= dtodx2*(x2Flux[k][j+1][i].E  - x2Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx2*(x2Flux[k][j+1][i].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx2*(x2Flux[k][j+1][i].s[n]
                                        - x2Flux[k][j  ][i].s[n]);
 #endif
       }
@@ -1716,24 +1904,36 @@ void integrate_3d_vl(DomainS *pD)
  * Update cell-centered variables in pG using 3D x3-Fluxes
  */
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,n) CFL_REDUCTION
+#endif
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d  -= dtodx3*(x3Flux[k+1][j][i].d  - x3Flux[k][j][i].d );
-        pG->U[k][j][i].M1 -= dtodx3*(x3Flux[k+1][j][i].My - x3Flux[k][j][i].My);
-        pG->U[k][j][i].M2 -= dtodx3*(x3Flux[k+1][j][i].Mz - x3Flux[k][j][i].Mz);
-        pG->U[k][j][i].M3 -= dtodx3*(x3Flux[k+1][j][i].Mx - x3Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,d)  -= dtodx3*(x3Flux[k+1][j][i].d  - x3Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1) -= dtodx3*(x3Flux[k+1][j][i].My - x3Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,M2) -= dtodx3*(x3Flux[k+1][j][i].Mz - x3Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,M3) -= dtodx3*(x3Flux[k+1][j][i].Mx - x3Flux[k][j][i].Mx);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E  -= dtodx3*(x3Flux[k+1][j][i].E  - x3Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E)  -= dtodx3*(x3Flux[k+1][j][i].E  - x3Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx3*(x3Flux[k+1][j][i].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx3*(x3Flux[k+1][j][i].s[n]
                                        - x3Flux[k  ][j][i].s[n]);
 #endif
       }
+#ifdef FUSED_CFL
+      new_dt_speeds(pG,j,k,&cfl_v1,&cfl_v2,&cfl_v3);
+#endif
     }
   }
+#ifdef FUSED_CFL
+  pG->max_v1 = cfl_v1;
+  pG->max_v2 = cfl_v2;
+  pG->max_v3 = cfl_v3;
+  pG->cfl_set = 1;
+#endif /* FUSED_CFL */
 
 #ifdef FIRST_ORDER_FLUX_CORRECTION
 /*=== STEP 14: First-order flux correction ===================================*/
@@ -1744,7 +1944,8 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        W = Cons_to_Prim(&(pG->U[k][j][i]));
+        Ufofc = GET_GRID_U(pG,k,j,i);
+        W = Cons_to_Prim(&Ufofc);
         if (W.d < 0.0) {
           flag_cell = 1;
           BadCell.i = i;
@@ -2078,12 +2279,90 @@ void integrate_3d_vl(DomainS *pD)
 }
 
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void integrate_3d_vl_tiled(DomainS *pD)
+ *  \brief Cache-blocked version of integrate_3d_vl().
+ *
+ *   The Grid is divided into bricks of at most tile_nx1*tile_nx2*tile_nx3
+ *   cells.  Each brick plus nghost ghost zones is copied into Tile and advanced
+ *   with integrate_3d_vl(), so the working set stays cache-sized.  Since the
+ *   ghost zones of a brick overlap its neighbours, updated bricks cannot be
+ *   written back immediately: bricks are done one x3-plane at a time, and an
+ *   updated plane is copied back into the Grid only after the next plane has
+ *   been advanced.  This requires each plane to be at least nghost cells
+ *   thick, which integrate_init_3d() ensures.  The ghost zones are recomputed
+ *   in every brick, but the update of each cell is identical to that of the
+ *   untiled integrator.  The exception is the H-correction, which uses
+ *   wavespeeds from states just outside the reconstructed range; as at MPI
+ *   Grid boundaries, results then differ at round-off level at brick faces.
+ */
+void integrate_3d_vl_tiled(DomainS *pD)
+{
+  GridS *pG=(pD->Grid);
+  int ib,jb,kb,nb1,nb2,nb3;
+  int ibs,ibe,jbs,jbe,kbs,kbe,kps=0,kpe=0;
+#ifdef FUSED_CFL
+  Real cfl_v1=0.0,cfl_v2=0.0,cfl_v3=0.0;
+#endif
+
+  nb1 = (pG->Nx[0] + tile_nx1 - 1)/tile_nx1;
+  nb2 = (pG->Nx[1] + tile_nx2 - 1)/tile_nx2;
+  nb3 = (pG->Nx[2] + tile_nx3 - 1)/tile_nx3;
+
+  TileDomain = *pD;
+  TileDomain.Grid = &Tile;
+  Tile.dx1 = pG->dx1;
+  Tile.dx2 = pG->dx2;
+  Tile.dx3 = pG->dx3;
+  Tile.time = pG->time;
+  Tile.dt = pG->dt;
+
+/* Bricks in each direction differ in size by at most one cell */
+
+  for (kb=0; kb<nb3; kb++) {
+    kbs = pG->ks + (kb*pG->Nx[2])/nb3;
+    kbe = pG->ks + ((kb+1)*pG->Nx[2])/nb3 - 1;
+    for (jb=0; jb<nb2; jb++) {
+      jbs = pG->js + (jb*pG->Nx[1])/nb2;
+      jbe = pG->js + ((jb+1)*pG->Nx[1])/nb2 - 1;
+      for (ib=0; ib<nb1; ib++) {
+        ibs = pG->is + (ib*pG->Nx[0])/nb1;
+        ibe = pG->is + ((ib+1)*pG->Nx[0])/nb1 - 1;
+
+        load_tile(pG,ibs,ibe,jbs,jbe,kbs,kbe);
+        integrate_3d_vl(&TileDomain);
+        store_tile(pG,(kb%2),ibs,ibe,jbs,jbe,kbs,kbe,kbs);
+#ifdef FUSED_CFL
+        cfl_v1 = MAX(cfl_v1,Tile.max_v1);
+        cfl_v2 = MAX(cfl_v2,Tile.max_v2);
+        cfl_v3 = MAX(cfl_v3,Tile.max_v3);
+#endif
+      }
+    }
+
+/* The previous plane is no longer needed as ghost zones of any brick */
+
+    if (kb > 0) flush_tile_plane(pG,((kb-1)%2),kps,kpe);
+    kps = kbs;
+    kpe = kbe;
+  }
+  flush_tile_plane(pG,((nb3-1)%2),kps,kpe);
+#ifdef FUSED_CFL
+  pG->max_v1 = cfl_v1;
+  pG->max_v2 = cfl_v2;
+  pG->max_v3 = cfl_v3;
+  pG->cfl_set = 1;
+#endif /* FUSED_CFL */
+
+  return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void integrate_init_3d(MeshS *pM)
  *  \brief Allocate temporary integration arrays */
 void integrate_init_3d(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,n,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -2102,6 +2381,55 @@ void integrate_init_3d(MeshS *pM)
     }
   }
 
+/* With tiling, the Grid is advanced in bricks of at most tile_nx1*tile_nx2*
+ * tile_nx3 cells, and the scratch arrays below need only cover one brick */
+  tile_nx1 = par_geti_def("job","tile_nx1",0);
+  tile_nx2 = par_geti_def("job","tile_nx2",0);
+  tile_nx3 = par_geti_def("job","tile_nx3",0);
+  if (tile_nx1 > 0 || tile_nx2 > 0 || tile_nx3 > 0) {
+#if defined(SHEARING_BOX) || defined(SELF_GRAVITY)
+    ath_error("[integrate_init_3d]: tiling not implemented with shearing box or self-gravity\n");
+#endif
+#if defined(STATIC_MESH_REFINEMENT) || defined(FIRST_ORDER_FLUX_CORRECTION)
+    ath_error("[integrate_init_3d]: tiling not implemented with SMR or first-order flux correction\n");
+#endif
+    if (tile_nx1 <= 0 || tile_nx1 > size1) tile_nx1 = size1;
+    if (tile_nx2 <= 0 || tile_nx2 > size2) tile_nx2 = size2;
+    if (tile_nx3 <= 0 || tile_nx3 > size3) tile_nx3 = size3;
+    if ((tile_nx1 < size1 && tile_nx1 < 2*nghost) ||
+        (tile_nx2 < size2 && tile_nx2 < 2*nghost) ||
+        (tile_nx3 < size3 && tile_nx3 < 2*nghost))
+      ath_error("[integrate_init_3d]: tile_nx1,2,3=%d,%d,%d must be >= %d\n",
+                tile_nx1,tile_nx2,tile_nx3,2*nghost);
+
+    if (calloc_grid_U(&Tile,tile_nx3+2*nghost,tile_nx2+2*nghost,
+      tile_nx1+2*nghost) != 0) goto on_error;
+#ifdef MHD
+    if ((Tile.B1i = (Real***)calloc_3d_array(tile_nx3+2*nghost,tile_nx2+2*nghost,
+      tile_nx1+2*nghost,sizeof(Real))) == NULL) goto on_error;
+    if ((Tile.B2i = (Real***)calloc_3d_array(tile_nx3+2*nghost,tile_nx2+2*nghost,
+      tile_nx1+2*nghost,sizeof(Real))) == NULL) goto on_error;
+    if ((Tile.B3i = (Real***)calloc_3d_array(tile_nx3+2*nghost,tile_nx2+2*nghost,
+      tile_nx1+2*nghost,sizeof(Real))) == NULL) goto on_error;
+#endif /* MHD */
+    for (n=0; n<2; n++) {
+      if ((Ubuf[n] = (ConsS***)calloc_3d_array(tile_nx3,size2,size1,
+        sizeof(ConsS))) == NULL) goto on_error;
+#ifdef MHD
+      if ((B1buf[n] = (Real***)calloc_3d_array(tile_nx3,size2,size1+1,
+        sizeof(Real))) == NULL) goto on_error;
+      if ((B2buf[n] = (Real***)calloc_3d_array(tile_nx3,size2+1,size1,
+        sizeof(Real))) == NULL) goto on_error;
+      if ((B3buf[n] = (Real***)calloc_3d_array(tile_nx3+1,size2,size1,
+        sizeof(Real))) == NULL) goto on_error;
+#endif /* MHD */
+    }
+
+    size1 = tile_nx1;
+    size2 = tile_nx2;
+    size3 = tile_nx3;
+  }
+
   size1 = size1 + 2*nghost;
   size2 = size2 + 2*nghost;
   size3 = size3 + 2*nghost;
@@ -2143,9 +2471,6 @@ void integrate_init_3d(MeshS *pM)
   if ((Wr_x3Face=(Prim1DS***)calloc_3d_array(size3,size2,size1,sizeof(Prim1DS)))
     == NULL) goto on_error;
 
-  if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-  if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) goto on_error;
-
 #ifdef MHD
   if ((B1_x1Face = (Real***)calloc_3d_array(size3,size2,size1,sizeof(Real)))
     == NULL) goto on_error;
@@ -2155,12 +2480,22 @@ void integrate_init_3d(MeshS *pM)
     == NULL) goto on_error;
 #endif /* MHD */
 
-  if ((U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) goto on_error;
-  if ((W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
-  if ((Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) goto on_error;
+/* 1D scratch vectors are private to each OpenMP thread */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel reduction(+:nerr)
+#endif
+  {
+    if ((Bxc = (Real*)malloc(nmax*sizeof(Real))) == NULL) nerr++;
+    if ((Bxi = (Real*)malloc(nmax*sizeof(Real))) == NULL) nerr++;
+    if ((U1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((Ul  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((Ur  = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((F1d = (Cons1DS*)malloc(nmax*sizeof(Cons1DS))) == NULL) nerr++;
+    if ((W1d = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+    if ((Wl  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+    if ((Wr  = (Prim1DS*)malloc(nmax*sizeof(Prim1DS))) == NULL) nerr++;
+  }
+  if (nerr > 0) goto on_error;
 
   if ((x1Flux = (Cons1DS***)calloc_3d_array(size3,size2,size1, sizeof(Cons1DS)))
     == NULL) goto on_error;
@@ -2212,6 +2547,8 @@ void integrate_init_3d(MeshS *pM)
  *  \brief Free temporary integration arrays */
 void integrate_destruct_3d(void)
 {
+  int n;
+
 #ifdef MHD
   if (emf1 != NULL) free_3d_array(emf1);
   if (emf2 != NULL) free_3d_array(emf2);
@@ -2232,20 +2569,26 @@ void integrate_destruct_3d(void)
   if (Wl_x3Face != NULL) free_3d_array(Wl_x3Face);
   if (Wr_x3Face != NULL) free_3d_array(Wr_x3Face);
 
-  if (Bxc != NULL) free(Bxc);
-  if (Bxi != NULL) free(Bxi);
 #ifdef MHD
   if (B1_x1Face != NULL) free_3d_array(B1_x1Face);
   if (B2_x2Face != NULL) free_3d_array(B2_x2Face);
   if (B3_x3Face != NULL) free_3d_array(B3_x3Face);
 #endif /* MHD */
 
-  if (U1d != NULL) free(U1d);
-  if (Ul  != NULL) free(Ul);
-  if (Ur  != NULL) free(Ur);
-  if (W1d != NULL) free(W1d);
-  if (Wl  != NULL) free(Wl);
-  if (Wr  != NULL) free(Wr);
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
+  {
+    if (Bxc != NULL) free(Bxc);
+    if (Bxi != NULL) free(Bxi);
+    if (U1d != NULL) free(U1d);
+    if (Ul  != NULL) free(Ul);
+    if (Ur  != NULL) free(Ur);
+    if (F1d != NULL) free(F1d);
+    if (W1d != NULL) free(W1d);
+    if (Wl  != NULL) free(Wl);
+    if (Wr  != NULL) free(Wr);
+  }
 
   if (x1Flux  != NULL) free_3d_array(x1Flux);
   if (x2Flux  != NULL) free_3d_array(x2Flux);
@@ -2270,6 +2613,20 @@ void integrate_destruct_3d(void)
   if (rFlxoib != NULL) free_2d_array(rFlxoib);
 #endif
 
+  free_grid_U(&Tile);
+#ifdef MHD
+  if (Tile.B1i != NULL) free_3d_array(Tile.B1i);
+  if (Tile.B2i != NULL) free_3d_array(Tile.B2i);
+  if (Tile.B3i != NULL) free_3d_array(Tile.B3i);
+#endif /* MHD */
+  for (n=0; n<2; n++) {
+    if (Ubuf[n] != NULL) free_3d_array(Ubuf[n]);
+#ifdef MHD
+    if (B1buf[n] != NULL) free_3d_array(B1buf[n]);
+    if (B2buf[n] != NULL) free_3d_array(B2buf[n]);
+    if (B3buf[n] != NULL) free_3d_array(B3buf[n]);
+#endif /* MHD */
+  }
 
   return;
 }
@@ -2300,6 +2657,9 @@ static void integrate_emf1_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,de1_l2,de1_r2,de1_l3,de1_r3)
+#endif
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu; i++) {
@@ -2373,6 +2733,9 @@ static void integrate_emf2_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,de2_l1,de2_r1,de2_l3,de2_r3)
+#endif
   for (k=kl; k<=ku+1; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu+1; i++) {
@@ -2447,6 +2810,9 @@ static void integrate_emf3_corner(const GridS *pG)
   jl = pG->js-(nghost-1);   ju = pG->je+(nghost-1);
   kl = pG->ks-(nghost-1);   ku = pG->ke+(nghost-1);
 
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i,de3_l1,de3_r1,de3_l2,de3_r2) firstprivate(rsf,lsf)
+#endif
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju+1; j++) {
       for (i=il; i<=iu+1; i++) {
@@ -2689,9 +3055,9 @@ static void FixCell(GridS *pG, Int3Vect ix)
 #ifdef CYLINDRICAL
     rsf = pG->ri[i+1]/pG->r[i];  lsf = pG->ri[i]/pG->r[i];
 #endif
-    pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
-    pG->U[k][j][i].B2c = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
-    pG->U[k][j][i].B3c = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
+    GRID_U(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+    GRID_U(pG,k,j,i,B2c) = 0.5*(    pG->B2i[k][j][i] +     pG->B2i[k][j+1][i]);
+    GRID_U(pG,k,j,i,B3c) = 0.5*(    pG->B3i[k][j][i] +     pG->B3i[k+1][j][i]);
   }}}
 #endif /* MHD */
 
@@ -2749,40 +3115,40 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   lsf = (lx1>0) ? pG->ri[i  ]/pG->r[i] : pG->ri[i+1]/pG->r[i];
   dtodx2 = pG->dt/(pG->r[i]*pG->dx2);
 #endif
-  pG->U[k][j][i].d  += dtodx1*(rsf*rx1*x1FD_ip1.d  - lsf*lx1*x1FD_i.d );
-  pG->U[k][j][i].M1 += dtodx1*(rsf*rx1*x1FD_ip1.Mx - lsf*lx1*x1FD_i.Mx);
-  pG->U[k][j][i].M2 += dtodx1*(SQR(rsf)*rx1*x1FD_ip1.My - SQR(lsf)*lx1*x1FD_i.My);
-  pG->U[k][j][i].M3 += dtodx1*(rsf*rx1*x1FD_ip1.Mz - lsf*lx1*x1FD_i.Mz);
+  GRID_U(pG,k,j,i,d)  += dtodx1*(rsf*rx1*x1FD_ip1.d  - lsf*lx1*x1FD_i.d );
+  GRID_U(pG,k,j,i,M1) += dtodx1*(rsf*rx1*x1FD_ip1.Mx - lsf*lx1*x1FD_i.Mx);
+  GRID_U(pG,k,j,i,M2) += dtodx1*(SQR(rsf)*rx1*x1FD_ip1.My - SQR(lsf)*lx1*x1FD_i.My);
+  GRID_U(pG,k,j,i,M3) += dtodx1*(rsf*rx1*x1FD_ip1.Mz - lsf*lx1*x1FD_i.Mz);
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E  += dtodx1*(rsf*rx1*x1FD_ip1.E  - lsf*lx1*x1FD_i.E );
+  GRID_U(pG,k,j,i,E)  += dtodx1*(rsf*rx1*x1FD_ip1.E  - lsf*lx1*x1FD_i.E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[k][j][i].s[n] += dtodx1*(rsf*rx1*x1FD_ip1.s[n] - lsf*lx1*x1FD_i.s[n]);
+    GRID_U(pG,k,j,i,s[n]) += dtodx1*(rsf*rx1*x1FD_ip1.s[n] - lsf*lx1*x1FD_i.s[n]);
 #endif
 
-  pG->U[k][j][i].d  += dtodx2*(rx2*x2FD_jp1.d  - lx2*x2FD_j.d );
-  pG->U[k][j][i].M1 += dtodx2*(rx2*x2FD_jp1.Mz - lx2*x2FD_j.Mz);
-  pG->U[k][j][i].M2 += dtodx2*(rx2*x2FD_jp1.Mx - lx2*x2FD_j.Mx);
-  pG->U[k][j][i].M3 += dtodx2*(rx2*x2FD_jp1.My - lx2*x2FD_j.My);
+  GRID_U(pG,k,j,i,d)  += dtodx2*(rx2*x2FD_jp1.d  - lx2*x2FD_j.d );
+  GRID_U(pG,k,j,i,M1) += dtodx2*(rx2*x2FD_jp1.Mz - lx2*x2FD_j.Mz);
+  GRID_U(pG,k,j,i,M2) += dtodx2*(rx2*x2FD_jp1.Mx - lx2*x2FD_j.Mx);
+  GRID_U(pG,k,j,i,M3) += dtodx2*(rx2*x2FD_jp1.My - lx2*x2FD_j.My);
 #ifndef BAROTROPIC                                   
-  pG->U[k][j][i].E  += dtodx2*(rx2*x2FD_jp1.E  - lx2*x2FD_j.E );
+  GRID_U(pG,k,j,i,E)  += dtodx2*(rx2*x2FD_jp1.E  - lx2*x2FD_j.E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[k][j][i].s[n] += dtodx2*(rx2*x2FD_jp1.s[n] - lx2*x2FD_j.s[n]);
+    GRID_U(pG,k,j,i,s[n]) += dtodx2*(rx2*x2FD_jp1.s[n] - lx2*x2FD_j.s[n]);
 #endif
 
-  pG->U[k][j][i].d  += dtodx3*(rx3*x3FD_kp1.d  - lx3*x3FD_k.d );
-  pG->U[k][j][i].M1 += dtodx3*(rx3*x3FD_kp1.My - lx3*x3FD_k.My);
-  pG->U[k][j][i].M2 += dtodx3*(rx3*x3FD_kp1.Mz - lx3*x3FD_k.Mz);
-  pG->U[k][j][i].M3 += dtodx3*(rx3*x3FD_kp1.Mx - lx3*x3FD_k.Mx);
+  GRID_U(pG,k,j,i,d)  += dtodx3*(rx3*x3FD_kp1.d  - lx3*x3FD_k.d );
+  GRID_U(pG,k,j,i,M1) += dtodx3*(rx3*x3FD_kp1.My - lx3*x3FD_k.My);
+  GRID_U(pG,k,j,i,M2) += dtodx3*(rx3*x3FD_kp1.Mz - lx3*x3FD_k.Mz);
+  GRID_U(pG,k,j,i,M3) += dtodx3*(rx3*x3FD_kp1.Mx - lx3*x3FD_k.Mx);
 #ifndef BAROTROPIC                                   
-  pG->U[k][j][i].E  += dtodx3*(rx3*x3FD_kp1.E  - lx3*x3FD_k.E );
+  GRID_U(pG,k,j,i,E)  += dtodx3*(rx3*x3FD_kp1.E  - lx3*x3FD_k.E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
   for (n=0; n<NSCALARS; n++)
-    pG->U[k][j][i].s[n] += dtodx3*(rx3*x3FD_kp1.s[n] - lx3*x3FD_k.s[n]);
+    GRID_U(pG,k,j,i,s[n]) += dtodx3*(rx3*x3FD_kp1.s[n] - lx3*x3FD_k.s[n]);
 #endif
 
 #ifdef SHEARING_BOX
@@ -2820,11 +3186,11 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
  * potential momentum source terms using a Crank-Nicholson
  * discretization for the momentum fluctuation equation. */
 
-  pG->U[k][j][i].M1 += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
-  pG->U[k][j][i].M2 += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
+  GRID_U(pG,k,j,i,M1) += (4.0*dM2e + 2.0*(qshear-2.)*om_dt*M1e)*fact;
+  GRID_U(pG,k,j,i,M2) += 2.0*(qshear-2.)*(M1e + om_dt*dM2e)*fact;
 
 #ifndef FARGO
-  pG->U[k][j][i].M2 += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d + ABS(rx1)*x1FD_ip1.d);
+  GRID_U(pG,k,j,i,M2) += 0.5*qshear*om_dt*(ABS(lx1)*x1FD_i.d + ABS(rx1)*x1FD_ip1.d);
 #endif
 
 /* Update the energy for a fixed potential.
@@ -2834,21 +3200,21 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = (*ShearingBoxPot)((x1+rx1*0.5*pG->dx1),x2,x3);
   phil = (*ShearingBoxPot)((x1-lx1*0.5*pG->dx1),x2,x3);
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
+  GRID_U(pG,k,j,i,E) += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
                               rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
   phir = (*ShearingBoxPot)(x1,(x2+rx2*0.5*pG->dx2),x3);
   phil = (*ShearingBoxPot)(x1,(x2-lx2*0.5*pG->dx2),x3);
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+  GRID_U(pG,k,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                               rx2*x2FD_jp1.d*(phir - phic));
 #endif
 
   phir = (*ShearingBoxPot)(x1,x2,(x3+rx3*0.5*pG->dx3));
   phil = (*ShearingBoxPot)(x1,x2,(x3-lx3*0.5*pG->dx3));
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
+  GRID_U(pG,k,j,i,E) += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
                               rx3*x3FD_kp1.d*(phir - phic));
 #endif
 #endif /* SHEARING_BOX */
@@ -2860,7 +3226,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
     phil = (*StaticGravPot)((x1-lx1*0.5*pG->dx1),x2,x3);
 
 #ifndef BAROTROPIC
-    pG->U[k][j][i].E += dtodx1*(lsf*lx1*x1FD_i.d*(phic - phil) +
+    GRID_U(pG,k,j,i,E) += dtodx1*(lsf*lx1*x1FD_i.d*(phic - phil) +
                                 rsf*rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
@@ -2868,7 +3234,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
     phil = (*StaticGravPot)(x1,(x2-lx2*0.5*pG->dx2),x3);
 
 #ifndef BAROTROPIC
-    pG->U[k][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+    GRID_U(pG,k,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                                 rx2*x2FD_jp1.d*(phir - phic));
 #endif
 
@@ -2876,7 +3242,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
     phil = (*StaticGravPot)(x1,x2,(x3-lx3*0.5*pG->dx3));
 
 #ifndef BAROTROPIC
-    pG->U[k][j][i].E += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
+    GRID_U(pG,k,j,i,E) += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
                                 rx3*x3FD_kp1.d*(phir - phic));
 #endif
   }
@@ -2887,7 +3253,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = 0.5*(pG->Phi[k][j][i  ] + pG->Phi[k][j][i+rx1]);
 
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
+  GRID_U(pG,k,j,i,E) += dtodx1*(lx1*x1FD_i.d*(phic - phil) +
                               rx1*x1FD_ip1.d*(phir - phic));
 #endif
 
@@ -2895,7 +3261,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = 0.5*(pG->Phi[k][j  ][i] + pG->Phi[k][j+rx2][i]);
 
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
+  GRID_U(pG,k,j,i,E) += dtodx2*(lx2*x2FD_j.d*(phic - phil) +
                               rx2*x2FD_jp1.d*(phir - phic));
 #endif
 
@@ -2903,7 +3269,7 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
   phir = 0.5*(pG->Phi[k  ][j][i] + pG->Phi[k+rx3][j][i]);
 
 #ifndef BAROTROPIC
-  pG->U[k][j][i].E += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
+  GRID_U(pG,k,j,i,E) += dtodx3*(lx3*x3FD_k.d*(phic - phil) +
                               rx3*x3FD_kp1.d*(phir - phic));
 #endif
 
@@ -2941,6 +3307,161 @@ static void ApplyCorr(GridS *pG, int i, int j, int k,
 
 #endif /* FIRST_ORDER_FLUX_CORRECTION */
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static void load_tile(const GridS *pG, int ibs, int ibe, int jbs,
+ *                            int jbe, int kbs, int kbe)
+ *  \brief Sets up Tile as the brick [ibs:ibe][jbs:jbe][kbs:kbe] of pG,
+ *   including nghost ghost zones taken from pG.
+ */
+static void load_tile(const GridS *pG, int ibs, int ibe, int jbs, int jbe,
+                      int kbs, int kbe)
+{
+  int i,j,k;
+  int ioff = ibs-nghost, joff = jbs-nghost, koff = kbs-nghost;
+
+  Tile.is = nghost;  Tile.ie = nghost + ibe - ibs;
+  Tile.js = nghost;  Tile.je = nghost + jbe - jbs;
+  Tile.ks = nghost;  Tile.ke = nghost + kbe - kbs;
+  Tile.Nx[0] = ibe - ibs + 1;
+  Tile.Nx[1] = jbe - jbs + 1;
+  Tile.Nx[2] = kbe - kbs + 1;
+  Tile.Disp[0] = pG->Disp[0] + (ibs - pG->is);
+  Tile.Disp[1] = pG->Disp[1] + (jbs - pG->js);
+  Tile.Disp[2] = pG->Disp[2] + (kbs - pG->ks);
+  Tile.MinX[0] = pG->MinX[0] + (Real)(ibs - pG->is)*pG->dx1;
+  Tile.MinX[1] = pG->MinX[1] + (Real)(jbs - pG->js)*pG->dx2;
+  Tile.MinX[2] = pG->MinX[2] + (Real)(kbs - pG->ks)*pG->dx3;
+  Tile.MaxX[0] = Tile.MinX[0] + (Real)(Tile.Nx[0])*pG->dx1;
+  Tile.MaxX[1] = Tile.MinX[1] + (Real)(Tile.Nx[1])*pG->dx2;
+  Tile.MaxX[2] = Tile.MinX[2] + (Real)(Tile.Nx[2])*pG->dx3;
+#ifdef CYLINDRICAL
+  Tile.r  = pG->r  + ioff;
+  Tile.ri = pG->ri + ioff;
+#endif
+
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i)
+#endif
+  for (k=kbs-nghost; k<=kbe+nghost; k++) {
+    for (j=jbs-nghost; j<=jbe+nghost; j++) {
+      for (i=ibs-nghost; i<=ibe+nghost; i++) {
+        SET_GRID_U(&Tile,k-koff,j-joff,i-ioff,GET_GRID_U(pG,k,j,i));
+#ifdef MHD
+        Tile.B1i[k-koff][j-joff][i-ioff] = pG->B1i[k][j][i];
+        Tile.B2i[k-koff][j-joff][i-ioff] = pG->B2i[k][j][i];
+        Tile.B3i[k-koff][j-joff][i-ioff] = pG->B3i[k][j][i];
+#endif /* MHD */
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void store_tile(const GridS *pG, int nb, int ibs, int ibe,
+ *                  int jbs, int jbe, int kbs, int kbe, int kps)
+ *  \brief Copies the updated interior of Tile into plane buffer nb, which
+ *   starts at k=kps.  Interface fields on the upper faces of a brick are
+ *   stored only at the upper boundary of the Grid, otherwise they belong to
+ *   the next brick.
+ */
+static void store_tile(const GridS *pG, int nb, int ibs, int ibe, int jbs,
+                       int jbe, int kbs, int kbe, int kps)
+{
+  int i,j,k;
+  int ioff = ibs-nghost, joff = jbs-nghost, koff = kbs-nghost;
+#ifdef MHD
+  int ip = (ibe == pG->ie) ? 1 : 0;
+  int jp = (jbe == pG->je) ? 1 : 0;
+  int kp = (kbe == pG->ke) ? 1 : 0;
+#endif
+
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i)
+#endif
+  for (k=kbs; k<=kbe; k++) {
+    for (j=jbs; j<=jbe; j++) {
+      for (i=ibs; i<=ibe; i++) {
+        Ubuf[nb][k-kps][j-pG->js][i-pG->is] =
+          GET_GRID_U(&Tile,k-koff,j-joff,i-ioff);
+      }
+#ifdef MHD
+      for (i=ibs; i<=ibe+ip; i++) {
+        B1buf[nb][k-kps][j-pG->js][i-pG->is] = Tile.B1i[k-koff][j-joff][i-ioff];
+      }
+#endif /* MHD */
+    }
+#ifdef MHD
+    for (j=jbs; j<=jbe+jp; j++) {
+      for (i=ibs; i<=ibe; i++) {
+        B2buf[nb][k-kps][j-pG->js][i-pG->is] = Tile.B2i[k-koff][j-joff][i-ioff];
+      }
+    }
+#endif /* MHD */
+  }
+#ifdef MHD
+  for (k=kbs; k<=kbe+kp; k++) {
+    for (j=jbs; j<=jbe; j++) {
+      for (i=ibs; i<=ibe; i++) {
+        B3buf[nb][k-kps][j-pG->js][i-pG->is] = Tile.B3i[k-koff][j-joff][i-ioff];
+      }
+    }
+  }
+#endif /* MHD */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void flush_tile_plane(GridS *pG, int nb, int kps, int kpe)
+ *  \brief Copies plane buffer nb, holding the updated cells kps:kpe, back
+ *   into the Grid.
+ */
+static void flush_tile_plane(GridS *pG, int nb, int kps, int kpe)
+{
+  int i,j,k;
+  int is = pG->is, ie = pG->ie;
+  int js = pG->js, je = pG->je;
+#ifdef MHD
+  int kp = (kpe == pG->ke) ? 1 : 0;
+#endif
+
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel for private(j,i)
+#endif
+  for (k=kps; k<=kpe; k++) {
+    for (j=js; j<=je; j++) {
+      for (i=is; i<=ie; i++) {
+        SET_GRID_U(pG,k,j,i,Ubuf[nb][k-kps][j-js][i-is]);
+      }
+#ifdef MHD
+      for (i=is; i<=ie+1; i++) {
+        pG->B1i[k][j][i] = B1buf[nb][k-kps][j-js][i-is];
+      }
+#endif /* MHD */
+    }
+#ifdef MHD
+    for (j=js; j<=je+1; j++) {
+      for (i=is; i<=ie; i++) {
+        pG->B2i[k][j][i] = B2buf[nb][k-kps][j-js][i-is];
+      }
+    }
+#endif /* MHD */
+  }
+#ifdef MHD
+  for (k=kps; k<=kpe+kp; k++) {
+    for (j=js; j<=je; j++) {
+      for (i=is; i<=ie; i++) {
+        pG->B3i[k][j][i] = B3buf[nb][k-kps][j-js][i-is];
+      }
+    }
+  }
+#endif /* MHD */
+
+  return;
+}
+
 #endif /* VL_INTEGRATOR */
 
 #endif /* SPECIAL_RELATIVITY */
@@ -140,6 +140,7 @@ void integrate_3d_vl(DomainS *pD)
   Real Vsq;
   ConsS Ucheck;
   PrimS Wcheck;
+  ConsS Ucell;
   Int3Vect BadCell;
 #endif
   int il=is-(nghost-1), iu=ie+(nghost-1);
@@ -152,11 +153,11 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks-nghost; k<=ke+nghost; k++) {
     for (j=js-nghost; j<=je+nghost; j++) {
       for (i=is-nghost; i<=ie+nghost; i++) {
-        Uhalf[k][j][i] = pG->U[k][j][i];
-        W[k][j][i] = Cons_to_Prim(&(pG->U[k][j][i]));
+        Uhalf[k][j][i] = GET_GRID_U(pG,k,j,i);
+        W[k][j][i] = Cons_to_Prim(&(Uhalf[k][j][i]));
 #ifdef USE_ENTROPY_FIX
 	S[k][j][i] = W[k][j][i].P * pow(W[k][j][i].d,1.0-Gamma);
-	S[k][j][i]*= pG->U[k][j][i].d / W[k][j][i].d;
+	S[k][j][i]*= GRID_U(pG,k,j,i,d) / W[k][j][i].d;
 	Shalf[k][j][i] = S[k][j][i];
 #endif
 #ifdef MHD
@@ -578,7 +579,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-          Uhalf[k][j][i].M1 -= q1*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M1 -= q1*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q1*(x1Flux[k][j][i  ].d*(phic - phil)
                                 + x1Flux[k][j][i+1].d*(phir - phic));
@@ -586,7 +587,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          Uhalf[k][j][i].M2 -= q2*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M2 -= q2*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q2*(x2Flux[k][j  ][i].d*(phic - phil)
                                 + x2Flux[k][j+1][i].d*(phir - phic));
@@ -594,7 +595,7 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          Uhalf[k][j][i].M3 -= q3*(phir-phil)*pG->U[k][j][i].d;
+          Uhalf[k][j][i].M3 -= q3*(phir-phil)*GRID_U(pG,k,j,i,d);
 #ifndef BAROTROPIC
           Uhalf[k][j][i].E -= q3*(x3Flux[k  ][j][i].d*(phic - phil)
                                 + x3Flux[k+1][j][i].d*(phir - phic));
@@ -1182,9 +1183,9 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i]+pG->B1i[k][j][i+1]);
-        pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i]+pG->B2i[k][j+1][i]);
-        pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i]+pG->B3i[k+1][j][i]);
+        GRID_U(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i]+pG->B1i[k][j][i+1]);
+        GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i]+pG->B2i[k][j+1][i]);
+        GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i]+pG->B3i[k+1][j][i]);
       }
     }
   }
@@ -1208,25 +1209,25 @@ void integrate_3d_vl(DomainS *pD)
           phir = (*StaticGravPot)((x1+0.5*pG->dx1),x2,x3);
           phil = (*StaticGravPot)((x1-0.5*pG->dx1),x2,x3);
 
-          pG->U[k][j][i].M1 -= dtodx1*(phir-phil)*Uhalf[k][j][i].d;
+          GRID_U(pG,k,j,i,M1) -= dtodx1*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil)
+          GRID_U(pG,k,j,i,E) -= dtodx1*(x1Flux[k][j][i  ].d*(phic - phil)
                                     + x1Flux[k][j][i+1].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,(x2+0.5*pG->dx2),x3);
           phil = (*StaticGravPot)(x1,(x2-0.5*pG->dx2),x3);
 
-          pG->U[k][j][i].M2 -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
+          GRID_U(pG,k,j,i,M2) -= dtodx2*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
+          GRID_U(pG,k,j,i,E) -= dtodx2*(x2Flux[k][j  ][i].d*(phic - phil)
                                     + x2Flux[k][j+1][i].d*(phir - phic));
 #endif
           phir = (*StaticGravPot)(x1,x2,(x3+0.5*pG->dx3));
           phil = (*StaticGravPot)(x1,x2,(x3-0.5*pG->dx3));
 
-          pG->U[k][j][i].M3 -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
+          GRID_U(pG,k,j,i,M3) -= dtodx3*(phir-phil)*Uhalf[k][j][i].d;
 #ifndef BAROTROPIC
-          pG->U[k][j][i].E -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
+          GRID_U(pG,k,j,i,E) -= dtodx3*(x3Flux[k  ][j][i].d*(phic - phil)
                                     + x3Flux[k+1][j][i].d*(phir - phic));
 #endif
         }
@@ -1243,16 +1244,16 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d -=dtodx1*(x1Flux[k][j][i+1].d -x1Flux[k][j][i].d );
-        pG->U[k][j][i].M1-=dtodx1*(x1Flux[k][j][i+1].Mx-x1Flux[k][j][i].Mx);
-        pG->U[k][j][i].M2-=dtodx1*(x1Flux[k][j][i+1].My-x1Flux[k][j][i].My);
-        pG->U[k][j][i].M3-=dtodx1*(x1Flux[k][j][i+1].Mz-x1Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,d) -=dtodx1*(x1Flux[k][j][i+1].d -x1Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1)-=dtodx1*(x1Flux[k][j][i+1].Mx-x1Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,M2)-=dtodx1*(x1Flux[k][j][i+1].My-x1Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,M3)-=dtodx1*(x1Flux[k][j][i+1].Mz-x1Flux[k][j][i].Mz);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx1*(x1Flux[k][j][i+1].E -x1Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E) -=dtodx1*(x1Flux[k][j][i+1].E -x1Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx1*(x1Flux[k][j][i+1].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx1*(x1Flux[k][j][i+1].s[n]
                                        - x1Flux[k][j][i  ].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -1269,16 +1270,16 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d -=dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
-        pG->U[k][j][i].M1-=dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
-        pG->U[k][j][i].M2-=dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
-        pG->U[k][j][i].M3-=dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,d) -=dtodx2*(x2Flux[k][j+1][i].d -x2Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1)-=dtodx2*(x2Flux[k][j+1][i].Mz-x2Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,M2)-=dtodx2*(x2Flux[k][j+1][i].Mx-x2Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,M3)-=dtodx2*(x2Flux[k][j+1][i].My-x2Flux[k][j][i].My);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E) -=dtodx2*(x2Flux[k][j+1][i].E -x2Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx2*(x2Flux[k][j+1][i].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx2*(x2Flux[k][j+1][i].s[n]
                                        - x2Flux[k][j  ][i].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -1295,16 +1296,16 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].d -=dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
-        pG->U[k][j][i].M1-=dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
-        pG->U[k][j][i].M2-=dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
-        pG->U[k][j][i].M3-=dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
+        GRID_U(pG,k,j,i,d) -=dtodx3*(x3Flux[k+1][j][i].d -x3Flux[k][j][i].d );
+        GRID_U(pG,k,j,i,M1)-=dtodx3*(x3Flux[k+1][j][i].My-x3Flux[k][j][i].My);
+        GRID_U(pG,k,j,i,M2)-=dtodx3*(x3Flux[k+1][j][i].Mz-x3Flux[k][j][i].Mz);
+        GRID_U(pG,k,j,i,M3)-=dtodx3*(x3Flux[k+1][j][i].Mx-x3Flux[k][j][i].Mx);
 #ifndef BAROTROPIC
-        pG->U[k][j][i].E -=dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
+        GRID_U(pG,k,j,i,E) -=dtodx3*(x3Flux[k+1][j][i].E -x3Flux[k][j][i].E );
 #endif /* BAROTROPIC */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          pG->U[k][j][i].s[n] -= dtodx3*(x3Flux[k+1][j][i].s[n]
+          GRID_U(pG,k,j,i,s[n]) -= dtodx3*(x3Flux[k+1][j][i].s[n]
                                        - x3Flux[k  ][j][i].s[n]);
 #endif
 #ifdef USE_ENTROPY_FIX
@@ -1323,7 +1324,8 @@ void integrate_3d_vl(DomainS *pD)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        Wcheck = check_Prim(&(pG->U[k][j][i]));
+        Ucell = GET_GRID_U(pG,k,j,i);
+        Wcheck = check_Prim(&Ucell);
         if (Wcheck.d < 0.0) {
           flag_cell = 1;
           BadCell.i = i;
@@ -1381,7 +1383,8 @@ void integrate_3d_vl(DomainS *pD)
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
 	flag_cell = 0;
-        Wcheck = check_Prim(&(pG->U[k][j][i]));
+        Ucell = GET_GRID_U(pG,k,j,i);
+        Wcheck = check_Prim(&Ucell);
         if (Wcheck.d < 0.0) {
           flag_cell = 1;
           negd++;
@@ -1398,30 +1401,33 @@ void integrate_3d_vl(DomainS *pD)
 #ifdef USE_ENTROPY_FIX
 	if (flag_cell != 0) {
 	  entropy++;
-	  Wcheck = entropy_fix (&(pG->U[k][j][i]),&(S[k][j][i]));
+	  Ucell = GET_GRID_U(pG,k,j,i);
+	  Wcheck = entropy_fix (&Ucell,&(S[k][j][i]));
 	  Ucheck = Prim_to_Cons(&Wcheck);
 	  Wcheck = check_Prim(&Ucheck);
 	  Vsq = SQR(Wcheck.V1) + SQR(Wcheck.V2) + SQR(Wcheck.V3);
 	  if (Wcheck.d > 0.0 && Wcheck.P > 0.0 && Vsq < 1.0){
-	    pG->U[k][j][i].d = Ucheck.d;
-	    pG->U[k][j][i].M1 = Ucheck.M1;
-	    pG->U[k][j][i].M2 = Ucheck.M2;
-	    pG->U[k][j][i].M3 = Ucheck.M3;
-	    pG->U[k][j][i].E = Ucheck.E;
+	    GRID_U(pG,k,j,i,d) = Ucheck.d;
+	    GRID_U(pG,k,j,i,M1) = Ucheck.M1;
+	    GRID_U(pG,k,j,i,M2) = Ucheck.M2;
+	    GRID_U(pG,k,j,i,M3) = Ucheck.M3;
+	    GRID_U(pG,k,j,i,E) = Ucheck.E;
 	    flag_cell = 0;
 	  }
 	}
 #endif /* USE_ENTROPY_FIX */
 	if (flag_cell != 0) {
 	  final++;
-	  Wcheck = fix_vsq (&(pG->U[k][j][i]));
+	  Ucell = GET_GRID_U(pG,k,j,i);
+	  Wcheck = fix_vsq (&Ucell);
 	  Ucheck = Prim_to_Cons(&Wcheck);
-	  pG->U[k][j][i].d = Ucheck.d;
-	  pG->U[k][j][i].M1 = Ucheck.M1;
-	  pG->U[k][j][i].M2 = Ucheck.M2;
-	  pG->U[k][j][i].M3 = Ucheck.M3;
-	  pG->U[k][j][i].E = Ucheck.E;
-	  Wcheck = check_Prim(&(pG->U[k][j][i]));
+	  GRID_U(pG,k,j,i,d) = Ucheck.d;
+	  GRID_U(pG,k,j,i,M1) = Ucheck.M1;
+	  GRID_U(pG,k,j,i,M2) = Ucheck.M2;
+	  GRID_U(pG,k,j,i,M3) = Ucheck.M3;
+	  GRID_U(pG,k,j,i,E) = Ucheck.E;
+	  Ucell = GET_GRID_U(pG,k,j,i);
+	  Wcheck = check_Prim(&Ucell);
 	  Vsq = SQR(Wcheck.V1) + SQR(Wcheck.V2) + SQR(Wcheck.V3);
 	  if (Wcheck.d < 0.0 || Wcheck.P < 0.0 || Vsq > 1.0){
 	    fail++;
@@ -2268,93 +2274,93 @@ static void FixCell(GridS *pG, Int3Vect ix)
 
 /* Use flux differences to correct bad cell-centered quantities */
   
-  pG->U[ix.k][ix.j][ix.i].d  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
-  pG->U[ix.k][ix.j][ix.i].M1 += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
-  pG->U[ix.k][ix.j][ix.i].M2 += dtodx1*(x1FD_ip1.My - x1FD_i.My);
-  pG->U[ix.k][ix.j][ix.i].M3 += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
+  GRID_U(pG,ix.k,ix.j,ix.i,d)  += dtodx1*(x1FD_ip1.d  - x1FD_i.d );
+  GRID_U(pG,ix.k,ix.j,ix.i,M1) += dtodx1*(x1FD_ip1.Mx - x1FD_i.Mx);
+  GRID_U(pG,ix.k,ix.j,ix.i,M2) += dtodx1*(x1FD_ip1.My - x1FD_i.My);
+  GRID_U(pG,ix.k,ix.j,ix.i,M3) += dtodx1*(x1FD_ip1.Mz - x1FD_i.Mz);
 #ifndef BAROTROPIC
-  pG->U[ix.k][ix.j][ix.i].E  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
+  GRID_U(pG,ix.k,ix.j,ix.i,E)  += dtodx1*(x1FD_ip1.E  - x1FD_i.E );
 #endif /* BAROTROPIC */
   
-  pG->U[ix.k][ix.j][ix.i].d  += dtodx2*(x2FD_jp1.d  - x2FD_j.d );
-  pG->U[ix.k][ix.j][ix.i].M1 += dtodx2*(x2FD_jp1.Mz - x2FD_j.Mz);
-  pG->U[ix.k][ix.j][ix.i].M2 += dtodx2*(x2FD_jp1.Mx - x2FD_j.Mx);
-  pG->U[ix.k][ix.j][ix.i].M3 += dtodx2*(x2FD_jp1.My - x2FD_j.My);
+  GRID_U(pG,ix.k,ix.j,ix.i,d)  += dtodx2*(x2FD_jp1.d  - x2FD_j.d );
+  GRID_U(pG,ix.k,ix.j,ix.i,M1) += dtodx2*(x2FD_jp1.Mz - x2FD_j.Mz);
+  GRID_U(pG,ix.k,ix.j,ix.i,M2) += dtodx2*(x2FD_jp1.Mx - x2FD_j.Mx);
+  GRID_U(pG,ix.k,ix.j,ix.i,M3) += dtodx2*(x2FD_jp1.My - x2FD_j.My);
 #ifndef BAROTROPIC
-  pG->U[ix.k][ix.j][ix.i].E  += dtodx2*(x2FD_jp1.E  - x2FD_j.E );
+  GRID_U(pG,ix.k,ix.j,ix.i,E)  += dtodx2*(x2FD_jp1.E  - x2FD_j.E );
 #endif /* BAROTROPIC */
 
-  pG->U[ix.k][ix.j][ix.i].d  += dtodx3*(x3FD_kp1.d  - x3FD_k.d );
-  pG->U[ix.k][ix.j][ix.i].M1 += dtodx3*(x3FD_kp1.Mz - x3FD_k.Mz);
-  pG->U[ix.k][ix.j][ix.i].M2 += dtodx3*(x3FD_kp1.Mx - x3FD_k.Mx);
-  pG->U[ix.k][ix.j][ix.i].M3 += dtodx3*(x3FD_kp1.My - x3FD_k.My);
+  GRID_U(pG,ix.k,ix.j,ix.i,d)  += dtodx3*(x3FD_kp1.d  - x3FD_k.d );
+  GRID_U(pG,ix.k,ix.j,ix.i,M1) += dtodx3*(x3FD_kp1.Mz - x3FD_k.Mz);
+  GRID_U(pG,ix.k,ix.j,ix.i,M2) += dtodx3*(x3FD_kp1.Mx - x3FD_k.Mx);
+  GRID_U(pG,ix.k,ix.j,ix.i,M3) += dtodx3*(x3FD_kp1.My - x3FD_k.My);
 #ifndef BAROTROPIC
-  pG->U[ix.k][ix.j][ix.i].E  += dtodx3*(x3FD_kp1.E  - x3FD_k.E );
+  GRID_U(pG,ix.k,ix.j,ix.i,E)  += dtodx3*(x3FD_kp1.E  - x3FD_k.E );
 #endif /* BAROTROPIC */
 
 /* Use flux differences to correct cell-centered values at i-1 and i+1 */
   
   if (ix.i > pG->is) {
-    pG->U[ix.k][ix.j][ix.i-1].d  += dtodx1*(x1FD_i.d );
-    pG->U[ix.k][ix.j][ix.i-1].M1 += dtodx1*(x1FD_i.Mx);
-    pG->U[ix.k][ix.j][ix.i-1].M2 += dtodx1*(x1FD_i.My);
-    pG->U[ix.k][ix.j][ix.i-1].M3 += dtodx1*(x1FD_i.Mz);
+    GRID_U(pG,ix.k,ix.j,ix.i-1,d)  += dtodx1*(x1FD_i.d );
+    GRID_U(pG,ix.k,ix.j,ix.i-1,M1) += dtodx1*(x1FD_i.Mx);
+    GRID_U(pG,ix.k,ix.j,ix.i-1,M2) += dtodx1*(x1FD_i.My);
+    GRID_U(pG,ix.k,ix.j,ix.i-1,M3) += dtodx1*(x1FD_i.Mz);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j][ix.i-1].E  += dtodx1*(x1FD_i.E );
+    GRID_U(pG,ix.k,ix.j,ix.i-1,E)  += dtodx1*(x1FD_i.E );
 #endif /* BAROTROPIC */
   }
   
   if (ix.i < pG->ie) {
-    pG->U[ix.k][ix.j][ix.i+1].d  -= dtodx1*(x1FD_ip1.d );
-    pG->U[ix.k][ix.j][ix.i+1].M1 -= dtodx1*(x1FD_ip1.Mx);
-    pG->U[ix.k][ix.j][ix.i+1].M2 -= dtodx1*(x1FD_ip1.My);
-    pG->U[ix.k][ix.j][ix.i+1].M3 -= dtodx1*(x1FD_ip1.Mz);
+    GRID_U(pG,ix.k,ix.j,ix.i+1,d)  -= dtodx1*(x1FD_ip1.d );
+    GRID_U(pG,ix.k,ix.j,ix.i+1,M1) -= dtodx1*(x1FD_ip1.Mx);
+    GRID_U(pG,ix.k,ix.j,ix.i+1,M2) -= dtodx1*(x1FD_ip1.My);
+    GRID_U(pG,ix.k,ix.j,ix.i+1,M3) -= dtodx1*(x1FD_ip1.Mz);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j][ix.i+1].E  -= dtodx1*(x1FD_ip1.E );
+    GRID_U(pG,ix.k,ix.j,ix.i+1,E)  -= dtodx1*(x1FD_ip1.E );
 #endif /* BAROTROPIC */
   }
 
 /* Use flux differences to correct cell-centered values at j-1 and j+1 */
   
   if (ix.j > pG->js) {
-    pG->U[ix.k][ix.j-1][ix.i].d  += dtodx2*(x2FD_j.d );
-    pG->U[ix.k][ix.j-1][ix.i].M1 += dtodx2*(x2FD_j.Mz);
-    pG->U[ix.k][ix.j-1][ix.i].M2 += dtodx2*(x2FD_j.Mx);
-    pG->U[ix.k][ix.j-1][ix.i].M3 += dtodx2*(x2FD_j.My);
+    GRID_U(pG,ix.k,ix.j-1,ix.i,d)  += dtodx2*(x2FD_j.d );
+    GRID_U(pG,ix.k,ix.j-1,ix.i,M1) += dtodx2*(x2FD_j.Mz);
+    GRID_U(pG,ix.k,ix.j-1,ix.i,M2) += dtodx2*(x2FD_j.Mx);
+    GRID_U(pG,ix.k,ix.j-1,ix.i,M3) += dtodx2*(x2FD_j.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j-1][ix.i].E  += dtodx2*(x2FD_j.E );
+    GRID_U(pG,ix.k,ix.j-1,ix.i,E)  += dtodx2*(x2FD_j.E );
 #endif /* BAROTROPIC */
   }
   
   if (ix.j < pG->je) {
-    pG->U[ix.k][ix.j+1][ix.i].d  -= dtodx2*(x2FD_jp1.d );
-    pG->U[ix.k][ix.j+1][ix.i].M1 -= dtodx2*(x2FD_jp1.Mz);
-    pG->U[ix.k][ix.j+1][ix.i].M2 -= dtodx2*(x2FD_jp1.Mx);
-    pG->U[ix.k][ix.j+1][ix.i].M3 -= dtodx2*(x2FD_jp1.My);
+    GRID_U(pG,ix.k,ix.j+1,ix.i,d)  -= dtodx2*(x2FD_jp1.d );
+    GRID_U(pG,ix.k,ix.j+1,ix.i,M1) -= dtodx2*(x2FD_jp1.Mz);
+    GRID_U(pG,ix.k,ix.j+1,ix.i,M2) -= dtodx2*(x2FD_jp1.Mx);
+    GRID_U(pG,ix.k,ix.j+1,ix.i,M3) -= dtodx2*(x2FD_jp1.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k][ix.j+1][ix.i].E  -= dtodx2*(x2FD_jp1.E );
+    GRID_U(pG,ix.k,ix.j+1,ix.i,E)  -= dtodx2*(x2FD_jp1.E );
 #endif /* BAROTROPIC */
   }
 
 /* Use flux differences to correct cell-centered values at k-1 and k+1 */
  
   if (ix.k > pG->ks) {
-    pG->U[ix.k-1][ix.j][ix.i].d  += dtodx3*(x3FD_k.d );
-    pG->U[ix.k-1][ix.j][ix.i].M1 += dtodx3*(x3FD_k.Mz);
-    pG->U[ix.k-1][ix.j][ix.i].M2 += dtodx3*(x3FD_k.Mx);
-    pG->U[ix.k-1][ix.j][ix.i].M3 += dtodx3*(x3FD_k.My);
+    GRID_U(pG,ix.k-1,ix.j,ix.i,d)  += dtodx3*(x3FD_k.d );
+    GRID_U(pG,ix.k-1,ix.j,ix.i,M1) += dtodx3*(x3FD_k.Mz);
+    GRID_U(pG,ix.k-1,ix.j,ix.i,M2) += dtodx3*(x3FD_k.Mx);
+    GRID_U(pG,ix.k-1,ix.j,ix.i,M3) += dtodx3*(x3FD_k.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k-1][ix.j][ix.i].E  += dtodx3*(x3FD_k.E );
+    GRID_U(pG,ix.k-1,ix.j,ix.i,E)  += dtodx3*(x3FD_k.E );
 #endif /* BAROTROPIC */
   }
  
   if (ix.k < pG->ke) {
-    pG->U[ix.k+1][ix.j][ix.i].d  -= dtodx3*(x3FD_kp1.d );
-    pG->U[ix.k+1][ix.j][ix.i].M1 -= dtodx3*(x3FD_kp1.Mz);
-    pG->U[ix.k+1][ix.j][ix.i].M2 -= dtodx3*(x3FD_kp1.Mx);
-    pG->U[ix.k+1][ix.j][ix.i].M3 -= dtodx3*(x3FD_kp1.My);
+    GRID_U(pG,ix.k+1,ix.j,ix.i,d)  -= dtodx3*(x3FD_kp1.d );
+    GRID_U(pG,ix.k+1,ix.j,ix.i,M1) -= dtodx3*(x3FD_kp1.Mz);
+    GRID_U(pG,ix.k+1,ix.j,ix.i,M2) -= dtodx3*(x3FD_kp1.Mx);
+    GRID_U(pG,ix.k+1,ix.j,ix.i,M3) -= dtodx3*(x3FD_kp1.My);
 #ifndef BAROTROPIC
-    pG->U[ix.k+1][ix.j][ix.i].E  -= dtodx3*(x3FD_kp1.E );
+    GRID_U(pG,ix.k+1,ix.j,ix.i,E)  -= dtodx3*(x3FD_kp1.E );
 #endif /* BAROTROPIC */
   }
 
@@ -2417,9 +2423,9 @@ static void FixCell(GridS *pG, Int3Vect ix)
   for (k=(ix.k-1); k<=(ix.k+1); k++) {
   for (j=(ix.j-1); j<=(ix.j+1); j++) {
   for (i=(ix.i-1); i<=(ix.i+1); i++) {
-    pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
-    pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
-    pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+    GRID_U(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+    GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+    GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
   }}}
 #endif /* MHD */
 
@@ -12,6 +12,15 @@
 
 #include "../config.h"
 
+/* With FUSED_CFL the integrators call new_dt_speeds() for each row of cells in
+ * their last loop over the Grid, and store the maximum signal speeds in the
+ * Grid for new_dt().  CFL_REDUCTION goes on the OpenMP pragma of that loop. */
+#ifdef FUSED_CFL
+#define CFL_REDUCTION reduction(max:cfl_v1,cfl_v2,cfl_v3)
+#else
+#define CFL_REDUCTION
+#endif
+
 /* integrate.c */
 VDFun_t integrate_init(MeshS *pM);
 void integrate_destruct(void);
@@ -33,5 +42,23 @@ void integrate_destruct_3d(void);
 void integrate_init_3d(MeshS *pM);
 void integrate_3d_ctu(DomainS *pD);
 void integrate_3d_vl(DomainS *pD);
+void integrate_3d_vl_tiled(DomainS *pD);
+
+#ifdef RUNTIME_SOLVERS
+/* With RUNTIME_SOLVERS both integrators are compiled, with the init and
+ * destruct functions above renamed (see Makefile.in) */
+void integrate_init_1d_ctu(MeshS *pM);
+void integrate_init_1d_vl(MeshS *pM);
+void integrate_destruct_1d_ctu(void);
+void integrate_destruct_1d_vl(void);
+void integrate_init_2d_ctu(MeshS *pM);
+void integrate_init_2d_vl(MeshS *pM);
+void integrate_destruct_2d_ctu(void);
+void integrate_destruct_2d_vl(void);
+void integrate_init_3d_ctu(MeshS *pM);
+void integrate_init_3d_vl(MeshS *pM);
+void integrate_destruct_3d_ctu(void);
+void integrate_destruct_3d_vl(void);
+#endif /* RUNTIME_SOLVERS */
 
 #endif /* INTEGRATORS_PROTOTYPES_H */
@@ -45,6 +45,9 @@ static char *athena_version = "version 4.0 - 01-Jul-2010";
 #include "globals.h"
 #include "prototypes.h"
 #include "particles/prototypes.h"
+#ifdef OPENMP_PARALLEL
+#include <omp.h>
+#endif
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
@@ -85,6 +88,9 @@ int main(int argc, char *argv[])
   VDFun_t SelfGrav;      /* function pointer to self-gravity, set at runtime */
 #endif
   int nl,nd;
+#ifdef ADAPTIVE_MESH_REFINEMENT
+  int regrid;             /* number of levels regridded by AMR_regrid() */
+#endif
   char *definput = "athinput";  /* default input filename */
   char *athinput = definput;
   int ires=0;             /* restart flag, set to 1 if -r argument on cmdline */
@@ -115,12 +121,26 @@ int main(int argc, char *argv[])
   struct timeval tvs, tve;
   Real dt_done;
 
+#ifdef OPENMP_PARALLEL
+  int nthreads;           /* number of OpenMP threads per MPI process */
+#endif
 #ifdef MPI_PARALLEL
   char *pc, *suffix, new_name[MAXLEN];
   int len, h, m, s, err, use_wtlim=0;
   double wtend;
+#if defined(OPENMP_PARALLEL) || defined(ASYNC_RESTART)
+/* Only the master thread makes MPI calls, outside of any parallel region and
+ * not from the thread writing restart files */
+  int thread_level;
+  if(MPI_SUCCESS != MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED,
+                                    &thread_level))
+    ath_error("[main]: Error on calling MPI_Init_thread\n");
+  if(thread_level < MPI_THREAD_FUNNELED)
+    ath_error("[main]: MPI library does not support MPI_THREAD_FUNNELED\n");
+#else
   if(MPI_SUCCESS != MPI_Init(&argc, &argv))
     ath_error("[main]: Error on calling MPI_Init\n");
+#endif /* OPENMP_PARALLEL || ASYNC_RESTART */
 #endif /* MPI_PARALLEL */
 
 /*----------------------------------------------------------------------------*/
@@ -259,8 +279,12 @@ int main(int argc, char *argv[])
 	ath_error("[main]: Bad Restart filename: %s\n",new_name);
     }while(*pc != '.');
 
-/* Only children add myID_Comm_world to the filename */
+/* Only children add myID_Comm_world to the filename, except with MPI-IO
+ * restarts where all processes read the same file */
 
+#ifdef MPIIO_RESTART
+    res_file = new_name;
+#else
     if(myID_Comm_world == 0) {
       strcpy(new_name, res_file);
     } else {       
@@ -269,6 +293,7 @@ int main(int argc, char *argv[])
       free(suffix);
       res_file = new_name;
     }
+#endif /* MPIIO_RESTART */
   }
 
 /* Quit MPI_PARALLEL job if code was run with -n option. */
@@ -332,6 +357,25 @@ int main(int argc, char *argv[])
   if(have_time > 0) /* current calendar time (UTC) is available */
     ath_pout(0,"Simulation started on %s\n",ctime(&start));
 
+/* Set the number of OpenMP threads.  Dynamic adjustment of the team size is
+ * disabled since the integrators keep per-thread scratch arrays (declared
+ * threadprivate) which must persist between parallel regions.  */
+
+#ifdef OPENMP_PARALLEL
+  nthreads = par_geti_def("job","num_threads",omp_get_max_threads());
+  if(nthreads < 1)
+    ath_error("[main]: num_threads=%d must be >= 1\n",nthreads);
+  omp_set_dynamic(0);
+  omp_set_num_threads(nthreads);
+  ath_pout(0,"Using %d OpenMP threads per process\n",nthreads);
+#endif /* OPENMP_PARALLEL */
+
+/* With runtime solvers, choose flux, reconstruction and integrator from the
+ * <job> block */
+#ifdef RUNTIME_SOLVERS
+  runtime_solvers_init();
+#endif
+
 /*--- Step 4. ----------------------------------------------------------------*/
 /* Initialize nested mesh hierarchy. */
 
@@ -381,6 +425,9 @@ int main(int argc, char *argv[])
   SMR_init(&Mesh);
   RestrictCorrect(&Mesh);
 #endif
+#ifdef ADAPTIVE_MESH_REFINEMENT
+  AMR_init(&Mesh);
+#endif
 
 /* Initialize the first nstep value to flush the output and error logs. */
   nflush = nstep_start + iflush;
@@ -463,6 +510,9 @@ int main(int argc, char *argv[])
     sprintf(level_dir,"lev%d",nl);
     mkdir(level_dir, 0775); /* Create directories for levels > 0 */
   }
+#ifdef PHASE_TIMERS
+  timers_init(&Mesh);
+#endif
 
   gettimeofday(&tvs,NULL);
   if((have_times = times(&tbuf)) > 0)
@@ -487,22 +537,28 @@ int main(int argc, char *argv[])
  *            (f) Self-gravity
  *            (g) Update time, set new timestep
  *            (h) Set boundary values
- *            (i) check for stopping criteria
+ *            (i) Compute new timestep; with AMR, move refined Domains
+ *            (j) check for stopping criteria
  */
 
   while (Mesh.time < tlim && (nlim < 0 || Mesh.nstep < nlim)) {
+    TIMER_START(TIMER_CYCLE);
 
 /*--- Step 9a. ---------------------------------------------------------------*/
 /* Only write output's with t_out>t (last argument of data_output = 0) */
 
+    TIMER_START(TIMER_OUTPUT);
     data_output(&Mesh, 0);
+    TIMER_STOP(TIMER_OUTPUT);
 
 /*--- Step 9b. ---------------------------------------------------------------*/
 /* operator-split explicit diffusion: thermal conduction, viscosity, resistivity
  * Done first since CFL constraint is applied which may change dt  */
 
 #ifdef OPERATOR_SPLIT_COOLING
+    TIMER_START(TIMER_COOLING);
     integrate_cooling(&Mesh);
+    TIMER_START(TIMER_BVALS);
     for (nl=0; nl<(Mesh.NLevels); nl++){ 
       for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
         if (Mesh.Domain[nl][nd].Grid != NULL){
@@ -510,10 +566,13 @@ int main(int argc, char *argv[])
         }
       }
     }
+    TIMER_STOP(TIMER_BVALS);
+    TIMER_STOP(TIMER_COOLING);
 #endif
 
 
 #if defined(RESISTIVITY) || defined(VISCOSITY) || defined(THERMAL_CONDUCTION)
+    TIMER_START(TIMER_DIFFUSION);
 #ifdef STS
     ath_pout(0,"Next N_STS = %d\n", N_STS);
     for (i=0; i<N_STS; i++) {
@@ -523,25 +582,38 @@ int main(int argc, char *argv[])
       integrate_diff(&Mesh);
 
 #ifdef STATIC_MESH_REFINEMENT
+      TIMER_START(TIMER_SMR);
       RestrictCorrect(&Mesh);
+      TIMER_STOP(TIMER_SMR);
 #endif
+      TIMER_START(TIMER_BVALS);
       for (nl=0; nl<(Mesh.NLevels); nl++){ 
         for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
           if (Mesh.Domain[nl][nd].Grid != NULL){
             bvals_mhd(&(Mesh.Domain[nl][nd]));
           }
       }}
+      TIMER_STOP(TIMER_BVALS);
 #ifdef STATIC_MESH_REFINEMENT
+      TIMER_START(TIMER_SMR);
       Prolongate(&Mesh);
+      TIMER_STOP(TIMER_SMR);
 #endif
 #ifdef STS
     }
 #endif
+    TIMER_STOP(TIMER_DIFFUSION);
 #endif /* Explicit diffusion */
 
 /*--- Step 9c. ---------------------------------------------------------------*/
-/* Loop over all Domains and call Integrator */
+/* Loop over all Domains and call Integrator.  With subcycling, SMR_advance()
+ * integrates each level with its own timestep, and restricts the solution as
+ * each level completes its step, so Step 9d is not needed. */
 
+#ifdef SMR_SUBCYCLE
+    SMR_advance(&Mesh, Integrate);
+#else
+    TIMER_START(TIMER_INTEGRATE);
     for (nl=0; nl<(Mesh.NLevels); nl++){ 
       for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
         if (Mesh.Domain[nl][nd].Grid != NULL){
@@ -555,24 +627,31 @@ int main(int argc, char *argv[])
         }
       }
     }
+    TIMER_STOP(TIMER_INTEGRATE);
+#endif /* SMR_SUBCYCLE */
 
 /*--- Step 9d. ---------------------------------------------------------------*/
 /* With SMR, restrict solution from Child --> Parent grids  */
 
-#ifdef STATIC_MESH_REFINEMENT
+#if defined(STATIC_MESH_REFINEMENT) && !defined(SMR_SUBCYCLE)
+    TIMER_START(TIMER_SMR);
     RestrictCorrect(&Mesh);
+    TIMER_STOP(TIMER_SMR);
 #endif
 
 /*--- Step 9e. ---------------------------------------------------------------*/
 /* User work (defined in problem()) */
 
+    TIMER_START(TIMER_USERWORK);
     Userwork_in_loop(&Mesh);
+    TIMER_STOP(TIMER_USERWORK);
 
 /*--- Step 9f. ---------------------------------------------------------------*/
 /* Compute gravitational potential using new density, and add second-order
  * correction to fluxes for accelerations due to self-gravity. */
 
 #ifdef SELF_GRAVITY
+    TIMER_START(TIMER_SELFGRAV);
     for (nl=0; nl<(Mesh.NLevels); nl++){ 
       for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
         if (Mesh.Domain[nl][nd].Grid != NULL){
@@ -582,6 +661,7 @@ int main(int argc, char *argv[])
         }
       }
     }
+    TIMER_STOP(TIMER_SELFGRAV);
 #endif
 
 /*--- Step 9g. ---------------------------------------------------------------*/
@@ -603,26 +683,90 @@ int main(int argc, char *argv[])
 /* Boundary values must be set after time is updated for t-dependent BCs.
  * With SMR, ghost zones at internal fine/coarse boundaries set by Prolongate */
 
+#if defined(ASYNC_BVALS) && !defined(PARTICLES) && !defined(RESISTIVITY) \
+ && !defined(THERMAL_CONDUCTION) && !defined(VISCOSITY)
+/* Without particles or explicit diffusion new_dt() only uses the active zones,
+ * so it is computed (Step 9i) while the ghost zone messages are in flight. */
+
+    TIMER_START(TIMER_BVALS);
     for (nl=0; nl<(Mesh.NLevels); nl++){ 
       for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
         if (Mesh.Domain[nl][nd].Grid != NULL){
+          bvals_mhd_start(&(Mesh.Domain[nl][nd]));
+        }
+      }
+    }
+    TIMER_STOP(TIMER_BVALS);
+
+    TIMER_START(TIMER_NEW_DT);
+    new_dt(&Mesh);
+    TIMER_STOP(TIMER_NEW_DT);
+
+    TIMER_START(TIMER_BVALS);
+    for (nl=0; nl<(Mesh.NLevels); nl++){ 
+      for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
+        if (Mesh.Domain[nl][nd].Grid != NULL){
+          bvals_mhd_finish(&(Mesh.Domain[nl][nd]));
+        }
+      }
+    }
+    TIMER_STOP(TIMER_BVALS);
+
+#ifdef STATIC_MESH_REFINEMENT
+    TIMER_START(TIMER_SMR);
+    Prolongate(&Mesh);
+    TIMER_STOP(TIMER_SMR);
+#endif
+
+#else /* ghost zones are set before new_dt() */
+
+    for (nl=0; nl<(Mesh.NLevels); nl++){ 
+      for (nd=0; nd<(Mesh.DomainsPerLevel[nl]); nd++){  
+        if (Mesh.Domain[nl][nd].Grid != NULL){
+          TIMER_START(TIMER_BVALS);
           bvals_mhd(&(Mesh.Domain[nl][nd]));
+          TIMER_STOP(TIMER_BVALS);
 #ifdef PARTICLES
+          TIMER_START(TIMER_PARTICLES);
           bvals_particle(&(Mesh.Domain[nl][nd]));
+          TIMER_STOP(TIMER_PARTICLES);
 #endif
         }
       }
     }
 
 #ifdef STATIC_MESH_REFINEMENT
+    TIMER_START(TIMER_SMR);
     Prolongate(&Mesh);
+    TIMER_STOP(TIMER_SMR);
 #endif
 
 /*--- Step 9i. ---------------------------------------------------------------*/
 /* Compute new dt. With resistivity, the diffusion coeffieicnts are evaluated
  * within new_dt(), which requires that boundary values are already updated.  */
 
+    TIMER_START(TIMER_NEW_DT);
     new_dt(&Mesh);
+    TIMER_STOP(TIMER_NEW_DT);
+#endif /* ASYNC_BVALS */
+
+#ifdef ADAPTIVE_MESH_REFINEMENT
+/* Rebuild the Domains of adaptive levels to follow the flagged cells, and if
+ * any changed compute the timestep again on the new Grids */
+
+    TIMER_START(TIMER_SMR);
+    regrid = AMR_regrid(&Mesh);
+    TIMER_STOP(TIMER_SMR);
+    if (regrid > 0) {
+      TIMER_START(TIMER_NEW_DT);
+      new_dt(&Mesh);
+      TIMER_STOP(TIMER_NEW_DT);
+    }
+#endif
+    TIMER_STOP(TIMER_CYCLE);
+#ifdef PHASE_TIMERS
+    timers_cycle(&Mesh);
+#endif
 
 /*--- Step 9j. ---------------------------------------------------------------*/
 /* Force quit if wall time limit reached.  Check signals from system */
@@ -711,6 +855,10 @@ int main(int argc, char *argv[])
   ath_pout(0,"\ntotal zone-cycles/wall-second = %e\n",zcs);
 #endif /* MPI_PARALLEL */
 
+#ifdef PHASE_TIMERS
+  timers_report();
+#endif
+
 /* complete any final User work */
 
   Userwork_after_loop(&Mesh);
@@ -724,6 +872,9 @@ int main(int argc, char *argv[])
   lr_states_destruct();
   integrate_destruct();
   data_output_destruct();
+#ifdef ASYNC_RESTART
+  dump_restart_destruct(); /* also waits for the last restart file */
+#endif
 #ifdef PARTICLES
   particle_destruct(&Mesh);
   bvals_particle_destruct(&Mesh);
@@ -107,13 +107,13 @@ void conduction(DomainS *pD)
     Q[k][j][i].x2 = 0.0;
     Q[k][j][i].x3 = 0.0;
 
-    Temp[k][j][i] = pG->U[k][j][i].E - (0.5/pG->U[k][j][i].d)*
-      (SQR(pG->U[k][j][i].M1) +SQR(pG->U[k][j][i].M2) +SQR(pG->U[k][j][i].M3));
+    Temp[k][j][i] = GRID_U(pG,k,j,i,E) - (0.5/GRID_U(pG,k,j,i,d))*
+      (SQR(GRID_U(pG,k,j,i,M1)) +SQR(GRID_U(pG,k,j,i,M2)) +SQR(GRID_U(pG,k,j,i,M3)));
 #ifdef MHD
-    Temp[k][j][i] -= (0.5)*(SQR(pG->U[k][j][i].B1c) +
-      SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
+    Temp[k][j][i] -= (0.5)*(SQR(GRID_U(pG,k,j,i,B1c)) +
+      SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
 #endif
-    Temp[k][j][i] *= (Gamma_1/pG->U[k][j][i].d);
+    Temp[k][j][i] *= (Gamma_1/GRID_U(pG,k,j,i,d));
 
   }}}
 
@@ -128,7 +128,7 @@ void conduction(DomainS *pD)
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie; i++) {
-      pG->U[k][j][i].E += dtodx1*(Q[k][j][i+1].x1 - Q[k][j][i].x1);
+      GRID_U(pG,k,j,i,E) += dtodx1*(Q[k][j][i+1].x1 - Q[k][j][i].x1);
     }
   }}
 
@@ -138,7 +138,7 @@ void conduction(DomainS *pD)
     for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].E += dtodx2*(Q[k][j+1][i].x2 - Q[k][j][i].x2);
+        GRID_U(pG,k,j,i,E) += dtodx2*(Q[k][j+1][i].x2 - Q[k][j][i].x2);
       }
     }}
   }
@@ -149,7 +149,7 @@ void conduction(DomainS *pD)
     for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].E += dtodx3*(Q[k+1][j][i].x3 - Q[k][j][i].x3);
+        GRID_U(pG,k,j,i,E) += dtodx3*(Q[k+1][j][i].x3 - Q[k][j][i].x3);
       }
     }}
   }
@@ -175,7 +175,7 @@ void HeatFlux_iso(DomainS *pD)
   for (k=ks; k<=ke; k++) {
   for (j=js; j<=je; j++) {
     for (i=is; i<=ie+1; i++) {
-      kd = kappa_iso*0.5*(pG->U[k][j][i].d + pG->U[k][j][i-1].d);
+      kd = kappa_iso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k,j,i-1,d));
       Q[k][j][i].x1 += kd*(Temp[k][j][i] - Temp[k][j][i-1])/pG->dx1;
     }
   }}
@@ -186,7 +186,7 @@ void HeatFlux_iso(DomainS *pD)
     for (k=ks; k<=ke; k++) {
     for (j=js; j<=je+1; j++) {
       for (i=is; i<=ie; i++) {
-        kd = kappa_iso*0.5*(pG->U[k][j][i].d + pG->U[k][j-1][i].d);
+        kd = kappa_iso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k,j-1,i,d));
         Q[k][j][i].x2 += kd*(Temp[k][j][i] - Temp[k][j-1][i])/pG->dx2;
       }
     }}
@@ -198,7 +198,7 @@ void HeatFlux_iso(DomainS *pD)
     for (k=ks; k<=ke+1; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        kd = kappa_iso*0.5*(pG->U[k][j][i].d + pG->U[k-1][j][i].d);
+        kd = kappa_iso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k-1,j,i,d));
         Q[k][j][i].x3 += kd*(Temp[k][j][i] - Temp[k-1][j][i])/pG->dx3;
       }
     }}
@@ -248,24 +248,24 @@ void HeatFlux_aniso(DomainS *pD)
 /* Add flux at x1-interface, 2D PROBLEM */
 
       if (pD->Nx[2] == 1) {
-        By = 0.5*(pG->U[k][j][i-1].B2c + pG->U[k][j][i].B2c);
+        By = 0.5*(GRID_U(pG,k,j,i-1,B2c) + GRID_U(pG,k,j,i,B2c));
         B02 = SQR(pG->B1i[k][j][i]) + SQR(By);
         B02 = MAX(B02,TINY_NUMBER); /* limit in case B=0 */
         bDotGradT = pG->B1i[k][j][i]*(Temp[k][j][i]-Temp[k][j][i-1])/pG->dx1
            + By*dTdy;
-        kd = kappa_aniso*0.5*(pG->U[k][j][i].d + pG->U[k][j][i-1].d);
+        kd = kappa_aniso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k,j,i-1,d));
         Q[k][j][i].x1 += kd*(pG->B1i[k][j][i]*bDotGradT)/B02;
 
 /* Add flux at x1-interface, 3D PROBLEM */
 
       } else {
-        By = 0.5*(pG->U[k][j][i-1].B2c + pG->U[k][j][i].B2c);
-        Bz = 0.5*(pG->U[k][j][i-1].B3c + pG->U[k][j][i].B3c);
+        By = 0.5*(GRID_U(pG,k,j,i-1,B2c) + GRID_U(pG,k,j,i,B2c));
+        Bz = 0.5*(GRID_U(pG,k,j,i-1,B3c) + GRID_U(pG,k,j,i,B3c));
         B02 = SQR(pG->B1i[k][j][i]) + SQR(By) + SQR(Bz);
         B02 = MAX(B02,TINY_NUMBER); /* limit in case B=0 */
         bDotGradT = pG->B1i[k][j][i]*(Temp[k][j][i]-Temp[k][j][i-1])/pG->dx1
            + By*dTdy + Bz*dTdz;
-        kd = kappa_aniso*0.5*(pG->U[k][j][i].d + pG->U[k][j][i-1].d);
+        kd = kappa_aniso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k,j,i-1,d));
         Q[k][j][i].x1 += kd*(pG->B1i[k][j][i]*bDotGradT)/B02;
       }
     }
@@ -296,25 +296,25 @@ void HeatFlux_aniso(DomainS *pD)
 /* Add flux at x2-interface, 2D PROBLEM */
 
       if (pD->Nx[2] == 1) {
-        Bx = 0.5*(pG->U[k][j-1][i].B1c + pG->U[k][j][i].B1c);
+        Bx = 0.5*(GRID_U(pG,k,j-1,i,B1c) + GRID_U(pG,k,j,i,B1c));
         B02 = SQR(Bx) + SQR(pG->B2i[k][j][i]);
         B02 = MAX(B02,TINY_NUMBER); /* limit in case B=0 */
 
         bDotGradT = pG->B2i[k][j][i]*(Temp[k][j][i]-Temp[k][j-1][i])/pG->dx2
            + Bx*dTdx;
-        kd = kappa_aniso*0.5*(pG->U[k][j][i].d + pG->U[k][j-1][i].d);
+        kd = kappa_aniso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k,j-1,i,d));
         Q[k][j][i].x2 += kd*(pG->B2i[k][j][i]*bDotGradT)/B02;
 
 /* Add flux at x2-interface, 3D PROBLEM */
 
       } else {
-        Bx = 0.5*(pG->U[k][j-1][i].B1c + pG->U[k][j][i].B1c);
-        Bz = 0.5*(pG->U[k][j-1][i].B3c + pG->U[k][j][i].B3c);
+        Bx = 0.5*(GRID_U(pG,k,j-1,i,B1c) + GRID_U(pG,k,j,i,B1c));
+        Bz = 0.5*(GRID_U(pG,k,j-1,i,B3c) + GRID_U(pG,k,j,i,B3c));
         B02 = SQR(Bx) + SQR(pG->B2i[k][j][i]) + SQR(Bz);
         B02 = MAX(B02,TINY_NUMBER); /* limit in case B=0 */
         bDotGradT = pG->B2i[k][j][i]*(Temp[k][j][i]-Temp[k][j-1][i])/pG->dx2
            + Bx*dTdx + Bz*dTdz;
-        kd = kappa_aniso*0.5*(pG->U[k][j][i].d + pG->U[k][j-1][i].d);
+        kd = kappa_aniso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k,j-1,i,d));
         Q[k][j][i].x2 += kd*(pG->B2i[k][j][i]*bDotGradT)/B02;
       }
     }
@@ -343,13 +343,13 @@ void HeatFlux_aniso(DomainS *pD)
 
 /* Add flux at x3-interface, 3D PROBLEM */
 
-        Bx = 0.5*(pG->U[k-1][j][i].B1c + pG->U[k][j][i].B1c);
-        By = 0.5*(pG->U[k-1][j][i].B2c + pG->U[k][j][i].B2c);
+        Bx = 0.5*(GRID_U(pG,k-1,j,i,B1c) + GRID_U(pG,k,j,i,B1c));
+        By = 0.5*(GRID_U(pG,k-1,j,i,B2c) + GRID_U(pG,k,j,i,B2c));
         B02 = SQR(Bx) + SQR(By) + SQR(pG->B3i[k][j][i]);
         B02 = MAX(B02,TINY_NUMBER); /* limit in case B=0 */
         bDotGradT = pG->B3i[k][j][i]*(Temp[k][j][i]-Temp[k-1][j][i])/pG->dx3
            + Bx*dTdx + By*dTdy;
-        kd = kappa_aniso*0.5*(pG->U[k][j][i].d + pG->U[k-1][j][i].d);
+        kd = kappa_aniso*0.5*(GRID_U(pG,k,j,i,d) + GRID_U(pG,k-1,j,i,d));
         Q[k][j][i].x3 += kd*(pG->B3i[k][j][i]*bDotGradT)/B02;
       }
     }}
@@ -55,8 +55,10 @@ void integrate_cooling(MeshS *pM)
 void integrate_cooling_init(MeshS *pM)
 {   
 #ifdef OPERATOR_SPLIT_COOLING
-#ifdef VL_INTEGRATOR
+#if defined(VL_INTEGRATOR)
   if(pM->Nx[2]>1 && CourNo > 0.33333) ath_error("[integrate_cooling] CourNo should be smaller than 1/3 for 3D VL integrator with operator split cooling.\n");
+#elif defined(RUNTIME_SOLVERS)
+  if(!runtime_ctu_integrator() && pM->Nx[2]>1 && CourNo > 0.33333) ath_error("[integrate_cooling] CourNo should be smaller than 1/3 for 3D VL integrator with operator split cooling.\n");
 #endif
   cooling_solver_init(pM);
 #endif
@@ -14,8 +14,18 @@
  * A CFL condition is also applied using particle velocities if PARTICLES is
  * defined.
  *
+ * With SMR_SUBCYCLE the timestep pM->dt is that of the root level, limited by
+ * 2^nl times the CFL timestep of each level nl, and Grids on level nl are
+ * advanced with pM->dt/2^nl.
+ *
+ * With FUSED_CFL the integrators call new_dt_speeds() for each row of cells as
+ * it receives its final update, while it is still in cache, and store the
+ * maximum speeds in the Grid.  new_dt() then only reduces these, and makes its
+ * own pass over a Grid only if they are not set (e.g. at the start of a run).
+ *
  * CONTAINS PUBLIC FUNCTIONS: 
- * - new_dt() - computes dt						      */
+ * - new_dt()        - computes dt
+ * - new_dt_speeds() - maximum signal speeds in one row of cells	      */
 /*============================================================================*/
 
 #include <stdio.h>
@@ -41,14 +51,7 @@ void new_dt(MeshS *pM)
 {
   GridS *pGrid;
 #ifndef SPECIAL_RELATIVITY
-  int i,j,k;
-  Real di,v1,v2,v3,qsq,asq,cf1sq,cf2sq,cf3sq;
-#ifdef ADIABATIC
-  Real p;
-#endif
-#ifdef MHD
-  Real b1,b2,b3,bsq,tsum,tdif;
-#endif /* MHD */
+  int j,k;
 #ifdef PARTICLES
   long q;
 #endif /* PARTICLES */
@@ -66,8 +69,8 @@ void new_dt(MeshS *pM)
   int nl,nd;
   Real max_v1=0.0,max_v2=0.0,max_v3=0.0,max_dti = 0.0;
   Real tlim,old_dt;
-#ifdef CYLINDRICAL
-  Real x1,x2,x3;
+#ifdef SMR_SUBCYCLE
+  Real lev_fac;
 #endif
 
 /* Loop over all Domains with a Grid on this processor -----------------------*/
@@ -83,73 +86,20 @@ void new_dt(MeshS *pM)
     max_v1 = max_v2 = max_v3 = 1.0;
 #else
 
+#ifdef FUSED_CFL
+/* Use the speeds found by the integrator if they are for the current state */
+    if (pGrid->cfl_set) {
+      max_v1 = MAX(max_v1,pGrid->max_v1);
+      max_v2 = MAX(max_v2,pGrid->max_v2);
+      max_v3 = MAX(max_v3,pGrid->max_v3);
+      pGrid->cfl_set = 0;
+    } else
+#endif /* FUSED_CFL */
     for (k=pGrid->ks; k<=pGrid->ke; k++) {
-    for (j=pGrid->js; j<=pGrid->je; j++) {
-      for (i=pGrid->is; i<=pGrid->ie; i++) {
-        di = 1.0/(pGrid->U[k][j][i].d);
-        v1 = pGrid->U[k][j][i].M1*di;
-        v2 = pGrid->U[k][j][i].M2*di;
-        v3 = pGrid->U[k][j][i].M3*di;
-        qsq = v1*v1 + v2*v2 + v3*v3;
-
-#ifdef MHD
-
-/* Use maximum of face-centered fields (always larger than cell-centered B) */
-        b1 = pGrid->U[k][j][i].B1c 
-          + fabs((double)(pGrid->B1i[k][j][i] - pGrid->U[k][j][i].B1c));
-        b2 = pGrid->U[k][j][i].B2c 
-          + fabs((double)(pGrid->B2i[k][j][i] - pGrid->U[k][j][i].B2c));
-        b3 = pGrid->U[k][j][i].B3c 
-          + fabs((double)(pGrid->B3i[k][j][i] - pGrid->U[k][j][i].B3c));
-        bsq = b1*b1 + b2*b2 + b3*b3;
-/* compute sound speed squared */
-#ifdef ADIABATIC
-        p = MAX(Gamma_1*(pGrid->U[k][j][i].E - 0.5*pGrid->U[k][j][i].d*qsq
-                - 0.5*bsq), TINY_NUMBER);
-        asq = Gamma*p*di;
-#elif defined ISOTHERMAL
-        asq = Iso_csound2;
-#endif /* EOS */
-
-/* compute fast magnetosonic speed squared in each direction */
-        tsum = bsq*di + asq;
-        tdif = bsq*di - asq;
-        cf1sq = 0.5*(tsum + sqrt(tdif*tdif + 4.0*asq*(b2*b2+b3*b3)*di));
-        cf2sq = 0.5*(tsum + sqrt(tdif*tdif + 4.0*asq*(b1*b1+b3*b3)*di));
-        cf3sq = 0.5*(tsum + sqrt(tdif*tdif + 4.0*asq*(b1*b1+b2*b2)*di));
-
-#else /* MHD */
-
-/* compute sound speed squared */
-#ifdef ADIABATIC
-        p = MAX(Gamma_1*(pGrid->U[k][j][i].E - 0.5*pGrid->U[k][j][i].d*qsq),
-                TINY_NUMBER);
-        asq = Gamma*p*di;
-#elif defined ISOTHERMAL
-        asq = Iso_csound2;
-#endif /* EOS */
-/* compute fast magnetosonic speed squared in each direction */
-        cf1sq = asq;
-        cf2sq = asq;
-        cf3sq = asq;
-
-#endif /* MHD */
-
-/* compute maximum cfl velocity (corresponding to minimum dt) */
-        if (pGrid->Nx[0] > 1)
-          max_v1 = MAX(max_v1,fabs(v1)+sqrt((double)cf1sq));
-        if (pGrid->Nx[1] > 1)
-#ifdef CYLINDRICAL
-          cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
-          max_v2 = MAX(max_v2,(fabs(v2)+sqrt((double)cf2sq))/x1);
-#else
-          max_v2 = MAX(max_v2,fabs(v2)+sqrt((double)cf2sq));
-#endif
-        if (pGrid->Nx[2] > 1)
-          max_v3 = MAX(max_v3,fabs(v3)+sqrt((double)cf3sq));
- 
+      for (j=pGrid->js; j<=pGrid->je; j++) {
+        new_dt_speeds(pGrid,j,k,&max_v1,&max_v2,&max_v3);
       }
-    }}
+    }
 
 #endif /* SPECIAL_RELATIVITY */
 
@@ -166,12 +116,24 @@ void new_dt(MeshS *pM)
 #endif /* PARTICLES */
 
 /* compute maximum inverse of dt (corresponding to minimum dt) */
+#ifdef SMR_SUBCYCLE
+/* With subcycling, Grids on level nl take 2^nl steps per root level step, so
+ * pM->dt is the timestep of the root level */
+    lev_fac = 1.0/(Real)(1 << nl);
+    if (pGrid->Nx[0] > 1)
+      max_dti = MAX(max_dti, lev_fac*max_v1/pGrid->dx1);
+    if (pGrid->Nx[1] > 1)
+      max_dti = MAX(max_dti, lev_fac*max_v2/pGrid->dx2);
+    if (pGrid->Nx[2] > 1)
+      max_dti = MAX(max_dti, lev_fac*max_v3/pGrid->dx3);
+#else
     if (pGrid->Nx[0] > 1)
       max_dti = MAX(max_dti, max_v1/pGrid->dx1);
     if (pGrid->Nx[1] > 1)
       max_dti = MAX(max_dti, max_v2/pGrid->dx2);
     if (pGrid->Nx[2] > 1)
       max_dti = MAX(max_dti, max_v3/pGrid->dx3);
+#endif /* SMR_SUBCYCLE */
 
   }}} /*--- End loop over Domains --------------------------------------------*/
 
@@ -234,12 +196,17 @@ void new_dt(MeshS *pM)
 
 #endif /* Explicit Diffusion */
 
-/* Spread timestep across all Grid structures in all Domains */
+/* Spread timestep across all Grid structures in all Domains.  With
+ * subcycling, each level has half the timestep of its parent. */
 
   for (nl=0; nl<=(pM->NLevels)-1; nl++){
     for (nd=0; nd<=(pM->DomainsPerLevel[nl])-1; nd++){
       if (pM->Domain[nl][nd].Grid != NULL) {
+#ifdef SMR_SUBCYCLE
+        pM->Domain[nl][nd].Grid->dt = pM->dt/(Real)(1 << nl);
+#else
         pM->Domain[nl][nd].Grid->dt = pM->dt;
+#endif
       }
     }
   }
@@ -247,6 +214,102 @@ void new_dt(MeshS *pM)
   return;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void new_dt_speeds(const GridS *pG, const int j, const int k,
+ *                         Real *pmax_v1, Real *pmax_v2, Real *pmax_v3)
+ *  \brief Updates the maximum signal speeds *pmax_v1,2,3 in each direction
+ *   with those in cells is..ie of row (j,k) of pG.  Uses cell-centered
+ *   velocities and sound speed, and the fast speed from face-centered B.  */
+
+#ifndef SPECIAL_RELATIVITY
+void new_dt_speeds(const GridS *pG, const int j, const int k,
+                   Real *pmax_v1, Real *pmax_v2, Real *pmax_v3)
+{
+  int i;
+  Real di,v1,v2,v3,qsq,asq,cf1sq,cf2sq,cf3sq;
+  Real max_v1=(*pmax_v1), max_v2=(*pmax_v2), max_v3=(*pmax_v3);
+#ifdef ADIABATIC
+  Real p;
+#endif
+#ifdef MHD
+  Real b1,b2,b3,bsq,tsum,tdif;
+#endif /* MHD */
+#ifdef CYLINDRICAL
+  Real x1,x2,x3;
+#endif
+
+  for (i=pG->is; i<=pG->ie; i++) {
+    di = 1.0/(GRID_U(pG,k,j,i,d));
+    v1 = GRID_U(pG,k,j,i,M1)*di;
+    v2 = GRID_U(pG,k,j,i,M2)*di;
+    v3 = GRID_U(pG,k,j,i,M3)*di;
+    qsq = v1*v1 + v2*v2 + v3*v3;
+
+#ifdef MHD
+
+/* Use maximum of face-centered fields (always larger than cell-centered B) */
+    b1 = GRID_U(pG,k,j,i,B1c)
+      + fabs((double)(pG->B1i[k][j][i] - GRID_U(pG,k,j,i,B1c)));
+    b2 = GRID_U(pG,k,j,i,B2c)
+      + fabs((double)(pG->B2i[k][j][i] - GRID_U(pG,k,j,i,B2c)));
+    b3 = GRID_U(pG,k,j,i,B3c)
+      + fabs((double)(pG->B3i[k][j][i] - GRID_U(pG,k,j,i,B3c)));
+    bsq = b1*b1 + b2*b2 + b3*b3;
+/* compute sound speed squared */
+#ifdef ADIABATIC
+    p = MAX(Gamma_1*(GRID_U(pG,k,j,i,E) - 0.5*GRID_U(pG,k,j,i,d)*qsq
+            - 0.5*bsq), TINY_NUMBER);
+    asq = Gamma*p*di;
+#elif defined ISOTHERMAL
+    asq = Iso_csound2;
+#endif /* EOS */
+
+/* compute fast magnetosonic speed squared in each direction */
+    tsum = bsq*di + asq;
+    tdif = bsq*di - asq;
+    cf1sq = 0.5*(tsum + sqrt(tdif*tdif + 4.0*asq*(b2*b2+b3*b3)*di));
+    cf2sq = 0.5*(tsum + sqrt(tdif*tdif + 4.0*asq*(b1*b1+b3*b3)*di));
+    cf3sq = 0.5*(tsum + sqrt(tdif*tdif + 4.0*asq*(b1*b1+b2*b2)*di));
+
+#else /* MHD */
+
+/* compute sound speed squared */
+#ifdef ADIABATIC
+    p = MAX(Gamma_1*(GRID_U(pG,k,j,i,E) - 0.5*GRID_U(pG,k,j,i,d)*qsq),
+            TINY_NUMBER);
+    asq = Gamma*p*di;
+#elif defined ISOTHERMAL
+    asq = Iso_csound2;
+#endif /* EOS */
+/* compute fast magnetosonic speed squared in each direction */
+    cf1sq = asq;
+    cf2sq = asq;
+    cf3sq = asq;
+
+#endif /* MHD */
+
+/* compute maximum cfl velocity (corresponding to minimum dt) */
+    if (pG->Nx[0] > 1)
+      max_v1 = MAX(max_v1,fabs(v1)+sqrt((double)cf1sq));
+    if (pG->Nx[1] > 1)
+#ifdef CYLINDRICAL
+      cc_pos(pG,i,j,k,&x1,&x2,&x3);
+      max_v2 = MAX(max_v2,(fabs(v2)+sqrt((double)cf2sq))/x1);
+#else
+      max_v2 = MAX(max_v2,fabs(v2)+sqrt((double)cf2sq));
+#endif
+    if (pG->Nx[2] > 1)
+      max_v3 = MAX(max_v3,fabs(v3)+sqrt((double)cf3sq));
+
+  }
+
+  *pmax_v1 = max_v1;
+  *pmax_v2 = max_v2;
+  *pmax_v3 = max_v3;
+  return;
+}
+#endif /* SPECIAL_RELATIVITY */
+
 #ifdef STS
 /*=========================== PRIVATE FUNCTIONS ==============================*/
 /*----------------------------------------------------------------------------*/
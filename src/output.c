@@ -16,16 +16,28 @@
  *
  * OPTIONS available in an <outputN> block are:
  * - out       = cons,prim,d,M1,M2,M3,E,B1c,B2c,B3c,ME,V1,V2,V3,P,S,cs2,G
- * - out_fmt   = bin,hst,tab,rst,vtk,pdf,pgm,ppm
+ * - out_fmt   = bin,hdf,hst,tab,rst,vtk,pdf,pgm,ppm,slice,proj,prof,spec
  * - dat_fmt   = format string used to write tabular output (e.g. %12.5e)
  * - dt        = problem time between outputs
  * - time      = time of next output (useful for restarts)
+ * - dcycle    = number of cycles between outputs, used instead of dt if > 0
+ * - cycle     = cycle of next output with dcycle (useful for restarts)
  * - id        = any string
  * - dmin/dmax = max/min applied to all outputs
  * - palette   = rainbow,jh_colors,idl1,idl2,step8,step32,heat
  * - x1,x2,x3  = range over which data is averaged or sliced; see parse_slice()
  * - usr_expr_flag = 1 for user-defined expression (defined in problem.c)
  * - level,domain = integer indices of level and domain to be output with SMR
+ * - compress  = none,lossless,lossy for bin and vtk dumps; none,lossless for
+ *               rst (requires --enable-compression, see compress.c) and for
+ *               hdf dumps (deflate filter of the HDF5 library)
+ * - rel_err   = maximum relative error of lossy compression (default 1.0e-4)
+ * - single_file = 1 to write one bin or vtk file per Domain shared by all
+ *               processes with MPI-IO, instead of one per process
+ * - chunk     = edge of the chunks of hdf dumps in cells (default 32), see
+ *               dump_hdf5.c (requires --enable-hdf5)
+ * - axis,pos,profile,x1c,x2c,x3c,rmax,nbin = options of the in-situ slice,
+ *               proj, prof and spec outputs, see output_insitu.c
  *   
  * EXAMPLE of an <outputN> block for a VTK dump:
  * - <output1>
@@ -44,6 +56,14 @@
  * - dmax    = 2.9
  * - palette = rainbow
  *
+ * EXAMPLE of an <outputN> block for the column density along x3 every 10
+ * cycles:
+ * - <output6>
+ * - out_fmt = proj
+ * - dcycle  = 10
+ * - out     = d
+ * - axis    = 3
+ *
  * EXAMPLE of an <outputN> block for restarts:
  * - <ouput3>
  * - out_fmt = rst
@@ -69,13 +89,19 @@
  * - data_output() -
  * - data_output_destruct()
  * - OutData1,2,3()   -
+ * - OutBounds3()     - range of cells of 3D outputs
+ * - OutRow()         - output expression along an x1-row of cells
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - expr_*()
+ * - row_*()          - built-in expressions evaluated for a row of cells
  * - get_expr()
+ * - getrowexpr()
+ * - out_bounds()
  * - free_output()
  * - parse_slice()
  * - getRGB()
+ * - out_due()        - tests whether an output is due, and sets the next one
  *
  * VARIABLE TYPE AND STRUCTURE DEFINITIONS: none
  *============================================================================*/
@@ -110,7 +136,10 @@ static int rst_flag = 0;            /* (0,1) -> Restart Outputs are (off,on) */
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
  *   expr_*
+ *   row_*
  *   get_expr
+ *   getrowexpr
+ *   out_bounds
  *   free_output
  *   parse_slice
  *   getRGB
@@ -144,9 +173,43 @@ extern Real expr_V2par(const GridS *pG, const int i, const int j, const int k);
 extern Real expr_V3par(const GridS *pG, const int i, const int j, const int k);
 int check_particle_binning(char *out);
 #endif
+static void row_d  (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_M1 (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_M2 (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_M3 (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+#ifndef BAROTROPIC
+static void row_E  (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+#endif
+#ifdef MHD
+static void row_B1c(const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_B2c(const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_B3c(const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_ME (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+#endif
+static void row_V1 (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_V2 (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_V3 (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
+static void row_P  (const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row);
 static ConsFun_t getexpr(const int n, const char *expr);
+static ConsRowFun_t getrowexpr(const char *expr);
+static void out_bounds(GridS *pgrid, int *il, int *iu, int *jl, int *ju,
+                       int *kl, int *ku);
 static void free_output(OutputS *pout);
 static void parse_slice(char *block, char *axname, Real *l, Real *u, int *flag);
+static int out_due(MeshS *pM, OutputS *pOut);
 float *getRGB(char *name);
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
@@ -157,7 +220,7 @@ float *getRGB(char *name);
 void init_output(MeshS *pM)
 {
   int i,j,outn,maxout;
-  char block[80], *fmt, defid[10];
+  char block[80], *fmt, defid[10], *cmp;
   OutputS new_out;
   int usr_expr_flag;
 
@@ -191,7 +254,14 @@ void init_output(MeshS *pM)
     new_out.t   = par_getd_def(block,"time",pM->time);
     new_out.num = par_geti_def(block,"num",0);
 
-    new_out.dt  = par_getd(block,"dt");
+/* Outputs are made every dt in time, or every dcycle cycles if dcycle > 0 */
+    new_out.dcycle = par_geti_def(block,"dcycle",0);
+    if (new_out.dcycle < 0)
+      ath_error("[init_output]: %s/dcycle must not be negative\n",block);
+    if (new_out.dcycle > 0)
+      new_out.ncycle = par_geti_def(block,"cycle",pM->nstep);
+    else
+      new_out.dt  = par_getd(block,"dt");
     new_out.n   = outn;
 
 /* level and domain number can be specified with SMR  */
@@ -214,6 +284,74 @@ void init_output(MeshS *pM)
 
     new_out.out = par_gets_def(block,"out","cons");
 
+/* compress: none, lossless or lossy compression of the binary data in bin and
+ * vtk dumps, and lossless compression of restarts (see compress.c) */
+
+    cmp = par_gets_def(block,"compress","none");
+    if (strcmp(cmp,"lossless") == 0) new_out.compress = 1;
+    else if (strcmp(cmp,"lossy") == 0) new_out.compress = 2;
+    else if (strcmp(cmp,"none") != 0)
+      ath_error("[init_output]: %s/compress=%s, must be none, lossless or lossy\n",
+        block,cmp);
+    free(cmp);
+    new_out.rel_err = par_getd_def(block,"rel_err",1.0e-4);
+    if (new_out.compress > 0 && new_out.out_fmt != NULL &&
+        strcmp(new_out.out_fmt,"hdf") == 0) {
+      if (new_out.compress == 2)
+        ath_error("[init_output]: %s/compress=lossy cannot be used for hdf dumps\n",
+          block);
+    }
+    else if (new_out.compress > 0) {
+#ifndef COMPRESSION
+      ath_error("[init_output]: %s/compress requires configure --enable-compression\n",
+        block);
+#endif
+      if (new_out.out_fmt == NULL ||
+          (strcmp(new_out.out_fmt,"rst") != 0 &&
+           ((strcmp(new_out.out_fmt,"bin") != 0 &&
+             strcmp(new_out.out_fmt,"vtk") != 0) ||
+            (strcmp(new_out.out,"cons") != 0 &&
+             strcmp(new_out.out,"prim") != 0))))
+        ath_error("[init_output]: %s/compress only works for bin and vtk dumps and restarts\n",
+          block);
+      if (new_out.compress == 2 && strcmp(new_out.out_fmt,"rst") == 0)
+        ath_error("[init_output]: %s/compress=lossy cannot be used for restarts\n",
+          block);
+      if (new_out.compress == 2 && new_out.rel_err <= 0.0)
+        ath_error("[init_output]: %s/rel_err must be positive\n",block);
+#ifdef MPIIO_RESTART
+      if (strcmp(new_out.out_fmt,"rst") == 0)
+        ath_error("[init_output]: %s/compress cannot be used with MPI-IO restarts\n",
+          block);
+#endif
+    }
+
+/* single_file: in MPI jobs, write one bin or vtk file for each Domain shared
+ * by all processes, rather than one per process (see shared_file.c).  It has
+ * no effect in serial jobs. */
+
+    new_out.single_file = par_geti_def(block,"single_file",0);
+    if (new_out.single_file != 0) {
+      if (new_out.out_fmt == NULL || (strcmp(new_out.out_fmt,"bin") != 0 &&
+                                      strcmp(new_out.out_fmt,"vtk") != 0))
+        ath_error("[init_output]: %s/single_file only works for bin and vtk outputs\n",
+          block);
+      if (new_out.compress > 0)
+        ath_error("[init_output]: %s/single_file cannot be used with compress\n",
+          block);
+#ifdef WRITE_GHOST_CELLS
+      ath_error("[init_output]: %s/single_file cannot be used with ghost cells\n",
+        block);
+#endif
+      new_out.single_file = 1;
+    }
+
+/* chunk: edge of the chunks that hdf dumps are stored and compressed in */
+
+    new_out.chunk = par_geti_def(block,"chunk",32);
+    if (new_out.chunk < 1)
+      ath_error("[init_output]: %s/chunk must be positive\n",block);
+
 #ifdef PARTICLES
     /* check input for particle binning (=1, default) or not (=0) */
     new_out.out_pargrid = par_geti_def(block,"pargrid",
@@ -240,7 +378,7 @@ Now use the default one.\n");
 /* First handle data dumps of all CONSERVED variables (out=cons) */
 
     if(strcmp(new_out.out,"cons") == 0){
-/* check for valid data dump: dump format = {bin, hst, tab, rst, vtk} */
+/* check for valid data dump: dump format = {bin, hdf, hst, tab, rst, vtk} */
       if(par_exist(block,"name")){
 	/* The output function is user defined - get its name */
 	char *name = par_gets(block,"name");
@@ -292,6 +430,18 @@ Now use the default one.\n");
 #endif
 	goto add_it;
       }
+      else if (strcmp(fmt,"hdf")==0){
+#ifdef HDF5_OUTPUT
+	new_out.out_fun = dump_hdf5;
+#ifdef PARTICLES
+        new_out.out_pargrid = 1; /* bin particles */
+#endif
+	goto add_it;
+#else
+	ath_error("[init_output]: %s/out_fmt=hdf requires configure --enable-hdf5\n",
+          block);
+#endif
+      }
 #ifdef PARTICLES
       else if (strcmp(fmt,"lis")==0){ /* dump particle list */
 	new_out.out_fun = dump_particle_binary; 
@@ -307,7 +457,7 @@ Now use the default one.\n");
 /* Next handle data dumps of all PRIMITIVE variables (out=prim) */
 
     if(strcmp(new_out.out,"prim") == 0){
-/* check for valid data dump: dump format = {bin, tab, vtk} */
+/* check for valid data dump: dump format = {bin, hdf, tab, vtk} */
       if(par_exist(block,"name")){
         /* The output function is user defined - get its name */
         char *name = par_gets(block,"name");
@@ -336,6 +486,15 @@ Now use the default one.\n");
         new_out.out_fun = dump_vtk;
         goto add_it;
       }
+      else if (strcmp(fmt,"hdf")==0){
+#ifdef HDF5_OUTPUT
+        new_out.out_fun = dump_hdf5;
+        goto add_it;
+#else
+        ath_error("[init_output]: %s/out_fmt=hdf requires configure --enable-hdf5\n",
+          block);
+#endif
+      }
       else{    /* Unknown data dump (fatal error) */
         ath_error("Unsupported dump mode for %s/out_fmt=%s for out=prim\n",
           block,fmt);
@@ -358,8 +517,10 @@ Now use the default one.\n");
 /* Get the expression function pointer */
     if(usr_expr_flag)
       new_out.expr = get_usr_expr(new_out.out);
-    else
+    else {
       new_out.expr = getexpr(outn, new_out.out);
+      new_out.row_expr = getrowexpr(new_out.out);
+    }
 
     if (new_out.expr == NULL) {
       ath_perr(-1,"Could not parse expression %s, skipping it\n",
@@ -442,10 +603,17 @@ Now use the default one.\n");
       new_out.out_fun = output_pgm;
     else if (strcmp(fmt,"ppm")==0)
       new_out.out_fun = output_ppm;
-    else if (strcmp(fmt,"vtk")==0)
+    else if (strcmp(fmt,"vtk")==0){
       new_out.out_fun = output_vtk;
+      if (new_out.single_file && new_out.ndim != 3)
+        ath_error("[init_output]: %s/single_file only works for 3D vtk outputs\n",
+          block);
+    }
     else if (strcmp(fmt,"tab")==0)
       new_out.out_fun = output_tab;
+    else if (strcmp(fmt,"slice")==0 || strcmp(fmt,"proj")==0 ||
+             strcmp(fmt,"prof")==0  || strcmp(fmt,"spec")==0)
+      init_insitu(pM,block,&new_out);
     else {
 /* unknown output format is fatal */
       free_output(&new_out);
@@ -493,20 +661,14 @@ void data_output(MeshS *pM, const int flag)
 
   for (n=0; n<out_count; n++) {
     dump_flag[n] = flag;
-    if (pM->time >= OutArray[n].t) {
-      OutArray[n].t += OutArray[n].dt;
-      dump_flag[n] = 1;
-    }
+    if (out_due(pM,&(OutArray[n]))) dump_flag[n] = 1;
   }
 
 /* Now check for restart dump, and make restart if dump_flag != 0 */
 
   if(rst_flag){
     dump_flag[out_count] = flag;
-    if(pM->time >= rst_out.t){
-      rst_out.t += rst_out.dt;
-      dump_flag[out_count] = 1;
-    }
+    if (out_due(pM,&rst_out)) dump_flag[out_count] = 1;
 
     if(dump_flag[out_count] != 0){
 /* Update the output numbers and times in the output blocks */
@@ -522,12 +684,16 @@ void data_output(MeshS *pM, const int flag)
 	    par_seti(block,"num","%d",OutArray[n].num,"Next Output Number");
           }
 	  par_setd(block,"time","%.15e",OutArray[n].t,"Next Output Time");
+          if (OutArray[n].dcycle > 0)
+            par_seti(block,"cycle","%d",OutArray[n].ncycle,"Next Output Cycle");
 	}
       }
 /* Now do the same for the restart output block */
       sprintf(block,"output%d",rst_out.n);
       par_seti(block,"num","%d",rst_out.num+1,"Next Output Number");
       par_setd(block,"time","%.15e",rst_out.t,"Next Output Time");
+      if (rst_out.dcycle > 0)
+        par_seti(block,"cycle","%d",rst_out.ncycle,"Next Output Cycle");
 
 /* Write the restart file */
       (*(rst_out.res_fun))(pM,&(rst_out));
@@ -571,6 +737,9 @@ void data_output_destruct(void)
   int ierr;
 #endif
 
+/* write history data still being reduced */
+  dump_history_flush();
+
   for (i=0; i<out_count; i++) {
 
 /* print the global min/max computed over the calculation */
@@ -626,43 +795,12 @@ void data_output_destruct(void)
 Real ***OutData3(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2, int *Nx3)
 {
   Real ***data;
-  int i,j,k,il,jl,kl,iu,ju,ku;
+  int j,k,il,jl,kl,iu,ju,ku;
 
   if (pout->ndim != 3) ath_error("[OutData3] <output%d> %s is %d-D, not 3-D\n",
     pout->n,pout->out, pout->ndim);
 
-#ifdef WRITE_GHOST_CELLS
-  if(pgrid->Nx[0] > 1){
-    il = pgrid->is - nghost;
-    iu = pgrid->ie + nghost;
-  } else{
-    il = pgrid->is;
-    iu = pgrid->ie;
-  }
-
-  if(pgrid->Nx[1] > 1){
-    jl = pgrid->js - nghost;
-    ju = pgrid->je + nghost;
-  } else{
-    jl = pgrid->js;
-    ju = pgrid->je;
-  }
-
-  if(pgrid->Nx[2] > 1){
-    kl = pgrid->ks - nghost;
-    ku = pgrid->ke + nghost;
-  } else{
-    kl = pgrid->ks;
-    ku = pgrid->ke;
-  }
-#else
-  il = pgrid->is;
-  iu = pgrid->ie;
-  jl = pgrid->js;
-  ju = pgrid->je;
-  kl = pgrid->ks;
-  ku = pgrid->ke;
-#endif
+  out_bounds(pgrid,&il,&iu,&jl,&ju,&kl,&ku);
   *Nx1 = iu-il+1;
   *Nx2 = ju-jl+1;
   *Nx3 = ku-kl+1;
@@ -671,11 +809,51 @@ Real ***OutData3(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2, int *Nx3)
   if (data == NULL) ath_error("[OutData3] Error creating 3D data array\n");
   for (k=0; k<*Nx3; k++)
     for (j=0; j<*Nx2; j++)
-      for (i=0; i<*Nx1; i++)
-        data[k][j][i] = (*pout->expr)(pgrid,i+il,j+jl,k+kl);
+      OutRow(pgrid,pout,il,iu,j+jl,k+kl,data[k][j]);
   return data;
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn void OutBounds3(GridS *pgrid, OutputS *pout, int *il, int *iu,
+ *                      int *jl, int *ju, int *kl, int *ku)
+ *  \brief Returns the range of cells in the 3D output data of the Grid, the
+ *   same as in the array created by OutData3().
+ *
+ * Used with OutRow() to write 3D outputs one x1-row at a time, without
+ * creating the whole array. */
+
+void OutBounds3(GridS *pgrid, OutputS *pout, int *il, int *iu, int *jl,
+                int *ju, int *kl, int *ku)
+{
+  if (pout->ndim != 3) ath_error("[OutBounds3] <output%d> %s is %d-D, not 3-D\n",
+    pout->n,pout->out, pout->ndim);
+  out_bounds(pgrid,il,iu,jl,ju,kl,ku);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void OutRow(GridS *pgrid, OutputS *pout, const int il, const int iu,
+ *                  const int j, const int k, Real *row)
+ *  \brief Computes the output expression in cells il..iu of the x1-row (j,k)
+ *   of the Grid, and stores it in row[0..iu-il].
+ *
+ * Uses the row version of built-in expressions, with no call per cell, and
+ * otherwise calls the expression (e.g. a user-defined one) in each cell. */
+
+void OutRow(GridS *pgrid, OutputS *pout, const int il, const int iu,
+            const int j, const int k, Real *row)
+{
+  int i;
+
+  if (pout->row_expr != NULL) {
+    (*pout->row_expr)(pgrid,il,iu,j,k,row);
+  } else {
+    for (i=il; i<=iu; i++)
+      row[i-il] = (*pout->expr)(pgrid,i,j,k);
+  }
+  return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn Real **OutData2(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2)
  *  \brief Creates 2D array of output data with two dimensions equal to Grid
@@ -688,7 +866,7 @@ Real ***OutData3(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2, int *Nx3)
 
 Real **OutData2(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2)
 {
-  Real **data;
+  Real **data,*row;
   Real factor,x1fc,x2fc,x3fc;
   int Nx3;
   int i,j,k,il,jl,kl,iu,ju,ku;
@@ -697,38 +875,7 @@ Real **OutData2(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2)
   if (pout->ndim != 2) ath_error("[OutData2] <output%d> %s is %d-D, not 2-D\n",
     pout->n,pout->out, pout->ndim);
 
-#ifdef WRITE_GHOST_CELLS
-  if(pgrid->Nx[0] > 1){
-    il = pgrid->is - nghost;
-    iu = pgrid->ie + nghost;
-  } else{
-    il = pgrid->is;
-    iu = pgrid->ie;
-  }
-
-  if(pgrid->Nx[1] > 1){
-    jl = pgrid->js - nghost;
-    ju = pgrid->je + nghost;
-  } else{
-    jl = pgrid->js;
-    ju = pgrid->je;
-  }
-
-  if(pgrid->Nx[2] > 1){
-    kl = pgrid->ks - nghost;
-    ku = pgrid->ke + nghost;
-  } else{
-    kl = pgrid->ks;
-    ku = pgrid->ke;
-  }
-#else
-  il = pgrid->is;
-  iu = pgrid->ie;
-  jl = pgrid->js;
-  ju = pgrid->je;
-  kl = pgrid->ks;
-  ku = pgrid->ke;
-#endif
+  out_bounds(pgrid,&il,&iu,&jl,&ju,&kl,&ku);
   *Nx1 = iu-il+1;
   *Nx2 = ju-jl+1;
   Nx3 = ku-kl+1;
@@ -739,9 +886,7 @@ Real **OutData2(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2)
     data = (Real**) calloc_2d_array(*Nx2,*Nx1,sizeof(Real));
     if (data == NULL) ath_error("[OutData2] Error creating 2D data array\n");
     for (j=0; j<*Nx2; j++) {
-      for (i=0; i<*Nx1; i++) {
-	data[j][i] = (*pout->expr)(pgrid,i+il,j+jl,kl);
-      }
+      OutRow(pgrid,pout,il,iu,j+jl,kl,data[j]);
     }
     return data;
   }
@@ -772,15 +917,17 @@ Real **OutData2(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2)
     /* allocate array and compute data */
     data = (Real**) calloc_2d_array(*Nx2,*Nx1,sizeof(Real));
     if (data == NULL) ath_error("[OutData2] Error creating 2D data array\n");
+    if ((row = (Real*)malloc(*Nx1*sizeof(Real))) == NULL)
+      ath_error("[OutData2] Error creating row array\n");
     factor = 1.0/(kend - kstart + 1);
     for (j=0; j<*Nx2; j++) {
-      for (i=0; i<*Nx1; i++) {
-	data[j][i] = 0.0;
-	for (k=kstart; k<=kend; k++)
-	  data[j][i] += (*pout->expr)(pgrid,i+il,j+jl,k);
-	data[j][i] *= factor;
+      for (k=kstart; k<=kend; k++) {
+        OutRow(pgrid,pout,il,iu,j+jl,k,row);
+        for (i=0; i<*Nx1; i++) data[j][i] += row[i];
       }
+      for (i=0; i<*Nx1; i++) data[j][i] *= factor;
     }
+    free(row);
 
 /* Nx3,Nx2,Nx1 -> Nx3,Nx1 */
   } else if (pout->reduce_x2 != 0) {
@@ -806,15 +953,17 @@ Real **OutData2(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2)
     /* allocate array and compute data */
     data = (Real**) calloc_2d_array(Nx3,*Nx1,sizeof(Real));
     if (data == NULL) ath_error("[OutData2] Error creating 2D data array\n");
+    if ((row = (Real*)malloc(*Nx1*sizeof(Real))) == NULL)
+      ath_error("[OutData2] Error creating row array\n");
     factor = 1.0/(jend - jstart + 1);
     for (k=0; k<Nx3; k++) {
-      for (i=0; i<*Nx1; i++) {
-	data[k][i] = 0.0;
-	for (j=jstart; j<=jend; j++)
-	  data[k][i] += (*pout->expr)(pgrid,i+il,j,k+kl);
-	data[k][i] *= factor;
+      for (j=jstart; j<=jend; j++) {
+        OutRow(pgrid,pout,il,iu,j,k+kl,row);
+        for (i=0; i<*Nx1; i++) data[k][i] += row[i];
       }
+      for (i=0; i<*Nx1; i++) data[k][i] *= factor;
     }
+    free(row);
     *Nx2 = Nx3; /* return second dimension of array created */
 
 /* Nx3,Nx2,Nx1 -> Nx3,Nx2 */
@@ -842,15 +991,19 @@ Real **OutData2(GridS *pgrid, OutputS *pout, int *Nx1, int *Nx2)
 
     data = (Real**) calloc_2d_array(Nx3,*Nx2,sizeof(Real));
     if (data == NULL) ath_error("[OutData2] Error creating 2D data array\n");
+    if ((row = (Real*)malloc((iend-istart+1)*sizeof(Real))) == NULL)
+      ath_error("[OutData2] Error creating row array\n");
     factor = 1.0/(iend - istart + 1);
     for (k=0; k<Nx3; k++) {
       for (j=0; j<*Nx2; j++) {
+        OutRow(pgrid,pout,istart,iend,j+jl,k+kl,row);
 	data[k][j] = 0.0;
-	for (i=istart; i<=iend; i++)
-	  data[k][j] += (*pout->expr)(pgrid,i,j+jl,k+kl);
+	for (i=0; i<=iend-istart; i++)
+	  data[k][j] += row[i];
 	data[k][j] *= factor;
       }
     }
+    free(row);
     *Nx1 = *Nx2;
     *Nx2 = Nx3; /* return dimensions of array created */
   } else
@@ -879,38 +1032,7 @@ Real *OutData1(GridS *pgrid, OutputS *pout, int *Nx1)
   if (pout->ndim != 1) ath_error("[OutData1] <output%d> %s is %d-D, not 1-D\n",
     pout->n,pout->out, pout->ndim);
 
-#ifdef WRITE_GHOST_CELLS
-  if(pgrid->Nx[0] > 1){
-    il = pgrid->is - nghost;
-    iu = pgrid->ie + nghost;
-  } else{
-    il = pgrid->is;
-    iu = pgrid->ie;
-  }
-
-  if(pgrid->Nx[1] > 1){
-    jl = pgrid->js - nghost;
-    ju = pgrid->je + nghost;
-  } else{
-    jl = pgrid->js;
-    ju = pgrid->je;
-  }
-
-  if(pgrid->Nx[2] > 1){
-    kl = pgrid->ks - nghost;
-    ku = pgrid->ke + nghost;
-  } else{
-    kl = pgrid->ks;
-    ku = pgrid->ke;
-  }
-#else
-  il = pgrid->is;
-  iu = pgrid->ie;
-  jl = pgrid->js;
-  ju = pgrid->je;
-  kl = pgrid->ks;
-  ku = pgrid->ke;
-#endif
+  out_bounds(pgrid,&il,&iu,&jl,&ju,&kl,&ku);
   *Nx1 = iu-il+1;
   Nx2 = ju-jl+1;
   Nx3 = ku-kl+1;
@@ -920,9 +1042,7 @@ Real *OutData1(GridS *pgrid, OutputS *pout, int *Nx1)
   if (pgrid->Nx[1] == 1) {
     data = (Real*) calloc_1d_array(*Nx1,sizeof(Real));
     if (data == NULL) ath_error("[OutData1] Error creating 1D data array\n");
-    for (i=0; i<*Nx1; i++) {
-      data[i] = (*pout->expr)(pgrid,i+il,jl,kl);
-    }
+    OutRow(pgrid,pout,il,iu,jl,kl,data);
     return data;
   }
 
@@ -1102,28 +1222,28 @@ Real *OutData1(GridS *pgrid, OutputS *pout, int *Nx1)
 /*! \fn Real expr_d(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Density */
 Real expr_d(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,d);
 }
 /*! \fn Real expr_M1(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 1-component of momentum */ 
 Real expr_M1(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M1;
+  return GRID_U(pG,k,j,i,M1);
 }
 /*! \fn Real expr_M2(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 2-component of momentum */
 Real expr_M2(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M2;
+  return GRID_U(pG,k,j,i,M2);
 }
 /*! \fn Real expr_M3(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 3-component of momentum */
 Real expr_M3(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M3;
+  return GRID_U(pG,k,j,i,M3);
 }
 #ifndef BAROTROPIC
 /*! \fn Real expr_E(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Total energy */
 Real expr_E(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].E;
+  return GRID_U(pG,k,j,i,E);
 }
 #endif
 
@@ -1134,24 +1254,24 @@ Real expr_E(const GridS *pG, const int i, const int j, const int k) {
 /*! \fn Real expr_B1c(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 1-component of cell-centered B-field */
 Real expr_B1c(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].B1c;
+  return GRID_U(pG,k,j,i,B1c);
 }
 /*! \fn Real expr_B2c(const GridS *pG, const int i, const int j, const int k) 
  *  \brief 2-component of cell-centered B-field */
 Real expr_B2c(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].B2c;
+  return GRID_U(pG,k,j,i,B2c);
 }
 /*! \fn Real expr_B3c(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 3-component of cell-centered B-field */
 Real expr_B3c(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].B3c;
+  return GRID_U(pG,k,j,i,B3c);
 }
 /*! \fn Real expr_ME(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Magnetic field energy */
 Real expr_ME(const GridS *pG, const int i, const int j, const int k) {
-  return 0.5*(pG->U[k][j][i].B1c*pG->U[k][j][i].B1c + 
-	      pG->U[k][j][i].B2c*pG->U[k][j][i].B2c + 
-	      pG->U[k][j][i].B3c*pG->U[k][j][i].B3c);
+  return 0.5*(GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c) + 
+	      GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c) + 
+	      GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,B3c));
 }
 #endif
 
@@ -1161,26 +1281,27 @@ Real expr_ME(const GridS *pG, const int i, const int j, const int k) {
 /*! \fn Real expr_V1(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 1-velocity */
 Real expr_V1(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M1/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d);
 }
 /*! \fn Real expr_V2(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 2-velocity */
 Real expr_V2(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M2/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d);
 }
 /*! \fn Real expr_V3(const GridS *pG, const int i, const int j, const int k)  
  *  \brief 3-velocity */
 Real expr_V3(const GridS *pG, const int i, const int j, const int k) {
-  return pG->U[k][j][i].M3/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
 }
 
 /*! \fn Real expr_P(const GridS *pG, const int i, const int j, const int k) 
  *  \brief Pressure */
 Real expr_P(const GridS *pG, const int i, const int j, const int k) {
 #ifdef ISOTHERMAL
-  return  pG->U[k][j][i].d*Iso_csound2;
+  return  GRID_U(pG,k,j,i,d)*Iso_csound2;
 #else
-  ConsS *gp = &(pG->U[k][j][i]);
+  const ConsS Uc = GET_GRID_U(pG,k,j,i);
+  const ConsS *gp = &Uc;
   return Gamma_1*(gp->E 
 #ifdef MHD
 		  - 0.5*(gp->B1c*gp->B1c + gp->B2c*gp->B2c + gp->B3c*gp->B3c)
@@ -1189,6 +1310,136 @@ Real expr_P(const GridS *pG, const int i, const int j, const int k) {
 #endif /* ISOTHERMAL */
 }
 
+/*--------------------------------------------------------------------------- */
+/* row_*: the expressions above for cells il..iu of the x1-row (j,k), stored in
+ * row[0..iu-il].  Simple loops over contiguous cells (with --enable-soa) that
+ * the compiler can vectorize, and give the same values as expr_*. */
+
+/*! \fn static void row_d(const GridS *pG, const int il, const int iu,
+ *                        const int j, const int k, Real *row)
+ *  \brief Density */
+static void row_d(const GridS *pG, const int il, const int iu, const int j,
+                  const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,d);
+}
+/*! \fn static void row_M1(const GridS *pG, const int il, const int iu,
+ *                         const int j, const int k, Real *row)
+ *  \brief 1-component of momentum */
+static void row_M1(const GridS *pG, const int il, const int iu, const int j,
+                   const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,M1);
+}
+/*! \fn static void row_M2(const GridS *pG, const int il, const int iu,
+ *                         const int j, const int k, Real *row)
+ *  \brief 2-component of momentum */
+static void row_M2(const GridS *pG, const int il, const int iu, const int j,
+                   const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,M2);
+}
+/*! \fn static void row_M3(const GridS *pG, const int il, const int iu,
+ *                         const int j, const int k, Real *row)
+ *  \brief 3-component of momentum */
+static void row_M3(const GridS *pG, const int il, const int iu, const int j,
+                   const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,M3);
+}
+#ifndef BAROTROPIC
+/*! \fn static void row_E(const GridS *pG, const int il, const int iu,
+ *                        const int j, const int k, Real *row)
+ *  \brief Total energy */
+static void row_E(const GridS *pG, const int il, const int iu, const int j,
+                  const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,E);
+}
+#endif
+#ifdef MHD
+/*! \fn static void row_B1c(const GridS *pG, const int il, const int iu,
+ *                          const int j, const int k, Real *row)
+ *  \brief 1-component of cell-centered B-field */
+static void row_B1c(const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,B1c);
+}
+/*! \fn static void row_B2c(const GridS *pG, const int il, const int iu,
+ *                          const int j, const int k, Real *row)
+ *  \brief 2-component of cell-centered B-field */
+static void row_B2c(const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,B2c);
+}
+/*! \fn static void row_B3c(const GridS *pG, const int il, const int iu,
+ *                          const int j, const int k, Real *row)
+ *  \brief 3-component of cell-centered B-field */
+static void row_B3c(const GridS *pG, const int il, const int iu, const int j,
+                    const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,B3c);
+}
+/*! \fn static void row_ME(const GridS *pG, const int il, const int iu,
+ *                         const int j, const int k, Real *row)
+ *  \brief Magnetic field energy */
+static void row_ME(const GridS *pG, const int il, const int iu, const int j,
+                   const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++)
+    row[i-il] = 0.5*(GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c) +
+                     GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c) +
+                     GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,B3c));
+}
+#endif
+/*! \fn static void row_V1(const GridS *pG, const int il, const int iu,
+ *                         const int j, const int k, Real *row)
+ *  \brief 1-velocity */
+static void row_V1(const GridS *pG, const int il, const int iu, const int j,
+                   const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d);
+}
+/*! \fn static void row_V2(const GridS *pG, const int il, const int iu,
+ *                         const int j, const int k, Real *row)
+ *  \brief 2-velocity */
+static void row_V2(const GridS *pG, const int il, const int iu, const int j,
+                   const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d);
+}
+/*! \fn static void row_V3(const GridS *pG, const int il, const int iu,
+ *                         const int j, const int k, Real *row)
+ *  \brief 3-velocity */
+static void row_V3(const GridS *pG, const int il, const int iu, const int j,
+                   const int k, Real *row) {
+  int i;
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
+}
+/*! \fn static void row_P(const GridS *pG, const int il, const int iu,
+ *                        const int j, const int k, Real *row)
+ *  \brief Pressure */
+static void row_P(const GridS *pG, const int il, const int iu, const int j,
+                  const int k, Real *row) {
+  int i;
+#ifdef ISOTHERMAL
+  for (i=il; i<=iu; i++) row[i-il] = GRID_U(pG,k,j,i,d)*Iso_csound2;
+#else
+  for (i=il; i<=iu; i++)
+    row[i-il] = Gamma_1*(GRID_U(pG,k,j,i,E)
+#ifdef MHD
+      - 0.5*(GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c) +
+             GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c) +
+             GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,B3c))
+#endif /* MHD */
+      - 0.5*(GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M1) +
+             GRID_U(pG,k,j,i,M2)*GRID_U(pG,k,j,i,M2) +
+             GRID_U(pG,k,j,i,M3)*GRID_U(pG,k,j,i,M3))/GRID_U(pG,k,j,i,d));
+#endif /* ISOTHERMAL */
+}
+
 /*--------------------------------------------------------------------------- */
 /*! \fn Real expr_cs2(const GridS *pG, const int i, const int j, const int k)
  *  \brief Sound speed squared  */
@@ -1196,7 +1447,8 @@ Real expr_P(const GridS *pG, const int i, const int j, const int k) {
 #ifdef ADIABATIC
 Real expr_cs2(const GridS *pG, const int i, const int j, const int k)
 {
-  ConsS *gp = &(pG->U[k][j][i]);
+  const ConsS Uc = GET_GRID_U(pG,k,j,i);
+  const ConsS *gp = &Uc;
   return (Gamma*Gamma_1*(gp->E 
 #ifdef MHD
 	  - 0.5*(gp->B1c*gp->B1c + gp->B2c*gp->B2c + gp->B3c*gp->B3c)
@@ -1212,7 +1464,8 @@ Real expr_cs2(const GridS *pG, const int i, const int j, const int k)
 #ifdef ADIABATIC
 Real expr_S(const GridS *pG, const int i, const int j, const int k)
 {
-  ConsS *gp = &(pG->U[k][j][i]);
+  const ConsS Uc = GET_GRID_U(pG,k,j,i);
+  const ConsS *gp = &Uc;
   Real P = Gamma_1*(gp->E 
 #ifdef MHD
 		   - 0.5*(gp->B1c*gp->B1c + gp->B2c*gp->B2c + gp->B3c*gp->B3c)
@@ -1230,7 +1483,9 @@ Real expr_S(const GridS *pG, const int i, const int j, const int k)
 Real expr_G(const GridS *pG, const int i, const int j, const int k)
 {
   PrimS W;
-  W = Cons_to_Prim(&(pG->U[k][j][i]));
+  ConsS Ucell;
+  Ucell = GET_GRID_U(pG,k,j,i);
+  W = Cons_to_Prim(&Ucell);
   return 1.0/sqrt(1.0 - (SQR(W.V1)+SQR(W.V2)+SQR(W.V3)));
 }
 #endif /* SPECIAL_RELATIVITY */
@@ -1336,6 +1591,79 @@ static ConsFun_t getexpr(const int n, const char *expr)
   }
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static ConsRowFun_t getrowexpr(const char *expr)
+ *  \brief Return a function pointer for the row version of a built-in
+ *   expression, or NULL if there is none (OutRow() then calls the expression
+ *   returned by getexpr() in each cell). */
+
+static ConsRowFun_t getrowexpr(const char *expr)
+{
+  if (strcmp(expr,"d")==0)
+    return row_d;
+  else if (strcmp(expr,"M1")==0)
+    return row_M1;
+  else if (strcmp(expr,"M2")==0)
+    return row_M2;
+  else if (strcmp(expr,"M3")==0)
+    return row_M3;
+#ifndef BAROTROPIC
+  else if (strcmp(expr,"E")==0)
+    return row_E;
+#endif /* BAROTROPIC */
+#ifdef MHD
+  else if (strcmp(expr,"B1c")==0)
+    return row_B1c;
+  else if (strcmp(expr,"B2c")==0)
+    return row_B2c;
+  else if (strcmp(expr,"B3c")==0)
+    return row_B3c;
+  else if (strcmp(expr,"ME")==0)
+    return row_ME;
+#endif
+  else if (strcmp(expr,"V1")==0)
+    return row_V1;
+  else if (strcmp(expr,"V2")==0)
+    return row_V2;
+  else if (strcmp(expr,"V3")==0)
+    return row_V3;
+  else if (strcmp(expr,"P")==0)
+    return row_P;
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void out_bounds(GridS *pgrid, int *il, int *iu, int *jl,
+ *                             int *ju, int *kl, int *ku)
+ *  \brief Range of cells of the Grid in outputs, including the ghost cells
+ *   in each direction with more than one cell with WRITE_GHOST_CELLS */
+
+static void out_bounds(GridS *pgrid, int *il, int *iu, int *jl, int *ju,
+                       int *kl, int *ku)
+{
+  *il = pgrid->is;
+  *iu = pgrid->ie;
+  *jl = pgrid->js;
+  *ju = pgrid->je;
+  *kl = pgrid->ks;
+  *ku = pgrid->ke;
+#ifdef WRITE_GHOST_CELLS
+  if(pgrid->Nx[0] > 1){
+    *il -= nghost;
+    *iu += nghost;
+  }
+  if(pgrid->Nx[1] > 1){
+    *jl -= nghost;
+    *ju += nghost;
+  }
+  if(pgrid->Nx[2] > 1){
+    *kl -= nghost;
+    *ku += nghost;
+  }
+#endif
+  return;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn static void free_output(OutputS *pOut)
  *  \brief free memory associated with Output structure.  
@@ -1407,6 +1735,23 @@ static void parse_slice(char *block, char *axname, Real *l, Real *u, int *flag)
 
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn static int out_due(MeshS *pM, OutputS *pOut)
+ *  \brief Returns 1 if output pOut is due, i.e. its next time (or cycle, if
+ *   dcycle > 0) has been reached, and then sets its next time (or cycle). */
+
+static int out_due(MeshS *pM, OutputS *pOut)
+{
+  if (pOut->dcycle > 0) {
+    if (pM->nstep < pOut->ncycle) return 0;
+    pOut->ncycle += pOut->dcycle;
+  } else {
+    if (pM->time < pOut->t) return 0;
+    pOut->t += pOut->dt;
+  }
+  return 1;
+}
+
 /*----------------------------------------------------------------------------*/
 /*! \fn float *getRGB(char *name)
  *  \brief function for accessing palettes stored stored in structure RGB.
@@ -0,0 +1,560 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file output_insitu.c
+ *  \brief Reduced-size analysis products of one variable computed during the
+ *   run: slices, projections, profiles and power spectra.
+ *
+ * PURPOSE: Reduced-size analysis products of one variable computed during the
+ *   run, so that full 3D dumps need not be written and post-processed:
+ *   - slice: 2D slice through a Domain normal to one axis
+ *   - proj:  integral of the variable along one axis (e.g. column density
+ *            for out=d)
+ *   - prof:  1D profile of the mean of the variable in bins of spherical
+ *            radius r, cylindrical radius R or azimuth phi about a centre
+ *   - spec:  power spectrum of the variable, summed over shells in |k|
+ *            (requires configure --enable-fft)
+ *   The variable is any single-variable expression (out = d, M1, ..., or a
+ *   user expression with usr_expr_flag = 1).  Fully MPI enabled: each Grid
+ *   computes its part of the product, which is summed over the Grids of the
+ *   Domain on the first process in Comm_Domain, and only that process writes
+ *   the output.  With SMR, products are made for all levels and domains,
+ *   unless level and domain are specified in the <outputN> block.  Products
+ *   can be made every dcycle cycles rather than every dt in time (see
+ *   output.c).
+ *
+ *   OPTIONS in the <outputN> block, besides those of all outputs:
+ *   - out_fmt = slice, proj, prof or spec (also the extension of the files)
+ *   - axis    = 1, 2 or 3: axis normal to slices and projections (default 3)
+ *   - pos     = position of slices along axis (default: centre of the root
+ *               Domain); the slice is through the cells that contain it
+ *   - profile = r, R or phi for profiles (default r).  R and phi are about
+ *               the axis parallel to x3 through the centre.
+ *   - x1c,x2c,x3c = centre of profiles (default: centre of the root Domain)
+ *   - rmax    = outer radius of profiles; for profiles in phi, only cells
+ *               with R < rmax are included (default: the largest distance
+ *               from the centre to a corner of the root Domain)
+ *   - nbin    = number of bins of profiles (default 64) and spectra (default
+ *               enough for all wavenumbers in the Domain)
+ *
+ *   Each output is written to a small binary file, in the byte order of the
+ *   machine and with x fastest:
+ *     int    axis, nx, ny     axis of slices and projections (0 otherwise),
+ *                             size of the data (ny = 1 for prof and spec)
+ *     double time, pos        time; position of slices (0 otherwise)
+ *     double x0, dx, y0, dy   centre of the first cell/bin, and spacing, of
+ *                             the data in x and y.  For slices and
+ *                             projections x and y are the two axes other
+ *                             than axis, in increasing order.
+ *     float  data[ny][nx]
+ *     float  count[nx]        prof and spec only: number of cells or modes
+ *                             in each bin
+ *   For profiles, data is the mean of the variable in each bin, and for
+ *   spectra the sum over the modes in each shell of |q_k|^2, with q_k the
+ *   discrete Fourier transform of the variable divided by the number of
+ *   cells, so that the sum over all shells is the mean of the square of the
+ *   variable.  Shells are centred on k = n*dk, with dk = 2*pi/L and L the
+ *   largest size of the Domain.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - init_insitu()  - reads options and sets the output function
+ * - output_slice() - slices
+ * - output_proj()  - projections
+ * - output_prof()  - profiles
+ * - output_spec()  - power spectra
+ *============================================================================*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   insitu_domain() - returns the Domain for the next product, or NULL
+ *   reduce_sum()    - sums an array over the Grids of a Domain on its root
+ *   plane_axes()    - the two axes normal to the axis of the output
+ *   plane_sum()     - adds q*w of cells to a plane, or q of a slice
+ *   insitu_write()  - writes one product to a file
+ *============================================================================*/
+
+static DomainS *insitu_domain(MeshS *pM, OutputS *pOut, int *nl, int *nd);
+static int reduce_sum(DomainS *pD, double *buf, const int n);
+static void plane_axes(const int axis, int *p, int *q);
+static void plane_sum(DomainS *pD, OutputS *pOut, const int slice, double *buf);
+static void insitu_write(MeshS *pM, OutputS *pOut, const int nl, const int nd,
+                         const int nx, const int ny, const double *hdr,
+                         const double *data, const double *count);
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void init_insitu(MeshS *pM, char *block, OutputS *pOut)
+ *  \brief Reads the options of in-situ output block, with out_fmt = slice,
+ *   proj, prof or spec, and sets the output function of pOut */
+
+void init_insitu(MeshS *pM, char *block, OutputS *pOut)
+{
+  char *prof;
+  Real d, r2;
+  int i,n;
+
+  pOut->axis = par_geti_def(block,"axis",3);
+  if (pOut->axis < 1 || pOut->axis > 3)
+    ath_error("[init_insitu]: %s/axis must be 1, 2 or 3\n",block);
+  n = pOut->axis - 1;
+  pOut->pos = par_getd_def(block,"pos",0.5*(pM->RootMinX[n]+pM->RootMaxX[n]));
+
+  pOut->nbin = par_geti_def(block,"nbin",0);
+  if (pOut->nbin < 0)
+    ath_error("[init_insitu]: %s/nbin must be positive\n",block);
+
+  if (strcmp(pOut->out_fmt,"slice") == 0) {
+    pOut->out_fun = output_slice;
+  }
+  else if (strcmp(pOut->out_fmt,"proj") == 0) {
+    pOut->out_fun = output_proj;
+  }
+  else if (strcmp(pOut->out_fmt,"prof") == 0) {
+#ifdef CYLINDRICAL
+    ath_error("[init_insitu]: %s/out_fmt=prof needs Cartesian coordinates\n",
+              block);
+#endif
+    prof = par_gets_def(block,"profile","r");
+    if      (strcmp(prof,"r") == 0)   pOut->prof = 0;
+    else if (strcmp(prof,"R") == 0)   pOut->prof = 1;
+    else if (strcmp(prof,"phi") == 0) pOut->prof = 2;
+    else
+      ath_error("[init_insitu]: %s/profile=%s, must be r, R or phi\n",
+                block,prof);
+    free(prof);
+
+    pOut->xc[0] = par_getd_def(block,"x1c",0.5*(pM->RootMinX[0]+pM->RootMaxX[0]));
+    pOut->xc[1] = par_getd_def(block,"x2c",0.5*(pM->RootMinX[1]+pM->RootMaxX[1]));
+    pOut->xc[2] = par_getd_def(block,"x3c",0.5*(pM->RootMinX[2]+pM->RootMaxX[2]));
+
+/* By default include every cell: distance to the farthest corner */
+    r2 = 0.0;
+    for (i=0; i<3; i++) {
+      if (i == 2 && pOut->prof != 0) break;
+      if (pM->Nx[i] == 1) continue;
+      d = MAX(fabs(pM->RootMinX[i]-pOut->xc[i]),
+              fabs(pM->RootMaxX[i]-pOut->xc[i]));
+      r2 += d*d;
+    }
+    pOut->rmax = par_getd_def(block,"rmax",sqrt(r2));
+    if (pOut->rmax <= 0.0)
+      ath_error("[init_insitu]: %s/rmax must be positive\n",block);
+    if (pOut->nbin == 0) pOut->nbin = 64;
+    pOut->out_fun = output_prof;
+  }
+  else if (strcmp(pOut->out_fmt,"spec") == 0) {
+#ifdef FFT_ENABLED
+    if (pM->Nx[2] == 1)
+      ath_error("[init_insitu]: %s/out_fmt=spec only works in 3D\n",block);
+    pOut->out_fun = output_spec;
+#else
+    ath_error("[init_insitu]: %s/out_fmt=spec requires configure --enable-fft\n",
+              block);
+#endif
+  }
+  else {
+    ath_error("[init_insitu]: %s/out_fmt=%s is not an in-situ output\n",
+              block,pOut->out_fmt);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void output_slice(MeshS *pM, OutputS *pOut)
+ *  \brief Writes a 2D slice normal to pOut->axis through pOut->pos in each
+ *   Domain that contains it */
+
+void output_slice(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD;
+  double *buf, hdr[6];
+  int nl=0,nd=-1,n,p,q,ax = pOut->axis - 1;
+
+  plane_axes(pOut->axis,&p,&q);
+  while ((pD = insitu_domain(pM,pOut,&nl,&nd)) != NULL) {
+    if (pOut->pos < pD->MinX[ax] || pOut->pos > pD->MaxX[ax]) continue;
+    n = (int)((pOut->pos - pD->MinX[ax])/pD->dx[ax]);
+    n = MIN(n, pD->Nx[ax]-1);
+
+    buf = (double*)calloc((size_t)pD->Nx[p]*pD->Nx[q],sizeof(double));
+    if (buf == NULL) ath_error("[output_slice]: malloc failed\n");
+    plane_sum(pD,pOut,n,buf);
+
+    if (reduce_sum(pD,buf,pD->Nx[p]*pD->Nx[q])) {
+      hdr[0] = pD->MinX[ax] + (n + 0.5)*pD->dx[ax];
+      hdr[1] = pD->MinX[p] + 0.5*pD->dx[p];
+      hdr[2] = pD->dx[p];
+      hdr[3] = pD->MinX[q] + 0.5*pD->dx[q];
+      hdr[4] = pD->dx[q];
+      insitu_write(pM,pOut,nl,nd,pD->Nx[p],pD->Nx[q],hdr,buf,NULL);
+    }
+    free(buf);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void output_proj(MeshS *pM, OutputS *pOut)
+ *  \brief Writes the integral of the variable along pOut->axis over each
+ *   Domain */
+
+void output_proj(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD;
+  double *buf, hdr[6];
+  int nl=0,nd=-1,p,q;
+
+  plane_axes(pOut->axis,&p,&q);
+  while ((pD = insitu_domain(pM,pOut,&nl,&nd)) != NULL) {
+    buf = (double*)calloc((size_t)pD->Nx[p]*pD->Nx[q],sizeof(double));
+    if (buf == NULL) ath_error("[output_proj]: malloc failed\n");
+    plane_sum(pD,pOut,-1,buf);
+
+    if (reduce_sum(pD,buf,pD->Nx[p]*pD->Nx[q])) {
+      hdr[0] = 0.0;
+      hdr[1] = pD->MinX[p] + 0.5*pD->dx[p];
+      hdr[2] = pD->dx[p];
+      hdr[3] = pD->MinX[q] + 0.5*pD->dx[q];
+      hdr[4] = pD->dx[q];
+      insitu_write(pM,pOut,nl,nd,pD->Nx[p],pD->Nx[q],hdr,buf,NULL);
+    }
+    free(buf);
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void output_prof(MeshS *pM, OutputS *pOut)
+ *  \brief Writes the mean of the variable in bins of r, R or phi about the
+ *   centre pOut->xc of each Domain */
+
+void output_prof(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD;
+  GridS *pG;
+  Real *row,x1,x2,x3;
+  double *buf, hdr[6], dx1, dx2, dx3, R2, s, scl;
+  int nl=0,nd=-1,i,j,k,n,nbin = pOut->nbin;
+
+  if (pOut->prof == 2) scl = (double)nbin/(2.0*PI);
+  else                 scl = (double)nbin/pOut->rmax;
+
+  while ((pD = insitu_domain(pM,pOut,&nl,&nd)) != NULL) {
+    pG = pD->Grid;
+    buf = (double*)calloc(2*nbin,sizeof(double));
+    row = (Real*)calloc_1d_array(pG->Nx[0],sizeof(Real));
+    if (buf == NULL || row == NULL) ath_error("[output_prof]: malloc failed\n");
+
+/* Sum of the variable in buf[0..nbin-1], and number of cells in the rest */
+
+    for (k=pG->ks; k<=pG->ke; k++) {
+      for (j=pG->js; j<=pG->je; j++) {
+        OutRow(pG,pOut,pG->is,pG->ie,j,k,row);
+        for (i=pG->is; i<=pG->ie; i++) {
+          cc_pos(pG,i,j,k,&x1,&x2,&x3);
+          dx1 = x1 - pOut->xc[0];
+          dx2 = (pG->Nx[1] > 1 ? x2 - pOut->xc[1] : 0.0);
+          dx3 = (pG->Nx[2] > 1 ? x3 - pOut->xc[2] : 0.0);
+          R2 = dx1*dx1 + dx2*dx2;
+          if (pOut->prof == 0) {
+            s = sqrt(R2 + dx3*dx3);
+          } else {
+            s = sqrt(R2);
+          }
+          if (s >= pOut->rmax) continue;
+          if (pOut->prof == 2) s = atan2(dx2,dx1) + PI;
+          n = MIN((int)(s*scl), nbin-1);
+          buf[n] += row[i-pG->is];
+          buf[nbin+n] += 1.0;
+        }
+      }
+    }
+
+    if (reduce_sum(pD,buf,2*nbin)) {
+      for (n=0; n<nbin; n++)
+        if (buf[nbin+n] > 0.0) buf[n] /= buf[nbin+n];
+      hdr[0] = 0.0;
+      hdr[1] = (pOut->prof == 2 ? -PI : 0.0) + 0.5/scl;
+      hdr[2] = 1.0/scl;
+      hdr[3] = hdr[4] = 0.0;
+      insitu_write(pM,pOut,nl,nd,nbin,1,hdr,buf,&(buf[nbin]));
+    }
+    free_1d_array(row);
+    free(buf);
+  }
+
+  return;
+}
+
+#ifdef FFT_ENABLED
+/*----------------------------------------------------------------------------*/
+/*! \fn void output_spec(MeshS *pM, OutputS *pOut)
+ *  \brief Writes the power spectrum of the variable in each Domain, summed
+ *   over shells in |k|.  The forward FFT plan of the Domain is made on the
+ *   first call, and kept in pD->fplan3d for later outputs. */
+
+void output_spec(MeshS *pM, OutputS *pOut)
+{
+  DomainS *pD;
+  GridS *pG;
+  ath_fft_data *work;
+  Real *row;
+  double *buf, hdr[6], L[3], kf[3], kx, ky, kz, dk, nmax, scl;
+  int nl=0,nd=-1,i,j,k,n,d,ig,jg,kg,nbin;
+
+  while ((pD = insitu_domain(pM,pOut,&nl,&nd)) != NULL) {
+    pG = pD->Grid;
+
+/* Shells of width dk, with bins up to the largest |k| by default */
+
+    nmax = 0.0;
+    for (d=0; d<3; d++) L[d] = pD->MaxX[d] - pD->MinX[d];
+    dk = 2.0*PI/MAX(L[0],MAX(L[1],L[2]));
+    for (d=0; d<3; d++) {
+      kf[d] = 2.0*PI/L[d];
+      nmax += pow(0.5*pD->Nx[d]*kf[d]/dk, 2);
+    }
+    nbin = (pOut->nbin > 0 ? pOut->nbin : (int)(sqrt(nmax) + 0.5) + 1);
+
+    if (pD->fplan3d == NULL)
+      pD->fplan3d = ath_3d_fft_quick_plan(pD, NULL, ATH_FFT_FORWARD);
+    work = ath_3d_fft_malloc(pD->fplan3d);
+    buf = (double*)calloc(2*nbin,sizeof(double));
+    row = (Real*)calloc_1d_array(pG->Nx[0],sizeof(Real));
+    if (work == NULL || buf == NULL || row == NULL)
+      ath_error("[output_spec]: malloc failed\n");
+
+    for (k=pG->ks; k<=pG->ke; k++) {
+      for (j=pG->js; j<=pG->je; j++) {
+        OutRow(pG,pOut,pG->is,pG->ie,j,k,row);
+        for (i=pG->is; i<=pG->ie; i++) {
+          n = F3DI(i-pG->is,j-pG->js,k-pG->ks,pG->Nx[0],pG->Nx[1],pG->Nx[2]);
+          work[n][0] = row[i-pG->is];
+          work[n][1] = 0.0;
+        }
+      }
+    }
+    ath_3d_fft(pD->fplan3d, work);
+
+/* The transform has the decomposition of the Grids, so each process bins
+ * the modes of its own block of wavenumbers */
+
+    scl = 1.0/((double)pD->fplan3d->gcnt*(double)pD->fplan3d->gcnt);
+    for (k=0; k<pG->Nx[2]; k++) {
+      kg = k + pG->Disp[2] - pD->Disp[2];
+      kz = kf[2]*(kg <= pD->Nx[2]/2 ? kg : kg - pD->Nx[2]);
+      for (j=0; j<pG->Nx[1]; j++) {
+        jg = j + pG->Disp[1] - pD->Disp[1];
+        ky = kf[1]*(jg <= pD->Nx[1]/2 ? jg : jg - pD->Nx[1]);
+        for (i=0; i<pG->Nx[0]; i++) {
+          ig = i + pG->Disp[0] - pD->Disp[0];
+          kx = kf[0]*(ig <= pD->Nx[0]/2 ? ig : ig - pD->Nx[0]);
+          n = (int)(sqrt(kx*kx + ky*ky + kz*kz)/dk + 0.5);
+          if (n >= nbin) continue;
+          d = F3DI(i,j,k,pG->Nx[0],pG->Nx[1],pG->Nx[2]);
+          buf[n] += scl*(work[d][0]*work[d][0] + work[d][1]*work[d][1]);
+          buf[nbin+n] += 1.0;
+        }
+      }
+    }
+
+    if (reduce_sum(pD,buf,2*nbin)) {
+      hdr[0] = 0.0;
+      hdr[1] = 0.0;
+      hdr[2] = dk;
+      hdr[3] = hdr[4] = 0.0;
+      insitu_write(pM,pOut,nl,nd,nbin,1,hdr,buf,&(buf[nbin]));
+    }
+    free_1d_array(row);
+    free(buf);
+    ath_3d_fft_free(work);
+  }
+
+  return;
+}
+#endif /* FFT_ENABLED */
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static DomainS *insitu_domain(MeshS *pM, OutputS *pOut, int *nl,
+ *                                    int *nd)
+ *  \brief Returns the Domain after [*nl][*nd] with a Grid on this process,
+ *   and the level and domain asked for in pOut, or NULL if there is none.
+ *   Start with *nl=0, *nd=-1. */
+
+static DomainS *insitu_domain(MeshS *pM, OutputS *pOut, int *nl, int *nd)
+{
+  for (; *nl<(pM->NLevels); (*nl)++, *nd=-1){
+    for ((*nd)++; *nd<(pM->DomainsPerLevel[*nl]); (*nd)++){
+      if (pM->Domain[*nl][*nd].Grid != NULL &&
+          (pOut->nlevel == -1 || pOut->nlevel == *nl) &&
+          (pOut->ndomain == -1 || pOut->ndomain == *nd))
+        return &(pM->Domain[*nl][*nd]);
+    }
+  }
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int reduce_sum(DomainS *pD, double *buf, const int n)
+ *  \brief Sums buf[0..n-1] over all Grids in the Domain, into buf on the
+ *   first process in Comm_Domain.  Returns 1 on that process, which writes
+ *   the output, and 0 on the others. */
+
+static int reduce_sum(DomainS *pD, double *buf, const int n)
+{
+#ifdef MPI_PARALLEL
+  int ierr, myID_Comm_Domain;
+
+  ierr = MPI_Comm_rank(pD->Comm_Domain, &myID_Comm_Domain);
+  if (myID_Comm_Domain == 0) {
+    ierr = MPI_Reduce(MPI_IN_PLACE,buf,n,MPI_DOUBLE,MPI_SUM,0,pD->Comm_Domain);
+    return 1;
+  }
+  ierr = MPI_Reduce(buf,NULL,n,MPI_DOUBLE,MPI_SUM,0,pD->Comm_Domain);
+  return 0;
+#else
+  return 1;
+#endif /* MPI_PARALLEL */
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void plane_axes(const int axis, int *p, int *q)
+ *  \brief Sets p < q to the indices [0,1,2] of the two axes other than
+ *   axis [1,2,3] */
+
+static void plane_axes(const int axis, int *p, int *q)
+{
+  *p = (axis == 1 ? 1 : 0);
+  *q = (axis == 3 ? 1 : 2);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void plane_sum(DomainS *pD, OutputS *pOut, const int slice,
+ *                            double *buf)
+ *  \brief Adds the variable in the cells of the Grid to buf, the plane of the
+ *   Domain normal to pOut->axis.  If slice >= 0, only cells of the Domain
+ *   with index slice along the axis are added; otherwise all cells are,
+ *   times their width along the axis, so buf is the integral along it. */
+
+static void plane_sum(DomainS *pD, OutputS *pOut, const int slice, double *buf)
+{
+  GridS *pG = pD->Grid;
+  Real *row, w;
+  int i,j,k,p,q,ax = pOut->axis - 1,il,iu,jl,ju,kl,ku,g[3],lo[3],hi[3];
+
+  plane_axes(pOut->axis,&p,&q);
+  lo[0] = il = pG->is;  hi[0] = iu = pG->ie;
+  lo[1] = jl = pG->js;  hi[1] = ju = pG->je;
+  lo[2] = kl = pG->ks;  hi[2] = ku = pG->ke;
+
+  if (slice >= 0) {
+    w = 1.0;
+    i = slice - (pG->Disp[ax] - pD->Disp[ax]) + lo[ax];
+    if (i < lo[ax] || i > hi[ax]) return;
+    if (ax == 0) il = iu = i;
+    if (ax == 1) jl = ju = i;
+    if (ax == 2) kl = ku = i;
+  } else {
+    w = (ax == 0 ? pG->dx1 : (ax == 1 ? pG->dx2 : pG->dx3));
+  }
+
+  row = (Real*)calloc_1d_array(iu-il+1,sizeof(Real));
+  if (row == NULL) ath_error("[plane_sum]: malloc failed\n");
+
+  for (k=kl; k<=ku; k++) {
+    g[2] = k - pG->ks + pG->Disp[2] - pD->Disp[2];
+    for (j=jl; j<=ju; j++) {
+      g[1] = j - pG->js + pG->Disp[1] - pD->Disp[1];
+      OutRow(pG,pOut,il,iu,j,k,row);
+      for (i=il; i<=iu; i++) {
+        g[0] = i - pG->is + pG->Disp[0] - pD->Disp[0];
+        buf[g[q]*pD->Nx[p] + g[p]] += w*row[i-il];
+      }
+    }
+  }
+
+  free_1d_array(row);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void insitu_write(MeshS *pM, OutputS *pOut, const int nl,
+ *                               const int nd, const int nx, const int ny,
+ *                               const double *hdr, const double *data,
+ *                               const double *count)
+ *  \brief Writes data[ny][nx] of Domain nd on level nl, and count[nx] if it
+ *   is not NULL, with the header pos,x0,dx,y0,dy in hdr[0..4] */
+
+static void insitu_write(MeshS *pM, OutputS *pOut, const int nl, const int nd,
+                         const int nx, const int ny, const double *hdr,
+                         const double *data, const double *count)
+{
+  FILE *pfile;
+  char *fname,*plev=NULL,*pdom=NULL,*pdir=NULL;
+  char levstr[20],domstr[20],dirstr[20];
+  float *fdata;
+  double time = pM->time;
+  int n,axis;
+
+/* Create filename and open file.  Files are always written in lev#
+ * directories of root (rank=0) process, as for pdf outputs. */
+  if (nl>0) {
+    plev = &levstr[0];
+    sprintf(plev,"lev%d",nl);
+    pdir = &dirstr[0];
+#ifdef MPI_PARALLEL
+    sprintf(pdir,"../lev%d",nl);
+#else
+    sprintf(pdir,"lev%d",nl);
+#endif
+  }
+  if (nd>0) {
+    pdom = &domstr[0];
+    sprintf(pdom,"dom%d",nd);
+  }
+
+  fname = ath_fname(pdir,pM->outfilename,plev,pdom,num_digit,
+    pOut->num,pOut->id,pOut->out_fmt);
+  if (fname == NULL) {
+    ath_error("[insitu_write]: Unable to create filename\n");
+  }
+  if ((pfile = fopen(fname,"wb")) == NULL) {
+    ath_error("[insitu_write]: Unable to open %s\n",fname);
+  }
+
+  axis = (count == NULL ? pOut->axis : 0);
+  fwrite(&axis,sizeof(int),1,pfile);
+  fwrite(&nx,sizeof(int),1,pfile);
+  fwrite(&ny,sizeof(int),1,pfile);
+  fwrite(&time,sizeof(double),1,pfile);
+  fwrite(hdr,sizeof(double),5,pfile);
+
+  if ((fdata = (float*)malloc((size_t)nx*sizeof(float))) == NULL)
+    ath_error("[insitu_write]: malloc failed\n");
+  for (n=0; n<nx*ny; n++) {
+    fdata[n % nx] = (float)data[n];
+    if (n % nx == nx-1) fwrite(fdata,sizeof(float),nx,pfile);
+  }
+  if (count != NULL) {
+    for (n=0; n<nx; n++) fdata[n] = (float)count[n];
+    fwrite(fdata,sizeof(float),nx,pfile);
+  }
+
+  if (fclose(pfile) != 0) ath_error("[insitu_write]: Error writing %s\n",fname);
+  free(fdata);
+  free(fname);
+  return;
+}
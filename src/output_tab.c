@@ -9,7 +9,8 @@
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - output_tab() - opens file and calls appropriate 1D/2D/3D output function
- *     Uses OutData1,2,3() to extract appropriate section to be output.
+ *     Uses OutData1,2() to extract appropriate section to be output, and
+ *     OutRow() to compute 3D data one x1-row at a time as it is written.
  *
  * PRIVATE FUNCTION PROTOTYPES:
  * - output_tab_1d() - write tab file for 1D slice of data
@@ -216,11 +217,11 @@ void output_tab_2d(MeshS *pM, OutputS *pOut, int nl, int nd)
 void output_tab_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
 {
   GridS *pGrid=pM->Domain[nl][nd].Grid;
-  int i,j,k,nx1,nx2,nx3;
+  int i,j,k,il,iu,jl,ju,kl,ku;
   FILE *pFile;
   char fmt[80],*fname,*plev=NULL,*pdom=NULL;
   char levstr[8],domstr[8];
-  Real ***data, dmin, dmax, xworld, yworld, zworld;
+  Real *row, dmin, dmax, xworld, yworld, zworld;
 
 /* Add a white space to the format, setup format for integer zone columns */
   if(pOut->dat_fmt == NULL){
@@ -230,9 +231,10 @@ void output_tab_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
     sprintf(fmt," %s",pOut->dat_fmt);
   }
 
-/* compute 3D array of data */
-  data = OutData3(pGrid,pOut,&nx1,&nx2,&nx3);
-  minmax3(data,nx3,nx2,nx1,&dmin,&dmax);
+/* data is computed one x1-row at a time as it is written */
+  OutBounds3(pGrid,pOut,&il,&iu,&jl,&ju,&kl,&ku);
+  if((row = (Real *)malloc((iu-il+1)*sizeof(Real))) == NULL)
+    ath_error("[output_tab]: malloc failed for temporary array\n");
 
 /* construct output filename */
   if (nl>0) {
@@ -257,17 +259,22 @@ void output_tab_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
   free(fname);
 
 /* write data */
-  for (k=0; k<nx3; k++) {
-    for (j=0; j<nx2; j++) {
-      for (i=0; i<nx1; i++) {
+  dmin = dmax = 0.0;
+  for (k=0; k<=ku-kl; k++) {
+    for (j=0; j<=ju-jl; j++) {
+      OutRow(pGrid,pOut,il,iu,j+jl,k+kl,row);
+      if (k == 0 && j == 0) dmin = dmax = row[0];
+      for (i=0; i<=iu-il; i++) {
         xworld = (float)(i);  /* just i-index for now */
         yworld = (float)(j);  /* just j-index for now */
         zworld = (float)(k);  /* just k-index for now */
         fprintf(pFile,fmt,xworld);
         fprintf(pFile,fmt,yworld);
         fprintf(pFile,fmt,zworld);
-        fprintf(pFile,fmt,data[k][j][i]);
+        fprintf(pFile,fmt,row[i]);
         fprintf(pFile,"\n");
+        dmin = MIN(dmin,row[i]);
+        dmax = MAX(dmax,row[i]);
       }
     }
   }
@@ -282,5 +289,5 @@ void output_tab_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
   }
 
   fclose(pFile);
-  free_3d_array(data); /* Free the memory we malloc'd */
+  free(row); /* Free the memory we malloc'd */
 }
@@ -5,7 +5,11 @@
  *
  * PURPOSE: Function to write a single variable in VTK "legacy" format.  With
  *   SMR, dumps are made for all levels and domains, unless nlevel and ndomain
- *   are specified in <output> block.
+ *   are specified in <output> block.  With single_file = 1 in an MPI job, 3D
+ *   data is written to one file for each Domain shared by all processes (see
+ *   shared_file.c).
+ *   3D data is computed one x1-row at a time with OutRow() as it is written,
+ *   so no 3D array of it is allocated.
  *
  * CONTAINS PUBLIC FUNCTIONS: 
  * - output_vtk() - writes VTK file (single variable).
@@ -23,12 +27,16 @@
 
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES:
- *   output_vtk_2d() - write vtk file for 2D data
- *   output_vtk_3d() - write vtk file for 3D data
+ *   output_vtk_2d()        - write vtk file for 2D data
+ *   output_vtk_3d()        - write vtk file for 3D data
+ *   output_vtk_3d_shared() - write 3D data of Domain to a shared file
  *============================================================================*/
 
 static void output_vtk_2d(MeshS *pM, OutputS *pOut, int nl, int nd);
 static void output_vtk_3d(MeshS *pM, OutputS *pOut, int nl, int nd);
+#ifdef MPI_PARALLEL
+static void output_vtk_3d_shared(MeshS *pM, OutputS *pOut, int nl, int nd);
+#endif
 
 /*=========================== PUBLIC FUNCTIONS ===============================*/
 /*----------------------------------------------------------------------------*/
@@ -185,14 +193,25 @@ static void output_vtk_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
   char levstr[8],domstr[8];
 /* Upper and Lower bounds on i,j,k for data dump */
   int big_end = ath_big_endian();
-  int nx1,nx2,nx3,i,j,k;
+  int nx1,nx2,nx3,i,j,k,il,iu,jl,ju,kl,ku;
   Real dmin, dmax;
-  Real ***data3d=NULL; /* 3D array of data to be dumped */
+  Real *row;           /* one x1-row of data to be dumped */
   float *data;         /* data actually output has to be floats */
   double x1, x2, x3;
 
-/* Allocate memory for and compute 3D array of data values */
-  data3d = OutData3(pGrid,pOut,&nx1,&nx2,&nx3);
+#ifdef MPI_PARALLEL
+  if (pOut->single_file) {
+    output_vtk_3d_shared(pM, pOut, nl, nd);
+    return;
+  }
+#endif
+
+/* Range of cells to be dumped.  The data is computed and written one x1-row
+ * at a time, so no 3D array of it is needed */
+  OutBounds3(pGrid,pOut,&il,&iu,&jl,&ju,&kl,&ku);
+  nx1 = iu-il+1;
+  nx2 = ju-jl+1;
+  nx3 = ku-kl+1;
 
 /* construct output filename.  pOut->id will either be name of variable,
  * if 'id=...' was included in <ouput> block, or 'outN' where N is number of
@@ -217,12 +236,7 @@ static void output_vtk_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
   }
   free(fname);
 
-/* Store the global min / max, for output at end of run */
-  minmax3(data3d,nx3,nx2,nx1,&dmin,&dmax);
-  pOut->gmin = MIN(dmin,pOut->gmin);
-  pOut->gmax = MAX(dmax,pOut->gmax);
-
-/* Allocate memory for temporary array of floats */
+/* Allocate memory for temporary arrays of one row */
 
   x1 = pGrid->MinX[0];
   x2 = pGrid->MinX[1];
@@ -231,6 +245,8 @@ static void output_vtk_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
      ath_error("[output_vtk]: malloc failed for temporary array\n");
      return;
   }
+  if((row = (Real *)malloc(nx1*sizeof(Real))) == NULL)
+     ath_error("[output_vtk]: malloc failed for temporary array\n");
 
 /* There are five basic parts to the VTK "legacy" file format.  */
 /*  1. Write file version and identifier */
@@ -261,20 +277,96 @@ static void output_vtk_3d(MeshS *pM, OutputS *pOut, int nl, int nd)
 
   fprintf(pfile,"SCALARS %s float\n", pOut->id);
   fprintf(pfile,"LOOKUP_TABLE default\n");
-  for (k=0; k<nx3; k++) {
-    for (j=0; j<nx2; j++) {
+  dmin = dmax = 0.0;
+  for (k=kl; k<=ku; k++) {
+    for (j=jl; j<=ju; j++) {
+      OutRow(pGrid,pOut,il,iu,j,k,row);
+      if (k == kl && j == jl) dmin = dmax = row[0];
       for (i=0; i<nx1; i++) {
-        data[i] = (float)data3d[k][j][i];
+        dmin = MIN(dmin,row[i]);
+        dmax = MAX(dmax,row[i]);
+        data[i] = (float)row[i];
       }
       if(!big_end) ath_bswap(data,sizeof(float),nx1);
       fwrite(data,sizeof(float),(size_t)nx1,pfile);
     }
   }
 
+/* Store the global min / max, for output at end of run */
+  pOut->gmin = MIN(dmin,pOut->gmin);
+  pOut->gmax = MAX(dmax,pOut->gmax);
+
 /* close file and free memory */
 
   fclose(pfile);
   free(data);
-  free_3d_array(data3d);
+  free(row);
+  return;
+}
+
+#ifdef MPI_PARALLEL
+/*----------------------------------------------------------------------------*/
+/*! \fn static void output_vtk_3d_shared(MeshS *pM, OutputS *pOut, int nl,
+ *                                       int nd)
+ *  \brief Writes 3D data of Domain nd on level nl to one file shared by all
+ *   processes with a Grid in it */
+
+static void output_vtk_3d_shared(MeshS *pM, OutputS *pOut, int nl, int nd)
+{
+  DomainS *pD = &(pM->Domain[nl][nd]);
+  GridS *pGrid = pD->Grid;
+  SFileS *sf;
+  int nx1,i,j,k,il,iu,jl,ju,kl,ku,m=0;
+  Real dmin, dmax;
+  Real *row;           /* one x1-row of data to be dumped */
+  float *data;         /* data actually output has to be floats */
+
+/* Compute the data one x1-row at a time straight into the float array that
+ * is written, with no 3D array of Reals */
+  OutBounds3(pGrid,pOut,&il,&iu,&jl,&ju,&kl,&ku);
+  nx1 = iu-il+1;
+  if((data = (float *)malloc(nx1*(ju-jl+1)*(ku-kl+1)*sizeof(float))) == NULL)
+    ath_error("[output_vtk]: malloc failed for temporary array\n");
+  if((row = (Real *)malloc(nx1*sizeof(Real))) == NULL)
+    ath_error("[output_vtk]: malloc failed for temporary array\n");
+  dmin = dmax = 0.0;
+  for (k=kl; k<=ku; k++) {
+    for (j=jl; j<=ju; j++) {
+      OutRow(pGrid,pOut,il,iu,j,k,row);
+      if (k == kl && j == jl) dmin = dmax = row[0];
+      for (i=0; i<nx1; i++) {
+        dmin = MIN(dmin,row[i]);
+        dmax = MAX(dmax,row[i]);
+        data[m++] = (float)row[i];
+      }
+    }
+  }
+  free(row);
+  if(!ath_big_endian()) ath_bswap(data,sizeof(float),m);
+
+/* Store the global min / max, for output at end of run */
+  pOut->gmin = MIN(dmin,pOut->gmin);
+  pOut->gmax = MAX(dmax,pOut->gmax);
+
+/* Header, with the size and origin of the Domain, then the data */
+
+  sf = ath_sfopen(pM,nl,nd,pOut,pOut->id,"vtk");
+  ath_sfprintf(sf,"# vtk DataFile Version 2.0\n");
+  ath_sfprintf(sf,"Really cool Athena data at time= %e, level= %i, domain= %i\n",
+    pGrid->time,nl,nd);
+  ath_sfprintf(sf,"BINARY\n");
+  ath_sfprintf(sf,"DATASET STRUCTURED_POINTS\n");
+  ath_sfprintf(sf,"DIMENSIONS %d %d %d\n",pD->Nx[0]+1,pD->Nx[1]+1,
+    pD->Nx[2]+1);
+  ath_sfprintf(sf,"ORIGIN %e %e %e \n",pD->MinX[0],pD->MinX[1],pD->MinX[2]);
+  ath_sfprintf(sf,"SPACING %e %e %e \n",pGrid->dx1,pGrid->dx2,pGrid->dx3);
+  ath_sfprintf(sf,"CELL_DATA %d \n",pD->Nx[0]*pD->Nx[1]*pD->Nx[2]);
+  ath_sfprintf(sf,"SCALARS %s float\n", pOut->id);
+  ath_sfprintf(sf,"LOOKUP_TABLE default\n");
+  ath_sfwrite_grid(data,(int)sizeof(float),sf);
+  ath_sfclose(sf);
+
+  free(data);
   return;
 }
+#endif /* MPI_PARALLEL */
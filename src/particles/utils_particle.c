@@ -479,21 +479,21 @@ void get_gasinfo(GridS *pG)
       for (i=ilp; i<=iup; i++)
       {
         pq = &(pG->Coup[k][j][i]);
-        rho1 = 1.0/(pG->U[k][j][i].d);
+        rho1 = 1.0/(GRID_U(pG,k,j,i,d));
 
-        pq->grid_d  = pG->U[k][j][i].d;
-        pq->grid_v1 = pG->U[k][j][i].M1 * rho1;
-        pq->grid_v2 = pG->U[k][j][i].M2 * rho1;
-        pq->grid_v3 = pG->U[k][j][i].M3 * rho1;
+        pq->grid_d  = GRID_U(pG,k,j,i,d);
+        pq->grid_v1 = GRID_U(pG,k,j,i,M1) * rho1;
+        pq->grid_v2 = GRID_U(pG,k,j,i,M2) * rho1;
+        pq->grid_v3 = GRID_U(pG,k,j,i,M3) * rho1;
 
 #ifndef ISOTHERMAL
   #ifndef BAROTROPIC
         /* E = P/(gamma-1) + rho*v^2/2 + B^2/2 */
-        P = pG->U[k][j][i].E - 0.5*pG->U[k][j][i].d*(SQR(pq->grid_v1) \
+        P = GRID_U(pG,k,j,i,E) - 0.5*GRID_U(pG,k,j,i,d)*(SQR(pq->grid_v1) \
              + SQR(pq->grid_v2) + SQR(pq->grid_v3));
     #ifdef MHD
-        P = P - 0.5*(SQR(pG->U[k][j][i].B1c)+SQR(pG->U[k][j][i].B2c)
-                                            +SQR(pG->U[k][j][i].B3c));
+        P = P - 0.5*(SQR(GRID_U(pG,k,j,i,B1c))+SQR(GRID_U(pG,k,j,i,B2c))
+                                            +SQR(GRID_U(pG,k,j,i,B3c)));
     #endif /* MHD */
         P = MAX(Gamma_1*P, TINY_NUMBER);
         pq->grid_cs = sqrt(Gamma*P*rho1);
@@ -95,21 +95,21 @@ void problem(DomainS *pDomain)
 /*  Preshock flow */
       cc_pos(pGrid, i, j, k, &x1, &x2, &x3);
       if (x1 < xshock) {
-        pGrid->U[k][j][i].d  = dr;
-        pGrid->U[k][j][i].M1 = dr*ur;
-        pGrid->U[k][j][i].M2 = 0.0;
-        pGrid->U[k][j][i].M3 = 0.0;
+        GRID_U(pGrid,k,j,i,d)  = dr;
+        GRID_U(pGrid,k,j,i,M1) = dr*ur;
+        GRID_U(pGrid,k,j,i,M2) = 0.0;
+        GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef ADIABATIC
-        pGrid->U[k][j][i].E = pr/Gamma_1 + 0.5*dr*ur*ur;
+        GRID_U(pGrid,k,j,i,E) = pr/Gamma_1 + 0.5*dr*ur*ur;
 #endif
       } else {
 /*  Postshock flow */
-        pGrid->U[k][j][i].d  = dl;
-        pGrid->U[k][j][i].M1 = dl*ul;
-        pGrid->U[k][j][i].M2 = 0.0;
-        pGrid->U[k][j][i].M3 = 0.0;
+        GRID_U(pGrid,k,j,i,d)  = dl;
+        GRID_U(pGrid,k,j,i,M1) = dl*ul;
+        GRID_U(pGrid,k,j,i,M2) = 0.0;
+        GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef ADIABATIC
-        pGrid->U[k][j][i].E = pl/Gamma_1 + 0.5*dl*ul*ul;
+        GRID_U(pGrid,k,j,i,E) = pl/Gamma_1 + 0.5*dl*ul*ul;
 #endif
       }
     }
@@ -123,9 +123,9 @@ void problem(DomainS *pDomain)
       if (x1 < xshock) {
         index = div((i+j+k),2);
         if (index.rem == 0) {
-          pGrid->U[k][j][i].M2 = amp;
+          GRID_U(pGrid,k,j,i,M2) = amp;
         } else {
-          pGrid->U[k][j][i].M2 = -amp;
+          GRID_U(pGrid,k,j,i,M2) = -amp;
         }
       }
     }
@@ -140,20 +140,20 @@ void problem(DomainS *pDomain)
           r2  = sqrt(SQR(x1-x10)+SQR(x2-x20)+SQR(x3-x30));          
           switch (iwhich) {
           case 0: {
-            pGrid->U[k][j][i].d = d0 +
+            GRID_U(pGrid,k,j,i,d) = d0 +
               0.5*(d1-d0)*(1.0-tanh((r2-radius)/(sig0*radius)));
             break;
           }
           case 1: {
-            pGrid->U[k][j][i].d = d1 +
+            GRID_U(pGrid,k,j,i,d) = d1 +
              (0.75*d0/(PI*radius*radius*radius))*pow((1.0+SQR(r2/radius)),-2.5);
             break;
           }
 	  default: ath_error("[collapse3d]: invalid iwhich\n");
           }
-          pGrid->U[k][j][i].M1 = 0.0;
-          pGrid->U[k][j][i].M2 = 0.0;
-          pGrid->U[k][j][i].M3 = 0.0;
+          GRID_U(pGrid,k,j,i,M1) = 0.0;
+          GRID_U(pGrid,k,j,i,M2) = 0.0;
+          GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef MHD
           pGrid->B1i[k][j][i]  = bx0;
           pGrid->B2i[k][j][i]  = by0;
@@ -195,18 +195,18 @@ void problem(DomainS *pDomain)
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
 #ifdef MHD
-          pGrid->U[k][j][i].B1c= 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-          pGrid->U[k][j][i].B2c= 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
-          pGrid->U[k][j][i].B3c= 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+          GRID_U(pGrid,k,j,i,B1c)= 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+          GRID_U(pGrid,k,j,i,B2c)= 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+          GRID_U(pGrid,k,j,i,B3c)= 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
 #endif
 #ifndef ISOTHERMAL
-          pGrid->U[k][j][i].E = p0/Gamma_1
+          GRID_U(pGrid,k,j,i,E) = p0/Gamma_1
 #ifdef MHD
-              + 0.5*(SQR(pGrid->U[k][j][i].B1c) + SQR(pGrid->U[k][j][i].B2c)
-                   + SQR(pGrid->U[k][j][i].B3c))
+              + 0.5*(SQR(GRID_U(pGrid,k,j,i,B1c)) + SQR(GRID_U(pGrid,k,j,i,B2c))
+                   + SQR(GRID_U(pGrid,k,j,i,B3c)))
 #endif
-              + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-                   + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+              + 0.5*(SQR(GRID_U(pGrid,k,j,i,M1)) + SQR(GRID_U(pGrid,k,j,i,M2))
+                   + SQR(GRID_U(pGrid,k,j,i,M3)))/GRID_U(pGrid,k,j,i,d);
 #endif
         }
       }
@@ -183,14 +183,14 @@ void problem(DomainS *pDomain)
   for (j=js; j<=je; j++) {
   for (i=is; i<=ie; i++) {
 
-    pGrid->U[k][j][i].d  = Soln[i].d;
-    pGrid->U[k][j][i].M1 = d0 * v0;
-    pGrid->U[k][j][i].M2 = Soln[i].M2;
-    pGrid->U[k][j][i].M3 = 0.0;
-
-    pGrid->U[k][j][i].B1c = pGrid->B1i[k][j][i] = Bx0;
-    pGrid->U[k][j][i].B2c = pGrid->B2i[k][j][i] = Soln[i].B2c;
-    pGrid->U[k][j][i].B3c = pGrid->B3i[k][j][i] = 0.0;
+    GRID_U(pGrid,k,j,i,d)  = Soln[i].d;
+    GRID_U(pGrid,k,j,i,M1) = d0 * v0;
+    GRID_U(pGrid,k,j,i,M2) = Soln[i].M2;
+    GRID_U(pGrid,k,j,i,M3) = 0.0;
+
+    GRID_U(pGrid,k,j,i,B1c) = pGrid->B1i[k][j][i] = Bx0;
+    GRID_U(pGrid,k,j,i,B2c) = pGrid->B2i[k][j][i] = Soln[i].B2c;
+    GRID_U(pGrid,k,j,i,B3c) = pGrid->B3i[k][j][i] = 0.0;
   }}}
 
   return;
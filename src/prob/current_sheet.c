@@ -52,16 +52,16 @@ void problem(DomainS *pDomain)
         cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
         W.Vx = uflow*cos(PI*x2);
         U1d = Prim1D_to_Cons1D(&(W), &Bx);
-        pGrid->U[k][j][i].d  = U1d.d;
-        pGrid->U[k][j][i].M1 = U1d.Mx; 
-        pGrid->U[k][j][i].M2 = U1d.My;
-        pGrid->U[k][j][i].M3 = U1d.Mz;
+        GRID_U(pGrid,k,j,i,d)  = U1d.d;
+        GRID_U(pGrid,k,j,i,M1) = U1d.Mx; 
+        GRID_U(pGrid,k,j,i,M2) = U1d.My;
+        GRID_U(pGrid,k,j,i,M3) = U1d.Mz;
 #ifndef ISOTHERMAL
-        pGrid->U[k][j][i].E = U1d.E;
+        GRID_U(pGrid,k,j,i,E) = U1d.E;
 #endif
-        pGrid->U[k][j][i].B1c = Bx;
-        pGrid->U[k][j][i].B2c = U1d.By;
-        pGrid->U[k][j][i].B3c = U1d.Bz;
+        GRID_U(pGrid,k,j,i,B1c) = Bx;
+        GRID_U(pGrid,k,j,i,B2c) = U1d.By;
+        GRID_U(pGrid,k,j,i,B3c) = U1d.Bz;
         pGrid->B1i[k][j][i] = Bx;
         pGrid->B2i[k][j][i] = U1d.By;
         pGrid->B3i[k][j][i] = U1d.Bz;
@@ -70,7 +70,7 @@ void problem(DomainS *pDomain)
         if (k == ke && ke > ks) pGrid->B3i[k+1][j][i] = U1d.Bz;
         if (x1 > 0.5 && x1 < 1.5) {
           pGrid->B2i[k][j][i] = -U1d.By;
-          pGrid->U[k][j][i].B2c = -U1d.By;
+          GRID_U(pGrid,k,j,i,B2c) = -U1d.By;
           if (j == je) pGrid->B2i[k][j+1][i] = -U1d.By;
         }
       }
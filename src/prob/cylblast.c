@@ -92,18 +92,18 @@ void problem(DomainS *pDomain)
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
         x2i = x2 - 0.5*pG->dx2;
 
-        pG->U[k][j][i].d  = rho0;
-        pG->U[k][j][i].M1 = 0.0;
-        pG->U[k][j][i].M2 = pG->U[k][j][i].d*x1*omega0;
-        pG->U[k][j][i].M3 = 0.0;
+        GRID_U(pG,k,j,i,d)  = rho0;
+        GRID_U(pG,k,j,i,M1) = 0.0;
+        GRID_U(pG,k,j,i,M2) = GRID_U(pG,k,j,i,d)*x1*omega0;
+        GRID_U(pG,k,j,i,M3) = 0.0;
 #ifdef MHD
         /* Set up a planar magnetic field in the x-y (r-phi) plane */
         pG->B1i[k][j][i]   = b0*(cos(angle)*cos(x2)+sin(angle)*sin(x2)); 
         pG->B2i[k][j][i]   = b0*(-cos(angle)*sin(x2i)+sin(angle)*cos(x2i));
         pG->B3i[k][j][i]   = 0.0;
-        pG->U[k][j][i].B1c = b0*(cos(angle)*cos(x2)+sin(angle)*sin(x2));
-        pG->U[k][j][i].B2c = b0*(-cos(angle)*sin(x2)+sin(angle)*cos(x2));
-        pG->U[k][j][i].B3c = 0.0;
+        GRID_U(pG,k,j,i,B1c) = b0*(cos(angle)*cos(x2)+sin(angle)*sin(x2));
+        GRID_U(pG,k,j,i,B2c) = b0*(-cos(angle)*sin(x2)+sin(angle)*cos(x2));
+        GRID_U(pG,k,j,i,B3c) = 0.0;
 #endif
         /* Cartesian position of cell center */
         x = x1*cos(x2);
@@ -118,10 +118,10 @@ void problem(DomainS *pDomain)
         }
         Emag = 0.0;
 #ifdef MHD
-        Emag = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
+        Emag = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
 #endif
-        Ekin = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
-        pG->U[k][j][i].E = Eint + Emag + Ekin;
+        Ekin = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
+        GRID_U(pG,k,j,i,E) = Eint + Emag + Ekin;
 #endif /* ISOTHERMAL */
       }
     }
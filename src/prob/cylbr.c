@@ -80,19 +80,19 @@ void problem(DomainS *pDomain)
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
         psi = a*x2 - phi0;
 
-        pG->U[k][j][i].d   = rho0*(1.0 + SQR(sin(psi)));
-        pG->U[k][j][i].M2  = pG->U[k][j][i].d*omega0*x1;
-        pG->U[k][j][i].M3  = pG->U[k][j][i].d*vz0;
-        pG->U[k][j][i].B1c = br0*(cos(psi))/x1;
+        GRID_U(pG,k,j,i,d)   = rho0*(1.0 + SQR(sin(psi)));
+        GRID_U(pG,k,j,i,M2)  = GRID_U(pG,k,j,i,d)*omega0*x1;
+        GRID_U(pG,k,j,i,M3)  = GRID_U(pG,k,j,i,d)*vz0;
+        GRID_U(pG,k,j,i,B1c) = br0*(cos(psi))/x1;
         pG->B1i[k][j][i]   = br0*(cos(psi))/(x1-0.5*pG->dx1);
 
         Eint = (pgas0 + 0.5*SQR(br0)*(1.0 + SQR(sin(psi)))/SQR(x1))/Gamma_1;
-        Emag = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
-        Ekin = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d; 
-        pG->U[k][j][i].E = Eint + Emag + Ekin;
+        Emag = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
+        Ekin = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d); 
+        GRID_U(pG,k,j,i,E) = Eint + Emag + Ekin;
 
         /* Save solution */
-        RootSoln[k][j][i] = pG->U[k][j][i];
+        RootSoln[k][j][i] = GET_GRID_U(pG,k,j,i);
       }
     }
   }
@@ -173,16 +173,16 @@ void cylbr_ix1(GridS *pG)
         cc_pos(pG,is-i,j,k,&x1,&x2,&x3);
         psi = a*x2 - phi0;
 
-        pG->U[k][j][is-i].d   = rho0*(1.0 + SQR(sin(psi)));
-        pG->U[k][j][is-i].M2  = pG->U[k][j][is-i].d*omega0*x1;
-        pG->U[k][j][is-i].M3  = pG->U[k][j][is-i].d*vz0;
-        pG->U[k][j][is-i].B1c = br0*(cos(psi))/x1;
+        GRID_U(pG,k,j,is-i,d)   = rho0*(1.0 + SQR(sin(psi)));
+        GRID_U(pG,k,j,is-i,M2)  = GRID_U(pG,k,j,is-i,d)*omega0*x1;
+        GRID_U(pG,k,j,is-i,M3)  = GRID_U(pG,k,j,is-i,d)*vz0;
+        GRID_U(pG,k,j,is-i,B1c) = br0*(cos(psi))/x1;
         pG->B1i[k][j][is-i]   = br0*(cos(psi))/(x1-0.5*pG->dx1);
 
         Eint = (pgas0 + 0.5*SQR(br0)*(1.0 + SQR(sin(psi)))/SQR(x1))/Gamma_1;
-        Emag = 0.5*(SQR(pG->U[k][j][is-i].B1c) + SQR(pG->U[k][j][is-i].B2c) + SQR(pG->U[k][j][is-i].B3c));
-        Ekin = 0.5*(SQR(pG->U[k][j][is-i].M1) + SQR(pG->U[k][j][is-i].M2) + SQR(pG->U[k][j][is-i].M3))/pG->U[k][j][is-i].d; 
-        pG->U[k][j][is-i].E = Eint + Emag + Ekin;
+        Emag = 0.5*(SQR(GRID_U(pG,k,j,is-i,B1c)) + SQR(GRID_U(pG,k,j,is-i,B2c)) + SQR(GRID_U(pG,k,j,is-i,B3c)));
+        Ekin = 0.5*(SQR(GRID_U(pG,k,j,is-i,M1)) + SQR(GRID_U(pG,k,j,is-i,M2)) + SQR(GRID_U(pG,k,j,is-i,M3)))/GRID_U(pG,k,j,is-i,d); 
+        GRID_U(pG,k,j,is-i,E) = Eint + Emag + Ekin;
       }
     }
   }
@@ -210,16 +210,16 @@ void cylbr_ox1(GridS *pG)
         cc_pos(pG,ie+i,j,k,&x1,&x2,&x3);
         psi = a*x2 - phi0;
 
-        pG->U[k][j][ie+i].d   = rho0*(1.0 + SQR(sin(psi)));
-        pG->U[k][j][ie+i].M2  = pG->U[k][j][ie+i].d*omega0*x1;
-        pG->U[k][j][ie+i].M3  = pG->U[k][j][ie+i].d*vz0;
-        pG->U[k][j][ie+i].B1c = br0*(cos(psi))/x1;
+        GRID_U(pG,k,j,ie+i,d)   = rho0*(1.0 + SQR(sin(psi)));
+        GRID_U(pG,k,j,ie+i,M2)  = GRID_U(pG,k,j,ie+i,d)*omega0*x1;
+        GRID_U(pG,k,j,ie+i,M3)  = GRID_U(pG,k,j,ie+i,d)*vz0;
+        GRID_U(pG,k,j,ie+i,B1c) = br0*(cos(psi))/x1;
         pG->B1i[k][j][ie+i]   = br0*(cos(psi))/(x1-0.5*pG->dx1);
 
         Eint = (pgas0 + 0.5*SQR(br0)*(1.0 + SQR(sin(psi)))/SQR(x1))/Gamma_1;
-        Emag = 0.5*(SQR(pG->U[k][j][ie+i].B1c) + SQR(pG->U[k][j][ie+i].B2c) + SQR(pG->U[k][j][ie+i].B3c));
-        Ekin = 0.5*(SQR(pG->U[k][j][ie+i].M1) + SQR(pG->U[k][j][ie+i].M2) + SQR(pG->U[k][j][ie+i].M3))/pG->U[k][j][ie+i].d; 
-        pG->U[k][j][ie+i].E = Eint + Emag + Ekin;
+        Emag = 0.5*(SQR(GRID_U(pG,k,j,ie+i,B1c)) + SQR(GRID_U(pG,k,j,ie+i,B2c)) + SQR(GRID_U(pG,k,j,ie+i,B3c)));
+        Ekin = 0.5*(SQR(GRID_U(pG,k,j,ie+i,M1)) + SQR(GRID_U(pG,k,j,ie+i,M2)) + SQR(GRID_U(pG,k,j,ie+i,M3)))/GRID_U(pG,k,j,ie+i,d); 
+        GRID_U(pG,k,j,ie+i,E) = Eint + Emag + Ekin;
       }
     }
   }
@@ -423,98 +423,98 @@ void problem(DomainS *pDomain)
 	
 	/*Initial Condition 1: for no inflow*/
 	if(IC == 1) {
-	  pG->U[k][j][i].d = rho0;
-	  pG->U[k][j][i].M1 = 0.0;
-	  pG->U[k][j][i].M2 = pG->U[k][j][i].d*vphi(x1,x2,x3);
-	  pG->U[k][j][i].M2 += pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+	  GRID_U(pG,k,j,i,d) = rho0;
+	  GRID_U(pG,k,j,i,M1) = 0.0;
+	  GRID_U(pG,k,j,i,M2) = GRID_U(pG,k,j,i,d)*vphi(x1,x2,x3);
+	  GRID_U(pG,k,j,i,M2) += GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
 	  r = 2.0*rand()/((double)RAND_MAX)-1.0;
-	  pG->U[k][j][i].M3 = pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+	  GRID_U(pG,k,j,i,M3) = GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
 #ifndef ISOTHERMAL
-	  pG->U[k][j][i].E  = pgas/(Gamma*Gamma_1)
-	    + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+	  GRID_U(pG,k,j,i,E)  = pgas/(Gamma*Gamma_1)
+	    + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #endif
 	} /*IC 1*/
 	
         /*Initial Condition 2: for L1-inflow*/
         if(IC == 2) {
-	  if(x1<=0.2*x1Max) pG->U[k][j][i].d = 0.2*rho0;
-	  else pG->U[k][j][i].d = d_floor;
+	  if(x1<=0.2*x1Max) GRID_U(pG,k,j,i,d) = 0.2*rho0;
+	  else GRID_U(pG,k,j,i,d) = d_floor;
 	  
-	  pG->U[k][j][i].M1 = 0.0;
-	  pG->U[k][j][i].M2 = pG->U[k][j][i].d*vphi(x1,x2,x3);
-	  pG->U[k][j][i].M2 += pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+	  GRID_U(pG,k,j,i,M1) = 0.0;
+	  GRID_U(pG,k,j,i,M2) = GRID_U(pG,k,j,i,d)*vphi(x1,x2,x3);
+	  GRID_U(pG,k,j,i,M2) += GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
 	  r = 2.0*rand()/((double)RAND_MAX)-1.0;
-	  pG->U[k][j][i].M3 = pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+	  GRID_U(pG,k,j,i,M3) = GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
 #ifndef ISOTHERMAL
-	  if(x1<=0.2*x1Max) pG->U[k][j][i].E  = 0.2*pgas/(Gamma*Gamma_1)
-				+ 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
-	  else              pG->U[k][j][i].E  = pgas_floor/(Gamma*Gamma_1)
-				+ 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+	  if(x1<=0.2*x1Max) GRID_U(pG,k,j,i,E)  = 0.2*pgas/(Gamma*Gamma_1)
+				+ 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
+	  else              GRID_U(pG,k,j,i,E)  = pgas_floor/(Gamma*Gamma_1)
+				+ 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #endif
         } /*IC 2*/
 	
         /*Initial Condition 3: empty initial disk*/
         if(IC == 3) {
-	  pG->U[k][j][i].d = d_floor;
-	  pG->U[k][j][i].M1 = 0.0;
-	  pG->U[k][j][i].M2 = pG->U[k][j][i].d*vphi(x1,x2,x3);
-	  pG->U[k][j][i].M2 += pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+	  GRID_U(pG,k,j,i,d) = d_floor;
+	  GRID_U(pG,k,j,i,M1) = 0.0;
+	  GRID_U(pG,k,j,i,M2) = GRID_U(pG,k,j,i,d)*vphi(x1,x2,x3);
+	  GRID_U(pG,k,j,i,M2) += GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
 	  r = 2.0*rand()/((double)RAND_MAX)-1.0;
-	  pG->U[k][j][i].M3 = pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+	  GRID_U(pG,k,j,i,M3) = GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
 #ifndef ISOTHERMAL
-	  pG->U[k][j][i].E  = pgas_floor/(Gamma*Gamma_1)
-	    + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d; 
+	  GRID_U(pG,k,j,i,E)  = pgas_floor/(Gamma*Gamma_1)
+	    + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d); 
 #endif
         } /*IC 3*/
 
         /*Initial Condition 4: truncated initial disk*/
         if(IC == 4) {
-          if(x1>=rstart && x1<=rtrunc) pG->U[k][j][i].d = rho0;
-          else pG->U[k][j][i].d = d_floor;
+          if(x1>=rstart && x1<=rtrunc) GRID_U(pG,k,j,i,d) = rho0;
+          else GRID_U(pG,k,j,i,d) = d_floor;
 
-          pG->U[k][j][i].M1 = 0.0;
-          pG->U[k][j][i].M2 = pG->U[k][j][i].d*vphi(x1,x2,x3);
-          pG->U[k][j][i].M2 += pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+          GRID_U(pG,k,j,i,M1) = 0.0;
+          GRID_U(pG,k,j,i,M2) = GRID_U(pG,k,j,i,d)*vphi(x1,x2,x3);
+          GRID_U(pG,k,j,i,M2) += GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
           r = 2.0*rand()/((double)RAND_MAX)-1.0;
-          pG->U[k][j][i].M3 = pG->U[k][j][i].d*Amp*r*csound*ChiMag(x1);
+          GRID_U(pG,k,j,i,M3) = GRID_U(pG,k,j,i,d)*Amp*r*csound*ChiMag(x1);
 #ifndef ISOTHERMAL
-          if(x1>=rstart && x1<=rtrunc) pG->U[k][j][i].E  = pgas/(Gamma*Gamma_1)
-                                + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
-          else              pG->U[k][j][i].E  = pgas_floor/(Gamma*Gamma_1)
-                                + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+          if(x1>=rstart && x1<=rtrunc) GRID_U(pG,k,j,i,E)  = pgas/(Gamma*Gamma_1)
+                                + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
+          else              GRID_U(pG,k,j,i,E)  = pgas_floor/(Gamma*Gamma_1)
+                                + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #endif
         } /*IC 4*/
 
 	if((IC!=1)&&(IC!=2)&&(IC!=3)&&(IC!=4)) ath_error("The initial condition flag is not defined."); 
 	
 #ifdef MHD
-        pG->U[k][j][i].B1c = 0.0;
+        GRID_U(pG,k,j,i,B1c) = 0.0;
         if (Field == 2) {
-	  pG->U[k][j][i].B2c = BpNet(x1,x2,x3);
+	  GRID_U(pG,k,j,i,B2c) = BpNet(x1,x2,x3);
         } else {
-          pG->U[k][j][i].B2c = 0.0;
+          GRID_U(pG,k,j,i,B2c) = 0.0;
         }
         if (Field == 0) {
-          pG->U[k][j][i].B3c = BzZero(x1,x2,x3);
+          GRID_U(pG,k,j,i,B3c) = BzZero(x1,x2,x3);
         } else if (Field == 1) {
-          pG->U[k][j][i].B3c = BzNet(x1,x2,x3);
+          GRID_U(pG,k,j,i,B3c) = BzNet(x1,x2,x3);
         } else {
-	  pG->U[k][j][i].B3c = 0.0;
+	  GRID_U(pG,k,j,i,B3c) = 0.0;
         }
         pG->B1i[k][j][i] = 0.0;
-        pG->B2i[k][j][i] = pG->U[k][j][i].B2c;
-        pG->B3i[k][j][i] = pG->U[k][j][i].B3c;
+        pG->B2i[k][j][i] = GRID_U(pG,k,j,i,B2c);
+        pG->B3i[k][j][i] = GRID_U(pG,k,j,i,B3c);
 	/* Initial Vacuum Disk */
 	if (Field == 3){
-	  pG->U[k][j][i].B1c = 0.0;
-	  pG->U[k][j][i].B2c = 0.0;
-	  pG->U[k][j][i].B3c = 0.0;
+	  GRID_U(pG,k,j,i,B1c) = 0.0;
+	  GRID_U(pG,k,j,i,B2c) = 0.0;
+	  GRID_U(pG,k,j,i,B3c) = 0.0;
 	  pG->B1i[k][j][i] = 0.0;
 	  pG->B2i[k][j][i] = 0.0;
 	  pG->B3i[k][j][i] = 0.0;
 	}
 #ifndef ISOTHERMAL
-        pG->U[k][j][i].E  += 0.5* (SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c)) ;
+        GRID_U(pG,k,j,i,E)  += 0.5* (SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c))) ;
 #endif
 #endif /* MHD */
       }
@@ -591,7 +591,7 @@ static Real MR1(const GridS *pG, const int i, const int j, const int k) {
   
   cc_pos(pG,i,j,k,&R,&phi,&z);
   if (R<R0) {
-    Mass = pG->U[k][j][i].d ; 
+    Mass = GRID_U(pG,k,j,i,d) ; 
   } else {
     Mass = 0.0;
   }
@@ -602,7 +602,7 @@ static Real MR2(const GridS *pG, const int i, const int j, const int k) {
   
   cc_pos(pG,i,j,k,&R,&phi,&z);
   if (R<R0) {
-    Mass = pG->U[k][j][i].d ;
+    Mass = GRID_U(pG,k,j,i,d) ;
   } else {
     Mass = 0.0;
   }
@@ -613,7 +613,7 @@ static Real MR3(const GridS *pG, const int i, const int j, const int k) {
   
   cc_pos(pG,i,j,k,&R,&phi,&z); 
   if (R<x1Max) {
-    Mass = pG->U[k][j][i].d ;
+    Mass = GRID_U(pG,k,j,i,d) ;
   } else {
     Mass = 0.0;
   }
@@ -625,7 +625,7 @@ static Real Mdot(const GridS *pG, const int i, const int j, const int k) {
   Real dphi=pG->dx2, dz=pG->dx3, R, phi, z, Md;
   
   cc_pos(pG,i,j,k,&R,&phi,&z);
-  Md = -1.0*pG->U[k][j][i].M1 * R;
+  Md = -1.0*GRID_U(pG,k,j,i,M1) * R;
   if (dphi>0) Md *= dphi;
   if (dz>0) Md *= dz;
   Md *= (pG->je-pG->js+1)*(pG->ke-pG->ks+1);
@@ -637,7 +637,7 @@ static Real MdotR1(const GridS *pG, const int i, const int j, const int k) {
   
   cc_pos(pG,i,j,k,&R,&phi,&z);
   if ((R0 > (R-dR)) && (R0 < (R+dR))) {
-    Md = -1.0*pG->U[k][j][i].M1/dR;
+    Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
   } else {
     Md = 0.0;
   }
@@ -649,7 +649,7 @@ static Real MdotR2(const GridS *pG, const int i, const int j, const int k) {
   
   cc_pos(pG,i,j,k,&R,&phi,&z);
   if ((R0 > (R-dR)) && (R0 < (R+dR))) {
-    Md = -1.0*pG->U[k][j][i].M1/dR;
+    Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
   } else {
     Md = 0.0;
   }
@@ -661,7 +661,7 @@ static Real MdotR3(const GridS *pG, const int i, const int j, const int k) {
   
   cc_pos(pG,i,j,k,&R,&phi,&z);
   if ((R0 > (R-dR)) && (R0 < (R+dR))) {
-    Md = -1.0*pG->U[k][j][i].M1/dR;
+    Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
   } else {
     Md = 0.0;
   }
@@ -673,7 +673,7 @@ static Real MdotR4(const GridS *pG, const int i, const int j, const int k) {
   
   cc_pos(pG,i,j,k,&R,&phi,&z);
   if ((x1Max > (R-dR)) && (x1Max < (R+dR))) {
-    Md = -1.0*pG->U[k][j][i].M1/dR;
+    Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
   } else {
     Md = 0.0;
   }
@@ -682,7 +682,7 @@ static Real MdotR4(const GridS *pG, const int i, const int j, const int k) {
 static Real Pb(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-  return ( 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c)) );
+  return ( 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c))) );
 #else
   return 0.0;
 #endif
@@ -692,16 +692,16 @@ static Real Pg(const GridS *pG, const int i, const int j, const int k)
 {
 #ifndef ISOTHERMAL
   Real Pb, Pg, Ek;
-  Ek = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+  Ek = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #ifdef MHD
-  Pb = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
-  Pg = (pG->U[k][j][i].E - Pb - Ek) * (Gamma-1);
+  Pb = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
+  Pg = (GRID_U(pG,k,j,i,E) - Pb - Ek) * (Gamma-1);
 #else
-  Pg = (pG->U[k][j][i].E - Ek) * (Gamma-1);
+  Pg = (GRID_U(pG,k,j,i,E) - Ek) * (Gamma-1);
 #endif
 #else
   Real Pg;
-  Pg = Iso_csound2*pG->U[k][j][i].d; 
+  Pg = Iso_csound2*GRID_U(pG,k,j,i,d); 
 #endif
   return Pg;
 }
@@ -710,7 +710,7 @@ static Real Pg_M(const GridS *pG, const int i, const int j, const int k)
 {
   Real Pg_M;
 
-  Pg_M = Pg(pG, i, j, k) * pG->U[k][j][i].d;
+  Pg_M = Pg(pG, i, j, k) * GRID_U(pG,k,j,i,d);
   return Pg_M;
 }
 
@@ -726,14 +726,14 @@ static Real alpha_M(const GridS *pG, const int i, const int j, const int k)
 {
     Real alpha_M;
 
-    alpha_M = Trp(pG, i, j, k) / Pg(pG, i, j, k) * pG->U[k][j][i].d;
+    alpha_M = Trp(pG, i, j, k) / Pg(pG, i, j, k) * GRID_U(pG,k,j,i,d);
     return alpha_M;
 }
 
 static Real Br2(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-  return ( pG->U[k][j][i].B1c * pG->U[k][j][i].B1c );
+  return ( GRID_U(pG,k,j,i,B1c) * GRID_U(pG,k,j,i,B1c) );
 #else
   return 0.0;
 #endif
@@ -742,7 +742,7 @@ static Real Br2(const GridS *pG, const int i, const int j, const int k)
 static Real Mrp(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-  return ( -1.0*pG->U[k][j][i].B1c*pG->U[k][j][i].B2c );  
+  return ( -1.0*GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c) );  
 #else
   return 0.0;
 #endif
@@ -752,14 +752,14 @@ static Real Trp(const GridS *pG, const int i, const int j, const int k)
 {
   Real R,p,z;
   cc_pos(pG,i,j,k,&R,&p,&z);
-  return ((pG->U[k][j][i].M1*(pG->U[k][j][i].M2-vphi(R,p,z)*pG->U[k][j][i].d))/(pG->U[k][j][i].d));
+  return ((GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M2)-vphi(R,p,z)*GRID_U(pG,k,j,i,d)))/(GRID_U(pG,k,j,i,d)));
 }
 
 static Real Trp_M(const GridS *pG, const int i, const int j, const int k)
 {
   Real R,p,z;
   cc_pos(pG,i,j,k,&R,&p,&z);
-  return (pG->U[k][j][i].M1*(pG->U[k][j][i].M2-vphi(R,p,z)*pG->U[k][j][i].d));
+  return (GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M2)-vphi(R,p,z)*GRID_U(pG,k,j,i,d)));
 }
 
 /* rho * (Vphi - Vkep)*/
@@ -767,13 +767,13 @@ static Real rdVp(const GridS *pG, const int i, const int j, const int k)
 {
   Real R,p,z;
   cc_pos(pG,i,j,k,&R,&p,&z);
-  return (pG->U[k][j][i].M2-vphi(R,p,z)*pG->U[k][j][i].d);
+  return (GRID_U(pG,k,j,i,M2)-vphi(R,p,z)*GRID_U(pG,k,j,i,d));
 }
 
 static Real Va(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-  return (sqrt((SQR(pG->U[k][j][i].B1c)+SQR(pG->U[k][j][i].B2c)+SQR(pG->U[k][j][i].B3c))/pG->U[k][j][i].d));
+  return (sqrt((SQR(GRID_U(pG,k,j,i,B1c))+SQR(GRID_U(pG,k,j,i,B2c))+SQR(GRID_U(pG,k,j,i,B3c)))/GRID_U(pG,k,j,i,d)));
 #else
   return 0.0;
 #endif
@@ -781,14 +781,14 @@ static Real Va(const GridS *pG, const int i, const int j, const int k)
 static Real Vaz(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-  return (fabs(pG->U[k][j][i].B3c)/sqrt(pG->U[k][j][i].d));
+  return (fabs(GRID_U(pG,k,j,i,B3c))/sqrt(GRID_U(pG,k,j,i,d)));
 #else
   return 0.0;
 #endif
 }
 static Real Br(const GridS *pG, const int i, const int j, const int k) {
 #ifdef MHD
-  return pG->U[k][j][i].B1c;
+  return GRID_U(pG,k,j,i,B1c);
 #else
   return 0.0;
 #endif
@@ -796,7 +796,7 @@ static Real Br(const GridS *pG, const int i, const int j, const int k) {
 }
 static Real Bp(const GridS *pG, const int i, const int j, const int k) {
 #ifdef MHD
-  return pG->U[k][j][i].B2c;
+  return GRID_U(pG,k,j,i,B2c);
 #else
   return 0.0;
 #endif  
@@ -804,7 +804,7 @@ static Real Bp(const GridS *pG, const int i, const int j, const int k) {
 
 static Real Bz(const GridS *pG, const int i, const int j, const int k) {
 #ifdef MHD
-  return pG->U[k][j][i].B3c;
+  return GRID_U(pG,k,j,i,B3c);
 #else
   return 0.0;
 #endif
@@ -812,20 +812,20 @@ static Real Bz(const GridS *pG, const int i, const int j, const int k) {
 
 static Real Bmag(const GridS *pG, const int i, const int j, const int k) {
 #ifdef MHD
-  return sqrt(pG->U[k][j][i].B1c*pG->U[k][j][i].B1c + pG->U[k][j][i].B2c*pG->U[k][j][i].B2c + pG->U[k][j][i].B3c*pG->U[k][j][i].B3c);
+  return sqrt(GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c) + GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c) + GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,B3c));
 #else
   return 0.0;
 #endif
 }
 
 static Real Vr(const GridS *pG, const int i, const int j, const int k) {
-  return (pG->U[k][j][i].M1/pG->U[k][j][i].d);
+  return (GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d));
 }
 
 static Real Vp(const GridS *pG, const int i, const int j, const int k) {
   Real R=x1vc(pG, i), vp;
   
-  vp = pG->U[k][j][i].M2/pG->U[k][j][i].d;
+  vp = GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d);
 #ifdef ROTATING_FRAME
   vp += Omega_0*R;
 #endif
@@ -837,18 +837,18 @@ static Real Vp(const GridS *pG, const int i, const int j, const int k) {
 }
 
 static Real Vz(const GridS *pG, const int i, const int j, const int k) {
-  return (pG->U[k][j][i].M3/pG->U[k][j][i].d);  
+  return (GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d));  
 }
 
 static Real L_AM(const GridS *pG, const int i, const int j, const int k) {
   Real L, R, I;
   
   R = x1vc(pG, i);
-//  L = pG->U[k][j][i].d * R * Vp(pG, i, j, k);
+//  L = GRID_U(pG,k,j,i,d) * R * Vp(pG, i, j, k);
   /* ang. mom. in rotating frame */
-  L = pG->U[k][j][i].M2 * R;
+  L = GRID_U(pG,k,j,i,M2) * R;
   #ifdef FARGO
-  L += pG->U[k][j][i].d * R * (*OrbitalProfile)(R)*R;
+  L += GRID_U(pG,k,j,i,d) * R * (*OrbitalProfile)(R)*R;
   #endif
   return(L);
 }
@@ -858,7 +858,7 @@ static Real L_AM_M(const GridS *pG, const int i, const int j, const int k) {
 
   R = x1vc(pG, i);
   I = ChiSub(R);
-  L = SQR(pG->U[k][j][i].d) * R * Vp(pG, i, j, k);
+  L = SQR(GRID_U(pG,k,j,i,d)) * R * Vp(pG, i, j, k);
 
   return(L*I);
 }
@@ -868,14 +868,14 @@ static Real Msub(const GridS *pG, const int i, const int j, const int k) {
   
   R = x1vc(pG,i);
   I = ChiSub(R);
-  return (pG->U[k][j][i].d*I);
+  return (GRID_U(pG,k,j,i,d)*I);
 }
 static Real Msub2(const GridS *pG, const int i, const int j, const int k) {
   Real I, R;
   
   R = x1vc(pG,i);
   I = ChiSub2(R);
-  return (pG->U[k][j][i].d*I);
+  return (GRID_U(pG,k,j,i,d)*I);
 }
 
 static Real Trpsub(const GridS *pG, const int i, const int j, const int k){
@@ -885,9 +885,9 @@ static Real Trpsub(const GridS *pG, const int i, const int j, const int k){
 #ifdef ROTATING_FRAME
   Real R,p,z;
   cc_pos(pG,i,j,k,&R,&p,&z);
-  return ((pG->U[k][j][i].M1*(pG->U[k][j][i].M2-vphi(R,p,z)*pG->U[k][j][i].d))/(pG->U[k][j][i].d) * I);
+  return ((GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M2)-vphi(R,p,z)*GRID_U(pG,k,j,i,d)))/(GRID_U(pG,k,j,i,d)) * I);
 #else
-  return ((pG->U[k][j][i].M1*pG->U[k][j][i].M2)/(pG->U[k][j][i].d) * I);
+  return ((GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M2))/(GRID_U(pG,k,j,i,d)) * I);
 #endif
 }
 
@@ -898,9 +898,9 @@ static Real Trpsub2(const GridS *pG, const int i, const int j, const int k){
 #ifdef ROTATING_FRAME
   Real R,p,z;
   cc_pos(pG,i,j,k,&R,&p,&z);
-  return ((pG->U[k][j][i].M1*(pG->U[k][j][i].M2-vphi(R,p,z)*pG->U[k][j][i].d))/(pG->U[k][j][i].d) * I);
+  return ((GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M2)-vphi(R,p,z)*GRID_U(pG,k,j,i,d)))/(GRID_U(pG,k,j,i,d)) * I);
 #else
-  return ((pG->U[k][j][i].M1*pG->U[k][j][i].M2)/(pG->U[k][j][i].d) * I);
+  return ((GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M2))/(GRID_U(pG,k,j,i,d)) * I);
 #endif
 }
 
@@ -910,7 +910,7 @@ static Real Mrpsub(const GridS *pG, const int i, const int j, const int k) {
   R = x1vc(pG,i);
   I = ChiSub(R);
 #ifdef MHD
-  return (-1.0*pG->U[k][j][i].B1c*pG->U[k][j][i].B2c*I);
+  return (-1.0*GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c)*I);
 #else
   return 0.0;
 #endif
@@ -922,7 +922,7 @@ static Real Mrpsub2(const GridS *pG, const int i, const int j, const int k) {
   R = x1vc(pG,i);
   I = ChiSub2(R);
 #ifdef MHD
-  return (-1.0*pG->U[k][j][i].B1c*pG->U[k][j][i].B2c*I);
+  return (-1.0*GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c)*I);
 #else
   return 0.0;
 #endif  
@@ -934,7 +934,7 @@ static Real Bpsub(const GridS *pG, const int i, const int j, const int k) {
   R = x1vc(pG,i);
   I = ChiSub(R);
 #ifdef MHD
-  return (pG->U[k][j][i].B2c*I);
+  return (GRID_U(pG,k,j,i,B2c)*I);
 #else
   return 0.0;
 #endif
@@ -947,7 +947,7 @@ static Real Bzsub(const GridS *pG, const int i, const int j, const int k) {
   R = x1vc(pG,i);
   I = ChiSub(R);
 #ifdef MHD
-  return (pG->U[k][j][i].B3c*I);
+  return (GRID_U(pG,k,j,i,B3c)*I);
 #else
   return 0.0;
 #endif  
@@ -959,7 +959,7 @@ static Real Pbsub(const GridS *pG, const int i, const int j, const int k) {
   R = x1vc(pG,i);
   I = ChiSub(R);
 #ifdef MHD
-  return (0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c))*I);
+  return (0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)))*I);
 #else
   return 0.0;
 #endif
@@ -971,7 +971,7 @@ static Real Pbsub2(const GridS *pG, const int i, const int j, const int k) {
   R = x1vc(pG,i);
   I = ChiSub2(R);
 #ifdef MHD
-  return (0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c))*I);
+  return (0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)))*I);
 #else
   return 0.0;
 #endif
@@ -984,15 +984,15 @@ static Real Pgsub(const GridS *pG, const int i, const int j, const int k)
   I = ChiSub(R);
 #ifndef ISOTHERMAL
   Real Pb, Ek;
-  Ek = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+  Ek = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #ifdef MHD
-  Pb = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
-  Pg = (pG->U[k][j][i].E - Pb - Ek) * (Gamma-1);
+  Pb = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
+  Pg = (GRID_U(pG,k,j,i,E) - Pb - Ek) * (Gamma-1);
 #else
-  Pg = (pG->U[k][j][i].E - Ek) * (Gamma-1);
+  Pg = (GRID_U(pG,k,j,i,E) - Ek) * (Gamma-1);
 #endif
 #else
-  Pg = Iso_csound2*pG->U[k][j][i].d;
+  Pg = Iso_csound2*GRID_U(pG,k,j,i,d);
 #endif
   return (Pg*I);
 }
@@ -1004,15 +1004,15 @@ static Real Pgsub2(const GridS *pG, const int i, const int j, const int k)
   I = ChiSub2(R);
 #ifndef ISOTHERMAL
   Real Pb, Ek;
-  Ek = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+  Ek = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #ifdef MHD
-  Pb = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
-  Pg = (pG->U[k][j][i].E - Pb - Ek) * (Gamma-1);
+  Pb = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
+  Pg = (GRID_U(pG,k,j,i,E) - Pb - Ek) * (Gamma-1);
 #else
-  Pg = (pG->U[k][j][i].E - Ek) * (Gamma-1);
+  Pg = (GRID_U(pG,k,j,i,E) - Ek) * (Gamma-1);
 #endif
 #else
-  Pg = Iso_csound2*pG->U[k][j][i].d;
+  Pg = Iso_csound2*GRID_U(pG,k,j,i,d);
 #endif
   return (Pg*I);
 }
@@ -1024,11 +1024,11 @@ static Real Temp(const GridS *pG, const int i, const int j, const int k) {
   T = Iso_csound2;
 #else
 #ifdef MHD
-        T = (pG->U[k][j][i].E - 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c)))/pG->U[k][j][i].d
-	  - 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/SQR(pG->U[k][j][i].d);
+        T = (GRID_U(pG,k,j,i,E) - 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c))))/GRID_U(pG,k,j,i,d)
+	  - 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/SQR(GRID_U(pG,k,j,i,d));
 #else
-	T = pG->U[k][j][i].E/pG->U[k][j][i].d
-	  - 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/SQR(pG->U[k][j][i].d);
+	T = GRID_U(pG,k,j,i,E)/GRID_U(pG,k,j,i,d)
+	  - 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/SQR(GRID_U(pG,k,j,i,d));
 #endif
 #endif
 	return T;
@@ -1068,7 +1068,7 @@ static Real torque(const GridS *pG, const int i, const int j, const int k) {
         gphi = -1.0*(grav_pot(x1,x2+0.5*dys,x3)-grav_pot(x1,x2-0.5*dys,x3))/dys/x1;
         tq = x1*gphi;
 #ifdef ROTATING_FRAME
-        fcor = -2.0 * Omega_0* pG->U[k][j][i].M1/pG->U[k][j][i].d;
+        fcor = -2.0 * Omega_0* GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d);
         tq += x1 *fcor;
 #endif
         return tq;
@@ -1348,25 +1348,25 @@ void Userwork_in_loop(MeshS *pM)
 	    for (i=il; i<=iu; i++) {     
 
   /* Apply density and pressure floor */
-	      if(pG->U[k][j][i].d < d_MIN) pG->U[k][j][i].d = d_MIN;
+	      if(GRID_U(pG,k,j,i,d) < d_MIN) GRID_U(pG,k,j,i,d) = d_MIN;
 #ifndef BAROTROPIC
 #ifdef MHD
-	      Pres = pG->U[k][j][i].E - 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d
-		- 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
+	      Pres = GRID_U(pG,k,j,i,E) - 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d)
+		- 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
 	      if(Pres < presmin)
-		pG->U[k][j][i].E = presmin + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d
-		  + 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
+		GRID_U(pG,k,j,i,E) = presmin + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d)
+		  + 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
 #else
-	      Pres = pG->U[k][j][i].E - 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+	      Pres = GRID_U(pG,k,j,i,E) - 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 	      if(Pres < presmin)
-		pG->U[k][j][i].E = presmin + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+		GRID_U(pG,k,j,i,E) = presmin + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #endif	
 	      /*
-		T = pG->U[k][j][i].E/pG->U[k][j][i].d 
-		- 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/SQR(pG->U[k][j][i].d);
+		T = GRID_U(pG,k,j,i,E)/GRID_U(pG,k,j,i,d) 
+		- 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/SQR(GRID_U(pG,k,j,i,d));
 		if(T < Tmin)
-		pG->U[k][j][i].E = pG->U[k][j][i].d*Tmin 
-		+ 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d; 
+		GRID_U(pG,k,j,i,E) = GRID_U(pG,k,j,i,d)*Tmin 
+		+ 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d); 
 	      */			
 #endif /*BAROTROPIC*/
 
@@ -1471,12 +1471,12 @@ void ScaleToBeta(GridS *pG, Real beta) {
       for (i=is; i<=ie; i++) {
 	CellVol = (pG->r[i])*(pG->dx1)*(pG->dx2)*(pG->dx3);
 #ifndef ISOTHERMAL
-        Pgas += (Gamma-1)*(pG->U[k][j][i].E - 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d)*CellVol;
+        Pgas += (Gamma-1)*(GRID_U(pG,k,j,i,E) - 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d))*CellVol;
 #else
-        Pgas += Iso_csound2*pG->U[k][j][i].d*CellVol;
+        Pgas += Iso_csound2*GRID_U(pG,k,j,i,d)*CellVol;
 #endif
-        Pb += 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c)
-		   + SQR(pG->U[k][j][i].B3c))*CellVol;
+        Pb += 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c))
+		   + SQR(GRID_U(pG,k,j,i,B3c)))*CellVol;
       }
     }
   }
@@ -1495,9 +1495,9 @@ void ScaleToBeta(GridS *pG, Real beta) {
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i].B1c *= scl;
-        pG->U[k][j][i].B2c *= scl;
-        pG->U[k][j][i].B3c *= scl;
+        GRID_U(pG,k,j,i,B1c) *= scl;
+        GRID_U(pG,k,j,i,B2c) *= scl;
+        GRID_U(pG,k,j,i,B3c) *= scl;
         pG->B1i[k][j][i]   *= scl;
         pG->B2i[k][j][i]   *= scl;
         pG->B3i[k][j][i]   *= scl;
@@ -1525,54 +1525,54 @@ void disk_ir(GridS *pGrid) {
 #endif
       /* Calculate angular momentum in rotating frame */
 #ifdef FARGO
-      Lper = R*pGrid->U[k][j][is].M2;
+      Lper = R*GRID_U(pGrid,k,j,is,M2);
 #else
       /*vphi is different with or without ROTATING_FRAME, added by Wendy Ju*/
       Vkep = vphi(R,p,z);
-      Lper = R*pGrid->U[k][j][is].M2 - R*pGrid->U[k][j][is].d*Vkep;
+      Lper = R*GRID_U(pGrid,k,j,is,M2) - R*GRID_U(pGrid,k,j,is,d)*Vkep;
 #endif /* FARGO */
       Lper = MIN(Lper,0.0);
       
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][is];
+        SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j,is));
 
-	if (Hbc ==1) pGrid->U[k][j][is-i].d = rho0;
+	if (Hbc ==1) GRID_U(pGrid,k,j,is-i,d) = rho0;
 	/* Enforce diode */
-	pGrid->U[k][j][is-i].M1 = MIN(pGrid->U[k][j][is-i].M1,0.0);
+	GRID_U(pGrid,k,j,is-i,M1) = MIN(GRID_U(pGrid,k,j,is-i,M1),0.0);
 	/* Calculate Keplerian velocity */
 	cc_pos(pGrid,is-i,j,k,&R,&p,&z);
 	Vkep = vphi(R,p,z);
 #ifdef FARGO
 	if (Hbc == 1) {
-	  pGrid->U[k][j][is-i].M2 = pGrid->U[k][j][is].d*Vkep;
+	  GRID_U(pGrid,k,j,is-i,M2) = GRID_U(pGrid,k,j,is,d)*Vkep;
 	} else if (Hbc == 2){  /*copy the inner velocity*/
-	  pGrid->U[k][j][is-i].M2 = pGrid->U[k][j][is].M2;
+	  GRID_U(pGrid,k,j,is-i,M2) = GRID_U(pGrid,k,j,is,M2);
 	}else{
-	  pGrid->U[k][j][is-i].M2 = Lper/R;
+	  GRID_U(pGrid,k,j,is-i,M2) = Lper/R;
 	}
 #else
 	if (Hbc == 1) {  /*local kepler velocity*/
-	  pGrid->U[k][j][is-i].M2 = pGrid->U[k][j][is].d*Vkep;
+	  GRID_U(pGrid,k,j,is-i,M2) = GRID_U(pGrid,k,j,is,d)*Vkep;
 	} else if (Hbc == 2){  /*copy the inner velocity*/
-	  pGrid->U[k][j][is-i].M2 = pGrid->U[k][j][is].M2;
+	  GRID_U(pGrid,k,j,is-i,M2) = GRID_U(pGrid,k,j,is,M2);
 	}else{  /*keep velocity perturbation constant*/
-	  pGrid->U[k][j][is-i].M2 = Lper/R + pGrid->U[k][j][is-i].d*Vkep;
+	  GRID_U(pGrid,k,j,is-i,M2) = Lper/R + GRID_U(pGrid,k,j,is-i,d)*Vkep;
 	}
 #endif
 #ifdef MHD
 	if (Mbc == 0) {  /* Divergence-free in radial*/
-	  pGrid->U[k][j][is-i].B1c = RBr/R;
-	  pGrid->U[k][j][is-i].B2c = 0.0;
-	  pGrid->U[k][j][is-i].B3c = 0.0;
+	  GRID_U(pGrid,k,j,is-i,B1c) = RBr/R;
+	  GRID_U(pGrid,k,j,is-i,B2c) = 0.0;
+	  GRID_U(pGrid,k,j,is-i,B3c) = 0.0;
 	}
 	else{
-	  pGrid->U[k][j][is-i].B1c = pGrid->U[k][j][is].B1c;
-	  pGrid->U[k][j][is-i].B2c = pGrid->U[k][j][is].B2c;
-	  pGrid->U[k][j][is-i].B3c = pGrid->U[k][j][is].B3c;
+	  GRID_U(pGrid,k,j,is-i,B1c) = GRID_U(pGrid,k,j,is,B1c);
+	  GRID_U(pGrid,k,j,is-i,B2c) = GRID_U(pGrid,k,j,is,B2c);
+	  GRID_U(pGrid,k,j,is-i,B3c) = GRID_U(pGrid,k,j,is,B3c);
 	}
 #endif
 #ifndef ISOTHERMAL
-	pGrid->U[k][j][is-i].E = pGrid->U[k][j][is].E;
+	GRID_U(pGrid,k,j,is-i,E) = GRID_U(pGrid,k,j,is,E);
 #endif
       }
     }
@@ -1652,52 +1652,52 @@ void disk_or(GridS *pGrid) {
 #endif
       /* Calculate angular momentum in rotating frame */
 #ifdef FARGO
-      Lper = pGrid->r[ie]*pGrid->U[k][j][ie].M2;
+      Lper = pGrid->r[ie]*GRID_U(pGrid,k,j,ie,M2);
 #else
       Vkep = vphi(R,p,z); /*different with or without ROTATING_FRAME, added by Wendy Ju*/
-      Lper = R*pGrid->U[k][j][ie].M2 - R*pGrid->U[k][j][ie].d*Vkep;
+      Lper = R*GRID_U(pGrid,k,j,ie,M2) - R*GRID_U(pGrid,k,j,ie,d)*Vkep;
 #endif
       
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][ie];
+        SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j,ie));
 	
-//	if (Hbc == 1) pGrid->U[k][j][ie+i].d = d_floor;
+//	if (Hbc == 1) GRID_U(pGrid,k,j,ie+i,d) = d_floor;
 	/* Enforce diode */
-	pGrid->U[k][j][ie+i].M1 = MAX(pGrid->U[k][j][ie+i].M1,0.0);
+	GRID_U(pGrid,k,j,ie+i,M1) = MAX(GRID_U(pGrid,k,j,ie+i,M1),0.0);
 	
 	cc_pos(pGrid,ie+i,j,k,&R,&p,&z);
 	Vkep = vphi(R,p,z); /*different with or without ROTATING_FRAME, added by Wendy Ju*/
 #ifdef FARGO
 	if (Hbc == 1) {
-	  pGrid->U[k][j][ie+i].M2 = pGrid->U[k][j][ie].d*Vkep;
+	  GRID_U(pGrid,k,j,ie+i,M2) = GRID_U(pGrid,k,j,ie,d)*Vkep;
 	} else if (Hbc == 2){  /*copy the inner velocity*/
-	  pGrid->U[k][j][ie+i].M2 = pGrid->U[k][j][ie].M2;
+	  GRID_U(pGrid,k,j,ie+i,M2) = GRID_U(pGrid,k,j,ie,M2);
 	}else{
-	  pGrid->U[k][j][ie+i].M2 = Lper/R;
+	  GRID_U(pGrid,k,j,ie+i,M2) = Lper/R;
 	}
 #else
 	if (Hbc == 1) {  /*local kepler velocity*/
-	  pGrid->U[k][j][ie+i].M2 = pGrid->U[k][j][ie].d*Vkep;
+	  GRID_U(pGrid,k,j,ie+i,M2) = GRID_U(pGrid,k,j,ie,d)*Vkep;
 	} else if (Hbc == 2){  /*copy the inner velocity*/
-	  pGrid->U[k][j][ie+i].M2 = pGrid->U[k][j][ie].M2;
+	  GRID_U(pGrid,k,j,ie+i,M2) = GRID_U(pGrid,k,j,ie,M2);
 	}else {  /*keep velocity perturbation constant*/
-	  pGrid->U[k][j][ie+i].M2 = Lper/R + pGrid->U[k][j][ie+i].d*Vkep;
+	  GRID_U(pGrid,k,j,ie+i,M2) = Lper/R + GRID_U(pGrid,k,j,ie+i,d)*Vkep;
 	}
 #endif
 #ifdef MHD
 	if (Mbc == 0) {  /*radial divergence free */
-	  pGrid->U[k][j][ie+i].B1c = RBr/R;
-	  pGrid->U[k][j][ie+i].B2c = 0.0;
-	  pGrid->U[k][j][ie+i].B3c = 0.0;
+	  GRID_U(pGrid,k,j,ie+i,B1c) = RBr/R;
+	  GRID_U(pGrid,k,j,ie+i,B2c) = 0.0;
+	  GRID_U(pGrid,k,j,ie+i,B3c) = 0.0;
 	}
 	else{
-	  pGrid->U[k][j][ie+i].B1c = pGrid->U[k][j][ie].B1c;
-	  pGrid->U[k][j][ie+i].B2c = pGrid->U[k][j][ie].B2c;
-	  pGrid->U[k][j][ie+i].B3c = pGrid->U[k][j][ie].B3c;
+	  GRID_U(pGrid,k,j,ie+i,B1c) = GRID_U(pGrid,k,j,ie,B1c);
+	  GRID_U(pGrid,k,j,ie+i,B2c) = GRID_U(pGrid,k,j,ie,B2c);
+	  GRID_U(pGrid,k,j,ie+i,B3c) = GRID_U(pGrid,k,j,ie,B3c);
 	}
 #endif
 #ifndef ISOTHERMAL
-	pGrid->U[k][j][ie+i].E = pGrid->U[k][j][ie].E;
+	GRID_U(pGrid,k,j,ie+i,E) = GRID_U(pGrid,k,j,ie,E);
 #endif
 	
       }/*i*/
@@ -1757,21 +1757,21 @@ void disk_or(GridS *pGrid) {
 	/* To let the geometry move with the flow*/
 	Rmov = pGrid->r[ie+i] + Vr_l1*pGrid->time;
 	if((p>-Pi/60.0)&&(p<Pi/60.0)) { /*about 6 degrees*/
-	  pGrid->U[k][j][ie+i].d = rho0;
-	  pGrid->U[k][j][ie+i].M1 = -1.0 * pGrid->U[k][j][ie+i].d * Vr_l1;
+	  GRID_U(pGrid,k,j,ie+i,d) = rho0;
+	  GRID_U(pGrid,k,j,ie+i,M1) = -1.0 * GRID_U(pGrid,k,j,ie+i,d) * Vr_l1;
 
-          pGrid->U[k][j][ie+i].M2 = 0.0;
+          GRID_U(pGrid,k,j,ie+i,M2) = 0.0;
         #ifdef ROTATING_FRAME
-          pGrid->U[k][j][ie+i].M2 = 0.0;
+          GRID_U(pGrid,k,j,ie+i,M2) = 0.0;
         #endif
         #ifdef FARGO
-          pGrid->U[k][j][ie+i].M2 -= pGrid->U[k][j][ie+i].d * R * (*OrbitalProfile)(R);
+          GRID_U(pGrid,k,j,ie+i,M2) -= GRID_U(pGrid,k,j,ie+i,d) * R * (*OrbitalProfile)(R);
         #endif
 
-          pGrid->U[k][j][ie+i].M3 = 0.0; 
+          GRID_U(pGrid,k,j,ie+i,M3) = 0.0; 
 #ifndef ISOTHERMAL
-	  pGrid->U[k][j][ie+i].E  = pgas/(Gamma*Gamma_1) 
-	    + 0.5*(SQR(pGrid->U[k][j][ie+i].M1) + SQR(pGrid->U[k][j][ie+i].M2) + SQR(pGrid->U[k][j][ie+i].M3))/pGrid->U[k][j][ie+i].d;
+	  GRID_U(pGrid,k,j,ie+i,E)  = pgas/(Gamma*Gamma_1) 
+	    + 0.5*(SQR(GRID_U(pGrid,k,j,ie+i,M1)) + SQR(GRID_U(pGrid,k,j,ie+i,M2)) + SQR(GRID_U(pGrid,k,j,ie+i,M3)))/GRID_U(pGrid,k,j,ie+i,d);
 #endif
 	  
 	  /** Inflow B field**/  
@@ -1788,12 +1788,12 @@ void disk_or(GridS *pGrid) {
 #ifndef BAROTROPIC
 	    A_eff = sqrt(A0_fac * pgas/Gamma/Beta);
 #else
-	    A_eff = sqrt(A0_fac * pGrid->U[k][j][ie+i].d*Iso_csound2/Beta);
+	    A_eff = sqrt(A0_fac * GRID_U(pGrid,k,j,ie+i,d)*Iso_csound2/Beta);
 #endif /*BAROTROPIC*/
 	    
-	    pGrid->U[k][j][ie+i].B1c = A_eff * cos(Pi*R_Az/R_A0) * R_Ac*sin(p) / R_Az ;
-	    pGrid->U[k][j][ie+i].B2c = -1.0 * A_eff * cos(Pi*R_Az/R_A0) * (R - R_Ac*cos(p)) / R_Az;
-	    pGrid->U[k][j][ie+i].B3c = 0.0;
+	    GRID_U(pGrid,k,j,ie+i,B1c) = A_eff * cos(Pi*R_Az/R_A0) * R_Ac*sin(p) / R_Az ;
+	    GRID_U(pGrid,k,j,ie+i,B2c) = -1.0 * A_eff * cos(Pi*R_Az/R_A0) * (R - R_Ac*cos(p)) / R_Az;
+	    GRID_U(pGrid,k,j,ie+i,B3c) = 0.0;
 	    
 	    pGrid->B2i[k][j][ie+i] = A_eff * cos(Pi*R_Az/R_A0) * (R - R_Ac*cos(p-0.5*pGrid->dx2)) / R_Az;
 	    R_Az = sqrt((R-0.5*pGrid->dx1)*(R-0.5*pGrid->dx1) + R_Ac*R_Ac - 2.0*(R-0.5*pGrid->dx1)*R_Ac*cos(p));
@@ -1803,29 +1803,29 @@ void disk_or(GridS *pGrid) {
 	    {
 /*B1 and B2 is already properly defined, so only redefine B3*/
 #ifndef BAROTROPIC
-	      pGrid->U[k][j][ie+i].B3c = sqrt(2.0 * pgas/Gamma/Beta);
+	      GRID_U(pGrid,k,j,ie+i,B3c) = sqrt(2.0 * pgas/Gamma/Beta);
 #else
-	      pGrid->U[k][j][ie+i].B3c = sqrt(2.0 * pGrid->U[k][j][ie+i].d*Iso_csound2/Beta);
+	      GRID_U(pGrid,k,j,ie+i,B3c) = sqrt(2.0 * GRID_U(pGrid,k,j,ie+i,d)*Iso_csound2/Beta);
 #endif /*BAROTROPIC*/
 	      
 /*
 	      if(i!=1){
 		pGrid->B1i[k][j][ie+i] = 0.0;
 		pGrid->B2i[k][j][ie+i] = 0.0;
-		pGrid->B3i[k][j][ie+i] = pGrid->U[k][j][ie+i].B3c;
+		pGrid->B3i[k][j][ie+i] = GRID_U(pGrid,k,j,ie+i,B3c);
 	      }
 */
-		pGrid->B3i[k][j][ie+i] = pGrid->U[k][j][ie+i].B3c;
+		pGrid->B3i[k][j][ie+i] = GRID_U(pGrid,k,j,ie+i,B3c);
 
 	    } else ath_error("[Problem]: Bgeo has no such option!\n");
 	  
 	  
 	  /*
-	    pGrid->U[k][j][ie+i].B1c = A0 * cos(Pi/Lx*Rmov*cos(p)) * sin(Pi/Ly*Rmov*sin(p)) * sin(p)
+	    GRID_U(pGrid,k,j,ie+i,B1c) = A0 * cos(Pi/Lx*Rmov*cos(p)) * sin(Pi/Ly*Rmov*sin(p)) * sin(p)
 	    + A0 * sin(Pi/Lx*Rmov*cos(p)) * cos(Pi/Ly*Rmov*sin(p)) * cos(p);
-	    pGrid->U[k][j][ie+i].B2c = A0 * cos(Pi/Lx*Rmov*cos(p)) * sin(Pi/Ly*Rmov*sin(p)) * cos(p)
+	    GRID_U(pGrid,k,j,ie+i,B2c) = A0 * cos(Pi/Lx*Rmov*cos(p)) * sin(Pi/Ly*Rmov*sin(p)) * cos(p)
 	    + A0 * sin(Pi/Lx*Rmov*cos(p)) * cos(Pi/Ly*Rmov*sin(p)) * sin(p);
-	    pGrid->U[k][j][ie+i].B3c = 0.0;
+	    GRID_U(pGrid,k,j,ie+i,B3c) = 0.0;
 	    
 	    if(i!=1){
 	    pGrid->B1i[k][j][ie+i] = A0 * cos(Pi/Lx*(Rmov-0.5*pGrid->dx1)*cos(p)) * sin(Pi/Ly*(Rmov-0.5*pGrid->dx1)*sin(p)) * sin(p)
@@ -1836,7 +1836,7 @@ void disk_or(GridS *pGrid) {
 	    }
 	  */
 #ifndef ISOTHERMAL
-	  pGrid->U[k][j][ie+i].E  += 0.5*(SQR(pGrid->U[k][j][ie+i].B1c) + SQR(pGrid->U[k][j][ie+i].B2c) + SQR(pGrid->U[k][j][ie+i].B3c));
+	  GRID_U(pGrid,k,j,ie+i,E)  += 0.5*(SQR(GRID_U(pGrid,k,j,ie+i,B1c)) + SQR(GRID_U(pGrid,k,j,ie+i,B2c)) + SQR(GRID_U(pGrid,k,j,ie+i,B3c)));
 #endif
 	  
 #endif /*MHD*/
@@ -1957,7 +1957,7 @@ static void dump_vtksub(MeshS *pM, OutputS *pOut) {
 	for (k = kl; k <= ku; k++) {
 		for (j = jl; j <= ju; j++) {
 			for (i = il; i <= iu; i++) {
-				data[i - il] = (float) pGrid->U[k][j][i].d;
+				data[i - il] = (float) GRID_U(pGrid,k,j,i,d);
 			}
 			if (!big_end)
 				ath_bswap(data, sizeof(float), iu - il + 1);
@@ -1971,9 +1971,9 @@ static void dump_vtksub(MeshS *pM, OutputS *pOut) {
 	for (k = kl; k <= ku; k++) {
 		for (j = jl; j <= ju; j++) {
 			for (i = il; i <= iu; i++) {
-				data[3 * (i - il)] = (float) pGrid->U[k][j][i].M1;
-				data[3 * (i - il) + 1] = (float) pGrid->U[k][j][i].M2;
-				data[3 * (i - il) + 2] = (float) pGrid->U[k][j][i].M3;
+				data[3 * (i - il)] = (float) GRID_U(pGrid,k,j,i,M1);
+				data[3 * (i - il) + 1] = (float) GRID_U(pGrid,k,j,i,M2);
+				data[3 * (i - il) + 2] = (float) GRID_U(pGrid,k,j,i,M3);
 			}
 			if (!big_end)
 				ath_bswap(data, sizeof(float), 3 * (iu - il + 1));
@@ -1988,9 +1988,9 @@ static void dump_vtksub(MeshS *pM, OutputS *pOut) {
 	for (k = kl; k <= ku; k++) {
 		for (j = jl; j <= ju; j++) {
 			for (i = il; i <= iu; i++) {
-				data[3 * (i - il)] = (float) pGrid->U[k][j][i].B1c;
-				data[3 * (i - il) + 1] = (float) pGrid->U[k][j][i].B2c;
-				data[3 * (i - il) + 2] = (float) pGrid->U[k][j][i].B3c;
+				data[3 * (i - il)] = (float) GRID_U(pGrid,k,j,i,B1c);
+				data[3 * (i - il) + 1] = (float) GRID_U(pGrid,k,j,i,B2c);
+				data[3 * (i - il) + 2] = (float) GRID_U(pGrid,k,j,i,B3c);
 			}
 			if (!big_end)
 				ath_bswap(data, sizeof(float), 3 * (iu - il + 1));
@@ -2172,7 +2172,7 @@ static void out_jtab(MeshS *pM, OutputS *pOut)
       for (i=is; i<=ie; i++) {
 	ig=i+idisp-nghost;
         i1d=0;
-        out1d[ig][i1d] += pGrid->U[k][j][i].d; /*density*/
+        out1d[ig][i1d] += GRID_U(pGrid,k,j,i,d); /*density*/
         i1d++;
         out1d[ig][i1d] += Pg(pGrid,i,j,k); /*gas pressure*/
 #ifdef MHD
@@ -2183,23 +2183,23 @@ static void out_jtab(MeshS *pM, OutputS *pOut)
         i1d++;
         out1d[ig][i1d] += Temp(pGrid,i,j,k); /*gas temperature*/
         i1d++;
-        out1d[ig][i1d] += pGrid->U[k][j][i].E; /*total energy*/
+        out1d[ig][i1d] += GRID_U(pGrid,k,j,i,E); /*total energy*/
 #endif
         i1d++;
-        out1d[ig][i1d] += 0.5*SQR(pGrid->U[k][j][i].M1)/pGrid->U[k][j][i].d; /*KEr*/
+        out1d[ig][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,M1))/GRID_U(pGrid,k,j,i,d); /*KEr*/
         i1d++;
-        out1d[ig][i1d] += 0.5*SQR(Vp(pGrid,i,j,k))*pGrid->U[k][j][i].d; /*KEphi*/
+        out1d[ig][i1d] += 0.5*SQR(Vp(pGrid,i,j,k))*GRID_U(pGrid,k,j,i,d); /*KEphi*/
         i1d++;
-        out1d[ig][i1d] += 0.5*SQR(pGrid->U[k][j][i].M3)/pGrid->U[k][j][i].d; /*KEz*/
+        out1d[ig][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,M3))/GRID_U(pGrid,k,j,i,d); /*KEz*/
         i1d++;
         out1d[ig][i1d] += Trp(pGrid,i,j,k); /*Reynolds stress*/
 #ifdef MHD
         i1d++;
-        out1d[ig][i1d] += 0.5*SQR(pGrid->U[k][j][i].B1c); /*MEr*/
+        out1d[ig][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,B1c)); /*MEr*/
         i1d++;
-        out1d[ig][i1d] += 0.5*SQR(pGrid->U[k][j][i].B2c); /*MEphi*/
+        out1d[ig][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,B2c)); /*MEphi*/
         i1d++;
-        out1d[ig][i1d] += 0.5*SQR(pGrid->U[k][j][i].B3c); /*MEz*/
+        out1d[ig][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,B3c)); /*MEz*/
         i1d++;
         out1d[ig][i1d] += Br(pGrid,i,j,k); /*Br*/
         i1d++;
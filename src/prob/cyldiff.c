@@ -63,6 +63,7 @@ void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
   int i,j,k;
+  ConsS Uzero = {0.0};
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3;
   int *ierr;
@@ -106,16 +107,16 @@ void problem(DomainS *pDomain)
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1c,&x2c,&x3c);
         fc_pos(pG,i,j,k,&x1f,&x2f,&x3f);
-        memset(&(pG->U[k][j][i]),0.0,sizeof(ConsS));
+        SET_GRID_U(pG,k,j,i,Uzero);
 
-        pG->U[k][j][i].d  = 1.0;
+        GRID_U(pG,k,j,i,d)  = 1.0;
         switch (iprob) {
           case 1:
 #ifndef CYLINDRICAL
   ath_error("[cyldiff]: iprob=1 only works in cylindrical!\n");
 #endif
 #ifdef MHD
-                  pG->U[k][j][i].B3c = jn(mm,lambdamn*x1c)*cos(mm*x2c);
+                  GRID_U(pG,k,j,i,B3c) = jn(mm,lambdamn*x1c)*cos(mm*x2c);
                   pG->B3i[k][j][i]   = jn(mm,lambdamn*x1f)*cos(mm*x2f);
 #endif
 
@@ -126,7 +127,7 @@ void problem(DomainS *pDomain)
 #endif
 
 #ifdef MHD
-                  pG->U[k][j][i].B3c = 1.0-SQR(x1c);
+                  GRID_U(pG,k,j,i,B3c) = 1.0-SQR(x1c);
                   pG->B3i[k][j][i]   = 1.0-SQR(x1f);
 #endif
                   break;
@@ -134,7 +135,7 @@ void problem(DomainS *pDomain)
                   ath_error("[cyldiff]:  Not an accepted problem number\n");
         }
 
-        RootSoln[k][j][i] = pG->U[k][j][i].B3c;
+        RootSoln[k][j][i] = GRID_U(pG,k,j,i,B3c);
       }
     }
   }
@@ -243,7 +244,7 @@ void Userwork_after_loop(MeshS *pM)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        error += fabs(pG->U[k][j][i].B3c - RootSoln[k][j][i]*tfact);
+        error += fabs(GRID_U(pG,k,j,i,B3c) - RootSoln[k][j][i]*tfact);
       }
     }
   }
@@ -307,13 +308,13 @@ void cyldiff_ix1(GridS *pG)
           case 1:        
 #ifdef MHD
 
-            pG->U[k][j][is-i].B3c = jn(mm,lambdamn*x1c)*cos(mm*x2c)*exp(-om_diff*pG->time);
+            GRID_U(pG,k,j,is-i,B3c) = jn(mm,lambdamn*x1c)*cos(mm*x2c)*exp(-om_diff*pG->time);
             pG->B3i[k][j][is-i]   = jn(mm,lambdamn*x1f)*cos(mm*x2f)*exp(-om_diff*pG->time);
 #endif
             break;
           default:
 #ifdef MHD
-            pG->U[k][j][is-i].B3c = pG->U[k][j][is].B3c;
+            GRID_U(pG,k,j,is-i,B3c) = GRID_U(pG,k,j,is,B3c);
             pG->B3i[k][j][is-i]   = pG->B3i[k][j][is];
 #endif
         }
@@ -348,13 +349,13 @@ void cyldiff_ox1(GridS *pG)
         switch(iprob){
           case 1:        
 #ifdef MHD
-            pG->U[k][j][ie+i].B3c = 0.;
+            GRID_U(pG,k,j,ie+i,B3c) = 0.;
             pG->B3i[k][j][ie+i]   = 0.;
 #endif
             break;
           default:
 #ifdef MHD
-            pG->U[k][j][ie+i].B3c = pG->U[k][j][ie].B3c;
+            GRID_U(pG,k,j,ie+i,B3c) = GRID_U(pG,k,j,ie,B3c);
             pG->B3i[k][j][ie+i]   = pG->B3i[k][j][ie];
 #endif
         }
@@ -385,13 +386,13 @@ void cyldiff_ix2(GridS *pG)
         switch(iprob){
           case 1:        
 #ifdef MHD
-            pG->U[k][js-j][i].B3c = 0.;
+            GRID_U(pG,k,js-j,i,B3c) = 0.;
             pG->B3i[k][js-j][i]   = 0.;
 #endif
             break;
           default:
 #ifdef MHD
-            pG->U[k][js-j][i].B3c = pG->U[k][js][i].B3c;
+            GRID_U(pG,k,js-j,i,B3c) = GRID_U(pG,k,js,i,B3c);
             pG->B3i[k][js-j][i]   = pG->B3i[k][js][i];
 #endif
         }
@@ -423,13 +424,13 @@ void cyldiff_ox2(GridS *pG)
         switch(iprob){
           case 1:        
 #ifdef MHD
-            pG->U[k][je+j][i].B3c = 0.;
+            GRID_U(pG,k,je+j,i,B3c) = 0.;
             pG->B3i[k][je+j][i]   = 0.;
 #endif
             break;
           default:
 #ifdef MHD
-            pG->U[k][je+j][i].B3c = pG->U[k][je][i].B3c;
+            GRID_U(pG,k,je+j,i,B3c) = GRID_U(pG,k,je,i,B3c);
             pG->B3i[k][je+j][i]   = pG->B3i[k][je][i];
 #endif
         }
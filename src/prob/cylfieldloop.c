@@ -50,6 +50,7 @@ void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
   int i=0,j=0,k=0;
+  ConsS Uzero = {0.0};
   int is,ie,js,je,ks,ke,nx1,nx2,nx3;
   int il,iu,jl,ju,kl,ku;
   Real x1,x2,x3,lsf,rsf;
@@ -92,16 +93,16 @@ void problem(DomainS *pDomain)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
-        memset(&(pG->U[k][j][i]),0.0,sizeof(ConsS));
+        SET_GRID_U(pG,k,j,i,Uzero);
 
-        pG->U[k][j][i].d  = rho0;
-        pG->U[k][j][i].M1 = 0.0;
+        GRID_U(pG,k,j,i,d)  = rho0;
+        GRID_U(pG,k,j,i,M1) = 0.0;
 #ifndef FARGO
-        pG->U[k][j][i].M2 = pG->U[k][j][i].d*x1*omega0;
+        GRID_U(pG,k,j,i,M2) = GRID_U(pG,k,j,i,d)*x1*omega0;
 #else
-        pG->U[k][j][i].M2 = 0;
+        GRID_U(pG,k,j,i,M2) = 0;
 #endif
-        pG->U[k][j][i].M3 = pG->U[k][j][i].d*vz0;
+        GRID_U(pG,k,j,i,M3) = GRID_U(pG,k,j,i,d)*vz0;
         pG->B1i[k][j][i]  = vecpot2b1i(NULL,A3,pG,i,j,k);
         pG->B2i[k][j][i]  = vecpot2b2i(NULL,A3,pG,i,j,k);
         pG->B3i[k][j][i]  = 0.0;
@@ -118,31 +119,31 @@ void problem(DomainS *pDomain)
         rsf = (x1 + 0.5*pG->dx1)/x1;
 
         if (i < iu) 
-          pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
+          GRID_U(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*pG->B1i[k][j][i+1]);
         else
-          pG->U[k][j][i].B1c = 0.5*(lsf*pG->B1i[k][j][i] + rsf*vecpot2b1i(NULL,A3,pG,i+1,j,k));
+          GRID_U(pG,k,j,i,B1c) = 0.5*(lsf*pG->B1i[k][j][i] + rsf*vecpot2b1i(NULL,A3,pG,i+1,j,k));
 
         if (j < ju) 
-          pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+          GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
         else
-          pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + vecpot2b2i(NULL,A3,pG,i,j+1,k));
+          GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + vecpot2b2i(NULL,A3,pG,i,j+1,k));
 
         if (ke > ks)
           if (k < ku)
-            pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+            GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
           else
-            pG->U[k][j][i].B3c = 0.0;
+            GRID_U(pG,k,j,i,B3c) = 0.0;
         else
-          pG->U[k][j][i].B3c = pG->B3i[k][j][i];
+          GRID_U(pG,k,j,i,B3c) = pG->B3i[k][j][i];
 
 #ifndef ISOTHERMAL
-        pG->U[k][j][i].E = 1.0/Gamma_1 
-          + 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c))
-          + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) + SQR(pG->U[k][j][i].M3))/pG->U[k][j][i].d;
+        GRID_U(pG,k,j,i,E) = 1.0/Gamma_1 
+          + 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)))
+          + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) + SQR(GRID_U(pG,k,j,i,M3)))/GRID_U(pG,k,j,i,d);
 #endif /* ISOTHERMAL */
 
         // Save solution
-        RootSoln[k][j][i] = pG->U[k][j][i];
+        RootSoln[k][j][i] = GET_GRID_U(pG,k,j,i);
       }
     }
   }
@@ -157,35 +157,35 @@ void problem(DomainS *pDomain)
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
         x1 = x1vc(pG,i);
         r = 2.0*rand()/((double)RAND_MAX) - 1.0;
-        pG->U[k][j][i].d = rho0;
+        GRID_U(pG,k,j,i,d) = rho0;
 #ifdef FARGO
-        pG->U[k][j][i].M2 = 0.0;
+        GRID_U(pG,k,j,i,M2) = 0.0;
 #else
-        pG->U[k][j][i].M2 = pG->U[k][j][i].d*avg1d(vphi,pG,i,j,k);
+        GRID_U(pG,k,j,i,M2) = GRID_U(pG,k,j,i,d)*avg1d(vphi,pG,i,j,k);
 #endif
-        pG->U[k][j][i].M2 += pG->U[k][j][i].d*Amp*r*Iso_csound*ChiMag(x1);
+        GRID_U(pG,k,j,i,M2) += GRID_U(pG,k,j,i,d)*Amp*r*Iso_csound*ChiMag(x1);
 				r = 2.0*rand()/((double)RAND_MAX)-1.0;
-        pG->U[k][j][i].M1 = 0.0;
-        pG->U[k][j][i].M3 = pG->U[k][j][i].d*Amp*r*Iso_csound*ChiMag(x1);
+        GRID_U(pG,k,j,i,M1) = 0.0;
+        GRID_U(pG,k,j,i,M3) = GRID_U(pG,k,j,i,d)*Amp*r*Iso_csound*ChiMag(x1);
 #ifdef MHD
-        pG->U[k][j][i].B1c = 0.0;
+        GRID_U(pG,k,j,i,B1c) = 0.0;
 
         if (Field == 2) {
-        	pG->U[k][j][i].B2c = BpNet(x1,x2,x3);
+        	GRID_U(pG,k,j,i,B2c) = BpNet(x1,x2,x3);
         } else {
-          pG->U[k][j][i].B2c = 0.0;
+          GRID_U(pG,k,j,i,B2c) = 0.0;
         }
         if (Field == 0) {
-          pG->U[k][j][i].B3c = BzZero(x1,x2,x3);
+          GRID_U(pG,k,j,i,B3c) = BzZero(x1,x2,x3);
         } else if (Field == 1) {
-          pG->U[k][j][i].B3c = BzNet(x1,x2,x3);
+          GRID_U(pG,k,j,i,B3c) = BzNet(x1,x2,x3);
         } else {
-        	pG->U[k][j][i].B3c = 0.0;
+        	GRID_U(pG,k,j,i,B3c) = 0.0;
         }
 
         pG->B1i[k][j][i] = 0.0;
-        pG->B2i[k][j][i] = pG->U[k][j][i].B2c;
-        pG->B3i[k][j][i] = pG->U[k][j][i].B3c;
+        pG->B2i[k][j][i] = GRID_U(pG,k,j,i,B2c);
+        pG->B3i[k][j][i] = GRID_U(pG,k,j,i,B3c);
 
 #endif
 
@@ -242,7 +242,7 @@ static Real MdotR1(const GridS *pG, const int i, const int j, const int k) {
 
 	cc_pos(pG,i,j,k,&R,&phi,&z);
 	if ((R0 > (R-dR)) && (R0 < (R+dR))) {
-		Md = -1.0*pG->U[k][j][i].M1/dR;
+		Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
 	} else {
 		Md = 0.0;
 	}
@@ -255,7 +255,7 @@ static Real MdotR2(const GridS *pG, const int i, const int j, const int k) {
 
 	cc_pos(pG,i,j,k,&R,&phi,&z);
 	if ((R0 > (R-dR)) && (R0 < (R+dR))) {
-		Md = -1.0*pG->U[k][j][i].M1/dR;
+		Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
 	} else {
 		Md = 0.0;
 	}
@@ -267,7 +267,7 @@ static Real MdotR3(const GridS *pG, const int i, const int j, const int k) {
 
 	cc_pos(pG,i,j,k,&R,&phi,&z);
 	if ((R0 > (R-dR)) && (R0 < (R+dR))) {
-		Md = -1.0*pG->U[k][j][i].M1/dR;
+		Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
 	} else {
 		Md = 0.0;
 	}
@@ -278,7 +278,7 @@ static Real MdotR4(const GridS *pG, const int i, const int j, const int k) {
 
 	cc_pos(pG,i,j,k,&R,&phi,&z);
 	if ((R0 > (R-dR)) && (R0 < (R+dR))) {
-		Md = -1.0*pG->U[k][j][i].M1/dR;
+		Md = -1.0*GRID_U(pG,k,j,i,M1)/dR;
 	} else {
 		Md = 0.0;
 	}
@@ -287,7 +287,7 @@ static Real MdotR4(const GridS *pG, const int i, const int j, const int k) {
 static Real Pb(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-	return ( 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c)) );
+	return ( 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c))) );
 #else
 	return 0.0;
 #endif
@@ -296,7 +296,7 @@ static Real Pb(const GridS *pG, const int i, const int j, const int k)
 static Real Mrp(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-	return ( -1.0*pG->U[k][j][i].B1c*pG->U[k][j][i].B2c );  
+	return ( -1.0*GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c) );  
 #else
 	return 0.0;
 #endif
@@ -305,19 +305,19 @@ static Real Mrp(const GridS *pG, const int i, const int j, const int k)
 static Real Trp(const GridS *pG, const int i, const int j, const int k)
 {
 	// Note, this assumes Fargo to calculate perturbation Vp
-	return ((pG->U[k][j][i].M1*pG->U[k][j][i].M2)/(pG->U[k][j][i].d));
+	return ((GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M2))/(GRID_U(pG,k,j,i,d)));
 }
 static Real Vaz(const GridS *pG, const int i, const int j, const int k)
 {
 #ifdef MHD
-	return (fabs(pG->U[k][j][i].B3c)/sqrt(pG->U[k][j][i].d));
+	return (fabs(GRID_U(pG,k,j,i,B3c))/sqrt(GRID_U(pG,k,j,i,d)));
 #else
 	return 0.0;
 #endif
 }
 static Real Br(const GridS *pG, const int i, const int j, const int k) {
 #ifdef MHD
-	return pG->U[k][j][i].B1c;
+	return GRID_U(pG,k,j,i,B1c);
 #else
 	return 0.0;
 #endif
@@ -325,7 +325,7 @@ static Real Br(const GridS *pG, const int i, const int j, const int k) {
 }
 static Real Bp(const GridS *pG, const int i, const int j, const int k) {
 #ifdef MHD
-	return pG->U[k][j][i].B2c;
+	return GRID_U(pG,k,j,i,B2c);
 #else
 	return 0.0;
 #endif
@@ -333,22 +333,22 @@ static Real Bp(const GridS *pG, const int i, const int j, const int k) {
 }
 static Real Bz(const GridS *pG, const int i, const int j, const int k) {
 #ifdef MHD
-	return pG->U[k][j][i].B3c;
+	return GRID_U(pG,k,j,i,B3c);
 #else
 	return 0.0;
 #endif
 
 }
 static Real Vr(const GridS *pG, const int i, const int j, const int k) {
-	return (pG->U[k][j][i].M1/pG->U[k][j][i].d);
+	return (GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d));
 
 }
 static Real Vp(const GridS *pG, const int i, const int j, const int k) {
-	return (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+	return (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 
 }
 static Real Vz(const GridS *pG, const int i, const int j, const int k) {
-	return (pG->U[k][j][i].M3/pG->U[k][j][i].d);
+	return (GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d));
 
 }
 
@@ -357,7 +357,7 @@ static Real Msub(const GridS *pG, const int i, const int j, const int k) {
 
 	R = x1vc(pG,i);
 	I = ChiSub(R);
-	return (pG->U[k][j][i].d*I);
+	return (GRID_U(pG,k,j,i,d)*I);
 }
 
 static Real Mrpsub(const GridS *pG, const int i, const int j, const int k) {
@@ -366,7 +366,7 @@ static Real Mrpsub(const GridS *pG, const int i, const int j, const int k) {
 	R = x1vc(pG,i);
 	I = ChiSub(R);
 #ifdef MHD
-	return (-1.0*pG->U[k][j][i].B1c*pG->U[k][j][i].B2c*I);
+	return (-1.0*GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c)*I);
 #else
 	return 0.0;
 #endif
@@ -379,7 +379,7 @@ static Real Bpsub(const GridS *pG, const int i, const int j, const int k) {
 	R = x1vc(pG,i);
 	I = ChiSub(R);
 #ifdef MHD
-	return (pG->U[k][j][i].B2c*I);
+	return (GRID_U(pG,k,j,i,B2c)*I);
 #else
 	return 0.0;
 #endif
@@ -392,7 +392,7 @@ static Real Bzsub(const GridS *pG, const int i, const int j, const int k) {
 	R = x1vc(pG,i);
 	I = ChiSub(R);
 #ifdef MHD
-	return (pG->U[k][j][i].B3c*I);
+	return (GRID_U(pG,k,j,i,B3c)*I);
 #else
 	return 0.0;
 #endif
@@ -405,7 +405,7 @@ static Real Pbsub(const GridS *pG, const int i, const int j, const int k) {
 	R = x1vc(pG,i);
 	I = ChiSub(R);
 #ifdef MHD
-	return (0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c))*I);
+	return (0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)))*I);
 #else
 	return 0.0;
 #endif
@@ -534,12 +534,12 @@ void ScaleToBeta(GridS *pG, Real beta) {
       for (i=is; i<=ie; i++) {
 				CellVol = (pG->r[i])*(pG->dx1)*(pG->dx2)*(pG->dx3);
 #ifndef ISOTHERMAL
-        Pgas += (Gamma-1)*pG->U[k][j][i].E*CellVol;
+        Pgas += (Gamma-1)*GRID_U(pG,k,j,i,E)*CellVol;
 #else
-        Pgas += Iso_csound2*pG->U[k][j][i].d*CellVol;
+        Pgas += Iso_csound2*GRID_U(pG,k,j,i,d)*CellVol;
 #endif
-        Pb += 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c)
-              + SQR(pG->U[k][j][i].B3c))*CellVol;
+        Pb += 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c))
+              + SQR(GRID_U(pG,k,j,i,B3c)))*CellVol;
       }
     }
   }
@@ -558,9 +558,9 @@ void ScaleToBeta(GridS *pG, Real beta) {
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i].B1c *= scl;
-        pG->U[k][j][i].B2c *= scl;
-        pG->U[k][j][i].B3c *= scl;
+        GRID_U(pG,k,j,i,B1c) *= scl;
+        GRID_U(pG,k,j,i,B2c) *= scl;
+        GRID_U(pG,k,j,i,B3c) *= scl;
         pG->B1i[k][j][i]   *= scl;
         pG->B2i[k][j][i]   *= scl;
         pG->B3i[k][j][i]   *= scl;
@@ -588,40 +588,40 @@ void disk_ir(GridS *pGrid) {
 #endif
     	// Calculate angular momentum in rotating frame
 #ifdef FARGO
-    	Lper = R*pGrid->U[k][j][is].M2;
+    	Lper = R*GRID_U(pGrid,k,j,is,M2);
 #else
 //    	Vkep = sqrt(R*(*x1GravAcc)(R,p,z));//JB
     	Vkep = sqrt(R*grav_acc(R,p,z));//JB
-    	Lper = R*pGrid->U[k][j][is].M2 - R*pGrid->U[k][j][is].d*Vkep;
+    	Lper = R*GRID_U(pGrid,k,j,is,M2) - R*GRID_U(pGrid,k,j,is,d)*Vkep;
 #endif
     	Lper = MIN(Lper,0.0);
 
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][is];
+        SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j,is));
 				// Enforce diode
-				pGrid->U[k][j][is-i].M1 = MIN(pGrid->U[k][j][is-i].M1,0.0);
+				GRID_U(pGrid,k,j,is-i,M1) = MIN(GRID_U(pGrid,k,j,is-i,M1),0.0);
 				// Calculate Keplerian velocity
 				cc_pos(pGrid,is-i,j,k,&R,&p,&z);
 //				Vkep = sqrt(R*(*x1GravAcc)(R,p,z));//JB
 				Vkep = sqrt(R*grav_acc(R,p,z));//JB
 #ifdef FARGO
 				if (Hbc == 1) {
-					pGrid->U[k][j][is-i].M2 = 0.0;
+					GRID_U(pGrid,k,j,is-i,M2) = 0.0;
 				} else {
-					pGrid->U[k][j][is-i].M2 = Lper/R;
+					GRID_U(pGrid,k,j,is-i,M2) = Lper/R;
 				}
 #else
 				if (Hbc == 1) {
-					pGrid->U[k][j][is-i].M2 = pGrid->U[k][j][is].d*Vkep;
+					GRID_U(pGrid,k,j,is-i,M2) = GRID_U(pGrid,k,j,is,d)*Vkep;
 				} else {
-					pGrid->U[k][j][is-i].M2 = Lper/R + pGrid->U[k][j][is-i].d*Vkep;
+					GRID_U(pGrid,k,j,is-i,M2) = Lper/R + GRID_U(pGrid,k,j,is-i,d)*Vkep;
 				}
 #endif
 #ifdef MHD
 				if (Mbc == 0) {
-					pGrid->U[k][j][is-i].B1c = RBr/R;
-					pGrid->U[k][j][is-i].B2c = 0.0;
-					pGrid->U[k][j][is-i].B3c = 0.0;
+					GRID_U(pGrid,k,j,is-i,B1c) = RBr/R;
+					GRID_U(pGrid,k,j,is-i,B2c) = 0.0;
+					GRID_U(pGrid,k,j,is-i,B3c) = 0.0;
 				}
 #endif
       }
@@ -696,39 +696,39 @@ void disk_or(GridS *pGrid) {
 #endif
     	// Calculate angular momentum in rotating frame
 #ifdef FARGO
-    	Lper = pGrid->r[ie]*pGrid->U[k][j][ie].M2;
+    	Lper = pGrid->r[ie]*GRID_U(pGrid,k,j,ie,M2);
 #else
 			cc_pos(pGrid,ie,j,k,&R,&p,&z);
 //			Vkep = sqrt(R*(*x1GravAcc)(R,p,z));//JB
 			Vkep = sqrt(R*grav_acc(R,p,z));//JB
-//			Lper = R*pGrid->U[k][j][ie].M2 - x1p*pGrid->U[k][j][ie]*Vkep;//JB
-			Lper = R*pGrid->U[k][j][ie].M2 - R*pGrid->U[k][j][ie].d*Vkep;//JB
+//			Lper = R*GRID_U(pGrid,k,j,ie,M2) - x1p*GRID_U(pGrid,k,j,ie,d)*Vkep;//JB
+			Lper = R*GRID_U(pGrid,k,j,ie,M2) - R*GRID_U(pGrid,k,j,ie,d)*Vkep;//JB
 #endif
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][ie];
+        SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j,ie));
 				// Enforce diode
-				pGrid->U[k][j][ie+i].M1 = MAX(pGrid->U[k][j][ie+i].M1,0.0);
+				GRID_U(pGrid,k,j,ie+i,M1) = MAX(GRID_U(pGrid,k,j,ie+i,M1),0.0);
 				cc_pos(pGrid,ie+i,j,k,&R,&p,&z);
 //				Vkep = sqrt(R*(*x1GravAcc)(R,p,z));//JB
 				Vkep = sqrt(R*grav_acc(R,p,z));//JB
 #ifdef FARGO
 				if (Hbc == 1) {
-					pGrid->U[k][j][ie+i].M2 = 0.0;
+					GRID_U(pGrid,k,j,ie+i,M2) = 0.0;
 				} else {
-					pGrid->U[k][j][ie+i].M2 = Lper/R;
+					GRID_U(pGrid,k,j,ie+i,M2) = Lper/R;
 				}
 #else
 				if (Hbc == 1) {
-					pGrid->U[k][j][ie+i].M2 = pGrid->U[k][j][ie].d*Vkep;
+					GRID_U(pGrid,k,j,ie+i,M2) = GRID_U(pGrid,k,j,ie,d)*Vkep;
 				} else {
-					pGrid->U[k][j][ie+i].M2 = Lper/R + pGrid->U[k][j][ie+i].d*Vkep;
+					GRID_U(pGrid,k,j,ie+i,M2) = Lper/R + GRID_U(pGrid,k,j,ie+i,d)*Vkep;
 				}
 #endif
 #ifdef MHD
 				if (Mbc == 0) {
-					pGrid->U[k][j][ie+i].B1c = RBr/R;
-					pGrid->U[k][j][ie+i].B2c = 0.0;
-					pGrid->U[k][j][ie+i].B3c = 0.0;
+					GRID_U(pGrid,k,j,ie+i,B1c) = RBr/R;
+					GRID_U(pGrid,k,j,ie+i,B2c) = 0.0;
+					GRID_U(pGrid,k,j,ie+i,B3c) = 0.0;
 				}
 #endif
 	
@@ -890,7 +890,7 @@ static void dump_vtksub(MeshS *pM, OutputS *pOut) {
 	for (k = kl; k <= ku; k++) {
 		for (j = jl; j <= ju; j++) {
 			for (i = il; i <= iu; i++) {
-				data[i - il] = (float) pGrid->U[k][j][i].d;
+				data[i - il] = (float) GRID_U(pGrid,k,j,i,d);
 			}
 			if (!big_end)
 				ath_bswap(data, sizeof(float), iu - il + 1);
@@ -904,9 +904,9 @@ static void dump_vtksub(MeshS *pM, OutputS *pOut) {
 	for (k = kl; k <= ku; k++) {
 		for (j = jl; j <= ju; j++) {
 			for (i = il; i <= iu; i++) {
-				data[3 * (i - il)] = (float) pGrid->U[k][j][i].M1;
-				data[3 * (i - il) + 1] = (float) pGrid->U[k][j][i].M2;
-				data[3 * (i - il) + 2] = (float) pGrid->U[k][j][i].M3;
+				data[3 * (i - il)] = (float) GRID_U(pGrid,k,j,i,M1);
+				data[3 * (i - il) + 1] = (float) GRID_U(pGrid,k,j,i,M2);
+				data[3 * (i - il) + 2] = (float) GRID_U(pGrid,k,j,i,M3);
 			}
 			if (!big_end)
 				ath_bswap(data, sizeof(float), 3 * (iu - il + 1));
@@ -921,9 +921,9 @@ static void dump_vtksub(MeshS *pM, OutputS *pOut) {
 	for (k = kl; k <= ku; k++) {
 		for (j = jl; j <= ju; j++) {
 			for (i = il; i <= iu; i++) {
-				data[3 * (i - il)] = (float) pGrid->U[k][j][i].B1c;
-				data[3 * (i - il) + 1] = (float) pGrid->U[k][j][i].B2c;
-				data[3 * (i - il) + 2] = (float) pGrid->U[k][j][i].B3c;
+				data[3 * (i - il)] = (float) GRID_U(pGrid,k,j,i,B1c);
+				data[3 * (i - il) + 1] = (float) GRID_U(pGrid,k,j,i,B2c);
+				data[3 * (i - il) + 2] = (float) GRID_U(pGrid,k,j,i,B3c);
 			}
 			if (!big_end)
 				ath_bswap(data, sizeof(float), 3 * (iu - il + 1));
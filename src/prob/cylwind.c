@@ -40,6 +40,7 @@ void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
   int i,j,k,converged;
+  ConsS Uzero = {0.0};
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3; 
   Real x1,x2,x3,a,b;
@@ -78,7 +79,7 @@ void problem(DomainS *pDomain)
 
   for (i=il; i<=iu; i++) {
     cc_pos(pG,i,js,ks,&x1,&x2,&x3);
-    memset(&(pG->U[ks][js][i]),0.0,sizeof(ConsS));
+    SET_GRID_U(pG,ks,js,i,Uzero);
 
     switch(iprob) {
       case 1: /* Parker wind */
@@ -103,21 +104,21 @@ void problem(DomainS *pDomain)
     converged = bisection(myfunc,a,b,x1,&v);
     if (!converged) ath_error("[cylwind]:  Bisection did not converge!\n");
 
-    pG->U[ks][js][i].d   = lambda_s/(x1*v);
-    pG->U[ks][js][i].M1  = lambda_s/x1;
+    GRID_U(pG,ks,js,i,d)   = lambda_s/(x1*v);
+    GRID_U(pG,ks,js,i,M1)  = lambda_s/x1;
     if (iprob==2)
-      pG->U[ks][js][i].M1  *= -1.0;
+      GRID_U(pG,ks,js,i,M1)  *= -1.0;
 
 #ifdef MHD
-    pG->U[ks][js][i].B1c = b0/x1;
+    GRID_U(pG,ks,js,i,B1c) = b0/x1;
     pG->B1i[ks][js][i]   = b0/(x1-0.5*pG->dx1);
 #endif /* MHD */
 
     /* Initialize total energy */
 #ifndef ISOTHERMAL
     pgas0 = 1.0/Gamma;
-    pgas = pgas0*pow(pG->U[ks][js][i].d,Gamma);
-    pG->U[ks][js][i].E = pgas/Gamma_1 + 0.5*SQR(pG->U[ks][js][i].M1)/pG->U[ks][js][i].d;
+    pgas = pgas0*pow(GRID_U(pG,ks,js,i,d),Gamma);
+    GRID_U(pG,ks,js,i,E) = pgas/Gamma_1 + 0.5*SQR(GRID_U(pG,ks,js,i,M1))/GRID_U(pG,ks,js,i,d);
 #endif /* ISOTHERMAL */
   }
 
@@ -125,8 +126,8 @@ void problem(DomainS *pDomain)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i] = pG->U[ks][js][i];
-        RootSoln[k][j][i] = pG->U[k][j][i];
+        SET_GRID_U(pG,k,j,i,GET_GRID_U(pG,ks,js,i));
+        RootSoln[k][j][i] = GET_GRID_U(pG,k,j,i);
       }
     }
   }
@@ -34,6 +34,7 @@ void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
   int i,j,k;
+  ConsS Uzero = {0.0};
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1,nx2,nx3;
   Real x1,x2,x3;
@@ -82,7 +83,7 @@ void problem(DomainS *pDomain)
   // Compute 1D wind/accretion solution
   for (i=il; i<=iu; i++) {
     cc_pos(pG,i,j,k,&x1,&x2,&x3);
-    memset(&(pG->U[ks][js][i]),0.0,sizeof(ConsS));
+    SET_GRID_U(pG,ks,js,i,Uzero);
     vs = pow(lambda_s/x1,0.5*beta);
 
     switch(iprob) {
@@ -108,19 +109,19 @@ void problem(DomainS *pDomain)
     converged = bisection(myfunc,a,b,x1,&v);
     if (!converged) ath_error("[cylwindrot]:  Bisection did not converge!\n");
 
-    pG->U[ks][js][i].d   = lambda_s/(x1*v);
-    pG->U[ks][js][i].M1  = lambda_s/x1;
+    GRID_U(pG,ks,js,i,d)   = lambda_s/(x1*v);
+    GRID_U(pG,ks,js,i,M1)  = lambda_s/x1;
     if (iprob==2)
-      pG->U[ks][js][i].M1  *= -1.0;
-    pG->U[ks][js][i].M2  = pG->U[ks][js][i].d*ang_mom/x1;
-    pG->U[ks][js][i].M3  = pG->U[ks][js][i].d*vz0;
+      GRID_U(pG,ks,js,i,M1)  *= -1.0;
+    GRID_U(pG,ks,js,i,M2)  = GRID_U(pG,ks,js,i,d)*ang_mom/x1;
+    GRID_U(pG,ks,js,i,M3)  = GRID_U(pG,ks,js,i,d)*vz0;
 
         /* Initialize total energy */
 #ifndef ISOTHERMAL
         pgas0 = 1.0/Gamma;
-        pgas = pgas0*pow(pG->U[ks][js][i].d,Gamma);
-        pG->U[ks][js][i].E = pgas/Gamma_1
-          + 0.5*(SQR(pG->U[ks][js][i].M1) + SQR(pG->U[ks][js][i].M2) + SQR(pG->U[ks][js][i].M3))/pG->U[ks][js][i].d;
+        pgas = pgas0*pow(GRID_U(pG,ks,js,i,d),Gamma);
+        GRID_U(pG,ks,js,i,E) = pgas/Gamma_1
+          + 0.5*(SQR(GRID_U(pG,ks,js,i,M1)) + SQR(GRID_U(pG,ks,js,i,M2)) + SQR(GRID_U(pG,ks,js,i,M3)))/GRID_U(pG,ks,js,i,d);
 #endif /* ISOTHERMAL */
   }
 
@@ -128,8 +129,8 @@ void problem(DomainS *pDomain)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i] = pG->U[ks][js][i];
-        RootSoln[k][j][i] = pG->U[ks][js][i];
+        SET_GRID_U(pG,k,j,i,GET_GRID_U(pG,ks,js,i));
+        RootSoln[k][j][i] = GET_GRID_U(pG,ks,js,i);
       }
     }
   }
@@ -36,6 +36,7 @@ void problem(DomainS *pDomain)
 {
   GridS *pG = pDomain->Grid;
   int i,j,k,n,converged;
+  ConsS Uzero = {0.0};
   int is,ie,il,iu,js,je,jl,ju,ks,ke,kl,ku;
   int nx1, nx2, nx3;
   Real x1, x2, x3;
@@ -43,7 +44,7 @@ void problem(DomainS *pDomain)
   Real x,y,xslow,yslow,xfast,yfast;
   Real R0,R1,R2,rho,Mdot,K,Omega,Pgas,beta,vR,BR,vphi,Bphi;
   ConsS *Wind=NULL;
-  Real *pU=NULL,*pUl=NULL,*pUr=NULL;
+  Real *pUl=NULL,*pUr=NULL;
   Real lsf,rsf;
 
   is = pG->is;  ie = pG->ie;  nx1 = ie-is+1;
@@ -156,16 +157,15 @@ void problem(DomainS *pDomain)
 
   /* Average the wind solution across the zone for cc variables */
   for (i=il; i<=iu; i++) {
-    memset(&(pG->U[ks][js][i]),0.0,sizeof(ConsS));
+    SET_GRID_U(pG,ks,js,i,Uzero);
     cc_pos(pG,i,js,ks,&x1,&x2,&x3);
     lsf = (x1 - 0.5*pG->dx1)/x1;
     rsf = (x1 + 0.5*pG->dx1)/x1;
 
-    pU  = (Real*)&(pG->U[ks][js][i]);
     pUl = (Real*)&(Wind[i]);
     pUr = (Real*)&(Wind[i+1]);
     for (n=0; n<NWAVE; n++) {
-      pU[n] = 0.5*(lsf*pUl[n] + rsf*pUr[n]);
+      GRID_UN(pG,ks,js,i,n) = 0.5*(lsf*pUl[n] + rsf*pUr[n]);
     }
 
     pG->B1i[ks][js][i]   = Wind[i].B1c;
@@ -177,11 +177,11 @@ void problem(DomainS *pDomain)
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i] = pG->U[ks][js][i];
+        SET_GRID_U(pG,k,j,i,GET_GRID_U(pG,ks,js,i));
         pG->B1i[k][j][i] = pG->B1i[ks][js][i];
         pG->B2i[k][j][i] = pG->B2i[ks][js][i];
         pG->B3i[k][j][i] = pG->B3i[ks][js][i];
-        RootSoln[k][j][i]  = pG->U[ks][js][i];
+        RootSoln[k][j][i]  = GET_GRID_U(pG,ks,js,i);
       }
     }
   }
@@ -63,10 +63,10 @@ void problem(DomainS *pD)
       for (i=is; i<=ie; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
         r2=SQR(x1)+SQR(x2)+SQR(x3);
-        pG->U[k][j][i].d = exp(-r2);
-        pG->U[k][j][i].M1 = 0.0;
-        pG->U[k][j][i].M2 = 0.0;
-        pG->U[k][j][i].M3 = 0.0;
+        GRID_U(pG,k,j,i,d) = exp(-r2);
+        GRID_U(pG,k,j,i,M1) = 0.0;
+        GRID_U(pG,k,j,i,M2) = 0.0;
+        GRID_U(pG,k,j,i,M3) = 0.0;
       }
     }
   }
@@ -202,8 +202,8 @@ void do_fft(DomainS *pD)
         for (i=is; i<=ie; i++) {
           cc_pos(pG,i,j,k,&x1,&x2,&x3);
           r2=SQR(x1)+SQR(x2)+SQR(x3);
-          pG->U[k][j][i].d = exp(-r2);
-          work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] = pG->U[k][j][i].d;
+          GRID_U(pG,k,j,i,d) = exp(-r2);
+          work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0] = GRID_U(pG,k,j,i,d);
         }
       }
     }
@@ -213,8 +213,8 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M1 = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0];
-          pG->U[k][j][i].M2 = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1];
+          GRID_U(pG,k,j,i,M1) = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0];
+          GRID_U(pG,k,j,i,M2) = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][1];
         }
       }
     }
@@ -224,7 +224,7 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M3 = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0]/pD->bplan3d->gcnt;
+          GRID_U(pG,k,j,i,M3) = work[F3DI(i-is,j-js,k-ks,pG->Nx[0],pG->Nx[1],pG->Nx[2])][0]/pD->bplan3d->gcnt;
         }
       }
     }
@@ -237,8 +237,8 @@ void do_fft(DomainS *pD)
         for (i=is; i<=ie; i++) {
           cc_pos(pG,i,j,k,&x1,&x2,&x3);
           r2=SQR(x1)+SQR(x2);
-          pG->U[k][j][i].d = exp(-r2);
-          work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] = pG->U[k][j][i].d;
+          GRID_U(pG,k,j,i,d) = exp(-r2);
+          work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0] = GRID_U(pG,k,j,i,d);
         }
       }
     }
@@ -248,8 +248,8 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M1 = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0];
-          pG->U[k][j][i].M2 = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1];
+          GRID_U(pG,k,j,i,M1) = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0];
+          GRID_U(pG,k,j,i,M2) = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][1];
         }
       }
     }
@@ -259,7 +259,7 @@ void do_fft(DomainS *pD)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].M3 = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0]/pD->bplan2d->gcnt;
+          GRID_U(pG,k,j,i,M3) = work[F2DI(i-is,j-js,pG->Nx[0],pG->Nx[1])][0]/pD->bplan2d->gcnt;
         }
       }
     }
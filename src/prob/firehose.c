@@ -77,26 +77,26 @@ void problem(Grid *pGrid, Domain *pDomain)
 /* Calculate the cell center positions */
       cc_pos(pGrid,i,j,ks,&x1,&x2,&x3);
 
-      pGrid->U[ks][j][i].d = d0;
-      pGrid->U[ks][j][i].M1 = -d0*v0*cos(k0*x2)*sin(k0*x1);
-      pGrid->U[ks][j][i].M2 = d0*v0*sin(k0*x2)*cos(k0*x1)+amp*cos(kp*x1);
-      pGrid->U[ks][j][i].M3 = 0.0;
+      GRID_U(pGrid,ks,j,i,d) = d0;
+      GRID_U(pGrid,ks,j,i,M1) = -d0*v0*cos(k0*x2)*sin(k0*x1);
+      GRID_U(pGrid,ks,j,i,M2) = d0*v0*sin(k0*x2)*cos(k0*x1)+amp*cos(kp*x1);
+      GRID_U(pGrid,ks,j,i,M3) = 0.0;
 #ifdef MHD
       pGrid->B1i[ks][j][i] = B0;
       pGrid->B2i[ks][j][i] = 0.0;
       pGrid->B3i[ks][j][i] = 0.0;
-      pGrid->U[ks][j][i].B1c = B0;
-      pGrid->U[ks][j][i].B2c = 0.0;
-      pGrid->U[ks][j][i].B3c = 0.0;
+      GRID_U(pGrid,ks,j,i,B1c) = B0;
+      GRID_U(pGrid,ks,j,i,B2c) = 0.0;
+      GRID_U(pGrid,ks,j,i,B3c) = 0.0;
 #endif /* MHD */
       press = p0 + 0.5*d0*v0*v0*(cos(k0*x1)*cos(k0*x1) + cos(k0*x2)*cos(k0*x2));
-      pGrid->U[ks][j][i].E = press/Gamma_1
+      GRID_U(pGrid,ks,j,i,E) = press/Gamma_1
 #ifdef MHD
-        + 0.5*(SQR(pGrid->U[ks][j][i].B1c) + SQR(pGrid->U[ks][j][i].B2c)
-             + SQR(pGrid->U[ks][j][i].B3c))
+        + 0.5*(SQR(GRID_U(pGrid,ks,j,i,B1c)) + SQR(GRID_U(pGrid,ks,j,i,B2c))
+             + SQR(GRID_U(pGrid,ks,j,i,B3c)))
 #endif /* MHD */
-        + 0.5*(SQR(pGrid->U[ks][j][i].M1) + SQR(pGrid->U[ks][j][i].M2)
-              + SQR(pGrid->U[ks][j][i].M3))/pGrid->U[ks][j][i].d;
+        + 0.5*(SQR(GRID_U(pGrid,ks,j,i,M1)) + SQR(GRID_U(pGrid,ks,j,i,M2))
+              + SQR(GRID_U(pGrid,ks,j,i,M3)))/GRID_U(pGrid,ks,j,i,d);
     }
   }
 #ifdef MHD
@@ -119,25 +119,25 @@ void problem(Grid *pGrid, Domain *pDomain)
 /* Calculate the cell center positions */
       cc_pos(pGrid,i,j,ks,&x1,&x2,&x3);
 
-      pGrid->U[ks][j][i].d = d0;
-      pGrid->U[ks][j][i].M1 = d0*amp*(ran2(&iseed) - 0.5);
-      pGrid->U[ks][j][i].M2 = d0*(amp*(ran2(&iseed) - 0.5) - 0.015*x1);
-      pGrid->U[ks][j][i].M3 = 0.0;
+      GRID_U(pGrid,ks,j,i,d) = d0;
+      GRID_U(pGrid,ks,j,i,M1) = d0*amp*(ran2(&iseed) - 0.5);
+      GRID_U(pGrid,ks,j,i,M2) = d0*(amp*(ran2(&iseed) - 0.5) - 0.015*x1);
+      GRID_U(pGrid,ks,j,i,M3) = 0.0;
 #ifdef MHD
       pGrid->B1i[ks][j][i] = B0;
       pGrid->B2i[ks][j][i] = B0;
       pGrid->B3i[ks][j][i] = 0.0;
-      pGrid->U[ks][j][i].B1c = B0;
-      pGrid->U[ks][j][i].B2c = B0;
-      pGrid->U[ks][j][i].B3c = 0.0;
+      GRID_U(pGrid,ks,j,i,B1c) = B0;
+      GRID_U(pGrid,ks,j,i,B2c) = B0;
+      GRID_U(pGrid,ks,j,i,B3c) = 0.0;
 #endif /* MHD */
-      pGrid->U[ks][j][i].E = 0.1/Gamma_1
+      GRID_U(pGrid,ks,j,i,E) = 0.1/Gamma_1
 #ifdef MHD
-        + 0.5*(SQR(pGrid->U[ks][j][i].B1c) + SQR(pGrid->U[ks][j][i].B2c)
-             + SQR(pGrid->U[ks][j][i].B3c))
+        + 0.5*(SQR(GRID_U(pGrid,ks,j,i,B1c)) + SQR(GRID_U(pGrid,ks,j,i,B2c))
+             + SQR(GRID_U(pGrid,ks,j,i,B3c)))
 #endif /* MHD */
-        + 0.5*(SQR(pGrid->U[ks][j][i].M1) + SQR(pGrid->U[ks][j][i].M2)
-              + SQR(pGrid->U[ks][j][i].M3))/pGrid->U[ks][j][i].d;
+        + 0.5*(SQR(GRID_U(pGrid,ks,j,i,M1)) + SQR(GRID_U(pGrid,ks,j,i,M2))
+              + SQR(GRID_U(pGrid,ks,j,i,M3)))/GRID_U(pGrid,ks,j,i,d);
     }
   }
 #ifdef MHD
@@ -314,9 +314,9 @@ static void pbc_ix1(Grid *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][is-i] = pGrid->U[k][j][ie-(i-1)];
-        pGrid->U[k][j][is-i].M2 =
-          pGrid->U[k][j][is-i].M2 + pGrid->U[k][j][is-i].d*0.015*Lx;
+        SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j,ie-(i-1)));
+        GRID_U(pGrid,k,j,is-i,M2) =
+          GRID_U(pGrid,k,j,is-i,M2) + GRID_U(pGrid,k,j,is-i,d)*0.015*Lx;
 #ifdef SPECIAL_RELATIVITY
         pGrid->W[k][j][is-i] = pGrid->W[k][j][ie-(i-1)];
 #endif
@@ -377,9 +377,9 @@ static void pbc_ox1(Grid *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][ie+i] = pGrid->U[k][j][is+(i-1)];
-        pGrid->U[k][j][ie+i].M2 =
-          pGrid->U[k][j][ie+i].M2 - pGrid->U[k][j][ie+i].d*0.015*Lx;
+        SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j,is+(i-1)));
+        GRID_U(pGrid,k,j,ie+i,M2) =
+          GRID_U(pGrid,k,j,ie+i,M2) - GRID_U(pGrid,k,j,ie+i,d)*0.015*Lx;
 #ifdef SPECIAL_RELATIVITY
         pGrid->W[k][j][ie+i] = pGrid->W[k][j][is+(i-1)];
 #endif
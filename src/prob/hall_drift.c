@@ -111,20 +111,20 @@ void problem(DomainS *pDomain)
     Real x1,x2,x3;
     cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
 
-    pGrid->U[k][j][i].d = d0/(1.0 - dden*cos(k2*x2)/d0);
+    GRID_U(pGrid,k,j,i,d) = d0/(1.0 - dden*cos(k2*x2)/d0);
 
-    pGrid->U[k][j][i].M1 = 0.0;
-    pGrid->U[k][j][i].M2 = 0.0;
-    pGrid->U[k][j][i].M3 = 0.0;
+    GRID_U(pGrid,k,j,i,M1) = 0.0;
+    GRID_U(pGrid,k,j,i,M2) = 0.0;
+    GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef MHD
-    pGrid->U[k][j][i].B1c = 0.0;
-    pGrid->U[k][j][i].B2c = 0.0;
-    pGrid->U[k][j][i].B3c = B0 + dB*cos(k1*x1);
+    GRID_U(pGrid,k,j,i,B1c) = 0.0;
+    GRID_U(pGrid,k,j,i,B2c) = 0.0;
+    GRID_U(pGrid,k,j,i,B3c) = B0 + dB*cos(k1*x1);
 #endif /* MHD */
 
 #ifndef ISOTHERMAL
-    pGrid->U[k][j][i].E = Pres/Gamma_1 +
-      0.5*pGrid->U[k][j][i].B3c*pGrid->U[k][j][i].B3c;
+    GRID_U(pGrid,k,j,i,E) = Pres/Gamma_1 +
+      0.5*GRID_U(pGrid,k,j,i,B3c)*GRID_U(pGrid,k,j,i,B3c);
 #endif /* ISOTHERMAL */
 
   }}}
@@ -210,18 +210,18 @@ void problem(DomainS *pDomain)
 
 /* Initialize d, M, and P.  For 2D shearing box M1=Vx, M2=Vz, M3=Vy */ 
 
-      pGrid->U[ks][j][i].d  = rd;
-      pGrid->U[ks][j][i].M1 = rd*rvx;
-      pGrid->U[ks][j][i].M2 = rd*rvy;
+      GRID_U(pGrid,ks,j,i,d)  = rd;
+      GRID_U(pGrid,ks,j,i,M1) = rd*rvx;
+      GRID_U(pGrid,ks,j,i,M2) = rd*rvy;
 #ifdef FARGO
-      pGrid->U[ks][j][i].M3 = rd*rvz;
+      GRID_U(pGrid,ks,j,i,M3) = rd*rvz;
 #else
-      pGrid->U[ks][j][i].M3 = rd*(rvz - qshear*Omega_0*x1);
+      GRID_U(pGrid,ks,j,i,M3) = rd*(rvz - qshear*Omega_0*x1);
 #endif
 #ifdef ADIABATIC
-      pGrid->U[ks][j][i].E = rp/Gamma_1
-        + 0.5*(SQR(pGrid->U[ks][j][i].M1) + SQR(pGrid->U[ks][j][i].M2) +
-               SQR(pGrid->U[ks][j][i].M3))/rd;
+      GRID_U(pGrid,ks,j,i,E) = rp/Gamma_1
+        + 0.5*(SQR(GRID_U(pGrid,ks,j,i,M1)) + SQR(GRID_U(pGrid,ks,j,i,M2)) +
+               SQR(GRID_U(pGrid,ks,j,i,M3)))/rd;
 #endif
 
 /* Initialize magnetic field.  For 2D shearing box B1=Bx, B2=Bz, B3=By
@@ -231,9 +231,9 @@ void problem(DomainS *pDomain)
  */
 #ifdef MHD
       if (ifield == 1) {
-        pGrid->U[ks][j][i].B1c = 0.0;
-        pGrid->U[ks][j][i].B2c = B0*(sin((double)kx*x1));
-        pGrid->U[ks][j][i].B3c = 0.0;
+        GRID_U(pGrid,ks,j,i,B1c) = 0.0;
+        GRID_U(pGrid,ks,j,i,B2c) = B0*(sin((double)kx*x1));
+        GRID_U(pGrid,ks,j,i,B3c) = 0.0;
         pGrid->B1i[ks][j][i] = 0.0;
         pGrid->B2i[ks][j][i] = B0*(sin((double)kx*x1));
         pGrid->B3i[ks][j][i] = 0.0;
@@ -241,9 +241,9 @@ void problem(DomainS *pDomain)
         if (j==je) pGrid->B2i[ks][je+1][i] = B0*(sin((double)kx*x1));
       }
       if (ifield == 2) {
-        pGrid->U[ks][j][i].B1c = 0.0;
-        pGrid->U[ks][j][i].B2c = B0;
-        pGrid->U[ks][j][i].B3c = 0.0;
+        GRID_U(pGrid,ks,j,i,B1c) = 0.0;
+        GRID_U(pGrid,ks,j,i,B2c) = B0;
+        GRID_U(pGrid,ks,j,i,B3c) = 0.0;
         pGrid->B1i[ks][j][i] = 0.0;
         pGrid->B2i[ks][j][i] = B0;
         pGrid->B3i[ks][j][i] = 0.0;
@@ -259,8 +259,8 @@ void problem(DomainS *pDomain)
           pGrid->B2i[ks][je+1][i] =-(az[je+1][i+1]-az[je+1][i])/pGrid->dx1;
       }
 #ifdef ADIABATIC
-      pGrid->U[ks][j][i].E += 0.5*(SQR(pGrid->U[ks][j][i].B1c)
-         + SQR(pGrid->U[ks][j][i].B2c) + SQR(pGrid->U[ks][j][i].B3c));
+      GRID_U(pGrid,ks,j,i,E) += 0.5*(SQR(GRID_U(pGrid,ks,j,i,B1c))
+         + SQR(GRID_U(pGrid,ks,j,i,B2c)) + SQR(GRID_U(pGrid,ks,j,i,B3c)));
 #endif
 #endif /* MHD */
     }
@@ -270,8 +270,8 @@ void problem(DomainS *pDomain)
 #ifdef MHD
   for (j=js; j<=je; j++) {
   for (i=is; i<=ie; i++) {
-    pGrid->U[ks][j][i].B1c =0.5*(pGrid->B1i[ks][j][i] + pGrid->B1i[ks][j][i+1]);
-    pGrid->U[ks][j][i].B2c =0.5*(pGrid->B2i[ks][j][i] + pGrid->B2i[ks][j+1][i]);
+    GRID_U(pGrid,ks,j,i,B1c) =0.5*(pGrid->B1i[ks][j][i] + pGrid->B1i[ks][j][i+1]);
+    GRID_U(pGrid,ks,j,i,B2c) =0.5*(pGrid->B2i[ks][j][i] + pGrid->B2i[ks][j+1][i]);
   }}
   free_2d_array(az);
 #endif /* MHD */
@@ -491,9 +491,9 @@ static Real expr_dV3(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M3/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
 #else
-  return (pG->U[k][j][i].M3/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return (GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -507,9 +507,9 @@ static Real hst_rho_Vx_dVy(const GridS *pG, const int i, const int j, const int
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M1*pG->U[k][j][i].M3/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
 #else
-  return pG->U[k][j][i].M1*(pG->U[k][j][i].M3/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -524,11 +524,11 @@ static Real hst_dEk(const GridS *pG, const int i, const int j, const int k)
   Real dMy, dE;
 
 #ifdef FARGO
-  dMy = pG->U[k][j][i].M3;
+  dMy = GRID_U(pG,k,j,i,M3);
 #else
-  dMy = (pG->U[k][j][i].M3 + qshear*Omega_0*x1*pG->U[k][j][i].d);
+  dMy = (GRID_U(pG,k,j,i,M3) + qshear*Omega_0*x1*GRID_U(pG,k,j,i,d));
 #endif
-  dE = 0.5*(pG->U[k][j][i].M1*pG->U[k][j][i].M1 + 4.0*dMy*dMy)/pG->U[k][j][i].d;
+  dE = 0.5*(GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M1) + 4.0*dMy*dMy)/GRID_U(pG,k,j,i,d);
 
   return dE;
 }
@@ -547,7 +547,7 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
   phi = UnstratifiedDisk(x1, x2, x3);
 
-  return pG->U[k][j][i].E + pG->U[k][j][i].d*phi;
+  return GRID_U(pG,k,j,i,E) + GRID_U(pG,k,j,i,d)*phi;
 #else
   return 0.0;
 #endif
@@ -562,21 +562,21 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
  *  \brief x-component of magnetic field */
 static Real hst_Bx(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][pG->is].B1c;
+  return GRID_U(pG,k,j,pG->is,B1c);
 }
 
 /*! \fn static Real hst_By(const GridS *pG, const int i,const int j,const int k)
  *  \brief y-component of the magnetic field */
 static Real hst_By(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][pG->js][i].B2c;
+  return GRID_U(pG,k,pG->js,i,B2c);
 }
 
 /*! \fn static Real hst_Bz(const GridS *pG, const int i,const int j,const int k)
  *  \brief z-component of the magnetic field */
 static Real hst_Bz(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[pG->ks][j][i].B3c;
+  return GRID_U(pG,pG->ks,j,i,B3c);
 }
 
 /*! \fn static Real hst_BxBy(const GridS *pG, const int i, const int j, 
@@ -584,7 +584,7 @@ static Real hst_Bz(const GridS *pG, const int i, const int j, const int k)
  *  \brief Maxwell stress */
 static Real hst_BxBy(const GridS *pG, const int i, const int j, const int k)
 {
-  return -pG->U[k][j][i].B1c*pG->U[k][j][i].B2c;
+  return -GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c);
 }
 
 #endif /* MHD */
@@ -282,17 +282,17 @@ void problem(DomainS *pDomain)
 /* Initialize d, M, and P.  For 3D shearing box M1=Vx, M2=Vy, M3=Vz
  * With FARGO do not initialize the background shear */ 
 
-      pGrid->U[k][j][i].d  = rd;
-      pGrid->U[k][j][i].M1 = rd*rvx;
-      pGrid->U[k][j][i].M2 = rd*rvy;
+      GRID_U(pGrid,k,j,i,d)  = rd;
+      GRID_U(pGrid,k,j,i,M1) = rd*rvx;
+      GRID_U(pGrid,k,j,i,M2) = rd*rvy;
 #ifndef FARGO
-      pGrid->U[k][j][i].M2 -= rd*(qshear*Omega_0*x1);
+      GRID_U(pGrid,k,j,i,M2) -= rd*(qshear*Omega_0*x1);
 #endif
-      pGrid->U[k][j][i].M3 = rd*rvz;
+      GRID_U(pGrid,k,j,i,M3) = rd*rvz;
 #ifdef ADIABATIC
-      pGrid->U[k][j][i].E = rp/Gamma_1
-        + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2) 
-             + SQR(pGrid->U[k][j][i].M3))/rd;
+      GRID_U(pGrid,k,j,i,E) = rp/Gamma_1
+        + 0.5*(SQR(GRID_U(pGrid,k,j,i,M1)) + SQR(GRID_U(pGrid,k,j,i,M2)) 
+             + SQR(GRID_U(pGrid,k,j,i,M3)))/rd;
 #endif
 
 /* Initialize magnetic field.  For 3D shearing box B1=Bx, B2=By, B3=Bz
@@ -361,12 +361,12 @@ void problem(DomainS *pDomain)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-        pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
-        pGrid->U[k][j][i].B3c = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+        GRID_U(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+        GRID_U(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+        GRID_U(pGrid,k,j,i,B3c) = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
 #ifdef ADIABATIC
-      pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-         + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+      GRID_U(pGrid,k,j,i,E) += 0.5*(SQR(GRID_U(pGrid,k,j,i,B1c))
+         + SQR(GRID_U(pGrid,k,j,i,B2c)) + SQR(GRID_U(pGrid,k,j,i,B3c)));
 #endif
       }
     }
@@ -383,9 +383,9 @@ void problem(DomainS *pDomain)
     for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pGrid->U[k][j][i].M1 -= rd*SumRvx;
-        pGrid->U[k][j][i].M2 -= rd*SumRvy;
-        pGrid->U[k][j][i].M3 -= rd*SumRvz;
+        GRID_U(pGrid,k,j,i,M1) -= rd*SumRvx;
+        GRID_U(pGrid,k,j,i,M2) -= rd*SumRvy;
+        GRID_U(pGrid,k,j,i,M3) -= rd*SumRvz;
       }
     }}
   }
@@ -732,9 +732,9 @@ static Real expr_dV2(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 #else
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -772,10 +772,10 @@ static Real hst_rho_Vx_dVy(const GridS *pG,const int i,const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M1*(pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 #else
-  return pG->U[k][j][i].M1*
-    (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return GRID_U(pG,k,j,i,M1)*
+    (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -787,11 +787,11 @@ static Real hst_rho_dVy2(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3,dVy;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  dVy = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 #else
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  dVy = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
-  return pG->U[k][j][i].d*dVy*dVy;
+  return GRID_U(pG,k,j,i,d)*dVy*dVy;
 }
 
 #ifdef ADIABATIC
@@ -804,7 +804,7 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
   phi = UnstratifiedDisk(x1, x2, x3);
 
-  return pG->U[k][j][i].E + pG->U[k][j][i].d*phi;
+  return GRID_U(pG,k,j,i,E) + GRID_U(pG,k,j,i,d)*phi;
 }
 #endif /* ADIABATIC */
 
@@ -818,21 +818,21 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
  *  \brief x-component of B-field */
 static Real hst_Bx(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B1c;
+  return GRID_U(pG,k,j,i,B1c);
 }
 
 /*! \fn static Real hst_By(const GridS *pG, const int i,const int j,const int k)
  *  \brief y-component of B-field */
 static Real hst_By(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B2c;
+  return GRID_U(pG,k,j,i,B2c);
 }
 
 /*! \fn static Real hst_Bz(const GridS *pG, const int i,const int j,const int k)
  *  \brief z-component of B-field */
 static Real hst_Bz(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B3c;
+  return GRID_U(pG,k,j,i,B3c);
 }
 
 /*! \fn static Real hst_BxBy(const GridS *pG, const int i, const int j, 
@@ -840,22 +840,22 @@ static Real hst_Bz(const GridS *pG, const int i, const int j, const int k)
  *  \brief Maxwell stress */
 static Real hst_BxBy(const GridS *pG, const int i, const int j, const int k)
 {
-  return -pG->U[k][j][i].B1c*pG->U[k][j][i].B2c;
+  return -GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c);
 }
 
 static Real hst_dEw2(const GridS *pG, const int i, const int j, const int k)
 {
   Real x1,x2,x3,dVx,dVy,dVz,dBz;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  dBz = pG->U[k][j][i].B3c-(sqrt(15.0/16.0))/(2.0*PI)/sqrt(4.*PI);
-  dVx = pG->U[k][j][i].M1/pG->U[k][j][i].d;
-  dVy = pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1;
-  dVz = pG->U[k][j][i].M3/pG->U[k][j][i].d;
+  dBz = GRID_U(pG,k,j,i,B3c)-(sqrt(15.0/16.0))/(2.0*PI)/sqrt(4.*PI);
+  dVx = GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d);
+  dVy = GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1;
+  dVz = GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
   
-/*  return (dVx*dVx + dVy*dVy + dVz*dVz + pG->U[k][j][i].B1c*pG->U[k][j][i].B1c
-    + pG->U[k][j][i].B2c*pG->U[k][j][i].B2c + dBz*dBz); */
-  return (pG->U[k][j][i].B1c*pG->U[k][j][i].B1c
-    + pG->U[k][j][i].B2c*pG->U[k][j][i].B2c + dBz*dBz); 
+/*  return (dVx*dVx + dVy*dVy + dVz*dVz + GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c)
+    + GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c) + dBz*dBz); */
+  return (GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c)
+    + GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c) + dBz*dBz); 
 }
 
 static Real hst_dBy(const GridS *pG, const int i, const int j, const int k)
@@ -872,7 +872,7 @@ static Real hst_dBy(const GridS *pG, const int i, const int j, const int k)
 
 /* compute real part of Fourier mode, for comparison to JGG fig 11 */
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  dBy = 2.0*(pG->U[k][j][i].B2c - (0.2-0.15*Omega_0*pG->time));
+  dBy = 2.0*(GRID_U(pG,k,j,i,B2c) - (0.2-0.15*Omega_0*pG->time));
   dBy *= cos(fkx*x1 + fky*x2 + fkz*x3);
 
   return dBy;
@@ -138,20 +138,20 @@ Real divB=0.0, maxdivB=0.0;
         x2i = x2 - 0.5*pG->dx2;
         x3i = x3 - 0.5*pG->dx3;
 
-        pG->U[k][j][i].d = rho0;
-        pG->U[k][j][i].M1 = 0.0;
-        pG->U[k][j][i].M2 = VP(x1)*rho0;
-        pG->U[k][j][i].M3 = 0.0;
-        pG->U[k][j][i].E   = e0;
+        GRID_U(pG,k,j,i,d) = rho0;
+        GRID_U(pG,k,j,i,M1) = 0.0;
+        GRID_U(pG,k,j,i,M2) = VP(x1)*rho0;
+        GRID_U(pG,k,j,i,M3) = 0.0;
+        GRID_U(pG,k,j,i,E)   = e0;
         Ap[k][j][i] = 0.0;
 
 #ifdef MHD
         pG->B1i[k][j][i] = 0.0;
         pG->B2i[k][j][i] = 0.0;
         pG->B3i[k][j][i] = 0.0;
-        pG->U[k][j][i].B1c = 0.0;
-        pG->U[k][j][i].B2c = 0.0;
-        pG->U[k][j][i].B3c = 0.0;
+        GRID_U(pG,k,j,i,B1c) = 0.0;
+        GRID_U(pG,k,j,i,B2c) = 0.0;
+        GRID_U(pG,k,j,i,B3c) = 0.0;
 
 #endif
 
@@ -166,9 +166,9 @@ Real divB=0.0, maxdivB=0.0;
 					IntE = IntE*(1.0 - seed*sin(x2));
           if ((IntE >= e0) && (rhoa >= rho0)) {
 						//If the values are above cutoff, set up the cell
-            pG->U[k][j][i].d = rhoa;
-            pG->U[k][j][i].M2 = VP(x1)*pG->U[k][j][i].d;
-            pG->U[k][j][i].E = IntE;
+            GRID_U(pG,k,j,i,d) = rhoa;
+            GRID_U(pG,k,j,i,M2) = VP(x1)*GRID_U(pG,k,j,i,d);
+            GRID_U(pG,k,j,i,E) = IntE;
 						
             //Note, at this point, E holds only the internal energy.  This must
             //be fixed later
@@ -224,13 +224,13 @@ Real divB=0.0, maxdivB=0.0;
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
         if (i==iu)
-          pG->U[k][j][i].B1c = pG->B1i[k][j][i];
+          GRID_U(pG,k,j,i,B1c) = pG->B1i[k][j][i];
         else
-          pG->U[k][j][i].B1c = 0.5*((x1-0.5*pG->dx1)*pG->B1i[k][j][i] + (x1+0.5*pG->dx1)*pG->B1i[k][j][i+1])/x1;
+          GRID_U(pG,k,j,i,B1c) = 0.5*((x1-0.5*pG->dx1)*pG->B1i[k][j][i] + (x1+0.5*pG->dx1)*pG->B1i[k][j][i+1])/x1;
         if (k==ku)
-          pG->U[k][j][i].B3c = pG->B3i[k][j][i];
+          GRID_U(pG,k,j,i,B3c) = pG->B3i[k][j][i];
         else
-          pG->U[k][j][i].B3c = 0.5*(pG->B3i[k+1][j][i] + pG->B3i[k][j][i]);
+          GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k+1][j][i] + pG->B3i[k][j][i]);
       }
     }
   }
@@ -244,9 +244,9 @@ Real divB=0.0, maxdivB=0.0;
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        Pgas += (Gamma-1)*pG->U[k][j][i].E*Volume(pG,i,j,k);
-        Pb += 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c)
-              + SQR(pG->U[k][j][i].B3c))*Volume(pG,i,j,k);
+        Pgas += (Gamma-1)*GRID_U(pG,k,j,i,E)*Volume(pG,i,j,k);
+        Pb += 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c))
+              + SQR(GRID_U(pG,k,j,i,B3c)))*Volume(pG,i,j,k);
       }
     }
   }
@@ -272,8 +272,8 @@ Real divB=0.0, maxdivB=0.0;
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[k][j][i].B1c *= scl;
-        pG->U[k][j][i].B3c *= scl;
+        GRID_U(pG,k,j,i,B1c) *= scl;
+        GRID_U(pG,k,j,i,B3c) *= scl;
         pG->B1i[k][j][i]   *= scl;
         pG->B3i[k][j][i]   *= scl;
       }
@@ -285,14 +285,14 @@ Real divB=0.0, maxdivB=0.0;
   for (k=kl; k<=ku; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        KinE = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) 
-                + SQR(pG->U[k][j][i].M3))/(pG->U[k][j][i].d);
+        KinE = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) 
+                + SQR(GRID_U(pG,k,j,i,M3)))/(GRID_U(pG,k,j,i,d));
         MagE = 0.0;
 #ifdef MHD
-        MagE = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c)
-                + SQR(pG->U[k][j][i].B3c));
+        MagE = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c))
+                + SQR(GRID_U(pG,k,j,i,B3c)));
 #endif
-        pG->U[k][j][i].E += KinE + MagE;
+        GRID_U(pG,k,j,i,E) += KinE + MagE;
       }
     }
   }
@@ -387,28 +387,28 @@ void Userwork_in_loop(Grid *pG, Domain *pDomain)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,k,&x1,&x2,&x3);
-        if (isnan(pG->U[k][j][i].d) || isnan(pG->U[k][j][i].E)) {
-          printf("At pos (%f,%f,%f), Den = %f, E = %f\n", x1,x2,x3,pG->U[k][j][i].d, pG->U[k][j][i].E);
+        if (isnan(GRID_U(pG,k,j,i,d)) || isnan(GRID_U(pG,k,j,i,E))) {
+          printf("At pos (%f,%f,%f), Den = %f, E = %f\n", x1,x2,x3,GRID_U(pG,k,j,i,d), GRID_U(pG,k,j,i,E));
         }
 
-        KinE = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) 
-                + SQR(pG->U[k][j][i].M3))/(pG->U[k][j][i].d);
+        KinE = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) 
+                + SQR(GRID_U(pG,k,j,i,M3)))/(GRID_U(pG,k,j,i,d));
 #ifdef MHD
-        MagE = 0.5*(SQR(pG->U[k][j][i].B1c) + SQR(pG->U[k][j][i].B2c)
-                + SQR(pG->U[k][j][i].B3c));
+        MagE = 0.5*(SQR(GRID_U(pG,k,j,i,B1c)) + SQR(GRID_U(pG,k,j,i,B2c))
+                + SQR(GRID_U(pG,k,j,i,B3c)));
 #endif
-        IntE = pG->U[k][j][i].E - KinE - MagE;
+        IntE = GRID_U(pG,k,j,i,E) - KinE - MagE;
 
-        if (pG->U[k][j][i].d < rho0) {
+        if (GRID_U(pG,k,j,i,d) < rho0) {
 
-          pG->U[k][j][i].d = rho0;
+          GRID_U(pG,k,j,i,d) = rho0;
 
-          KinE = 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2)
-                  + SQR(pG->U[k][j][i].M3))/(pG->U[k][j][i].d);
+          KinE = 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2))
+                  + SQR(GRID_U(pG,k,j,i,M3)))/(GRID_U(pG,k,j,i,d));
 
           IntE = e0;  // Set this as well to keep c_s reasonable
 
-          pG->U[k][j][i].E = IntE + KinE + MagE;
+          GRID_U(pG,k,j,i,E) = IntE + KinE + MagE;
 					protd++;
 					prote++;
         }
@@ -416,10 +416,10 @@ void Userwork_in_loop(Grid *pG, Domain *pDomain)
 
 
         else if (IntE < e0) {
-          pG->U[k][j][i].E = e0 + KinE + MagE;
+          GRID_U(pG,k,j,i,E) = e0 + KinE + MagE;
 					prote++;
         }
-        IntE = pG->U[k][j][i].E - KinE - MagE;
+        IntE = GRID_U(pG,k,j,i,E) - KinE - MagE;
 
       }
     }
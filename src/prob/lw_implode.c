@@ -61,19 +61,19 @@ void problem(DomainS *pDomain)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-	pGrid->U[k][j][i].M1 = 0.0;
-	pGrid->U[k][j][i].M2 = 0.0;
-	pGrid->U[k][j][i].M3 = 0.0;
+	GRID_U(pGrid,k,j,i,M1) = 0.0;
+	GRID_U(pGrid,k,j,i,M2) = 0.0;
+	GRID_U(pGrid,k,j,i,M3) = 0.0;
 
 	if(((j-js + pDomain->Disp[1])+(i-is + pDomain->Disp[0])) > (nx2*irefine)) {
-	  pGrid->U[k][j][i].d  = d_out;
+	  GRID_U(pGrid,k,j,i,d)  = d_out;
 #ifndef ISOTHERMAL
-	  pGrid->U[k][j][i].E = p_out/Gamma_1;
+	  GRID_U(pGrid,k,j,i,E) = p_out/Gamma_1;
 #endif
 	} else {
-	  pGrid->U[k][j][i].d  = d_in;
+	  GRID_U(pGrid,k,j,i,d)  = d_in;
 #ifndef ISOTHERMAL
-	  pGrid->U[k][j][i].E = p_in/Gamma_1;
+	  GRID_U(pGrid,k,j,i,E) = p_in/Gamma_1;
 #endif
 	}
       }
@@ -126,5 +126,5 @@ void Userwork_after_loop(MeshS *pM)
  *  \brief computes difference d{i,j}-d{j,i} to test if solution is symmetric */
 static Real expr_diff_d(const GridS *pG, const int i, const int j, const int k)
 {
- return (pG->U[k][j][i].d - pG->U[k][i][j].d);
+ return (GRID_U(pG,k,j,i,d) - GRID_U(pG,k,i,j,d));
 }
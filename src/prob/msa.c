@@ -147,17 +147,17 @@ void problem(DomainS *pDomain)
       rby = -amp*nwx*cos(kxt*x1+ky*(x2-0.5*pG->dx2));
       rbz = 0.0;
 
-      pG->U[k][j][i].d  = rd;
-      pG->U[k][j][i].M1 = rd*rvx;
-      pG->U[k][j][i].M2 = rd*rvy;
+      GRID_U(pG,k,j,i,d)  = rd;
+      GRID_U(pG,k,j,i,M1) = rd*rvx;
+      GRID_U(pG,k,j,i,M2) = rd*rvy;
 #ifndef FARGO
-      pG->U[k][j][i].M2 -= rd*(qshear*Omega_0*x1);
+      GRID_U(pG,k,j,i,M2) -= rd*(qshear*Omega_0*x1);
 #endif
-      pG->U[k][j][i].M3 = rd*rvz;
+      GRID_U(pG,k,j,i,M3) = rd*rvz;
 #ifdef ADIABATIC
-      pG->U[k][j][i].E = (P0+rp)/Gamma_1
-         + 0.5*(SQR(pG->U[k][j][i].M1) + SQR(pG->U[k][j][i].M2) 
-         + SQR(pG->U[k][j][i].M3))/rd;
+      GRID_U(pG,k,j,i,E) = (P0+rp)/Gamma_1
+         + 0.5*(SQR(GRID_U(pG,k,j,i,M1)) + SQR(GRID_U(pG,k,j,i,M2)) 
+         + SQR(GRID_U(pG,k,j,i,M3)))/rd;
 #endif
 
 #ifdef MHD
@@ -179,12 +179,12 @@ void problem(DomainS *pDomain)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i]+pG->B1i[k][j][i+1]);
-        pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i]+pG->B2i[k][j+1][i]);
-        if (pG->Nx[2] >1) pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i]+pG->B3i[k+1][j][i]); else pG->U[k][j][i].B3c =pG->B3i[k][j][i];
+        GRID_U(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i]+pG->B1i[k][j][i+1]);
+        GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i]+pG->B2i[k][j+1][i]);
+        if (pG->Nx[2] >1) GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i]+pG->B3i[k+1][j][i]); else GRID_U(pG,k,j,i,B3c) =pG->B3i[k][j][i];
 #ifdef ADIABATIC
-        pG->U[k][j][i].E += 0.5*(SQR(pG->U[k][j][i].B1c)
-         + SQR(pG->U[k][j][i].B2c) + SQR(pG->U[k][j][i].B3c));
+        GRID_U(pG,k,j,i,E) += 0.5*(SQR(GRID_U(pG,k,j,i,B1c))
+         + SQR(GRID_U(pG,k,j,i,B2c)) + SQR(GRID_U(pG,k,j,i,B3c)));
 #endif
       }
     }
@@ -358,7 +358,7 @@ static Real hst_sigma(const GridS *pG, const int i, const int j, const int k)
   kx = nwx*2*PI;
   ky = nwy*2*PI;
   kxt = kx+qshear*ky*pG->time;
-  return (pG->U[k][j][i].d-1)/cos(kxt*x1+ky*x2);
+  return (GRID_U(pG,k,j,i,d)-1)/cos(kxt*x1+ky*x2);
 }
 
 static Real hst_ux(const GridS *pG, const int i, const int j, const int k)
@@ -375,7 +375,7 @@ static Real hst_ux(const GridS *pG, const int i, const int j, const int k)
   kx = nwx*2*PI;
   ky = nwy*2*PI;
   kxt = kx+qshear*ky*pG->time;
-  return (pG->U[k][j][i].M1/pG->U[k][j][i].d-1)/sin(kxt*x1+ky*x2);
+  return (GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d)-1)/sin(kxt*x1+ky*x2);
 }
 
 static Real hst_uy(const GridS *pG, const int i, const int j, const int k)
@@ -392,7 +392,7 @@ static Real hst_uy(const GridS *pG, const int i, const int j, const int k)
   kx = nwx*2*PI;
   ky = nwy*2*PI;
   kxt = kx+qshear*ky*pG->time;
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d-1)/sin(kxt*x1+ky*x2);
+  return (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d)-1)/sin(kxt*x1+ky*x2);
 }
 
 #ifdef MHD
@@ -419,7 +419,7 @@ static Real hst_m1(const GridS *pG, const int i, const int j, const int k)
   kx = nwx*2*PI;
   ky = nwy*2*PI;
   kxt = kx+qshear*ky*pG->time;
-  return (pG->U[k][j][i].B1c/ky/B0)/cos(kxt*x1+ky*x2);
+  return (GRID_U(pG,k,j,i,B1c)/ky/B0)/cos(kxt*x1+ky*x2);
 }
 
 static Real hst_m2(const GridS *pG, const int i, const int j, const int k)
@@ -445,7 +445,7 @@ static Real hst_m2(const GridS *pG, const int i, const int j, const int k)
   kx = nwx*2*PI;
   ky = nwy*2*PI;
   kxt = kx+qshear*ky*pG->time;
-  return -(pG->U[k][j][i].B2c-B0)/kxt/B0/cos(kxt*x1+ky*x2);
+  return -(GRID_U(pG,k,j,i,B2c)-B0)/kxt/B0/cos(kxt*x1+ky*x2);
 }
 #endif
 
@@ -454,7 +454,7 @@ static Real hst_dSigma(const GridS *pG, const int i, const int j, const int k)
   Real dSigma=0.;
   int ii=i-pG->Disp[0],jj=j-pG->Disp[1],kk=k-pG->Disp[2];
   int ks = pG->ks, ke = pG->ke;
-  if((ii == 58) && (jj == 16) && (kk == ks)) dSigma=pG->U[kk][jj][ii].d-1.0;
+  if((ii == 58) && (jj == 16) && (kk == ks)) dSigma=GRID_U(pG,kk,jj,ii,d)-1.0;
   return dSigma*dVol;
 }
 
@@ -463,7 +463,7 @@ static Real hst_Vx(const GridS *pG, const int i, const int j, const int k)
   Real Vx=0.;
   int ii=i-pG->Disp[0],jj=j-pG->Disp[1],kk=k-pG->Disp[2];
   int ks = pG->ks, ke = pG->ke;
-  if(ii == 58 && jj == 16 && kk == ks) Vx=pG->U[kk][jj][ii].M1/pG->U[kk][jj][ii].d;
+  if(ii == 58 && jj == 16 && kk == ks) Vx=GRID_U(pG,kk,jj,ii,M1)/GRID_U(pG,kk,jj,ii,d);
   return Vx*dVol;
 }
 
@@ -475,9 +475,9 @@ static Real hst_dVy(const GridS *pG, const int i, const int j, const int k)
   if(ii == 58 && jj == 16 && kk == ks){
     cc_pos(pG,ii,jj,kk,&x1,&x2,&x3);
 #ifndef FARGO
-    dVy = (pG->U[kk][jj][ii].M2/pG->U[kk][jj][ii].d + qshear*Omega_0*x1);
+    dVy = (GRID_U(pG,kk,jj,ii,M2)/GRID_U(pG,kk,jj,ii,d) + qshear*Omega_0*x1);
 #else
-    dVy = (pG->U[kk][jj][ii].M2/pG->U[kk][jj][ii].d);
+    dVy = (GRID_U(pG,kk,jj,ii,M2)/GRID_U(pG,kk,jj,ii,d));
 #endif
   }
   return dVy*dVol;
@@ -489,7 +489,7 @@ static Real hst_Bx(const GridS *pG, const int i, const int j, const int k)
   Real B1c=0.;
   int ii=i-pG->Disp[0],jj=j-pG->Disp[1],kk=k-pG->Disp[2];
   int ks = pG->ks, ke = pG->ke;
-  if(ii == 58 && jj == 16 && kk == ks) B1c= pG->U[kk][jj][ii].B1c;
+  if(ii == 58 && jj == 16 && kk == ks) B1c= GRID_U(pG,kk,jj,ii,B1c);
   return B1c*dVol;
 }
 
@@ -505,7 +505,7 @@ static Real hst_dBy(const GridS *pG, const int i, const int j, const int k)
   cs = sqrt(4.0-2.0*qshear)/PI/nJ/Q;
   B0 = cs/sqrt(beta);
 
-  if(ii == 58 && jj == 16 && kk == ks) dBy = pG->U[kk][jj][ii].B2c - B0;
+  if(ii == 58 && jj == 16 && kk == ks) dBy = GRID_U(pG,kk,jj,ii,B2c) - B0;
 
   return dBy*dVol;
 }
@@ -545,12 +545,12 @@ static Real hst_dPhi(const GridS *pG, const int i, const int j, const int k)
   k20 =kx*kx+ky*ky;
 
   cs = sqrt(4.0-2.0*qshear)/(PI*nJ*Q);
-  Phi1 = -4.0*PI*nJ*cs*cs/k20*(pG->U[k][j][i].d-1.0);
+  Phi1 = -4.0*PI*nJ*cs*cs/k20*(GRID_U(pG,k,j,i,d)-1.0);
 #ifdef SELF_GRAVITY_USING_FFT_DISK
   Phi1 *= 1-0.5*(exp(-sqrt(k20)*(zmax-fabs(x3)))+exp(-sqrt(k20)*(zmax+fabs(x3))));
 #endif
 
-  dPhi = (pG->Phi[k][j][i]-Phi1)/(pG->U[k][j][i].d-1)*k2;
+  dPhi = (pG->Phi[k][j][i]-Phi1)/(GRID_U(pG,k,j,i,d)-1)*k2;
   dPhi /=  1-0.5*(exp(-sqrt(k2)*(zmax-fabs(x3)))+exp(-sqrt(k2)*(zmax+fabs(x3))));
   return dPhi;
 }
@@ -571,12 +571,12 @@ static Real hst_dE(const GridS *pG, const int i, const int j, const int k)
   cs2 = SQR(cs);
   E0 = cs2/Gamma/Gamma_1;
   if(ii == 58 && jj == 16 && kk == ks) {
-  dE = pG->U[kk][jj][ii].E 
-       - 0.5*(SQR(pG->U[kk][jj][ii].M1) + SQR(pG->U[kk][jj][ii].M2) 
-         + SQR(pG->U[kk][jj][ii].M3))/pG->U[kk][jj][ii].d;
+  dE = GRID_U(pG,kk,jj,ii,E) 
+       - 0.5*(SQR(GRID_U(pG,kk,jj,ii,M1)) + SQR(GRID_U(pG,kk,jj,ii,M2)) 
+         + SQR(GRID_U(pG,kk,jj,ii,M3)))/GRID_U(pG,kk,jj,ii,d);
 #ifdef MHD
-  dE -= 0.5*(SQR(pG->U[kk][jj][ii].B1c)
-           + SQR(pG->U[kk][jj][ii].B2c) + SQR(pG->U[kk][jj][ii].B3c));
+  dE -= 0.5*(SQR(GRID_U(pG,kk,jj,ii,B1c))
+           + SQR(GRID_U(pG,kk,jj,ii,B2c)) + SQR(GRID_U(pG,kk,jj,ii,B3c)));
 #endif
   dE -= E0;
 
@@ -65,10 +65,10 @@ void problem(DomainS *pDomain)
 /* Calculate the cell center positions */
       cc_pos(pGrid,i,j,ks,&x1,&x2,&x3);
 
-      pGrid->U[ks][j][i].d = d0;
-      pGrid->U[ks][j][i].M1 = -d0*v0*sin(2.0*PI*x2);
-      pGrid->U[ks][j][i].M2 =  d0*v0*sin(2.0*PI*x1);
-      pGrid->U[ks][j][i].M3 = 0.0;
+      GRID_U(pGrid,ks,j,i,d) = d0;
+      GRID_U(pGrid,ks,j,i,M1) = -d0*v0*sin(2.0*PI*x2);
+      GRID_U(pGrid,ks,j,i,M2) =  d0*v0*sin(2.0*PI*x1);
+      GRID_U(pGrid,ks,j,i,M3) = 0.0;
       pGrid->B1i[ks][j][i] = (az[j+1][i] - az[j][i])/pGrid->dx2;
       pGrid->B2i[ks][j][i] =-(az[j][i+1] - az[j][i])/pGrid->dx1;
     }
@@ -87,15 +87,15 @@ void problem(DomainS *pDomain)
 
   for (j=js; j<=je; j++) {
   for (i=is; i<=ie; i++) {
-    pGrid->U[ks][j][i].B1c = 0.5*(pGrid->B1i[ks][j][i]+pGrid->B1i[ks][j][i+1]);
-    pGrid->U[ks][j][i].B2c = 0.5*(pGrid->B2i[ks][j][i]+pGrid->B2i[ks][j+1][i]);
-    pGrid->U[ks][j][i].B3c = 0.0;
+    GRID_U(pGrid,ks,j,i,B1c) = 0.5*(pGrid->B1i[ks][j][i]+pGrid->B1i[ks][j][i+1]);
+    GRID_U(pGrid,ks,j,i,B2c) = 0.5*(pGrid->B2i[ks][j][i]+pGrid->B2i[ks][j+1][i]);
+    GRID_U(pGrid,ks,j,i,B3c) = 0.0;
 #ifndef ISOTHERMAL
-    pGrid->U[ks][j][i].E = p0/Gamma_1
-        + 0.5*(SQR(pGrid->U[ks][j][i].B1c) + SQR(pGrid->U[ks][j][i].B2c)
-             + SQR(pGrid->U[ks][j][i].B3c))
-        + 0.5*(SQR(pGrid->U[ks][j][i].M1) + SQR(pGrid->U[ks][j][i].M2)
-              + SQR(pGrid->U[ks][j][i].M3))/pGrid->U[ks][j][i].d;
+    GRID_U(pGrid,ks,j,i,E) = p0/Gamma_1
+        + 0.5*(SQR(GRID_U(pGrid,ks,j,i,B1c)) + SQR(GRID_U(pGrid,ks,j,i,B2c))
+             + SQR(GRID_U(pGrid,ks,j,i,B3c)))
+        + 0.5*(SQR(GRID_U(pGrid,ks,j,i,M1)) + SQR(GRID_U(pGrid,ks,j,i,M2))
+              + SQR(GRID_U(pGrid,ks,j,i,M3)))/GRID_U(pGrid,ks,j,i,d);
 #endif
   }}
 
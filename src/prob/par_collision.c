@@ -118,11 +118,11 @@ void problem(DomainS *pDomain)
   for (j=pGrid->js; j<=pGrid->je; j++) {
   for (i=pGrid->is; i<=pGrid->ie; i++) {
     cc_pos(pGrid,i,j,pGrid->ks,&x1,&x2,&x3);
-    pGrid->U[pGrid->ks][j][i].d = 1.0;
+    GRID_U(pGrid,pGrid->ks,j,i,d) = 1.0;
 
-    pGrid->U[pGrid->ks][j][i].M1 = ux;
-    pGrid->U[pGrid->ks][j][i].M2 = uy;
-    pGrid->U[pGrid->ks][j][i].M3 = uz;
+    GRID_U(pGrid,pGrid->ks,j,i,M1) = ux;
+    GRID_U(pGrid,pGrid->ks,j,i,M2) = uy;
+    GRID_U(pGrid,pGrid->ks,j,i,M3) = uz;
   }}
 
 /* Now set initial conditions for the particles */
@@ -309,9 +309,9 @@ void Userwork_in_loop(MeshS *pM)
     t = pGrid->time + pGrid->dt;
     pos0 = ParticleTroj(t);
     vel0 = ParticleVel(t);
-    Mg1 = pGrid->U[pGrid->ks][pGrid->js][pGrid->is].M1;
-    Mg2 = pGrid->U[pGrid->ks][pGrid->js][pGrid->is].M2;
-    Mg3 = pGrid->U[pGrid->ks][pGrid->js][pGrid->is].M3;
+    Mg1 = GRID_U(pGrid,pGrid->ks,pGrid->js,pGrid->is,M1);
+    Mg2 = GRID_U(pGrid,pGrid->ks,pGrid->js,pGrid->is,M2);
+    Mg3 = GRID_U(pGrid,pGrid->ks,pGrid->js,pGrid->is,M3);
     gr = &(pGrid->particle[lab]);
 #ifdef FEEDBACK
     mp = grproperty[0].m*SQR(Npar);
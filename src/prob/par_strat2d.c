@@ -252,19 +252,19 @@ void problem(DomainS *pDomain)
     cc_pos(pGrid,i,j,pGrid->ks,&x1,&x2,&x3);
 
     rhog = exp(-0.5*SQR(x2/ScaleHg));
-    pGrid->U[pGrid->ks][j][i].d = rhog;
+    GRID_U(pGrid,pGrid->ks,j,i,d) = rhog;
 
     if (ipert != 1) {/* NSH velocity */
-      pGrid->U[pGrid->ks][j][i].M1 = 0.5*rhog*(uxNSH[j-js]+uxNSH[j-js+1]);
-      pGrid->U[pGrid->ks][j][i].M3 = 0.5*rhog*(uyNSH[j-js]+uyNSH[j-js+1]);
+      GRID_U(pGrid,pGrid->ks,j,i,M1) = 0.5*rhog*(uxNSH[j-js]+uxNSH[j-js+1]);
+      GRID_U(pGrid,pGrid->ks,j,i,M3) = 0.5*rhog*(uyNSH[j-js]+uyNSH[j-js+1]);
     } else {
-      pGrid->U[pGrid->ks][j][i].M1 = 0.0;
-      pGrid->U[pGrid->ks][j][i].M3 = 0.0;
+      GRID_U(pGrid,pGrid->ks,j,i,M1) = 0.0;
+      GRID_U(pGrid,pGrid->ks,j,i,M3) = 0.0;
     }
 
-    pGrid->U[pGrid->ks][j][i].M2 = 0.0;
+    GRID_U(pGrid,pGrid->ks,j,i,M2) = 0.0;
 #ifndef FARGO
-    pGrid->U[pGrid->ks][j][i].M3 -= qshear*rhog*Omega_0*x1;
+    GRID_U(pGrid,pGrid->ks,j,i,M3) -= qshear*rhog*Omega_0*x1;
 #endif
 
   }}
@@ -403,9 +403,9 @@ static Real hst_rho_Vx_dVy(const GridS *pG,
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M1*pG->U[k][j][i].M3/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
 #else
-  return pG->U[k][j][i].M1*(pG->U[k][j][i].M3/pG->U[k][j][i].d
+  return GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d)
                              + qshear*Omega_0*x1);
 #endif
 }
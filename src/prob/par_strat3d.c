@@ -255,19 +255,19 @@ void problem(DomainS *pDomain)
     cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
 
     rhog = exp(-0.5*SQR(x3/ScaleHg));
-    pGrid->U[k][j][i].d = rhog;
+    GRID_U(pGrid,k,j,i,d) = rhog;
 
     if (ipert != 1) {/* NSH velocity */
-      pGrid->U[k][j][i].M1 = 0.5*rhog*(uxNSH[k-ks]+uxNSH[k-ks+1]);
-      pGrid->U[k][j][i].M2 = 0.5*rhog*(uyNSH[k-ks]+uyNSH[k-ks+1]);
+      GRID_U(pGrid,k,j,i,M1) = 0.5*rhog*(uxNSH[k-ks]+uxNSH[k-ks+1]);
+      GRID_U(pGrid,k,j,i,M2) = 0.5*rhog*(uyNSH[k-ks]+uyNSH[k-ks+1]);
     } else {
-      pGrid->U[k][j][i].M1 = 0.0;
-      pGrid->U[k][j][i].M2 = 0.0;
+      GRID_U(pGrid,k,j,i,M1) = 0.0;
+      GRID_U(pGrid,k,j,i,M2) = 0.0;
     }
 
-    pGrid->U[k][j][i].M3 = 0.0;
+    GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifndef FARGO
-    pGrid->U[k][j][i].M2 -= qshear*rhog*Omega_0*x1;
+    GRID_U(pGrid,k,j,i,M2) -= qshear*rhog*Omega_0*x1;
 #endif
 
   }}}
@@ -406,9 +406,9 @@ static Real hst_rho_Vx_dVy(const GridS *pG,
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M1*pG->U[k][j][i].M2/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,M1)*GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d);
 #else
-  return pG->U[k][j][i].M1*(pG->U[k][j][i].M2/pG->U[k][j][i].d
+  return GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d)
                             + qshear*Omega_0*x1);
 #endif
 }
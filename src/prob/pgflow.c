@@ -173,14 +173,14 @@ void problem(DomainS *pDomain)
       }
 
       d0[k][j][i] = rho;
-      pGrid->U[k][j][i].d  = rho;
-      pGrid->U[k][j][i].M1 = Phi*cos_a;
-      pGrid->U[k][j][i].M2 = Phi*sin_a;
-      pGrid->U[k][j][i].M3 = 0.0;
-      pGrid->U[k][j][i].E = S*pow(rho,(double)Gamma)/Gamma_1
+      GRID_U(pGrid,k,j,i,d)  = rho;
+      GRID_U(pGrid,k,j,i,M1) = Phi*cos_a;
+      GRID_U(pGrid,k,j,i,M2) = Phi*sin_a;
+      GRID_U(pGrid,k,j,i,M3) = 0.0;
+      GRID_U(pGrid,k,j,i,E) = S*pow(rho,(double)Gamma)/Gamma_1
         + 0.5*Phi*Phi/rho;
 
-      E0 += pGrid->U[k][j][i].E + rho*psi;
+      E0 += GRID_U(pGrid,k,j,i,E) + rho*psi;
     }
   }}
 
@@ -234,7 +234,7 @@ void Userwork_in_loop(MeshS *pM)
     for (j=pGrid->js; j<=pGrid->je; j++) {
       for (i=pGrid->is; i<=pGrid->ie; i++) {
         cc_pos(pGrid,i,j,k,&x,&y,&z);
-        Et+=pGrid->U[k][j][i].E+pGrid->U[k][j][i].d*grav_pot(x,y,z);
+        Et+=GRID_U(pGrid,k,j,i,E)+GRID_U(pGrid,k,j,i,d)*grav_pot(x,y,z);
       }
     }
   }
@@ -342,5 +342,5 @@ static double Bfunc(double rho){
 
 static Real expr_drho(const GridS *pG, const int i, const int j, const int k)
 {
- return (pG->U[k][j][i].d - d0[k][j][i]);
+ return (GRID_U(pG,k,j,i,d) - d0[k][j][i]);
 }
@@ -54,39 +54,39 @@ void problem(DomainS *pDomain)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
-        pGrid->U[k][j][i].d = 1.0;
-        pGrid->U[k][j][i].M1 = 0.0;
-        pGrid->U[k][j][i].M2 = 0.0;
-        pGrid->U[k][j][i].M3 = 0.0;
+        GRID_U(pGrid,k,j,i,d) = 1.0;
+        GRID_U(pGrid,k,j,i,M1) = 0.0;
+        GRID_U(pGrid,k,j,i,M2) = 0.0;
+        GRID_U(pGrid,k,j,i,M3) = 0.0;
         pGrid->B1i[k][j][i] = bx0;
         pGrid->B2i[k][j][i] = 0.0;
-        pGrid->U[k][j][i].B1c = bx0;
-        pGrid->U[k][j][i].B2c = 0.0;
-        pGrid->U[k][j][i].B3c = 0.0;
+        GRID_U(pGrid,k,j,i,B1c) = bx0;
+        GRID_U(pGrid,k,j,i,B2c) = 0.0;
+        GRID_U(pGrid,k,j,i,B3c) = 0.0;
 
 /* reset density, velocity if cell is inside rotor */
 
         cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
         rad = sqrt(x1*x1 + x2*x2);
         if (rad <= r0) {
-          pGrid->U[k][j][i].d  = 10.0;
-          pGrid->U[k][j][i].M1 = -100.0*v0*x2;
-          pGrid->U[k][j][i].M2 = 100.0*v0*x1;
+          GRID_U(pGrid,k,j,i,d)  = 10.0;
+          GRID_U(pGrid,k,j,i,M1) = -100.0*v0*x2;
+          GRID_U(pGrid,k,j,i,M2) = 100.0*v0*x1;
         } else {
 
 /* smooth solution between r0 and r1.  For no smoothing, set r1<0 in input */
 
           if (rad <= r1) {
             frac = (0.115 - rad)/(0.015);
-            pGrid->U[k][j][i].d  = 1.0 + 9.0*frac;
-            pGrid->U[k][j][i].M1 = -frac*100.0*v0*x2;
-            pGrid->U[k][j][i].M2 = frac*100.0*v0*x1;
+            GRID_U(pGrid,k,j,i,d)  = 1.0 + 9.0*frac;
+            GRID_U(pGrid,k,j,i,M1) = -frac*100.0*v0*x2;
+            GRID_U(pGrid,k,j,i,M2) = frac*100.0*v0*x1;
           }
         }
 
-        pGrid->U[k][j][i].E = p0/Gamma_1 + 0.5*bx0*bx0
-          + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2))
-          /pGrid->U[k][j][i].d;
+        GRID_U(pGrid,k,j,i,E) = p0/Gamma_1 + 0.5*bx0*bx0
+          + 0.5*(SQR(GRID_U(pGrid,k,j,i,M1)) + SQR(GRID_U(pGrid,k,j,i,M2)))
+          /GRID_U(pGrid,k,j,i,d);
       }
     }
   }
@@ -120,28 +120,28 @@ void problem(DomainS *pDomain)
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
         cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
-	pGrid->U[k][j][i].d = 1.0;
-        pGrid->U[k][j][i].E = (1.0/Gamma - 0.1*x2)/Gamma_1;
-	pGrid->U[k][j][i].M1 = 0.0;
+	GRID_U(pGrid,k,j,i,d) = 1.0;
+        GRID_U(pGrid,k,j,i,E) = (1.0/Gamma - 0.1*x2)/Gamma_1;
+	GRID_U(pGrid,k,j,i,M1) = 0.0;
         if (iprob == 1) {
-          pGrid->U[k][j][i].M2 = amp/4.0*
+          GRID_U(pGrid,k,j,i,M2) = amp/4.0*
             (1.0+cos(2.0*PI*x1/lx))*(1.0+cos(2.0*PI*x2/ly));
         }
         else {
-          pGrid->U[k][j][i].M2 = amp*(ran2(&iseed) - 0.5)*
+          GRID_U(pGrid,k,j,i,M2) = amp*(ran2(&iseed) - 0.5)*
             (1.0+cos(2.0*PI*x2/ly));
 	}
-        pGrid->U[k][j][i].M3 = 0.0;
+        GRID_U(pGrid,k,j,i,M3) = 0.0;
         if (x2 > 0.0) {
-	  pGrid->U[k][j][i].d = 2.0;
-          pGrid->U[k][j][i].M2 *= 2.0;
-          pGrid->U[k][j][i].E = (1.0/Gamma - 0.2*x2)/Gamma_1;
+	  GRID_U(pGrid,k,j,i,d) = 2.0;
+          GRID_U(pGrid,k,j,i,M2) *= 2.0;
+          GRID_U(pGrid,k,j,i,E) = (1.0/Gamma - 0.2*x2)/Gamma_1;
 	}
-	pGrid->U[k][j][i].E+=0.5*SQR(pGrid->U[k][j][i].M2)/pGrid->U[k][j][i].d;
+	GRID_U(pGrid,k,j,i,E)+=0.5*SQR(GRID_U(pGrid,k,j,i,M2))/GRID_U(pGrid,k,j,i,d);
 #ifdef MHD
 	pGrid->B1i[k][j][i] = b0;
-	pGrid->U[k][j][i].B1c = b0;
-        pGrid->U[k][j][i].E += 0.5*b0*b0;
+	GRID_U(pGrid,k,j,i,B1c) = b0;
+        GRID_U(pGrid,k,j,i,E) += 0.5*b0*b0;
 #endif
       }
 #ifdef MHD
@@ -177,65 +177,65 @@ void problem(DomainS *pDomain)
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
         cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
-	pGrid->U[k][j][i].d = 1.0;
-        pGrid->U[k][j][i].E = (1.0/Gamma - 0.1*x3)/Gamma_1;
-	pGrid->U[k][j][i].M1 = 0.0;
-	pGrid->U[k][j][i].M2 = 0.0;
+	GRID_U(pGrid,k,j,i,d) = 1.0;
+        GRID_U(pGrid,k,j,i,E) = (1.0/Gamma - 0.1*x3)/Gamma_1;
+	GRID_U(pGrid,k,j,i,M1) = 0.0;
+	GRID_U(pGrid,k,j,i,M2) = 0.0;
         if (iprob == 1) {
-          pGrid->U[k][j][i].M3 = amp/8.0*(1.0+cos(2.0*PI*x1/lx))*
+          GRID_U(pGrid,k,j,i,M3) = amp/8.0*(1.0+cos(2.0*PI*x1/lx))*
             (1.0+cos(2.0*PI*x2/ly))*(1.0+cos(2.0*PI*x3/lz));
         }
         else {
-          pGrid->U[k][j][i].M3 = amp*(ran2(&iseed) - 0.5)*
+          GRID_U(pGrid,k,j,i,M3) = amp*(ran2(&iseed) - 0.5)*
             (1.0+cos(2.0*PI*x3/lz));
 	}
         if (x3 > 0.0) {
-	  pGrid->U[k][j][i].d = rhoh;
-          pGrid->U[k][j][i].M3 *= rhoh;
-          pGrid->U[k][j][i].E = (1.0/Gamma - 0.1*rhoh*x3)/Gamma_1;
+	  GRID_U(pGrid,k,j,i,d) = rhoh;
+          GRID_U(pGrid,k,j,i,M3) *= rhoh;
+          GRID_U(pGrid,k,j,i,E) = (1.0/Gamma - 0.1*rhoh*x3)/Gamma_1;
 	}
-	pGrid->U[k][j][i].E+=0.5*SQR(pGrid->U[k][j][i].M3)/pGrid->U[k][j][i].d;
+	GRID_U(pGrid,k,j,i,E)+=0.5*SQR(GRID_U(pGrid,k,j,i,M3))/GRID_U(pGrid,k,j,i,d);
 #ifdef MHD
         switch(iprob){
         case 3: /* B only in light fluid, do not add B^2 to E, total P const */
           if (x3 <= 0.0) {
             pGrid->B1i[k][j][i] = b0;
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-            pGrid->U[k][j][i].B1c = b0;
+            GRID_U(pGrid,k,j,i,B1c) = b0;
           }
           break;
         case 4: /* discontinuous rotation of B by angle at interface */
           if (x3 <= 0.0) {
             pGrid->B1i[k][j][i] = b0;
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-            pGrid->U[k][j][i].B1c = b0;
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            GRID_U(pGrid,k,j,i,B1c) = b0;
+            GRID_U(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           else {
             pGrid->B1i[k][j][i] = b0*cos(angle);
             pGrid->B2i[k][j][i] = b0*sin(angle);
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0*cos(angle);
             if (j == je) pGrid->B2i[k][je+1][i] = b0*sin(angle);
-            pGrid->U[k][j][i].B1c = b0*cos(angle);
-            pGrid->U[k][j][i].B2c = b0*sin(angle);
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            GRID_U(pGrid,k,j,i,B1c) = b0*cos(angle);
+            GRID_U(pGrid,k,j,i,B2c) = b0*sin(angle);
+            GRID_U(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           break;
         case 5: /* rotation of B by angle over distance L_rot at interface */
           if (x3 <= (-L_rot/2.0)) {
             pGrid->B1i[k][j][i] = b0;
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-            pGrid->U[k][j][i].B1c = b0;
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            GRID_U(pGrid,k,j,i,B1c) = b0;
+            GRID_U(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           else if (x3 >= (L_rot/2.0)) {
             pGrid->B1i[k][j][i] = b0*cos(angle);
             pGrid->B2i[k][j][i] = b0*sin(angle);
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0*cos(angle);
             if (j == je) pGrid->B2i[k][je+1][i] = b0*sin(angle);
-            pGrid->U[k][j][i].B1c = b0*cos(angle);
-            pGrid->U[k][j][i].B2c = b0*sin(angle);
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            GRID_U(pGrid,k,j,i,B1c) = b0*cos(angle);
+            GRID_U(pGrid,k,j,i,B2c) = b0*sin(angle);
+            GRID_U(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
           else {
             fact = ((L_rot/2.0)+x3)/L_rot;
@@ -243,17 +243,17 @@ void problem(DomainS *pDomain)
             pGrid->B2i[k][j][i] = b0*sin(fact*angle);
             if (i == ie) pGrid->B1i[k][j][ie+1] = b0*cos(fact*angle);
             if (j == je) pGrid->B2i[k][je+1][i] = b0*sin(fact*angle);
-            pGrid->U[k][j][i].B1c = b0*cos(fact*angle);
-            pGrid->U[k][j][i].B2c = b0*sin(fact*angle);
-            pGrid->U[k][j][i].E += 0.5*b0*b0;
+            GRID_U(pGrid,k,j,i,B1c) = b0*cos(fact*angle);
+            GRID_U(pGrid,k,j,i,B2c) = b0*sin(fact*angle);
+            GRID_U(pGrid,k,j,i,E) += 0.5*b0*b0;
           }
 
           break;
         default:
           pGrid->B1i[k][j][i] = b0;
           if (i == ie) pGrid->B1i[k][j][ie+1] = b0;
-          pGrid->U[k][j][i].B1c = b0;
-          pGrid->U[k][j][i].E += 0.5*b0*b0;
+          GRID_U(pGrid,k,j,i,B1c) = b0;
+          GRID_U(pGrid,k,j,i,E) += 0.5*b0*b0;
         }
 #endif
       }
@@ -439,10 +439,10 @@ static void reflect_ix2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=il; i<=iu; i++) {
-        pGrid->U[k][js-j][i]    =  pGrid->U[k][js+(j-1)][i];
-        pGrid->U[k][js-j][i].M2 = -pGrid->U[k][js-j][i].M2; /* reflect 2-mom. */
-        pGrid->U[k][js-j][i].E +=  
-	  pGrid->U[k][js+(j-1)][i].d*0.1*(2*j-1)*pGrid->dx2/Gamma_1;
+        SET_GRID_U(pGrid,k,js-j,i,GET_GRID_U(pGrid,k,js+(j-1),i));
+        GRID_U(pGrid,k,js-j,i,M2) = -GRID_U(pGrid,k,js-j,i,M2); /* reflect 2-mom. */
+        GRID_U(pGrid,k,js-j,i,E) +=  
+	  GRID_U(pGrid,k,js+(j-1),i,d)*0.1*(2*j-1)*pGrid->dx2/Gamma_1;
       }
     }
   }
@@ -502,10 +502,10 @@ static void reflect_ox2(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=il; i<=iu; i++) {
-        pGrid->U[k][je+j][i]    =  pGrid->U[k][je-(j-1)][i];
-        pGrid->U[k][je+j][i].M2 = -pGrid->U[k][je+j][i].M2; /* reflect 2-mom. */
-        pGrid->U[k][je+j][i].E -=
-          pGrid->U[k][je-(j-1)][i].d*0.1*(2*j-1)*pGrid->dx2/Gamma_1;
+        SET_GRID_U(pGrid,k,je+j,i,GET_GRID_U(pGrid,k,je-(j-1),i));
+        GRID_U(pGrid,k,je+j,i,M2) = -GRID_U(pGrid,k,je+j,i,M2); /* reflect 2-mom. */
+        GRID_U(pGrid,k,je+j,i,E) -=
+          GRID_U(pGrid,k,je-(j-1),i,d)*0.1*(2*j-1)*pGrid->dx2/Gamma_1;
       }
     }
   }
@@ -564,10 +564,10 @@ static void reflect_ix3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pGrid->U[ks-k][j][i]    =  pGrid->U[ks+(k-1)][j][i];
-        pGrid->U[ks-k][j][i].M3 = -pGrid->U[ks-k][j][i].M3; /* reflect 3-mom. */
-        pGrid->U[ks-k][j][i].E +=
-          pGrid->U[ks+(k-1)][j][i].d*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
+        SET_GRID_U(pGrid,ks-k,j,i,GET_GRID_U(pGrid,ks+(k-1),j,i));
+        GRID_U(pGrid,ks-k,j,i,M3) = -GRID_U(pGrid,ks-k,j,i,M3); /* reflect 3-mom. */
+        GRID_U(pGrid,ks-k,j,i,E) +=
+          GRID_U(pGrid,ks+(k-1),j,i,d)*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
       }
     }
   }
@@ -622,10 +622,10 @@ static void reflect_ox3(GridS *pGrid)
   for (k=1; k<=nghost; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pGrid->U[ke+k][j][i]    =  pGrid->U[ke-(k-1)][j][i];
-        pGrid->U[ke+k][j][i].M3 = -pGrid->U[ke+k][j][i].M3; /* reflect 3-mom. */
-        pGrid->U[ke+k][j][i].E -=
-          pGrid->U[ke-(k-1)][j][i].d*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
+        SET_GRID_U(pGrid,ke+k,j,i,GET_GRID_U(pGrid,ke-(k-1),j,i));
+        GRID_U(pGrid,ke+k,j,i,M3) = -GRID_U(pGrid,ke+k,j,i,M3); /* reflect 3-mom. */
+        GRID_U(pGrid,ke+k,j,i,E) -=
+          GRID_U(pGrid,ke-(k-1),j,i,d)*0.1*(2*k-1)*pGrid->dx3/Gamma_1;
       }
     }
   }
@@ -110,78 +110,78 @@ void problem(DomainS *pDomain)
 
 /* postshock flow */
         if(x1 < xshock) {
-          pGrid->U[k][j][i].d  = dl;
-          pGrid->U[k][j][i].M1 = ul*dl;
-          pGrid->U[k][j][i].M2 = 0.0;
-          pGrid->U[k][j][i].M3 = 0.0;
+          GRID_U(pGrid,k,j,i,d)  = dl;
+          GRID_U(pGrid,k,j,i,M1) = ul*dl;
+          GRID_U(pGrid,k,j,i,M2) = 0.0;
+          GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef MHD
           pGrid->B1i[k][j][i] = bxl;
           pGrid->B2i[k][j][i] = byl;
           pGrid->B3i[k][j][i] = bzl;
-          pGrid->U[k][j][i].B1c = bxl;
-          pGrid->U[k][j][i].B2c = byl;
-          pGrid->U[k][j][i].B3c = bzl;
+          GRID_U(pGrid,k,j,i,B1c) = bxl;
+          GRID_U(pGrid,k,j,i,B2c) = byl;
+          GRID_U(pGrid,k,j,i,B3c) = bzl;
 #endif
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E = pl/Gamma_1 
+          GRID_U(pGrid,k,j,i,E) = pl/Gamma_1 
 #ifdef MHD
             + 0.5*(bxl*bxl + byl*byl + bzl*bzl)
 #endif
             + 0.5*dl*(ul*ul);
 #endif
 #if (NSCALARS > 0)
-          pGrid->U[k][j][i].s[0] = 0.0;
+          GRID_U(pGrid,k,j,i,s[0]) = 0.0;
 #endif
 
 /* preshock ambient gas */
         } else {
-          pGrid->U[k][j][i].d  = dr;
-          pGrid->U[k][j][i].M1 = ur*dr;
-          pGrid->U[k][j][i].M2 = 0.0;
-          pGrid->U[k][j][i].M3 = 0.0;
+          GRID_U(pGrid,k,j,i,d)  = dr;
+          GRID_U(pGrid,k,j,i,M1) = ur*dr;
+          GRID_U(pGrid,k,j,i,M2) = 0.0;
+          GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef MHD
           pGrid->B1i[k][j][i] = bxr;
           pGrid->B2i[k][j][i] = byr;
           pGrid->B3i[k][j][i] = bzr;
-          pGrid->U[k][j][i].B1c = bxr;
-          pGrid->U[k][j][i].B2c = byr;
-          pGrid->U[k][j][i].B3c = bzr;
+          GRID_U(pGrid,k,j,i,B1c) = bxr;
+          GRID_U(pGrid,k,j,i,B2c) = byr;
+          GRID_U(pGrid,k,j,i,B3c) = bzr;
 #endif
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E = pr/Gamma_1
+          GRID_U(pGrid,k,j,i,E) = pr/Gamma_1
 #ifdef MHD
             + 0.5*(bxr*bxr + byr*byr + bzr*bzr)
 #endif
             + 0.5*dr*(ur*ur);
 #endif
 #if (NSCALARS > 0)
-          pGrid->U[k][j][i].s[0] = 0.0;
+          GRID_U(pGrid,k,j,i,s[0]) = 0.0;
 #endif
         }
 
 /* cloud interior */
         if (diag < rad) {
-          pGrid->U[k][j][i].d  = dr*drat;
-          pGrid->U[k][j][i].M1 = ur*dr*drat;
-          pGrid->U[k][j][i].M2 = 0.0;
-          pGrid->U[k][j][i].M3 = 0.0;
+          GRID_U(pGrid,k,j,i,d)  = dr*drat;
+          GRID_U(pGrid,k,j,i,M1) = ur*dr*drat;
+          GRID_U(pGrid,k,j,i,M2) = 0.0;
+          GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef MHD
           pGrid->B1i[k][j][i] = bxr;
           pGrid->B2i[k][j][i] = byr;
           pGrid->B3i[k][j][i] = bzr;
-          pGrid->U[k][j][i].B1c = bxr;
-          pGrid->U[k][j][i].B2c = byr;
-          pGrid->U[k][j][i].B3c = bzr;
+          GRID_U(pGrid,k,j,i,B1c) = bxr;
+          GRID_U(pGrid,k,j,i,B2c) = byr;
+          GRID_U(pGrid,k,j,i,B3c) = bzr;
 #endif
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E = pr/Gamma_1
+          GRID_U(pGrid,k,j,i,E) = pr/Gamma_1
 #ifdef MHD
             + 0.5*(bxr*bxr + byr*byr + bzr*bzr)
 #endif
             + 0.5*dr*drat*(ur*ur);
 #endif
 #if (NSCALARS > 0)
-          pGrid->U[k][j][i].s[0] = drat;
+          GRID_U(pGrid,k,j,i,s[0]) = drat;
 #endif
         }
       }
@@ -249,7 +249,7 @@ void problem_read_restart(MeshS *pM, FILE *fp)
 #if (NSCALARS > 0)
 static Real color(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].s[0]/pG->U[k][j][i].d;
+  return GRID_U(pG,k,j,i,s[0])/GRID_U(pG,k,j,i,d);
 }
 #endif
 
@@ -296,27 +296,27 @@ void shk_cloud_iib(GridS *pGrid)
   for (k=ks; k<=ke; k++) {
     for (j=js; j<=je; j++) {
       for (i=1; i<=nghost; i++) {
-        pGrid->U[k][j][i].d  = dl;
-        pGrid->U[k][j][i].M1 = ul*dl;
-        pGrid->U[k][j][i].M2 = 0.0;
-        pGrid->U[k][j][i].M3 = 0.0;
+        GRID_U(pGrid,k,j,i,d)  = dl;
+        GRID_U(pGrid,k,j,i,M1) = ul*dl;
+        GRID_U(pGrid,k,j,i,M2) = 0.0;
+        GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifdef MHD
         pGrid->B1i[k][j][i] = bxl;
         pGrid->B2i[k][j][i] = byl;
         pGrid->B3i[k][j][i] = bzl;
-        pGrid->U[k][j][i].B1c = bxl;
-        pGrid->U[k][j][i].B2c = byl;
-        pGrid->U[k][j][i].B3c = bzl;
+        GRID_U(pGrid,k,j,i,B1c) = bxl;
+        GRID_U(pGrid,k,j,i,B2c) = byl;
+        GRID_U(pGrid,k,j,i,B3c) = bzl;
 #endif
 #ifdef ADIABATIC
-        pGrid->U[k][j][i].E = pl/Gamma_1
+        GRID_U(pGrid,k,j,i,E) = pl/Gamma_1
 #ifdef MHD
           + 0.5*(bxl*bxl + byl*byl + bzl*bzl)
 #endif
           + 0.5*dl*(ul*ul);
 #endif
 #if (NSCALARS > 0)
-        pGrid->U[k][j][i].s[0] = 0.0;
+        GRID_U(pGrid,k,j,i,s[0]) = 0.0;
 #endif
       }
     }
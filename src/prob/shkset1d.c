@@ -156,23 +156,23 @@ void problem(DomainS *pDomain)
           }
 
 /* Initialize conserved (and with SR the primitive) variables in Grid */
-          pGrid->U[k][j][i].d  = U1d.d;
-          pGrid->U[k][j][i].M1 = U1d.Mx;
-          pGrid->U[k][j][i].M2 = U1d.My;
-          pGrid->U[k][j][i].M3 = U1d.Mz;
+          GRID_U(pGrid,k,j,i,d)  = U1d.d;
+          GRID_U(pGrid,k,j,i,M1) = U1d.Mx;
+          GRID_U(pGrid,k,j,i,M2) = U1d.My;
+          GRID_U(pGrid,k,j,i,M3) = U1d.Mz;
 #ifdef MHD
           pGrid->B1i[k][j][i] = Bxl;
           pGrid->B2i[k][j][i] = U1d.By;
           pGrid->B3i[k][j][i] = U1d.Bz;
-          pGrid->U[k][j][i].B1c = Bxl;
-          pGrid->U[k][j][i].B2c = U1d.By;
-          pGrid->U[k][j][i].B3c = U1d.Bz;
+          GRID_U(pGrid,k,j,i,B1c) = Bxl;
+          GRID_U(pGrid,k,j,i,B2c) = U1d.By;
+          GRID_U(pGrid,k,j,i,B3c) = U1d.Bz;
 #endif
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E = U1d.E;
+          GRID_U(pGrid,k,j,i,E) = U1d.E;
 #endif
 #if (NSCALARS > 0)
-          pGrid->U[k][j][i].s[0] = U1d.s[0];
+          GRID_U(pGrid,k,j,i,s[0]) = U1d.s[0];
 #endif
         }
       }
@@ -196,23 +196,23 @@ void problem(DomainS *pDomain)
           }
 
 /* Initialize conserved (and with SR the primitive) variables in Grid */
-          pGrid->U[k][j][i].d  = U1d.d;
-          pGrid->U[k][j][i].M1 = -U1d.My;
-          pGrid->U[k][j][i].M2 = U1d.Mx;
-          pGrid->U[k][j][i].M3 = U1d.Mz;
+          GRID_U(pGrid,k,j,i,d)  = U1d.d;
+          GRID_U(pGrid,k,j,i,M1) = -U1d.My;
+          GRID_U(pGrid,k,j,i,M2) = U1d.Mx;
+          GRID_U(pGrid,k,j,i,M3) = U1d.Mz;
 #ifdef MHD
           pGrid->B1i[k][j][i] = -U1d.By;
           pGrid->B2i[k][j][i] = Bxl;
           pGrid->B3i[k][j][i] = U1d.Bz;
-          pGrid->U[k][j][i].B1c = -U1d.By;
-          pGrid->U[k][j][i].B2c = Bxl;
-          pGrid->U[k][j][i].B3c = U1d.Bz;
+          GRID_U(pGrid,k,j,i,B1c) = -U1d.By;
+          GRID_U(pGrid,k,j,i,B2c) = Bxl;
+          GRID_U(pGrid,k,j,i,B3c) = U1d.Bz;
 #endif
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E = U1d.E;
+          GRID_U(pGrid,k,j,i,E) = U1d.E;
 #endif
 #if (NSCALARS > 0)
-          pGrid->U[k][j][i].s[0] = U1d.s[0];
+          GRID_U(pGrid,k,j,i,s[0]) = U1d.s[0];
 #endif
         }
       }
@@ -236,23 +236,23 @@ void problem(DomainS *pDomain)
           }
 
 /* Initialize conserved (and with SR the primitive) variables in Grid */
-          pGrid->U[k][j][i].d  = U1d.d;
-          pGrid->U[k][j][i].M1 = -U1d.Mz;
-          pGrid->U[k][j][i].M2 = U1d.My;
-          pGrid->U[k][j][i].M3 = U1d.Mx;
+          GRID_U(pGrid,k,j,i,d)  = U1d.d;
+          GRID_U(pGrid,k,j,i,M1) = -U1d.Mz;
+          GRID_U(pGrid,k,j,i,M2) = U1d.My;
+          GRID_U(pGrid,k,j,i,M3) = U1d.Mx;
 #ifdef MHD
           pGrid->B1i[k][j][i] = -U1d.Bz;
           pGrid->B2i[k][j][i] = U1d.By;
           pGrid->B3i[k][j][i] = Bxl;
-          pGrid->U[k][j][i].B1c = -U1d.Bz;
-          pGrid->U[k][j][i].B2c = U1d.By;
-          pGrid->U[k][j][i].B3c = Bxl;
+          GRID_U(pGrid,k,j,i,B1c) = -U1d.Bz;
+          GRID_U(pGrid,k,j,i,B2c) = U1d.By;
+          GRID_U(pGrid,k,j,i,B3c) = Bxl;
 #endif
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E = U1d.E;
+          GRID_U(pGrid,k,j,i,E) = U1d.E;
 #endif
 #if (NSCALARS > 0)
-          pGrid->U[k][j][i].s[0] = U1d.s[0];
+          GRID_U(pGrid,k,j,i,s[0]) = U1d.s[0];
 #endif
         }
       }
@@ -535,21 +535,21 @@ void Userwork_after_loop(MeshS *pM)
 #endif
 
     for (i=is; i<=ie; i++) {
-      error.d   += fabs(pGrid->U[k][j][i].d   - RootSoln[k][j][i].d );
-      error.M1  += fabs(pGrid->U[k][j][i].M1  - RootSoln[k][j][i].M1);
-      error.M2  += fabs(pGrid->U[k][j][i].M2  - RootSoln[k][j][i].M2);
-      error.M3  += fabs(pGrid->U[k][j][i].M3  - RootSoln[k][j][i].M3); 
+      error.d   += fabs(GRID_U(pGrid,k,j,i,d)   - RootSoln[k][j][i].d );
+      error.M1  += fabs(GRID_U(pGrid,k,j,i,M1)  - RootSoln[k][j][i].M1);
+      error.M2  += fabs(GRID_U(pGrid,k,j,i,M2)  - RootSoln[k][j][i].M2);
+      error.M3  += fabs(GRID_U(pGrid,k,j,i,M3)  - RootSoln[k][j][i].M3); 
 #ifdef MHD
-      error.B1c += fabs(pGrid->U[k][j][i].B1c - RootSoln[k][j][i].B1c);
-      error.B2c += fabs(pGrid->U[k][j][i].B2c - RootSoln[k][j][i].B2c);
-      error.B3c += fabs(pGrid->U[k][j][i].B3c - RootSoln[k][j][i].B3c);
+      error.B1c += fabs(GRID_U(pGrid,k,j,i,B1c) - RootSoln[k][j][i].B1c);
+      error.B2c += fabs(GRID_U(pGrid,k,j,i,B2c) - RootSoln[k][j][i].B2c);
+      error.B3c += fabs(GRID_U(pGrid,k,j,i,B3c) - RootSoln[k][j][i].B3c);
 #endif /* MHD */
 #ifndef ISOTHERMAL
-      error.E   += fabs(pGrid->U[k][j][i].E   - RootSoln[k][j][i].E );
+      error.E   += fabs(GRID_U(pGrid,k,j,i,E)   - RootSoln[k][j][i].E );
 #endif /* ISOTHERMAL */
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++)
-        error.s[n] += fabs(pGrid->U[k][j][i].s[n] - RootSoln[k][j][i].s[n]);
+        error.s[n] += fabs(GRID_U(pGrid,k,j,i,s[n]) - RootSoln[k][j][i].s[n]);
 #endif
     }
 
@@ -234,7 +234,7 @@ void problem(DomainS *pDomain)
 
 /* cell is completely in the left state */
 	if((drr = r2*(ix1) + r1*(ix2) - gcd*r1*r2) <= 0){
-	  pGrid->U[k][j][i] = ql;
+	  SET_GRID_U(pGrid,k,j,i,ql);
 #ifdef MHD
 	  pGrid->B1i[k][j][i] = ql.B1c;
 	  pGrid->B2i[k][j][i] = ql.B2c;
@@ -243,7 +243,7 @@ void problem(DomainS *pDomain)
 	}
 /* cell is completely in the right state */
 	else if((dll = r2*(ix1-1) + r1*(ix2-1) - gcd*r1*r2) >= 0){
-	  pGrid->U[k][j][i] = qr;
+	  SET_GRID_U(pGrid,k,j,i,qr);
 #ifdef MHD
 	  pGrid->B1i[k][j][i] = qr.B1c;
 	  pGrid->B2i[k][j][i] = qr.B2c;
@@ -331,17 +331,17 @@ void problem(DomainS *pDomain)
 #endif /* MHD */
 
 /* Initialize the volume averaged quantities */
-	  pGrid->U[k][j][i].d  = vfl*ql.d + vfr*qr.d;
-	  pGrid->U[k][j][i].M1 = vfl*ql.M1 + vfr*qr.M1;
-	  pGrid->U[k][j][i].M2 = vfl*ql.M2 + vfr*qr.M2;
-	  pGrid->U[k][j][i].M3 = vfl*ql.M3 + vfr*qr.M3;
+	  GRID_U(pGrid,k,j,i,d)  = vfl*ql.d + vfr*qr.d;
+	  GRID_U(pGrid,k,j,i,M1) = vfl*ql.M1 + vfr*qr.M1;
+	  GRID_U(pGrid,k,j,i,M2) = vfl*ql.M2 + vfr*qr.M2;
+	  GRID_U(pGrid,k,j,i,M3) = vfl*ql.M3 + vfr*qr.M3;
 #ifdef MHD
-	  pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i] + B1r);
-	  pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i] + B2r);
-	  pGrid->U[k][j][i].B3c = vfl*ql.B3c + vfr*qr.B3c;
+	  GRID_U(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i] + B1r);
+	  GRID_U(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i] + B2r);
+	  GRID_U(pGrid,k,j,i,B3c) = vfl*ql.B3c + vfr*qr.B3c;
 #endif /* MHD */
 #ifndef ISOTHERMAL
-	  pGrid->U[k][j][i].E  = vfl*ql.E + vfr*qr.E;
+	  GRID_U(pGrid,k,j,i,E)  = vfl*ql.E + vfr*qr.E;
 #endif
 	}
       }
@@ -610,17 +610,17 @@ void Userwork_after_loop(MeshS *pM)
 #endif /* ISOTHERMAL */
 
     for (i=is; i<=ie; i++) {
-      error.d   += fabs(pGrid->U[k][j][i].d   - RootSoln[k][j][i].d );
-      error.M1  += fabs(pGrid->U[k][j][i].M1  - RootSoln[k][j][i].M1);
-      error.M2  += fabs(pGrid->U[k][j][i].M2  - RootSoln[k][j][i].M2);
-      error.M3  += fabs(pGrid->U[k][j][i].M3  - RootSoln[k][j][i].M3); 
+      error.d   += fabs(GRID_U(pGrid,k,j,i,d)   - RootSoln[k][j][i].d );
+      error.M1  += fabs(GRID_U(pGrid,k,j,i,M1)  - RootSoln[k][j][i].M1);
+      error.M2  += fabs(GRID_U(pGrid,k,j,i,M2)  - RootSoln[k][j][i].M2);
+      error.M3  += fabs(GRID_U(pGrid,k,j,i,M3)  - RootSoln[k][j][i].M3); 
 #ifdef MHD
-      error.B1c += fabs(pGrid->U[k][j][i].B1c - RootSoln[k][j][i].B1c);
-      error.B2c += fabs(pGrid->U[k][j][i].B2c - RootSoln[k][j][i].B2c);
-      error.B3c += fabs(pGrid->U[k][j][i].B3c - RootSoln[k][j][i].B3c);
+      error.B1c += fabs(GRID_U(pGrid,k,j,i,B1c) - RootSoln[k][j][i].B1c);
+      error.B2c += fabs(GRID_U(pGrid,k,j,i,B2c) - RootSoln[k][j][i].B2c);
+      error.B3c += fabs(GRID_U(pGrid,k,j,i,B3c) - RootSoln[k][j][i].B3c);
 #endif /* MHD */
 #ifndef ISOTHERMAL
-      error.E   += fabs(pGrid->U[k][j][i].E   - RootSoln[k][j][i].E );
+      error.E   += fabs(GRID_U(pGrid,k,j,i,E)   - RootSoln[k][j][i].E );
 #endif /* ISOTHERMAL */
     }
 
@@ -809,7 +809,7 @@ void shkset2d_iib(GridS *pGrid)
   for (k=kl; k<=ku; k++) {
     for (i=1; i<=nghost; i++) { /* Do NOT Change this loop ordering! */
       for (j=jl; j<=ju; j++) {
-	pGrid->U  [k][j][is-i] = pGrid->U  [k][j-r2][is-i+r1];
+	SET_GRID_U(pGrid,k,j,is-i,GET_GRID_U(pGrid,k,j-r2,is-i+r1));
 #ifdef MHD
 	pGrid->B1i[k][j][is-i] = pGrid->B1i[k][j-r2][is-i+r1];
 	pGrid->B2i[k][j][is-i] = pGrid->B2i[k][j-r2][is-i+r1];
@@ -853,7 +853,7 @@ void shkset2d_oib(GridS *pGrid)
   for (k=kl; k<=ku; k++) {
     for (i=1; i<=nghost; i++) { /* Do NOT Change this loop ordering! */
       for (j=jl; j<=ju; j++) {
-	pGrid->U[k][j][ie+i] = pGrid->U[k][j+r2][ie+i-r1];
+	SET_GRID_U(pGrid,k,j,ie+i,GET_GRID_U(pGrid,k,j+r2,ie+i-r1));
 #ifdef MHD
 	if(i>1) pGrid->B1i[k][j][ie+i] = pGrid->B1i[k][j+r2][ie+i-r1];
 	pGrid->B2i[k][j][ie+i] = pGrid->B2i[k][j+r2][ie+i-r1];
@@ -890,7 +890,7 @@ void shkset2d_ijb(GridS *pGrid)
   for (k=kl; k<=ku; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=il; i<=iu; i++) {
-	pGrid->U  [k][js-j][i] = pGrid->U  [k][js-j+r2][i-r1];
+	SET_GRID_U(pGrid,k,js-j,i,GET_GRID_U(pGrid,k,js-j+r2,i-r1));
 #ifdef MHD
 	pGrid->B1i[k][js-j][i] = pGrid->B1i[k][js-j+r2][i-r1];
 	pGrid->B2i[k][js-j][i] = pGrid->B2i[k][js-j+r2][i-r1];
@@ -929,7 +929,7 @@ void shkset2d_ojb(GridS *pGrid)
   for (k=kl; k<=ku; k++) {
     for (j=1; j<=nghost; j++) {
       for (i=il; i<=iu; i++) {
-	pGrid->U[k][je+j][i] = pGrid->U[k][je+j-r2][i+r1];
+	SET_GRID_U(pGrid,k,je+j,i,GET_GRID_U(pGrid,k,je+j-r2,i+r1));
 #ifdef MHD
 	pGrid->B1i[k][je+j][i] = pGrid->B1i[k][je+j-r2][i+r1];
 	if(j>1) pGrid->B2i[k][je+j][i] = pGrid->B2i[k][je+j-r2][i+r1];
@@ -168,17 +168,17 @@ void problem(DomainS *pDomain)
 /* Initialize d, M, and P.  For 3D shearing box M1=Vx, M2=Vy, M3=Vz
  * With FARGO do not initialize the background shear */ 
 
-      pGrid->U[k][j][i].d  = rd;
-      pGrid->U[k][j][i].M1 = rd*rvx;
-      pGrid->U[k][j][i].M2 = rd*rvy;
+      GRID_U(pGrid,k,j,i,d)  = rd;
+      GRID_U(pGrid,k,j,i,M1) = rd*rvx;
+      GRID_U(pGrid,k,j,i,M2) = rd*rvy;
 #ifndef FARGO
-      pGrid->U[k][j][i].M2 -= rd*(qshear*Omega_0*x1);
+      GRID_U(pGrid,k,j,i,M2) -= rd*(qshear*Omega_0*x1);
 #endif
-      pGrid->U[k][j][i].M3 = rd*rvz;
+      GRID_U(pGrid,k,j,i,M3) = rd*rvz;
 #ifdef ADIABATIC
-      pGrid->U[k][j][i].E = rp/Gamma_1
-        + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2) 
-             + SQR(pGrid->U[k][j][i].M3))/rd;
+      GRID_U(pGrid,k,j,i,E) = rp/Gamma_1
+        + 0.5*(SQR(GRID_U(pGrid,k,j,i,M1)) + SQR(GRID_U(pGrid,k,j,i,M2)) 
+             + SQR(GRID_U(pGrid,k,j,i,M3)))/rd;
 #endif
 
 /* Initialize magnetic field.  For 3D shearing box B1=Bx, B2=By, B3=Bz
@@ -293,8 +293,8 @@ void problem(DomainS *pDomain)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je+1; j++) {
         for (i=is; i<=ie; i++) {
-          pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-          pGrid->U[k][j][i].B3c = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+          GRID_U(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+          GRID_U(pGrid,k,j,i,B3c) = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
         }
       }
     }
@@ -302,8 +302,8 @@ void problem(DomainS *pDomain)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je+1; j++) {
         for (i=is; i<=ie; i++) {
-          if (SQR(pGrid->U[k][j][i].B1c)+SQR(pGrid->U[k][j][i].B3c) != 0.0) {
-            pGrid->B2i[k][j][i] = sqrt(SQR(B0)-(SQR(pGrid->U[k][j][i].B1c)+SQR(pGrid->U[k][j][i].B3c)));
+          if (SQR(GRID_U(pGrid,k,j,i,B1c))+SQR(GRID_U(pGrid,k,j,i,B3c)) != 0.0) {
+            pGrid->B2i[k][j][i] = sqrt(SQR(B0)-(SQR(GRID_U(pGrid,k,j,i,B1c))+SQR(GRID_U(pGrid,k,j,i,B3c))));
           } else {
             pGrid->B2i[k][j][i] = 0.0;
           }
@@ -312,10 +312,10 @@ void problem(DomainS *pDomain)
   /* Finally, calculate cell centered By field from face fields */
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+          GRID_U(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-               + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+          GRID_U(pGrid,k,j,i,E) += 0.5*(SQR(GRID_U(pGrid,k,j,i,B1c))
+               + SQR(GRID_U(pGrid,k,j,i,B2c)) + SQR(GRID_U(pGrid,k,j,i,B3c)));
 #endif
         }
       }
@@ -324,12 +324,12 @@ void problem(DomainS *pDomain)
     for (k=ks; k<=ke; k++) {
       for (j=js; j<=je; j++) {
         for (i=is; i<=ie; i++) {
-          pGrid->U[k][j][i].B1c = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
-          pGrid->U[k][j][i].B2c = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
-          pGrid->U[k][j][i].B3c = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
+          GRID_U(pGrid,k,j,i,B1c) = 0.5*(pGrid->B1i[k][j][i]+pGrid->B1i[k][j][i+1]);
+          GRID_U(pGrid,k,j,i,B2c) = 0.5*(pGrid->B2i[k][j][i]+pGrid->B2i[k][j+1][i]);
+          GRID_U(pGrid,k,j,i,B3c) = 0.5*(pGrid->B3i[k][j][i]+pGrid->B3i[k+1][j][i]);
 #ifdef ADIABATIC
-          pGrid->U[k][j][i].E += 0.5*(SQR(pGrid->U[k][j][i].B1c)
-               + SQR(pGrid->U[k][j][i].B2c) + SQR(pGrid->U[k][j][i].B3c));
+          GRID_U(pGrid,k,j,i,E) += 0.5*(SQR(GRID_U(pGrid,k,j,i,B1c))
+               + SQR(GRID_U(pGrid,k,j,i,B2c)) + SQR(GRID_U(pGrid,k,j,i,B3c)));
 #endif
         }
       }
@@ -528,7 +528,7 @@ void Userwork_in_loop(MeshS *pM)
         for (k=ks; k<=ke; k++) {
           for (j=js; j<=je; j++) {
             for (i=is; i<=ie; i++) {
-              pGrid->U[k][j][i].d = MAX(pGrid->U[k][j][i].d,D_FLOOR);
+              GRID_U(pGrid,k,j,i,d) = MAX(GRID_U(pGrid,k,j,i,d),D_FLOOR);
             }
           }
         }
@@ -706,9 +706,9 @@ static void strat_ix3(GridS *pG)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         pG->B1i[ks-k][j][i] = pG->B1i[ks][j][i];
-        pG->U[ks-k][j][i].B1c = pG->U[ks][j][i].B1c;
+        GRID_U(pG,ks-k,j,i,B1c) = GRID_U(pG,ks,j,i,B1c);
         pG->B2i[ks-k][j][i] = pG->B2i[ks][j][i];
-        pG->U[ks-k][j][i].B2c = pG->U[ks][j][i].B2c;
+        GRID_U(pG,ks-k,j,i,B2c) = GRID_U(pG,ks,j,i,B2c);
         pG->B3i[ks-k][j][i] = pG->B3i[ks][j][i];
       }
     }
@@ -717,7 +717,7 @@ static void strat_ix3(GridS *pG)
   for (k=1; k<=nghost; k++) {
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
-        pG->U[ks-k][j][i].B3c = 0.5*(pG->B3i[ks-k+1][j][i]+pG->B3i[ks-k][j][i]);
+        GRID_U(pG,ks-k,j,i,B3c) = 0.5*(pG->B3i[ks-k+1][j][i]+pG->B3i[ks-k][j][i]);
       }
     }
   }
@@ -729,39 +729,39 @@ static void strat_ix3(GridS *pG)
         cc_pos(pG,i,j,ks-k,&x1,&x2,&x3);
 /* First calculate the effective gas temperature in the last physical zone */
 #ifdef ADIABATIC
-        pressks = pG->U[ks][j][i].E - 0.5*(SQR(pG->U[ks][j][i].M1)
-                      + SQR(pG->U[ks][j][i].M2)
-                      + SQR(pG->U[ks][j][i].M3))/pG->U[ks][j][i].d;
+        pressks = GRID_U(pG,ks,j,i,E) - 0.5*(SQR(GRID_U(pG,ks,j,i,M1))
+                      + SQR(GRID_U(pG,ks,j,i,M2))
+                      + SQR(GRID_U(pG,ks,j,i,M3)))/GRID_U(pG,ks,j,i,d);
 #ifdef MHD
-        pressks -= 0.5*(SQR(pG->U[ks][j][i].B1c)
-                      + SQR(pG->U[ks][j][i].B2c)
-                      + SQR(pG->U[ks][j][i].B3c));
+        pressks -= 0.5*(SQR(GRID_U(pG,ks,j,i,B1c))
+                      + SQR(GRID_U(pG,ks,j,i,B2c))
+                      + SQR(GRID_U(pG,ks,j,i,B3c)));
 #endif /* MHD */
         pressks *= Gamma_1;
         pressks = MAX(pressks,TINY_NUMBER);
-        Tks = pressks/pG->U[ks][j][i].d;
+        Tks = pressks/GRID_U(pG,ks,j,i,d);
 #else
         Tks = 0.5*Omega_0*Omega_0;
 #endif /* ADIABATIC */
 /* Now extrapolate the density to balance gravity assuming a constant temperature in the ghost zones */
-        pG->U[ks-k][j][i].d = pG->U[ks][j][i].d*exp(-(x3*x3-x3b*x3b)/(2.0*Tks/(Omega_0*Omega_0)));
+        GRID_U(pG,ks-k,j,i,d) = GRID_U(pG,ks,j,i,d)*exp(-(x3*x3-x3b*x3b)/(2.0*Tks/(Omega_0*Omega_0)));
 /* Copy the velocities, but not the momenta --- important because of the density extrapolation above */
-        pG->U[ks-k][j][i].M1 = pG->U[ks][j][i].M1/pG->U[ks][j][i].d*pG->U[ks-k][j][i].d;
-        pG->U[ks-k][j][i].M2 = pG->U[ks][j][i].M2/pG->U[ks][j][i].d*pG->U[ks-k][j][i].d;
+        GRID_U(pG,ks-k,j,i,M1) = GRID_U(pG,ks,j,i,M1)/GRID_U(pG,ks,j,i,d)*GRID_U(pG,ks-k,j,i,d);
+        GRID_U(pG,ks-k,j,i,M2) = GRID_U(pG,ks,j,i,M2)/GRID_U(pG,ks,j,i,d)*GRID_U(pG,ks-k,j,i,d);
 /* If there's inflow into the grid, set the normal velocity to zero */
-        if (pG->U[ks][j][i].M3 >= 0.0) {
-          pG->U[ks-k][j][i].M3 = 0.0;
+        if (GRID_U(pG,ks,j,i,M3) >= 0.0) {
+          GRID_U(pG,ks-k,j,i,M3) = 0.0;
         } else {
-          pG->U[ks-k][j][i].M3 = pG->U[ks][j][i].M3/pG->U[ks][j][i].d*pG->U[ks-k][j][i].d;
+          GRID_U(pG,ks-k,j,i,M3) = GRID_U(pG,ks,j,i,M3)/GRID_U(pG,ks,j,i,d)*GRID_U(pG,ks-k,j,i,d);
         }
 #ifdef ADIABATIC
-        press = pG->U[ks-k][j][i].d*Tks;
-        pG->U[ks-k][j][i].E = press/Gamma_1
-        + 0.5*(SQR(pG->U[ks-k][j][i].M1) + SQR(pG->U[ks-k][j][i].M2)
-             + SQR(pG->U[ks-k][j][i].M3))/pG->U[ks-k][j][i].d;
+        press = GRID_U(pG,ks-k,j,i,d)*Tks;
+        GRID_U(pG,ks-k,j,i,E) = press/Gamma_1
+        + 0.5*(SQR(GRID_U(pG,ks-k,j,i,M1)) + SQR(GRID_U(pG,ks-k,j,i,M2))
+             + SQR(GRID_U(pG,ks-k,j,i,M3)))/GRID_U(pG,ks-k,j,i,d);
 #ifdef MHD
-       pG->U[ks-k][j][i].E += 0.5*(SQR(pG->U[ks-k][j][i].B1c)
-         + SQR(pG->U[ks-k][j][i].B2c) + SQR(pG->U[ks-k][j][i].B3c));
+       GRID_U(pG,ks-k,j,i,E) += 0.5*(SQR(GRID_U(pG,ks-k,j,i,B1c))
+         + SQR(GRID_U(pG,ks-k,j,i,B2c)) + SQR(GRID_U(pG,ks-k,j,i,B3c)));
 #endif /* MHD */
 #endif /* ADIABATIC */
       }
@@ -817,9 +817,9 @@ static void strat_ox3(GridS *pG)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         pG->B1i[ke+k][j][i] = pG->B1i[ke][j][i];
-        pG->U[ke+k][j][i].B1c = pG->U[ke][j][i].B1c;
+        GRID_U(pG,ke+k,j,i,B1c) = GRID_U(pG,ke,j,i,B1c);
         pG->B2i[ke+k][j][i] = pG->B2i[ke][j][i];
-        pG->U[ke+k][j][i].B2c = pG->U[ke][j][i].B2c;
+        GRID_U(pG,ke+k,j,i,B2c) = GRID_U(pG,ke,j,i,B2c);
 /* ke+1 interface field is already handled via CT */
         if (k > 1) {pG->B3i[ke+k][j][i] = pG->B3i[ke+1][j][i];}
       }
@@ -830,9 +830,9 @@ static void strat_ox3(GridS *pG)
     for (j=jl; j<=ju; j++) {
       for (i=il; i<=iu; i++) {
         if (k != nghost) {
-          pG->U[ke+k][j][i].B3c = 0.5*(pG->B3i[ke+k+1][j][i]+pG->B3i[ke+k][j][i]);
+          GRID_U(pG,ke+k,j,i,B3c) = 0.5*(pG->B3i[ke+k+1][j][i]+pG->B3i[ke+k][j][i]);
         } else {
-          pG->U[ke+k][j][i].B3c = pG->B3i[ke+k][j][i];
+          GRID_U(pG,ke+k,j,i,B3c) = pG->B3i[ke+k][j][i];
         }
       }
     }  
@@ -844,39 +844,39 @@ static void strat_ox3(GridS *pG)
       for (i=il; i<=iu; i++) {
         cc_pos(pG,i,j,ke+k,&x1,&x2,&x3);
 #ifdef ADIABATIC
-        presske = pG->U[ke][j][i].E - 0.5*(SQR(pG->U[ke][j][i].M1)
-                      + SQR(pG->U[ke][j][i].M2)
-                      + SQR(pG->U[ke][j][i].M3))/pG->U[ke][j][i].d;
+        presske = GRID_U(pG,ke,j,i,E) - 0.5*(SQR(GRID_U(pG,ke,j,i,M1))
+                      + SQR(GRID_U(pG,ke,j,i,M2))
+                      + SQR(GRID_U(pG,ke,j,i,M3)))/GRID_U(pG,ke,j,i,d);
 #ifdef MHD
-        presske -= 0.5*(SQR(pG->U[ke][j][i].B1c)
-                      + SQR(pG->U[ke][j][i].B2c)
-                      + SQR(pG->U[ke][j][i].B3c));
+        presske -= 0.5*(SQR(GRID_U(pG,ke,j,i,B1c))
+                      + SQR(GRID_U(pG,ke,j,i,B2c))
+                      + SQR(GRID_U(pG,ke,j,i,B3c)));
 #endif /* MHD */
         presske *= Gamma_1;
         presske = MAX(presske,TINY_NUMBER);
-        Tke = presske/pG->U[ke][j][i].d;
+        Tke = presske/GRID_U(pG,ke,j,i,d);
 #else
         Tke = 0.5*Omega_0*Omega_0;
 #endif /* ADIABATIC */
 /* Now extrapolate the density to balance gravity assuming a constant temperature in the ghost zones */
-        pG->U[ke+k][j][i].d = pG->U[ke][j][i].d*exp(-(x3*x3-x3t*x3t)/(2.0*Tke/(Omega_0*Omega_0)));
+        GRID_U(pG,ke+k,j,i,d) = GRID_U(pG,ke,j,i,d)*exp(-(x3*x3-x3t*x3t)/(2.0*Tke/(Omega_0*Omega_0)));
 /* Copy the velocities, but not the momenta --- important because of the density extrapolation above */
-        pG->U[ke+k][j][i].M1 = pG->U[ke][j][i].M1/pG->U[ke][j][i].d*pG->U[ke+k][j][i].d;
-        pG->U[ke+k][j][i].M2 = pG->U[ke][j][i].M2/pG->U[ke][j][i].d*pG->U[ke+k][j][i].d;
+        GRID_U(pG,ke+k,j,i,M1) = GRID_U(pG,ke,j,i,M1)/GRID_U(pG,ke,j,i,d)*GRID_U(pG,ke+k,j,i,d);
+        GRID_U(pG,ke+k,j,i,M2) = GRID_U(pG,ke,j,i,M2)/GRID_U(pG,ke,j,i,d)*GRID_U(pG,ke+k,j,i,d);
 /* If there's inflow into the grid, set the normal velocity to zero */
-        if (pG->U[ke][j][i].M3 <= 0.0) {
-          pG->U[ke+k][j][i].M3 = 0.0;
+        if (GRID_U(pG,ke,j,i,M3) <= 0.0) {
+          GRID_U(pG,ke+k,j,i,M3) = 0.0;
         } else {
-          pG->U[ke+k][j][i].M3 = pG->U[ke][j][i].M3/pG->U[ke][j][i].d*pG->U[ke+k][j][i].d;
+          GRID_U(pG,ke+k,j,i,M3) = GRID_U(pG,ke,j,i,M3)/GRID_U(pG,ke,j,i,d)*GRID_U(pG,ke+k,j,i,d);
         }
 #ifdef ADIABATIC
-        press = pG->U[ke+k][j][i].d*Tke;
-        pG->U[ke+k][j][i].E = press/Gamma_1
-        + 0.5*(SQR(pG->U[ke+k][j][i].M1) + SQR(pG->U[ke+k][j][i].M2)
-             + SQR(pG->U[ke+k][j][i].M3))/pG->U[ke+k][j][i].d;
+        press = GRID_U(pG,ke+k,j,i,d)*Tke;
+        GRID_U(pG,ke+k,j,i,E) = press/Gamma_1
+        + 0.5*(SQR(GRID_U(pG,ke+k,j,i,M1)) + SQR(GRID_U(pG,ke+k,j,i,M2))
+             + SQR(GRID_U(pG,ke+k,j,i,M3)))/GRID_U(pG,ke+k,j,i,d);
 #ifdef MHD
-       pG->U[ke+k][j][i].E += 0.5*(SQR(pG->U[ke+k][j][i].B1c)
-         + SQR(pG->U[ke+k][j][i].B2c) + SQR(pG->U[ke+k][j][i].B3c));
+       GRID_U(pG,ke+k,j,i,E) += 0.5*(SQR(GRID_U(pG,ke+k,j,i,B1c))
+         + SQR(GRID_U(pG,ke+k,j,i,B2c)) + SQR(GRID_U(pG,ke+k,j,i,B3c)));
 #endif /* MHD */
 #endif /* ADIABATIC */
       }
@@ -897,9 +897,9 @@ static Real expr_dV2(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 #else
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -913,12 +913,12 @@ static Real expr_beta(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3,B2;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef MHD
-  B2=pG->U[k][j][i].B1c*pG->U[k][j][i].B1c;
-  B2+=pG->U[k][j][i].B2c*pG->U[k][j][i].B2c;
-  B2+=pG->U[k][j][i].B3c*pG->U[k][j][i].B3c;
+  B2=GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c);
+  B2+=GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c);
+  B2+=GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,B3c);
 
 #ifdef ISOTHERMAL
-  return (2.0*Iso_csound2*pG->U[k][j][i].d/B2);
+  return (2.0*Iso_csound2*GRID_U(pG,k,j,i,d)/B2);
 #else
   return 0.0;
 #endif
@@ -938,9 +938,9 @@ static Real expr_ME(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3,B2;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef MHD
-  B2=pG->U[k][j][i].B1c*pG->U[k][j][i].B1c;
-  B2+=pG->U[k][j][i].B2c*pG->U[k][j][i].B2c;
-  B2+=pG->U[k][j][i].B3c*pG->U[k][j][i].B3c;
+  B2=GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B1c);
+  B2+=GRID_U(pG,k,j,i,B2c)*GRID_U(pG,k,j,i,B2c);
+  B2+=GRID_U(pG,k,j,i,B3c)*GRID_U(pG,k,j,i,B3c);
   return (B2/2.0);
 #else
   return NULL;
@@ -956,14 +956,14 @@ static Real expr_KE(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3,Vy,Vx,Vz;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  Vy = (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  Vy = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 #else
-  Vy = (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  Vy = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
-  Vx = pG->U[k][j][i].M1/pG->U[k][j][i].d;
-  Vz = pG->U[k][j][i].M3/pG->U[k][j][i].d;
+  Vx = GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d);
+  Vz = GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d);
 
-  return pG->U[k][j][i].d*(Vx*Vx + Vy*Vy + Vz*Vz)/2.0;
+  return GRID_U(pG,k,j,i,d)*(Vx*Vx + Vy*Vy + Vz*Vz)/2.0;
 
 }
 
@@ -981,10 +981,10 @@ static Real hst_rho_Vx_dVy(const GridS *pG,const int i,const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M1*(pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  return GRID_U(pG,k,j,i,M1)*(GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 #else
-  return pG->U[k][j][i].M1*
-    (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  return GRID_U(pG,k,j,i,M1)*
+    (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
 }
 
@@ -996,11 +996,11 @@ static Real hst_rho_dVy2(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3,dVy;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d);
+  dVy = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d));
 #else
-  dVy = (pG->U[k][j][i].M2/pG->U[k][j][i].d + qshear*Omega_0*x1);
+  dVy = (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) + qshear*Omega_0*x1);
 #endif
-  return pG->U[k][j][i].d*dVy*dVy;
+  return GRID_U(pG,k,j,i,d)*dVy*dVy;
 }
 
 #ifdef ADIABATIC
@@ -1013,7 +1013,7 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
   phi = UnstratifiedDisk(x1, x2, x3);
 
-  return pG->U[k][j][i].E + pG->U[k][j][i].d*phi;
+  return GRID_U(pG,k,j,i,E) + GRID_U(pG,k,j,i,d)*phi;
 }
 #endif /* ADIABATIC */
 
@@ -1027,14 +1027,14 @@ static Real hst_E_total(const GridS *pG, const int i, const int j, const int k)
  *  \brief x-component of magnetic field */
 static Real hst_Bx(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B1c;
+  return GRID_U(pG,k,j,i,B1c);
 }
 
 /*! \fn static Real hst_By(const GridS *pG,const int i,const int j,const int k) 
  *  \brief y-component of magnetic field */
 static Real hst_By(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B2c;
+  return GRID_U(pG,k,j,i,B2c);
 }
 
 /*! \fn static Real hst_Bz(const GridS *pG, const int i, const int j, 
@@ -1042,7 +1042,7 @@ static Real hst_By(const GridS *pG, const int i, const int j, const int k)
  *  \brief z-component of magnetic field */
 static Real hst_Bz(const GridS *pG, const int i, const int j, const int k)
 {
-  return pG->U[k][j][i].B3c;
+  return GRID_U(pG,k,j,i,B3c);
 }
 
 /*! \fn static Real hst_BxBy(const GridS *pG, const int i, const int j, 
@@ -1050,7 +1050,7 @@ static Real hst_Bz(const GridS *pG, const int i, const int j, const int k)
  *  \brief Maxwell stress */
 static Real hst_BxBy(const GridS *pG, const int i, const int j, const int k)
 {
-  return -pG->U[k][j][i].B1c*pG->U[k][j][i].B2c;
+  return -GRID_U(pG,k,j,i,B1c)*GRID_U(pG,k,j,i,B2c);
 }
 #endif /* MHD */
 
@@ -1158,12 +1158,12 @@ static void output_1d(MeshS *pM, OutputS *pOut)
     for (j=js; j<=je; j++) {
       for (i=is; i<=ie; i++) {
         i1d=0;
-        out1d[kg][i1d] += pGrid->U[k][j][i].d;
+        out1d[kg][i1d] += GRID_U(pGrid,k,j,i,d);
         i1d++;
 #ifdef ISOTHERMAL
-        out1d[kg][i1d] += pGrid->U[k][j][i].d*Iso_csound2;
+        out1d[kg][i1d] += GRID_U(pGrid,k,j,i,d)*Iso_csound2;
 #else
-        press           = MAX(Gamma_1*(pGrid->U[k][j][i].E - expr_KE(pGrid,i,j,k)
+        press           = MAX(Gamma_1*(GRID_U(pGrid,k,j,i,E) - expr_KE(pGrid,i,j,k)
 #ifdef MHD
                                  - expr_ME(pGrid,i,j,k)
 #endif
@@ -1172,34 +1172,34 @@ static void output_1d(MeshS *pM, OutputS *pOut)
 #endif
 #ifdef ADIABATIC
         i1d++;
-        out1d[kg][i1d] += press/(Gamma_1*pGrid->U[k][j][i].d);
+        out1d[kg][i1d] += press/(Gamma_1*GRID_U(pGrid,k,j,i,d));
         i1d++;
-        out1d[kg][i1d] += pGrid->U[k][j][i].E;
+        out1d[kg][i1d] += GRID_U(pGrid,k,j,i,E);
         i1d++;
         out1d[kg][i1d] += hst_E_total(pGrid,i,j,k);
 #endif
         i1d++;
-        out1d[kg][i1d] += 0.5*SQR(pGrid->U[k][j][i].M1)/pGrid->U[k][j][i].d;
+        out1d[kg][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,M1))/GRID_U(pGrid,k,j,i,d);
         i1d++;
         cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-        out1d[kg][i1d] += 0.5*SQR(pGrid->U[k][j][i].M2)/pGrid->U[k][j][i].d;
+        out1d[kg][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,M2))/GRID_U(pGrid,k,j,i,d);
 #else
-        out1d[kg][i1d] += 0.5*pGrid->U[k][j][i].d*SQR(pGrid->U[k][j][i].M2/pGrid->U[k][j][i].d + qshear*Omega_0*x1);
+        out1d[kg][i1d] += 0.5*GRID_U(pGrid,k,j,i,d)*SQR(GRID_U(pGrid,k,j,i,M2)/GRID_U(pGrid,k,j,i,d) + qshear*Omega_0*x1);
 #endif
         i1d++;
-        out1d[kg][i1d] += 0.5*SQR(pGrid->U[k][j][i].M3)/pGrid->U[k][j][i].d;
+        out1d[kg][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,M3))/GRID_U(pGrid,k,j,i,d);
         i1d++;
         out1d[kg][i1d] += expr_KE(pGrid,i,j,k);
         i1d++;
         out1d[kg][i1d] += hst_rho_Vx_dVy(pGrid,i,j,k);
 #ifdef MHD
         i1d++;
-        out1d[kg][i1d] += 0.5*SQR(pGrid->U[k][j][i].B1c);
+        out1d[kg][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,B1c));
         i1d++;
-        out1d[kg][i1d] += 0.5*SQR(pGrid->U[k][j][i].B2c);
+        out1d[kg][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,B2c));
         i1d++;
-        out1d[kg][i1d] += 0.5*SQR(pGrid->U[k][j][i].B3c);
+        out1d[kg][i1d] += 0.5*SQR(GRID_U(pGrid,k,j,i,B3c));
         i1d++;
         out1d[kg][i1d] += expr_ME(pGrid,i,j,k);
         i1d++;
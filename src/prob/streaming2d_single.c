@@ -348,14 +348,14 @@ void problem(DomainS *pDomain)
       rhog = rho0;  u1 = u2 = u3 = 0.0;
     }
 
-    pGrid->U[pGrid->ks][j][i].d = rhog;
+    GRID_U(pGrid,pGrid->ks,j,i,d) = rhog;
 
-    pGrid->U[pGrid->ks][j][i].M1 = rhog * (uxNSH+u1);
-    pGrid->U[pGrid->ks][j][i].M3 = rhog * (uyNSH+u3);
+    GRID_U(pGrid,pGrid->ks,j,i,M1) = rhog * (uxNSH+u1);
+    GRID_U(pGrid,pGrid->ks,j,i,M3) = rhog * (uyNSH+u3);
 
-    pGrid->U[pGrid->ks][j][i].M2 = rhog * u2;
+    GRID_U(pGrid,pGrid->ks,j,i,M2) = rhog * u2;
 #ifndef FARGO
-    pGrid->U[pGrid->ks][j][i].M3 -= qshear*rhog*Omega_0*x1;
+    GRID_U(pGrid,pGrid->ks,j,i,M3) -= qshear*rhog*Omega_0*x1;
 #endif
 
   }}
@@ -530,7 +530,7 @@ static Real expr_rhodif(const GridS *pG, const int i, const int j, const int k)
 {
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  return pG->U[k][j][i].d - rho0;
+  return GRID_U(pG,k,j,i,d) - rho0;
 }
 
 /* dVx */
@@ -538,7 +538,7 @@ static Real expr_dVx(const GridS *pG, const int i, const int j, const int k)
 {
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  return pG->U[k][j][i].M1/pG->U[k][j][i].d - uxNSH;
+  return GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d) - uxNSH;
 }
 
 /* dVy */
@@ -547,9 +547,9 @@ static Real expr_dVy(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M3/pG->U[k][j][i].d - uyNSH;
+  return GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d) - uyNSH;
 #else
-  return (pG->U[k][j][i].M3/pG->U[k][j][i].d -uyNSH + qshear*Omega_0*x1);
+  return (GRID_U(pG,k,j,i,M3)/GRID_U(pG,k,j,i,d) -uyNSH + qshear*Omega_0*x1);
 #endif
 }
 
@@ -276,14 +276,14 @@ void problem(DomainS *pDomain)
       rhog = rho0;  u1 = u2 = u3 = 0.0;
     }
 
-    pGrid->U[k][j][i].d = rhog;
+    GRID_U(pGrid,k,j,i,d) = rhog;
 
-    pGrid->U[k][j][i].M1 = rhog * (uxNSH+u1);
-    pGrid->U[k][j][i].M2 = rhog * (uyNSH+u2);
+    GRID_U(pGrid,k,j,i,M1) = rhog * (uxNSH+u1);
+    GRID_U(pGrid,k,j,i,M2) = rhog * (uyNSH+u2);
 
-    pGrid->U[k][j][i].M3 = rhog * u3;
+    GRID_U(pGrid,k,j,i,M3) = rhog * u3;
 #ifndef FARGO
-    pGrid->U[k][j][i].M2 -= qshear*rhog*Omega_0*x1;
+    GRID_U(pGrid,k,j,i,M2) -= qshear*rhog*Omega_0*x1;
 #endif
 
   }}}
@@ -467,7 +467,7 @@ static Real expr_rhodif(const GridS *pG, const int i, const int j, const int k)
 {
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  return pG->U[k][j][i].d - rho0;
+  return GRID_U(pG,k,j,i,d) - rho0;
 }
 
 /*! \fn static Real expr_dVx(const GridS *pG, const int i, const int j, 
@@ -477,7 +477,7 @@ static Real expr_dVx(const GridS *pG, const int i, const int j, const int k)
 {
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  return pG->U[k][j][i].M1/pG->U[k][j][i].d - uxNSH;
+  return GRID_U(pG,k,j,i,M1)/GRID_U(pG,k,j,i,d) - uxNSH;
 }
 
 /*! \fn static Real expr_dVy(const GridS *pG, const int i, const int j, 
@@ -488,9 +488,9 @@ static Real expr_dVy(const GridS *pG, const int i, const int j, const int k)
   Real x1,x2,x3;
   cc_pos(pG,i,j,k,&x1,&x2,&x3);
 #ifdef FARGO
-  return pG->U[k][j][i].M2/pG->U[k][j][i].d - uyNSH;
+  return GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) - uyNSH;
 #else
-  return (pG->U[k][j][i].M2/pG->U[k][j][i].d -uyNSH + qshear*Omega_0*x1);
+  return (GRID_U(pG,k,j,i,M2)/GRID_U(pG,k,j,i,d) -uyNSH + qshear*Omega_0*x1);
 #endif
 }
 
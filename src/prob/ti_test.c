@@ -93,15 +93,15 @@ void problem(DomainS *pDomain)
     for (i=is; i<=ie; i++) {
       cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
 
-      if(iprob == 1) pGrid->U[k][j][i].d = n0*(1+amp*sin(kwx*x1));
-      if(iprob == 2) pGrid->U[k][j][i].d = n0*(1+amp*(ran2(&iseed)-0.5));
-      pGrid->U[k][j][i].M1 = 0.0;
-      pGrid->U[k][j][i].M2 = 0.0;
-      pGrid->U[k][j][i].M3 = 0.0;
+      if(iprob == 1) GRID_U(pGrid,k,j,i,d) = n0*(1+amp*sin(kwx*x1));
+      if(iprob == 2) GRID_U(pGrid,k,j,i,d) = n0*(1+amp*(ran2(&iseed)-0.5));
+      GRID_U(pGrid,k,j,i,M1) = 0.0;
+      GRID_U(pGrid,k,j,i,M2) = 0.0;
+      GRID_U(pGrid,k,j,i,M3) = 0.0;
 #ifndef BAROTROPIC
-      pGrid->U[k][j][i].E = P0/Gamma_1
-             + 0.5*(SQR(pGrid->U[k][j][i].M1) + SQR(pGrid->U[k][j][i].M2)
-             + SQR(pGrid->U[k][j][i].M3))/pGrid->U[k][j][i].d;
+      GRID_U(pGrid,k,j,i,E) = P0/Gamma_1
+             + 0.5*(SQR(GRID_U(pGrid,k,j,i,M1)) + SQR(GRID_U(pGrid,k,j,i,M2))
+             + SQR(GRID_U(pGrid,k,j,i,M3)))/GRID_U(pGrid,k,j,i,d);
 #endif
     }
   }}
@@ -130,7 +130,7 @@ void problem_read_restart(MeshS *pM, FILE *fp)
 
 static Real logd(const GridS *pG, const int i, const int j, const int k)
 {
-  return log10(pG->U[k][j][i].d);
+  return log10(GRID_U(pG,k,j,i,d));
 }
 
 
@@ -49,18 +49,18 @@ void problem(DomainS *pDomain)
 /* Calculate the cell center position of the cell i,j,k */
 	  cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
 
-	  pGrid->U[k][j][i].d = 1.0;
-	  pGrid->U[k][j][i].M1 = 0.0;
-	  pGrid->U[k][j][i].M2 = 0.0;
-	  pGrid->U[k][j][i].M3 = 0.0;
+	  GRID_U(pGrid,k,j,i,d) = 1.0;
+	  GRID_U(pGrid,k,j,i,M1) = 0.0;
+	  GRID_U(pGrid,k,j,i,M2) = 0.0;
+	  GRID_U(pGrid,k,j,i,M3) = 0.0;
 	  if (x1 < 0.1) {
-	    pGrid->U[k][j][i].E = 1.0e3/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 1.0e3/Gamma_1 ;
 	  }
 	  else if (x1 > 0.9) {
-	    pGrid->U[k][j][i].E = 1.0e2/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 1.0e2/Gamma_1 ;
 	  }
 	  else {
-	    pGrid->U[k][j][i].E = 0.01/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 0.01/Gamma_1 ;
 	  }
 	}
       }
@@ -74,18 +74,18 @@ void problem(DomainS *pDomain)
 /* Calculate the cell center position of the cell i,j,k */
 	  cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
 
-	  pGrid->U[k][j][i].d = 1.0;
-	  pGrid->U[k][j][i].M1 = 0.0;
-	  pGrid->U[k][j][i].M2 = 0.0;
-	  pGrid->U[k][j][i].M3 = 0.0;
+	  GRID_U(pGrid,k,j,i,d) = 1.0;
+	  GRID_U(pGrid,k,j,i,M1) = 0.0;
+	  GRID_U(pGrid,k,j,i,M2) = 0.0;
+	  GRID_U(pGrid,k,j,i,M3) = 0.0;
 	  if (x2 < 0.1) {
-	    pGrid->U[k][j][i].E = 1.0e3/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 1.0e3/Gamma_1 ;
 	  }
 	  else if (x2 > 0.9) {
-	    pGrid->U[k][j][i].E = 1.0e2/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 1.0e2/Gamma_1 ;
 	  }
 	  else {
-	    pGrid->U[k][j][i].E = 0.01/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 0.01/Gamma_1 ;
 	  }
 	}
       }
@@ -99,18 +99,18 @@ void problem(DomainS *pDomain)
 /* Calculate the cell center position of the cell i,j,k */
 	  cc_pos(pGrid,i,j,k,&x1,&x2,&x3);
 
-	  pGrid->U[k][j][i].d = 1.0;
-	  pGrid->U[k][j][i].M1 = 0.0;
-	  pGrid->U[k][j][i].M2 = 0.0;
-	  pGrid->U[k][j][i].M3 = 0.0;
+	  GRID_U(pGrid,k,j,i,d) = 1.0;
+	  GRID_U(pGrid,k,j,i,M1) = 0.0;
+	  GRID_U(pGrid,k,j,i,M2) = 0.0;
+	  GRID_U(pGrid,k,j,i,M3) = 0.0;
 	  if (x3 < 0.1) {
-	    pGrid->U[k][j][i].E = 1.0e3/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 1.0e3/Gamma_1 ;
 	  }
 	  else if (x3 > 0.9) {
-	    pGrid->U[k][j][i].E = 1.0e2/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 1.0e2/Gamma_1 ;
 	  }
 	  else {
-	    pGrid->U[k][j][i].E = 0.01/Gamma_1 ;
+	    GRID_U(pGrid,k,j,i,E) = 0.01/Gamma_1 ;
 	  }
 	}
       }
@@ -27,11 +27,19 @@
 /* main.c */
 int athena_main(int argc, char *argv[]);
 
+/*----------------------------------------------------------------------------*/
+/* amr.c */
+#ifdef ADAPTIVE_MESH_REFINEMENT
+void AMR_init(MeshS *pM);
+int AMR_regrid(MeshS *pM);
+#endif /* ADAPTIVE_MESH_REFINEMENT */
+
 /*----------------------------------------------------------------------------*/
 /* ath_array.c */
 void*   calloc_1d_array(                      size_t nc, size_t size);
 void**  calloc_2d_array(           size_t nr, size_t nc, size_t size);
 void*** calloc_3d_array(size_t nt, size_t nr, size_t nc, size_t size);
+void*** calloc_3d_array_aligned(size_t nt, size_t nr, size_t nc, size_t size);
 void free_1d_array(void *array);
 void free_2d_array(void *array);
 void free_3d_array(void *array);
@@ -68,8 +76,13 @@ void baton_stop(const int Nb, const int tag);
 /*----------------------------------------------------------------------------*/
 /* bvals_mhd.c  */
 void bvals_mhd_init(MeshS *pM);
+void bvals_mhd_destruct(MeshS *pM);
 void bvals_mhd_fun(DomainS *pD, enum BCDirection dir, VGFun_t prob_bc);
 void bvals_mhd(DomainS *pDomain);
+#ifdef ASYNC_BVALS
+void bvals_mhd_start(DomainS *pD);
+void bvals_mhd_finish(DomainS *pD);
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* bvals_shear.c  */
@@ -125,6 +138,17 @@ int cellk(const GridS *pG, const Real z, const Real dx3_1, int *k, Real *c);
 Real x3cc(const GridS *pG, const int k);
 #endif
 
+/*----------------------------------------------------------------------------*/
+/* compress.c */
+ZFileS *ath_zopen(FILE *fp, const OutputS *pOut);
+int ath_zprintf(ZFileS *zf, const char *fmt, ...);
+size_t ath_zwrite(const void *ptr, size_t size, size_t n, ZFileS *zf);
+void ath_zlossy(ZFileS *zf, void *data, size_t size, int n);
+void ath_zclose(ZFileS *zf);
+#ifdef COMPRESSION
+FILE *ath_zunpack(FILE *fp, char **image);
+#endif
+
 /*----------------------------------------------------------------------------*/
 /* convert_var.c */
 PrimS Cons_to_Prim(const ConsS *pU);
@@ -148,15 +172,32 @@ Prim1DS check_Prim1D (const Cons1DS *pU, const Real *pBx);
 /*----------------------------------------------------------------------------*/
 /* init_grid.c */
 void init_grid(MeshS *pM);
+void init_grid_domain(MeshS *pM, DomainS *pD);
+#ifdef STATIC_MESH_REFINEMENT
+void init_grid_overlaps(MeshS *pM);
+void free_grid_overlaps(GridS *pG);
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* init_mesh.c */
 void init_mesh(MeshS *pM);
+void divide_domain(DomainS *pD);
 void get_myGridIndex(DomainS *pD, const int my_id, int *pi, int *pj, int *pk);
+#ifdef MPI_PARALLEL
+void init_comm_domain(DomainS *pD);
+#ifdef STATIC_MESH_REFINEMENT
+void init_comm_children(MeshS *pM);
+#endif
+void balance_grids(MeshS *pM, const int adaptive);
+#endif /* MPI_PARALLEL */
 
 /*----------------------------------------------------------------------------*/
 /* new_dt.c */
 void new_dt(MeshS *pM);
+#ifndef SPECIAL_RELATIVITY
+void new_dt_speeds(const GridS *pG, const int j, const int k,
+                   Real *pmax_v1, Real *pmax_v2, Real *pmax_v3);
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* output.c - and related files */
@@ -165,7 +206,13 @@ void data_output(MeshS *pM, const int flag);
 void add_rst_out(OutputS *new_out);
 void data_output_destruct(void);
 void dump_history_enroll(const ConsFun_t pfun, const char *label);
+void dump_history_enroll_row(const ConsRowFun_t pfun, const char *label);
+void dump_history_flush(void);
 Real ***OutData3(GridS *pGrid, OutputS *pOut, int *Nx1, int *Nx2, int *Nx3);
+void OutBounds3(GridS *pGrid, OutputS *pOut, int *il, int *iu, int *jl,
+                int *ju, int *kl, int *ku);
+void OutRow(GridS *pGrid, OutputS *pOut, const int il, const int iu,
+            const int j, const int k, Real *row);
 Real  **OutData2(GridS *pGrid, OutputS *pOut, int *Nx1, int *Nx2);
 Real   *OutData1(GridS *pGrid, OutputS *pOut, int *Nx1);
 
@@ -175,11 +222,22 @@ void output_ppm  (MeshS *pM, OutputS *pOut);
 void output_vtk  (MeshS *pM, OutputS *pOut);
 void output_tab  (MeshS *pM, OutputS *pOut);
 
+void init_insitu (MeshS *pM, char *block, OutputS *pOut);
+void output_slice(MeshS *pM, OutputS *pOut);
+void output_proj (MeshS *pM, OutputS *pOut);
+void output_prof (MeshS *pM, OutputS *pOut);
+#ifdef FFT_ENABLED
+void output_spec (MeshS *pM, OutputS *pOut);
+#endif
+
 void dump_binary  (MeshS *pM, OutputS *pOut);
 void dump_history (MeshS *pM, OutputS *pOut);
 void dump_tab_cons(MeshS *pM, OutputS *pOut);
 void dump_tab_prim(MeshS *pM, OutputS *pOut);
 void dump_vtk     (MeshS *pM, OutputS *pOut);
+#ifdef HDF5_OUTPUT
+void dump_hdf5    (MeshS *pM, OutputS *pOut);
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* par.c */
@@ -231,8 +289,53 @@ void get_eta_user(GridS *pG, int i, int j, int k,
 /*----------------------------------------------------------------------------*/
 /* restart.c  */
 void dump_restart(MeshS *pM, OutputS *pout);
+#ifdef ASYNC_RESTART
+void dump_restart_destruct(void);
+#endif
 void restart_grids(char *res_file, MeshS *pM);
 
+/*----------------------------------------------------------------------------*/
+/* restart_map.c */
+void ath_rstidx_add(RstIndexS *idx, FILE *fp, const char *name, const int nl,
+                    const int nd, const int elsize, const int n1, const int n2,
+                    const int n3);
+void ath_rstidx_write(RstIndexS *idx, FILE *fp);
+RstMapS *ath_rstmap_open(const char *fname);
+const void *ath_rstmap_field(const RstMapS *rm, const char *name, const int nl,
+                             const int nd, const RstFieldS **ppf);
+void ath_rstmap_close(RstMapS *rm);
+
+/*----------------------------------------------------------------------------*/
+/* runtime_solvers.c */
+#ifdef RUNTIME_SOLVERS
+void runtime_solvers_init(void);
+int runtime_ctu_integrator(void);
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* shared_file.c */
+#ifdef MPI_PARALLEL
+/*! \struct SFileS
+ *  \brief File for one Domain shared by all processes, see shared_file.c */
+typedef struct SFile_s{
+  MPI_File fh;          /*!< file opened by all processes in the Domain */
+  char *fname;          /*!< its name */
+  int root;             /*!< 1 on the process that writes the header data */
+  MPI_Offset pos;       /*!< offset of the end of the data written so far */
+  char *hdr;            /*!< text and header data not yet written */
+  size_t nhdr, caphdr;  /*!< bytes in hdr, and size of hdr */
+  int Nx[3];            /*!< number of cells in Domain */
+  int start[3],size[3]; /*!< first cell and number of cells of Grid in it */
+}SFileS;
+
+SFileS *ath_sfopen(MeshS *pM, const int nl, const int nd, const OutputS *pOut,
+                   const char *id, const char *ext);
+int ath_sfprintf(SFileS *sf, const char *fmt, ...);
+void ath_sfwrite(const void *ptr, size_t size, size_t n, SFileS *sf);
+void ath_sfwrite_grid(const void *data, const int cellsize, SFileS *sf);
+void ath_sfclose(SFileS *sf);
+#endif /* MPI_PARALLEL */
+
 /*----------------------------------------------------------------------------*/
 /* show_config.c */
 void show_config(void);
@@ -242,7 +345,38 @@ void show_config_par(void);
 /* smr.c */
 void RestrictCorrect(MeshS *pM);
 void Prolongate(MeshS *pM);
+#ifdef SMR_SUBCYCLE
+void SMR_advance(MeshS *pM, VDFun_t Integrate);
+#endif
 void SMR_init(MeshS *pM);
+void SMR_destruct(MeshS *pM);
+void ProCon(const ConsS Uim1,const ConsS Ui,  const ConsS Uip1,
+            const ConsS Ujm1,const ConsS Ujp1,
+            const ConsS Ukm1,const ConsS Ukp1, ConsS PCon[][2][2]);
+#ifdef MHD
+void ProFld(Real3Vect BGZ[][3][3], Real3Vect PFld[][3][3], 
+  const Real dx1c, const Real dx2c, const Real dx3c);
+#endif /* MHD */
+
+/*----------------------------------------------------------------------------*/
+/* timers.c */
+/* Phases of the main loop timed with PHASE_TIMERS.  TIMER_START() and
+ * TIMER_STOP() compile to nothing without it. */
+enum TimerPhase {TIMER_CYCLE, TIMER_OUTPUT, TIMER_COOLING, TIMER_DIFFUSION,
+                 TIMER_INTEGRATE, TIMER_PARTICLES, TIMER_SMR, TIMER_USERWORK,
+                 TIMER_SELFGRAV, TIMER_BVALS, TIMER_NEW_DT, NTIMERS};
+#ifdef PHASE_TIMERS
+void timers_init(MeshS *pM);
+void timer_start(const enum TimerPhase n);
+void timer_stop(const enum TimerPhase n);
+void timers_cycle(MeshS *pM);
+void timers_report(void);
+#define TIMER_START(n) timer_start(n)
+#define TIMER_STOP(n)  timer_stop(n)
+#else
+#define TIMER_START(n)
+#define TIMER_STOP(n)
+#endif /* PHASE_TIMERS */
 
 /*----------------------------------------------------------------------------*/
 /* units.c */
@@ -275,6 +409,13 @@ void minmax1(Real   *data, int nx1,                   Real *dmin, Real *dmax);
 void minmax2(Real  **data, int nx2, int nx1,          Real *dmin, Real *dmax);
 void minmax3(Real ***data, int nx3, int nx2, int nx1, Real *dmin, Real *dmax);
 void do_nothing_bc(GridS *pG);
+int calloc_grid_U(GridS *pG, int nx3, int nx2, int nx1);
+void free_grid_U(GridS *pG);
+#ifdef SOA_LAYOUT
+ConsS get_grid_cons(const GridS *pG, const int k, const int j, const int i);
+void set_grid_cons(GridS *pG, const int k, const int j, const int i,
+                   const ConsS U);
+#endif
 Real compute_div_b(GridS *pG);
 int sign_change(Real (*func)(const Real,const Real), const Real a0, const Real b0, const Real x, Real *a, Real *b);
 int bisection(Real (*func)(const Real,const Real), const Real a0, const Real b0, const Real x, Real *root);
@@ -53,6 +53,9 @@
 #define RLIM (0.1)
 
 static Real **pW=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(pW)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void lr_states(const GridS *pG, const Prim1DS W[], const Real Bxc[],
@@ -146,7 +149,7 @@ void lr_states(const GridS *pG __attribute((unused)),
 
 void lr_states_init(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd,n4v=4;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,nerr=0,n4v=4;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -170,12 +173,19 @@ void lr_states_init(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
-  if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) goto on_error;
+/* With OpenMP, each thread allocates its own copy of the work arrays */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel reduction(+:nerr)
+#endif
+  {
+    if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) nerr++;
+  }
 
-  return;
-  on_error:
+  if (nerr > 0) {
     lr_states_destruct();
     ath_error("[lr_states_init]: malloc returned a NULL pointer\n");
+  }
+  return;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -184,7 +194,12 @@ void lr_states_init(MeshS *pM)
 
 void lr_states_destruct(void)
 {
-  if (pW != NULL) free(pW);
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
+  {
+    if (pW != NULL) free(pW);
+  }
   return;
 }
 
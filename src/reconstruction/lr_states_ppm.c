@@ -49,6 +49,9 @@
 #endif /* VL_INTEGRATOR */
 
 static Real **pW=NULL, **dWm=NULL, **Wim1h=NULL;
+#ifdef OPENMP_PARALLEL
+#pragma omp threadprivate(pW,dWm,Wim1h)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*! \fn void lr_states(const GridS* pG, const Prim1DS W[], const Real Bxc[],
@@ -75,8 +78,10 @@ void lr_states(const GridS* pG __attribute__((unused)),
 {
   int i,n,m;
   Real lim_slope1,lim_slope2,qa,qb,qc,qx;
-  Real ev    [NWAVE],rem    [NWAVE][NWAVE],lem    [NWAVE][NWAVE];
-  Real ev_ip1[NWAVE],rem_ip1[NWAVE][NWAVE],lem_ip1[NWAVE][NWAVE];
+  Real ev_buf[2][NWAVE],rem_buf[2][NWAVE][NWAVE],lem_buf[2][NWAVE][NWAVE];
+  Real *ev=ev_buf[0], (*rem)[NWAVE]=rem_buf[0], (*lem)[NWAVE]=lem_buf[0];
+  Real *ev_ip1=ev_buf[1],(*rem_ip1)[NWAVE]=rem_buf[1],(*lem_ip1)[NWAVE]=lem_buf[1];
+  Real *ev_tmp, (*em_tmp)[NWAVE];
   Real dWc[NWAVE+NSCALARS],dWl[NWAVE+NSCALARS];
   Real dWr[NWAVE+NSCALARS],dWg[NWAVE+NSCALARS];
   Real dac[NWAVE+NSCALARS],dal[NWAVE+NSCALARS];
@@ -280,8 +285,8 @@ void lr_states(const GridS* pG __attribute__((unused)),
  *
  * At the start of the loop, rem and lem still store values at i=il-1 computed
  * at the end of Step 2.  For each i, the eigensystem at i+1 is stored in
- * rem_ip1 and lem_ip1.  At the end of the loop rem[lem] is then set to
- * rem_ip1[lem_ip1] in preparation for the next iteration.
+ * rem_ip1 and lem_ip1.  At the end of the loop the pointers rem[lem] and
+ * rem_ip1[lem_ip1] are swapped in preparation for the next iteration.
  */
 
 /*========================= START BIG LOOP OVER i =========================*/
@@ -663,15 +668,13 @@ void lr_states(const GridS* pG __attribute__((unused)),
 #endif /* CTU_INTEGRATOR */
 
 /*--- Step 20. -----------------------------------------------------------------
- * Save eigenvalues and eigenmatrices at i+1 for use in next iteration */
+ * Save eigenvalues and eigenmatrices at i+1 for use in next iteration by
+ * swapping pointers rather than copying.  The esys_prim_*() functions always
+ * write the same elements, so the zeros set above are never overwritten. */
 
-    for (m=0; m<NWAVE; m++) {
-      ev[m] = ev_ip1[m];
-      for (n=0; n<NWAVE; n++) {
-        rem[m][n] = rem_ip1[m][n];
-        lem[m][n] = lem_ip1[m][n];
-      }
-    }
+    ev_tmp = ev;  ev  = ev_ip1;  ev_ip1  = ev_tmp;
+    em_tmp = rem; rem = rem_ip1; rem_ip1 = em_tmp;
+    em_tmp = lem; lem = lem_ip1; lem_ip1 = em_tmp;
 
   } /*====================== END BIG LOOP OVER i =========================*/
 
@@ -685,7 +688,7 @@ void lr_states(const GridS* pG __attribute__((unused)),
 
 void lr_states_init(MeshS *pM)
 {
-  int nmax,size1=0,size2=0,size3=0,nl,nd;
+  int nmax,size1=0,size2=0,size3=0,nl,nd,nerr=0;
 
 /* Cycle over all Grids on this processor to find maximum Nx1, Nx2, Nx3 */
   for (nl=0; nl<(pM->NLevels); nl++){
@@ -709,18 +712,25 @@ void lr_states_init(MeshS *pM)
   size3 = size3 + 2*nghost;
   nmax = MAX((MAX(size1,size2)),size3);
 
-  if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) goto on_error;
+/* With OpenMP, each thread allocates its own copy of the work arrays */
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel reduction(+:nerr)
+#endif
+  {
+    if ((pW = (Real**)malloc(nmax*sizeof(Real*))) == NULL) nerr++;
 
-  if ((dWm = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
-    goto on_error;
+    if ((dWm = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
+      nerr++;
 
-  if ((Wim1h = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
-    goto on_error;
+    if ((Wim1h = (Real**)calloc_2d_array(nmax, (NWAVE + NSCALARS), sizeof(Real))) == NULL)
+      nerr++;
+  }
 
-  return;
-  on_error:
+  if (nerr > 0) {
     lr_states_destruct();
     ath_error("[lr_states_init]: malloc returned a NULL pointer\n");
+  }
+  return;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -729,9 +739,14 @@ void lr_states_init(MeshS *pM)
 
 void lr_states_destruct(void)
 {
-  if (pW != NULL) free(pW);
-  if (dWm != NULL) free_2d_array(dWm);
-  if (Wim1h != NULL) free_2d_array(Wim1h);
+#ifdef OPENMP_PARALLEL
+#pragma omp parallel
+#endif
+  {
+    if (pW != NULL) free(pW);
+    if (dWm != NULL) free_2d_array(dWm);
+    if (Wim1h != NULL) free_2d_array(Wim1h);
+  }
   return;
 }
 
@@ -38,11 +38,77 @@ void esys_prim_adb_mhd(const Real d, const Real v1, const Real rho_a2,
 #endif
 
 /*  All of the lr_states_*.c files in this directory contain the same function
- *  names below */
+ *  names below.  With RUNTIME_SOLVERS each is compiled once for every
+ *  integrator and type of flux it works with, with the names below renamed
+ *  (see Makefile.in), and everywhere else lr_states() calls the variant chosen
+ *  in runtime_solvers.c through a pointer. */
 void lr_states_destruct(void);
 void lr_states_init(MeshS *pM);
+#if defined(RUNTIME_SOLVERS) && !defined(RUNTIME_VARIANT)
+extern LRStatesFun_t lr_states;
+#else
 void lr_states(const GridS* pG, const Prim1DS W[], const Real Bxc[],
                const Real dt, const Real dx, const int is, const int ie,
                Prim1DS Wl[], Prim1DS Wr[], const int dir);
+#endif
+
+#ifdef RUNTIME_SOLVERS
+/* the variants of lr_states_*.c compiled with RUNTIME_SOLVERS */
+void lr_states_init_dc(MeshS *pM);
+void lr_states_destruct_dc(void);
+void lr_states_dc(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_plm_ctu(MeshS *pM);
+void lr_states_destruct_plm_ctu(void);
+void lr_states_plm_ctu(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_plm_ctu_hll(MeshS *pM);
+void lr_states_destruct_plm_ctu_hll(void);
+void lr_states_plm_ctu_hll(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_ppm_ctu(MeshS *pM);
+void lr_states_destruct_ppm_ctu(void);
+void lr_states_ppm_ctu(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_ppm_ctu_hll(MeshS *pM);
+void lr_states_destruct_ppm_ctu_hll(void);
+void lr_states_ppm_ctu_hll(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_prim2_ctu(MeshS *pM);
+void lr_states_destruct_prim2_ctu(void);
+void lr_states_prim2_ctu(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_prim2_ctu_hll(MeshS *pM);
+void lr_states_destruct_prim2_ctu_hll(void);
+void lr_states_prim2_ctu_hll(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_prim2_vl(MeshS *pM);
+void lr_states_destruct_prim2_vl(void);
+void lr_states_prim2_vl(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_prim3_ctu(MeshS *pM);
+void lr_states_destruct_prim3_ctu(void);
+void lr_states_prim3_ctu(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_prim3_ctu_hll(MeshS *pM);
+void lr_states_destruct_prim3_ctu_hll(void);
+void lr_states_prim3_ctu_hll(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+void lr_states_init_prim3_vl(MeshS *pM);
+void lr_states_destruct_prim3_vl(void);
+void lr_states_prim3_vl(const GridS* pG, const Prim1DS W[], const Real Bxc[],
+  const Real dt, const Real dx, const int is, const int ie,
+  Prim1DS Wl[], Prim1DS Wr[], const int dir);
+#endif /* RUNTIME_SOLVERS */
 
 #endif /* RECONSTRUCTION_PROTOTYPES_H */
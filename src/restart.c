@@ -25,13 +25,47 @@
  * With SMR, restart files contain ALL levels and domains being updated by each
  * processor in one file, written in the default directory for the process.
  *
+ * With MPIIO_RESTART (configure --enable-mpiio-restart), all processes instead
+ * write a single restart file with collective MPI-IO, in the run directory
+ * (the parent of the id# directories).  After the parameter file, the root
+ * process writes nstep, time and dt, a table of the Domains (level, size,
+ * displacement and offset of their data) and any problem-specific data.  Then
+ * each variable of each Domain follows as one array over the whole Domain,
+ * each process writing the part covered by its Grids.  Since the data does not
+ * depend on the decomposition, the run can be restarted on any number of
+ * processes with any NGrid_x? (set on the command line), as long as the
+ * Domains themselves are unchanged.  problem_write_restart() is only called by
+ * the root process, problem_read_restart() by all processes.
+ *
+ * With ASYNC_RESTART (configure --enable-async-restart), dump_restart() writes
+ * the restart file into a staging buffer in memory, which holds one extra copy
+ * of the Grid arrays and is kept between restart files, and a background
+ * thread then writes the buffer to disk while the integration continues.  The
+ * file is identical to the one written without the option.  dump_restart()
+ * waits for the previous file to be finished before it starts the next one,
+ * and main() calls dump_restart_destruct() before it exits.
+ *
+ * With compress = lossless in the <outputN> block of the restarts (configure
+ * --enable-compression), the binary data is compressed by the functions in
+ * compress.c.  The parameter file at the start stays plain text, and
+ * restart_grids() reads both kinds of files.
+ *
+ * Uncompressed restart files end with an index of the fields in them (name,
+ * Domain, size and offset, see restart_map.c), after the problem-specific
+ * data.  restart_grids() maps such files into memory and copies each field
+ * into the Grids in one pass, rather than reading the file value by value.
+ * Files without the index, and all files in runs with particles, are read
+ * sequentially as before.
+ *
  * CONTAINS PUBLIC FUNCTIONS: 
- * - restart_grids() - reads nstep,time,dt,ConsS and B from restart file 
- * - dump_restart()  - writes a restart file
+ * - restart_grids()         - reads nstep,time,dt,ConsS and B from restart file 
+ * - dump_restart()          - writes a restart file
+ * - dump_restart_destruct() - waits for restart file, frees staging buffer
  *									      */
 /*============================================================================*/
 
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -41,6 +75,90 @@
 #include "prototypes.h"
 #include "particles/particle.h"
 
+#ifdef ASYNC_RESTART
+#include <pthread.h>
+
+/* restart file being written by the background thread */
+static pthread_t rst_thread;
+static int rst_busy = 0;         /* 1 while rst_thread is running */
+static int rst_werr = 0;         /* 1 if rst_thread failed to write the file */
+static FILE *rst_fp = NULL;      /* restart file */
+static char *rst_fname = NULL;   /* its name */
+static char *rst_image = NULL;   /* staging buffer with contents of file */
+static size_t rst_size = 0;      /* size of the file in bytes */
+static size_t rst_cap = 0;       /* size of the staging buffer in bytes */
+#endif /* ASYNC_RESTART */
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   cc_field()            - sets cell-centred B from interface B
+ *   restart_grids_mpiio() - restart_grids() for a shared MPI-IO restart file
+ *   dump_restart_mpiio()  - dump_restart() for a shared MPI-IO restart file
+ *   rst_data()            - reads or writes arrays of all Domains with MPI-IO
+ *   rst_vars()            - lists arrays written for each Domain
+ *   rst_extent()          - size of an array over a Domain, or part on a Grid
+ *   pack_var()            - copies part of an array on a Grid to a buffer
+ *   unpack_var()          - copies part of an array on a Grid from a buffer
+ *   write_restart()       - writes contents of a restart file to a stream
+ *   rst_label()           - writes label of a field, and adds it to index
+ *   restart_grids_map()   - restart_grids() through the index of the file
+ *   map_field()           - data of a field in the mapped restart file
+ *   map_cons()            - copies a variable of ConsS from the mapped file
+ *   map_face()            - copies interface B from the mapped file
+ *   rst_wait()            - waits for restart file written in background
+ *   rst_estimate()        - initial size of staging buffer
+ *   rst_grow()            - replaces staging buffer by a larger one
+ *   rst_writer()          - writes staging buffer to restart file in thread
+ *============================================================================*/
+
+#ifdef MHD
+static void cc_field(GridS *pG);
+#endif
+#ifdef MPIIO_RESTART
+static void restart_grids_mpiio(char *res_file, MeshS *pM);
+static void dump_restart_mpiio(MeshS *pM, OutputS *pout);
+static void rst_data(MeshS *pM, char *name, const long long data_start,
+                     const int write);
+static int rst_vars(int var[]);
+static void rst_extent(DomainS *pD, GridS *pG, const int var, const int write,
+                       int start[3], int size[3]);
+static void pack_var(GridS *pG, const int var, const int size[3], Real *buf);
+static void unpack_var(GridS *pG, const int var, const int size[3],
+                       const Real *buf);
+
+/* maximum number of arrays written for each Domain, see rst_vars() */
+#define NRST_VAR (8 + NSCALARS)
+
+#ifdef SINGLE_PREC
+#define MPI_RL MPI_FLOAT
+#else
+#define MPI_RL MPI_DOUBLE
+#endif
+#endif /* MPIIO_RESTART */
+static void write_restart(MeshS *pM, ZFileS *zf);
+static void rst_label(ZFileS *zf, RstIndexS *idx, const char *name,
+                      const int nl, const int nd, const int elsize,
+                      const int n1, const int n2, const int n3);
+#ifndef PARTICLES
+static int restart_grids_map(char *res_file, MeshS *pM);
+static const char *map_field(const RstMapS *rm, const char *name, const int nl,
+                             const int nd, const int elsize, const int n1,
+                             const int n2, const int n3);
+static void map_cons(const RstMapS *rm, const char *name, const int nl,
+                     const int nd, GridS *pG, const int n);
+#ifdef MHD
+static void map_face(const RstMapS *rm, const char *name, const int nl,
+                     const int nd, Real ***B, const int ib, const int jb,
+                     const int kb, GridS *pG);
+#endif
+#endif /* PARTICLES */
+#ifdef ASYNC_RESTART
+static void rst_wait(void);
+static size_t rst_estimate(MeshS *pM);
+static void rst_grow(const size_t nbytes);
+static void *rst_writer(void *arg);
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void restart_grids(char *res_file, MeshS *pM)
  *  \brief Reads nstep, time, dt, and arrays of ConsS and interface B
@@ -58,6 +176,9 @@ void restart_grids(char *res_file, MeshS *pM)
   GridS *pG;
   FILE *fp;
   char line[MAXLEN];
+#ifdef COMPRESSION
+  char *image = NULL;
+#endif
   int i,j,k,is,ie,js,je,ks,ke,nl,nd;
 #ifdef MHD
   int ib=0,jb=0,kb=0;
@@ -70,6 +191,16 @@ void restart_grids(char *res_file, MeshS *pM)
   long p;
 #endif
 
+#ifdef MPIIO_RESTART
+  restart_grids_mpiio(res_file, pM);
+  return;
+#endif
+#ifndef PARTICLES
+/* Map the file into memory and read the fields through its index, if it has
+ * one (compressed files and files from older versions do not) */
+  if (restart_grids_map(res_file, pM)) return;
+#endif
+
 /* Open the restart file */
 
   if((fp = fopen(res_file,"r")) == NULL)
@@ -81,9 +212,21 @@ void restart_grids(char *res_file, MeshS *pM)
     fgets(line,MAXLEN,fp);
   }while(strncmp(line,"<par_end>",9) != 0);
 
-/* read nstep */
+/* Decompress the rest of a compressed restart file into memory */
 
   fgets(line,MAXLEN,fp);
+#ifdef COMPRESSION
+  if(strncmp(line,"COMPRESSED",10) == 0){
+    fp = ath_zunpack(fp, &image);
+    fgets(line,MAXLEN,fp);
+  }
+#else
+  if(strncmp(line,"COMPRESSED",10) == 0)
+    ath_error("[restart_grids]: Compressed restart file requires configure --enable-compression\n");
+#endif
+
+/* read nstep */
+
   if(strncmp(line,"N_STEP",6) != 0)
     ath_error("[restart_grids]: Expected N_STEP, found %s",line);
   fread(&(pM->nstep),sizeof(int),1,fp);
@@ -136,7 +279,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].d),sizeof(Real),1,fp);
+            fread(&(GRID_U(pG,k,j,i,d)),sizeof(Real),1,fp);
           }
         }
       }
@@ -150,7 +293,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].M1),sizeof(Real),1,fp);
+            fread(&(GRID_U(pG,k,j,i,M1)),sizeof(Real),1,fp);
           }
         }
       }
@@ -164,7 +307,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].M2),sizeof(Real),1,fp);
+            fread(&(GRID_U(pG,k,j,i,M2)),sizeof(Real),1,fp);
           }
         }
       }
@@ -178,7 +321,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].M3),sizeof(Real),1,fp);
+            fread(&(GRID_U(pG,k,j,i,M3)),sizeof(Real),1,fp);
           }
         }
       }
@@ -193,7 +336,7 @@ void restart_grids(char *res_file, MeshS *pM)
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            fread(&(pG->U[k][j][i].E),sizeof(Real),1,fp);
+            fread(&(GRID_U(pG,k,j,i,E)),sizeof(Real),1,fp);
           }
         }
       }
@@ -250,62 +393,9 @@ void restart_grids(char *res_file, MeshS *pM)
         }
       }
 
-/* initialize the cell center magnetic fields as either the average of the face
- * centered field if there is more than one cell in that dimension, or just
- * the face centered field if not  */
+/* initialize the cell center magnetic fields */
 
-      if(ib==1) {
-        for (k=ks; k<=ke; k++) {
-        for (j=js; j<=je; j++) {
-        for (i=is; i<=ie; i++) {
-#if defined(CARTESIAN)
-          pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] +pG->B1i[k][j][i+1]);
-#elif defined(CYLINDRICAL)
-          pG->U[k][j][i].B1c = 0.5*(pG->ri[i]*pG->B1i[k][j][i] + pG->ri[i+1]*pG->B1i[k][j][i+1])/pG->r[i];
-#elif defined(SPHERICAL)
-          pG->U[k][j][i].B1c = ((pG->px1i[i+1]-pG->px1v[i])*pG->B1i[k][j][i] + (pG->px1v[i]-pG->px1i[i])*pG->B1i[k][j][i+1])/pG->dx1;
-#endif
-        }}}
-      }
-      else {
-        for (k=ks; k<=ke; k++) {
-        for (j=js; j<=je; j++) {
-        for (i=is; i<=ie; i++) {
-        pG->U[k][j][i].B1c = pG->B1i[k][j][i];
-        }}}
-      }
-      if(jb==1) {
-        for (k=ks; k<=ke; k++) {
-        for (j=js; j<=je; j++) {
-        for (i=is; i<=ie; i++) {
-#ifdef SPHERICAL
-          pG->U[k][j][i].B2c = ((pG->px2i[j+1]-pG->px2v[j])*pG->B2i[k][j][i] + (pG->px2v[j]-pG->px2i[j])*pG->B2i[k][j+1][i])/pG->dx2;
-#else
-          pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] +pG->B2i[k][j+1][i]);
-#endif
-        }}}
-      }
-      else {
-        for (k=ks; k<=ke; k++) {
-        for (j=js; j<=je; j++) {
-        for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].B2c = pG->B2i[k][j][i];
-        }}}
-      }
-      if(kb==1) {
-        for (k=ks; k<=ke; k++) {
-        for (j=js; j<=je; j++) {
-        for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] +pG->B3i[k+1][j][i]);
-        }}}
-      }
-      else {
-        for (k=ks; k<=ke; k++) {
-        for (j=js; j<=je; j++) {
-        for (i=is; i<=ie; i++) {
-          pG->U[k][j][i].B3c = pG->B3i[k][j][i];
-        }}}
-      }
+      cc_field(pG);
 #endif
 
 #if (NSCALARS > 0)
@@ -321,7 +411,7 @@ void restart_grids(char *res_file, MeshS *pM)
         for (k=ks; k<=ke; k++) {
           for (j=js; j<=je; j++) {
             for (i=is; i<=ie; i++) {
-              fread(&(pG->U[k][j][i].s[n]),sizeof(Real),1,fp);
+              fread(&(GRID_U(pG,k,j,i,s[n])),sizeof(Real),1,fp);
             }
           }
         }
@@ -469,6 +559,9 @@ void restart_grids(char *res_file, MeshS *pM)
   problem_read_restart(pM, fp);
 
   fclose(fp);
+#ifdef COMPRESSION
+  if (image != NULL) free(image);
+#endif
 
   return;
 }
@@ -480,15 +573,111 @@ void restart_grids(char *res_file, MeshS *pM)
 
 void dump_restart(MeshS *pM, OutputS *pout)
 {
-  GridS *pG;
   FILE *fp;
+  ZFileS *zf;
   char *fname;
+#ifdef ASYNC_RESTART
+  long nbytes;
+#endif
+
+#ifdef MPIIO_RESTART
+  dump_restart_mpiio(pM, pout);
+  return;
+#endif
+#ifdef ASYNC_RESTART
+/* Wait for the previous restart file to be finished */
+  rst_wait();
+#endif
+
+/* Create filename and Open the output file */
+
+  if((fname = ath_fname(NULL,pM->outfilename,NULL,NULL,num_digit,
+      pout->num,NULL,"rst")) == NULL){
+    ath_error("[dump_restart]: Error constructing filename\n");
+  }
+
+  if((fp = fopen(fname,"wb")) == NULL){
+    ath_error("[dump_restart]: Unable to open restart file\n");
+    return;
+  }
+
+#ifdef ASYNC_RESTART
+/* Write the contents of the file to the staging buffer, which is kept for the
+ * next restart file.  If they do not fit, make it larger and start again. */
+
+  rst_fp = fp;
+  rst_fname = fname;
+  if (rst_image == NULL) rst_grow(rst_estimate(pM));
+  for (;;) {
+    if((fp = fmemopen(rst_image, rst_cap, "w")) == NULL)
+      ath_error("[dump_restart]: Unable to open staging buffer\n");
+    zf = ath_zopen(fp, pout);
+    write_restart(pM, zf);
+    ath_zclose(zf);
+    fflush(fp);
+    nbytes = ftell(fp);
+    if (!ferror(fp) && nbytes >= 0 && (size_t)nbytes < rst_cap) break;
+    fclose(fp);
+    rst_grow(2*rst_cap);
+  }
+  fclose(fp);
+  rst_size = (size_t)nbytes;
+
+/* Start writing the staging buffer to the file in the background, or write it
+ * now if no thread can be started */
+
+  rst_werr = 0;
+  if(pthread_create(&rst_thread, NULL, rst_writer, NULL) == 0) {
+    rst_busy = 1;
+  } else {
+    rst_writer(NULL);
+    rst_wait();
+  }
+#else
+  free(fname);
+  zf = ath_zopen(fp, pout);
+  write_restart(pM, zf);
+  ath_zclose(zf);
+  fclose(fp);
+#endif
+
+  return;
+}
+
+#ifdef ASYNC_RESTART
+/*----------------------------------------------------------------------------*/
+/*! \fn void dump_restart_destruct(void)
+ *  \brief Waits until the restart file being written in the background is
+ *   finished, and frees the staging buffer */
+
+void dump_restart_destruct(void)
+{
+  rst_wait();
+  free(rst_image);
+  rst_image = NULL;
+  rst_cap = 0;
+  return;
+}
+#endif /* ASYNC_RESTART */
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void write_restart(MeshS *pM, ZFileS *zf)
+ *  \brief Writes the contents of a restart file to zf, including
+ *   problem-specific data from a user defined function.  With compression,
+ *   the parameter file and the labels stay plain text, after a line
+ *   COMPRESSED.  */
+
+static void write_restart(MeshS *pM, ZFileS *zf)
+{
+  GridS *pG;
   int i,j,k,is,ie,js,je,ks,ke,nl,nd;
 #ifdef MHD
   int ib=0,jb=0,kb=0;
 #endif
 #if (NSCALARS > 0)
   int n;
+  char label[16];
 #endif
 #ifdef PARTICLES
   int nprop, *ibuf = NULL, ibufsize, lbufsize, sbufsize, nibuf, nlbuf, nsbuf;
@@ -498,6 +687,12 @@ void dump_restart(MeshS *pM, OutputS *pout)
 #endif
   int bufsize, nbuf = 0;
   Real *buf = NULL;
+  RstIndexS idx = {0, 0, NULL};
+#ifdef COMPRESSION
+  FILE *fud;
+  char *ud;
+  size_t nud;
+#endif
 
 /* Allocate memory for buffer */
   bufsize = 262144 / sizeof(Real);  /* 256 KB worth of Reals */
@@ -523,19 +718,6 @@ void dump_restart(MeshS *pM, OutputS *pout)
   }
 #endif
 
-/* Create filename and Open the output file */
-
-  if((fname = ath_fname(NULL,pM->outfilename,NULL,NULL,num_digit,
-      pout->num,NULL,"rst")) == NULL){
-    ath_error("[dump_restart]: Error constructing filename\n");
-  }
-
-  if((fp = fopen(fname,"wb")) == NULL){
-    ath_error("[dump_restart]: Unable to open restart file\n");
-    return;
-  }
-  free(fname);
-
 /* Add the current time & nstep to the parameter file */
 
   par_setd("time","time","%e",pM->time,"Current Simulation Time");
@@ -543,31 +725,34 @@ void dump_restart(MeshS *pM, OutputS *pout)
 
 /* Write the current state of the parameter file */
 
-  par_dump(2,fp);
+  par_dump(2,zf->fp);
+  if (zf->compress) ath_zprintf(zf,"COMPRESSED\n");
 
 /* Write out the current simulation step number */
 
-  fprintf(fp,"N_STEP\n");
-  if(fwrite(&(pM->nstep),sizeof(int),1,fp) != 1)
+  ath_zprintf(zf,"N_STEP\n");
+  if (zf->compress == 0)
+    ath_rstidx_add(&idx,zf->fp,"N_STEP",-1,-1,(int)sizeof(int),1,1,1);
+  if(ath_zwrite(&(pM->nstep),sizeof(int),1,zf) != 1)
     ath_error("[dump_restart]: fwrite() error\n");
 
 /* Write out the current simulation time */
 
-  fprintf(fp,"\nTIME\n");
-  if(fwrite(&(pM->time),sizeof(Real),1,fp) != 1)
+  rst_label(zf,&idx,"TIME",-1,-1,(int)sizeof(Real),1,1,1);
+  if(ath_zwrite(&(pM->time),sizeof(Real),1,zf) != 1)
     ath_error("[dump_restart]: fwrite() error\n");
 
 /* Write out the current simulation time step */
 
-  fprintf(fp,"\nTIME_STEP\n");
-  if(fwrite(&(pM->dt),sizeof(Real),1,fp) != 1)
+  rst_label(zf,&idx,"TIME_STEP",-1,-1,(int)sizeof(Real),1,1,1);
+  if(ath_zwrite(&(pM->dt),sizeof(Real),1,zf) != 1)
     ath_error("[dump_restart]: fwrite() error\n");
 #ifdef STS
-  if(fwrite(&(pM->diff_dt),sizeof(Real),1,fp) != 1)
+  if(ath_zwrite(&(pM->diff_dt),sizeof(Real),1,zf) != 1)
     ath_error("[dump_restart]: fwrite() error\n");
-  if(fwrite(&(N_STS),sizeof(int),1,fp) != 1)
+  if(ath_zwrite(&(N_STS),sizeof(int),1,zf) != 1)
     ath_error("[dump_restart]: fwrite() error\n");
-  if(fwrite(&(nu_STS),sizeof(Real),1,fp) != 1)
+  if(ath_zwrite(&(nu_STS),sizeof(Real),1,zf) != 1)
     ath_error("[dump_restart]: fwrite() error\n");
 #endif
 
@@ -586,97 +771,97 @@ void dump_restart(MeshS *pM, OutputS *pout)
 
 /* Write the density */
 
-      fprintf(fp,"\nDENSITY\n");
+      rst_label(zf,&idx,"DENSITY",nl,nd,(int)sizeof(Real),ie-is+1,je-js+1,ke-ks+1);
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].d;
+            buf[nbuf++] = GRID_U(pG,k,j,i,d);
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
 
 /* Write the x1-momentum */
 
-      fprintf(fp,"\n1-MOMENTUM\n");
+      rst_label(zf,&idx,"1-MOMENTUM",nl,nd,(int)sizeof(Real),ie-is+1,je-js+1,ke-ks+1);
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].M1;
+            buf[nbuf++] = GRID_U(pG,k,j,i,M1);
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
 
 /* Write the x2-momentum */
 
-      fprintf(fp,"\n2-MOMENTUM\n");
+      rst_label(zf,&idx,"2-MOMENTUM",nl,nd,(int)sizeof(Real),ie-is+1,je-js+1,ke-ks+1);
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].M2;
+            buf[nbuf++] = GRID_U(pG,k,j,i,M2);
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 /* Write the x3-momentum */
 
-      fprintf(fp,"\n3-MOMENTUM\n");
+      rst_label(zf,&idx,"3-MOMENTUM",nl,nd,(int)sizeof(Real),ie-is+1,je-js+1,ke-ks+1);
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].M3;
+            buf[nbuf++] = GRID_U(pG,k,j,i,M3);
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 #ifndef BAROTROPIC
 /* Write energy density */
 
-      fprintf(fp,"\nENERGY\n");
+      rst_label(zf,&idx,"ENERGY",nl,nd,(int)sizeof(Real),ie-is+1,je-js+1,ke-ks+1);
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
-            buf[nbuf++] = pG->U[k][j][i].E;
+            buf[nbuf++] = GRID_U(pG,k,j,i,E);
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
 #endif
@@ -690,58 +875,61 @@ void dump_restart(MeshS *pM, OutputS *pout)
 
 /* Write the x1-field */
 
-      fprintf(fp,"\n1-FIELD\n");
+      rst_label(zf,&idx,"1-FIELD",nl,nd,(int)sizeof(Real),
+                ie-is+1+ib,je-js+1,ke-ks+1);
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie+ib; i++) {
             buf[nbuf++] = pG->B1i[k][j][i];
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
 
 /* Write the x2-field */
 
-      fprintf(fp,"\n2-FIELD\n");
+      rst_label(zf,&idx,"2-FIELD",nl,nd,(int)sizeof(Real),
+                ie-is+1,je-js+1+jb,ke-ks+1);
       for (k=ks; k<=ke; k++) {
         for (j=js; j<=je+jb; j++) {
           for (i=is; i<=ie; i++) {
             buf[nbuf++] = pG->B2i[k][j][i];
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
 
 /* Write the x3-field */
 
-      fprintf(fp,"\n3-FIELD\n");
+      rst_label(zf,&idx,"3-FIELD",nl,nd,(int)sizeof(Real),
+                ie-is+1,je-js+1,ke-ks+1+kb);
       for (k=ks; k<=ke+kb; k++) {
         for (j=js; j<=je; j++) {
           for (i=is; i<=ie; i++) {
             buf[nbuf++] = pG->B3i[k][j][i];
             if ((nbuf+1) > bufsize) {
-              fwrite(buf,sizeof(Real),nbuf,fp);
+              ath_zwrite(buf,sizeof(Real),nbuf,zf);
               nbuf = 0;
             }
           }
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
 #endif
@@ -750,20 +938,21 @@ void dump_restart(MeshS *pM, OutputS *pout)
 
 #if (NSCALARS > 0)
       for (n=0; n<NSCALARS; n++) {
-        fprintf(fp,"\nSCALAR %d\n", n);
+        sprintf(label,"SCALAR %d", n);
+        rst_label(zf,&idx,label,nl,nd,(int)sizeof(Real),ie-is+1,je-js+1,ke-ks+1);
         for (k=ks; k<=ke; k++) {
           for (j=js; j<=je; j++) {
             for (i=is; i<=ie; i++) {
-              buf[nbuf++] = pG->U[k][j][i].s[n];
+              buf[nbuf++] = GRID_U(pG,k,j,i,s[n]);
               if ((nbuf+1) > bufsize) {
-                fwrite(buf,sizeof(Real),nbuf,fp);
+                ath_zwrite(buf,sizeof(Real),nbuf,zf);
                 nbuf = 0;
               }
             }
           }
         }
         if (nbuf > 0) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
@@ -772,11 +961,11 @@ void dump_restart(MeshS *pM, OutputS *pout)
 #ifdef PARTICLES
 /* Write out the number of particles */
 
-      fprintf(fp,"\nPARTICLE LIST\n");
       np = 0;
       for (p=0; p<pG->nparticle; p++)
         if (pG->particle[p].pos == 1) np += 1;
-      fwrite(&(np),sizeof(long),1,fp);
+      rst_label(zf,&idx,"PARTICLE LIST",nl,nd,(int)sizeof(long),1,1,1);
+      ath_zwrite(&(np),sizeof(long),1,zf);
     
 /* Write out the particle properties */
     
@@ -785,7 +974,7 @@ void dump_restart(MeshS *pM, OutputS *pout)
 #else
       nprop = 4;
 #endif
-      fwrite(&(npartypes),sizeof(int),1,fp); /* number of particle types */
+      ath_zwrite(&(npartypes),sizeof(int),1,zf); /* number of particle types */
       for (i=0; i<npartypes; i++) {          /* particle property list */
 #ifdef FEEDBACK
         buf[nbuf++] = grproperty[i].m;
@@ -795,170 +984,170 @@ void dump_restart(MeshS *pM, OutputS *pout)
         buf[nbuf++] = tstop0[i];
         buf[nbuf++] = grrhoa[i];
         if ((nbuf+nprop) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
-      fwrite(&(alamcoeff),sizeof(Real),1,fp);  /* coef for Reynolds number */
+      ath_zwrite(&(alamcoeff),sizeof(Real),1,zf);  /* coef for Reynolds number */
     
       for (i=0; i<npartypes; i++) {         /* particle integrator type */
         sbuf[nsbuf++] = grproperty[i].integrator;
         if ((nsbuf+1) > sbufsize) {
-          fwrite(sbuf,sizeof(short),nsbuf,fp);
+          ath_zwrite(sbuf,sizeof(short),nsbuf,zf);
           nsbuf = 0;
         }
       }
       if (nsbuf > 0) {
-        fwrite(sbuf,sizeof(short),nsbuf,fp);
+        ath_zwrite(sbuf,sizeof(short),nsbuf,zf);
         nsbuf = 0;
       }
     
 /* Write x1 */
     
-      fprintf(fp,"\nPARTICLE X1\n");
+      rst_label(zf,&idx,"PARTICLE X1",nl,nd,(int)sizeof(Real),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         buf[nbuf++] = pG->particle[p].x1;
         if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 /* Write x2 */
     
-      fprintf(fp,"\nPARTICLE X2\n");
+      rst_label(zf,&idx,"PARTICLE X2",nl,nd,(int)sizeof(Real),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         buf[nbuf++] = pG->particle[p].x2;
         if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 /* Write x3 */
     
-      fprintf(fp,"\nPARTICLE X3\n");
+      rst_label(zf,&idx,"PARTICLE X3",nl,nd,(int)sizeof(Real),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         buf[nbuf++] = pG->particle[p].x3;
         if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 /* Write v1 */
     
-      fprintf(fp,"\nPARTICLE V1\n");
+      rst_label(zf,&idx,"PARTICLE V1",nl,nd,(int)sizeof(Real),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         buf[nbuf++] = pG->particle[p].v1;
         if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 /* Write v2 */
     
-      fprintf(fp,"\nPARTICLE V2\n");
+      rst_label(zf,&idx,"PARTICLE V2",nl,nd,(int)sizeof(Real),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         buf[nbuf++] = pG->particle[p].v2;
         if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 /* Write v3 */
     
-      fprintf(fp,"\nPARTICLE V3\n");
+      rst_label(zf,&idx,"PARTICLE V3",nl,nd,(int)sizeof(Real),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         buf[nbuf++] = pG->particle[p].v3;
         if ((nbuf+1) > bufsize) {
-          fwrite(buf,sizeof(Real),nbuf,fp);
+          ath_zwrite(buf,sizeof(Real),nbuf,zf);
           nbuf = 0;
         }
       }
       if (nbuf > 0) {
-        fwrite(buf,sizeof(Real),nbuf,fp);
+        ath_zwrite(buf,sizeof(Real),nbuf,zf);
         nbuf = 0;
       }
     
 /* Write properties */
     
-      fprintf(fp,"\nPARTICLE PROPERTY\n");
+      rst_label(zf,&idx,"PARTICLE PROPERTY",nl,nd,(int)sizeof(int),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         ibuf[nibuf++] = pG->particle[p].property;
         if ((nibuf+1) > ibufsize) {
-          fwrite(ibuf,sizeof(int),nibuf,fp);
+          ath_zwrite(ibuf,sizeof(int),nibuf,zf);
           nibuf = 0;
         }
       }
       if (nibuf > 0) {
-        fwrite(ibuf,sizeof(int),nibuf,fp);
+        ath_zwrite(ibuf,sizeof(int),nibuf,zf);
         nibuf = 0;
       }
     
 /* Write my_id */
     
-      fprintf(fp,"\nPARTICLE MY_ID\n");
+      rst_label(zf,&idx,"PARTICLE MY_ID",nl,nd,(int)sizeof(long),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         lbuf[nlbuf++] = pG->particle[p].my_id;
         if ((nlbuf+1) > lbufsize) {
-          fwrite(lbuf,sizeof(long),nlbuf,fp);
+          ath_zwrite(lbuf,sizeof(long),nlbuf,zf);
           nlbuf = 0;
         }
       }
       if (nlbuf > 0) {
-        fwrite(lbuf,sizeof(long),nlbuf,fp);
+        ath_zwrite(lbuf,sizeof(long),nlbuf,zf);
         nlbuf = 0;
       }
     
 #ifdef MPI_PARALLEL
 /* Write init_id */
     
-      fprintf(fp,"\nPARTICLE INIT_ID\n");
+      rst_label(zf,&idx,"PARTICLE INIT_ID",nl,nd,(int)sizeof(int),(int)np,1,1);
       for (p=0;p<pG->nparticle;p++)
       if (pG->particle[p].pos == 1){
         ibuf[nibuf++] = pG->particle[p].init_id;
         if ((nibuf+1) > ibufsize) {
-          fwrite(ibuf,sizeof(int),nibuf,fp);
+          ath_zwrite(ibuf,sizeof(int),nibuf,zf);
           nibuf = 0;
         }
       }
       if (nibuf > 0) {
-        fwrite(ibuf,sizeof(int),nibuf,fp);
+        ath_zwrite(ibuf,sizeof(int),nibuf,zf);
         nibuf = 0;
       }
 #endif
@@ -969,12 +1158,825 @@ void dump_restart(MeshS *pM, OutputS *pout)
     
 /* call a user function to write his/her problem-specific data! */
     
-  fprintf(fp,"\nUSER_DATA\n");
-  problem_write_restart(pM, fp);
+  rst_label(zf,&idx,"USER_DATA",-1,-1,1,0,1,1);
+#ifdef COMPRESSION
+  if (zf->compress) {
+    if ((fud = open_memstream(&ud, &nud)) == NULL)
+      ath_error("[dump_restart]: Unable to open memory stream\n");
+    problem_write_restart(pM, fud);
+    fclose(fud);
+    ath_zwrite(ud,1,nud,zf);
+    free(ud);
+  } else
+#endif
+  problem_write_restart(pM, zf->fp);
+
+/* Append the index of the fields, with the size of the problem-specific data */
+
+  if (zf->compress == 0) {
+    idx.field[idx.nfield-1].n[0] =
+      (int)((long long)ftell(zf->fp) - idx.field[idx.nfield-1].offset);
+    ath_rstidx_write(&idx, zf->fp);
+  }
+
+  free_1d_array(buf);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void rst_label(ZFileS *zf, RstIndexS *idx, const char *name,
+ *                            const int nl, const int nd, const int elsize,
+ *                            const int n1, const int n2, const int n3)
+ *  \brief Writes the label of field name on a line of its own, and adds the
+ *   field that follows it to the index, unless the file is compressed */
+
+static void rst_label(ZFileS *zf, RstIndexS *idx, const char *name,
+                      const int nl, const int nd, const int elsize,
+                      const int n1, const int n2, const int n3)
+{
+  ath_zprintf(zf,"\n%s\n",name);
+  if (zf->compress == 0)
+    ath_rstidx_add(idx,zf->fp,name,nl,nd,elsize,n1,n2,n3);
+  return;
+}
+
+#ifndef PARTICLES
+/*----------------------------------------------------------------------------*/
+/*! \fn static int restart_grids_map(char *res_file, MeshS *pM)
+ *  \brief Reads nstep, time, dt, ConsS and interface B of each Grid like
+ *   restart_grids(), from the restart file mapped into memory.  Each field is
+ *   found from the index at the end of the file and copied straight into the
+ *   Grid, rather than read value by value.  Returns 0 without reading anything
+ *   if the file has no index. */
+
+static int restart_grids_map(char *res_file, MeshS *pM)
+{
+  RstMapS *rm;
+  GridS *pG;
+  FILE *fp;
+  const char *src;
+  const RstFieldS *pf;
+  int is,ie,js,je,ks,ke,nl,nd;
+#ifdef MHD
+  int ib,jb,kb;
+#endif
+#if (NSCALARS > 0)
+  int n;
+  char label[16];
+#endif
+
+  if ((rm = ath_rstmap_open(res_file)) == NULL) return 0;
+
+/* read nstep, time and dt */
+
+  src = map_field(rm,"N_STEP",-1,-1,(int)sizeof(int),1,1,1);
+  memcpy(&(pM->nstep),src,sizeof(int));
+  src = map_field(rm,"TIME",-1,-1,(int)sizeof(Real),1,1,1);
+  memcpy(&(pM->time),src,sizeof(Real));
+  src = map_field(rm,"TIME_STEP",-1,-1,(int)sizeof(Real),1,1,1);
+  memcpy(&(pM->dt),src,sizeof(Real));
+#ifdef STS
+  src += sizeof(Real);
+  memcpy(&(pM->diff_dt),src,sizeof(Real));
+  src += sizeof(Real);
+  memcpy(&(N_STS),src,sizeof(int));
+  src += sizeof(int);
+  memcpy(&(nu_STS),src,sizeof(Real));
+#endif
+
+/* Now loop over all Domains containing a Grid on this processor */
+
+  for (nl=0; nl<=(pM->NLevels)-1; nl++){
+  for (nd=0; nd<=(pM->DomainsPerLevel[nl])-1; nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) {
+      pG=pM->Domain[nl][nd].Grid;
+      is = pG->is;  ie = pG->ie;
+      js = pG->js;  je = pG->je;
+      ks = pG->ks;  ke = pG->ke;
 
+      pG->time = pM->time;
+      pG->dt   = pM->dt;
+
+      map_cons(rm,"DENSITY",nl,nd,pG,(int)(offsetof(ConsS,d)/sizeof(Real)));
+      map_cons(rm,"1-MOMENTUM",nl,nd,pG,(int)(offsetof(ConsS,M1)/sizeof(Real)));
+      map_cons(rm,"2-MOMENTUM",nl,nd,pG,(int)(offsetof(ConsS,M2)/sizeof(Real)));
+      map_cons(rm,"3-MOMENTUM",nl,nd,pG,(int)(offsetof(ConsS,M3)/sizeof(Real)));
+#ifndef BAROTROPIC
+      map_cons(rm,"ENERGY",nl,nd,pG,(int)(offsetof(ConsS,E)/sizeof(Real)));
+#endif
+
+#ifdef MHD
+/* one more face-centered component than cells in each direction with more
+ * than one cell, as in restart_grids() */
+      ib = (ie > is) ? 1 : 0;
+      jb = (je > js) ? 1 : 0;
+      kb = (ke > ks) ? 1 : 0;
+      map_face(rm,"1-FIELD",nl,nd,pG->B1i,ib,0,0,pG);
+      map_face(rm,"2-FIELD",nl,nd,pG->B2i,0,jb,0,pG);
+      map_face(rm,"3-FIELD",nl,nd,pG->B3i,0,0,kb,pG);
+      cc_field(pG);
+#endif
+
+#if (NSCALARS > 0)
+      for (n=0; n<NSCALARS; n++) {
+        sprintf(label,"SCALAR %d",n);
+        map_cons(rm,label,nl,nd,pG,
+                 (int)(offsetof(ConsS,s)/sizeof(Real)) + n);
+      }
+#endif
+    }
+  }} /* End loop over all Domains --------------------------------------------*/
+
+/* Call a user function to read his/her problem-specific data, from a stream
+ * positioned at the start of it */
+
+  if (ath_rstmap_field(rm,"USER_DATA",-1,-1,&pf) == NULL)
+    ath_error("[restart_grids]: No USER_DATA in index of %s\n",res_file);
+  if((fp = fopen(res_file,"r")) == NULL)
+    ath_error("[restart_grids]: Error opening the restart file\n");
+  if (fseek(fp, (long)pf->offset, SEEK_SET) != 0)
+    ath_error("[restart_grids]: Error seeking to USER_DATA in %s\n",res_file);
+  problem_read_restart(pM, fp);
   fclose(fp);
 
+  ath_rstmap_close(rm);
+  return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static const char *map_field(const RstMapS *rm, const char *name,
+ *                                   const int nl, const int nd,
+ *                                   const int elsize, const int n1,
+ *                                   const int n2, const int n3)
+ *  \brief Returns the data of field name of Domain nd on level nl in the
+ *   mapped restart file, after checking its size against the Grid */
+
+static const char *map_field(const RstMapS *rm, const char *name, const int nl,
+                             const int nd, const int elsize, const int n1,
+                             const int n2, const int n3)
+{
+  const RstFieldS *pf;
+  const char *src;
+
+  if ((src = (const char*)ath_rstmap_field(rm,name,nl,nd,&pf)) == NULL)
+    ath_error("[restart_grids]: No %s for level %d domain %d in restart file\n",
+              name,nl,nd);
+  if (pf->elsize != elsize || pf->n[0] != n1 || pf->n[1] != n2 ||
+      pf->n[2] != n3)
+    ath_error("[restart_grids]: %s for level %d domain %d is %dx%dx%d of size %d, expected %dx%dx%d of size %d\n",
+              name,nl,nd,pf->n[0],pf->n[1],pf->n[2],pf->elsize,n1,n2,n3,elsize);
+  return src;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void map_cons(const RstMapS *rm, const char *name,
+ *                           const int nl, const int nd, GridS *pG,
+ *                           const int n)
+ *  \brief Copies field name from the mapped restart file into variable n (in
+ *   ConsS order) of the active cells of Grid pG */
+
+static void map_cons(const RstMapS *rm, const char *name, const int nl,
+                     const int nd, GridS *pG, const int n)
+{
+  const char *src;
+  int i,j,k;
+
+  src = map_field(rm,name,nl,nd,(int)sizeof(Real),pG->ie-pG->is+1,
+                  pG->je-pG->js+1,pG->ke-pG->ks+1);
+  for (k=pG->ks; k<=pG->ke; k++) {
+    for (j=pG->js; j<=pG->je; j++) {
+      for (i=pG->is; i<=pG->ie; i++) {
+        memcpy(&(GRID_UN(pG,k,j,i,n)),src,sizeof(Real));
+        src += sizeof(Real);
+      }
+    }
+  }
+  return;
+}
+
+#ifdef MHD
+/*----------------------------------------------------------------------------*/
+/*! \fn static void map_face(const RstMapS *rm, const char *name,
+ *                           const int nl, const int nd, Real ***B,
+ *                           const int ib, const int jb, const int kb,
+ *                           GridS *pG)
+ *  \brief Copies field name from the mapped restart file into the interface
+ *   field B of Grid pG, with ib, jb and kb extra faces in x1, x2 and x3 */
+
+static void map_face(const RstMapS *rm, const char *name, const int nl,
+                     const int nd, Real ***B, const int ib, const int jb,
+                     const int kb, GridS *pG)
+{
+  const char *src;
+  int j,k,n1;
+
+  n1 = pG->ie-pG->is+1+ib;
+  src = map_field(rm,name,nl,nd,(int)sizeof(Real),n1,pG->je-pG->js+1+jb,
+                  pG->ke-pG->ks+1+kb);
+  for (k=pG->ks; k<=pG->ke+kb; k++) {
+    for (j=pG->js; j<=pG->je+jb; j++) {
+      memcpy(&(B[k][j][pG->is]),src,n1*sizeof(Real));
+      src += n1*sizeof(Real);
+    }
+  }
+  return;
+}
+#endif /* MHD */
+#endif /* PARTICLES */
+
+#ifdef MHD
+/*----------------------------------------------------------------------------*/
+/*! \fn static void cc_field(GridS *pG)
+ *  \brief Sets the cell center magnetic fields as either the average of the
+ *   face centered field if there is more than one cell in that dimension, or
+ *   just the face centered field if not  */
+
+static void cc_field(GridS *pG)
+{
+  int i,j,k,is,ie,js,je,ks,ke,ib=0,jb=0,kb=0;
+
+  is = pG->is;  ie = pG->ie;
+  js = pG->js;  je = pG->je;
+  ks = pG->ks;  ke = pG->ke;
+  if (ie > is) ib=1;
+  if (je > js) jb=1;
+  if (ke > ks) kb=1;
+
+  if(ib==1) {
+    for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+    for (i=is; i<=ie; i++) {
+#if defined(CARTESIAN)
+      GRID_U(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] +pG->B1i[k][j][i+1]);
+#elif defined(CYLINDRICAL)
+      GRID_U(pG,k,j,i,B1c) = 0.5*(pG->ri[i]*pG->B1i[k][j][i] + pG->ri[i+1]*pG->B1i[k][j][i+1])/pG->r[i];
+#elif defined(SPHERICAL)
+      GRID_U(pG,k,j,i,B1c) = ((pG->px1i[i+1]-pG->px1v[i])*pG->B1i[k][j][i] + (pG->px1v[i]-pG->px1i[i])*pG->B1i[k][j][i+1])/pG->dx1;
+#endif
+    }}}
+  }
+  else {
+    for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+    for (i=is; i<=ie; i++) {
+      GRID_U(pG,k,j,i,B1c) = pG->B1i[k][j][i];
+    }}}
+  }
+  if(jb==1) {
+    for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+    for (i=is; i<=ie; i++) {
+#ifdef SPHERICAL
+      GRID_U(pG,k,j,i,B2c) = ((pG->px2i[j+1]-pG->px2v[j])*pG->B2i[k][j][i] + (pG->px2v[j]-pG->px2i[j])*pG->B2i[k][j+1][i])/pG->dx2;
+#else
+      GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] +pG->B2i[k][j+1][i]);
+#endif
+    }}}
+  }
+  else {
+    for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+    for (i=is; i<=ie; i++) {
+      GRID_U(pG,k,j,i,B2c) = pG->B2i[k][j][i];
+    }}}
+  }
+  if(kb==1) {
+    for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+    for (i=is; i<=ie; i++) {
+      GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] +pG->B3i[k+1][j][i]);
+    }}}
+  }
+  else {
+    for (k=ks; k<=ke; k++) {
+    for (j=js; j<=je; j++) {
+    for (i=is; i<=ie; i++) {
+      GRID_U(pG,k,j,i,B3c) = pG->B3i[k][j][i];
+    }}}
+  }
+
+  return;
+}
+#endif /* MHD */
+
+#ifdef MPIIO_RESTART
+/*----------------------------------------------------------------------------*/
+/*! \fn static void restart_grids_mpiio(char *res_file, MeshS *pM)
+ *  \brief Reads a shared restart file written by dump_restart_mpiio().  All
+ *   processes read the header, then each reads the parts of every Domain
+ *   covered by its Grids, which need not be the Grids that wrote them. */
+
+static void restart_grids_mpiio(char *res_file, MeshS *pM)
+{
+  DomainS *pD;
+  GridS *pG;
+  FILE *fp;
+  char line[MAXLEN];
+  int nl,nd,v,nvar,var[NRST_VAR],ndom=0,size_real,dom[8];
+  int start[3],gsize[3];
+  long long offset, data_start, expect=0;
+
+/* Open the restart file, and skip over the parameter file at its start */
+
+  if((fp = fopen(res_file,"rb")) == NULL)
+    ath_error("[restart_grids]: Error opening the restart file %s\n",res_file);
+
+  do{
+    fgets(line,MAXLEN,fp);
+  }while(strncmp(line,"<par_end>",9) != 0);
+
+/* read nstep, time and dt */
+
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"N_STEP",6) != 0)
+    ath_error("[restart_grids]: Expected N_STEP, found %s",line);
+  fread(&(pM->nstep),sizeof(int),1,fp);
+
+  fgets(line,MAXLEN,fp);   /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"TIME",4) != 0)
+    ath_error("[restart_grids]: Expected TIME, found %s",line);
+  fread(&(pM->time),sizeof(Real),1,fp);
+
+  fgets(line,MAXLEN,fp);    /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"TIME_STEP",9) != 0)
+    ath_error("[restart_grids]: Expected TIME_STEP, found %s",line);
+  fread(&(pM->dt),sizeof(Real),1,fp);
+#ifdef STS
+  fread(&(pM->diff_dt),sizeof(Real),1,fp);
+  fread(&(N_STS),sizeof(int),1,fp);
+  fread(&(nu_STS),sizeof(Real),1,fp);
+#endif
+
+/* Check that the Domains in the file are those of the Mesh.  Only the number
+ * of Grids in each Domain may differ from the run that wrote the file. */
+
+  fgets(line,MAXLEN,fp);    /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"DOMAINS",7) != 0)
+    ath_error("[restart_grids]: Expected DOMAINS, found %s(restart files written without MPI-IO can't be read)\n",
+      line);
+  fread(&ndom,sizeof(int),1,fp);
+  fread(&size_real,sizeof(int),1,fp);
+  if(size_real != (int)sizeof(Real))
+    ath_error("[restart_grids]: Restart file has %d byte Reals, expected %d\n",
+      size_real,(int)sizeof(Real));
+
+  nvar = rst_vars(var);
+  for (nl=0; nl<(pM->NLevels); nl++) ndom -= pM->DomainsPerLevel[nl];
+  if(ndom != 0)
+    ath_error("[restart_grids]: Restart file has a different number of Domains\n");
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    pD = &(pM->Domain[nl][nd]);
+    fread(dom,sizeof(int),8,fp);
+    fread(&offset,sizeof(long long),1,fp);
+    if(dom[0] != nl || dom[1] != nd ||
+       dom[2] != pD->Nx[0] || dom[3] != pD->Nx[1] || dom[4] != pD->Nx[2] ||
+       dom[5] != pD->Disp[0] || dom[6] != pD->Disp[1] || dom[7] != pD->Disp[2] ||
+       offset != expect)
+      ath_error("[restart_grids]: Domain %d on level %d differs from restart file\n",
+        nd,nl);
+    for (v=0; v<nvar; v++) {
+      rst_extent(pD,NULL,var[v],0,start,gsize);
+      expect += (long long)gsize[0]*gsize[1]*gsize[2]*sizeof(Real);
+    }
+  }}
+
+/* Call a user function to read his/her problem-specific data! */
+
+  fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"USER_DATA",9) != 0)
+    ath_error("[restart_grids]: Expected USER_DATA, found %s",line);
+  problem_read_restart(pM, fp);
+
+  fgets(line,MAXLEN,fp); /* Read the '\n' preceeding the next string */
+  fgets(line,MAXLEN,fp);
+  if(strncmp(line,"DATA",4) != 0)
+    ath_error("[restart_grids]: Expected DATA, found %s",line);
+  data_start = (long long)ftell(fp);
+  fclose(fp);
+
+/* Read the arrays with collective MPI-IO */
+
+  rst_data(pM, res_file, data_start, 0);
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if ((pG = pM->Domain[nl][nd].Grid) != NULL) {
+      pG->time = pM->time;
+      pG->dt   = pM->dt;
+#ifdef MHD
+      cc_field(pG);
+#endif
+    }
+  }}
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void dump_restart_mpiio(MeshS *pM, OutputS *pout)
+ *  \brief Writes a single restart file shared by all processes.  The root
+ *   process writes the header, then all processes write the arrays of each
+ *   Domain with collective MPI-IO. */
+
+static void dump_restart_mpiio(MeshS *pM, OutputS *pout)
+{
+  DomainS *pD;
+  FILE *fp;
+  char *fname, name[MAXLEN];
+  int nl,nd,v,nvar,var[NRST_VAR],ndom=0,size_real=(int)sizeof(Real),dom[8];
+  int len=0,start[3],gsize[3];
+  long long offset=0, data_start=0;
+
+/* Root process creates the filename in the run directory (the parent of the
+ * id# directories) from its own problem_id, and shares it */
+
+  if(myID_Comm_world == 0){
+    if((fname = ath_fname("..",pM->outfilename,NULL,NULL,num_digit,
+        pout->num,NULL,"rst")) == NULL){
+      ath_error("[dump_restart]: Error constructing filename\n");
+    }
+    len = 1 + (int)strlen(fname);
+    if(len > MAXLEN)
+      ath_error("[dump_restart]: Restart filename length = %d is too large\n",
+        len);
+    strcpy(name, fname);
+    free(fname);
+  }
+  if(MPI_SUCCESS != MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD))
+    ath_error("[dump_restart]: Error on calling MPI_Bcast\n");
+  if(MPI_SUCCESS != MPI_Bcast(name, len, MPI_CHAR, 0, MPI_COMM_WORLD))
+    ath_error("[dump_restart]: Error on calling MPI_Bcast\n");
+
+/* Add the current time & nstep to the parameter file */
+
+  par_setd("time","time","%e",pM->time,"Current Simulation Time");
+  par_seti("time","nstep","%d",pM->nstep,"Current Simulation Time Step");
+
+/* Root process writes the header: the parameter file, nstep, time and dt, the
+ * table of Domains, and the problem-specific data */
+
+  nvar = rst_vars(var);
+  if(myID_Comm_world == 0){
+    if((fp = fopen(name,"wb")) == NULL)
+      ath_error("[dump_restart]: Unable to open restart file %s\n",name);
+
+    par_dump(2,fp);
+
+    fprintf(fp,"N_STEP\n");
+    if(fwrite(&(pM->nstep),sizeof(int),1,fp) != 1)
+      ath_error("[dump_restart]: fwrite() error\n");
+    fprintf(fp,"\nTIME\n");
+    if(fwrite(&(pM->time),sizeof(Real),1,fp) != 1)
+      ath_error("[dump_restart]: fwrite() error\n");
+    fprintf(fp,"\nTIME_STEP\n");
+    if(fwrite(&(pM->dt),sizeof(Real),1,fp) != 1)
+      ath_error("[dump_restart]: fwrite() error\n");
+#ifdef STS
+    if(fwrite(&(pM->diff_dt),sizeof(Real),1,fp) != 1)
+      ath_error("[dump_restart]: fwrite() error\n");
+    if(fwrite(&(N_STS),sizeof(int),1,fp) != 1)
+      ath_error("[dump_restart]: fwrite() error\n");
+    if(fwrite(&(nu_STS),sizeof(Real),1,fp) != 1)
+      ath_error("[dump_restart]: fwrite() error\n");
+#endif
+
+/* For each Domain: level, number, Nx[3], Disp[3] and offset of its arrays
+ * from the start of the data */
+
+    for (nl=0; nl<(pM->NLevels); nl++) ndom += pM->DomainsPerLevel[nl];
+    fprintf(fp,"\nDOMAINS\n");
+    fwrite(&ndom,sizeof(int),1,fp);
+    fwrite(&size_real,sizeof(int),1,fp);
+    for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      pD = &(pM->Domain[nl][nd]);
+      dom[0] = nl;
+      dom[1] = nd;
+      dom[2] = pD->Nx[0];    dom[3] = pD->Nx[1];    dom[4] = pD->Nx[2];
+      dom[5] = pD->Disp[0];  dom[6] = pD->Disp[1];  dom[7] = pD->Disp[2];
+      fwrite(dom,sizeof(int),8,fp);
+      if(fwrite(&offset,sizeof(long long),1,fp) != 1)
+        ath_error("[dump_restart]: fwrite() error\n");
+      for (v=0; v<nvar; v++) {
+        rst_extent(pD,NULL,var[v],1,start,gsize);
+        offset += (long long)gsize[0]*gsize[1]*gsize[2]*sizeof(Real);
+      }
+    }}
+
+/* call a user function to write his/her problem-specific data! */
+
+    fprintf(fp,"\nUSER_DATA\n");
+    problem_write_restart(pM, fp);
+
+    fprintf(fp,"\nDATA\n");
+    data_start = (long long)ftell(fp);
+    fclose(fp);
+  }
+
+/* All processes write their part of the arrays after the header */
+
+  if(MPI_SUCCESS != MPI_Bcast(&data_start, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD))
+    ath_error("[dump_restart]: Error on calling MPI_Bcast\n");
+
+  rst_data(pM, name, data_start, 1);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void rst_data(MeshS *pM, char *name, const long long data_start,
+ *                           const int write)
+ *  \brief Writes (write=1) or reads (write=0) the arrays of all Domains in a
+ *   shared restart file, starting data_start bytes into the file.  Each array
+ *   covers its whole Domain, ordered with i fastest; each process accesses the
+ *   block of it on its Grid through a subarray file view.  Processes with no
+ *   Grid on a Domain take part in the collective calls with no data. */
+
+static void rst_data(MeshS *pM, char *name, const long long data_start,
+                     const int write)
+{
+  DomainS *pD;
+  GridS *pG;
+  MPI_File fh;
+  MPI_Datatype ftype;
+  MPI_Status stat;
+  MPI_Offset disp = (MPI_Offset)data_start;
+  int nl,nd,v,nvar,var[NRST_VAR],nbuf=1,count,ierr;
+  int start[3],size[3],gsize[3],sizes[3],subsizes[3],starts[3];
+  Real *buf;
+
+  nvar = rst_vars(var);
+
+/* Allocate a buffer for the largest Grid on this process */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if ((pG = pM->Domain[nl][nd].Grid) != NULL) {
+      count = (pG->Nx[0]+1)*(pG->Nx[1]+1)*(pG->Nx[2]+1);
+      if (count > nbuf) nbuf = count;
+    }
+  }}
+  if ((buf = (Real*)calloc_1d_array(nbuf, sizeof(Real))) == NULL)
+    ath_error("[rst_data]: Error allocating memory for buffer\n");
+
+  if (write)
+    ierr = MPI_File_open(MPI_COMM_WORLD, name, MPI_MODE_WRONLY, MPI_INFO_NULL,
+                         &fh);
+  else
+    ierr = MPI_File_open(MPI_COMM_WORLD, name, MPI_MODE_RDONLY, MPI_INFO_NULL,
+                         &fh);
+  if (ierr != MPI_SUCCESS)
+    ath_error("[rst_data]: Unable to open %s with MPI-IO\n",name);
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    pD = &(pM->Domain[nl][nd]);
+    pG = pD->Grid;
+
+    for (v=0; v<nvar; v++) {
+      rst_extent(pD,NULL,var[v],write,start,gsize);
+
+      if (pG != NULL) {
+        rst_extent(pD,pG,var[v],write,start,size);
+        sizes[0] = gsize[2];    sizes[1] = gsize[1];    sizes[2] = gsize[0];
+        subsizes[0] = size[2];  subsizes[1] = size[1];  subsizes[2] = size[0];
+        starts[0] = start[2];   starts[1] = start[1];   starts[2] = start[0];
+        MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C,
+                                 MPI_RL, &ftype);
+        MPI_Type_commit(&ftype);
+        count = size[0]*size[1]*size[2];
+      } else {
+        ftype = MPI_RL;
+        count = 0;
+      }
+
+      ierr = MPI_File_set_view(fh, disp, MPI_RL, ftype, "native",
+                               MPI_INFO_NULL);
+      if (ierr == MPI_SUCCESS) {
+        if (write) {
+          if (pG != NULL) pack_var(pG,var[v],size,buf);
+          ierr = MPI_File_write_all(fh, buf, count, MPI_RL, &stat);
+        } else {
+          ierr = MPI_File_read_all(fh, buf, count, MPI_RL, &stat);
+          if (pG != NULL && ierr == MPI_SUCCESS) unpack_var(pG,var[v],size,buf);
+        }
+      }
+      if (ierr != MPI_SUCCESS)
+        ath_error("[rst_data]: MPI-IO error on %s\n",name);
+
+      if (pG != NULL) MPI_Type_free(&ftype);
+      disp += (MPI_Offset)gsize[0]*gsize[1]*gsize[2]*sizeof(Real);
+    }
+  }}
+
+  MPI_File_close(&fh);
   free_1d_array(buf);
 
   return;
 }
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int rst_vars(int var[])
+ *  \brief Lists the arrays written for each Domain, in the same order as in
+ *   restart files written by each process: the index in ConsS of each
+ *   cell-centred variable, or -1,-2,-3 for the interface fields B1i,B2i,B3i.
+ *   Returns the number of arrays. */
+
+static int rst_vars(int var[])
+{
+  int n=0;
+#if (NSCALARS > 0)
+  int m;
+#endif
+
+  var[n++] = (int)(offsetof(ConsS,d)/sizeof(Real));
+  var[n++] = (int)(offsetof(ConsS,M1)/sizeof(Real));
+  var[n++] = (int)(offsetof(ConsS,M2)/sizeof(Real));
+  var[n++] = (int)(offsetof(ConsS,M3)/sizeof(Real));
+#ifndef BAROTROPIC
+  var[n++] = (int)(offsetof(ConsS,E)/sizeof(Real));
+#endif
+#ifdef MHD
+  var[n++] = -1;
+  var[n++] = -2;
+  var[n++] = -3;
+#endif
+#if (NSCALARS > 0)
+  for (m=0; m<NSCALARS; m++)
+    var[n++] = (int)(offsetof(ConsS,s)/sizeof(Real)) + m;
+#endif
+
+  return n;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void rst_extent(DomainS *pD, GridS *pG, const int var,
+ *                             const int write, int start[3], int size[3])
+ *  \brief Returns the start (relative to the Domain) and size in each
+ *   direction of array var over the Domain pD (pG=NULL), or of the part of it
+ *   on Grid pG.  Interface fields have one more value than cells in their
+ *   direction; when writing, the face shared by two Grids is written by the
+ *   Grid above it. */
+
+static void rst_extent(DomainS *pD, GridS *pG, const int var, const int write,
+                       int start[3], int size[3])
+{
+  int n,face;
+
+  for (n=0; n<3; n++) {
+    face = (var == -(n+1) && pD->Nx[n] > 1) ? 1 : 0;
+    if (pG == NULL) {
+      start[n] = 0;
+      size[n] = pD->Nx[n] + face;
+    } else {
+      start[n] = pG->Disp[n] - pD->Disp[n];
+      size[n] = pG->Nx[n];
+      if (face && (!write || start[n] + pG->Nx[n] == pD->Nx[n])) size[n]++;
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void pack_var(GridS *pG, const int var, const int size[3],
+ *                           Real *buf)
+ *  \brief Copies size[0]*size[1]*size[2] values of array var, starting at the
+ *   first active zone of Grid pG, to buf with i fastest */
+
+static void pack_var(GridS *pG, const int var, const int size[3], Real *buf)
+{
+  int i,j,k,n=0;
+  int ie = pG->is + size[0] - 1;
+  int je = pG->js + size[1] - 1;
+  int ke = pG->ks + size[2] - 1;
+
+  for (k=pG->ks; k<=ke; k++) {
+    for (j=pG->js; j<=je; j++) {
+      for (i=pG->is; i<=ie; i++) {
+#ifdef MHD
+        if      (var == -1) buf[n++] = pG->B1i[k][j][i];
+        else if (var == -2) buf[n++] = pG->B2i[k][j][i];
+        else if (var == -3) buf[n++] = pG->B3i[k][j][i];
+        else
+#endif
+        buf[n++] = GRID_UN(pG,k,j,i,var);
+      }
+    }
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void unpack_var(GridS *pG, const int var, const int size[3],
+ *                             const Real *buf)
+ *  \brief Inverse of pack_var() */
+
+static void unpack_var(GridS *pG, const int var, const int size[3],
+                       const Real *buf)
+{
+  int i,j,k,n=0;
+  int ie = pG->is + size[0] - 1;
+  int je = pG->js + size[1] - 1;
+  int ke = pG->ks + size[2] - 1;
+
+  for (k=pG->ks; k<=ke; k++) {
+    for (j=pG->js; j<=je; j++) {
+      for (i=pG->is; i<=ie; i++) {
+#ifdef MHD
+        if      (var == -1) pG->B1i[k][j][i] = buf[n++];
+        else if (var == -2) pG->B2i[k][j][i] = buf[n++];
+        else if (var == -3) pG->B3i[k][j][i] = buf[n++];
+        else
+#endif
+        GRID_UN(pG,k,j,i,var) = buf[n++];
+      }
+    }
+  }
+
+  return;
+}
+#endif /* MPIIO_RESTART */
+
+#ifdef ASYNC_RESTART
+/*----------------------------------------------------------------------------*/
+/*! \fn static void rst_wait(void)
+ *  \brief Waits until the restart file being written in the background is
+ *   finished.  Exits if it could not be written. */
+
+static void rst_wait(void)
+{
+  if (rst_fname == NULL) return;  /* no restart file being written */
+
+  if (rst_busy) {
+    if (pthread_join(rst_thread, NULL) != 0)
+      ath_error("[dump_restart]: Error joining writer thread\n");
+    rst_busy = 0;
+  }
+  if (rst_werr)
+    ath_error("[dump_restart]: Error writing restart file %s\n",rst_fname);
+
+  free(rst_fname);
+  rst_fname = NULL;
+  rst_fp = NULL;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static size_t rst_estimate(MeshS *pM)
+ *  \brief Size in bytes of the arrays in a restart file from this process,
+ *   plus 1 MB for the parameter file and problem-specific data */
+
+static size_t rst_estimate(MeshS *pM)
+{
+  GridS *pG;
+  size_t nbytes = 1048576;
+  int nl,nd;
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if ((pG = pM->Domain[nl][nd].Grid) != NULL) {
+      nbytes += (size_t)(NVAR + 3)*sizeof(Real)*
+        (size_t)(pG->Nx[0]+1)*(size_t)(pG->Nx[1]+1)*(size_t)(pG->Nx[2]+1);
+    }
+  }}
+
+  return nbytes;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void rst_grow(const size_t nbytes)
+ *  \brief Replaces the staging buffer by one of nbytes bytes */
+
+static void rst_grow(const size_t nbytes)
+{
+  free(rst_image);
+  if ((rst_image = (char*)malloc(nbytes)) == NULL)
+    ath_error("[dump_restart]: Error allocating %lu byte staging buffer\n",
+      (unsigned long)nbytes);
+  rst_cap = nbytes;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void *rst_writer(void *arg)
+ *  \brief Writes the staging buffer to the restart file and closes it.  Runs
+ *   in the background thread, so must not call ath_error(); errors are
+ *   reported by rst_wait(). */
+
+static void *rst_writer(void *arg)
+{
+  if (fwrite(rst_image, 1, rst_size, rst_fp) != rst_size) rst_werr = 1;
+  if (fclose(rst_fp) != 0) rst_werr = 1;
+  return NULL;
+}
+#endif /* ASYNC_RESTART */
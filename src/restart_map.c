@@ -0,0 +1,225 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file restart_map.c
+ *  \brief Index of the fields in a restart file, and a reader that maps the
+ *   file into memory.
+ *
+ * PURPOSE: Index of the fields in a restart file, and a reader that maps the
+ *   file into memory.  dump_restart() records the offset of the data of each
+ *   field (DENSITY, 1-MOMENTUM, ..., for each Domain) as it writes it, and
+ *   appends the index to the end of the file, after the problem-specific
+ *   data.  The text labels and the data before the index are unchanged, so
+ *   the file can still be read sequentially.  Compressed restart files and
+ *   those written with MPIIO_RESTART have no index.
+ *
+ *   The index is the label INDEX on a line of its own, followed by the
+ *   number of entries (int) and, for each entry:
+ *     char name[RST_NAMELEN]  label of the field in the file, e.g. "DENSITY"
+ *     int level, domain       Domain of the field, -1 for N_STEP, TIME, ...
+ *     int elsize              size of each element in bytes
+ *     int n[3]                number of elements in x1, x2 and x3
+ *     long long offset        offset of the data from the start of the file
+ *   The file ends with the offset of the number of entries (long long) and
+ *   the 8 characters RST_MAGIC, so a reader finds the index from the end of
+ *   the file.  All values are in the byte order of the machine that wrote
+ *   the file.
+ *
+ *   ath_rstmap_open() maps a file with mmap(), and ath_rstmap_field() then
+ *   returns a pointer to the data of any field in the mapping, without
+ *   reading or copying the rest of the file.  Only the pages that are used
+ *   are read from disk.  The data follows text labels, so the pointers need
+ *   not be aligned for the type of the elements; copy them out with memcpy().
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - ath_rstidx_add()   - records the offset of a field being written
+ * - ath_rstidx_write() - appends the index to the file and frees it
+ * - ath_rstmap_open()  - maps a restart file with an index into memory
+ * - ath_rstmap_field() - returns a pointer to the data of a field
+ * - ath_rstmap_close() - unmaps the file				      */
+/*============================================================================*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_rstidx_add(RstIndexS *idx, FILE *fp, const char *name,
+ *                          const int nl, const int nd, const int elsize,
+ *                          const int n1, const int n2, const int n3)
+ *  \brief Adds field name of Domain nd on level nl to the index, with its data
+ *   starting at the current position of fp */
+
+void ath_rstidx_add(RstIndexS *idx, FILE *fp, const char *name, const int nl,
+                    const int nd, const int elsize, const int n1, const int n2,
+                    const int n3)
+{
+  RstFieldS *pf;
+
+  if (idx->nfield == idx->cap) {
+    idx->cap = (idx->cap == 0 ? 64 : 2*idx->cap);
+    if ((idx->field = (RstFieldS*)realloc(idx->field,
+                                          idx->cap*sizeof(RstFieldS))) == NULL)
+      ath_error("[ath_rstidx_add]: malloc failed for restart index\n");
+  }
+  pf = &(idx->field[idx->nfield++]);
+  memset(pf->name, 0, RST_NAMELEN);
+  strncpy(pf->name, name, RST_NAMELEN-1);
+  pf->level = nl;
+  pf->domain = nd;
+  pf->elsize = elsize;
+  pf->n[0] = n1;
+  pf->n[1] = n2;
+  pf->n[2] = n3;
+  pf->offset = (long long)ftell(fp);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_rstidx_write(RstIndexS *idx, FILE *fp)
+ *  \brief Writes the index at the current position of fp, which must be the
+ *   end of the restart file, and frees it */
+
+void ath_rstidx_write(RstIndexS *idx, FILE *fp)
+{
+  RstFieldS *pf;
+  long long start;
+  int n;
+
+  fprintf(fp,"\nINDEX\n");
+  start = (long long)ftell(fp);
+  fwrite(&(idx->nfield),sizeof(int),1,fp);
+  for (n=0; n<idx->nfield; n++) {
+    pf = &(idx->field[n]);
+    fwrite(pf->name,1,RST_NAMELEN,fp);
+    fwrite(&(pf->level),sizeof(int),1,fp);
+    fwrite(&(pf->domain),sizeof(int),1,fp);
+    fwrite(&(pf->elsize),sizeof(int),1,fp);
+    fwrite(pf->n,sizeof(int),3,fp);
+    fwrite(&(pf->offset),sizeof(long long),1,fp);
+  }
+  fwrite(&start,sizeof(long long),1,fp);
+  fwrite(RST_MAGIC,1,8,fp);
+
+  free(idx->field);
+  idx->field = NULL;
+  idx->nfield = idx->cap = 0;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn RstMapS *ath_rstmap_open(const char *fname)
+ *  \brief Maps the restart file fname into memory and reads its index.
+ *   Returns NULL if the file cannot be mapped or has no index (e.g. it is
+ *   compressed), so the caller can read it sequentially instead. */
+
+RstMapS *ath_rstmap_open(const char *fname)
+{
+  RstMapS *rm;
+  struct stat st;
+  const char *p;
+  long long start;
+  int fd, n;
+
+  if ((fd = open(fname, O_RDONLY)) < 0) return NULL;
+  if (fstat(fd, &st) != 0 || st.st_size < 16 + (off_t)sizeof(int)) {
+    close(fd);
+    return NULL;
+  }
+  if ((rm = (RstMapS*)calloc(1,sizeof(RstMapS))) == NULL)
+    ath_error("[ath_rstmap_open]: malloc failed for RstMapS\n");
+  rm->size = (size_t)st.st_size;
+  rm->base = (char*)mmap(NULL, rm->size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (rm->base == (char*)MAP_FAILED) {
+    free(rm);
+    return NULL;
+  }
+
+/* Find the index from the end of the file, and check that it fits */
+
+  if (memcmp(rm->base + rm->size - 8, RST_MAGIC, 8) != 0) {
+    ath_rstmap_close(rm);
+    return NULL;
+  }
+  memcpy(&start, rm->base + rm->size - 16, sizeof(long long));
+  if (start < 0 || start + (long long)sizeof(int) > (long long)rm->size - 16) {
+    ath_rstmap_close(rm);
+    return NULL;
+  }
+  p = rm->base + start;
+  memcpy(&(rm->nfield), p, sizeof(int));
+  p += sizeof(int);
+  if (rm->nfield < 0 || (long long)rm->nfield*RST_ENTRYLEN !=
+      (long long)rm->size - 16 - start - (long long)sizeof(int)) {
+    ath_rstmap_close(rm);
+    return NULL;
+  }
+
+  if ((rm->field = (RstFieldS*)calloc(rm->nfield+1,sizeof(RstFieldS))) == NULL)
+    ath_error("[ath_rstmap_open]: malloc failed for restart index\n");
+  for (n=0; n<rm->nfield; n++) {
+    memcpy(rm->field[n].name, p, RST_NAMELEN);
+    rm->field[n].name[RST_NAMELEN-1] = '\0';
+    p += RST_NAMELEN;
+    memcpy(&(rm->field[n].level),  p, sizeof(int));  p += sizeof(int);
+    memcpy(&(rm->field[n].domain), p, sizeof(int));  p += sizeof(int);
+    memcpy(&(rm->field[n].elsize), p, sizeof(int));  p += sizeof(int);
+    memcpy(rm->field[n].n, p, 3*sizeof(int));        p += 3*sizeof(int);
+    memcpy(&(rm->field[n].offset), p, sizeof(long long));
+    p += sizeof(long long);
+  }
+
+  return rm;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn const void *ath_rstmap_field(const RstMapS *rm, const char *name,
+ *                                   const int nl, const int nd,
+ *                                   const RstFieldS **ppf)
+ *  \brief Returns a pointer to the data of field name of Domain nd on level
+ *   nl (-1 for global data) in the mapped file, and its index entry in *ppf
+ *   if ppf is not NULL.  Returns NULL if the file has no such field. */
+
+const void *ath_rstmap_field(const RstMapS *rm, const char *name, const int nl,
+                             const int nd, const RstFieldS **ppf)
+{
+  const RstFieldS *pf;
+  long long nbytes;
+  int n;
+
+  for (n=0; n<rm->nfield; n++) {
+    pf = &(rm->field[n]);
+    if (pf->level != nl || pf->domain != nd || strcmp(pf->name, name) != 0)
+      continue;
+    nbytes = (long long)pf->elsize*pf->n[0]*pf->n[1]*pf->n[2];
+    if (pf->offset < 0 || pf->offset + nbytes > (long long)rm->size)
+      ath_error("[ath_rstmap_field]: %s of level %d domain %d is past the end of the file\n",
+                name,nl,nd);
+    if (ppf != NULL) *ppf = pf;
+    return (const void*)(rm->base + pf->offset);
+  }
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_rstmap_close(RstMapS *rm)
+ *  \brief Unmaps the file and frees rm */
+
+void ath_rstmap_close(RstMapS *rm)
+{
+  munmap(rm->base, rm->size);
+  free(rm->field);
+  free(rm);
+  return;
+}
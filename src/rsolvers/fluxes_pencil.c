@@ -0,0 +1,54 @@
+#include "../copyright.h"
+/*============================================================================*/
+/*! \file fluxes_pencil.c
+ *  \brief Computes 1D fluxes along a pencil of interfaces by calling fluxes()
+ *   once per interface.
+ *
+ * PURPOSE: Computes 1D fluxes along a pencil of interfaces by calling fluxes()
+ *   once per interface.  Used with every Riemann solver that does not provide
+ *   its own vectorized fluxes_pencil() (see VECTOR_PENCIL_FLUXES in
+ *   rsolvers/prototypes.h).
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - fluxes_pencil() - fluxes at interfaces il..iu of a pencil */
+/*============================================================================*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../defs.h"
+#include "../athena.h"
+#include "../globals.h"
+#include "prototypes.h"
+#include "../prototypes.h"
+
+#ifndef VECTOR_PENCIL_FLUXES
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *            const Cons1DS Ul[], const Cons1DS Ur[],
+ *            const Prim1DS Wl[], const Prim1DS Wr[],
+ *            const Real Bxi[], Cons1DS Flux[])
+ *  \brief Computes 1D fluxes at interfaces il..iu
+ *   Input Arguments:
+ *  -  il,iu = range of interfaces
+ *  -  Bxi = B in direction of 1D slice at each cell interface
+ *  -  Ul,Ur = L/R-states of CONSERVED variables at each cell interface
+ *  -  Wl,Wr = L/R-states of PRIMITIVE variables at each cell interface
+ *   Output Arguments:
+ *  -  Flux = fluxes of CONSERVED variables at each cell interface
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS Ul[], const Cons1DS Ur[],
+                   const Prim1DS Wl[], const Prim1DS Wr[],
+                   const Real Bxi[], Cons1DS Flux[])
+{
+  int i;
+
+  for (i=il; i<=iu; i++) {
+    fluxes(Ul[i],Ur[i],Wl[i],Wr[i],Bxi[i],&Flux[i]);
+  }
+
+  return;
+}
+#endif /* VECTOR_PENCIL_FLUXES */
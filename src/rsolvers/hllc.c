@@ -247,5 +247,182 @@ void fluxes(const Cons1DS Ul, const Cons1DS Ur,
 
   return;
 }
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *            const Cons1DS Ul[], const Cons1DS Ur[],
+ *            const Prim1DS Wl[], const Prim1DS Wr[],
+ *            const Real Bxi[], Cons1DS Flux[])
+ *  \brief HLLC fluxes at interfaces il..iu of a pencil.
+ *
+ * Gives the same fluxes as calling fluxes() at each interface, processing
+ * NPENCIL interfaces at a time with one array per variable (see hlle.c).  The
+ * branches on the contact speed are replaced by selects between both sides.
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS Ul[], const Cons1DS Ur[],
+                   const Prim1DS Wl[], const Prim1DS Wr[],
+                   const Real Bxi[], Cons1DS Flux[])
+{
+  const int nw = (int)(sizeof(Prim1DS)/sizeof(Real));
+  const int nf = (int)(sizeof(Cons1DS)/sizeof(Real));
+  Real wl[sizeof(Prim1DS)/sizeof(Real)][NPENCIL];
+  Real wr[sizeof(Prim1DS)/sizeof(Real)][NPENCIL];
+  Real ul[NWAVE][NPENCIL], ur[NWAVE][NPENCIL];
+  Real f[sizeof(Cons1DS)/sizeof(Real)][NPENCIL], cpw[NPENCIL];
+  Real sqrtdl,sqrtdr,isdlpdr,v1roe,v2roe,v3roe,cf;
+#ifndef ISOTHERMAL
+  Real hroe,vsq,asq;
+#endif
+  Real cfl,cfr,bp,bm,tmp,al,ar,am,cp,tl,tr,sdl,sdr,sl,sm,sr,vl,vr;
+  const Real *dl = wl[0], *dr = wr[0];
+  const Real *vxl = wl[1], *vxr = wr[1];
+  const Real *vyl = wl[2], *vyr = wr[2];
+  const Real *vzl = wl[3], *vzr = wr[3];
+#ifndef ISOTHERMAL
+  const Real *pl = wl[4], *pr = wr[4];
+#endif
+  int i,m,n,nb;
+
+  for (i=il; i<=iu; i+=NPENCIL) {
+    nb = MIN(NPENCIL, iu-i+1);
+
+/* Transpose the L/R states into one array per variable */
+
+    for (m=0; m<nb; m++) {
+      const Real *pwl = (const Real *)&(Wl[i+m]);
+      const Real *pwr = (const Real *)&(Wr[i+m]);
+      const Real *pul = (const Real *)&(Ul[i+m]);
+      const Real *pur = (const Real *)&(Ur[i+m]);
+      for (n=0; n<nw; n++) {
+        wl[n][m] = pwl[n];
+        wr[n][m] = pwr[n];
+      }
+      for (n=0; n<NWAVE; n++) {
+        ul[n][m] = pul[n];
+        ur[n][m] = pur[n];
+      }
+    }
+
+    for (m=0; m<nb; m++) {
+
+/* Roe-averaged data and eigenvalues, as in Steps 2-3 of fluxes() */
+
+      sqrtdl = sqrt((double)dl[m]);
+      sqrtdr = sqrt((double)dr[m]);
+      isdlpdr = 1.0/(sqrtdl + sqrtdr);
+
+      v1roe = (sqrtdl*vxl[m] + sqrtdr*vxr[m])*isdlpdr;
+      v2roe = (sqrtdl*vyl[m] + sqrtdr*vyr[m])*isdlpdr;
+      v3roe = (sqrtdl*vzl[m] + sqrtdr*vzr[m])*isdlpdr;
+
+#ifdef ISOTHERMAL
+      cf = Iso_csound;
+#else
+      hroe = ((ul[4][m] + pl[m])/sqrtdl + (ur[4][m] + pr[m])/sqrtdr)*isdlpdr;
+      vsq = v1roe*v1roe + v2roe*v2roe + v3roe*v3roe;
+      asq = Gamma_1*MAX((hroe-0.5*vsq), TINY_NUMBER);
+      cf = sqrt(asq);
+#endif
+
+/* Max and min wave speeds, as in Step 4 */
+
+#ifdef ISOTHERMAL
+      cfl = cfr = Iso_csound;
+#else
+      cfl = sqrt((double)(Gamma*pl[m]/dl[m]));
+      cfr = sqrt((double)(Gamma*pr[m]/dr[m]));
+#endif
+
+      ar = MAX((v1roe + cf),(vxr[m] + cfr));
+      al = MIN((v1roe - cf),(vxl[m] - cfl));
+
+      bp = ar > 0.0 ? ar : 0.0;
+      bm = al < 0.0 ? al : 0.0;
+
+/* Contact wave speed and pressure, as in Step 5 */
+
+#ifdef ISOTHERMAL
+      tl = dl[m]*Iso_csound2 + (vxl[m] - al)*ul[1][m];
+      tr = dr[m]*Iso_csound2 + (vxr[m] - ar)*ur[1][m];
+#else
+      tl = pl[m] + (vxl[m] - al)*ul[1][m];
+      tr = pr[m] + (vxr[m] - ar)*ur[1][m];
+#endif
+
+      sdl =   ul[1][m] - ul[0][m]*al;
+      sdr = -(ur[1][m] - ur[0][m]*ar);
+
+      tmp = 1.0/(sdl + sdr);
+      am = (tl - tr)*tmp;
+      cp = (sdl*tr + sdr*tl)*tmp;
+      cpw[m] = cp;
+      cp = cp > 0.0 ? cp : 0.0;
+
+/* Flux weights, as in Step 7 */
+
+      sl = am >= 0.0 ?  am/(am - bm) : 0.0;
+      sr = am >= 0.0 ?  0.0          : -am/(bp - am);
+      sm = am >= 0.0 ? -bm/(am - bm) : bp/(bp - am);
+
+/* HLLC flux from the L/R fluxes along bm, bp, as in Steps 6 and 8 */
+
+      vl = vxl[m] - bm;
+      vr = vxr[m] - bp;
+
+      f[0][m] = sl*(ul[1][m] - bm*ul[0][m]) + sr*(ur[1][m] - bp*ur[0][m]);
+#ifdef ISOTHERMAL
+      f[1][m] = sl*(ul[1][m]*vl + dl[m]*Iso_csound2)
+              + sr*(ur[1][m]*vr + dr[m]*Iso_csound2);
+#else
+      f[1][m] = sl*(ul[1][m]*vl + pl[m]) + sr*(ur[1][m]*vr + pr[m]);
+#endif
+      f[2][m] = sl*(ul[2][m]*vl) + sr*(ur[2][m]*vr);
+      f[3][m] = sl*(ul[3][m]*vl) + sr*(ur[3][m]*vr);
+#ifndef ISOTHERMAL
+      f[4][m] = sl*(ul[4][m]*vl + pl[m]*vxl[m])
+              + sr*(ur[4][m]*vr + pr[m]*vxr[m]);
+#endif
+
+      f[1][m] += sm*cp;
+#ifndef ISOTHERMAL
+      f[4][m] += sm*cp*am;
+#endif
+
+/* Fluxes of passively advected scalars, computed from density flux */
+#if (NSCALARS > 0)
+      for (n=0; n<NSCALARS; n++) {
+        f[NWAVE+n][m] = f[0][m]*(f[0][m] >= 0.0 ? wl[NWAVE+n][m] :
+                                                  wr[NWAVE+n][m]);
+      }
+#endif
+
+#ifdef CYLINDRICAL
+#ifndef ISOTHERMAL
+      f[NWAVE+NSCALARS][m] = al > 0.0 ? pl[m] : (ar < 0.0 ? pr[m] : cp);
+#else
+      f[NWAVE+NSCALARS][m] = al > 0.0 ? dl[m]*Iso_csound2 :
+        (ar < 0.0 ? dr[m]*Iso_csound2 :
+          (am >= 0.0 ? dl[m]*(al-vxl[m])/(al-am) : dr[m]*(ar-vxr[m])/(ar-am)));
+#endif /* ISOTHERMAL */
+#endif /* CYLINDRICAL */
+    }
+
+    for (m=0; m<nb; m++) {
+      if(cpw[m] < 0.0)
+        ath_perr(1,"[hllc flux]: Contact Pressure = %g\n",cpw[m]);
+    }
+
+/* Transpose the fluxes back */
+
+    for (m=0; m<nb; m++) {
+      Real *pf = (Real *)&(Flux[i+m]);
+      for (n=0; n<nf; n++) pf[n] = f[n][m];
+    }
+  }
+
+  return;
+}
 #endif /* SPECIAL_RELATIVITY */
 #endif /* HLLC_FLUX */
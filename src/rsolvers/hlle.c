@@ -269,4 +269,277 @@ void HLLE_FUNCTION(const Cons1DS Ul, const Cons1DS Ur,
   return;
 }
 #endif /* HLLE_FLUX */
+
+#ifdef HLLE_FLUX
+/*----------------------------------------------------------------------------*/
+/*! \fn void fluxes_pencil(const int il, const int iu,
+ *            const Cons1DS Ul[], const Cons1DS Ur[],
+ *            const Prim1DS Wl[], const Prim1DS Wr[],
+ *            const Real Bxi[], Cons1DS Flux[])
+ *  \brief HLLE fluxes at interfaces il..iu of a pencil.
+ *
+ * Gives the same fluxes as calling fluxes() at each interface.  Interfaces
+ * are processed NPENCIL at a time: the L/R states are transposed into one
+ * array per variable, the wave speeds and fluxes are computed in loops with
+ * no function calls or branches so the compiler can vectorize them, and the
+ * fluxes are transposed back.  Only the fastest Roe eigenvalues are needed,
+ * so they are computed here rather than with the esys_roe_*() functions.
+ */
+
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS Ul[], const Cons1DS Ur[],
+                   const Prim1DS Wl[], const Prim1DS Wr[],
+                   const Real Bxi[], Cons1DS Flux[])
+{
+  const int nw = (int)(sizeof(Prim1DS)/sizeof(Real));
+  const int nf = (int)(sizeof(Cons1DS)/sizeof(Real));
+  Real wl[sizeof(Prim1DS)/sizeof(Real)][NPENCIL];
+  Real wr[sizeof(Prim1DS)/sizeof(Real)][NPENCIL];
+  Real ul[NWAVE][NPENCIL], ur[NWAVE][NPENCIL];
+  Real f[sizeof(Cons1DS)/sizeof(Real)][NPENCIL];
+  Real sqrtdl,sqrtdr,isdlpdr,droe,v1roe,v2roe,v3roe,pbl=0.0,pbr=0.0;
+  Real asq,vaxsq=0.0,qsq,cfsq,cfl,cfr,bp,bm,ct2=0.0,tmp,cf,evl,evr;
+  Real fl,fr,al,ar,vl,vr;
+#ifndef ISOTHERMAL
+  Real hroe;
+#endif
+#ifdef HYDRO
+#ifndef ISOTHERMAL
+  Real vsq;
+#endif
+#endif
+#ifdef MHD
+  Real bx[NPENCIL];
+  Real b2roe,b3roe,x,y,di,btsq,bt_starsq,tsum,tdif;
+#ifndef ISOTHERMAL
+  Real vsq,hp;
+#endif
+#endif
+  const Real *dl = wl[0], *dr = wr[0];
+  const Real *vxl = wl[1], *vxr = wr[1];
+  const Real *vyl = wl[2], *vyr = wr[2];
+  const Real *vzl = wl[3], *vzr = wr[3];
+#ifndef ISOTHERMAL
+  const Real *pl = wl[4], *pr = wr[4];
+#endif
+#ifdef MHD
+  const Real *byl = wl[NWAVE-2], *byr = wr[NWAVE-2];
+  const Real *bzl = wl[NWAVE-1], *bzr = wr[NWAVE-1];
+#endif
+  int i,m,n,nb;
+
+  for (i=il; i<=iu; i+=NPENCIL) {
+    nb = MIN(NPENCIL, iu-i+1);
+
+/* Transpose the L/R states into one array per variable */
+
+    for (m=0; m<nb; m++) {
+      const Real *pwl = (const Real *)&(Wl[i+m]);
+      const Real *pwr = (const Real *)&(Wr[i+m]);
+      const Real *pul = (const Real *)&(Ul[i+m]);
+      const Real *pur = (const Real *)&(Ur[i+m]);
+      for (n=0; n<nw; n++) {
+        wl[n][m] = pwl[n];
+        wr[n][m] = pwr[n];
+      }
+      for (n=0; n<NWAVE; n++) {
+        ul[n][m] = pul[n];
+        ur[n][m] = pur[n];
+      }
+#ifdef MHD
+      bx[m] = Bxi[i+m];
+#endif
+    }
+
+    for (m=0; m<nb; m++) {
+
+/* Roe-averaged data, as in Step 2 of fluxes() */
+
+      sqrtdl = sqrt((double)dl[m]);
+      sqrtdr = sqrt((double)dr[m]);
+      isdlpdr = 1.0/(sqrtdl + sqrtdr);
+
+      droe  = sqrtdl*sqrtdr;
+      v1roe = (sqrtdl*vxl[m] + sqrtdr*vxr[m])*isdlpdr;
+      v2roe = (sqrtdl*vyl[m] + sqrtdr*vyr[m])*isdlpdr;
+      v3roe = (sqrtdl*vzl[m] + sqrtdr*vzr[m])*isdlpdr;
+
+#ifdef MHD
+      b2roe = (sqrtdr*byl[m] + sqrtdl*byr[m])*isdlpdr;
+      b3roe = (sqrtdr*bzl[m] + sqrtdl*bzr[m])*isdlpdr;
+      x = 0.5*(SQR(byl[m] - byr[m]) + SQR(bzl[m] - bzr[m]))/
+        (SQR(sqrtdl + sqrtdr));
+      y = 0.5*(dl[m] + dr[m])/droe;
+      pbl = 0.5*(SQR(bx[m]) + SQR(byl[m]) + SQR(bzl[m]));
+      pbr = 0.5*(SQR(bx[m]) + SQR(byr[m]) + SQR(bzr[m]));
+#endif
+
+#ifndef ISOTHERMAL
+      hroe  = ((ul[4][m] + pl[m] + pbl)/sqrtdl +
+               (ur[4][m] + pr[m] + pbr)/sqrtdr)*isdlpdr;
+#endif
+
+/* Fastest Roe eigenvalues, as in esys_roe_*() in esystem_roe.c */
+
+#ifdef HYDRO
+#ifdef ISOTHERMAL
+      cf = Iso_csound;
+#else
+      vsq = v1roe*v1roe + v2roe*v2roe + v3roe*v3roe;
+      asq = Gamma_1*MAX((hroe-0.5*vsq), TINY_NUMBER);
+      cf = sqrt(asq);
+#endif /* ISOTHERMAL */
+#endif /* HYDRO */
+
+#ifdef MHD
+      di = 1.0/droe;
+      btsq = b2roe*b2roe + b3roe*b3roe;
+      vaxsq = bx[m]*bx[m]*di;
+#ifdef ISOTHERMAL
+      bt_starsq = btsq*y;
+      asq = Iso_csound2 + x;
+#else
+      vsq = v1roe*v1roe + v2roe*v2roe + v3roe*v3roe;
+      bt_starsq = (Gamma_1 - Gamma_2*y)*btsq;
+      hp = hroe - (vaxsq + btsq*di);
+      asq = MAX((Gamma_1*(hp-0.5*vsq)-Gamma_2*x), TINY_NUMBER);
+#endif /* ISOTHERMAL */
+      ct2 = bt_starsq*di;
+      tsum = vaxsq + ct2 + asq;
+      tdif = vaxsq + ct2 - asq;
+      cfsq = 0.5*(tsum + sqrt((double)(tdif*tdif + 4.0*asq*ct2)));
+      cf = sqrt((double)cfsq);
+#endif /* MHD */
+
+      evl = v1roe - cf;
+      evr = v1roe + cf;
+
+/* Max and min wave speeds, as in Step 4 of fluxes() */
+
+#ifdef ISOTHERMAL
+      asq = Iso_csound2;
+#else
+      asq = Gamma*pl[m]/dl[m];
+#endif
+#ifdef MHD
+      vaxsq = bx[m]*bx[m]/dl[m];
+      ct2 = (ul[NWAVE-2][m]*ul[NWAVE-2][m] + ul[NWAVE-1][m]*ul[NWAVE-1][m])/dl[m];
+#endif
+      qsq = vaxsq + ct2 + asq;
+      tmp = vaxsq + ct2 - asq;
+      cfsq = 0.5*(qsq + sqrt((double)(tmp*tmp + 4.0*asq*ct2)));
+      cfl = sqrt((double)cfsq);
+
+#ifdef ISOTHERMAL
+      asq = Iso_csound2;
+#else
+      asq = Gamma*pr[m]/dr[m];
+#endif
+#ifdef MHD
+      vaxsq = bx[m]*bx[m]/dr[m];
+      ct2 = (ur[NWAVE-2][m]*ur[NWAVE-2][m] + ur[NWAVE-1][m]*ur[NWAVE-1][m])/dr[m];
+#endif
+      qsq = vaxsq + ct2 + asq;
+      tmp = vaxsq + ct2 - asq;
+      cfsq = 0.5*(qsq + sqrt((double)(tmp*tmp + 4.0*asq*ct2)));
+      cfr = sqrt((double)cfsq);
+
+      ar = MAX(evr,(vxr[m] + cfr));
+      al = MIN(evl,(vxl[m] - cfl));
+
+      bp = MAX(ar, 0.0);
+      bm = MIN(al, 0.0);
+
+/* L/R fluxes along the lines bm/bp and the HLLE flux, as in Steps 5-6 */
+
+      tmp = 0.5*(bp + bm)/(bp - bm);
+      vl = vxl[m] - bm;
+      vr = vxr[m] - bp;
+
+      fl = ul[1][m] - bm*ul[0][m];
+      fr = ur[1][m] - bp*ur[0][m];
+      f[0][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+
+      fl = ul[1][m]*vl;
+      fr = ur[1][m]*vr;
+#ifdef ISOTHERMAL
+      fl += dl[m]*Iso_csound2;
+      fr += dr[m]*Iso_csound2;
+#else
+      fl += pl[m];
+      fr += pr[m];
+#endif
+#ifdef MHD
+      fl -= 0.5*(bx[m]*bx[m] - SQR(byl[m]) - SQR(bzl[m]));
+      fr -= 0.5*(bx[m]*bx[m] - SQR(byr[m]) - SQR(bzr[m]));
+#endif
+      f[1][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+
+      fl = ul[2][m]*vl;
+      fr = ur[2][m]*vr;
+#ifdef MHD
+      fl -= bx[m]*byl[m];
+      fr -= bx[m]*byr[m];
+#endif
+      f[2][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+
+      fl = ul[3][m]*vl;
+      fr = ur[3][m]*vr;
+#ifdef MHD
+      fl -= bx[m]*bzl[m];
+      fr -= bx[m]*bzr[m];
+#endif
+      f[3][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+
+#ifndef ISOTHERMAL
+      fl = ul[4][m]*vl + pl[m]*vxl[m];
+      fr = ur[4][m]*vr + pr[m]*vxr[m];
+#ifdef MHD
+      fl += (pbl*vxl[m] - bx[m]*(bx[m]*vxl[m] + byl[m]*vyl[m] + bzl[m]*vzl[m]));
+      fr += (pbr*vxr[m] - bx[m]*(bx[m]*vxr[m] + byr[m]*vyr[m] + bzr[m]*vzr[m]));
+#endif
+      f[4][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+#endif /* ISOTHERMAL */
+
+#ifdef MHD
+      fl = byl[m]*vl - bx[m]*vyl[m];
+      fr = byr[m]*vr - bx[m]*vyr[m];
+      f[NWAVE-2][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+
+      fl = bzl[m]*vl - bx[m]*vzl[m];
+      fr = bzr[m]*vr - bx[m]*vzr[m];
+      f[NWAVE-1][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+#endif /* MHD */
+
+/* Fluxes of passively advected scalars, computed from density flux */
+#if (NSCALARS > 0)
+      for (n=0; n<NSCALARS; n++) {
+        f[NWAVE+n][m] = f[0][m]*(f[0][m] >= 0.0 ? wl[NWAVE+n][m] :
+                                                  wr[NWAVE+n][m]);
+      }
+#endif
+
+#ifdef CYLINDRICAL
+#ifndef ISOTHERMAL
+      fl = pl[m] + pbl;
+      fr = pr[m] + pbr;
+#else
+      fl = 0.0;
+      fr = 0.0;
+#endif /* ISOTHERMAL */
+      f[NWAVE+NSCALARS][m] = 0.5*(fl + fr) + (fl - fr)*tmp;
+#endif /* CYLINDRICAL */
+    }
+
+/* Transpose the fluxes back */
+
+    for (m=0; m<nb; m++) {
+      Real *pf = (Real *)&(Flux[i+m]);
+      for (n=0; n<nf; n++) pf[n] = f[n][m];
+    }
+  }
+
+  return;
+}
+#endif /* HLLE_FLUX */
 #endif
@@ -31,11 +31,78 @@ void esys_roe_adb_mhd(const Real d, const Real v1, const Real v2,
   const Real x, const Real y, Real eigenvalues[],
   Real right_eigenmatrix[][7], Real left_eigenmatrix[][7]);
 
-/* All of the Riemann solvers in this directory contain the same function name
- */
+/* All of the Riemann solvers in this directory contain the same function name.
+ * With RUNTIME_SOLVERS each is compiled once with fluxes() and fluxes_pencil()
+ * renamed fluxes_<solver>() and fluxes_pencil_<solver>() (see Makefile.in),
+ * and everywhere else they are pointers set in runtime_solvers.c. */
+#if defined(RUNTIME_SOLVERS) && !defined(RUNTIME_VARIANT)
+extern FluxFun_t fluxes;
+#else
 void fluxes(const Cons1DS Ul, const Cons1DS Ur,
             const Prim1DS Wl, const Prim1DS Wr,
             const Real Bxi, Cons1DS *pF);
+#endif
+
+/* fluxes() at interfaces il..iu of a pencil.  The HLLE and HLLC solvers
+ * provide vectorized versions that process NPENCIL interfaces at a time;
+ * fluxes_pencil.c loops over fluxes() for all others. */
+#define NPENCIL 64
+#if !defined(SPECIAL_RELATIVITY) && (defined(HLLE_FLUX) || defined(HLLC_FLUX))
+#define VECTOR_PENCIL_FLUXES
+#endif
+#if defined(RUNTIME_SOLVERS) && !defined(RUNTIME_VARIANT)
+extern FluxPencilFun_t fluxes_pencil;
+#else
+void fluxes_pencil(const int il, const int iu,
+                   const Cons1DS Ul[], const Cons1DS Ur[],
+                   const Prim1DS Wl[], const Prim1DS Wr[],
+                   const Real Bxi[], Cons1DS Flux[]);
+#endif
+
+#ifdef RUNTIME_SOLVERS
+/* the variants of the Riemann solvers compiled with RUNTIME_SOLVERS */
+void fluxes_roe(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+void fluxes_pencil_roe(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+void fluxes_hlle(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+void fluxes_pencil_hlle(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+void fluxes_force(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+void fluxes_pencil_force(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+#ifdef HYDRO
+void fluxes_hllc(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+void fluxes_pencil_hllc(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+void fluxes_exact(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+void fluxes_pencil_exact(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+#ifdef ISOTHERMAL
+void fluxes_two_shock(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+void fluxes_pencil_two_shock(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+#endif
+#endif /* HYDRO */
+#ifdef MHD
+void fluxes_hlld(const Cons1DS Ul, const Cons1DS Ur,
+  const Prim1DS Wl, const Prim1DS Wr, const Real Bxi, Cons1DS *pF);
+void fluxes_pencil_hlld(const int il, const int iu,
+  const Cons1DS Ul[], const Cons1DS Ur[], const Prim1DS Wl[],
+  const Prim1DS Wr[], const Real Bxi[], Cons1DS Flux[]);
+#endif
+#endif /* RUNTIME_SOLVERS */
 
 #ifdef SPECIAL_RELATIVITY
 void entropy_flux (const Cons1DS Ul, const Cons1DS Ur,
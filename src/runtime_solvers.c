@@ -0,0 +1,212 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file runtime_solvers.c
+ *  \brief Chooses the flux function, reconstruction and unsplit integrator at
+ *   runtime.
+ *
+ * PURPOSE: Chooses the flux function, reconstruction and unsplit integrator at
+ *   runtime from <job>flux, <job>order and <job>integrator in the input file,
+ *   with the values given to configure as defaults.  Only used when Athena is
+ *   configured with --enable-runtime-solvers, in which case every flux
+ *   function, reconstruction and integrator that works with the physics is
+ *   compiled into the executable under its own name (see the Makefile.in in
+ *   rsolvers/, reconstruction/ and integrators/).
+ *
+ *   fluxes(), fluxes_pencil() and lr_states() are then pointers to the chosen
+ *   variants.  fluxes() is called once per interface and the others once per
+ *   pencil, so the indirect call costs no more than the call to a function in
+ *   another file that the integrators make anyway.  Each variant is compiled with the same
+ *   macros as the equivalent static build, so gives bitwise identical results.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - runtime_solvers_init()   - reads <job> block and sets function pointers
+ * - runtime_ctu_integrator() - returns 1 if the CTU integrator was chosen
+ * - lr_states_init()         - calls lr_states_init() of the chosen variant
+ * - lr_states_destruct()     - calls lr_states_destruct() of chosen variant */
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+
+#ifdef RUNTIME_SOLVERS
+
+FluxFun_t fluxes = NULL;
+FluxPencilFun_t fluxes_pencil = NULL;
+LRStatesFun_t lr_states = NULL;
+
+/* init and destruct functions of the chosen reconstruction, and integrator */
+static void (*lr_init)(MeshS *pM) = NULL;
+static void (*lr_destruct)(void) = NULL;
+static int ctu_integrator = 1;
+
+/*! \struct FluxEntry
+ *  \brief A flux function compiled into the executable.  hll is 1 for the
+ *   fluxes with which lr_states() subtracts waves moving in both directions */
+typedef struct FluxEntry_s{
+  char *name;
+  FluxFun_t fluxes;
+  FluxPencilFun_t fluxes_pencil;
+  int hll;
+}FluxEntry;
+
+static FluxEntry FluxTable[] = {
+  {"roe",       fluxes_roe,       fluxes_pencil_roe,       0},
+  {"hlle",      fluxes_hlle,      fluxes_pencil_hlle,      1},
+#ifdef HYDRO
+  {"hllc",      fluxes_hllc,      fluxes_pencil_hllc,      1},
+  {"exact",     fluxes_exact,     fluxes_pencil_exact,     0},
+#ifdef ISOTHERMAL
+  {"two-shock", fluxes_two_shock, fluxes_pencil_two_shock, 0},
+#endif
+#endif /* HYDRO */
+#ifdef MHD
+  {"hlld",      fluxes_hlld,      fluxes_pencil_hlld,      1},
+#endif
+  {"force",     fluxes_force,     fluxes_pencil_force,     1}
+};
+
+/*! \struct OrderEntry
+ *  \brief A variant of a reconstruction compiled into the executable, for
+ *   the integrator given (NULL for either), and with hll=0 or 1 for the type of
+ *   flux function (-1 for either) */
+typedef struct OrderEntry_s{
+  char *order;
+  char *integrator;
+  int hll;
+  LRStatesFun_t lr_states;
+  void (*init)(MeshS *pM);
+  void (*destruct)(void);
+}OrderEntry;
+
+static OrderEntry OrderTable[] = {
+  {"1", NULL,  -1,
+   lr_states_dc,            lr_states_init_dc,            lr_states_destruct_dc},
+  {"2", "ctu",  0,
+   lr_states_plm_ctu,       lr_states_init_plm_ctu,       lr_states_destruct_plm_ctu},
+  {"2", "ctu",  1,
+   lr_states_plm_ctu_hll,   lr_states_init_plm_ctu_hll,   lr_states_destruct_plm_ctu_hll},
+  {"3", "ctu",  0,
+   lr_states_ppm_ctu,       lr_states_init_ppm_ctu,       lr_states_destruct_ppm_ctu},
+  {"3", "ctu",  1,
+   lr_states_ppm_ctu_hll,   lr_states_init_ppm_ctu_hll,   lr_states_destruct_ppm_ctu_hll},
+  {"2p","ctu",  0,
+   lr_states_prim2_ctu,     lr_states_init_prim2_ctu,     lr_states_destruct_prim2_ctu},
+  {"2p","ctu",  1,
+   lr_states_prim2_ctu_hll, lr_states_init_prim2_ctu_hll, lr_states_destruct_prim2_ctu_hll},
+  {"2p","vl",  -1,
+   lr_states_prim2_vl,      lr_states_init_prim2_vl,      lr_states_destruct_prim2_vl},
+  {"3p","ctu",  0,
+   lr_states_prim3_ctu,     lr_states_init_prim3_ctu,     lr_states_destruct_prim3_ctu},
+  {"3p","ctu",  1,
+   lr_states_prim3_ctu_hll, lr_states_init_prim3_ctu_hll, lr_states_destruct_prim3_ctu_hll},
+  {"3p","vl",  -1,
+   lr_states_prim3_vl,      lr_states_init_prim3_vl,      lr_states_destruct_prim3_vl}
+};
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void runtime_solvers_init(void)
+ *  \brief Reads <job>flux, <job>order and <job>integrator, checks that they
+ *   can be used together, and sets fluxes(), fluxes_pencil() and lr_states().
+ */
+
+void runtime_solvers_init(void)
+{
+  char *flux, *order, *integrator;
+  int n, nflux=-1, norder=-1;
+  int nf = (int)(sizeof(FluxTable)/sizeof(FluxEntry));
+  int no = (int)(sizeof(OrderTable)/sizeof(OrderEntry));
+
+  flux       = par_gets_def("job","flux",DEFAULT_FLUX);
+  order      = par_gets_def("job","order",DEFAULT_ORDER);
+  integrator = par_gets_def("job","integrator",DEFAULT_INTEGRATOR);
+
+  if (strcmp(integrator,"ctu") == 0) {
+    ctu_integrator = 1;
+  } else if (strcmp(integrator,"vl") == 0) {
+    ctu_integrator = 0;
+  } else {
+    ath_error("[runtime_solvers_init]: <job>integrator=%s, must be ctu or vl\n",
+      integrator);
+  }
+
+  for (n=0; n<nf; n++) if (strcmp(flux,FluxTable[n].name) == 0) nflux = n;
+  if (nflux < 0) {
+    ath_perr(-1,"[runtime_solvers_init]: <job>flux=%s, must be one of:",flux);
+    for (n=0; n<nf; n++) ath_perr(-1," %s",FluxTable[n].name);
+    ath_perr(-1,"\n");
+    ath_error("[runtime_solvers_init]: flux function %s not available\n",flux);
+  }
+
+  for (n=0; n<no; n++) {
+    if (strcmp(order,OrderTable[n].order) != 0) continue;
+    if (OrderTable[n].integrator != NULL &&
+        strcmp(integrator,OrderTable[n].integrator) != 0) continue;
+    if (OrderTable[n].hll >= 0 && OrderTable[n].hll != FluxTable[nflux].hll)
+      continue;
+    norder = n;
+  }
+  if (norder < 0)
+    ath_error("[runtime_solvers_init]: <job>order=%s cannot be used with <job>integrator=%s; use order=1, 2, 3, 2p or 3p with ctu, and 1, 2p or 3p with vl\n",
+      order,integrator);
+
+#ifdef H_CORRECTION
+  if (strcmp(flux,"roe") != 0)
+    ath_error("[runtime_solvers_init]: H-correction only works with Roe flux\n");
+#endif
+#ifdef FIRST_ORDER_FLUX_CORRECTION
+  if (ctu_integrator)
+    ath_error("[runtime_solvers_init]: first-order flux correction only works with VL integrator\n");
+#endif
+
+  fluxes        = FluxTable[nflux].fluxes;
+  fluxes_pencil = FluxTable[nflux].fluxes_pencil;
+  lr_states     = OrderTable[norder].lr_states;
+  lr_init       = OrderTable[norder].init;
+  lr_destruct   = OrderTable[norder].destruct;
+
+  ath_pout(0,"Runtime solvers: flux=%s order=%s integrator=%s\n",
+    flux,order,integrator);
+
+  free(flux);
+  free(order);
+  free(integrator);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int runtime_ctu_integrator(void)
+ *  \brief Returns 1 if <job>integrator=ctu, 0 if vl */
+
+int runtime_ctu_integrator(void)
+{
+  return ctu_integrator;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void lr_states_init(MeshS *pM)
+ *  \brief Allocates the work arrays of the chosen reconstruction */
+
+void lr_states_init(MeshS *pM)
+{
+  if (lr_init == NULL)
+    ath_error("[lr_states_init]: called before runtime_solvers_init()\n");
+  (*lr_init)(pM);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void lr_states_destruct(void)
+ *  \brief Frees the work arrays of the chosen reconstruction */
+
+void lr_states_destruct(void)
+{
+  if (lr_destruct != NULL) (*lr_destruct)();
+  return;
+}
+
+#endif /* RUNTIME_SOLVERS */
@@ -0,0 +1,243 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file shared_file.c
+ *  \brief Writes dumps as one file per Domain shared by all processes.
+ *
+ * PURPOSE: Writes dumps as one file per Domain shared by all processes, with
+ *   collective MPI-IO, rather than one file per process that has to be joined
+ *   afterwards (see vis/vtk/join_vtk.c).  Used by dump_vtk(), dump_binary()
+ *   and output_vtk() when single_file = 1 in the <outputN> block of an MPI
+ *   job.  The file is written in the run directory (the parent of the id#
+ *   directories) with the name the root process would use without it.
+ *
+ *   All processes with a Grid in the Domain open the file with ath_sfopen(),
+ *   and must then make the same sequence of calls.  Text and header data
+ *   written with ath_sfprintf() and ath_sfwrite() must be the same on every
+ *   process; it is collected and written once, by the first process in the
+ *   Domain.  ath_sfwrite_grid() writes an array over the whole Domain, each
+ *   process writing the block covered by its Grid through a subarray file
+ *   view built from the Grid's Disp and Nx.  The data is written as is, so
+ *   callers byte-swap it first if needed (e.g. with ath_bswap() for VTK).
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - ath_sfopen()       - opens the shared file for one Domain
+ * - ath_sfprintf()     - writes text
+ * - ath_sfwrite()      - writes header data
+ * - ath_sfwrite_grid() - writes an array over the Domain
+ * - ath_sfclose()      - closes the shared file			      */
+/*============================================================================*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+
+#ifdef MPI_PARALLEL
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   sf_append() - adds bytes to the header data not yet written
+ *   sf_flush()  - writes the header data collected so far
+ *============================================================================*/
+
+static void sf_append(SFileS *sf, const void *ptr, size_t nbytes);
+static void sf_flush(SFileS *sf);
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn SFileS *ath_sfopen(MeshS *pM, const int nl, const int nd,
+ *                         const OutputS *pOut, const char *id,
+ *                         const char *ext)
+ *  \brief Opens (and truncates) the shared file for Domain nd on level nl,
+ *   named from the dump number of pOut, id and ext as in ath_fname().  Must
+ *   be called by all processes with a Grid in the Domain. */
+
+SFileS *ath_sfopen(MeshS *pM, const int nl, const int nd, const OutputS *pOut,
+                   const char *id, const char *ext)
+{
+  DomainS *pD = &(pM->Domain[nl][nd]);
+  GridS *pG = pD->Grid;
+  SFileS *sf;
+  char *base,*fname,*plev=NULL,*pdom=NULL;
+  char levstr[20],domstr[20],suffix[16];
+  int n,rank;
+  size_t len;
+
+  if ((sf = (SFileS*)calloc(1,sizeof(SFileS))) == NULL)
+    ath_error("[ath_sfopen]: malloc failed for SFileS\n");
+
+/* Remove the "-id#" that main() adds to the problem_id of all processes but
+ * the root, so every process constructs the root's filename */
+
+  base = ath_strdup(pM->outfilename);
+  if (myID_Comm_world != 0) {
+    sprintf(suffix,"-id%d",myID_Comm_world);
+    len = strlen(base);
+    if (len > strlen(suffix) &&
+        strcmp(&(base[len - strlen(suffix)]),suffix) == 0)
+      base[len - strlen(suffix)] = '\0';
+  }
+
+  if (nl>0) {
+    plev = &levstr[0];
+    sprintf(plev,"lev%d",nl);
+  }
+  if (nd>0) {
+    pdom = &domstr[0];
+    sprintf(pdom,"dom%d",nd);
+  }
+  if ((fname = ath_fname("..",base,plev,pdom,num_digit,pOut->num,id,ext))
+      == NULL)
+    ath_error("[ath_sfopen]: Error constructing filename\n");
+  free(base);
+
+  MPI_Comm_rank(pD->Comm_Domain, &rank);
+  sf->root = (rank == 0);
+  if (MPI_File_open(pD->Comm_Domain, fname, MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                    MPI_INFO_NULL, &(sf->fh)) != MPI_SUCCESS)
+    ath_error("[ath_sfopen]: Unable to open %s with MPI-IO\n",fname);
+  if (MPI_File_set_size(sf->fh, 0) != MPI_SUCCESS)
+    ath_error("[ath_sfopen]: Unable to truncate %s\n",fname);
+  sf->fname = fname;
+
+/* Size of the Domain, and position and size of this Grid in it */
+
+  for (n=0; n<3; n++) {
+    sf->Nx[n] = pD->Nx[n];
+    sf->start[n] = pG->Disp[n] - pD->Disp[n];
+    sf->size[n] = pG->Nx[n];
+  }
+
+  return sf;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn int ath_sfprintf(SFileS *sf, const char *fmt, ...)
+ *  \brief Writes text like fprintf(); the text must be the same on all
+ *   processes */
+
+int ath_sfprintf(SFileS *sf, const char *fmt, ...)
+{
+  va_list ap;
+  char line[MAXLEN];
+  int ret;
+
+  va_start(ap, fmt);
+  ret = vsnprintf(line, MAXLEN, fmt, ap);
+  va_end(ap);
+  if (ret < 0 || ret >= MAXLEN)
+    ath_error("[ath_sfprintf]: line too long for %s\n",sf->fname);
+
+  sf_append(sf, line, (size_t)ret);
+  return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_sfwrite(const void *ptr, size_t size, size_t n, SFileS *sf)
+ *  \brief Writes binary data like fwrite(); the data must be the same on all
+ *   processes */
+
+void ath_sfwrite(const void *ptr, size_t size, size_t n, SFileS *sf)
+{
+  sf_append(sf, ptr, size*n);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_sfwrite_grid(const void *data, const int cellsize,
+ *                            SFileS *sf)
+ *  \brief Writes an array over the whole Domain with cellsize bytes per cell,
+ *   ordered with i fastest.  data holds the cells of this process's Grid,
+ *   also with i fastest.  Collective over the processes in the Domain. */
+
+void ath_sfwrite_grid(const void *data, const int cellsize, SFileS *sf)
+{
+  MPI_Datatype etype, ftype;
+  MPI_Status stat;
+  int sizes[3],subsizes[3],starts[3],count,ierr;
+
+  sf_flush(sf);
+
+  MPI_Type_contiguous(cellsize, MPI_BYTE, &etype);
+  MPI_Type_commit(&etype);
+  sizes[0] = sf->Nx[2];     sizes[1] = sf->Nx[1];     sizes[2] = sf->Nx[0];
+  subsizes[0] = sf->size[2];subsizes[1] = sf->size[1];subsizes[2] = sf->size[0];
+  starts[0] = sf->start[2]; starts[1] = sf->start[1]; starts[2] = sf->start[0];
+  MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C, etype,
+                           &ftype);
+  MPI_Type_commit(&ftype);
+  count = sf->size[0]*sf->size[1]*sf->size[2];
+
+  ierr = MPI_File_set_view(sf->fh, sf->pos, etype, ftype, "native",
+                           MPI_INFO_NULL);
+  if (ierr == MPI_SUCCESS)
+    ierr = MPI_File_write_all(sf->fh, (void*)data, count, etype, &stat);
+  if (ierr == MPI_SUCCESS)
+    ierr = MPI_File_set_view(sf->fh, 0, MPI_BYTE, MPI_BYTE, "native",
+                             MPI_INFO_NULL);
+  if (ierr != MPI_SUCCESS)
+    ath_error("[ath_sfwrite_grid]: MPI-IO error on %s\n",sf->fname);
+
+  MPI_Type_free(&ftype);
+  MPI_Type_free(&etype);
+  sf->pos += (MPI_Offset)sf->Nx[0]*sf->Nx[1]*sf->Nx[2]*cellsize;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void ath_sfclose(SFileS *sf)
+ *  \brief Writes any remaining header data, closes the file and frees sf.
+ *   Collective over the processes in the Domain. */
+
+void ath_sfclose(SFileS *sf)
+{
+  sf_flush(sf);
+  if (MPI_File_close(&(sf->fh)) != MPI_SUCCESS)
+    ath_error("[ath_sfclose]: Error closing %s\n",sf->fname);
+  free(sf->fname);
+  free(sf->hdr);
+  free(sf);
+  return;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void sf_append(SFileS *sf, const void *ptr, size_t nbytes)
+ *  \brief Adds nbytes to the header data not yet written */
+
+static void sf_append(SFileS *sf, const void *ptr, size_t nbytes)
+{
+  if (sf->nhdr + nbytes > sf->caphdr) {
+    sf->caphdr = 2*(sf->nhdr + nbytes);
+    if ((sf->hdr = (char*)realloc(sf->hdr, sf->caphdr)) == NULL)
+      ath_error("[ath_sfwrite]: malloc failed for header of %s\n",sf->fname);
+  }
+  memcpy(sf->hdr + sf->nhdr, ptr, nbytes);
+  sf->nhdr += nbytes;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void sf_flush(SFileS *sf)
+ *  \brief The root process writes the header data collected so far at the
+ *   end of the file; all processes advance their position past it */
+
+static void sf_flush(SFileS *sf)
+{
+  MPI_Status stat;
+
+  if (sf->nhdr == 0) return;
+  if (sf->root && MPI_File_write_at(sf->fh, sf->pos, sf->hdr, (int)sf->nhdr,
+                                    MPI_BYTE, &stat) != MPI_SUCCESS)
+    ath_error("[ath_sfwrite]: MPI-IO error on %s\n",sf->fname);
+  sf->pos += (MPI_Offset)sf->nhdr;
+  sf->nhdr = 0;
+  return;
+}
+
+#endif /* MPI_PARALLEL */
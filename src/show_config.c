@@ -111,6 +111,8 @@ void show_config(void)
   ath_pout(0," Order of Accuracy:       3 (THIRD_ORDER_CHAR)\n");
 #elif defined(THIRD_ORDER_PRIM)
   ath_pout(0," Order of Accuracy:       3p (THIRD_ORDER_PRIM)\n");
+#elif defined(RUNTIME_ORDER)
+  ath_pout(0," Order of Accuracy:       runtime (default %s)\n",DEFAULT_ORDER);
 #endif
 
 #if defined(ROE_FLUX)
@@ -127,12 +129,17 @@ void show_config(void)
   ath_pout(0," Flux:                    exact\n");
 #elif defined(TWO_SHOCK_FLUX)
   ath_pout(0," Flux:                    two-shock\n");
+#elif defined(RUNTIME_FLUX)
+  ath_pout(0," Flux:                    runtime (default %s)\n",DEFAULT_FLUX);
 #endif
 
 #if defined(CTU_INTEGRATOR)
   ath_pout(0," Unsplit integrator:      ctu\n");
 #elif defined(VL_INTEGRATOR)
   ath_pout(0," Unsplit integrator:      vl\n");
+#elif defined(RUNTIME_INTEGRATOR)
+  ath_pout(0," Unsplit integrator:      runtime (default %s)\n",
+    DEFAULT_INTEGRATOR);
 #endif
 
 #if defined(SINGLE_PREC)
@@ -153,6 +160,60 @@ void show_config(void)
   ath_pout(0," Parallel Modes: MPI:     OFF\n");
 #endif
 
+#if defined(ASYNC_BVALS)
+  ath_pout(0," Async MPI ghost zones:   ON\n");
+#else
+  ath_pout(0," Async MPI ghost zones:   OFF\n");
+#endif
+
+#if defined(MPIIO_RESTART)
+  ath_pout(0," MPI-IO restart files:    ON\n");
+#else
+  ath_pout(0," MPI-IO restart files:    OFF\n");
+#endif
+
+#if defined(ASYNC_RESTART)
+  ath_pout(0," Async restart files:     ON\n");
+#else
+  ath_pout(0," Async restart files:     OFF\n");
+#endif
+
+#if defined(COMPRESSION)
+  ath_pout(0," Compressed outputs:      ON\n");
+#else
+  ath_pout(0," Compressed outputs:      OFF\n");
+#endif
+
+#if defined(HDF5_OUTPUT)
+  ath_pout(0," HDF5 outputs:            ON\n");
+#else
+  ath_pout(0," HDF5 outputs:            OFF\n");
+#endif
+
+#if defined(OPENMP_PARALLEL)
+  ath_pout(0," Parallel Modes: OpenMP:  ON\n");
+#else
+  ath_pout(0," Parallel Modes: OpenMP:  OFF\n");
+#endif
+
+#if defined(PHASE_TIMERS)
+  ath_pout(0," Phase timers:            ON\n");
+#else
+  ath_pout(0," Phase timers:            OFF\n");
+#endif
+
+#if defined(SOA_LAYOUT)
+  ath_pout(0," Conserved var layout:    SoA\n");
+#else
+  ath_pout(0," Conserved var layout:    AoS\n");
+#endif
+
+#if defined(FUSED_CFL)
+  ath_pout(0," Fused CFL:               ON\n");
+#else
+  ath_pout(0," Fused CFL:               OFF\n");
+#endif
+
 #ifdef H_CORRECTION
   ath_pout(0," H-correction:            ON\n");
 #else
@@ -188,6 +249,24 @@ void show_config(void)
 #else
   ath_pout(0," Static mesh refinement:  OFF\n");
 #endif
+
+#ifdef SMR_SUBCYCLE
+  ath_pout(0," SMR subcycling:          ON\n");
+#else
+  ath_pout(0," SMR subcycling:          OFF\n");
+#endif
+
+#ifdef ADAPTIVE_MESH_REFINEMENT
+  ath_pout(0," AMR regridding:          ON\n");
+#else
+  ath_pout(0," AMR regridding:          OFF\n");
+#endif
+
+#ifdef SMR_AGGREGATE
+  ath_pout(0," SMR aggregated messages: ON\n");
+#else
+  ath_pout(0," SMR aggregated messages: OFF\n");
+#endif
 }
 
 /*----------------------------------------------------------------------------*/
@@ -277,6 +356,8 @@ void show_config_par(void)
   par_seti("configure","order","%d",3,"Order of accuracy");
 #elif defined(THIRD_ORDER_PRIM)
   par_sets("configure","order","3p","Order of accuracy");
+#elif defined(RUNTIME_ORDER)
+  par_sets("configure","order","runtime","Order of accuracy");
 #endif
 
 #if defined(ROE_FLUX)
@@ -293,12 +374,16 @@ void show_config_par(void)
   par_sets("configure","flux","exact","Flux function");
 #elif defined(TWO_SHOCK_FLUX)
   par_sets("configure","flux","two-shock","Flux function");
+#elif defined(RUNTIME_FLUX)
+  par_sets("configure","flux","runtime","Flux function");
 #endif
 
 #if defined(CTU_INTEGRATOR)
   par_sets("configure","integrator","ctu","Unsplit integrator");
 #elif defined(VL_INTEGRATOR)
   par_sets("configure","integrator","vl","Unsplit integrator");
+#elif defined(RUNTIME_INTEGRATOR)
+  par_sets("configure","integrator","runtime","Unsplit integrator");
 #endif
 
 #if defined(SINGLE_PREC)
@@ -319,6 +404,60 @@ void show_config_par(void)
   par_sets("configure","mpi","no","Is code MPI parallel enabled?");
 #endif
 
+#if defined(ASYNC_BVALS)
+  par_sets("configure","async_bvals","yes","MPI ghost zones exchanged in one round?");
+#else
+  par_sets("configure","async_bvals","no","MPI ghost zones exchanged in one round?");
+#endif
+
+#if defined(MPIIO_RESTART)
+  par_sets("configure","mpiio_restart","yes","Restart files shared by all processes?");
+#else
+  par_sets("configure","mpiio_restart","no","Restart files shared by all processes?");
+#endif
+
+#if defined(ASYNC_RESTART)
+  par_sets("configure","async_restart","yes","Restart files written in background?");
+#else
+  par_sets("configure","async_restart","no","Restart files written in background?");
+#endif
+
+#if defined(COMPRESSION)
+  par_sets("configure","compression","yes","Compressed dumps and restarts?");
+#else
+  par_sets("configure","compression","no","Compressed dumps and restarts?");
+#endif
+
+#if defined(HDF5_OUTPUT)
+  par_sets("configure","hdf5","yes","HDF5 dumps?");
+#else
+  par_sets("configure","hdf5","no","HDF5 dumps?");
+#endif
+
+#if defined(OPENMP_PARALLEL)
+  par_sets("configure","openmp","yes","Is code OpenMP threading enabled?");
+#else
+  par_sets("configure","openmp","no","Is code OpenMP threading enabled?");
+#endif
+
+#if defined(PHASE_TIMERS)
+  par_sets("configure","timers","yes","Main loop phases timed?");
+#else
+  par_sets("configure","timers","no","Main loop phases timed?");
+#endif
+
+#if defined(SOA_LAYOUT)
+  par_sets("configure","soa","yes","Conserved vars stored as arrays?");
+#else
+  par_sets("configure","soa","no","Conserved vars stored as arrays?");
+#endif
+
+#if defined(FUSED_CFL)
+  par_sets("configure","fused_cfl","yes","CFL speeds found by integrator?");
+#else
+  par_sets("configure","fused_cfl","no","CFL speeds found by integrator?");
+#endif
+
 #ifdef H_CORRECTION
   par_sets("configure","H-correction","yes","H-correction enabled?");
 #else
@@ -349,5 +488,23 @@ void show_config_par(void)
   par_sets("configure","SMR","no","SMR enabled?");
 #endif
 
+#ifdef SMR_SUBCYCLE
+  par_sets("configure","subcycle","yes","SMR levels subcycled in time?");
+#else
+  par_sets("configure","subcycle","no","SMR levels subcycled in time?");
+#endif
+
+#ifdef ADAPTIVE_MESH_REFINEMENT
+  par_sets("configure","AMR","yes","AMR enabled?");
+#else
+  par_sets("configure","AMR","no","AMR enabled?");
+#endif
+
+#ifdef SMR_AGGREGATE
+  par_sets("configure","smr_aggregate","yes","SMR messages aggregated by process?");
+#else
+  par_sets("configure","smr_aggregate","no","SMR messages aggregated by process?");
+#endif
+
   return;
 }
@@ -5,7 +5,27 @@
  *
  * PURPOSE: Functions to handle static mesh refinement (SMR).
  *
+ *   With SMR_SUBCYCLE (--enable-subcycle) each level takes two steps of half
+ *   the timestep for every step of its parent level (Berger & Colella).  The
+ *   ghost zones of a child level at fine/coarse boundaries are then set at the
+ *   start of each of its substeps by interpolating linearly in time between
+ *   the parent solution at the start and end of the parent step, and the
+ *   fluxes and EMFs of the child at these boundaries are averaged over its two
+ *   substeps before they are used to correct the parent.
+ *
+ *   With SMR_AGGREGATE (--enable-smr-aggregate) the data restricted to, or
+ *   prolongated from, each level is sent as one message to each other
+ *   processor, holding the data of all overlaps between their Grids in all
+ *   Domains on the two levels, rather than as one message for each overlap.
+ *   The messages are persistent requests built by SMR_init().  Sends are
+ *   started once all Domains on a level are loaded and completed at the end
+ *   of RestrictCorrect() or Prolongate(), and overlaps are taken in the order
+ *   their messages arrive, so communication overlaps the restriction, flux
+ *   correction and prolongation on the other levels.
+ *
  * REFERENCES:
+ * - M.J. Berger and P. Colella, "Local adaptive mesh refinement for shock
+ *   hydrodynamics", JCP 82, 64 (1989)
  * - G. Toth and P.L. Roe, "Divergence and Curl-preserving prolongation and
  *   restriction formulas", JCP 180, 736 (2002)
  *
@@ -14,9 +34,24 @@
  *    corrects cells at fine/coarse boundaries using restricted fine Grid fluxes
  * - Prolongate(): sets BC on fine Grid by prolongation (interpolation) of
  *     coarse Grid solution into fine grid ghost zones
+ * - SMR_advance(): advances all levels over one root level timestep, with
+ *     subcycling (only with SMR_SUBCYCLE)
  * - SMR_init(): allocates memory for send/receive buffers
+ * - SMR_destruct(): frees memory allocated by SMR_init()
  *
  * PRIVATE FUNCTION PROTOTYPES: 
+ * - restrict_levels() - restricts and corrects over a range of levels
+ * - prolong_levels() - prolongates over a range of levels
+ * - pack_prolong() - loads data sent to one child Grid in Prolongate
+ * - advance_level() - advances one level and, recursively, its children
+ * - save_prolong() - saves data sent to child Grids at start of a step
+ * - sum_fluxes() - averages fluxes at fine/coarse boundaries over substeps
+ * - flux_array() - returns one of the flux arrays of a Grid overlap
+ * - agg_init() - builds aggregated messages between two levels (SMR_AGGREGATE)
+ * - agg_free() - frees aggregated messages (SMR_AGGREGATE)
+ * - agg_rank() - returns processor of an overlap in MPI_COMM_WORLD
+ * - cmp_agg() - orders overlaps in aggregated messages, for qsort()
+ * - agg_next() - returns next overlap whose aggregated message has arrived
  * - ProCon() - prolongates conserved variables
  * - ProFld() - prolongates face-centered B field using TR formulas
  * - mcd_slope() - returns monotonized central-difference slope		      */
@@ -41,21 +76,84 @@ static double ***recv_bufRC=NULL;
 static MPI_Request ***recv_rq=NULL;
 static MPI_Request  **send_rq=NULL;
 #endif
-static int maxND, *start_addrP;
+static int maxND, *start_addrP=NULL;
+#ifdef SMR_SUBCYCLE
+static double ***old_bufP=NULL; /* data sent to children at start of step */
+static Real ***FlxSum=NULL;     /* fluxes at boundaries with parent Grids */
+#endif
 
-static ConsS ***GZ[3];
+static ConsS ***GZ[3]={NULL,NULL,NULL};
 #ifdef MHD
-Real **SMRemf1, **SMRemf2, **SMRemf3;
-Real3Vect ***BFld[3];
+Real **SMRemf1=NULL, **SMRemf2=NULL, **SMRemf3=NULL;
+Real3Vect ***BFld[3]={NULL,NULL,NULL};
 #endif
 
+#ifdef SMR_AGGREGATE
+/*! \struct AggMsgS
+ *  \brief Persistent messages between the Grids on this processor on level nl
+ *   and on level nl+1, for either prolongation or restriction.  There is one
+ *   message to and from each other processor, holding the data of all the
+ *   overlaps with its Grids in order of parent and then child Domain. */
+typedef struct AggMsg_s{
+  int nSend, nRecv;              /* number of messages sent and received */
+  double *send_buf, *recv_buf;   /* data of all messages */
+  MPI_Request *send_rq, *recv_rq;
+  int *done;                     /* 1 once received message has arrived */
+}AggMsgS;
+
+/*! \struct AggEntryS
+ *  \brief One overlap in an aggregated message, used to order them */
+typedef struct AggEntry_s{
+  int peer;                      /* other processor, in MPI_COMM_WORLD */
+  int pd, cd;                    /* Domain # of parent and child Grids */
+  int nWords;
+  GridOvrlpS *pO;
+}AggEntryS;
+
+static AggMsgS *AggP=NULL, *AggRC=NULL; /* [nl], between levels nl and nl+1 */
+static MPI_Comm Comm_Agg;        /* duplicate of MPI_COMM_WORLD */
+static int *Taken=NULL;          /* overlaps of a Grid already read */
+#endif /* SMR_AGGREGATE */
+
 /*==============================================================================
  * PRIVATE FUNCTION PROTOTYPES: 
+ *   restrict_levels - restricts and corrects over a range of levels
+ *   prolong_levels - prolongates over a range of levels
+ *   pack_prolong - loads data sent to one child Grid in Prolongate
+ *   advance_level - advances one level and, recursively, its children
+ *   save_prolong - saves data sent to child Grids at start of a step
+ *   sum_fluxes - averages fluxes at fine/coarse boundaries over substeps
+ *   flux_array - returns one of the flux arrays of a Grid overlap
+ *   agg_init - builds aggregated messages between two levels (SMR_AGGREGATE)
+ *   agg_free - frees aggregated messages (SMR_AGGREGATE)
+ *   agg_rank - returns processor of an overlap in MPI_COMM_WORLD
+ *   cmp_agg - orders overlaps in aggregated messages, for qsort()
+ *   agg_next - returns next overlap whose aggregated message has arrived
  *   ProCon - prolongates conserved variables
  *   ProFld - prolongates face-centered B field using TR formulas
  *   mcd_slope - returns monotonized central-difference slope
  *============================================================================*/
 
+static void restrict_levels(MeshS *pM, const int nlc, const int nlf);
+static void prolong_levels(MeshS *pM, const int nlc, const int nlf,
+                           const Real frac);
+static void pack_prolong(GridS *pG, GridOvrlpS *pCO, const int nDim,
+                         double *pSnd);
+#ifdef SMR_SUBCYCLE
+static void advance_level(MeshS *pM, const int nl, const int sub,
+                          VDFun_t Integrate);
+static void save_prolong(MeshS *pM, const int nl);
+static void sum_fluxes(MeshS *pM, const int nl, const int sub);
+static int flux_array(GridOvrlpS *pPO, const int dim, const int n, Real **ppF);
+#endif /* SMR_SUBCYCLE */
+#ifdef SMR_AGGREGATE
+static void agg_init(MeshS *pM, const int nl, const int rc);
+static void agg_free(AggMsgS *pA);
+static int agg_rank(MeshS *pM, const int lev, GridOvrlpS *pO, const int child);
+static int cmp_agg(const void *a, const void *b);
+static int agg_next(AggMsgS *pA, GridOvrlpS *pO, const int n0, const int n1,
+                    const int rc);
+#endif /* SMR_AGGREGATE */
 void ProCon(const ConsS Uim1,const ConsS Ui,  const ConsS Uip1,
             const ConsS Ujm1,const ConsS Ujp1,
             const ConsS Ukm1,const ConsS Ukp1, ConsS PCon[][2][2]);
@@ -76,8 +174,306 @@ static Real mcd_slope(const Real vl, const Real vc, const Real vr);
 
 void RestrictCorrect(MeshS *pM)
 {
+  restrict_levels(pM,0,(pM->NLevels)-1);
+  return;
+}
+
+/*============================================================================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void Prolongate(MeshS *pM)
+ *  \brief Sets BC on fine Grid by prolongation (interpolation) of
+ *     coarse Grid solution into fine grid ghost zones */
+void Prolongate(MeshS *pM)
+{
+  prolong_levels(pM,0,(pM->NLevels)-1,1.0);
+  return;
+}
+
+#ifdef SMR_SUBCYCLE
+/*============================================================================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void SMR_advance(MeshS *pM, VDFun_t Integrate)
+ *  \brief Advances all levels over one timestep pM->dt of the root level.  Each
+ *   level takes two steps for every step of its parent, with the timesteps
+ *   pG->dt set by new_dt().  The solution is restricted and corrected as each
+ *   level completes its step, so RestrictCorrect() is not needed afterwards.
+ *   The caller must set ghost zones on all levels at the end of the step. */
+
+void SMR_advance(MeshS *pM, VDFun_t Integrate)
+{
+  advance_level(pM,0,0,Integrate);
+  return;
+}
+#endif /* SMR_SUBCYCLE */
+
+/*============================================================================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void SMR_init(MeshS *pM)
+ *  \brief Allocates memory for send/receive buffers
+ */
+
+void SMR_init(MeshS *pM)
+{
+  int nl,nd,sendRC,recvRC,sendP,recvP,npg,ncg;
+  int max_sendRC=1,max_recvRC=1,max_sendP=1,max_recvP=1;
+  int max1=0,max2=0,max3=0,maxCG=1,maxPG=1;
+#ifdef MHD
+  int ngh1;
+#endif
+#ifdef SMR_SUBCYCLE
+  int dim,n,nFlx;
+  Real *pFlx;
+#endif
+#ifdef SMR_AGGREGATE
+  int ierr;
+#endif
   GridS *pG;
-  int nl,nd,ncg,dim,nDim,npg,rbufN,start_addr,cnt,nCons,nFlx,nZeroRC;
+  
+  maxND=1;
+  for (nl=0; nl<(pM->NLevels); nl++) maxND=MAX(maxND,pM->DomainsPerLevel[nl]);
+  if((start_addrP = (int*)calloc_1d_array(maxND,sizeof(int))) == NULL)
+    ath_error("[SMR_init]:Failed to allocate start_addrP\n");
+
+/* Loop over all parent Grids of Grids on this processor to find maximum total
+ * number of words communicated */
+
+  for (nl=0; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      sendRC=0;
+      recvRC=0;
+      sendP =1;
+      recvP =1;
+
+      if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this proc */
+        pG=pM->Domain[nl][nd].Grid;          /* set pointer to Grid */
+
+        for (npg=0; npg<pG->NPGrid; npg++){
+          sendRC += pG->PGrid[npg].nWordsRC;
+          recvP  += pG->PGrid[npg].nWordsP;
+        }
+        for (ncg=0; ncg<pG->NCGrid; ncg++){
+          recvRC += pG->CGrid[ncg].nWordsRC;
+          sendP  += pG->CGrid[ncg].nWordsP;
+        }
+
+        max_sendRC = MAX(max_sendRC,sendRC);
+        max_recvRC = MAX(max_recvRC,recvRC);
+        max_sendP  = MAX(max_sendP ,sendP );
+        max_recvP  = MAX(max_recvP ,recvP );
+        max1 = MAX(max1,(pG->Nx[0]+1));
+        max2 = MAX(max2,(pG->Nx[1]+1));
+        max3 = MAX(max3,(pG->Nx[2]+1));
+        maxCG = MAX(maxCG,pG->NCGrid);
+        maxPG = MAX(maxPG,pG->NPGrid);
+      }
+    }
+  }
+
+/* Allocate memory for send/receive buffers and EMFs used in RestrictCorrect.
+ * The MPI_Request arrays are indexed by either child or parent Grids, so are
+ * sized for the larger number. */
+
+  if((send_bufRC =
+    (double**)calloc_2d_array(maxND,max_sendRC,sizeof(double))) == NULL)
+    ath_error("[SMR_init]:Failed to allocate send_bufRC\n");
+
+#ifdef MPI_PARALLEL
+  if((recv_bufRC =
+    (double***)calloc_3d_array(2,maxND,max_recvRC,sizeof(double))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate recv_bufRC\n");
+  if((recv_rq = (MPI_Request***)
+    calloc_3d_array(pM->NLevels,maxND,MAX(maxCG,maxPG),sizeof(MPI_Request)))
+    == NULL)
+    ath_error("[SMR_init]: Failed to allocate recv MPI_Request array\n");
+  if((send_rq = (MPI_Request**)
+    calloc_2d_array(maxND,MAX(maxCG,maxPG),sizeof(MPI_Request))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate send MPI_Request array\n");
+
+#ifdef SMR_AGGREGATE
+/* Build the aggregated messages between each level and its children, in a
+ * communicator of their own so their tags cannot match any other message */
+
+  ierr = MPI_Comm_dup(MPI_COMM_WORLD, &Comm_Agg);
+  if((Taken = (int*)calloc_1d_array(MAX(maxCG,maxPG),sizeof(int))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate Taken\n");
+  if((AggP = (AggMsgS*)calloc_1d_array(pM->NLevels,sizeof(AggMsgS))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate AggP\n");
+  if((AggRC = (AggMsgS*)calloc_1d_array(pM->NLevels,sizeof(AggMsgS))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate AggRC\n");
+  for (nl=0; nl<(pM->NLevels)-1; nl++){
+    agg_init(pM,nl,0);
+    agg_init(pM,nl,1);
+  }
+#endif /* SMR_AGGREGATE */
+#endif /* MPI_PARALLEL */
+
+#ifdef MHD
+  if((SMRemf1 =
+    (Real**)calloc_2d_array(MAX(max2,max3),max1,sizeof(Real))) == NULL)
+    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf1\n");;
+  if((SMRemf2 =
+    (Real**)calloc_2d_array(MAX(max2,max3),MAX(max1,max2),sizeof(Real))) ==NULL)
+    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf2\n");;
+  if((SMRemf3 =
+    (Real**)calloc_2d_array(max3,MAX(max1,max2),sizeof(Real))) == NULL)
+    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf3\n");;
+#endif /* MHD */
+
+/* Allocate memory for send/receive buffers and GZ arrays used in Prolongate */
+
+  if((send_bufP =
+    (double**)calloc_2d_array(maxND,max_sendP,sizeof(double))) == NULL)
+    ath_error("[SMR_init]:Failed to allocate send_bufP\n");
+
+  if((recv_bufP =
+    (double***)calloc_3d_array(2,maxND,max_recvP,sizeof(double))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate recv_bufP\n");
+
+  max1 += 2*nghost;
+  max2 += 2*nghost;
+  max3 += 2*nghost;
+
+  if((GZ[0]=(ConsS***)calloc_3d_array(max3,max2,nghost,sizeof(ConsS)))
+    ==NULL) ath_error("[SMR_init]:Failed to allocate GZ[0]C\n");
+  if((GZ[1]=(ConsS***)calloc_3d_array(max3,nghost,max1,sizeof(ConsS)))
+    ==NULL) ath_error("[SMR_init]:Failed to allocate GZ[1]C\n");
+  if((GZ[2]=(ConsS***)calloc_3d_array(nghost,max2,max1,sizeof(ConsS)))
+    ==NULL) ath_error("[SMR_init]:Failed to allocate GZ[2]C\n");
+#ifdef MHD
+  ngh1 = nghost + 1;
+  if((BFld[0]=(Real3Vect***)calloc_3d_array(max3,max2,ngh1,sizeof(Real3Vect)))
+    ==NULL) ath_error("[SMR_init]:Failed to allocate BFld[0]C\n");
+  if((BFld[1]=(Real3Vect***)calloc_3d_array(max3,ngh1,max1,sizeof(Real3Vect)))
+    ==NULL) ath_error("[SMR_init]:Failed to allocate BFld[1]C\n");
+  if((BFld[2]=(Real3Vect***)calloc_3d_array(ngh1,max2,max1,sizeof(Real3Vect)))
+    ==NULL) ath_error("[SMR_init]:Failed to allocate BFld[2]C\n");
+#endif /* MHD */
+
+#ifdef SMR_SUBCYCLE
+/* Allocate memory for the data sent to child Grids at the start of a step,
+ * and for the fluxes at boundaries with parent Grids summed over substeps */
+
+  if((old_bufP = (double***)calloc_3d_array(pM->NLevels,maxND,max_sendP,
+    sizeof(double))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate old_bufP\n");
+  if((FlxSum = (Real***)calloc_2d_array(pM->NLevels,maxND,sizeof(Real*)))
+    == NULL) ath_error("[SMR_init]: Failed to allocate FlxSum\n");
+
+  for (nl=1; nl<(pM->NLevels); nl++){
+    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+      if (pM->Domain[nl][nd].Grid != NULL) {
+        pG=pM->Domain[nl][nd].Grid;
+        nFlx = 0;
+        for (npg=0; npg<pG->NPGrid; npg++){
+          for (dim=0; dim<6; dim++){
+            for (n=0; n<4; n++){
+              nFlx += flux_array(&(pG->PGrid[npg]),dim,n,&pFlx);
+            }
+          }
+        }
+        if (nFlx > 0) {
+          if((FlxSum[nl][nd] = (Real*)calloc_1d_array(nFlx,sizeof(Real)))
+            == NULL) ath_error("[SMR_init]: Failed to allocate FlxSum\n");
+        }
+      }
+    }
+  }
+#endif /* SMR_SUBCYCLE */
+
+  return;
+}
+
+/*============================================================================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void SMR_destruct(MeshS *pM)
+ *  \brief Frees memory allocated by SMR_init(), so it can be called again after
+ *   the Grids have changed
+ */
+
+void SMR_destruct(MeshS *pM)
+{
+  int n;
+#if defined(SMR_SUBCYCLE) || defined(SMR_AGGREGATE)
+  int nl;
+#endif
+#ifdef SMR_SUBCYCLE
+  int nd;
+#endif
+
+  if (start_addrP != NULL) free_1d_array(start_addrP);
+  if (send_bufRC != NULL) free_2d_array(send_bufRC);
+#ifdef MPI_PARALLEL
+  if (recv_bufRC != NULL) free_3d_array(recv_bufRC);
+  if (recv_rq != NULL) free_3d_array(recv_rq);
+  if (send_rq != NULL) free_2d_array(send_rq);
+  recv_bufRC = NULL;
+  recv_rq = NULL;
+  send_rq = NULL;
+#ifdef SMR_AGGREGATE
+  if (AggP != NULL) {
+    for (nl=0; nl<(pM->NLevels)-1; nl++){
+      agg_free(&(AggP[nl]));
+      agg_free(&(AggRC[nl]));
+    }
+    free_1d_array(AggP);
+    free_1d_array(AggRC);
+    free_1d_array(Taken);
+    MPI_Comm_free(&Comm_Agg);
+  }
+  AggP = AggRC = NULL;
+  Taken = NULL;
+#endif /* SMR_AGGREGATE */
+#endif /* MPI_PARALLEL */
+#ifdef MHD
+  if (SMRemf1 != NULL) free_2d_array(SMRemf1);
+  if (SMRemf2 != NULL) free_2d_array(SMRemf2);
+  if (SMRemf3 != NULL) free_2d_array(SMRemf3);
+  SMRemf1 = SMRemf2 = SMRemf3 = NULL;
+#endif /* MHD */
+  if (send_bufP != NULL) free_2d_array(send_bufP);
+  if (recv_bufP != NULL) free_3d_array(recv_bufP);
+  start_addrP = NULL;
+  send_bufRC = NULL;
+  send_bufP = NULL;
+  recv_bufP = NULL;
+
+  for (n=0; n<3; n++){
+    if (GZ[n] != NULL) free_3d_array(GZ[n]);
+    GZ[n] = NULL;
+#ifdef MHD
+    if (BFld[n] != NULL) free_3d_array(BFld[n]);
+    BFld[n] = NULL;
+#endif /* MHD */
+  }
+
+#ifdef SMR_SUBCYCLE
+  if (old_bufP != NULL) free_3d_array(old_bufP);
+  if (FlxSum != NULL) {
+    for (nl=0; nl<(pM->NLevels); nl++){
+      for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+        if (FlxSum[nl][nd] != NULL) free_1d_array(FlxSum[nl][nd]);
+      }
+    }
+    free_2d_array(FlxSum);
+  }
+  old_bufP = NULL;
+  FlxSum = NULL;
+#endif /* SMR_SUBCYCLE */
+
+  return;
+}
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static void restrict_levels(MeshS *pM, const int nlc, const int nlf)
+ *  \brief Restricts the solution on levels nlc+1..nlf into their parents, and
+ *   corrects the parents at fine/coarse boundaries, starting at level nlf.
+ *   Grids on level nlf must hold the restricted solution of their own children.
+ */
+
+static void restrict_levels(MeshS *pM, const int nlc, const int nlf)
+{
+  GridS *pG;
+  int nl,nd,ndRC,ncg,dim,nDim,npg,rbufN,start_addr,cnt,nCons,nFlx,nZeroRC;
   int i,ii,ics,ice,ips,ipe;
   int j,jj,jcs,jce,jps,jpe;
   int k,kk,kcs,kce,kps,kpe;
@@ -93,21 +489,31 @@ void RestrictCorrect(MeshS *pM)
 #ifdef MPI_PARALLEL
   int ierr,mAddress,mIndex,mCount;
 #endif
+#ifdef SMR_AGGREGATE
+  AggMsgS *pA;
+#endif
 
 /* number of dimensions in Grid. */
   nDim=1;
   for (i=1; i<3; i++) if (pM->Nx[i]>1) nDim++;
 
-/* Loop over all Domains, starting at maxlevel */
+/* Loop over levels nlf..nlc, starting at finest */
 
-  for (nl=(pM->NLevels)-1; nl>=0; nl--){
+  for (nl=nlf; nl>=nlc; nl--){
 
 #ifdef MPI_PARALLEL
 /* Post non-blocking receives at level nl-1 for data from child Grids at this
  * level (nl).  This data is sent in Step 3 below, and will be read in Step 1
  * at the next iteration of the loop. */ 
 
-  if (nl>0) {
+  if (nl>nlc) {
+#ifdef SMR_AGGREGATE
+/* With aggregated messages, start the persistent receives from all processors
+ * with child Grids on this level */
+    pA = &(AggRC[nl-1]);
+    for (i=0; i<pA->nRecv; i++) pA->done[i] = 0;
+    if (pA->nRecv > 0) ierr = MPI_Startall(pA->nRecv, pA->recv_rq);
+#else
     for (nd=0; nd<(pM->DomainsPerLevel[nl-1]); nd++){
       if (pM->Domain[nl-1][nd].Grid != NULL) {
         pG=pM->Domain[nl-1][nd].Grid;
@@ -133,14 +539,18 @@ void RestrictCorrect(MeshS *pM)
 
       }
     }
+#endif /* SMR_AGGREGATE */
   }
 #endif /* MPI_PARALLEL */
 
 /*=== Step 1. Get child solution, inject into parent Grid ====================*/
 /* Loop over Domains and child Grids.  Maxlevel domains skip this step because
- * they have NCGrids=0 */
+ * they have NCGrids=0.  Level nlf skips it because its children are not being
+ * restricted (with subcycling, they were restricted at the end of its last
+ * substep) */
 
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+  ndRC = (nl < nlf) ? pM->DomainsPerLevel[nl] : 0;
+  for (nd=0; nd<ndRC; nd++){
 
   if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
     pG=pM->Domain[nl][nd].Grid;
@@ -149,6 +559,9 @@ void RestrictCorrect(MeshS *pM)
 
     for (i=pG->NmyCGrid; i<pG->NCGrid; i++)
       if(pG->CGrid[i].nWordsRC == 0) nZeroRC++;
+#ifdef SMR_AGGREGATE
+    for (i=0; i<pG->NCGrid; i++) Taken[i] = 0;
+#endif
 
     for (ncg=0; ncg<(pG->NCGrid-nZeroRC); ncg++){
 
@@ -163,6 +576,13 @@ void RestrictCorrect(MeshS *pM)
       } else {
 
 #ifdef MPI_PARALLEL
+#ifdef SMR_AGGREGATE
+/* Take the child Grids in the order their aggregated messages arrive */
+
+        mIndex = agg_next(&(AggRC[nl]),pG->CGrid,pG->NmyCGrid,pG->NCGrid,1);
+        pCO=(GridOvrlpS*)&(pG->CGrid[mIndex]);
+        pRcv = pCO->pAggRC;
+#else
 /* Check non-blocking receives posted above for restricted solution from child
  * Grids, sent in Step 3 during last iteration of loop over nl.  Accept messages
  * in any order. */
@@ -184,6 +604,7 @@ void RestrictCorrect(MeshS *pM)
         for (i=pG->NmyCGrid; i<mIndex; i++) mAddress += pG->CGrid[i].nWordsRC;
         pCO=(GridOvrlpS*)&(pG->CGrid[mIndex]);
         pRcv = (double*)&(recv_bufRC[rbufN][nd][mAddress]);
+#endif /* SMR_AGGREGATE */
 #else
 /* If not MPI_PARALLEL, and child Grid not on this processor, then error */
 
@@ -206,20 +627,20 @@ void RestrictCorrect(MeshS *pM)
       for (k=kcs; k<=kce; k++) {
         for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[k][j][i].d  = *(pRcv++);
-            pG->U[k][j][i].M1 = *(pRcv++);
-            pG->U[k][j][i].M2 = *(pRcv++);
-            pG->U[k][j][i].M3 = *(pRcv++);
+            GRID_U(pG,k,j,i,d)  = *(pRcv++);
+            GRID_U(pG,k,j,i,M1) = *(pRcv++);
+            GRID_U(pG,k,j,i,M2) = *(pRcv++);
+            GRID_U(pG,k,j,i,M3) = *(pRcv++);
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  = *(pRcv++);
+            GRID_U(pG,k,j,i,E)  = *(pRcv++);
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c = *(pRcv++);
-            pG->U[k][j][i].B2c = *(pRcv++);
-            pG->U[k][j][i].B3c = *(pRcv++);
+            GRID_U(pG,k,j,i,B1c) = *(pRcv++);
+            GRID_U(pG,k,j,i,B2c) = *(pRcv++);
+            GRID_U(pG,k,j,i,B3c) = *(pRcv++);
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] = *(pRcv++);
+            for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) = *(pRcv++);
 #endif
           }
         }
@@ -233,9 +654,9 @@ void RestrictCorrect(MeshS *pM)
 
       if (nDim == 1){ /* 1D problem - set face-centered to cell-centered */
         for (i=ics; i<=ice; i++) {
-          pG->B1i[kcs][jcs][i] = pG->U[kcs][jcs][i].B1c;
-          pG->B2i[kcs][jcs][i] = pG->U[kcs][jcs][i].B2c;
-          pG->B3i[kcs][jcs][i] = pG->U[kcs][jcs][i].B3c;
+          pG->B1i[kcs][jcs][i] = GRID_U(pG,kcs,jcs,i,B1c);
+          pG->B2i[kcs][jcs][i] = GRID_U(pG,kcs,jcs,i,B2c);
+          pG->B3i[kcs][jcs][i] = GRID_U(pG,kcs,jcs,i,B3c);
         }
       } else {
 
@@ -287,9 +708,9 @@ void RestrictCorrect(MeshS *pM)
 /* Set cell-centered fields */
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[kcs][j][i].B1c=0.5*(pG->B1i[kcs][j][i] +pG->B1i[kcs][j][i+1]);
-            pG->U[kcs][j][i].B2c=0.5*(pG->B2i[kcs][j][i] +pG->B2i[kcs][j+1][i]);
-            pG->B3i[kcs][j][i] = pG->U[kcs][j][i].B3c;
+            GRID_U(pG,kcs,j,i,B1c)=0.5*(pG->B1i[kcs][j][i] +pG->B1i[kcs][j][i+1]);
+            GRID_U(pG,kcs,j,i,B2c)=0.5*(pG->B2i[kcs][j][i] +pG->B2i[kcs][j+1][i]);
+            pG->B3i[kcs][j][i] = GRID_U(pG,kcs,j,i,B3c);
           }}
 
         } else { /* 3D problem */
@@ -368,9 +789,9 @@ void RestrictCorrect(MeshS *pM)
           for (k=kcs; k<=kce; k++) {
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
-            pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
-            pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+            GRID_U(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+            GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+            GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
           }}}
 
         }
@@ -392,20 +813,20 @@ void RestrictCorrect(MeshS *pM)
           if (dim == 1) {i=ice+1; q1= (pG->dt/pG->dx1);}
           for (k=kcs, kk=0; k<=kce; k++, kk++) {
           for (j=jcs, jj=0; j<=jce; j++, jj++) {
-            pG->U[k][j][i].d  -= q1*(pCO->myFlx[dim][kk][jj].d  - *(pRcv++));
-            pG->U[k][j][i].M1 -= q1*(pCO->myFlx[dim][kk][jj].M1 - *(pRcv++));
-            pG->U[k][j][i].M2 -= q1*(pCO->myFlx[dim][kk][jj].M2 - *(pRcv++));
-            pG->U[k][j][i].M3 -= q1*(pCO->myFlx[dim][kk][jj].M3 - *(pRcv++));
+            GRID_U(pG,k,j,i,d)  -= q1*(pCO->myFlx[dim][kk][jj].d  - *(pRcv++));
+            GRID_U(pG,k,j,i,M1) -= q1*(pCO->myFlx[dim][kk][jj].M1 - *(pRcv++));
+            GRID_U(pG,k,j,i,M2) -= q1*(pCO->myFlx[dim][kk][jj].M2 - *(pRcv++));
+            GRID_U(pG,k,j,i,M3) -= q1*(pCO->myFlx[dim][kk][jj].M3 - *(pRcv++));
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  -= q1*(pCO->myFlx[dim][kk][jj].E  - *(pRcv++));
+            GRID_U(pG,k,j,i,E)  -= q1*(pCO->myFlx[dim][kk][jj].E  - *(pRcv++));
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c -= q1*(pCO->myFlx[dim][kk][jj].B1c - *(pRcv++));
-            pG->U[k][j][i].B2c -= q1*(pCO->myFlx[dim][kk][jj].B2c - *(pRcv++));
-            pG->U[k][j][i].B3c -= q1*(pCO->myFlx[dim][kk][jj].B3c - *(pRcv++));
+            GRID_U(pG,k,j,i,B1c) -= q1*(pCO->myFlx[dim][kk][jj].B1c - *(pRcv++));
+            GRID_U(pG,k,j,i,B2c) -= q1*(pCO->myFlx[dim][kk][jj].B2c - *(pRcv++));
+            GRID_U(pG,k,j,i,B3c) -= q1*(pCO->myFlx[dim][kk][jj].B3c - *(pRcv++));
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] -= 
+            for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) -= 
               q1*(pCO->myFlx[dim][kk][jj].s[n] - *(pRcv++));
 #endif
           }}
@@ -420,20 +841,20 @@ void RestrictCorrect(MeshS *pM)
           if (dim == 3) {j=jce+1; q2= (pG->dt/pG->dx2);}
           for (k=kcs, kk=0; k<=kce; k++, kk++) {
           for (i=ics, ii=0; i<=ice; i++, ii++) {
-            pG->U[k][j][i].d  -= q2*(pCO->myFlx[dim][kk][ii].d  - *(pRcv++));
-            pG->U[k][j][i].M1 -= q2*(pCO->myFlx[dim][kk][ii].M1 - *(pRcv++));
-            pG->U[k][j][i].M2 -= q2*(pCO->myFlx[dim][kk][ii].M2 - *(pRcv++));
-            pG->U[k][j][i].M3 -= q2*(pCO->myFlx[dim][kk][ii].M3 - *(pRcv++));
+            GRID_U(pG,k,j,i,d)  -= q2*(pCO->myFlx[dim][kk][ii].d  - *(pRcv++));
+            GRID_U(pG,k,j,i,M1) -= q2*(pCO->myFlx[dim][kk][ii].M1 - *(pRcv++));
+            GRID_U(pG,k,j,i,M2) -= q2*(pCO->myFlx[dim][kk][ii].M2 - *(pRcv++));
+            GRID_U(pG,k,j,i,M3) -= q2*(pCO->myFlx[dim][kk][ii].M3 - *(pRcv++));
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  -= q2*(pCO->myFlx[dim][kk][ii].E  - *(pRcv++));
+            GRID_U(pG,k,j,i,E)  -= q2*(pCO->myFlx[dim][kk][ii].E  - *(pRcv++));
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c -= q2*(pCO->myFlx[dim][kk][ii].B1c - *(pRcv++));
-            pG->U[k][j][i].B2c -= q2*(pCO->myFlx[dim][kk][ii].B2c - *(pRcv++));
-            pG->U[k][j][i].B3c -= q2*(pCO->myFlx[dim][kk][ii].B3c - *(pRcv++));
+            GRID_U(pG,k,j,i,B1c) -= q2*(pCO->myFlx[dim][kk][ii].B1c - *(pRcv++));
+            GRID_U(pG,k,j,i,B2c) -= q2*(pCO->myFlx[dim][kk][ii].B2c - *(pRcv++));
+            GRID_U(pG,k,j,i,B3c) -= q2*(pCO->myFlx[dim][kk][ii].B3c - *(pRcv++));
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] -= 
+            for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) -= 
               q2*(pCO->myFlx[dim][kk][ii].s[n] - *(pRcv++));
 #endif
           }}
@@ -448,20 +869,20 @@ void RestrictCorrect(MeshS *pM)
           if (dim == 5) {k=kce+1; q3= (pG->dt/pG->dx3);}
           for (j=jcs, jj=0; j<=jce; j++, jj++) {
           for (i=ics, ii=0; i<=ice; i++, ii++) {
-            pG->U[k][j][i].d  -= q3*(pCO->myFlx[dim][jj][ii].d  - *(pRcv++));
-            pG->U[k][j][i].M1 -= q3*(pCO->myFlx[dim][jj][ii].M1 - *(pRcv++));
-            pG->U[k][j][i].M2 -= q3*(pCO->myFlx[dim][jj][ii].M2 - *(pRcv++));
-            pG->U[k][j][i].M3 -= q3*(pCO->myFlx[dim][jj][ii].M3 - *(pRcv++));
+            GRID_U(pG,k,j,i,d)  -= q3*(pCO->myFlx[dim][jj][ii].d  - *(pRcv++));
+            GRID_U(pG,k,j,i,M1) -= q3*(pCO->myFlx[dim][jj][ii].M1 - *(pRcv++));
+            GRID_U(pG,k,j,i,M2) -= q3*(pCO->myFlx[dim][jj][ii].M2 - *(pRcv++));
+            GRID_U(pG,k,j,i,M3) -= q3*(pCO->myFlx[dim][jj][ii].M3 - *(pRcv++));
 #ifndef BAROTROPIC
-            pG->U[k][j][i].E  -= q3*(pCO->myFlx[dim][jj][ii].E  - *(pRcv++));
+            GRID_U(pG,k,j,i,E)  -= q3*(pCO->myFlx[dim][jj][ii].E  - *(pRcv++));
 #endif /* BAROTROPIC */
 #ifdef MHD
-            pG->U[k][j][i].B1c -= q3*(pCO->myFlx[dim][jj][ii].B1c - *(pRcv++));
-            pG->U[k][j][i].B2c -= q3*(pCO->myFlx[dim][jj][ii].B2c - *(pRcv++));
-            pG->U[k][j][i].B3c -= q3*(pCO->myFlx[dim][jj][ii].B3c - *(pRcv++));
+            GRID_U(pG,k,j,i,B1c) -= q3*(pCO->myFlx[dim][jj][ii].B1c - *(pRcv++));
+            GRID_U(pG,k,j,i,B2c) -= q3*(pCO->myFlx[dim][jj][ii].B2c - *(pRcv++));
+            GRID_U(pG,k,j,i,B3c) -= q3*(pCO->myFlx[dim][jj][ii].B3c - *(pRcv++));
 #endif /* MHD */
 #if (NSCALARS > 0)
-            for (n=0; n<NSCALARS; n++) pG->U[k][j][i].s[n] -= 
+            for (n=0; n<NSCALARS; n++) GRID_U(pG,k,j,i,s[n]) -= 
               q3*(pCO->myFlx[dim][jj][ii].s[n] - *(pRcv++));
 #endif
           }}
@@ -576,18 +997,18 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 
             for (k=kcs-1; k<=kce+1; k++) {
             for (j=jcs; j<=jce; j++) {
-              pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+              GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
             }}
 
           }
 
           for (k=kcs; k<=kce; k++) {
             for (j=jcs; j<=jce; j++) {
-              pG->U[k][j][ib  ].B1c=0.5*(pG->B1i[k][j][ib]+pG->B1i[k][j][ib+1]);
-              pG->U[k][j][ib-1].B1c=0.5*(pG->B1i[k][j][ib-1]+pG->B1i[k][j][ib]);
+              GRID_U(pG,k,j,ib,B1c)=0.5*(pG->B1i[k][j][ib]+pG->B1i[k][j][ib+1]);
+              GRID_U(pG,k,j,ib-1,B1c)=0.5*(pG->B1i[k][j][ib-1]+pG->B1i[k][j][ib]);
             }
             for (j=jcs-1; j<=jce+1; j++) {
-              pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+              GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
             }
           }
         }
@@ -686,18 +1107,18 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 
             for (k=kcs-1; k<=kce+1; k++) {
             for (i=ics; i<=ice; i++) {
-              pG->U[k][j][i].B3c = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
+              GRID_U(pG,k,j,i,B3c) = 0.5*(pG->B3i[k][j][i] + pG->B3i[k+1][j][i]);
             }}
 
           }
 
           for (k=kcs; k<=kce; k++) {
             for (i=ics-1; i<=ice+1; i++) {
-              pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+              GRID_U(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
             }
             for (i=ics; i<=ice; i++) {
-              pG->U[k][jb  ][i].B2c=0.5*(pG->B2i[k][jb][i]+pG->B2i[k][jb+1][i]);
-              pG->U[k][jb-1][i].B2c=0.5*(pG->B2i[k][jb-1][i]+pG->B2i[k][jb][i]);
+              GRID_U(pG,k,jb,i,B2c)=0.5*(pG->B2i[k][jb][i]+pG->B2i[k][jb+1][i]);
+              GRID_U(pG,k,jb-1,i,B2c)=0.5*(pG->B2i[k][jb-1][i]+pG->B2i[k][jb][i]);
             }
           }
         }
@@ -786,18 +1207,18 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 
           for (j=jcs; j<=jce; j++) {
           for (i=ics-1; i<=ice+1; i++) {
-            pG->U[k][j][i].B1c = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
+            GRID_U(pG,k,j,i,B1c) = 0.5*(pG->B1i[k][j][i] + pG->B1i[k][j][i+1]);
           }}
 
           for (j=jcs-1; j<=jce+1; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[k][j][i].B2c = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
+            GRID_U(pG,k,j,i,B2c) = 0.5*(pG->B2i[k][j][i] + pG->B2i[k][j+1][i]);
           }}
 
           for (j=jcs; j<=jce; j++) {
           for (i=ics; i<=ice; i++) {
-            pG->U[kb  ][j][i].B3c=0.5*(pG->B3i[kb][j][i] + pG->B3i[kb+1][j][i]);
-            pG->U[kb-1][j][i].B3c=0.5*(pG->B3i[kb-1][j][i] + pG->B3i[kb][j][i]);
+            GRID_U(pG,kb,j,i,B3c)=0.5*(pG->B3i[kb][j][i] + pG->B3i[kb+1][j][i]);
+            GRID_U(pG,kb-1,j,i,B3c)=0.5*(pG->B3i[kb-1][j][i] + pG->B3i[kb][j][i]);
           }}
         }
       }
@@ -811,10 +1232,12 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
 /*=== Step 3. Restrict child solution and fluxes and send ====================*/
 /* Loop over all Domains and parent Grids.  Maxlevel grids skip straight to this
  * step to start the chain of communication.  Root (level=0) skips this step
- * since it has NPGrid=0.  If there is a parent Grid on this processor, it will
- * be first in the PGrid array, so it will be at start of send_bufRC */
+ * since it has NPGrid=0, and so does level nlc since its parents are not being
+ * corrected.  If there is a parent Grid on this processor, it will be first in
+ * the PGrid array, so it will be at start of send_bufRC */
 
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+  ndRC = (nl > nlc) ? pM->DomainsPerLevel[nl] : 0;
+  for (nd=0; nd<ndRC; nd++){
 
   if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
     pG=pM->Domain[nl][nd].Grid;          /* set pointer to this Grid */
@@ -850,21 +1273,21 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
       for (k=kps; k<=kpe; k+=2) {
       for (j=jps; j<=jpe; j+=2) {
       for (i=ips; i<=ipe; i+=2) {
-        *(pSnd++) = pG->U[k][j][i].d  + pG->U[k][j][i+1].d;
-        *(pSnd++) = pG->U[k][j][i].M1 + pG->U[k][j][i+1].M1;
-        *(pSnd++) = pG->U[k][j][i].M2 + pG->U[k][j][i+1].M2;
-        *(pSnd++) = pG->U[k][j][i].M3 + pG->U[k][j][i+1].M3;
+        *(pSnd++) = GRID_U(pG,k,j,i,d)  + GRID_U(pG,k,j,i+1,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1) + GRID_U(pG,k,j,i+1,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2) + GRID_U(pG,k,j,i+1,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3) + GRID_U(pG,k,j,i+1,M3);
 #ifndef BAROTROPIC
-        *(pSnd++) = pG->U[k][j][i].E  + pG->U[k][j][i+1].E;
+        *(pSnd++) = GRID_U(pG,k,j,i,E)  + GRID_U(pG,k,j,i+1,E);
 #endif
 #ifdef MHD
-        *(pSnd++) = pG->U[k][j][i].B1c + pG->U[k][j][i+1].B1c;
-        *(pSnd++) = pG->U[k][j][i].B2c + pG->U[k][j][i+1].B2c;
-        *(pSnd++) = pG->U[k][j][i].B3c + pG->U[k][j][i+1].B3c;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c) + GRID_U(pG,k,j,i+1,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c) + GRID_U(pG,k,j,i+1,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c) + GRID_U(pG,k,j,i+1,B3c);
 #endif
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++) 
-          *(pSnd++) = pG->U[k][j][i].s[n] + pG->U[k][j][i+1].s[n];
+          *(pSnd++) = GRID_U(pG,k,j,i,s[n]) + GRID_U(pG,k,j,i+1,s[n]);
 #endif
       }}}
       fact = 0.5;
@@ -877,21 +1300,21 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
         for (k=kps; k<=kpe; k+=2) {
         for (j=jps; j<=jpe; j+=2) {
         for (i=ips; i<=ipe; i+=2) {
-          *(pSnd++) += pG->U[k][j+1][i].d  + pG->U[k][j+1][i+1].d;
-          *(pSnd++) += pG->U[k][j+1][i].M1 + pG->U[k][j+1][i+1].M1;
-          *(pSnd++) += pG->U[k][j+1][i].M2 + pG->U[k][j+1][i+1].M2;
-          *(pSnd++) += pG->U[k][j+1][i].M3 + pG->U[k][j+1][i+1].M3;
+          *(pSnd++) += GRID_U(pG,k,j+1,i,d)  + GRID_U(pG,k,j+1,i+1,d);
+          *(pSnd++) += GRID_U(pG,k,j+1,i,M1) + GRID_U(pG,k,j+1,i+1,M1);
+          *(pSnd++) += GRID_U(pG,k,j+1,i,M2) + GRID_U(pG,k,j+1,i+1,M2);
+          *(pSnd++) += GRID_U(pG,k,j+1,i,M3) + GRID_U(pG,k,j+1,i+1,M3);
 #ifndef BAROTROPIC
-          *(pSnd++) += pG->U[k][j+1][i].E  + pG->U[k][j+1][i+1].E;
+          *(pSnd++) += GRID_U(pG,k,j+1,i,E)  + GRID_U(pG,k,j+1,i+1,E);
 #endif
 #ifdef MHD
-          *(pSnd++) += pG->U[k][j+1][i].B1c + pG->U[k][j+1][i+1].B1c;
-          *(pSnd++) += pG->U[k][j+1][i].B2c + pG->U[k][j+1][i+1].B2c;
-          *(pSnd++) += pG->U[k][j+1][i].B3c + pG->U[k][j+1][i+1].B3c;
+          *(pSnd++) += GRID_U(pG,k,j+1,i,B1c) + GRID_U(pG,k,j+1,i+1,B1c);
+          *(pSnd++) += GRID_U(pG,k,j+1,i,B2c) + GRID_U(pG,k,j+1,i+1,B2c);
+          *(pSnd++) += GRID_U(pG,k,j+1,i,B3c) + GRID_U(pG,k,j+1,i+1,B3c);
 #endif
 #if (NSCALARS > 0)
           for (n=0; n<NSCALARS; n++) 
-            *(pSnd++) += pG->U[k][j+1][i].s[n] + pG->U[k][j+1][i+1].s[n];
+            *(pSnd++) += GRID_U(pG,k,j+1,i,s[n]) + GRID_U(pG,k,j+1,i+1,s[n]);
 #endif
         }}}
         fact = 0.25;
@@ -905,30 +1328,30 @@ printf("js,je = %i %i jcs/jce = %i %i\n",pG->js,pG->je,jcs,jce);
         for (k=kps; k<=kpe; k+=2) {
         for (j=jps; j<=jpe; j+=2) {
         for (i=ips; i<=ipe; i+=2) {
-          *(pSnd++) += pG->U[k+1][j  ][i].d  + pG->U[k+1][j  ][i+1].d +
-                       pG->U[k+1][j+1][i].d  + pG->U[k+1][j+1][i+1].d;
-          *(pSnd++) += pG->U[k+1][j  ][i].M1 + pG->U[k+1][j  ][i+1].M1 +
-                       pG->U[k+1][j+1][i].M1 + pG->U[k+1][j+1][i+1].M1;
-          *(pSnd++) += pG->U[k+1][j  ][i].M2 + pG->U[k+1][j  ][i+1].M2 +
-                       pG->U[k+1][j+1][i].M2 + pG->U[k+1][j+1][i+1].M2;
-          *(pSnd++) += pG->U[k+1][j  ][i].M3 + pG->U[k+1][j  ][i+1].M3 +
-                       pG->U[k+1][j+1][i].M3 + pG->U[k+1][j+1][i+1].M3;
+          *(pSnd++) += GRID_U(pG,k+1,j,i,d)  + GRID_U(pG,k+1,j,i+1,d) +
+                       GRID_U(pG,k+1,j+1,i,d)  + GRID_U(pG,k+1,j+1,i+1,d);
+          *(pSnd++) += GRID_U(pG,k+1,j,i,M1) + GRID_U(pG,k+1,j,i+1,M1) +
+                       GRID_U(pG,k+1,j+1,i,M1) + GRID_U(pG,k+1,j+1,i+1,M1);
+          *(pSnd++) += GRID_U(pG,k+1,j,i,M2) + GRID_U(pG,k+1,j,i+1,M2) +
+                       GRID_U(pG,k+1,j+1,i,M2) + GRID_U(pG,k+1,j+1,i+1,M2);
+          *(pSnd++) += GRID_U(pG,k+1,j,i,M3) + GRID_U(pG,k+1,j,i+1,M3) +
+                       GRID_U(pG,k+1,j+1,i,M3) + GRID_U(pG,k+1,j+1,i+1,M3);
 #ifndef BAROTROPIC
-          *(pSnd++) += pG->U[k+1][j  ][i].E  + pG->U[k+1][j  ][i+1].E +
-                       pG->U[k+1][j+1][i].E  + pG->U[k+1][j+1][i+1].E;
+          *(pSnd++) += GRID_U(pG,k+1,j,i,E)  + GRID_U(pG,k+1,j,i+1,E) +
+                       GRID_U(pG,k+1,j+1,i,E)  + GRID_U(pG,k+1,j+1,i+1,E);
 #endif
 #ifdef MHD
-          *(pSnd++) += pG->U[k+1][j  ][i].B1c + pG->U[k+1][j  ][i+1].B1c +
-                       pG->U[k+1][j+1][i].B1c + pG->U[k+1][j+1][i+1].B1c;
-          *(pSnd++) += pG->U[k+1][j  ][i].B2c + pG->U[k+1][j  ][i+1].B2c +
-                       pG->U[k+1][j+1][i].B2c + pG->U[k+1][j+1][i+1].B2c;
-          *(pSnd++) += pG->U[k+1][j  ][i].B3c + pG->U[k+1][j  ][i+1].B3c +
-                       pG->U[k+1][j+1][i].B3c + pG->U[k+1][j+1][i+1].B3c;
+          *(pSnd++) += GRID_U(pG,k+1,j,i,B1c) + GRID_U(pG,k+1,j,i+1,B1c) +
+                       GRID_U(pG,k+1,j+1,i,B1c) + GRID_U(pG,k+1,j+1,i+1,B1c);
+          *(pSnd++) += GRID_U(pG,k+1,j,i,B2c) + GRID_U(pG,k+1,j,i+1,B2c) +
+                       GRID_U(pG,k+1,j+1,i,B2c) + GRID_U(pG,k+1,j+1,i+1,B2c);
+          *(pSnd++) += GRID_U(pG,k+1,j,i,B3c) + GRID_U(pG,k+1,j,i+1,B3c) +
+                       GRID_U(pG,k+1,j+1,i,B3c) + GRID_U(pG,k+1,j+1,i+1,B3c);
 #endif
 #if (NSCALARS > 0)
           for (n=0; n<NSCALARS; n++) 
-            *(pSnd++) += pG->U[k+1][j  ][i].s[n] + pG->U[k+1][j  ][i+1].s[n] +
-                         pG->U[k+1][j+1][i].s[n] + pG->U[k+1][j+1][i+1].s[n];
+            *(pSnd++) += GRID_U(pG,k+1,j,i,s[n]) + GRID_U(pG,k+1,j,i+1,s[n]) +
+                         GRID_U(pG,k+1,j+1,i,s[n]) + GRID_U(pG,k+1,j+1,i+1,s[n]);
 #endif
         }}}
         fact = 0.125;
@@ -1315,10 +1738,16 @@ printf("cnt = %i\n", cnt);
 /* non-blocking send with MPI, using Domain number as tag.  */
 
       if (npg >= pG->NmyPGrid){
+#ifdef SMR_AGGREGATE
+/* copy into the aggregated message to the processor of the parent Grid */
+        memcpy(pG->PGrid[npg].pAggRC, &(send_bufRC[nd][start_addr]),
+               pG->PGrid[npg].nWordsRC*sizeof(double));
+#else
         mIndex = npg - pG->NmyPGrid - nZeroRC;
         ierr = MPI_Isend(&(send_bufRC[nd][start_addr]), pG->PGrid[npg].nWordsRC,
           MPI_DOUBLE, pG->PGrid[npg].ID, nd, pM->Domain[nl][nd].Comm_Parent,
           &(send_rq[nd][mIndex]));
+#endif /* SMR_AGGREGATE */
       }
 #endif /* MPI_PARALLEL */
 
@@ -1329,11 +1758,20 @@ printf("cnt = %i\n", cnt);
   }} /* end loop over Domains per level */
 
 #ifdef MPI_PARALLEL
+#ifdef SMR_AGGREGATE
+/*--- Step 4. Start aggregated sends. ----------------------------------------*/
+/* Each message holds the data of all Domains on this level, so is sent once
+ * they are all loaded.  The sends are completed after the loop over levels,
+ * so they overlap the restriction and flux correction of the parent level. */
+
+  if (nl > nlc && AggRC[nl-1].nSend > 0)
+    ierr = MPI_Startall(AggRC[nl-1].nSend, AggRC[nl-1].send_rq);
+#else
 /*--- Step 4. Check non-blocking sends completed. ----------------------------*/
 /* For MPI jobs, wait for all non-blocking sends in Step 3e to complete.  This
  * is more efficient if there are multiple messages per Grid. */
 
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+  for (nd=0; nd<ndRC; nd++){
     if (pM->Domain[nl][nd].Grid != NULL) {
       pG=pM->Domain[nl][nd].Grid;
       nZeroRC = 0;
@@ -1348,25 +1786,43 @@ printf("cnt = %i\n", cnt);
       }
     }
   }
+#endif /* SMR_AGGREGATE */
 #endif /* MPI_PARALLEL */
 
   } /* end loop over levels */
+
+#ifdef SMR_AGGREGATE
+/* Wait for the aggregated sends started in Step 4 to complete */
+
+  for (nl=nlc; nl<nlf; nl++){
+    if (AggRC[nl].nSend > 0)
+      ierr = MPI_Waitall(AggRC[nl].nSend,AggRC[nl].send_rq,MPI_STATUSES_IGNORE);
+  }
+#endif /* SMR_AGGREGATE */
 }
 
-/*============================================================================*/
 /*----------------------------------------------------------------------------*/
-/*! \fn void Prolongate(MeshS *pM)
- *  \brief Sets BC on fine Grid by prolongation (interpolation) of
- *     coarse Grid solution into fine grid ghost zones */
-void Prolongate(MeshS *pM)
+/*! \fn static void prolong_levels(MeshS *pM, const int nlc, const int nlf,
+ *                                 const Real frac)
+ *  \brief Sets ghost zones at fine/coarse boundaries of levels nlc+1..nlf by
+ *   prolongation from their parents, starting at level nlc.  With subcycling,
+ *   the data sent from level nlc is interpolated in time to the fraction frac
+ *   of its last step (frac=1 at the end of the step, without interpolation).
+ */
+
+static void prolong_levels(MeshS *pM, const int nlc, const int nlf,
+                           const Real frac)
 {
   GridS *pG;
-  int nDim,nl,nd,ncg,dim,npg,rbufN,id,l,m,n,mend,nend,nZeroP;
-  int i,ii,ics,ice,ips,ipe,igzs,igze;
-  int j,jj,jcs,jce,jps,jpe,jgzs,jgze;
-  int k,kk,kcs,kce,kps,kpe,kgzs,kgze;
+  int nDim,nl,nd,ndP,ndGZ,ncg,dim,npg,rbufN,id,l,m,n,mend,nend,nZeroP;
+  int i,ii,ips,ipe,igzs,igze;
+  int j,jj,jps,jpe,jgzs,jgze;
+  int k,kk,kps,kpe,kgzs,kgze;
   int ngz1,ngz2,ngz3;
   double *pRcv,*pSnd;
+#ifdef SMR_SUBCYCLE
+  double *pOld;
+#endif
   GridOvrlpS *pCO, *pPO;
   ConsS ProlongedC[2][2][2];
 #if (NSCALARS > 0)
@@ -1378,21 +1834,31 @@ void Prolongate(MeshS *pM)
 #ifdef MPI_PARALLEL
   int ierr,mAddress,mIndex,mCount;
 #endif
+#ifdef SMR_AGGREGATE
+  AggMsgS *pA;
+#endif
 
 /* number of dimensions in Grid. */
   nDim=1;
   for (dim=1; dim<3; dim++) if (pM->Nx[dim]>1) nDim++;
 
-/* Loop over all levels, starting at root level */
+/* Loop over levels nlc..nlf, starting at coarsest */
 
-  for (nl=0; nl<(pM->NLevels); nl++){
+  for (nl=nlc; nl<=nlf; nl++){
 
 #ifdef MPI_PARALLEL
 /* Post non-blocking receives at level nl+1 for data from parent Grids at this
  * level (nl). This data is sent in Step 1 below,
  * and will be read in Step 2 during the next iteration of nl */
 
-  if (nl<(pM->NLevels)-1) {
+  if (nl<nlf) {
+#ifdef SMR_AGGREGATE
+/* With aggregated messages, start the persistent receives from all processors
+ * with parent Grids on this level */
+    pA = &(AggP[nl]);
+    for (i=0; i<pA->nRecv; i++) pA->done[i] = 0;
+    if (pA->nRecv > 0) ierr = MPI_Startall(pA->nRecv, pA->recv_rq);
+#else
     for (nd=0; nd<(pM->DomainsPerLevel[nl+1]); nd++){
       if (pM->Domain[nl+1][nd].Grid != NULL) {
         pG=pM->Domain[nl+1][nd].Grid;
@@ -1426,13 +1892,16 @@ void Prolongate(MeshS *pM)
 
       }
     }
+#endif /* SMR_AGGREGATE */
   }
 #endif /* MPI_PARALLEL */
 
 /*=== Step 1. Send step ======================================================*/
-/* Loop over all Domains, and send ghost zones to all child Grids. */
+/* Loop over all Domains, and send ghost zones to all child Grids.  Level nlf
+ * skips this step since its children are not being prolongated. */
 
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+  ndP = (nl < nlf) ? pM->DomainsPerLevel[nl] : 0;
+  for (nd=0; nd<ndP; nd++){
 
   if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
     pG=pM->Domain[nl][nd].Grid;
@@ -1453,72 +1922,31 @@ void Prolongate(MeshS *pM)
  * same processor.  Start address must be different for each DomN */
       pSnd = (double*)&(send_bufP[pCO->DomN][start_addrP[pCO->DomN]]); 
 
-      for (dim=0; dim<(2*nDim); dim++){
-        if (pCO->myFlx[dim] != NULL) {
-
-/* Get coordinates ON THIS GRID of zones that overlap child Grid ghost zones */
-
-          ics = pCO->ijks[0] - (nghost/2) - 1;
-          ice = pCO->ijke[0] + (nghost/2) + 1;
-          if (pG->Nx[1] > 1) {
-            jcs = pCO->ijks[1] - (nghost/2) - 1;
-            jce = pCO->ijke[1] + (nghost/2) + 1;
-          } else {
-            jcs = pCO->ijks[1];
-            jce = pCO->ijke[1];
-          }
-          if (pG->Nx[2] > 1) {
-            kcs = pCO->ijks[2] - (nghost/2) - 1;
-            kce = pCO->ijke[2] + (nghost/2) + 1;
-          } else {
-            kcs = pCO->ijks[2];
-            kce = pCO->ijke[2];
-          }
-          if (dim == 0) ice = pCO->ijks[0];
-          if (dim == 1) ics = pCO->ijke[0];
-          if (dim == 2) jce = pCO->ijks[1];
-          if (dim == 3) jcs = pCO->ijke[1];
-          if (dim == 4) kce = pCO->ijks[2];
-          if (dim == 5) kcs = pCO->ijke[2];
-
-/*--- Step 1a. ---------------------------------------------------------------*/
-/* Load send buffer with values in zones that overlap child ghost zones */
+      pack_prolong(pG,pCO,nDim,pSnd);
 
-          for (k=kcs; k<=kce; k++) {
-          for (j=jcs; j<=jce; j++) {
-          for (i=ics; i<=ice; i++) {
-            *(pSnd++) = pG->U[k][j][i].d;
-            *(pSnd++) = pG->U[k][j][i].M1;
-            *(pSnd++) = pG->U[k][j][i].M2;
-            *(pSnd++) = pG->U[k][j][i].M3;
-#ifndef BAROTROPIC
-            *(pSnd++) = pG->U[k][j][i].E;
-#endif
-#ifdef MHD
-            *(pSnd++) = pG->U[k][j][i].B1c;
-            *(pSnd++) = pG->U[k][j][i].B2c;
-            *(pSnd++) = pG->U[k][j][i].B3c;
-            *(pSnd++) = pG->B1i[k][j][i];
-            *(pSnd++) = pG->B2i[k][j][i];
-            *(pSnd++) = pG->B3i[k][j][i];
-#endif
-#if (NSCALARS > 0)
-            for (ns=0; ns<NSCALARS; ns++) {
-               *(pSnd++) = pG->U[k][j][i].s[ns];
-            }
-#endif
-          }}}
-        }
+#ifdef SMR_SUBCYCLE
+/* With subcycling, interpolate linearly in time between the values saved by
+ * save_prolong() at the start of the last step on this level and its end */
+      if (frac < 1.0) {
+        pOld = &(old_bufP[nl][pCO->DomN][start_addrP[pCO->DomN]]);
+        for (i=0; i<pCO->nWordsP; i++)
+          pSnd[i] = pOld[i] + frac*(pSnd[i] - pOld[i]);
       }
+#endif
 
 /*--- Step 1b. ---------------------------------------------------------------*/
 /* non-blocking send of data to child, using Domain number as tag. */
 #ifdef MPI_PARALLEL
       if (ncg >= pG->NmyCGrid) {
+#ifdef SMR_AGGREGATE
+/* copy into the aggregated message to the processor of the child Grid */
+        memcpy(pCO->pAggP, pSnd, pCO->nWordsP*sizeof(double));
+#else
         mIndex = ncg - pG->NmyCGrid - nZeroP;
         ierr = MPI_Isend(&(send_bufP[pCO->DomN][start_addrP[pCO->DomN]]),
           pG->CGrid[ncg].nWordsP, MPI_DOUBLE, pG->CGrid[ncg].ID, nd,
           pM->Domain[nl][nd].Comm_Children, &(send_rq[nd][mIndex]));
+#endif /* SMR_AGGREGATE */
       }
 #endif /* MPI_PARALLEL */
 
@@ -1528,12 +1956,22 @@ void Prolongate(MeshS *pM)
     } /* end loop over child grids */
   }} /* end loop over Domains */
 
+#ifdef SMR_AGGREGATE
+/*--- Step 1c. ---------------------------------------------------------------*/
+/* Start the aggregated sends, once the data of all Domains is loaded.  They
+ * are completed after the loop over levels. */
+
+  if (nl < nlf && AggP[nl].nSend > 0)
+    ierr = MPI_Startall(AggP[nl].nSend, AggP[nl].send_rq);
+#endif /* SMR_AGGREGATE */
+
 /*=== Step 2. Get step =======================================================*/
 /* Loop over all Domains, get data sent by parent Grids, and prolongate solution
- * into ghost zones. */
-
+ * into ghost zones.  Level nlc skips this step since its parents have not sent
+ * any data. */
 
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+  ndGZ = (nl > nlc) ? pM->DomainsPerLevel[nl] : 0;
+  for (nd=0; nd<ndGZ; nd++){
 
   if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this processor */
     pG=pM->Domain[nl][nd].Grid;          /* set pointer to Grid */
@@ -1542,6 +1980,9 @@ void Prolongate(MeshS *pM)
 /* Loop over number of parent grids with non-zero-size prolongation data */
     nZeroP = 0;
     for (i=pG->NmyPGrid; i<pG->NPGrid; i++) if(pG->PGrid[i].nWordsP==0) nZeroP++;
+#ifdef SMR_AGGREGATE
+    for (i=0; i<pG->NPGrid; i++) Taken[i] = 0;
+#endif
 
     for (npg=0; npg<(pG->NPGrid - nZeroP); npg++){
 
@@ -1553,6 +1994,13 @@ void Prolongate(MeshS *pM)
       } else {
 
 #ifdef MPI_PARALLEL
+#ifdef SMR_AGGREGATE
+/* Take the parent Grids in the order their aggregated messages arrive */
+
+        mIndex = agg_next(&(AggP[nl-1]),pG->PGrid,pG->NmyPGrid,pG->NPGrid,0);
+        pPO = (GridOvrlpS*)&(pG->PGrid[mIndex]);
+        pRcv = pPO->pAggP;
+#else
 /* Check non-blocking receives posted above for data in ghost zone from parent
  * Grids, sent in Step 1.  Accept messages in any order. */
 
@@ -1573,6 +2021,7 @@ void Prolongate(MeshS *pM)
         for (i=0; i<mIndex; i++) mAddress += pG->PGrid[i].nWordsP;
         pPO = (GridOvrlpS*)&(pG->PGrid[mIndex]); 
         pRcv = (double*)&(recv_bufP[rbufN][nd][mAddress]);
+#endif /* SMR_AGGREGATE */
 
 #else
 /* If not MPI_PARALLEL, and parent Grid not on this processor, then error */
@@ -1730,21 +2179,21 @@ void Prolongate(MeshS *pM)
             for (n=0; n<=nend; n++) {
             for (m=0; m<=mend; m++) {
             for (l=0; l<=1; l++) {
-              pG->U[k+n][j+m][i+l].d  = ProlongedC[n][m][l].d;
-              pG->U[k+n][j+m][i+l].M1 = ProlongedC[n][m][l].M1;
-              pG->U[k+n][j+m][i+l].M2 = ProlongedC[n][m][l].M2;
-              pG->U[k+n][j+m][i+l].M3 = ProlongedC[n][m][l].M3;
+              GRID_U(pG,k+n,j+m,i+l,d)  = ProlongedC[n][m][l].d;
+              GRID_U(pG,k+n,j+m,i+l,M1) = ProlongedC[n][m][l].M1;
+              GRID_U(pG,k+n,j+m,i+l,M2) = ProlongedC[n][m][l].M2;
+              GRID_U(pG,k+n,j+m,i+l,M3) = ProlongedC[n][m][l].M3;
 #ifndef BAROTROPIC
-              pG->U[k+n][j+m][i+l].E  = ProlongedC[n][m][l].E;
+              GRID_U(pG,k+n,j+m,i+l,E)  = ProlongedC[n][m][l].E;
 #endif
 #ifdef MHD
-              pG->U[k+n][j+m][i+l].B1c = ProlongedC[n][m][l].B1c;
-              pG->U[k+n][j+m][i+l].B2c = ProlongedC[n][m][l].B2c;
-              pG->U[k+n][j+m][i+l].B3c = ProlongedC[n][m][l].B3c;
+              GRID_U(pG,k+n,j+m,i+l,B1c) = ProlongedC[n][m][l].B1c;
+              GRID_U(pG,k+n,j+m,i+l,B2c) = ProlongedC[n][m][l].B2c;
+              GRID_U(pG,k+n,j+m,i+l,B3c) = ProlongedC[n][m][l].B3c;
 #endif
 #if (NSCALARS > 0)
               for (ns=0; ns<NSCALARS; ns++) 
-                pG->U[k+n][j+m][i+l].s[ns] = ProlongedC[n][m][l].s[ns];
+                GRID_U(pG,k+n,j+m,i+l,s[ns]) = ProlongedC[n][m][l].s[ns];
 #endif
             }}}
 
@@ -1754,9 +2203,9 @@ void Prolongate(MeshS *pM)
 
             if (nDim == 1) {
               for (l=0; l<=1; l++) {
-                pG->B1i[k][j][i+l] = pG->U[k][j][i+l].B1c;
-                pG->B2i[k][j][i+l] = pG->U[k][j][i+l].B2c;
-                pG->B3i[k][j][i+l] = pG->U[k][j][i+l].B3c;
+                pG->B1i[k][j][i+l] = GRID_U(pG,k,j,i+l,B1c);
+                pG->B2i[k][j][i+l] = GRID_U(pG,k,j,i+l,B2c);
+                pG->B3i[k][j][i+l] = GRID_U(pG,k,j,i+l,B3c);
               }
             } else {
               for (n=0; n<3; n++) {
@@ -1890,11 +2339,11 @@ void Prolongate(MeshS *pM)
                 if (dim != 5 || (k+n) != kps)
                   pG->B3i[k+n][j+m][i+l] = ProlongedF[n][m][l].x3;
 
-                pG->U[k+n][j+m][i+l].B1c = 
+                GRID_U(pG,k+n,j+m,i+l,B1c) = 
                   0.5*(ProlongedF[n][m][l].x1 + ProlongedF[n][m][l+1].x1);
-                pG->U[k+n][j+m][i+l].B2c = 
+                GRID_U(pG,k+n,j+m,i+l,B2c) = 
                   0.5*(ProlongedF[n][m][l].x2 + ProlongedF[n][m+1][l].x2);
-                pG->U[k+n][j+m][i+l].B3c = 
+                GRID_U(pG,k+n,j+m,i+l,B3c) = 
                   0.5*(ProlongedF[n][m][l].x3 + ProlongedF[n+1][m][l].x3);
               }}}
             }
@@ -1913,7 +2362,7 @@ void Prolongate(MeshS *pM)
  * prevent "send" in Step 1 above from over-writing data in buffer on the next
  * iteration of the loop over levels (for nl=nl+1). */
 
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+  for (nd=0; nd<ndP; nd++){
     if (pM->Domain[nl][nd].Grid != NULL) { 
       pG=pM->Domain[nl][nd].Grid; 
       rbufN = ((nl+1) % 2);
@@ -1931,10 +2380,10 @@ void Prolongate(MeshS *pM)
     }
   }
 
-#ifdef MPI_PARALLEL
+#if defined(MPI_PARALLEL) && !defined(SMR_AGGREGATE)
 /* For MPI jobs, wait for all non-blocking sends in Step 1 to complete */
 
-  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+  for (nd=0; nd<ndP; nd++){
     if (pM->Domain[nl][nd].Grid != NULL) {
       pG=pM->Domain[nl][nd].Grid;
 
@@ -1947,129 +2396,480 @@ void Prolongate(MeshS *pM)
       }
     }
   }
-#endif /* MPI_PARALLEL */
+#endif /* MPI_PARALLEL & !SMR_AGGREGATE */
 
   } /* end loop over levels */
+
+#ifdef SMR_AGGREGATE
+/* Wait for the aggregated sends started in Step 1c to complete */
+
+  for (nl=nlc; nl<nlf; nl++){
+    if (AggP[nl].nSend > 0)
+      ierr = MPI_Waitall(AggP[nl].nSend,AggP[nl].send_rq,MPI_STATUSES_IGNORE);
+  }
+#endif /* SMR_AGGREGATE */
 }
 
-/*============================================================================*/
 /*----------------------------------------------------------------------------*/
-/*! \fn void SMR_init(MeshS *pM)
- *  \brief Allocates memory for send/receive buffers
+/*! \fn static void pack_prolong(GridS *pG, GridOvrlpS *pCO, const int nDim,
+ *                               double *pSnd)
+ *  \brief Loads pSnd with the solution in zones of Grid pG that overlap the
+ *   ghost zones of the child Grid with overlap pCO
  */
 
-void SMR_init(MeshS *pM)
+static void pack_prolong(GridS *pG, GridOvrlpS *pCO, const int nDim,
+                         double *pSnd)
 {
-  int nl,nd,sendRC,recvRC,sendP,recvP,npg,ncg;
-  int max_sendRC=1,max_recvRC=1,max_sendP=1,max_recvP=1;
-  int max1=0,max2=0,max3=0,maxCG=1;
+  int dim,i,ics,ice,j,jcs,jce,k,kcs,kce;
+#if (NSCALARS > 0)
+  int ns;
+#endif
+
+  for (dim=0; dim<(2*nDim); dim++){
+    if (pCO->myFlx[dim] != NULL) {
+
+/* Get coordinates ON THIS GRID of zones that overlap child Grid ghost zones */
+
+      ics = pCO->ijks[0] - (nghost/2) - 1;
+      ice = pCO->ijke[0] + (nghost/2) + 1;
+      if (pG->Nx[1] > 1) {
+        jcs = pCO->ijks[1] - (nghost/2) - 1;
+        jce = pCO->ijke[1] + (nghost/2) + 1;
+      } else {
+        jcs = pCO->ijks[1];
+        jce = pCO->ijke[1];
+      }
+      if (pG->Nx[2] > 1) {
+        kcs = pCO->ijks[2] - (nghost/2) - 1;
+        kce = pCO->ijke[2] + (nghost/2) + 1;
+      } else {
+        kcs = pCO->ijks[2];
+        kce = pCO->ijke[2];
+      }
+      if (dim == 0) ice = pCO->ijks[0];
+      if (dim == 1) ics = pCO->ijke[0];
+      if (dim == 2) jce = pCO->ijks[1];
+      if (dim == 3) jcs = pCO->ijke[1];
+      if (dim == 4) kce = pCO->ijks[2];
+      if (dim == 5) kcs = pCO->ijke[2];
+
+/*--- Step 1a. ---------------------------------------------------------------*/
+/* Load send buffer with values in zones that overlap child ghost zones */
+
+      for (k=kcs; k<=kce; k++) {
+      for (j=jcs; j<=jce; j++) {
+      for (i=ics; i<=ice; i++) {
+        *(pSnd++) = GRID_U(pG,k,j,i,d);
+        *(pSnd++) = GRID_U(pG,k,j,i,M1);
+        *(pSnd++) = GRID_U(pG,k,j,i,M2);
+        *(pSnd++) = GRID_U(pG,k,j,i,M3);
+#ifndef BAROTROPIC
+        *(pSnd++) = GRID_U(pG,k,j,i,E);
+#endif
 #ifdef MHD
-  int ngh1;
+        *(pSnd++) = GRID_U(pG,k,j,i,B1c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B2c);
+        *(pSnd++) = GRID_U(pG,k,j,i,B3c);
+        *(pSnd++) = pG->B1i[k][j][i];
+        *(pSnd++) = pG->B2i[k][j][i];
+        *(pSnd++) = pG->B3i[k][j][i];
+#endif
+#if (NSCALARS > 0)
+        for (ns=0; ns<NSCALARS; ns++) {
+           *(pSnd++) = GRID_U(pG,k,j,i,s[ns]);
+        }
 #endif
+      }}}
+    }
+  }
+
+  return;
+}
+
+#ifdef SMR_SUBCYCLE
+/*----------------------------------------------------------------------------*/
+/*! \fn static void advance_level(MeshS *pM, const int nl, const int sub,
+ *                                VDFun_t Integrate)
+ *  \brief Advances the Grids on level nl by one step, which is substep sub (0
+ *   or 1) of the step of their parents, then their children by two substeps,
+ *   and finally restricts the children into them.  Ghost zones of level nl
+ *   must be set at the start of the step.
+ */
+
+static void advance_level(MeshS *pM, const int nl, const int sub,
+                          VDFun_t Integrate)
+{
   GridS *pG;
-  
-  maxND=1;
-  for (nl=0; nl<(pM->NLevels); nl++) maxND=MAX(maxND,pM->DomainsPerLevel[nl]);
-  if((start_addrP = (int*)calloc_1d_array(maxND,sizeof(int))) == NULL)
-    ath_error("[SMR_init]:Failed to allocate start_addrP\n");
+  int nd,n;
 
-/* Loop over all parent Grids of Grids on this processor to find maximum total
- * number of words communicated */
+  if (nl < (pM->NLevels)-1) {
+    TIMER_START(TIMER_SMR);
+    save_prolong(pM,nl);
+    TIMER_STOP(TIMER_SMR);
+  }
 
-  for (nl=0; nl<(pM->NLevels); nl++){
-    for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
-      sendRC=0;
-      recvRC=0;
-      sendP =1;
-      recvP =1;
+  TIMER_START(TIMER_INTEGRATE);
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL){
+      pG = pM->Domain[nl][nd].Grid;
+      (*Integrate)(&(pM->Domain[nl][nd]));
+#ifdef FARGO
+      Fargo(&(pM->Domain[nl][nd]));
+#endif
+      pG->time += pG->dt;
+    }
+  }
+  TIMER_STOP(TIMER_INTEGRATE);
 
-      if (pM->Domain[nl][nd].Grid != NULL) { /* there is a Grid on this proc */
-        pG=pM->Domain[nl][nd].Grid;          /* set pointer to Grid */
+  if (nl > 0) sum_fluxes(pM,nl,sub);
+  if (nl == (pM->NLevels)-1) return;
 
-        for (npg=0; npg<pG->NPGrid; npg++){
-          sendRC += pG->PGrid[npg].nWordsRC;
-          recvP  += pG->PGrid[npg].nWordsP;
-        }
-        for (ncg=0; ncg<pG->NCGrid; ncg++){
-          recvRC += pG->CGrid[ncg].nWordsRC;
-          sendP  += pG->CGrid[ncg].nWordsP;
-        }
+/* Ghost zones of this level at the end of its step are needed to interpolate
+ * the ghost zones of its children in time */
 
-        max_sendRC = MAX(max_sendRC,sendRC);
-        max_recvRC = MAX(max_recvRC,recvRC);
-        max_sendP  = MAX(max_sendP ,sendP );
-        max_recvP  = MAX(max_recvP ,recvP );
-        max1 = MAX(max1,(pG->Nx[0]+1));
-        max2 = MAX(max2,(pG->Nx[1]+1));
-        max3 = MAX(max3,(pG->Nx[2]+1));
-        maxCG = MAX(maxCG,pG->NCGrid);
+  TIMER_START(TIMER_BVALS);
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) bvals_mhd(&(pM->Domain[nl][nd]));
+  }
+  TIMER_STOP(TIMER_BVALS);
+
+/* Two substeps of the children, setting their ghost zones at the start of
+ * each at time t + (n/2)dt of this level */
+
+  for (n=0; n<2; n++){
+    TIMER_START(TIMER_BVALS);
+    for (nd=0; nd<(pM->DomainsPerLevel[nl+1]); nd++){
+      if (pM->Domain[nl+1][nd].Grid != NULL)
+        bvals_mhd(&(pM->Domain[nl+1][nd]));
+    }
+    TIMER_STOP(TIMER_BVALS);
+
+    TIMER_START(TIMER_SMR);
+    prolong_levels(pM,nl,nl+1,0.5*n);
+    TIMER_STOP(TIMER_SMR);
+
+    advance_level(pM,nl+1,n,Integrate);
+  }
+
+  TIMER_START(TIMER_SMR);
+  restrict_levels(pM,nl,nl+1);
+  TIMER_STOP(TIMER_SMR);
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void save_prolong(MeshS *pM, const int nl)
+ *  \brief Saves the data sent to child Grids by Grids on level nl in
+ *   prolong_levels() at the start of their step, in the same order
+ */
+
+static void save_prolong(MeshS *pM, const int nl)
+{
+  GridS *pG;
+  GridOvrlpS *pCO;
+  int nDim,nd,ncg,dim,i;
+
+  nDim=1;
+  for (dim=1; dim<3; dim++) if (pM->Nx[dim]>1) nDim++;
+
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) {
+      pG=pM->Domain[nl][nd].Grid;
+      for(i=0; i<maxND; i++) start_addrP[i] = 0;
+
+      for (ncg=0; ncg<(pG->NCGrid); ncg++){
+        if (pG->CGrid[ncg].nWordsP > 0) {
+          pCO=(GridOvrlpS*)&(pG->CGrid[ncg]);
+          pack_prolong(pG,pCO,nDim,
+            &(old_bufP[nl][pCO->DomN][start_addrP[pCO->DomN]]));
+          start_addrP[pCO->DomN] += pG->CGrid[ncg].nWordsP;
+        }
       }
     }
   }
 
-/* Allocate memory for send/receive buffers and EMFs used in RestrictCorrect */
+  return;
+}
 
-  if((send_bufRC =
-    (double**)calloc_2d_array(maxND,max_sendRC,sizeof(double))) == NULL)
-    ath_error("[SMR_init]:Failed to allocate send_bufRC\n");
+/*----------------------------------------------------------------------------*/
+/*! \fn static void sum_fluxes(MeshS *pM, const int nl, const int sub)
+ *  \brief Averages the fluxes and EMFs stored by the integrator at boundaries
+ *   with parent Grids over the two substeps of level nl.  After substep 0 they
+ *   are saved, after substep 1 replaced by the average of both, which is the
+ *   flux over the step of the parent used by restrict_levels().
+ */
 
-#ifdef MPI_PARALLEL
-  if((recv_bufRC =
-    (double***)calloc_3d_array(2,maxND,max_recvRC,sizeof(double))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate recv_bufRC\n");
-  if((recv_rq = (MPI_Request***)
-    calloc_3d_array(pM->NLevels,maxND,maxCG,sizeof(MPI_Request))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate recv MPI_Request array\n");
-  if((send_rq = (MPI_Request**)
-    calloc_2d_array(maxND,maxCG,sizeof(MPI_Request))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate send MPI_Request array\n");
-#endif /* MPI_PARALLEL */
+static void sum_fluxes(MeshS *pM, const int nl, const int sub)
+{
+  GridS *pG;
+  Real *pSum,*pFlx;
+  int nd,npg,dim,n,i,nw;
 
-#ifdef MHD
-  if((SMRemf1 =
-    (Real**)calloc_2d_array(MAX(max2,max3),max1,sizeof(Real))) == NULL)
-    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf1\n");;
-  if((SMRemf2 =
-    (Real**)calloc_2d_array(MAX(max2,max3),MAX(max1,max2),sizeof(Real))) ==NULL)
-    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf2\n");;
-  if((SMRemf3 =
-    (Real**)calloc_2d_array(max3,MAX(max1,max2),sizeof(Real))) == NULL)
-    ath_error("[smr_init]Failed to calloc_2d_array for SMRemf3\n");;
-#endif /* MHD */
+  for (nd=0; nd<(pM->DomainsPerLevel[nl]); nd++){
+    if (pM->Domain[nl][nd].Grid != NULL) {
+      pG=pM->Domain[nl][nd].Grid;
+      pSum = FlxSum[nl][nd];
+
+      for (npg=0; npg<pG->NPGrid; npg++){
+      for (dim=0; dim<6; dim++){
+      for (n=0; n<4; n++){
+        nw = flux_array(&(pG->PGrid[npg]),dim,n,&pFlx);
+        if (sub == 0) {
+          for (i=0; i<nw; i++) pSum[i] = pFlx[i];
+        } else {
+          for (i=0; i<nw; i++) pFlx[i] = 0.5*(pSum[i] + pFlx[i]);
+        }
+        pSum += nw;
+      }}}
+    }
+  }
 
-/* Allocate memory for send/receive buffers and GZ arrays used in Prolongate */
+  return;
+}
 
-  if((send_bufP =
-    (double**)calloc_2d_array(maxND,max_sendP,sizeof(double))) == NULL)
-    ath_error("[SMR_init]:Failed to allocate send_bufP\n");
+/*----------------------------------------------------------------------------*/
+/*! \fn static int flux_array(GridOvrlpS *pPO, const int dim, const int n,
+ *                            Real **ppF)
+ *  \brief Sets *ppF to the start of the fluxes of conserved variables (n=0),
+ *   or of EMF1, EMF2, EMF3 (n=1,2,3), at boundary dim of overlap pPO, and
+ *   returns their number of Reals, or 0 if there are none.  Each is a 2D array
+ *   with the sizes allocated in init_grid().
+ */
 
-  if((recv_bufP =
-    (double***)calloc_3d_array(2,maxND,max_recvP,sizeof(double))) == NULL)
-    ath_error("[SMR_init]: Failed to allocate recv_bufP\n");
+static int flux_array(GridOvrlpS *pPO, const int dim, const int n, Real **ppF)
+{
+  Real **pA=NULL;
+  int m1,m2,slow;
 
-  max1 += 2*nghost;
-  max2 += 2*nghost;
-  max3 += 2*nghost;
+/* Sizes of overlap in the faster and slower directions along the boundary */
+  m1 = pPO->ijke[(dim < 2) ? 1 : 0] - pPO->ijks[(dim < 2) ? 1 : 0] + 1;
+  m2 = pPO->ijke[(dim < 4) ? 2 : 1] - pPO->ijks[(dim < 4) ? 2 : 1] + 1;
+
+  if (n == 0) {
+    if (pPO->myFlx[dim] == NULL) return 0;
+    *ppF = (Real*)&(pPO->myFlx[dim][0][0]);
+    return m1*m2*(int)(sizeof(ConsS)/sizeof(Real));
+  }
 
-  if((GZ[0]=(ConsS***)calloc_3d_array(max3,max2,nghost,sizeof(ConsS)))
-    ==NULL) ath_error("[SMR_init]:Failed to allocate GZ[0]C\n");
-  if((GZ[1]=(ConsS***)calloc_3d_array(max3,nghost,max1,sizeof(ConsS)))
-    ==NULL) ath_error("[SMR_init]:Failed to allocate GZ[1]C\n");
-  if((GZ[2]=(ConsS***)calloc_3d_array(nghost,max2,max1,sizeof(ConsS)))
-    ==NULL) ath_error("[SMR_init]:Failed to allocate GZ[2]C\n");
 #ifdef MHD
-  ngh1 = nghost + 1;
-  if((BFld[0]=(Real3Vect***)calloc_3d_array(max3,max2,ngh1,sizeof(Real3Vect)))
-    ==NULL) ath_error("[SMR_init]:Failed to allocate BFld[0]C\n");
-  if((BFld[1]=(Real3Vect***)calloc_3d_array(max3,ngh1,max1,sizeof(Real3Vect)))
-    ==NULL) ath_error("[SMR_init]:Failed to allocate BFld[1]C\n");
-  if((BFld[2]=(Real3Vect***)calloc_3d_array(ngh1,max2,max1,sizeof(Real3Vect)))
-    ==NULL) ath_error("[SMR_init]:Failed to allocate BFld[2]C\n");
+  if (n == 1) pA = pPO->myEMF1[dim];
+  if (n == 2) pA = pPO->myEMF2[dim];
+  if (n == 3) pA = pPO->myEMF3[dim];
+  if (pA == NULL) return 0;
+  *ppF = &(pA[0][0]);
+
+/* EMF along the slower direction has m1+1 edges in the faster one, and vice
+ * versa */
+  slow = (dim < 4) ? 3 : 2;
+  return (n == slow) ? m2*(m1+1) : (m2+1)*m1;
+#else
+  return 0;
 #endif /* MHD */
+}
+#endif /* SMR_SUBCYCLE */
+
+#ifdef SMR_AGGREGATE
+/*----------------------------------------------------------------------------*/
+/*! \fn static void agg_init(MeshS *pM, const int nl, const int rc)
+ *  \brief Builds the persistent messages between the Grids on this processor
+ *   on levels nl and nl+1, for prolongation (rc=0) or restriction (rc=1).
+ *   Sets the message and the start of its data in it for each overlap. */
+
+static void agg_init(MeshS *pM, const int nl, const int rc)
+{
+  AggMsgS *pA = (rc ? &(AggRC[nl]) : &(AggP[nl]));
+  AggEntryS *list;
+  GridS *pG;
+  GridOvrlpS *pO;
+  MPI_Request *rq;
+  double *buf;
+  int send,lev,nd,n,nO,nMy,ne,nm,m,start,off,ierr;
+
+  ne = 1;
+  for (lev=nl; lev<=nl+1; lev++){
+    for (nd=0; nd<(pM->DomainsPerLevel[lev]); nd++){
+      if ((pG = pM->Domain[lev][nd].Grid) != NULL)
+        ne += (lev == nl) ? pG->NCGrid : pG->NPGrid;
+    }
+  }
+  if ((list = (AggEntryS*)malloc(ne*sizeof(AggEntryS))) == NULL)
+    ath_error("[SMR_init]: Failed to allocate list of overlaps\n");
+
+/* Prolongated data is sent from level nl to nl+1, and restricted data from
+ * nl+1 to nl.  Grids on level nl overlap child Grids, on nl+1 parent Grids.
+ * Overlaps with Grids on this processor are not sent. */
+
+  for (send=0; send<2; send++){
+    lev = (send != rc) ? nl : nl+1;
+    ne = 0;
+    for (nd=0; nd<(pM->DomainsPerLevel[lev]); nd++){
+      if ((pG = pM->Domain[lev][nd].Grid) == NULL) continue;
+      if (lev == nl) {
+        pO = pG->CGrid;  nO = pG->NCGrid;  nMy = pG->NmyCGrid;
+      } else {
+        pO = pG->PGrid;  nO = pG->NPGrid;  nMy = pG->NmyPGrid;
+      }
+      for (n=0; n<nO; n++){
+        if (rc) pO[n].AggRC = -1;
+        else    pO[n].AggP  = -1;
+        list[ne].nWords = (rc ? pO[n].nWordsRC : pO[n].nWordsP);
+        if (n < nMy || list[ne].nWords == 0) continue;
+        list[ne].peer = agg_rank(pM,lev,&(pO[n]),(lev == nl));
+        list[ne].pd = (lev == nl) ? nd : pO[n].DomN;
+        list[ne].cd = (lev == nl) ? pO[n].DomN : nd;
+        list[ne].pO = &(pO[n]);
+        ne++;
+      }
+    }
+
+/* Both processors order the overlaps of a message in the same way */
 
+    qsort(list, ne, sizeof(AggEntryS), cmp_agg);
+
+    nm = off = 0;
+    for (n=0; n<ne; n++){
+      if (n == 0 || list[n].peer != list[n-1].peer) nm++;
+      off += list[n].nWords;
+    }
+    if ((buf = (double*)calloc_1d_array(MAX(off,1),sizeof(double))) == NULL)
+      ath_error("[SMR_init]: Failed to allocate aggregated messages\n");
+    if ((rq = (MPI_Request*)calloc_1d_array(MAX(nm,1),sizeof(MPI_Request)))
+      == NULL) ath_error("[SMR_init]: Failed to allocate MPI_Request array\n");
+
+    m = -1;
+    start = off = 0;
+    for (n=0; n<ne; n++){
+      if (n == 0 || list[n].peer != list[n-1].peer) m++;
+      if (rc) {
+        list[n].pO->AggRC = m;
+        list[n].pO->pAggRC = &(buf[off]);
+      } else {
+        list[n].pO->AggP = m;
+        list[n].pO->pAggP = &(buf[off]);
+      }
+      off += list[n].nWords;
+      if (n == ne-1 || list[n+1].peer != list[n].peer) {
+        if (send)
+          ierr = MPI_Send_init(&(buf[start]), (off-start), MPI_DOUBLE,
+            list[n].peer, (2*nl+rc), Comm_Agg, &(rq[m]));
+        else
+          ierr = MPI_Recv_init(&(buf[start]), (off-start), MPI_DOUBLE,
+            list[n].peer, (2*nl+rc), Comm_Agg, &(rq[m]));
+        start = off;
+      }
+    }
+
+    if (send) {
+      pA->nSend = nm;
+      pA->send_buf = buf;
+      pA->send_rq = rq;
+    } else {
+      pA->nRecv = nm;
+      pA->recv_buf = buf;
+      pA->recv_rq = rq;
+      if ((pA->done = (int*)calloc_1d_array(MAX(nm,1),sizeof(int))) == NULL)
+        ath_error("[SMR_init]: Failed to allocate aggregated messages\n");
+    }
+  }
+
+  free(list);
   return;
 }
-/*=========================== PRIVATE FUNCTIONS ==============================*/
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void agg_free(AggMsgS *pA)
+ *  \brief Frees the persistent messages built by agg_init() */
+
+static void agg_free(AggMsgS *pA)
+{
+  int m;
+
+  for (m=0; m<pA->nSend; m++) MPI_Request_free(&(pA->send_rq[m]));
+  for (m=0; m<pA->nRecv; m++) MPI_Request_free(&(pA->recv_rq[m]));
+  if (pA->send_buf != NULL) free_1d_array(pA->send_buf);
+  if (pA->recv_buf != NULL) free_1d_array(pA->recv_buf);
+  if (pA->send_rq != NULL) free_1d_array(pA->send_rq);
+  if (pA->recv_rq != NULL) free_1d_array(pA->recv_rq);
+  if (pA->done != NULL) free_1d_array(pA->done);
+  pA->send_buf = pA->recv_buf = NULL;
+  pA->send_rq = pA->recv_rq = NULL;
+  pA->done = NULL;
+  pA->nSend = pA->nRecv = 0;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int agg_rank(MeshS *pM, const int lev, GridOvrlpS *pO,
+ *                          const int child)
+ *  \brief Returns the processor in MPI_COMM_WORLD of the Grid of overlap pO of
+ *   a Grid on level lev, which is a child Grid if child=1 and a parent Grid
+ *   otherwise.  pO->ID is its rank in the Comm_Children communicator of the
+ *   parent Domain. */
+
+static int agg_rank(MeshS *pM, const int lev, GridOvrlpS *pO, const int child)
+{
+  DomainS *pD;
+  int l,m,n,id;
+
+  pD = &(pM->Domain[(child ? lev+1 : lev-1)][pO->DomN]);
+  for (n=0; n<(pD->NGrid[2]); n++){
+  for (m=0; m<(pD->NGrid[1]); m++){
+  for (l=0; l<(pD->NGrid[0]); l++){
+    id = (child ? pD->GData[n][m][l].ID_Comm_Parent :
+                  pD->GData[n][m][l].ID_Comm_Children);
+    if (id == pO->ID) return pD->GData[n][m][l].ID_Comm_world;
+  }}}
+
+  ath_error("[SMR_init]: no Grid with ID=%d in Domain[%d][%d]\n",pO->ID,
+            (child ? lev+1 : lev-1),pO->DomN);
+  return -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int cmp_agg(const void *a, const void *b)
+ *  \brief Orders overlaps by processor, then by parent and child Domain, for
+ *   qsort().  There is at most one overlap between two processors for each
+ *   pair of Domains. */
+
+static int cmp_agg(const void *a, const void *b)
+{
+  const AggEntryS *pa = (const AggEntryS*)a, *pb = (const AggEntryS*)b;
+
+  if (pa->peer != pb->peer) return (pa->peer < pb->peer ? -1 : 1);
+  if (pa->pd != pb->pd) return (pa->pd < pb->pd ? -1 : 1);
+  if (pa->cd != pb->cd) return (pa->cd < pb->cd ? -1 : 1);
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static int agg_next(AggMsgS *pA, GridOvrlpS *pO, const int n0,
+ *                          const int n1, const int rc)
+ *  \brief Returns the index of an overlap pO[n0..n1-1] not yet read, whose
+ *   aggregated message in pA has arrived, waiting for the next message if
+ *   there is none.  Taken[] marks the overlaps already read. */
+
+static int agg_next(AggMsgS *pA, GridOvrlpS *pO, const int n0, const int n1,
+                    const int rc)
+{
+  int n,m,ierr;
+
+  for (;;) {
+    for (n=n0; n<n1; n++){
+      m = (rc ? pO[n].AggRC : pO[n].AggP);
+      if (m >= 0 && Taken[n] == 0 && pA->done[m] == 1) {
+        Taken[n] = 1;
+        return n;
+      }
+    }
+    ierr = MPI_Waitany(pA->nRecv, pA->recv_rq, &m, MPI_STATUS_IGNORE);
+    if (m == MPI_UNDEFINED)
+      ath_error("[agg_next]: No aggregated message left to receive\n");
+    pA->done[m] = 1;
+  }
+}
+#endif /* SMR_AGGREGATE */
+
 /*----------------------------------------------------------------------------*/
 /*! \fn void ProCon(const ConsS Uim1,const ConsS Ui,  const ConsS Uip1,
  *            const ConsS Ujm1,const ConsS Ujp1,
@@ -0,0 +1,327 @@
+#include "copyright.h"
+/*============================================================================*/
+/*! \file timers.c
+ *  \brief Wall-clock timers for the phases of the main loop.
+ *
+ * PURPOSE: Wall-clock timers for the phases of the main loop (integrator,
+ *   boundary values, new_dt, output, SMR, ...), to find where the time goes
+ *   and how well it is balanced across processors without an external
+ *   profiler.  Only used when Athena is configured with --enable-timers;
+ *   otherwise TIMER_START() and TIMER_STOP() (see prototypes.h) compile to
+ *   nothing.
+ *
+ *   Timers nest: a timer started while another is running is listed under it
+ *   in the report, and its time is not counted in the "self" time of the
+ *   enclosing timer.  A timer started inside different timers (e.g. bvals
+ *   within diffusion and on its own) is listed under the outermost one.
+ *
+ *   The time spent in each phase during each cycle is kept in a buffer on
+ *   every processor.  Every <job>/timers_nbuf cycles (default 100), and at the
+ *   end of the run, the buffer is reduced over processors and the root
+ *   process appends the maximum and the mean of each phase for each cycle to
+ *   <basename>.timers.  So there is no global synchronisation in the cycles
+ *   in between.  At the end of the run timers_report() prints the min, mean
+ *   and max over processors of the total time in each phase, and the load
+ *   imbalance max/mean - 1.
+ *
+ * CONTAINS PUBLIC FUNCTIONS:
+ * - timers_init()   - zeroes timers, opens file for times of each cycle
+ * - timer_start()   - starts timer for one phase
+ * - timer_stop()    - stops timer for one phase
+ * - timers_cycle()  - stores times for the last cycle, writes buffer to file
+ * - timers_report() - prints summary of times over the run		      */
+/*============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "defs.h"
+#include "athena.h"
+#include "globals.h"
+#include "prototypes.h"
+
+#ifdef PHASE_TIMERS
+
+static char *TimerName[NTIMERS] = {"cycle", "output", "cooling", "diffusion",
+  "integrate", "particles", "smr", "userwork", "selfgrav", "bvals", "new_dt"};
+
+static double t_begin[NTIMERS];  /* wall time at which timer was started */
+static double t_nested[NTIMERS]; /* time in nested timers since then */
+static double t_total[NTIMERS];  /* total time over run */
+static double t_self[NTIMERS];   /* total time less time in nested timers */
+static double t_cycle[NTIMERS];  /* time in current cycle */
+static int parent[NTIMERS];      /* timer listed under (-1 for none, -2 if
+                                    never called) */
+static int stack[NTIMERS], depth=0; /* timers running, innermost last */
+static int nproc=1;
+static FILE *fp_cycle = NULL;
+
+/* times of each phase in the last nbuf cycles, written to file by
+ * flush_cycles() */
+static int nbuf=0, ncyc=0;       /* size of buffer, cycles in buffer */
+static double *t_buf=NULL;       /* [nbuf][NTIMERS] */
+static double *t_bufmax=NULL, *t_bufsum=NULL; /* reduced on root */
+static int *nstep_buf=NULL;
+static Real *time_buf=NULL;
+
+/* summary over processors for timers_report() */
+static double t_min[NTIMERS], t_max[NTIMERS], t_mean[NTIMERS];
+static double t_self_mean[NTIMERS];
+
+/*==============================================================================
+ * PRIVATE FUNCTION PROTOTYPES:
+ *   wtime()        - wall clock time in seconds
+ *   flush_cycles() - reduces buffered times of cycles and writes them to file
+ *   print_timer()  - prints one line of report, then nested timers
+ *============================================================================*/
+
+static double wtime(void);
+static void flush_cycles(void);
+static void print_timer(const int n, const int level);
+
+/*=========================== PUBLIC FUNCTIONS ===============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn void timers_init(MeshS *pM)
+ *  \brief Zeroes all timers, allocates the buffer of cycle times; root
+ *   process opens <basename>.timers (appending on restart) and writes a
+ *   header if the file is new. */
+
+void timers_init(MeshS *pM)
+{
+  int n;
+  char *fname;
+
+  for (n=0; n<NTIMERS; n++) {
+    t_total[n] = t_self[n] = t_cycle[n] = 0.0;
+    parent[n] = -2;
+  }
+  depth = 0;
+#ifdef MPI_PARALLEL
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+#endif
+
+  nbuf = par_geti_def("job","timers_nbuf",100);
+  if (nbuf < 1)
+    ath_error("[timers_init]: timers_nbuf=%d must be positive\n",nbuf);
+  ncyc = 0;
+  t_buf     = (double*)calloc_1d_array(nbuf*NTIMERS, sizeof(double));
+  t_bufmax  = (double*)calloc_1d_array(nbuf*NTIMERS, sizeof(double));
+  t_bufsum  = (double*)calloc_1d_array(nbuf*NTIMERS, sizeof(double));
+  nstep_buf = (int*)calloc_1d_array(nbuf, sizeof(int));
+  time_buf  = (Real*)calloc_1d_array(nbuf, sizeof(Real));
+  if (t_buf == NULL || t_bufmax == NULL || t_bufsum == NULL ||
+      nstep_buf == NULL || time_buf == NULL)
+    ath_error("[timers_init]: Error allocating buffer of %d cycles\n",nbuf);
+
+  if (myID_Comm_world != 0) return;
+
+  fname = ath_fname(NULL,pM->outfilename,NULL,NULL,0,0,NULL,"timers");
+  if (fname == NULL)
+    ath_error("[timers_init]: Unable to create timers filename\n");
+  if ((fp_cycle = fopen(fname,"a")) == NULL)
+    ath_error("[timers_init]: Unable to open %s\n",fname);
+  free(fname);
+
+  fseek(fp_cycle, 0, SEEK_END);
+  if (ftell(fp_cycle) == 0) {
+    fprintf(fp_cycle,"# Wall seconds in each phase per cycle, max and mean over %d processes\n",
+      nproc);
+    fprintf(fp_cycle,"# [1]=cycle [2]=time");
+    for (n=0; n<NTIMERS; n++)
+      fprintf(fp_cycle," [%d]=%s-max [%d]=%s-mean",3+2*n,TimerName[n],
+        4+2*n,TimerName[n]);
+    fprintf(fp_cycle,"\n");
+  }
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void timer_start(const enum TimerPhase n)
+ *  \brief Starts timer n, nested inside any timer already running */
+
+void timer_start(const enum TimerPhase n)
+{
+  int p;
+
+  if (depth == NTIMERS)
+    ath_error("[timer_start]: too many timers running to start %s\n",
+      TimerName[n]);
+  p = (depth > 0) ? stack[depth-1] : -1;
+  if (parent[n] == -2) parent[n] = p;
+  else if (parent[n] != p) parent[n] = (depth > 0) ? stack[0] : -1;
+
+  stack[depth++] = n;
+  t_nested[n] = 0.0;
+  t_begin[n] = wtime();
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void timer_stop(const enum TimerPhase n)
+ *  \brief Stops timer n, which must be the innermost one running */
+
+void timer_stop(const enum TimerPhase n)
+{
+  double dt = wtime() - t_begin[n];
+
+  if (depth == 0 || stack[depth-1] != (int)n)
+    ath_error("[timer_stop]: timer %s is not the innermost one running\n",
+      TimerName[n]);
+  depth--;
+
+  t_total[n] += dt;
+  t_cycle[n] += dt;
+  t_self[n]  += dt - t_nested[n];
+  if (depth > 0) t_nested[stack[depth-1]] += dt;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void timers_cycle(MeshS *pM)
+ *  \brief Stores the time in each phase during the last cycle in the
+ *   buffer, and writes the buffer to <basename>.timers when it is full.  Must
+ *   be called by all processes. */
+
+void timers_cycle(MeshS *pM)
+{
+  int n;
+
+  nstep_buf[ncyc] = pM->nstep;
+  time_buf[ncyc] = pM->time;
+  for (n=0; n<NTIMERS; n++) {
+    t_buf[ncyc*NTIMERS + n] = t_cycle[n];
+    t_cycle[n] = 0.0;
+  }
+  ncyc++;
+
+  if (ncyc == nbuf) flush_cycles();
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void timers_report(void)
+ *  \brief Prints min, mean and max over processors of the total time in each
+ *   phase, with nested phases indented, and closes <basename>.timers.  Must
+ *   be called by all processes. */
+
+void timers_report(void)
+{
+  double tsum[NTIMERS], tself[NTIMERS];
+  int n;
+
+  flush_cycles();
+
+#ifdef MPI_PARALLEL
+  MPI_Reduce(t_total, t_min, NTIMERS, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+  MPI_Reduce(t_total, t_max, NTIMERS, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(t_total, tsum,  NTIMERS, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(t_self,  tself, NTIMERS, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+  for (n=0; n<NTIMERS; n++) {
+    t_min[n] = t_max[n] = tsum[n] = t_total[n];
+    tself[n] = t_self[n];
+  }
+#endif
+  for (n=0; n<NTIMERS; n++) {
+    t_mean[n] = tsum[n]/(double)nproc;
+    t_self_mean[n] = tself[n]/(double)nproc;
+  }
+
+  ath_pout(0,"\nWall seconds in each phase, over %d processes:\n",nproc);
+  ath_pout(0,"%-18s %11s %11s %11s %11s %7s %9s\n","phase","min","mean","max",
+    "mean self","%cycle","imbalance");
+  for (n=0; n<NTIMERS; n++) {
+    if (parent[n] == -1) print_timer(n,0);
+  }
+
+  if (fp_cycle != NULL) {
+    fclose(fp_cycle);
+    fp_cycle = NULL;
+  }
+  free_1d_array(t_buf);
+  free_1d_array(t_bufmax);
+  free_1d_array(t_bufsum);
+  free_1d_array(nstep_buf);
+  free_1d_array(time_buf);
+  t_buf = t_bufmax = t_bufsum = NULL;
+  nstep_buf = NULL;
+  time_buf = NULL;
+  return;
+}
+
+/*=========================== PRIVATE FUNCTIONS ==============================*/
+/*----------------------------------------------------------------------------*/
+/*! \fn static double wtime(void)
+ *  \brief Wall clock time in seconds */
+
+static double wtime(void)
+{
+#ifdef MPI_PARALLEL
+  return MPI_Wtime();
+#else
+  struct timeval tv;
+  gettimeofday(&tv,NULL);
+  return (double)tv.tv_sec + 1.0e-6*(double)tv.tv_usec;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void flush_cycles(void)
+ *  \brief Reduces the times of the cycles in the buffer over processors, and
+ *   root process writes max and mean of each phase for each cycle to
+ *   <basename>.timers.  Every process holds the same number of cycles, so
+ *   all call this together. */
+
+static void flush_cycles(void)
+{
+  int n, m, cnt = ncyc*NTIMERS;
+
+  if (ncyc == 0) return;
+
+#ifdef MPI_PARALLEL
+  MPI_Reduce(t_buf, t_bufmax, cnt, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(t_buf, t_bufsum, cnt, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+  for (n=0; n<cnt; n++) t_bufmax[n] = t_bufsum[n] = t_buf[n];
+#endif
+
+  if (fp_cycle != NULL) {
+    for (m=0; m<ncyc; m++) {
+      fprintf(fp_cycle,"%d %e",nstep_buf[m],time_buf[m]);
+      for (n=0; n<NTIMERS; n++)
+        fprintf(fp_cycle," %e %e",t_bufmax[m*NTIMERS + n],
+          t_bufsum[m*NTIMERS + n]/(double)nproc);
+      fprintf(fp_cycle,"\n");
+    }
+    fflush(fp_cycle);
+  }
+
+  ncyc = 0;
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn static void print_timer(const int n, const int level)
+ *  \brief Prints line of report for timer n indented by level, then the
+ *   timers nested inside it.  Imbalance is max/mean - 1 over processors. */
+
+static void print_timer(const int n, const int level)
+{
+  int m;
+  double pct=0.0, imb=0.0;
+
+  if (t_mean[TIMER_CYCLE] > 0.0) pct = 100.0*t_mean[n]/t_mean[TIMER_CYCLE];
+  if (t_mean[n] > 0.0) imb = 100.0*(t_max[n]/t_mean[n] - 1.0);
+
+  ath_pout(0,"%*s%-*s %11.4e %11.4e %11.4e %11.4e %6.1f%% %8.1f%%\n",
+    2*level,"",18-2*level,TimerName[n],t_min[n],t_mean[n],t_max[n],
+    t_self_mean[n],pct,imb);
+
+  for (m=0; m<NTIMERS; m++) {
+    if (parent[m] == n) print_timer(m,level+1);
+  }
+  return;
+}
+
+#endif /* PHASE_TIMERS */
@@ -14,6 +14,10 @@
  * - minmax1()        - fast Min/Max for a 1d array using registers
  * - minmax2()        - fast Min/Max for a 2d array using registers
  * - minmax3()        - fast Min/Max for a 3d array using registers
+ * - calloc_grid_U()  - allocates conserved variables of a Grid
+ * - free_grid_U()    - frees conserved variables of a Grid
+ * - get_grid_cons()  - gathers ConsS of one cell (--enable-soa only)
+ * - set_grid_cons()  - scatters ConsS of one cell (--enable-soa only)
  *============================================================================*/
 
 #include <stdio.h>
@@ -206,6 +210,85 @@ void do_nothing_bc(GridS *pG __attribute((unused)))
 {
 }
 
+/*----------------------------------------------------------------------------*/
+/*! \fn int calloc_grid_U(GridS *pG, int nx3, int nx2, int nx1)
+ *  \brief Allocates pG->U as [nx3][nx2][nx1] cells, as one array of ConsS or,
+ *   with --enable-soa, as one padded and aligned array per variable.  Returns
+ *   0 on success.
+ */
+int calloc_grid_U(GridS *pG, int nx3, int nx2, int nx1)
+{
+#ifdef SOA_LAYOUT
+  Real ****pU = (Real****)&(pG->U);
+  int n;
+
+  for (n=0; n<NCONS_VAR; n++) pU[n] = NULL;
+  for (n=0; n<NCONS_VAR; n++) {
+    pU[n] = (Real***)calloc_3d_array_aligned(nx3,nx2,nx1,sizeof(Real));
+    if (pU[n] == NULL) {
+      free_grid_U(pG);
+      return 1;
+    }
+  }
+#else
+  pG->U = (ConsS***)calloc_3d_array(nx3,nx2,nx1,sizeof(ConsS));
+  if (pG->U == NULL) return 1;
+#endif
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void free_grid_U(GridS *pG)
+ *  \brief Frees memory allocated by calloc_grid_U() */
+void free_grid_U(GridS *pG)
+{
+#ifdef SOA_LAYOUT
+  Real ****pU = (Real****)&(pG->U);
+  int n;
+
+  for (n=0; n<NCONS_VAR; n++) {
+    if (pU[n] != NULL) free_3d_array(pU[n]);
+    pU[n] = NULL;
+  }
+#else
+  if (pG->U != NULL) free_3d_array(pG->U);
+  pG->U = NULL;
+#endif
+}
+
+#ifdef SOA_LAYOUT
+/*----------------------------------------------------------------------------*/
+/*! \fn ConsS get_grid_cons(const GridS *pG, const int k, const int j,
+ *                          const int i)
+ *  \brief Returns the conserved variables in cell (i,j,k) as a ConsS; used by
+ *   GET_GRID_U() with --enable-soa.
+ */
+ConsS get_grid_cons(const GridS *pG, const int k, const int j, const int i)
+{
+  ConsS U;
+  Real *pU = (Real*)&U;
+  int n;
+
+  for (n=0; n<NCONS_VAR; n++) pU[n] = GRID_UN(pG,k,j,i,n);
+  return U;
+}
+
+/*----------------------------------------------------------------------------*/
+/*! \fn void set_grid_cons(GridS *pG, const int k, const int j, const int i,
+ *                         const ConsS U)
+ *  \brief Sets the conserved variables in cell (i,j,k) from a ConsS; used by
+ *   SET_GRID_U() with --enable-soa.
+ */
+void set_grid_cons(GridS *pG, const int k, const int j, const int i,
+                   const ConsS U)
+{
+  const Real *pU = (const Real*)&U;
+  int n;
+
+  for (n=0; n<NCONS_VAR; n++) GRID_UN(pG,k,j,i,n) = pU[n];
+}
+#endif /* SOA_LAYOUT */
+
 /*============================================================================
  * ERROR-ANALYSIS FUNCTIONS
  *============================================================================*/
@@ -314,21 +397,21 @@ void compute_l1_error(const char *problem, const MeshS *pM,
 #endif
 
         /* Sum local L1 error for each grid cell I own */
-        error.d   += dVol*fabs(pG->U[k][j][i].d   - RootSoln[k][j][i].d );
-        error.M1  += dVol*fabs(pG->U[k][j][i].M1  - RootSoln[k][j][i].M1);
-        error.M2  += dVol*fabs(pG->U[k][j][i].M2  - RootSoln[k][j][i].M2);
-        error.M3  += dVol*fabs(pG->U[k][j][i].M3  - RootSoln[k][j][i].M3); 
+        error.d   += dVol*fabs(GRID_U(pG,k,j,i,d)   - RootSoln[k][j][i].d );
+        error.M1  += dVol*fabs(GRID_U(pG,k,j,i,M1)  - RootSoln[k][j][i].M1);
+        error.M2  += dVol*fabs(GRID_U(pG,k,j,i,M2)  - RootSoln[k][j][i].M2);
+        error.M3  += dVol*fabs(GRID_U(pG,k,j,i,M3)  - RootSoln[k][j][i].M3); 
 #ifdef MHD
-        error.B1c += dVol*fabs(pG->U[k][j][i].B1c - RootSoln[k][j][i].B1c);
-        error.B2c += dVol*fabs(pG->U[k][j][i].B2c - RootSoln[k][j][i].B2c);
-        error.B3c += dVol*fabs(pG->U[k][j][i].B3c - RootSoln[k][j][i].B3c);
+        error.B1c += dVol*fabs(GRID_U(pG,k,j,i,B1c) - RootSoln[k][j][i].B1c);
+        error.B2c += dVol*fabs(GRID_U(pG,k,j,i,B2c) - RootSoln[k][j][i].B2c);
+        error.B3c += dVol*fabs(GRID_U(pG,k,j,i,B3c) - RootSoln[k][j][i].B3c);
 #endif /* MHD */
 #ifndef ISOTHERMAL
-        error.E   += dVol*fabs(pG->U[k][j][i].E   - RootSoln[k][j][i].E );
+        error.E   += dVol*fabs(GRID_U(pG,k,j,i,E)   - RootSoln[k][j][i].E );
 #endif /* ISOTHERMAL */
 #if (NSCALARS > 0)
         for (n=0; n<NSCALARS; n++)
-          error.s[n] += dVol*fabs(pG->U[k][j][i].s[n] - RootSoln[k][j][i].s[n]);;
+          error.s[n] += dVol*fabs(GRID_U(pG,k,j,i,s[n]) - RootSoln[k][j][i].s[n]);;
 #endif
       }
 
@@ -1024,33 +1107,33 @@ Real fx(Real x)
 #endif
 }
 
-Real avgXZ(Real (*func)(Real, Real, Real), const GridS *pG, const int i, const
-int j, const int k) {
-  Real x1,x2,x3;
-
-  Real fXZ(Real z);
-
-  nrfunc=func;
-  cc_pos(pG,i,j,k,&x1,&x2,&x3);
-  xmin = x1 - 0.5*pG->dx1;  xmax = x1 + 0.5*pG->dx1;
-  zmin = x3 - 0.5*pG->dx3;  zmax = x3 + 0.5*pG->dx3;
-
-  ysav = x2;
-  return qsimp(fXZ,zmin,zmax)/(pG->dx1*pG->dx3);
-
-}
-
-Real fx2(Real x)
-{
-  return nrfunc(x,ysav,zsav);
-}
-
-Real fXZ(Real z) {
-  Real fx2(Real x);
-
-  zsav = z;
-  return qsimp(fx2,xmin,xmax);
-}
+Real avgXZ(Real (*func)(Real, Real, Real), const GridS *pG, const int i, const
+int j, const int k) {
+  Real x1,x2,x3;
+
+  Real fXZ(Real z);
+
+  nrfunc=func;
+  cc_pos(pG,i,j,k,&x1,&x2,&x3);
+  xmin = x1 - 0.5*pG->dx1;  xmax = x1 + 0.5*pG->dx1;
+  zmin = x3 - 0.5*pG->dx3;  zmax = x3 + 0.5*pG->dx3;
+
+  ysav = x2;
+  return qsimp(fXZ,zmin,zmax)/(pG->dx1*pG->dx3);
+
+}
+
+Real fx2(Real x)
+{
+  return nrfunc(x,ysav,zsav);
+}
+
+Real fXZ(Real z) {
+  Real fx2(Real x);
+
+  zsav = z;
+  return qsimp(fx2,xmin,xmax);
+}
 
 /*----------------------------------------------------------------------------*/
 /* FUNCTION vecpot2b1i,vecpot2b2i,vecpot2b3i
@@ -0,0 +1,376 @@
+/*==============================================================================
+ * FILE: sweep_layout.c
+ *
+ * PURPOSE: Measures the throughput of x1-, x2- and x3-sweeps over the
+ *   conserved variables for the two storage layouts selectable with
+ *   configure:  the default array of ConsS structures (AoS), and the
+ *   structure of arrays (SoA) enabled with --enable-soa.
+ *
+ *   Each sweep mimics the pattern used by the unsplit integrators: for every
+ *   pencil along the sweep direction, each conserved component is gathered
+ *   into a contiguous 1D array, a simple three-point update is applied, and
+ *   the result is scattered back into a second 3D array of the same layout.
+ *   The x2- and x3-sweeps gather with a stride of one row or plane, which in
+ *   the AoS layout is additionally multiplied by sizeof(ConsS).
+ *
+ *   A second set of timings applies the same update directly on the 3D
+ *   arrays with the x1-index innermost for every sweep direction.  This is
+ *   the loop order that lets the compiler vectorize x2- and x3-sweeps, and
+ *   it only runs with unit stride in the SoA layout.
+ *
+ *   The program is self contained (it does not include athena.h), so that it
+ *   can be compiled without configuring the code.  The SoA arrays are padded
+ *   and aligned in the same way as calloc_3d_array_aligned() in ath_array.c.
+ *
+ * COMPILE USING: gcc -O3 -Wall -W -o sweep_layout sweep_layout.c -lm
+ *
+ * USAGE: ./sweep_layout [-n <cells per side>] [-r <repetitions>]
+ *
+ *   Reports the number of cell updates per second for each sweep, layout and
+ *   loop order.
+ *============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef double Real;
+
+/* Number of conserved variables: d,M1,M2,M3,E,B1c,B2c,B3c as in adiabatic MHD*/
+#define NVAR 8
+#define NGH 4
+#define ALIGN 64
+
+typedef struct Cons_s{
+  Real d,M1,M2,M3,E,B1c,B2c,B3c;
+}ConsS;
+
+static Real **U1d=NULL, **F1d=NULL;
+
+static void *calloc_3d(size_t nt, size_t nr, size_t nc, size_t size, int pad);
+static void free_3d(void *array);
+static double wtime(void);
+static void sweep_aos(ConsS ***Uin, ConsS ***Uout, const int n, const int dir);
+static void sweep_soa(Real ****Uin, Real ****Uout, const int n, const int dir);
+static void direct_aos(ConsS ***Uin, ConsS ***Uout, const int n, const int dir);
+static void direct_soa(Real ****Uin, Real ****Uout, const int n, const int dir);
+
+/*----------------------------------------------------------------------------*/
+/* main:  */
+
+int main(int argc, char *argv[])
+{
+  int n=128, nrep=5, nt, dir, r, i, j, k, v;
+  ConsS ***Ua[2];
+  Real ****Us[2];
+  double t0, tmin, rate[2][2][3], chk[2];
+
+  for (i=1; i<argc; i++) {
+    if (strcmp(argv[i],"-n") == 0 && i+1 < argc) n = atoi(argv[++i]);
+    else if (strcmp(argv[i],"-r") == 0 && i+1 < argc) nrep = atoi(argv[++i]);
+    else {
+      fprintf(stderr,"Usage: %s [-n <cells per side>] [-r <repetitions>]\n",
+        argv[0]);
+      return 1;
+    }
+  }
+  if (n < 4 || nrep < 1) {
+    fprintf(stderr,"[sweep_layout]: need n >= 4 and at least 1 repetition\n");
+    return 1;
+  }
+  nt = n + 2*NGH;
+
+  U1d = (Real**)malloc(NVAR*sizeof(Real*));
+  F1d = (Real**)malloc(NVAR*sizeof(Real*));
+  for (v=0; v<NVAR; v++) {
+    U1d[v] = (Real*)calloc(nt,sizeof(Real));
+    F1d[v] = (Real*)calloc(nt,sizeof(Real));
+  }
+
+  for (r=0; r<2; r++) {
+    Ua[r] = (ConsS***)calloc_3d(nt,nt,nt,sizeof(ConsS),0);
+    Us[r] = (Real****)malloc(NVAR*sizeof(Real***));
+    for (v=0; v<NVAR; v++)
+      Us[r][v] = (Real***)calloc_3d(nt,nt,nt,sizeof(Real),1);
+  }
+
+/* Fill both layouts with the same smooth data */
+
+  for (k=0; k<nt; k++) {
+  for (j=0; j<nt; j++) {
+  for (i=0; i<nt; i++) {
+    for (v=0; v<NVAR; v++) {
+      Real q = 1.0 + 0.1*v + 1.0e-3*(i + 2*j + 3*k);
+      ((Real*)&(Ua[0][k][j][i]))[v] = q;
+      Us[0][v][k][j][i] = q;
+    }
+  }}}
+
+/* Time each sweep direction, keeping the fastest of nrep passes.  The
+ * checksum below is taken after the last (direct, x3) sweep. */
+
+  for (dir=0; dir<3; dir++) {
+    tmin = 1.0e30;
+    for (r=0; r<nrep; r++) {
+      t0 = wtime();
+      sweep_aos(Ua[0],Ua[1],n,dir);
+      t0 = wtime() - t0;
+      if (t0 < tmin) tmin = t0;
+    }
+    rate[0][0][dir] = (double)n*n*n/tmin;
+
+    tmin = 1.0e30;
+    for (r=0; r<nrep; r++) {
+      t0 = wtime();
+      sweep_soa(Us[0],Us[1],n,dir);
+      t0 = wtime() - t0;
+      if (t0 < tmin) tmin = t0;
+    }
+    rate[1][0][dir] = (double)n*n*n/tmin;
+  }
+
+  for (dir=0; dir<3; dir++) {
+    tmin = 1.0e30;
+    for (r=0; r<nrep; r++) {
+      t0 = wtime();
+      direct_aos(Ua[0],Ua[1],n,dir);
+      t0 = wtime() - t0;
+      if (t0 < tmin) tmin = t0;
+    }
+    rate[0][1][dir] = (double)n*n*n/tmin;
+
+    tmin = 1.0e30;
+    for (r=0; r<nrep; r++) {
+      t0 = wtime();
+      direct_soa(Us[0],Us[1],n,dir);
+      t0 = wtime() - t0;
+      if (t0 < tmin) tmin = t0;
+    }
+    rate[1][1][dir] = (double)n*n*n/tmin;
+  }
+
+/* Both layouts must produce the same answer */
+
+  chk[0] = chk[1] = 0.0;
+  for (k=NGH; k<n+NGH; k++) {
+  for (j=NGH; j<n+NGH; j++) {
+  for (i=NGH; i<n+NGH; i++) {
+    for (v=0; v<NVAR; v++) {
+      chk[0] += ((Real*)&(Ua[1][k][j][i]))[v];
+      chk[1] += Us[1][v][k][j][i];
+    }
+  }}}
+
+  printf("# %d^3 cells, %d variables, best of %d passes\n",n,NVAR,nrep);
+  for (r=0; r<2; r++) {
+    printf("# %s\n", r == 0 ? "pencil gather/scatter (integrator loop order)"
+                            : "direct update, x1-index innermost");
+    printf("# %-6s %14s %14s %14s\n","layout","x1 [cell/s]","x2 [cell/s]",
+      "x3 [cell/s]");
+    printf("  %-6s %14.4e %14.4e %14.4e\n","AoS",rate[0][r][0],rate[0][r][1],
+      rate[0][r][2]);
+    printf("  %-6s %14.4e %14.4e %14.4e\n","SoA",rate[1][r][0],rate[1][r][1],
+      rate[1][r][2]);
+    printf("# SoA/AoS %14.3f %14.3f %14.3f\n",rate[1][r][0]/rate[0][r][0],
+      rate[1][r][1]/rate[0][r][1],rate[1][r][2]/rate[0][r][2]);
+  }
+  if (chk[0] != chk[1])
+    printf("# WARNING: checksums differ (%.17g vs %.17g)\n",chk[0],chk[1]);
+
+  for (r=0; r<2; r++) {
+    free_3d(Ua[r]);
+    for (v=0; v<NVAR; v++) free_3d(Us[r][v]);
+    free(Us[r]);
+  }
+  for (v=0; v<NVAR; v++) {
+    free(U1d[v]);
+    free(F1d[v]);
+  }
+  free(U1d);
+  free(F1d);
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* update1d: three-point update of the gathered pencil, standing in for the
+ *   reconstruction + Riemann solve + flux difference of the integrators.
+ */
+
+static void update1d(const int il, const int iu)
+{
+  int i, v;
+
+  for (v=0; v<NVAR; v++) {
+    Real *q = U1d[v], *f = F1d[v];
+    for (i=il; i<=iu; i++) {
+      f[i] = q[i] - 0.1*(q[i+1] - q[i-1]) + 0.05*(q[i+1] - 2.0*q[i] + q[i-1]);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* sweep_aos: gather/update/scatter along direction dir (0,1,2 = x1,x2,x3)
+ *   with conserved variables stored as an array of ConsS.
+ */
+
+static void sweep_aos(ConsS ***Uin, ConsS ***Uout, const int n, const int dir)
+{
+  int i, j, k, v, il = NGH, iu = n+NGH-1;
+
+  for (k=NGH; k<=iu; k++) {
+    for (j=NGH; j<=iu; j++) {
+      for (i=0; i<n+2*NGH; i++) {
+        const ConsS *pU = (dir == 0) ? &(Uin[k][j][i]) :
+          ((dir == 1) ? &(Uin[k][i][j]) : &(Uin[i][k][j]));
+        U1d[0][i] = pU->d;
+        U1d[1][i] = pU->M1;
+        U1d[2][i] = pU->M2;
+        U1d[3][i] = pU->M3;
+        U1d[4][i] = pU->E;
+        U1d[5][i] = pU->B1c;
+        U1d[6][i] = pU->B2c;
+        U1d[7][i] = pU->B3c;
+      }
+      update1d(il,iu);
+      for (i=il; i<=iu; i++) {
+        ConsS *pU = (dir == 0) ? &(Uout[k][j][i]) :
+          ((dir == 1) ? &(Uout[k][i][j]) : &(Uout[i][k][j]));
+        for (v=0; v<NVAR; v++) ((Real*)pU)[v] = F1d[v][i];
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* sweep_soa: as sweep_aos, with one 3D array per conserved variable.
+ */
+
+static void sweep_soa(Real ****Uin, Real ****Uout, const int n, const int dir)
+{
+  int i, j, k, v, il = NGH, iu = n+NGH-1;
+
+  for (k=NGH; k<=iu; k++) {
+    for (j=NGH; j<=iu; j++) {
+      for (v=0; v<NVAR; v++) {
+        Real ***q = Uin[v], *u = U1d[v];
+        if (dir == 0)
+          for (i=0; i<n+2*NGH; i++) u[i] = q[k][j][i];
+        else if (dir == 1)
+          for (i=0; i<n+2*NGH; i++) u[i] = q[k][i][j];
+        else
+          for (i=0; i<n+2*NGH; i++) u[i] = q[i][k][j];
+      }
+      update1d(il,iu);
+      for (v=0; v<NVAR; v++) {
+        Real ***q = Uout[v], *f = F1d[v];
+        if (dir == 0)
+          for (i=il; i<=iu; i++) q[k][j][i] = f[i];
+        else if (dir == 1)
+          for (i=il; i<=iu; i++) q[k][i][j] = f[i];
+        else
+          for (i=il; i<=iu; i++) q[i][k][j] = f[i];
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* direct_aos: the update of update1d() applied in place along direction dir,
+ *   looping over x1 innermost.  Consecutive i are sizeof(ConsS) apart.
+ */
+
+static void direct_aos(ConsS ***Uin, ConsS ***Uout, const int n, const int dir)
+{
+  int i, j, k, v, il = NGH, iu = n+NGH-1;
+  int di = (dir == 0), dj = (dir == 1), dk = (dir == 2);
+
+  for (k=il; k<=iu; k++) {
+    for (j=il; j<=iu; j++) {
+      for (v=0; v<NVAR; v++) {
+        const Real *qc = (Real*)&(Uin[k][j][0]) + v;
+        const Real *qm = (Real*)&(Uin[k-dk][j-dj][-di]) + v;
+        const Real *qp = (Real*)&(Uin[k+dk][j+dj][di]) + v;
+        Real *f = (Real*)&(Uout[k][j][0]) + v;
+        for (i=il; i<=iu; i++) {
+          f[i*NVAR] = qc[i*NVAR] - 0.1*(qp[i*NVAR] - qm[i*NVAR])
+            + 0.05*(qp[i*NVAR] - 2.0*qc[i*NVAR] + qm[i*NVAR]);
+        }
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* direct_soa: as direct_aos, with unit stride in i.
+ */
+
+static void direct_soa(Real ****Uin, Real ****Uout, const int n, const int dir)
+{
+  int i, j, k, v, il = NGH, iu = n+NGH-1;
+  int di = (dir == 0), dj = (dir == 1), dk = (dir == 2);
+
+  for (v=0; v<NVAR; v++) {
+    for (k=il; k<=iu; k++) {
+      for (j=il; j<=iu; j++) {
+        const Real *qc = Uin[v][k][j];
+        const Real *qm = Uin[v][k-dk][j-dj] - di;
+        const Real *qp = Uin[v][k+dk][j+dj] + di;
+        Real *f = Uout[v][k][j];
+        for (i=il; i<=iu; i++) {
+          f[i] = qc[i] - 0.1*(qp[i] - qm[i]) + 0.05*(qp[i] - 2.0*qc[i] + qm[i]);
+        }
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* calloc_3d: contiguous 3D array as in ath_array.c.  With pad != 0 each row
+ *   is padded to a multiple of ALIGN bytes and the data are ALIGN-aligned.
+ */
+
+static void *calloc_3d(size_t nt, size_t nr, size_t nc, size_t size, int pad)
+{
+  void ***array;
+  size_t i, j, ncp = nc;
+  char *data;
+
+  if (pad) ncp = ((nc*size + ALIGN - 1)/ALIGN)*ALIGN/size;
+
+  array = (void***)calloc(nt,sizeof(void**));
+  array[0] = (void**)calloc(nt*nr,sizeof(void*));
+  if (posix_memalign((void**)&data, ALIGN, nt*nr*ncp*size) != 0) {
+    fprintf(stderr,"[calloc_3d]: failed to allocate memory\n");
+    exit(1);
+  }
+  memset(data, 0, nt*nr*ncp*size);
+
+  for (j=0; j<nt; j++) {
+    array[j] = array[0] + j*nr;
+    for (i=0; i<nr; i++)
+      array[j][i] = (void*)(data + (j*nr + i)*ncp*size);
+  }
+  return (void*)array;
+}
+
+static void free_3d(void *array)
+{
+  void ***ta = (void***)array;
+
+  free(ta[0][0]);
+  free(ta[0]);
+  free(array);
+}
+
+/*----------------------------------------------------------------------------*/
+/* wtime: wall-clock time in seconds */
+
+static double wtime(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1.0e-9*(double)ts.tv_nsec;
+}
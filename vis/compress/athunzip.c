@@ -0,0 +1,163 @@
+/*==============================================================================
+ * FILE: athunzip.c
+ *
+ * PURPOSE: Restores the uncompressed files from dumps and restart files
+ *   written with compress = lossless or lossy in the <outputN> block (Athena
+ *   configured with --enable-compression).  The text in these files is plain,
+ *   while each section of binary data starts with a zero byte and is split
+ *   into chunks that were byte-shuffled and compressed with zlib, or stored
+ *   (see src/compress.c).  The output is exactly the file Athena would have
+ *   written without compression, after any lossy rounding, so it can be used
+ *   with join_vtk, the IDL and Matlab readers, or to restart Athena.
+ *
+ *   By default name.vtkz is written to name.vtk and name.binz to name.bin;
+ *   other files (e.g. compressed restart files, which Athena also reads
+ *   directly) need -o.
+ *
+ * COMPILE USING: gcc -O2 -Wall -W -o athunzip athunzip.c -lz
+ *
+ * USAGE: ./athunzip [-o outfile] infile
+ *        ./athunzip infile1.vtkz infile2.vtkz ...
+ *============================================================================*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/* uncompressed size of chunks, as in src/compress.c */
+#define ZCHUNK 1048576
+
+static void unzip_error(const char *fmt, ...);
+static void unzip_file(const char *in_name, const char *out_name);
+static void get_section(FILE *fp, FILE *out, const char *in_name);
+static unsigned long get_u32(FILE *fp, const char *in_name);
+
+static unsigned char *zin, *zshuf, *zraw;
+
+int main(int argc, char *argv[])
+{
+  char *out_name;
+  int i, len;
+
+  if (argc < 2) {
+    fprintf(stderr,"Usage: %s [-o outfile] infile\n",argv[0]);
+    fprintf(stderr,"       %s infile1.vtkz infile2.binz ...\n",argv[0]);
+    return 1;
+  }
+
+  zin   = (unsigned char*)malloc(ZCHUNK + compressBound(ZCHUNK));
+  zshuf = (unsigned char*)malloc(ZCHUNK);
+  zraw  = (unsigned char*)malloc(ZCHUNK);
+  if (zin == NULL || zshuf == NULL || zraw == NULL)
+    unzip_error("malloc failed for buffers\n");
+
+  if (strcmp(argv[1],"-o") == 0) {
+    if (argc != 4) unzip_error("-o needs one output and one input file\n");
+    unzip_file(argv[3], argv[2]);
+    return 0;
+  }
+
+  for (i=1; i<argc; i++) {
+    len = (int)strlen(argv[i]);
+    if (len < 2 || argv[i][len-1] != 'z')
+      unzip_error("%s does not end in z, use -o outfile\n",argv[i]);
+    if ((out_name = (char*)malloc(len)) == NULL)
+      unzip_error("malloc failed for file name\n");
+    strncpy(out_name, argv[i], len-1);
+    out_name[len-1] = '\0';
+    unzip_file(argv[i], out_name);
+    free(out_name);
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* unzip_error: prints message and exits */
+
+static void unzip_error(const char *fmt, ...)
+{
+  va_list ap;
+
+  fprintf(stderr,"[athunzip]: ");
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  exit(1);
+}
+
+/*----------------------------------------------------------------------------*/
+/* unzip_file: copies the text of in_name to out_name, and expands sections */
+
+static void unzip_file(const char *in_name, const char *out_name)
+{
+  FILE *fp, *out;
+  int c;
+
+  if ((fp = fopen(in_name,"rb")) == NULL)
+    unzip_error("Unable to open %s\n",in_name);
+  if ((out = fopen(out_name,"wb")) == NULL)
+    unzip_error("Unable to open %s\n",out_name);
+
+  while ((c = getc(fp)) != EOF) {
+    if (c != 0) putc(c, out);
+    else get_section(fp, out, in_name);
+  }
+
+  fclose(fp);
+  if (fclose(out) != 0) unzip_error("Error writing %s\n",out_name);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* get_section: reads one section (after its first zero byte) from fp, and
+ *   writes the uncompressed data to out */
+
+static void get_section(FILE *fp, FILE *out, const char *in_name)
+{
+  unsigned char head[7];
+  unsigned long nraw, nin;
+  uLongf nshuf;
+  size_t i, b, s, n;
+
+  if (fread(head, 1, 7, fp) != 7 || memcmp(head, "ATHZ1", 5) != 0)
+    unzip_error("%s: zero byte outside compressed data\n",in_name);
+  s = (size_t)head[5];
+  if (s == 0) unzip_error("%s: bad element size\n",in_name);
+
+  while ((nraw = get_u32(fp, in_name)) > 0) {
+    nin = get_u32(fp, in_name);
+    if (nraw > ZCHUNK || nin > nraw || fread(zin, 1, nin, fp) != nin)
+      unzip_error("%s: corrupt compressed chunk\n",in_name);
+    if (nin == nraw) {
+      fwrite(zin, 1, nraw, out);
+      continue;
+    }
+    nshuf = ZCHUNK;
+    if (uncompress(zshuf, &nshuf, zin, nin) != Z_OK || nshuf != nraw)
+      unzip_error("%s: zlib uncompress() failed\n",in_name);
+    n = nraw/s;
+    for (b=0; b<s; b++) {
+      for (i=0; i<n; i++) zraw[i*s + b] = zshuf[b*n + i];
+    }
+    fwrite(zraw, 1, nraw, out);
+  }
+  get_u32(fp, in_name);  /* compressed size of end marker */
+
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* get_u32: reads a 4-byte little-endian integer */
+
+static unsigned long get_u32(FILE *fp, const char *in_name)
+{
+  unsigned char c[4];
+
+  if (fread(c, 1, 4, fp) != 4)
+    unzip_error("%s: unexpected end of file\n",in_name);
+  return (unsigned long)c[0] | ((unsigned long)c[1] << 8) |
+    ((unsigned long)c[2] << 16) | ((unsigned long)c[3] << 24);
+}
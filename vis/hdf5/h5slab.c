@@ -0,0 +1,188 @@
+/*==============================================================================
+ * FILE: h5slab.c
+ *
+ * PURPOSE: Extracts a subvolume of some variables of one Domain from an hdf
+ *   dump (out_fmt = hdf, Athena configured with --enable-hdf5, see
+ *   src/dump_hdf5.c) into a vtk file.  Only the chunks of each dataset that
+ *   overlap the subvolume are read and uncompressed, so a small region of a
+ *   large dump is read quickly.  The file can also be read with any other
+ *   HDF5 tool, e.g. h5py: f['level0/domain0/d'][k0:k1,j0:j1,i0:i1].
+ *
+ * COMPILE USING: gcc -O2 -Wall -W -o h5slab h5slab.c -I/usr/include/hdf5/serial
+ *                    -L/usr/lib/x86_64-linux-gnu/hdf5/serial -lhdf5
+ *
+ * USAGE: ./h5slab [options] -o <outfile.vtk> infile.h5 var1 [var2 ...]
+ *
+ *   -l level          level of the Domain (default 0)
+ *   -d domain         number of the Domain on its level (default 0)
+ *   -i il:iu          only cells il..iu of the Domain in x1 (the first cell
+ *   -j jl:ju          is 0), and likewise in x2 and x3; default is all cells
+ *   -k kl:ku
+ *============================================================================*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+
+static void slab_error(const char *fmt, ...);
+static void get_range(const char *arg, int *lo, int *hi);
+static int big_endian(void);
+static void bswap(void *data, const int size, const int n);
+
+int main(int argc, char *argv[])
+{
+  hid_t file, group, attr, dset, fspace, mspace;
+  hsize_t start[3], count[3];
+  char path[64], *out_name=NULL;
+  double MinX[3], dx[3], time;
+  float *data;
+  FILE *fp;
+  int lo[3]={0,0,0}, hi[3]={-1,-1,-1}, Nx[3];
+  int i, n, m, level=0, domain=0, ncell;
+
+  for (i=1; i<argc && argv[i][0] == '-'; i++) {
+    if (i+1 >= argc) slab_error("option %s needs a value\n",argv[i]);
+    switch(argv[i][1]) {
+    case 'o': out_name = argv[++i]; break;
+    case 'l': level = atoi(argv[++i]); break;
+    case 'd': domain = atoi(argv[++i]); break;
+    case 'i': get_range(argv[++i], &lo[0], &hi[0]); break;
+    case 'j': get_range(argv[++i], &lo[1], &hi[1]); break;
+    case 'k': get_range(argv[++i], &lo[2], &hi[2]); break;
+    default: slab_error("unknown option %s\n",argv[i]);
+    }
+  }
+  if (out_name == NULL || argc - i < 2) {
+    fprintf(stderr,"Usage: %s [-l level] [-d domain] [-i il:iu] [-j jl:ju] ",
+            argv[0]);
+    fprintf(stderr,"[-k kl:ku]\n          -o outfile.vtk infile.h5 var1 ...\n");
+    return 1;
+  }
+
+/* Size and position of the Domain, and time of the dump */
+
+  if ((file = H5Fopen(argv[i], H5F_ACC_RDONLY, H5P_DEFAULT)) < 0)
+    slab_error("Unable to open %s\n",argv[i]);
+  attr = H5Aopen_by_name(file, "/", "time", H5P_DEFAULT, H5P_DEFAULT);
+  H5Aread(attr, H5T_NATIVE_DOUBLE, &time);
+  H5Aclose(attr);
+
+  sprintf(path,"level%d/domain%d",level,domain);
+  if ((group = H5Gopen2(file, path, H5P_DEFAULT)) < 0)
+    slab_error("%s has no group %s\n",argv[i],path);
+  attr = H5Aopen(group, "Nx", H5P_DEFAULT);
+  H5Aread(attr, H5T_NATIVE_INT, Nx);
+  H5Aclose(attr);
+  attr = H5Aopen(group, "MinX", H5P_DEFAULT);
+  H5Aread(attr, H5T_NATIVE_DOUBLE, MinX);
+  H5Aclose(attr);
+  attr = H5Aopen(group, "dx", H5P_DEFAULT);
+  H5Aread(attr, H5T_NATIVE_DOUBLE, dx);
+  H5Aclose(attr);
+
+  for (n=0; n<3; n++) {
+    if (hi[n] < 0) hi[n] = Nx[n] - 1;
+    if (lo[n] < 0 || hi[n] >= Nx[n] || lo[n] > hi[n])
+      slab_error("range %d:%d outside 0:%d\n",lo[n],hi[n],Nx[n]-1);
+    start[2-n] = (hsize_t)lo[n];
+    count[2-n] = (hsize_t)(hi[n] - lo[n] + 1);
+  }
+  ncell = (int)(count[0]*count[1]*count[2]);
+  if ((data = (float*)malloc(ncell*sizeof(float))) == NULL)
+    slab_error("malloc failed for %d cells\n",ncell);
+  mspace = H5Screate_simple(3, count, NULL);
+
+  if ((fp = fopen(out_name,"wb")) == NULL)
+    slab_error("Unable to open %s\n",out_name);
+  fprintf(fp,"# vtk DataFile Version 2.0\n");
+  fprintf(fp,"Subvolume of %s at time= %e, level= %i, domain= %i\n",
+          argv[i],time,level,domain);
+  fprintf(fp,"BINARY\nDATASET STRUCTURED_POINTS\n");
+  fprintf(fp,"DIMENSIONS %d %d %d\n",hi[0]-lo[0]+2,hi[1]-lo[1]+2,
+          hi[2]-lo[2]+2);
+  fprintf(fp,"ORIGIN %e %e %e \n",MinX[0]+lo[0]*dx[0],MinX[1]+lo[1]*dx[1],
+          MinX[2]+lo[2]*dx[2]);
+  fprintf(fp,"SPACING %e %e %e \n",dx[0],dx[1],dx[2]);
+  fprintf(fp,"CELL_DATA %d \n",ncell);
+
+/* Read the hyperslab of each variable, converted to float by HDF5 */
+
+  for (m=i+1; m<argc; m++) {
+    if ((dset = H5Dopen2(group, argv[m], H5P_DEFAULT)) < 0)
+      slab_error("%s has no variable %s\n",path,argv[m]);
+    fspace = H5Dget_space(dset);
+    H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, NULL);
+    if (H5Dread(dset, H5T_NATIVE_FLOAT, mspace, fspace, H5P_DEFAULT, data) < 0)
+      slab_error("Error reading %s/%s\n",path,argv[m]);
+    H5Sclose(fspace);
+    H5Dclose(dset);
+
+    if (!big_endian()) bswap(data, sizeof(float), ncell);
+    fprintf(fp,"%sSCALARS %s float\nLOOKUP_TABLE default\n",
+            (m == i+1 ? "" : "\n"),argv[m]);
+    fwrite(data, sizeof(float), (size_t)ncell, fp);
+  }
+
+  if (fclose(fp) != 0) slab_error("Error writing %s\n",out_name);
+  H5Sclose(mspace);
+  H5Gclose(group);
+  H5Fclose(file);
+  free(data);
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* slab_error: prints message and exits */
+
+static void slab_error(const char *fmt, ...)
+{
+  va_list ap;
+
+  fprintf(stderr,"[h5slab]: ");
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  exit(1);
+}
+
+/*----------------------------------------------------------------------------*/
+/* get_range: parses a range of cell indices lo:hi */
+
+static void get_range(const char *arg, int *lo, int *hi)
+{
+  if (sscanf(arg, "%d:%d", lo, hi) != 2)
+    slab_error("bad range %s, use lo:hi\n",arg);
+  return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* big_endian: returns 1 on a big endian machine */
+
+static int big_endian(void)
+{
+  short int n = 1;
+  char *ep = (char *)&n;
+
+  return (*ep == 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/* bswap: swaps the bytes of n elements of size bytes in data */
+
+static void bswap(void *data, const int size, const int n)
+{
+  char *p = (char*)data, c;
+  int i, j;
+
+  for (i=0; i<n; i++, p+=size) {
+    for (j=0; j<size/2; j++) {
+      c = p[j];
+      p[j] = p[size-1-j];
+      p[size-1-j] = c;
+    }
+  }
+  return;
+}
@@ -0,0 +1,141 @@
+/*==============================================================================
+ * FILE: rstfield.c
+ *
+ * PURPOSE: Lists the fields in a restart file, or copies some fields of one
+ *   Domain to a raw binary file, using the index at the end of uncompressed
+ *   restart files (see src/restart_map.c).  The restart file is mapped into
+ *   memory, and only the fields asked for are read from disk, however large
+ *   the file.  Each field is written as is: elements of the size given in the
+ *   listing, in the byte order of the machine that wrote the restart file,
+ *   with x1 varying fastest.  Several fields are written one after the other.
+ *
+ * COMPILE USING: gcc -O2 -Wall -W -o rstfield rstfield.c
+ *
+ * USAGE: ./rstfield infile.rst
+ *        ./rstfield [-l level] [-d domain] -o outfile infile.rst name1 ...
+ *
+ *   -l level          level of the Domain (default 0)
+ *   -d domain         number of the Domain on its level (default 0)
+ *   Names with spaces (e.g. "SCALAR 0") must be quoted.
+ *============================================================================*/
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* format of the index, as in src/prototypes.h */
+#define RST_NAMELEN 24
+#define RST_ENTRYLEN (RST_NAMELEN + 6*sizeof(int) + sizeof(long long))
+#define RST_MAGIC "ATHRIDX1"
+
+static void rst_error(const char *fmt, ...);
+
+int main(int argc, char *argv[])
+{
+  struct stat st;
+  FILE *fp = NULL;
+  const char *base, *p;
+  char *out_name = NULL, name[RST_NAMELEN];
+  long long start, offset, nbytes;
+  int fd, i, m, n, nfield, level=0, domain=0, lev, dom, elsize, nx[3];
+
+  for (i=1; i<argc && argv[i][0] == '-'; i++) {
+    if (i+1 >= argc) rst_error("option %s needs a value\n",argv[i]);
+    switch(argv[i][1]) {
+    case 'o': out_name = argv[++i]; break;
+    case 'l': level = atoi(argv[++i]); break;
+    case 'd': domain = atoi(argv[++i]); break;
+    default: rst_error("unknown option %s\n",argv[i]);
+    }
+  }
+  if (argc - i < 1 || (out_name == NULL) != (argc - i == 1)) {
+    fprintf(stderr,"Usage: %s infile.rst\n",argv[0]);
+    fprintf(stderr,"       %s [-l level] [-d domain] -o outfile infile.rst ",
+            argv[0]);
+    fprintf(stderr,"name1 ...\n");
+    return 1;
+  }
+
+/* Map the file, and find the index from its end */
+
+  if ((fd = open(argv[i], O_RDONLY)) < 0 || fstat(fd, &st) != 0)
+    rst_error("Unable to open %s\n",argv[i]);
+  if (st.st_size < 16 + (off_t)sizeof(int))
+    rst_error("%s is too short for a restart file\n",argv[i]);
+  base = (const char*)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED,
+                           fd, 0);
+  if (base == (const char*)MAP_FAILED) rst_error("Unable to map %s\n",argv[i]);
+  close(fd);
+
+  if (memcmp(base + st.st_size - 8, RST_MAGIC, 8) != 0)
+    rst_error("%s has no index (compressed or older restart file?)\n",argv[i]);
+  memcpy(&start, base + st.st_size - 16, sizeof(long long));
+  if (start < 0 || start + (long long)sizeof(int) > (long long)st.st_size - 16)
+    rst_error("%s: corrupt index\n",argv[i]);
+  memcpy(&nfield, base + start, sizeof(int));
+  if (nfield < 0 || (long long)nfield*(long long)RST_ENTRYLEN !=
+      (long long)st.st_size - 16 - start - (long long)sizeof(int))
+    rst_error("%s: corrupt index\n",argv[i]);
+
+  if (out_name != NULL && (fp = fopen(out_name,"wb")) == NULL)
+    rst_error("Unable to open %s\n",out_name);
+  else if (out_name == NULL)
+    printf("%-20s %5s %6s %6s %22s %12s\n","name","level","domain","elsize",
+           "size","offset");
+
+/* List all entries, or write the ones asked for in order */
+
+  for (m = (out_name == NULL ? i : i+1); m < argc; m++) {
+    for (n=0; n<nfield; n++) {
+      p = base + start + sizeof(int) + n*RST_ENTRYLEN;
+      memcpy(name, p, RST_NAMELEN);
+      name[RST_NAMELEN-1] = '\0';
+      p += RST_NAMELEN;
+      memcpy(&lev, p, sizeof(int));     p += sizeof(int);
+      memcpy(&dom, p, sizeof(int));     p += sizeof(int);
+      memcpy(&elsize, p, sizeof(int));  p += sizeof(int);
+      memcpy(nx, p, 3*sizeof(int));     p += 3*sizeof(int);
+      memcpy(&offset, p, sizeof(long long));
+      nbytes = (long long)elsize*nx[0]*nx[1]*nx[2];
+      if (offset < 0 || offset + nbytes > (long long)st.st_size)
+        rst_error("%s: %s is past the end of the file\n",argv[i],name);
+
+      if (out_name == NULL) {
+        printf("%-20s %5d %6d %6d %8dx%6dx%6d %12lld\n",name,lev,dom,elsize,
+               nx[0],nx[1],nx[2],offset);
+      } else if (lev == level && dom == domain && strcmp(name,argv[m]) == 0) {
+        if (fwrite(base + offset, 1, (size_t)nbytes, fp) != (size_t)nbytes)
+          rst_error("Error writing %s\n",out_name);
+        break;
+      }
+    }
+    if (out_name == NULL) break;
+    if (n == nfield)
+      rst_error("%s has no %s for level %d domain %d\n",argv[i],argv[m],
+                level,domain);
+  }
+
+  if (fp != NULL && fclose(fp) != 0) rst_error("Error writing %s\n",out_name);
+  munmap((void*)base, (size_t)st.st_size);
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* rst_error: prints message and exits */
+
+static void rst_error(const char *fmt, ...)
+{
+  va_list ap;
+
+  fprintf(stderr,"[rstfield]: ");
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  exit(1);
+}